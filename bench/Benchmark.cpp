@@ -0,0 +1,366 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "Benchmark.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Event listener that counts the contact pairs reported by the world
+class ContactPairsCounter : public EventListener {
+
+    public:
+
+        uint64 nbContactPairs = 0;
+
+        virtual void onContact(const CollisionCallback::CallbackData& callbackData) override {
+            nbContactPairs += callbackData.getNbContactPairs();
+        }
+};
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Return the phase measured by a profiled block of code (or -1 if the block is not a phase)
+int getPhaseOfProfileBlock(const char* name) {
+
+    static const std::pair<const char*, BenchmarkResult::Phase> blocks[] = {
+        {"CollisionDetectionSystem::computeBroadPhase()", BenchmarkResult::BroadPhase},
+        {"CollisionDetectionSystem::computeMiddlePhase()", BenchmarkResult::MiddlePhase},
+        {"CollisionDetectionSystem::computeNarrowPhase()", BenchmarkResult::NarrowPhase},
+        {"PhysicsWorld::createIslands()", BenchmarkResult::Islands},
+        {"PhysicsWorld::solveContactsAndConstraints()", BenchmarkResult::Solver},
+        {"PhysicsWorld::solvePositionCorrection()", BenchmarkResult::Solver},
+        {"DynamicsSystem::integrateRigidBodiesVelocities()", BenchmarkResult::Integrate},
+        {"DynamicsSystem::integrateRigidBodiesPositions()", BenchmarkResult::Integrate},
+        {"DynamicsSystem::updateBodiesState()", BenchmarkResult::Integrate},
+    };
+
+    for (const auto& block : blocks) {
+        if (std::strcmp(block.first, name) == 0) return block.second;
+    }
+
+    return -1;
+}
+
+// Recursively add the time of the phases found below the current node of the profiler tree
+void accumulatePhaseTimes(ProfileNodeIterator* iterator, double* phaseTimes) {
+
+    // Add the time of the children that are phases and remember the other ones
+    std::vector<int> childrenToVisit;
+    iterator->first();
+    for (int i=0; !iterator->isEnd(); i++, iterator->next()) {
+
+        const int phase = getPhaseOfProfileBlock(iterator->getCurrentName());
+        if (phase >= 0) {
+            phaseTimes[phase] += iterator->getCurrentTotalTime().count();
+        }
+        else {
+            childrenToVisit.push_back(i);
+        }
+    }
+
+    // The children of a phase are not visited to avoid counting the same time twice
+    for (int child : childrenToVisit) {
+        iterator->enterChild(child);
+        accumulatePhaseTimes(iterator, phaseTimes);
+        iterator->enterParent();
+    }
+}
+
+#endif
+
+// Write a floating-point value as a JSON number
+void writeJsonNumber(std::ostream& outputStream, double value) {
+    outputStream << std::fixed << std::setprecision(6) << value;
+}
+
+}
+
+// Allocate memory of a given size (in bytes)
+void* TrackingAllocator::allocate(size_t size) {
+
+    const size_t currentNbBytes = mCurrentNbBytes.fetch_add(size) + size;
+
+    size_t peakNbBytes = mPeakNbBytes.load();
+    while (currentNbBytes > peakNbBytes && !mPeakNbBytes.compare_exchange_weak(peakNbBytes, currentNbBytes)) {}
+
+    return std::malloc(size);
+}
+
+// Release previously allocated memory
+void TrackingAllocator::release(void* pointer, size_t size) {
+
+    mCurrentNbBytes.fetch_sub(size);
+    std::free(pointer);
+}
+
+// Return the name of a phase
+const char* BenchmarkResult::getPhaseName(Phase phase) {
+
+    switch (phase) {
+        case BroadPhase: return "broadPhase";
+        case MiddlePhase: return "middlePhase";
+        case NarrowPhase: return "narrowPhase";
+        case Islands: return "islands";
+        case Solver: return "solver";
+        case Integrate: return "integrate";
+        default: return "unknown";
+    }
+}
+
+// Return the name of a memory allocator
+const char* BenchmarkResult::getAllocatorName(Allocator allocator) {
+
+    switch (allocator) {
+        case Pool: return "pool";
+        case Heap: return "heap";
+        case Frame: return "frame";
+        default: return "unknown";
+    }
+}
+
+// Constructor
+Benchmark::Benchmark(const BenchmarkSettings& settings) : mSettings(settings) {
+
+}
+
+// Run a scene and store its results
+const BenchmarkResult& Benchmark::run(BenchmarkScene& scene) {
+
+    using clock = std::chrono::high_resolution_clock;
+
+    BenchmarkResult result;
+    result.sceneName = scene.getName();
+    result.nbFrames = mSettings.nbFrames;
+
+    mAllocator.resetPeak();
+
+    {
+        // Use a new PhysicsCommon object for each scene so that the peak memory only
+        // depends on the current scene
+        PhysicsCommon physicsCommon(&mAllocator);
+
+        PhysicsWorld::WorldSettings worldSettings;
+        worldSettings.worldName = scene.getName();
+
+        // Sleeping is disabled so that the whole scene is simulated during the measured frames
+        worldSettings.isSleepingEnabled = false;
+
+        worldSettings.isWideContactSolverEnabled = mSettings.isWideContactSolverEnabled;
+        worldSettings.isBroadPhaseFatAABBPredictive = mSettings.isBroadPhaseFatAABBPredictive;
+        worldSettings.isDeterministic = mSettings.isDeterministic;
+
+        scene.createPhysicsWorld(physicsCommon, worldSettings);
+        PhysicsWorld* world = scene.getPhysicsWorld();
+        result.nbBodies = scene.getNbBodies();
+
+        if (mSettings.nbThreads > 1) {
+            world->setTaskScheduler(physicsCommon.createDefaultTaskScheduler(mSettings.nbThreads));
+        }
+
+        ContactPairsCounter contactPairsCounter;
+        world->setEventListener(&contactPairsCounter);
+
+        for (uint32 i=0; i < mSettings.nbWarmupFrames; i++) {
+            world->update(mSettings.timeStep);
+        }
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+        world->getProfiler()->reset();
+#endif
+
+        MemoryManager& memoryManager = world->getMemoryManager();
+        memoryManager.resetLockStatistics();
+
+        contactPairsCounter.nbContactPairs = 0;
+        result.minFrameTime = std::numeric_limits<double>::max();
+
+        for (uint32 i=0; i < mSettings.nbFrames; i++) {
+
+            const auto startTime = clock::now();
+            world->update(mSettings.timeStep);
+            const double frameTime = std::chrono::duration<double, std::milli>(clock::now() - startTime).count();
+
+            result.totalTime += frameTime;
+            result.minFrameTime = std::min(result.minFrameTime, frameTime);
+            result.maxFrameTime = std::max(result.maxFrameTime, frameTime);
+
+            result.nbBroadPhaseUpdatedColliders += world->getNbBroadPhaseUpdatedColliders();
+            result.nbBroadPhaseReinsertedColliders += world->getNbBroadPhaseReinsertedColliders();
+        }
+
+        if (mSettings.nbFrames == 0) result.minFrameTime = 0.0;
+
+        result.nbContactPairs = contactPairsCounter.nbContactPairs;
+
+        const MemoryManager::AllocationType allocationTypes[BenchmarkResult::NbAllocators] =
+            {MemoryManager::AllocationType::Pool, MemoryManager::AllocationType::Heap, MemoryManager::AllocationType::Frame};
+        for (int a=0; a < BenchmarkResult::NbAllocators; a++) {
+            result.nbAllocatorLocks[a] = memoryManager.getNbLocks(allocationTypes[a]);
+            result.nbAllocatorContendedLocks[a] = memoryManager.getNbContendedLocks(allocationTypes[a]);
+        }
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+        ProfileNodeIterator* iterator = world->getProfiler()->getIterator();
+        accumulatePhaseTimes(iterator, result.phaseTimes);
+        delete iterator;
+        result.hasPhaseTimes = true;
+
+        if (!mSettings.traceFilePrefix.empty()) {
+            world->getProfiler()->exportChromeTrace(mSettings.traceFilePrefix + "_" + scene.getName() + ".json");
+        }
+#endif
+
+        result.peakMemory = memoryManager.getHeapAllocator().getPeakNbUsedBytes();
+
+        // Measure the average time to save and restore the state of the world at the end of the
+        // measured frames. The first save allocates the memory of the checkpoint.
+        const uint32 nbStateMeasurements = 20;
+        world->setNbStateCheckpoints(1);
+        world->saveState();
+        for (uint32 i=0; i < nbStateMeasurements; i++) {
+
+            const auto saveStartTime = clock::now();
+            const uint32 checkpointId = world->saveState();
+            const auto restoreStartTime = clock::now();
+            world->restoreState(checkpointId);
+            const auto restoreEndTime = clock::now();
+
+            result.saveStateTime += std::chrono::duration<double, std::milli>(restoreStartTime - saveStartTime).count();
+            result.restoreStateTime += std::chrono::duration<double, std::milli>(restoreEndTime - restoreStartTime).count();
+        }
+        result.saveStateTime /= nbStateMeasurements;
+        result.restoreStateTime /= nbStateMeasurements;
+
+        world->setEventListener(nullptr);
+    }
+
+    result.peakReservedMemory = mAllocator.getPeakNbBytes();
+
+    mResults.push_back(result);
+
+    return mResults.back();
+}
+
+// Write the results of all the scenes as JSON
+void Benchmark::writeJson(std::ostream& outputStream) const {
+
+#ifdef IS_RP3D_DOUBLE_PRECISION_ENABLED
+    const char* precision = "double";
+#else
+    const char* precision = "float";
+#endif
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+    const char* isProfilingEnabled = "true";
+#else
+    const char* isProfilingEnabled = "false";
+#endif
+
+    outputStream << "{\n";
+    outputStream << "  \"precision\": \"" << precision << "\",\n";
+    outputStream << "  \"profiling\": " << isProfilingEnabled << ",\n";
+    outputStream << "  \"threads\": " << mSettings.nbThreads << ",\n";
+    outputStream << "  \"wideContactSolver\": " << (mSettings.isWideContactSolverEnabled ? "true" : "false") << ",\n";
+    outputStream << "  \"deterministic\": " << (mSettings.isDeterministic ? "true" : "false") << ",\n";
+    outputStream << "  \"predictiveFatAABB\": " << (mSettings.isBroadPhaseFatAABBPredictive ? "true" : "false") << ",\n";
+    outputStream << "  \"frames\": " << mSettings.nbFrames << ",\n";
+    outputStream << "  \"warmupFrames\": " << mSettings.nbWarmupFrames << ",\n";
+    outputStream << "  \"timeStep\": ";
+    writeJsonNumber(outputStream, double(mSettings.timeStep));
+    outputStream << ",\n";
+    outputStream << "  \"scenes\": [";
+
+    for (size_t s=0; s < mResults.size(); s++) {
+
+        const BenchmarkResult& result = mResults[s];
+        const double totalSeconds = result.totalTime / 1000.0;
+        const double nbFrames = std::max(1.0, double(result.nbFrames));
+
+        outputStream << (s > 0 ? ",\n" : "\n");
+        outputStream << "    {\n";
+        outputStream << "      \"name\": \"" << result.sceneName << "\",\n";
+        outputStream << "      \"bodies\": " << result.nbBodies << ",\n";
+        outputStream << "      \"totalTimeMs\": ";
+        writeJsonNumber(outputStream, result.totalTime);
+        outputStream << ",\n      \"averageFrameTimeMs\": ";
+        writeJsonNumber(outputStream, result.totalTime / nbFrames);
+        outputStream << ",\n      \"minFrameTimeMs\": ";
+        writeJsonNumber(outputStream, result.minFrameTime);
+        outputStream << ",\n      \"maxFrameTimeMs\": ";
+        writeJsonNumber(outputStream, result.maxFrameTime);
+        outputStream << ",\n      \"bodiesPerSecond\": ";
+        writeJsonNumber(outputStream, totalSeconds > 0.0 ? result.nbBodies * double(result.nbFrames) / totalSeconds : 0.0);
+        outputStream << ",\n      \"pairsPerSecond\": ";
+        writeJsonNumber(outputStream, totalSeconds > 0.0 ? double(result.nbContactPairs) / totalSeconds : 0.0);
+        outputStream << ",\n      \"contactPairs\": " << result.nbContactPairs;
+        outputStream << ",\n      \"broadPhaseUpdatesPerFrame\": ";
+        writeJsonNumber(outputStream, double(result.nbBroadPhaseUpdatedColliders) / nbFrames);
+        outputStream << ",\n      \"broadPhaseReinsertionsPerFrame\": ";
+        writeJsonNumber(outputStream, double(result.nbBroadPhaseReinsertedColliders) / nbFrames);
+        outputStream << ",\n      \"peakMemoryBytes\": " << result.peakMemory;
+        outputStream << ",\n      \"peakReservedMemoryBytes\": " << result.peakReservedMemory;
+        outputStream << ",\n      \"averageSaveStateTimeMs\": ";
+        writeJsonNumber(outputStream, result.saveStateTime);
+        outputStream << ",\n      \"averageRestoreStateTimeMs\": ";
+        writeJsonNumber(outputStream, result.restoreStateTime);
+
+        // Number of locks (and contended locks) of each memory allocator
+        outputStream << ",\n      \"allocatorLocks\": {";
+        for (int a=0; a < BenchmarkResult::NbAllocators; a++) {
+            outputStream << (a > 0 ? ", " : "") << "\"" << BenchmarkResult::getAllocatorName(BenchmarkResult::Allocator(a)) << "\": ";
+            outputStream << "{\"locks\": " << result.nbAllocatorLocks[a] << ", \"contended\": " << result.nbAllocatorContendedLocks[a] << "}";
+        }
+        outputStream << "}";
+        outputStream << ",\n      \"averagePhaseTimesMs\": ";
+
+        if (result.hasPhaseTimes) {
+
+            // Average time of each phase per frame
+            outputStream << "{";
+            for (int p=0; p < BenchmarkResult::NbPhases; p++) {
+                outputStream << (p > 0 ? ", " : "") << "\"" << BenchmarkResult::getPhaseName(BenchmarkResult::Phase(p)) << "\": ";
+                writeJsonNumber(outputStream, result.phaseTimes[p] / nbFrames);
+            }
+            outputStream << "}\n";
+        }
+        else {
+            outputStream << "null\n";
+        }
+
+        outputStream << "    }";
+    }
+
+    outputStream << "\n  ]\n";
+    outputStream << "}\n";
+}
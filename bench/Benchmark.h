@@ -0,0 +1,216 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include "scenes/BenchmarkScene.h"
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Class TrackingAllocator
+/**
+ * Memory allocator used as base allocator of the PhysicsCommon object to measure the
+ * current and peak memory reserved by the library. The allocators of the library can call
+ * the base allocator from several threads, so the counters are atomic.
+ */
+class TrackingAllocator : public rp3d::MemoryAllocator {
+
+    private :
+
+        /// Number of bytes currently allocated
+        std::atomic<size_t> mCurrentNbBytes;
+
+        /// Maximum number of bytes allocated at the same time
+        std::atomic<size_t> mPeakNbBytes;
+
+    public :
+
+        /// Constructor
+        TrackingAllocator() : mCurrentNbBytes(0), mPeakNbBytes(0) {
+
+        }
+
+        /// Allocate memory of a given size (in bytes)
+        virtual void* allocate(size_t size) override;
+
+        /// Release previously allocated memory
+        virtual void release(void* pointer, size_t size) override;
+
+        /// Reset the peak memory to the current memory
+        void resetPeak() {
+            mPeakNbBytes = mCurrentNbBytes.load();
+        }
+
+        /// Return the maximum number of bytes allocated at the same time
+        size_t getPeakNbBytes() const {
+            return mPeakNbBytes;
+        }
+};
+
+// Structure BenchmarkSettings
+/**
+ * Settings used to run the scenes of the benchmark
+ */
+struct BenchmarkSettings {
+
+    /// Number of measured frames
+    rp3d::uint32 nbFrames = 600;
+
+    /// Number of frames simulated before the measurements start
+    rp3d::uint32 nbWarmupFrames = 60;
+
+    /// Number of threads (1 to run the simulation without task scheduler)
+    rp3d::uint32 nbThreads = 1;
+
+    /// True if the contacts are solved with the wide (SIMD) contact solver
+    bool isWideContactSolverEnabled = false;
+
+    /// True if the worlds are simulated in the deterministic mode
+    bool isDeterministic = false;
+
+    /// True if the broad-phase fat AABBs are extruded along the displacement of the bodies
+    bool isBroadPhaseFatAABBPredictive = false;
+
+    /// Time step of the simulation (in seconds)
+    rp3d::decimal timeStep = rp3d::decimal(1.0) / rp3d::decimal(60.0);
+
+    /// If not empty, the Chrome trace of each scene is written into the file
+    /// "<traceFilePrefix>_<scene>.json" (only when profiling is enabled)
+    std::string traceFilePrefix;
+};
+
+// Structure BenchmarkResult
+/**
+ * Measurements of a scene of the benchmark
+ */
+struct BenchmarkResult {
+
+    /// Simulation phases that are measured with the profiler
+    enum Phase {BroadPhase, MiddlePhase, NarrowPhase, Islands, Solver, Integrate, NbPhases};
+
+    /// Memory allocators with a lock
+    enum Allocator {Pool, Heap, Frame, NbAllocators};
+
+    /// Name of the scene
+    std::string sceneName;
+
+    /// Number of rigid bodies in the scene
+    rp3d::uint32 nbBodies = 0;
+
+    /// Number of measured frames
+    rp3d::uint32 nbFrames = 0;
+
+    /// Total time of the measured frames (in milliseconds)
+    double totalTime = 0.0;
+
+    /// Minimum time of a frame (in milliseconds)
+    double minFrameTime = 0.0;
+
+    /// Maximum time of a frame (in milliseconds)
+    double maxFrameTime = 0.0;
+
+    /// Total number of contact pairs of the measured frames
+    rp3d::uint64 nbContactPairs = 0;
+
+    /// Total number of colliders updated in the broad-phase during the measured frames
+    rp3d::uint64 nbBroadPhaseUpdatedColliders = 0;
+
+    /// Total number of colliders reinserted into the broad-phase tree during the measured frames
+    rp3d::uint64 nbBroadPhaseReinsertedColliders = 0;
+
+    /// Maximum number of bytes allocated at the same time from the heap allocator of the library
+    /// (including the blocks of the pool allocator and the buffer of the single frame allocator)
+    size_t peakMemory = 0;
+
+    /// Maximum number of bytes reserved by the library from the base allocator. The heap allocator
+    /// reserves large chunks of memory, so this value changes by steps.
+    size_t peakReservedMemory = 0;
+
+    /// Average time to save the state of the world with PhysicsWorld::saveState() (in milliseconds)
+    double saveStateTime = 0.0;
+
+    /// Average time to restore the state of the world with PhysicsWorld::restoreState() (in milliseconds)
+    double restoreStateTime = 0.0;
+
+    /// True if the time of each phase has been measured
+    bool hasPhaseTimes = false;
+
+    /// Total time of each phase (in milliseconds)
+    double phaseTimes[NbPhases] = {};
+
+    /// Number of times the lock of each memory allocator has been taken during the measured frames
+    rp3d::uint64 nbAllocatorLocks[NbAllocators] = {};
+
+    /// Number of times a thread had to wait for the lock of each memory allocator during the measured frames
+    rp3d::uint64 nbAllocatorContendedLocks[NbAllocators] = {};
+
+    /// Return the name of a phase
+    static const char* getPhaseName(Phase phase);
+
+    /// Return the name of a memory allocator
+    static const char* getAllocatorName(Allocator allocator);
+};
+
+// Class Benchmark
+/**
+ * This class runs the scenes of the benchmark without rendering and writes the
+ * measurements as JSON. The time of each phase of the simulation is only available
+ * when the library is compiled with profiling enabled (RP3D_PROFILING_ENABLED).
+ */
+class Benchmark {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Benchmark settings
+        BenchmarkSettings mSettings;
+
+        /// Allocator used to measure the memory reserved by the library
+        TrackingAllocator mAllocator;
+
+        /// Results of the scenes that have been run
+        std::vector<BenchmarkResult> mResults;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        Benchmark(const BenchmarkSettings& settings);
+
+        /// Run a scene and store its results
+        const BenchmarkResult& run(BenchmarkScene& scene);
+
+        /// Write the results of all the scenes as JSON
+        void writeJson(std::ostream& outputStream) const;
+};
+
+#endif
@@ -0,0 +1,180 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "Benchmark.h"
+#include "scenes/PileScene.h"
+#include "scenes/CubeStackScene.h"
+#include "scenes/RagdollScene.h"
+#include "scenes/ConcaveMeshScene.h"
+#include "scenes/HeightFieldScene.h"
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <cstdlib>
+#include <algorithm>
+
+namespace {
+
+// Print the usage of the benchmark
+void printUsage(const char* programName) {
+
+    std::cerr << "Usage: " << programName << " [options]" << std::endl
+              << "  --scene <name>     Scene to run: pile, cubestack, ragdoll, concavemesh, heightfield or all (default: all)" << std::endl
+              << "  --frames <n>       Number of measured frames (default: 600)" << std::endl
+              << "  --warmup <n>       Number of frames simulated before the measurements (default: 60)" << std::endl
+              << "  --threads <n>      Number of threads of the task scheduler (default: 1)" << std::endl
+              << "  --wide-solver <0|1> Solve the contacts with the wide (SIMD) contact solver (default: 0)" << std::endl
+              << "  --deterministic <0|1> Simulate the worlds in the deterministic mode (default: 0)" << std::endl
+              << "  --predictive-aabb <0|1> Extrude the broad-phase fat AABBs along the displacement of the bodies (default: 0)" << std::endl
+              << "  --output <file>    Write the JSON results into a file instead of the standard output" << std::endl
+              << "  --trace <prefix>   Write the Chrome trace of each scene into <prefix>_<scene>.json (requires RP3D_PROFILING_ENABLED)" << std::endl;
+}
+
+// Create the scenes with a given name ("all" for all the scenes)
+std::vector<std::unique_ptr<BenchmarkScene>> createScenes(const std::string& name) {
+
+    std::vector<std::unique_ptr<BenchmarkScene>> scenes;
+    scenes.emplace_back(new PileScene());
+    scenes.emplace_back(new CubeStackScene());
+    scenes.emplace_back(new RagdollScene());
+    scenes.emplace_back(new ConcaveMeshScene());
+    scenes.emplace_back(new HeightFieldScene());
+
+    if (name != "all") {
+        scenes.erase(std::remove_if(scenes.begin(), scenes.end(),
+                                    [&](const std::unique_ptr<BenchmarkScene>& scene) { return scene->getName() != name; }),
+                     scenes.end());
+    }
+
+    return scenes;
+}
+
+// Parse a strictly positive or zero integer argument
+bool parseUnsigned(const char* text, rp3d::uint32& value) {
+
+    char* end = nullptr;
+    const long result = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || result < 0) return false;
+
+    value = static_cast<rp3d::uint32>(result);
+    return true;
+}
+
+}
+
+// Main function
+int main(int argc, char** argv) {
+
+    BenchmarkSettings settings;
+    std::string sceneName = "all";
+    std::string outputPath;
+
+    for (int i=1; i < argc; i++) {
+
+        const std::string argument = argv[i];
+
+        if (argument == "--help" || argument == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument " << argument << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        bool isValid = true;
+
+        if (argument == "--scene") sceneName = value;
+        else if (argument == "--frames") isValid = parseUnsigned(value, settings.nbFrames);
+        else if (argument == "--warmup") isValid = parseUnsigned(value, settings.nbWarmupFrames);
+        else if (argument == "--threads") isValid = parseUnsigned(value, settings.nbThreads) && settings.nbThreads > 0;
+        else if (argument == "--wide-solver") {
+            rp3d::uint32 isEnabled = 0;
+            isValid = parseUnsigned(value, isEnabled) && isEnabled <= 1;
+            settings.isWideContactSolverEnabled = isEnabled == 1;
+        }
+        else if (argument == "--deterministic") {
+            rp3d::uint32 isEnabled = 0;
+            isValid = parseUnsigned(value, isEnabled) && isEnabled <= 1;
+            settings.isDeterministic = isEnabled == 1;
+        }
+        else if (argument == "--predictive-aabb") {
+            rp3d::uint32 isEnabled = 0;
+            isValid = parseUnsigned(value, isEnabled) && isEnabled <= 1;
+            settings.isBroadPhaseFatAABBPredictive = isEnabled == 1;
+        }
+        else if (argument == "--output") outputPath = value;
+        else if (argument == "--trace") settings.traceFilePrefix = value;
+        else isValid = false;
+
+        if (!isValid) {
+            std::cerr << "Invalid argument " << argument << " " << value << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::unique_ptr<BenchmarkScene>> scenes = createScenes(sceneName);
+    if (scenes.empty()) {
+        std::cerr << "Unknown scene " << sceneName << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+#ifndef IS_RP3D_PROFILING_ENABLED
+    if (!settings.traceFilePrefix.empty()) {
+        std::cerr << "The library has been compiled without profiling (RP3D_PROFILING_ENABLED), no trace will be written" << std::endl;
+    }
+#endif
+
+    Benchmark benchmark(settings);
+
+    for (auto& scene : scenes) {
+
+        const BenchmarkResult& result = benchmark.run(*scene);
+
+        // Progress is written on the error output to keep the standard output valid JSON
+        std::cerr << result.sceneName << ": " << result.nbBodies << " bodies, "
+                  << result.totalTime / std::max(1u, result.nbFrames) << " ms/frame" << std::endl;
+    }
+
+    if (outputPath.empty()) {
+        benchmark.writeJson(std::cout);
+    }
+    else {
+        std::ofstream outputFile(outputPath);
+        if (!outputFile.is_open()) {
+            std::cerr << "Unable to open the output file " << outputPath << std::endl;
+            return 1;
+        }
+        benchmark.writeJson(outputFile);
+    }
+
+    return 0;
+}
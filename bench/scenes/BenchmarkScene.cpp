@@ -0,0 +1,149 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "BenchmarkScene.h"
+#include <cmath>
+
+using namespace reactphysics3d;
+
+// Constructor
+BenchmarkScene::BenchmarkScene(const std::string& name)
+               : mName(name), mPhysicsCommon(nullptr), mPhysicsWorld(nullptr), mNbBodies(0),
+                 mConvexMeshVertexArray(nullptr), mConvexMeshShape(nullptr) {
+
+}
+
+// Destructor
+BenchmarkScene::~BenchmarkScene() {
+
+    // The polyhedron mesh, the shapes and the world are released by the PhysicsCommon object
+    delete mConvexMeshVertexArray;
+}
+
+// Create the physics world and the bodies of the scene
+void BenchmarkScene::createPhysicsWorld(PhysicsCommon& physicsCommon, const PhysicsWorld::WorldSettings& worldSettings) {
+
+    mPhysicsCommon = &physicsCommon;
+    mPhysicsWorld = physicsCommon.createPhysicsWorld(worldSettings);
+    mNbBodies = 0;
+
+    createBodies();
+}
+
+// Create a rigid body with a single collider
+RigidBody* BenchmarkScene::createBody(const Vector3& position, CollisionShape* shape, BodyType type) {
+
+    RigidBody* body = mPhysicsWorld->createRigidBody(Transform(position, Quaternion::identity()));
+    body->setType(type);
+    Collider* collider = body->addCollider(shape, Transform::identity());
+    collider->getMaterial().setBounciness(decimal(0.2));
+
+    if (type == BodyType::DYNAMIC) {
+        body->updateMassPropertiesFromColliders();
+    }
+
+    mNbBodies++;
+
+    return body;
+}
+
+// Create a pile of boxes, spheres, capsules and convex meshes above a given position
+/// The bodies are placed on a grid with the different kinds of shapes interleaved so
+/// that every kind of narrow-phase algorithm is used by the scene.
+void BenchmarkScene::createFallingBodies(const Vector3& center, int nbBoxes, int nbSpheres, int nbCapsules,
+                                         int nbConvexMeshes, decimal spacing) {
+
+    // Create the convex mesh (hexagonal prism) the first time we need it
+    if (mConvexMeshShape == nullptr && nbConvexMeshes > 0) {
+
+        const int nbSides = 6;
+        const float radius = 1.0f;
+        const float halfHeight = 1.0f;
+        for (int i=0; i < 2 * nbSides; i++) {
+            const float angle = float(i % nbSides) * 2.0f * float(PI_RP3D) / float(nbSides);
+            mConvexMeshVertices.push_back(radius * std::cos(angle));
+            mConvexMeshVertices.push_back(i < nbSides ? -halfHeight : halfHeight);
+            mConvexMeshVertices.push_back(radius * std::sin(angle));
+        }
+
+        // Bottom and top faces
+        for (int i=0; i < nbSides; i++) mConvexMeshIndices.push_back(i);
+        for (int i=0; i < nbSides; i++) mConvexMeshIndices.push_back(2 * nbSides - 1 - i);
+        mConvexMeshFaces.push_back({uint32(nbSides), 0});
+        mConvexMeshFaces.push_back({uint32(nbSides), uint32(nbSides)});
+
+        // Side faces
+        for (int i=0; i < nbSides; i++) {
+            const int j = (i + 1) % nbSides;
+            mConvexMeshFaces.push_back({4, uint32(mConvexMeshIndices.size())});
+            mConvexMeshIndices.push_back(i);
+            mConvexMeshIndices.push_back(i + nbSides);
+            mConvexMeshIndices.push_back(j + nbSides);
+            mConvexMeshIndices.push_back(j);
+        }
+
+        mConvexMeshVertexArray = new PolygonVertexArray(2 * nbSides, mConvexMeshVertices.data(), 3 * sizeof(float),
+                                                        mConvexMeshIndices.data(), sizeof(int),
+                                                        uint32(mConvexMeshFaces.size()), mConvexMeshFaces.data(),
+                                                        PolygonVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                        PolygonVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+        PolyhedronMesh* polyhedronMesh = mPhysicsCommon->createPolyhedronMesh(mConvexMeshVertexArray);
+        mConvexMeshShape = mPhysicsCommon->createConvexMeshShape(polyhedronMesh);
+    }
+
+    BoxShape* boxShape = mPhysicsCommon->createBoxShape(Vector3(1, 1, 1));
+    SphereShape* sphereShape = mPhysicsCommon->createSphereShape(decimal(1.0));
+    CapsuleShape* capsuleShape = mPhysicsCommon->createCapsuleShape(decimal(0.75), decimal(1.5));
+
+    const int nbBodies = nbBoxes + nbSpheres + nbCapsules + nbConvexMeshes;
+    const int nbBodiesPerSide = 8;
+    const int nbBodiesPerLayer = nbBodiesPerSide * nbBodiesPerSide;
+
+    int nbRemaining[4] = {nbBoxes, nbSpheres, nbCapsules, nbConvexMeshes};
+    CollisionShape* shapes[4] = {boxShape, sphereShape, capsuleShape, mConvexMeshShape};
+    int kind = 0;
+
+    for (int i=0; i < nbBodies; i++) {
+
+        // Select the next kind of shape that still has bodies to create
+        while (nbRemaining[kind] == 0) kind = (kind + 1) % 4;
+        nbRemaining[kind]--;
+
+        const int layer = i / nbBodiesPerLayer;
+        const int row = (i % nbBodiesPerLayer) / nbBodiesPerSide;
+        const int column = i % nbBodiesPerSide;
+
+        // Shift every other layer to avoid perfectly stacked bodies
+        const decimal offset = (layer % 2) * decimal(0.5) * spacing;
+        const Vector3 position = center + Vector3((column - decimal(0.5) * (nbBodiesPerSide - 1)) * spacing + offset,
+                                                  layer * spacing,
+                                                  (row - decimal(0.5) * (nbBodiesPerSide - 1)) * spacing + offset);
+
+        createBody(position, shapes[kind], BodyType::DYNAMIC);
+
+        kind = (kind + 1) % 4;
+    }
+}
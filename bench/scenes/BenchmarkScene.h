@@ -0,0 +1,124 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef BENCHMARK_SCENE_H
+#define BENCHMARK_SCENE_H
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include <string>
+#include <vector>
+
+// Class BenchmarkScene
+/**
+ * This is the base class of the scenes of the benchmark. A scene creates the bodies
+ * of a physics world without any rendering. The shapes, meshes and worlds are owned
+ * by the PhysicsCommon object and are therefore released with it.
+ */
+class BenchmarkScene {
+
+    protected :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Name of the scene
+        std::string mName;
+
+        /// Physics common object used to create the world and the shapes
+        rp3d::PhysicsCommon* mPhysicsCommon;
+
+        /// Physics world of the scene
+        rp3d::PhysicsWorld* mPhysicsWorld;
+
+        /// Number of rigid bodies in the scene
+        rp3d::uint32 mNbBodies;
+
+        /// Vertices of the procedural convex mesh used by the dynamic bodies
+        std::vector<float> mConvexMeshVertices;
+
+        /// Indices of the procedural convex mesh used by the dynamic bodies
+        std::vector<int> mConvexMeshIndices;
+
+        /// Faces of the procedural convex mesh used by the dynamic bodies
+        std::vector<rp3d::PolygonVertexArray::PolygonFace> mConvexMeshFaces;
+
+        /// Polygon vertex array of the procedural convex mesh
+        rp3d::PolygonVertexArray* mConvexMeshVertexArray;
+
+        /// Convex mesh shape used by the dynamic bodies
+        rp3d::ConvexMeshShape* mConvexMeshShape;
+
+        // -------------------- Methods -------------------- //
+
+        /// Create the bodies of the scene
+        virtual void createBodies()=0;
+
+        /// Create a rigid body with a single collider
+        rp3d::RigidBody* createBody(const rp3d::Vector3& position, rp3d::CollisionShape* shape,
+                                    rp3d::BodyType type);
+
+        /// Create a pile of boxes, spheres, capsules and convex meshes above a given position
+        void createFallingBodies(const rp3d::Vector3& center, int nbBoxes, int nbSpheres, int nbCapsules,
+                                 int nbConvexMeshes, rp3d::decimal spacing);
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        BenchmarkScene(const std::string& name);
+
+        /// Destructor
+        virtual ~BenchmarkScene();
+
+        /// Create the physics world and the bodies of the scene
+        void createPhysicsWorld(rp3d::PhysicsCommon& physicsCommon, const rp3d::PhysicsWorld::WorldSettings& worldSettings);
+
+        /// Return the name of the scene
+        const std::string& getName() const;
+
+        /// Return the physics world of the scene
+        rp3d::PhysicsWorld* getPhysicsWorld();
+
+        /// Return the number of rigid bodies in the scene
+        rp3d::uint32 getNbBodies() const;
+};
+
+// Return the name of the scene
+inline const std::string& BenchmarkScene::getName() const {
+    return mName;
+}
+
+// Return the physics world of the scene
+inline rp3d::PhysicsWorld* BenchmarkScene::getPhysicsWorld() {
+    return mPhysicsWorld;
+}
+
+// Return the number of rigid bodies in the scene
+inline rp3d::uint32 BenchmarkScene::getNbBodies() const {
+    return mNbBodies;
+}
+
+#endif
@@ -0,0 +1,95 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "ConcaveMeshScene.h"
+#include <cmath>
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Constants
+const int NB_BOXES = 50;
+const int NB_SPHERES = 50;
+const int NB_CAPSULES = 50;
+const int NB_MESHES = 50;
+const int NB_CELLS_PER_SIDE = 40;
+const float CELL_SIZE = 2.0f;
+const float TERRAIN_AMPLITUDE = 2.0f;
+}
+
+// Constructor
+ConcaveMeshScene::ConcaveMeshScene() : BenchmarkScene("concavemesh"), mTriangleVertexArray(nullptr) {
+
+}
+
+// Destructor
+ConcaveMeshScene::~ConcaveMeshScene() {
+    delete mTriangleVertexArray;
+}
+
+// Create the bodies of the scene
+void ConcaveMeshScene::createBodies() {
+
+    // Create a wavy terrain mesh
+    const int nbVerticesPerSide = NB_CELLS_PER_SIDE + 1;
+    const float halfSize = 0.5f * NB_CELLS_PER_SIDE * CELL_SIZE;
+    mVertices.clear();
+    mIndices.clear();
+    for (int i=0; i < nbVerticesPerSide; i++) {
+        for (int j=0; j < nbVerticesPerSide; j++) {
+            const float x = i * CELL_SIZE - halfSize;
+            const float z = j * CELL_SIZE - halfSize;
+            mVertices.push_back(x);
+            mVertices.push_back(TERRAIN_AMPLITUDE * std::sin(0.2f * x) * std::cos(0.2f * z));
+            mVertices.push_back(z);
+        }
+    }
+    for (int i=0; i < NB_CELLS_PER_SIDE; i++) {
+        for (int j=0; j < NB_CELLS_PER_SIDE; j++) {
+            const int v = i * nbVerticesPerSide + j;
+            mIndices.push_back(v);
+            mIndices.push_back(v + 1);
+            mIndices.push_back(v + nbVerticesPerSide);
+            mIndices.push_back(v + 1);
+            mIndices.push_back(v + nbVerticesPerSide + 1);
+            mIndices.push_back(v + nbVerticesPerSide);
+        }
+    }
+
+    delete mTriangleVertexArray;
+    mTriangleVertexArray = new TriangleVertexArray(uint32(mVertices.size() / 3), mVertices.data(), 3 * sizeof(float),
+                                                   uint32(mIndices.size() / 3), mIndices.data(), 3 * sizeof(int),
+                                                   TriangleVertexArray::VertexDataType::VERTEX_FLOAT_TYPE,
+                                                   TriangleVertexArray::IndexDataType::INDEX_INTEGER_TYPE);
+
+    TriangleMesh* triangleMesh = mPhysicsCommon->createTriangleMesh();
+    triangleMesh->addSubpart(mTriangleVertexArray);
+    ConcaveMeshShape* concaveMeshShape = mPhysicsCommon->createConcaveMeshShape(triangleMesh);
+    createBody(Vector3::zero(), concaveMeshShape, BodyType::STATIC);
+
+    createFallingBodies(Vector3(0, 8, 0), NB_BOXES, NB_SPHERES, NB_CAPSULES, NB_MESHES, decimal(3.0));
+}
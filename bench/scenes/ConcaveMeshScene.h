@@ -0,0 +1,70 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef CONCAVEMESH_SCENE_H
+#define CONCAVEMESH_SCENE_H
+
+// Libraries
+#include "BenchmarkScene.h"
+
+// Class ConcaveMeshScene
+/**
+ * Headless version of the concave mesh scene of the testbed: bodies falling on a
+ * static concave mesh. The terrain mesh is generated procedurally.
+ */
+class ConcaveMeshScene : public BenchmarkScene {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Vertices of the terrain mesh
+        std::vector<float> mVertices;
+
+        /// Indices of the terrain mesh
+        std::vector<int> mIndices;
+
+        /// Triangle vertex array of the terrain mesh
+        rp3d::TriangleVertexArray* mTriangleVertexArray;
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Create the bodies of the scene
+        virtual void createBodies() override;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConcaveMeshScene();
+
+        /// Destructor
+        virtual ~ConcaveMeshScene() override;
+};
+
+#endif
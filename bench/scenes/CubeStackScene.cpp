@@ -0,0 +1,63 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "CubeStackScene.h"
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Constants
+const int NB_FLOORS = 15;
+const Vector3 BOX_SIZE(2, 2, 2);
+const Vector3 FLOOR_SIZE(50, 1, 20);
+}
+
+// Constructor
+CubeStackScene::CubeStackScene() : BenchmarkScene("cubestack") {
+
+}
+
+// Create the bodies of the scene
+void CubeStackScene::createBodies() {
+
+    BoxShape* boxShape = mPhysicsCommon->createBoxShape(BOX_SIZE * decimal(0.5));
+
+    for (int i=NB_FLOORS; i > 0; i--) {
+        for (int j=0; j < i; j++) {
+
+            const Vector3 position((-i * decimal(0.5) + j) * (decimal(0.1) + BOX_SIZE.x),
+                                   BOX_SIZE.y + (NB_FLOORS - i) * (BOX_SIZE.y + decimal(0.1)),
+                                   0);
+
+            createBody(position, boxShape, BodyType::DYNAMIC);
+        }
+    }
+
+    // Floor
+    BoxShape* floorShape = mPhysicsCommon->createBoxShape(FLOOR_SIZE * decimal(0.5));
+    createBody(Vector3::zero(), floorShape, BodyType::STATIC);
+}
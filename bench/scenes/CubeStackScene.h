@@ -0,0 +1,54 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef CUBESTACK_SCENE_H
+#define CUBESTACK_SCENE_H
+
+// Libraries
+#include "BenchmarkScene.h"
+
+// Class CubeStackScene
+/**
+ * Headless version of the cube stack scene of the testbed: a pyramid of boxes
+ * resting on a static floor.
+ */
+class CubeStackScene : public BenchmarkScene {
+
+    protected :
+
+        // -------------------- Methods -------------------- //
+
+        /// Create the bodies of the scene
+        virtual void createBodies() override;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        CubeStackScene();
+};
+
+#endif
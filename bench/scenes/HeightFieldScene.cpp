@@ -0,0 +1,73 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "HeightFieldScene.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Constants
+const int NB_BOXES = 50;
+const int NB_SPHERES = 50;
+const int NB_CAPSULES = 50;
+const int NB_MESHES = 50;
+const int NB_POINTS_PER_SIDE = 64;
+const float TERRAIN_AMPLITUDE = 3.0f;
+const decimal CELL_SIZE = decimal(1.5);
+}
+
+// Constructor
+HeightFieldScene::HeightFieldScene() : BenchmarkScene("heightfield") {
+
+}
+
+// Create the bodies of the scene
+void HeightFieldScene::createBodies() {
+
+    // Create the height values
+    mHeightData.resize(NB_POINTS_PER_SIDE * NB_POINTS_PER_SIDE);
+    float minHeight = 0;
+    float maxHeight = 0;
+    for (int i=0; i < NB_POINTS_PER_SIDE; i++) {
+        for (int j=0; j < NB_POINTS_PER_SIDE; j++) {
+            const float height = TERRAIN_AMPLITUDE * std::sin(0.25f * i) * std::cos(0.2f * j);
+            mHeightData[i * NB_POINTS_PER_SIDE + j] = height;
+            minHeight = std::min(minHeight, height);
+            maxHeight = std::max(maxHeight, height);
+        }
+    }
+
+    HeightFieldShape* heightFieldShape = mPhysicsCommon->createHeightFieldShape(NB_POINTS_PER_SIDE, NB_POINTS_PER_SIDE,
+                                                                                 minHeight, maxHeight, mHeightData.data(),
+                                                                                 HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE,
+                                                                                 1, 1, Vector3(CELL_SIZE, 1, CELL_SIZE));
+    createBody(Vector3::zero(), heightFieldShape, BodyType::STATIC);
+
+    createFallingBodies(Vector3(0, 8, 0), NB_BOXES, NB_SPHERES, NB_CAPSULES, NB_MESHES, decimal(3.0));
+}
@@ -0,0 +1,65 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "PileScene.h"
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Constants
+const int NB_BOXES = 100;
+const int NB_SPHERES = 40;
+const int NB_CAPSULES = 30;
+const int NB_MESHES = 30;
+const decimal CONTAINER_HALF_SIZE = decimal(12.0);
+const decimal WALL_HALF_THICKNESS = decimal(0.5);
+const decimal WALL_HALF_HEIGHT = decimal(6.0);
+}
+
+// Constructor
+PileScene::PileScene() : BenchmarkScene("pile") {
+
+}
+
+// Create the bodies of the scene
+void PileScene::createBodies() {
+
+    // Floor
+    BoxShape* floorShape = mPhysicsCommon->createBoxShape(Vector3(CONTAINER_HALF_SIZE, WALL_HALF_THICKNESS, CONTAINER_HALF_SIZE));
+    createBody(Vector3(0, -WALL_HALF_THICKNESS, 0), floorShape, BodyType::STATIC);
+
+    // Walls
+    BoxShape* wallShapeX = mPhysicsCommon->createBoxShape(Vector3(WALL_HALF_THICKNESS, WALL_HALF_HEIGHT, CONTAINER_HALF_SIZE));
+    BoxShape* wallShapeZ = mPhysicsCommon->createBoxShape(Vector3(CONTAINER_HALF_SIZE, WALL_HALF_HEIGHT, WALL_HALF_THICKNESS));
+    const decimal wallDistance = CONTAINER_HALF_SIZE + WALL_HALF_THICKNESS;
+    createBody(Vector3(-wallDistance, WALL_HALF_HEIGHT, 0), wallShapeX, BodyType::STATIC);
+    createBody(Vector3(wallDistance, WALL_HALF_HEIGHT, 0), wallShapeX, BodyType::STATIC);
+    createBody(Vector3(0, WALL_HALF_HEIGHT, -wallDistance), wallShapeZ, BodyType::STATIC);
+    createBody(Vector3(0, WALL_HALF_HEIGHT, wallDistance), wallShapeZ, BodyType::STATIC);
+
+    createFallingBodies(Vector3(0, 5, 0), NB_BOXES, NB_SPHERES, NB_CAPSULES, NB_MESHES, decimal(2.5));
+}
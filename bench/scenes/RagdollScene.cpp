@@ -0,0 +1,122 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include "RagdollScene.h"
+
+using namespace reactphysics3d;
+
+namespace {
+
+// Constants
+const int NB_RAGDOLLS_ROWS = 4;
+const int NB_RAGDOLLS_COLS = 4;
+const int NB_RAGDOLLS_LAYERS = 2;
+const decimal RAGDOLLS_SPACING = decimal(5.0);
+const decimal RAGDOLLS_LAYER_HEIGHT = decimal(12.0);
+const Vector3 FLOOR_SIZE(52, 1, 52);
+}
+
+// Constructor
+RagdollScene::RagdollScene() : BenchmarkScene("ragdoll") {
+
+}
+
+// Create the bodies of the scene
+void RagdollScene::createBodies() {
+
+    for (int l=0; l < NB_RAGDOLLS_LAYERS; l++) {
+        for (int i=0; i < NB_RAGDOLLS_ROWS; i++) {
+            for (int j=0; j < NB_RAGDOLLS_COLS; j++) {
+
+                // Shift every other layer so that the ragdolls fall on each other
+                const decimal offset = (l % 2) * decimal(0.5) * RAGDOLLS_SPACING;
+                createRagdoll(Vector3((i - decimal(0.5) * (NB_RAGDOLLS_ROWS - 1)) * RAGDOLLS_SPACING + offset,
+                                      decimal(1.0) + l * RAGDOLLS_LAYER_HEIGHT,
+                                      (j - decimal(0.5) * (NB_RAGDOLLS_COLS - 1)) * RAGDOLLS_SPACING + offset));
+            }
+        }
+    }
+
+    // Floor
+    BoxShape* floorShape = mPhysicsCommon->createBoxShape(FLOOR_SIZE * decimal(0.5));
+    createBody(Vector3(0, -decimal(0.5) * FLOOR_SIZE.y, 0), floorShape, BodyType::STATIC);
+}
+
+// Create a ragdoll at a given position
+/// The bodies of a ragdoll are the head, the chest, the waist and two bodies per arm and
+/// per leg. The given position is the position of the feet of the ragdoll.
+void RagdollScene::createRagdoll(const Vector3& position) {
+
+    SphereShape* headShape = mPhysicsCommon->createSphereShape(decimal(0.75));
+    CapsuleShape* chestShape = mPhysicsCommon->createCapsuleShape(decimal(0.7), decimal(0.6));
+    CapsuleShape* waistShape = mPhysicsCommon->createCapsuleShape(decimal(0.6), decimal(0.4));
+    CapsuleShape* upperArmShape = mPhysicsCommon->createCapsuleShape(decimal(0.35), decimal(1.2));
+    CapsuleShape* lowerArmShape = mPhysicsCommon->createCapsuleShape(decimal(0.3), decimal(1.2));
+    CapsuleShape* upperLegShape = mPhysicsCommon->createCapsuleShape(decimal(0.4), decimal(1.4));
+    CapsuleShape* lowerLegShape = mPhysicsCommon->createCapsuleShape(decimal(0.35), decimal(1.6));
+
+    RigidBody* head = createBody(position + Vector3(0, 9.0, 0), headShape, BodyType::DYNAMIC);
+    RigidBody* chest = createBody(position + Vector3(0, 7.4, 0), chestShape, BodyType::DYNAMIC);
+    RigidBody* waist = createBody(position + Vector3(0, 5.8, 0), waistShape, BodyType::DYNAMIC);
+
+    BallAndSocketJointInfo headJointInfo(head, chest, position + Vector3(0, 8.25, 0));
+    headJointInfo.isCollisionEnabled = false;
+    mPhysicsWorld->createJoint(headJointInfo);
+
+    BallAndSocketJointInfo waistJointInfo(chest, waist, position + Vector3(0, 6.5, 0));
+    waistJointInfo.isCollisionEnabled = false;
+    mPhysicsWorld->createJoint(waistJointInfo);
+
+    // For the left and right sides
+    for (int side = -1; side <= 1; side += 2) {
+
+        const decimal armX = side * decimal(1.6);
+        const decimal legX = side * decimal(0.5);
+
+        RigidBody* upperArm = createBody(position + Vector3(armX, 7.0, 0), upperArmShape, BodyType::DYNAMIC);
+        RigidBody* lowerArm = createBody(position + Vector3(armX, 4.9, 0), lowerArmShape, BodyType::DYNAMIC);
+        RigidBody* upperLeg = createBody(position + Vector3(legX, 4.0, 0), upperLegShape, BodyType::DYNAMIC);
+        RigidBody* lowerLeg = createBody(position + Vector3(legX, 1.7, 0), lowerLegShape, BodyType::DYNAMIC);
+
+        BallAndSocketJointInfo shoulderJointInfo(chest, upperArm, position + Vector3(armX, 8.0, 0));
+        shoulderJointInfo.isCollisionEnabled = false;
+        mPhysicsWorld->createJoint(shoulderJointInfo);
+
+        HingeJointInfo elbowJointInfo(upperArm, lowerArm, position + Vector3(armX, 5.9, 0), Vector3(1, 0, 0),
+                                      -PI_RP3D * decimal(0.5), decimal(0.0));
+        elbowJointInfo.isCollisionEnabled = false;
+        mPhysicsWorld->createJoint(elbowJointInfo);
+
+        BallAndSocketJointInfo hipJointInfo(waist, upperLeg, position + Vector3(legX, 5.1, 0));
+        hipJointInfo.isCollisionEnabled = false;
+        mPhysicsWorld->createJoint(hipJointInfo);
+
+        HingeJointInfo kneeJointInfo(upperLeg, lowerLeg, position + Vector3(legX, 2.9, 0), Vector3(1, 0, 0),
+                                     decimal(0.0), PI_RP3D * decimal(0.5));
+        kneeJointInfo.isCollisionEnabled = false;
+        mPhysicsWorld->createJoint(kneeJointInfo);
+    }
+}
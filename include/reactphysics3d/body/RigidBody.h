@@ -65,6 +65,9 @@ class RigidBody : public CollisionBody {
         /// Compute the inverse of the inertia tensor in world coordinates.
         static void computeWorldInertiaTensorInverse(const Matrix3x3& orientation, const Vector3& inverseInertiaTensorLocal, Matrix3x3& outInverseInertiaTensorWorld);
 
+        /// Create a new collider without adding it to the broad-phase and compute its world-space AABB
+        Collider* createCollider(CollisionShape* collisionShape, const Transform& transform, AABB& outWorldAABB);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -0,0 +1,108 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_RAY_PACKET_H
+#define REACTPHYSICS3D_RAY_PACKET_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/mathematics/Ray.h>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Structure RayPacket
+/**
+ * This structure represents a packet of rays that traverse an AABB tree together. The
+ * origins, inverse directions and maximum fractions of the rays are stored per coordinate
+ * (structure of arrays) so that an AABB is tested against all the rays of the packet with a
+ * single SSE2 or NEON slab test. A node of the tree is only visited once for all the rays of
+ * the packet that hit it, so the rays of a packet should be coherent (close origins and
+ * similar directions). The rays are identified by their lane in the packet and a mask of
+ * rays has one bit per lane.
+ */
+struct RayPacket {
+
+    // -------------------- Constants -------------------- //
+
+    /// Maximum number of rays in a packet
+    static constexpr uint32 NB_MAX_RAYS = 4;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Origins of the rays
+    decimal originX[NB_MAX_RAYS];
+    decimal originY[NB_MAX_RAYS];
+    decimal originZ[NB_MAX_RAYS];
+
+    /// Inverse directions of the rays
+    decimal directionInverseX[NB_MAX_RAYS];
+    decimal directionInverseY[NB_MAX_RAYS];
+    decimal directionInverseZ[NB_MAX_RAYS];
+
+    /// Current maximum fractions of the rays (reduced when a ray hits a shape)
+    decimal maxFractions[NB_MAX_RAYS];
+
+    /// Pointers to the rays
+    const Ray* rays[NB_MAX_RAYS];
+
+    /// Indices of the rays in the batch of rays the packet has been created from
+    uint32 rayIndices[NB_MAX_RAYS];
+
+    /// Number of rays in the packet
+    uint32 nbRays;
+
+    /// Mask of the rays that have not been terminated
+    uint32 activeRaysMask;
+
+    // -------------------- Methods -------------------- //
+
+    /// Constructor
+    RayPacket() : nbRays(0), activeRaysMask(0) {
+
+    }
+
+    /// Add a ray into the packet
+    void addRay(const Ray& ray, uint32 rayIndex);
+
+    /// Terminate a ray (the ray will not be tested anymore)
+    void terminateRay(uint32 lane);
+
+    /// Return the mask of the rays (among a given mask) that hit an AABB
+    uint32 testAABB(const Vector3& aabbMin, const Vector3& aabbMax, uint32 raysMask, decimal* outEnterFractions) const;
+
+    /// Return the mask of the rays (among a given mask) that hit an AABB (scalar version)
+    uint32 testAABBScalar(const Vector3& aabbMin, const Vector3& aabbMax, uint32 raysMask, decimal* outEnterFractions) const;
+};
+
+// Terminate a ray (the ray will not be tested anymore)
+RP3D_FORCE_INLINE void RayPacket::terminateRay(uint32 lane) {
+    assert(lane < nbRays);
+    activeRaysMask &= ~(1u << lane);
+}
+
+}
+
+#endif
@@ -37,6 +37,13 @@ class CollisionBody;
 class Collider;
 class CollisionShape;
 struct Ray;
+struct RayPacket;
+
+/// Enumeration for the result of each ray of a batch raycast
+/// CLOSEST_HIT : The closest hit along the ray is reported
+/// ANY_HIT : The first hit found along the ray is reported and the ray is not tested anymore.
+///           This is faster when only the visibility between two points is needed.
+enum class RaycastBatchMode {CLOSEST_HIT, ANY_HIT};
 
 // Structure RaycastInfo
 /**
@@ -89,6 +96,54 @@ struct RaycastInfo {
         RaycastInfo& operator=(const RaycastInfo& raycastInfo) = delete;
 };
 
+// Structure RaycastHit
+/**
+ * This structure contains the result of a ray of a batch raycast (see
+ * PhysicsWorld::raycastBatch()). Contrary to RaycastInfo, it can be copied so
+ * that the results of all the rays of a batch are stored in a flat array. The
+ * collider is null if the ray has not hit anything and the other attributes
+ * are only valid if the ray has hit a collider.
+ */
+struct RaycastHit {
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Hit point in world-space coordinates
+        Vector3 worldPoint;
+
+        /// Surface normal at hit point in world-space coordinates
+        Vector3 worldNormal;
+
+        /// Fraction distance of the hit point between point1 and point2 of the ray
+        decimal hitFraction;
+
+        /// Mesh subpart index that has been hit (only used for triangles mesh and -1 otherwise)
+        int meshSubpart;
+
+        /// Hit triangle index (only used for triangles mesh and -1 otherwise)
+        int triangleIndex;
+
+        /// Pointer to the hit collision body
+        CollisionBody* body;
+
+        /// Pointer to the hit collider (null if the ray has not hit anything)
+        Collider* collider;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        RaycastHit() : hitFraction(decimal(0.0)), meshSubpart(-1), triangleIndex(-1), body(nullptr), collider(nullptr) {
+
+        }
+
+        /// Return true if the ray has hit a collider
+        bool isHit() const {
+            return collider != nullptr;
+        }
+};
+
 // Class RaycastCallback
 /**
  * This class can be used to register a callback for ray casting queries.
@@ -144,6 +199,27 @@ struct RaycastTest {
         decimal raycastAgainstShape(Collider* shape, const Ray& ray);
 };
 
+/// Structure RaycastBatchTest
+struct RaycastBatchTest {
+
+    public:
+
+        /// Array with the result of each ray of the batch
+        RaycastHit* hits;
+
+        /// Result to find for each ray
+        RaycastBatchMode mode;
+
+        /// Constructor
+        RaycastBatchTest(RaycastHit* outHits, RaycastBatchMode batchMode) {
+            hits = outHits;
+            mode = batchMode;
+        }
+
+        /// Ray cast test of some rays of a packet against a collider
+        void raycastAgainstShape(Collider* shape, RayPacket& packet, uint32 raysMask);
+};
+
 }
 
 #endif
@@ -30,6 +30,7 @@
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/collision/shapes/AABB.h>
 #include <reactphysics3d/containers/Set.h>
+#include <reactphysics3d/containers/Stack.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -40,9 +41,12 @@ class BroadPhaseRaycastTestCallback;
 class DynamicAABBTreeOverlapCallback;
 class CollisionBody;
 struct RaycastTest;
+struct RayPacket;
 class AABB;
 class Profiler;
 class MemoryAllocator;
+class SnapshotWriter;
+class SnapshotReader;
 
 
 // Structure TreeNode
@@ -132,6 +136,23 @@ class DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class DynamicAABBTreeRaycastPacketCallback
+/**
+ * Raycast callback in the Dynamic AABB Tree called when the AABB of a leaf
+ * node is hit by some rays of a packet.
+ */
+class DynamicAABBTreeRaycastPacketCallback {
+
+    public:
+
+        // Called when the AABB of a leaf node is hit by some rays of a packet. The callback must
+        // reduce the maximum fraction of the rays that hit the shape or terminate them.
+        virtual void raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 raysMask)=0;
+
+        virtual ~DynamicAABBTreeRaycastPacketCallback() = default;
+
+};
+
 // Class DynamicAABBTree
 /**
  * This class implements a dynamic AABB tree that is used for broad-phase
@@ -143,6 +164,36 @@ class DynamicAABBTree {
 
     private:
 
+        // -------------------- Constants -------------------- //
+
+        /// Number of bins used to find the best split of a sub-tree built with the SAH
+        static const int32 NB_SAH_BINS;
+
+        // -------------------- Structures -------------------- //
+
+        /// Leaf node of a tree built in bulk
+        struct BulkLeafNode {
+
+            /// Fat AABB of the node
+            AABB aabb;
+
+            /// Center of the fat AABB of the node
+            Vector3 center;
+
+            /// ID of the node
+            int32 nodeID;
+        };
+
+        /// Bin used to evaluate the surface area heuristic (SAH) of the possible splits of a sub-tree
+        struct SAHBin {
+
+            /// AABB of the leaf nodes in the bin
+            AABB aabb;
+
+            /// Number of leaf nodes in the bin
+            int32 nbLeafNodes;
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Memory allocator
@@ -166,6 +217,15 @@ class DynamicAABBTree {
         /// The fat AABB is the initial AABB inflated by a given percentage of its size.
         decimal mFatAABBInflatePercentage;
 
+        /// Minimum margin between the AABB of an object and its fat AABB
+        decimal mFatAABBMinMargin;
+
+        /// Maximum margin between the AABB of an object and its fat AABB (in each direction)
+        decimal mFatAABBMaxMargin;
+
+        /// The fat AABB is extruded along the displacement of the object multiplied by this factor
+        decimal mFatAABBDisplacementFactor;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Pointer to the profiler
@@ -178,6 +238,21 @@ class DynamicAABBTree {
         /// Allocate and return a node to use in the tree
         int32 allocateNode();
 
+        /// Allocate memory for at least a given number of nodes
+        void reserveNodes(int32 nbNodes);
+
+        /// Allocate a new leaf node with the fat AABB of an object
+        int32 createLeafNode(const AABB& aabb);
+
+        /// Compute the fat AABB of an object
+        AABB computeFatAABB(const AABB& aabb, const Vector3& displacement) const;
+
+        /// Build the whole tree with the leaf nodes already in the tree and some new objects
+        void buildTree(const AABB* aabbs, uint32 nbObjects, int32* outNodeIDs);
+
+        /// Build a sub-tree with some leaf nodes using the surface area heuristic (SAH) and return its root node
+        int32 buildSubTree(BulkLeafNode* leafNodes, int32 nbLeafNodes);
+
         /// Release a node
         void releaseNode(int32 nodeID);
 
@@ -199,6 +274,10 @@ class DynamicAABBTree {
         /// Initialize the tree
         void init();
 
+        /// Read the attributes of a tree in a snapshot and return true if its nodes can be read
+        static bool readSnapshotHeader(SnapshotReader& reader, int32& rootNodeID, int32& freeNodeID,
+                                       int32& nbAllocatedNodes, int32& nbNodes);
+
 #ifndef NDEBUG
 
         /// Check if the tree structure is valid (for debugging purpose)
@@ -225,11 +304,18 @@ class DynamicAABBTree {
         /// Add an object into the tree (where node data is a pointer)
         int32 addObject(const AABB& aabb, void* data);
 
+        /// Add several objects into the tree at once
+        void addObjects(const AABB* aabbs, uint32 nbObjects, int32* outNodeIDs);
+
         /// Remove an object from the tree
         void removeObject(int32 nodeID);
 
         /// Update the dynamic tree after an object has moved.
-        bool updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert = false);
+        bool updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert = false,
+                          const Vector3& displacement = Vector3::zero());
+
+        /// Set the margins of the fat AABBs and the factor of their extrusion along the displacement of the objects
+        void setFatAABBMargins(decimal minMargin, decimal maxMargin, decimal displacementFactor);
 
         /// Return the fat AABB corresponding to a given node ID
         const AABB& getFatAABB(int32 nodeID) const;
@@ -240,6 +326,12 @@ class DynamicAABBTree {
         /// Return the data pointer of a given leaf node of the tree
         void* getNodeDataPointer(int32 nodeID) const;
 
+        /// Set the data pointer of a given leaf node of the tree
+        void setNodeDataPointer(int32 nodeID, void* data);
+
+        /// Set the two integers data of a given leaf node of the tree
+        void setNodeDataInt(int32 nodeID, int32 data1, int32 data2);
+
         /// Report all shapes overlapping with all the shapes in the map in parameter
         void reportAllShapesOverlappingWithShapes(const Array<int32>& nodesToTest, uint32 startIndex,
                                                   size_t endIndex, Array<Pair<int32, int32>>& outOverlappingNodes) const;
@@ -247,8 +339,16 @@ class DynamicAABBTree {
         /// Report all shapes overlapping with the AABB given in parameter.
         void reportAllShapesOverlappingWithAABB(const AABB& aabb, Array<int>& overlappingNodes) const;
 
+        /// Report all the leaf nodes overlapping with the AABB of a shape
+        void reportAllShapesOverlappingWithShape(int32 shapeID, const AABB& shapeAABB, Stack<int32>& stack,
+                                                 Array<Pair<int32, int32>>& outOverlappingNodes) const;
+
         /// Ray casting method
-        void raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+        decimal raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Ray casting method for a packet of rays
+        void raycastPacket(RayPacket& packet, DynamicAABBTreeRaycastPacketCallback& callback,
+                           Stack<Pair<int32, uint32>>& stack) const;
 
         /// Compute the height of the tree
         int computeHeight();
@@ -256,9 +356,24 @@ class DynamicAABBTree {
         /// Return the root AABB of the tree
         AABB getRootAABB() const;
 
+        /// Rebuild the whole tree using the surface area heuristic (SAH)
+        void rebuild();
+
+        /// Return the surface area heuristic (SAH) cost of the tree
+        decimal computeSAHCost() const;
+
         /// Clear all the nodes and reset the tree
         void reset();
 
+        /// Save the nodes of the tree into a snapshot
+        void saveSnapshot(SnapshotWriter& writer) const;
+
+        /// Restore the nodes of the tree from a snapshot
+        void restoreSnapshot(SnapshotReader& reader);
+
+        /// Skip the nodes of a tree in a snapshot and return true if they can be restored
+        bool skipSnapshot(SnapshotReader& reader) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -266,6 +381,10 @@ class DynamicAABBTree {
 
 #endif
 
+        // -------------------- Friendship -------------------- //
+
+        friend class QuantizedAABBTree;
+        friend class WideAABBTree;
 };
 
 // Return true if the node is a leaf of the tree
@@ -293,6 +412,21 @@ RP3D_FORCE_INLINE void* DynamicAABBTree::getNodeDataPointer(int32 nodeID) const
     return mNodes[nodeID].dataPointer;
 }
 
+// Set the data pointer of a given leaf node of the tree
+RP3D_FORCE_INLINE void DynamicAABBTree::setNodeDataPointer(int32 nodeID, void* data) {
+    assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
+    assert(mNodes[nodeID].isLeaf());
+    mNodes[nodeID].dataPointer = data;
+}
+
+// Set the two integers data of a given leaf node of the tree
+RP3D_FORCE_INLINE void DynamicAABBTree::setNodeDataInt(int32 nodeID, int32 data1, int32 data2) {
+    assert(nodeID >= 0 && nodeID < mNbAllocatedNodes);
+    assert(mNodes[nodeID].isLeaf());
+    mNodes[nodeID].dataInt[0] = data1;
+    mNodes[nodeID].dataInt[1] = data2;
+}
+
 // Return the root AABB of the tree
 RP3D_FORCE_INLINE AABB DynamicAABBTree::getRootAABB() const {
     return getFatAABB(mRootNodeID);
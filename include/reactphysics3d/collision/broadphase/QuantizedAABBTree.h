@@ -0,0 +1,258 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_QUANTIZED_AABB_TREE_H
+#define REACTPHYSICS3D_QUANTIZED_AABB_TREE_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
+#include <reactphysics3d/containers/Array.h>
+#include <reactphysics3d/containers/Pair.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class DynamicAABBTree;
+class DynamicAABBTreeRaycastCallback;
+class MemoryAllocator;
+class Profiler;
+
+// Structure QuantizedTreeNode
+/**
+ * This structure represents a node of a quantized AABB tree. The bounds of the node
+ * are stored with 16 bits integers relative to the AABB of the root of the tree so
+ * that a node only takes 32 bytes (two nodes per cache line).
+ */
+struct QuantizedTreeNode {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Quantized minimum coordinates of the AABB of the node
+    uint16 quantizedMin[3];
+
+    /// Quantized maximum coordinates of the AABB of the node
+    uint16 quantizedMax[3];
+
+    /// Index of the first node after the sub-tree of this node in depth-first order. The left child
+    /// of an internal node is the next node and its right child is the escape node of its left child.
+    int32 escapeIndex;
+
+    /// Two pieces of data stored at that node (in case the node is a leaf)
+    union {
+        int32 dataInt[2];
+        void* dataPointer;
+    };
+
+    /// ID of the leaf node in the dynamic AABB tree this tree has been built from (-1 for an internal node)
+    int32 sourceNodeID;
+
+    /// Unused (the nodes are 32 bytes large)
+    int32 padding;
+};
+
+// Class QuantizedAABBTree
+/**
+ * This class is a compact read-only copy of a dynamic AABB tree. The nodes are stored
+ * in depth-first order in a single array aligned on a cache line and their bounds are
+ * quantized with 16 bits integers. The bounds are rounded outwards such that a quantized
+ * AABB always contains the AABB of the original node. The queries report the indices of
+ * the leaf nodes in this tree. The tree must be built again if the dynamic AABB tree is
+ * modified. It is used for the static geometry (the triangles of a concave mesh and the
+ * colliders of the static bodies).
+ */
+class QuantizedAABBTree {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Largest quantized coordinate
+        static const decimal MAX_QUANTIZED_VALUE;
+
+        /// Alignment of the array of nodes (size of a cache line)
+        static const size_t NODES_ALIGNMENT;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Memory allocated for the nodes (not aligned)
+        void* mNodesMemory;
+
+        /// Array of the nodes in depth-first order (aligned on a cache line)
+        QuantizedTreeNode* mNodes;
+
+        /// Number of nodes in the tree
+        int32 mNbNodes;
+
+        /// Number of nodes that fit in the allocated memory
+        int32 mNbAllocatedNodes;
+
+        /// AABB of the root of the tree
+        AABB mRootAABB;
+
+        /// Factors to convert a coordinate relative to the minimum of the root AABB into a quantized value
+        Vector3 mQuantizationScale;
+
+        /// Factors to convert a quantized value into a coordinate relative to the minimum of the root AABB
+        Vector3 mDequantizationScale;
+
+        /// Origins of the dequantized minimum and maximum coordinates. They are the minimum of the root
+        /// AABB moved outwards by the rounding error of the dequantization in world-space so that a
+        /// dequantized AABB always contains the AABB of the original node even far from the origin.
+        Vector3 mDequantizationMinOrigin;
+        Vector3 mDequantizationMaxOrigin;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Pointer to the profiler
+		Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Copy a sub-tree of a dynamic AABB tree in depth-first order and return the next free index
+        int32 copySubTree(const DynamicAABBTree& tree, int32 sourceNodeID, int32 index);
+
+        /// Quantize the minimum and maximum coordinates of an AABB (rounded outwards)
+        void quantizeAABB(const AABB& aabb, uint16* outQuantizedMin, uint16* outQuantizedMax) const;
+
+        /// Return the AABB of a node in world-space coordinates
+        AABB dequantizeAABB(const QuantizedTreeNode& node) const;
+
+        /// Allocate memory for at least a given number of nodes
+        void reserveNodes(int32 nbNodes);
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        QuantizedAABBTree(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~QuantizedAABBTree();
+
+        /// Deleted copy-constructor
+        QuantizedAABBTree(const QuantizedAABBTree& tree) = delete;
+
+        /// Deleted assignment operator
+        QuantizedAABBTree& operator=(const QuantizedAABBTree& tree) = delete;
+
+        /// Build the tree from a dynamic AABB tree
+        void build(const DynamicAABBTree& tree);
+
+        /// Clear all the nodes of the tree
+        void reset();
+
+        /// Return the number of nodes in the tree
+        int32 getNbNodes() const;
+
+        /// Return the number of bytes used by the nodes of the tree
+        size_t getNodesSizeInBytes() const;
+
+        /// Return the AABB of the root of the tree
+        const AABB& getRootAABB() const;
+
+        /// Return the pointer to the data array of a given leaf node of the tree
+        const int32* getNodeDataInt(int32 nodeIndex) const;
+
+        /// Return the data pointer of a given leaf node of the tree
+        void* getNodeDataPointer(int32 nodeIndex) const;
+
+        /// Return the ID of a leaf node in the dynamic AABB tree the tree has been built from
+        int32 getSourceNodeID(int32 nodeIndex) const;
+
+        /// Report all the leaf nodes overlapping with the AABB given in parameter
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, Array<int32>& overlappingNodes) const;
+
+        /// Report all the leaf nodes overlapping with the AABB of a shape
+        void reportAllShapesOverlappingWithShape(int32 shapeID, const AABB& shapeAABB,
+                                                 Array<Pair<int32, int32>>& outOverlappingNodes) const;
+
+        /// Ray casting method
+        decimal raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Set the profiler
+		void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return the number of nodes in the tree
+RP3D_FORCE_INLINE int32 QuantizedAABBTree::getNbNodes() const {
+    return mNbNodes;
+}
+
+// Return the number of bytes used by the nodes of the tree
+RP3D_FORCE_INLINE size_t QuantizedAABBTree::getNodesSizeInBytes() const {
+    return static_cast<size_t>(mNbNodes) * sizeof(QuantizedTreeNode);
+}
+
+// Return the AABB of the root of the tree
+RP3D_FORCE_INLINE const AABB& QuantizedAABBTree::getRootAABB() const {
+    return mRootAABB;
+}
+
+// Return the pointer to the data array of a given leaf node of the tree
+RP3D_FORCE_INLINE const int32* QuantizedAABBTree::getNodeDataInt(int32 nodeIndex) const {
+    assert(nodeIndex >= 0 && nodeIndex < mNbNodes);
+    assert(mNodes[nodeIndex].escapeIndex == nodeIndex + 1);
+    return mNodes[nodeIndex].dataInt;
+}
+
+// Return the data pointer of a given leaf node of the tree
+RP3D_FORCE_INLINE void* QuantizedAABBTree::getNodeDataPointer(int32 nodeIndex) const {
+    assert(nodeIndex >= 0 && nodeIndex < mNbNodes);
+    assert(mNodes[nodeIndex].escapeIndex == nodeIndex + 1);
+    return mNodes[nodeIndex].dataPointer;
+}
+
+// Return the ID of a leaf node in the dynamic AABB tree the tree has been built from
+RP3D_FORCE_INLINE int32 QuantizedAABBTree::getSourceNodeID(int32 nodeIndex) const {
+    assert(nodeIndex >= 0 && nodeIndex < mNbNodes);
+    assert(mNodes[nodeIndex].escapeIndex == nodeIndex + 1);
+    return mNodes[nodeIndex].sourceNodeID;
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+RP3D_FORCE_INLINE void QuantizedAABBTree::setProfiler(Profiler* profiler) {
+	mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,331 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WIDE_AABB_TREE_H
+#define REACTPHYSICS3D_WIDE_AABB_TREE_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/collision/shapes/AABB.h>
+#include <reactphysics3d/containers/Array.h>
+#include <reactphysics3d/containers/Pair.h>
+#include <reactphysics3d/containers/Stack.h>
+
+/// Namespace ReactPhysics3D
+namespace reactphysics3d {
+
+// Declarations
+class DynamicAABBTree;
+class DynamicAABBTreeRaycastCallback;
+class DynamicAABBTreeRaycastPacketCallback;
+class MemoryAllocator;
+class Profiler;
+struct RayPacket;
+
+// Structure WideTreeNode
+/**
+ * This structure represents an internal node of a wide AABB tree. A node has up to four
+ * children whose bounds are quantized with 16 bits integers relative to the AABB of the
+ * root of the tree. The bounds are stored per coordinate (structure of arrays) so that
+ * the four children are tested with a single SIMD slab test. A node takes exactly one
+ * cache line (64 bytes).
+ */
+struct WideTreeNode {
+
+    // -------------------- Constants -------------------- //
+
+    /// Maximum number of children of a node
+    static constexpr int32 NB_CHILDREN = 4;
+
+    /// Value of an unused child slot (the root node is never the child of another node)
+    static constexpr int32 EMPTY_CHILD = 0;
+
+    // -------------------- Attributes -------------------- //
+
+    /// Quantized minimum x, y and z coordinates of the AABBs of the children
+    uint16 quantizedMinX[NB_CHILDREN];
+    uint16 quantizedMinY[NB_CHILDREN];
+    uint16 quantizedMinZ[NB_CHILDREN];
+
+    /// Quantized maximum x, y and z coordinates of the AABBs of the children
+    uint16 quantizedMaxX[NB_CHILDREN];
+    uint16 quantizedMaxY[NB_CHILDREN];
+    uint16 quantizedMaxZ[NB_CHILDREN];
+
+    /// Children of the node. A positive value is the index of an internal node, a negative
+    /// value -(i + 1) is the leaf i and EMPTY_CHILD is an unused slot. The used slots always
+    /// come first.
+    int32 children[NB_CHILDREN];
+
+    // -------------------- Methods -------------------- //
+
+    /// Return the number of children of the node
+    int32 getNbChildren() const;
+};
+
+// Structure WideTreeLeaf
+/**
+ * This structure represents a leaf of a wide AABB tree (a single shape or triangle).
+ */
+struct WideTreeLeaf {
+
+    // -------------------- Attributes -------------------- //
+
+    /// Two pieces of data stored at that leaf
+    union {
+        int32 dataInt[2];
+        void* dataPointer;
+    };
+
+    /// ID of the leaf node in the dynamic AABB tree this tree has been built from
+    int32 sourceNodeID;
+
+    /// Unused (the leaves are 16 bytes large)
+    int32 padding;
+};
+
+// Class WideAABBTree
+/**
+ * This class is a compact read-only copy of a dynamic AABB tree where each internal node
+ * has up to four children. It is built by collapsing the binary tree: the children of a node
+ * are expanded, largest surface area first, until the node has four children. A query tests
+ * the four children of a node at once with SIMD instructions which halves the depth of the
+ * tree and the number of nodes to visit. The leaves are stored in a separate array and the
+ * queries report the indices of the leaves in that array. The tree must be built again if
+ * the dynamic AABB tree is modified. It is used for the raycasts against the static geometry
+ * (the triangles of a concave mesh and the colliders of the static bodies).
+ */
+class WideAABBTree {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Largest quantized coordinate
+        static const decimal MAX_QUANTIZED_VALUE;
+
+        /// Alignment of the array of nodes (size of a cache line)
+        static const size_t NODES_ALIGNMENT;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Memory allocated for the nodes (not aligned)
+        void* mNodesMemory;
+
+        /// Array of the internal nodes (aligned on a cache line). The root is the first node.
+        WideTreeNode* mNodes;
+
+        /// Array of the leaves
+        WideTreeLeaf* mLeaves;
+
+        /// Number of internal nodes in the tree
+        int32 mNbNodes;
+
+        /// Number of leaves in the tree
+        int32 mNbLeaves;
+
+        /// Number of internal nodes that fit in the allocated memory
+        int32 mNbAllocatedNodes;
+
+        /// Number of leaves that fit in the allocated memory
+        int32 mNbAllocatedLeaves;
+
+        /// AABB of the root of the tree
+        AABB mRootAABB;
+
+        /// Factors to convert a coordinate relative to the minimum of the root AABB into a quantized value
+        Vector3 mQuantizationScale;
+
+        /// Factors to convert a quantized value into a coordinate relative to the minimum of the root AABB
+        Vector3 mDequantizationScale;
+
+        /// Origins of the dequantized minimum and maximum coordinates. They are the minimum of the root
+        /// AABB moved outwards by the rounding error of the dequantization in world-space so that a
+        /// dequantized AABB always contains the AABB of the original node even far from the origin.
+        Vector3 mDequantizationMinOrigin;
+        Vector3 mDequantizationMaxOrigin;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Pointer to the profiler
+		Profiler* mProfiler;
+
+#endif
+
+        // -------------------- Methods -------------------- //
+
+        /// Collapse a sub-tree of a dynamic AABB tree into a new node and return the index of the node
+        int32 collapseSubTree(const DynamicAABBTree& tree, int32 sourceNodeID);
+
+        /// Set a child of a node
+        void setChild(WideTreeNode& node, int32 childIndex, const DynamicAABBTree& tree, int32 sourceNodeID);
+
+        /// Quantize the minimum and maximum coordinates of an AABB (rounded outwards)
+        void quantizeAABB(const AABB& aabb, uint16* outQuantizedMin, uint16* outQuantizedMax) const;
+
+        /// Return the children of a node whose quantized AABB overlaps with a quantized AABB (one bit per child)
+        uint32 testOverlapWithChildren(const WideTreeNode& node, const uint16* quantizedMin, const uint16* quantizedMax) const;
+
+        /// Return the children of a node whose AABB is hit by a ray (one bit per child)
+        uint32 testRayWithChildren(const WideTreeNode& node, const Vector3& rayOrigin, const Vector3& rayDirectionInverse,
+                                   decimal maxFraction, decimal* outEnterFractions) const;
+
+        /// Return the children of a node whose AABB is hit by a ray (scalar version)
+        uint32 testRayWithChildrenScalar(const WideTreeNode& node, const Vector3& rayOrigin, const Vector3& rayDirectionInverse,
+                                         decimal maxFraction, decimal* outEnterFractions) const;
+
+        /// Allocate memory for at least a given number of nodes and leaves
+        void reserveNodes(int32 nbNodes, int32 nbLeaves);
+
+        /// Release the memory of the nodes and leaves
+        void releaseNodes();
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WideAABBTree(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~WideAABBTree();
+
+        /// Deleted copy-constructor
+        WideAABBTree(const WideAABBTree& tree) = delete;
+
+        /// Deleted assignment operator
+        WideAABBTree& operator=(const WideAABBTree& tree) = delete;
+
+        /// Build the tree from a dynamic AABB tree
+        void build(const DynamicAABBTree& tree);
+
+        /// Clear all the nodes of the tree
+        void reset();
+
+        /// Return the number of internal nodes in the tree
+        int32 getNbNodes() const;
+
+        /// Return the number of leaves in the tree
+        int32 getNbLeaves() const;
+
+        /// Return the number of bytes used by the nodes and leaves of the tree
+        size_t getNodesSizeInBytes() const;
+
+        /// Return the AABB of the root of the tree
+        const AABB& getRootAABB() const;
+
+        /// Return the pointer to the data array of a given leaf of the tree
+        const int32* getNodeDataInt(int32 leafIndex) const;
+
+        /// Return the data pointer of a given leaf of the tree
+        void* getNodeDataPointer(int32 leafIndex) const;
+
+        /// Return the ID of a leaf in the dynamic AABB tree the tree has been built from
+        int32 getSourceNodeID(int32 leafIndex) const;
+
+        /// Report all the leaves overlapping with the AABB given in parameter
+        void reportAllShapesOverlappingWithAABB(const AABB& aabb, Array<int32>& overlappingNodes) const;
+
+        /// Report all the leaves overlapping with the AABB of a shape
+        void reportAllShapesOverlappingWithShape(int32 shapeID, const AABB& shapeAABB, Stack<int32>& stack,
+                                                 Array<Pair<int32, int32>>& outOverlappingNodes) const;
+
+        /// Ray casting method
+        decimal raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const;
+
+        /// Ray casting method for a packet of rays
+        void raycastPacket(RayPacket& packet, DynamicAABBTreeRaycastPacketCallback& callback,
+                           Stack<Pair<int32, uint32>>& stack) const;
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+		/// Set the profiler
+		void setProfiler(Profiler* profiler);
+
+#endif
+
+};
+
+// Return the number of children of the node
+RP3D_FORCE_INLINE int32 WideTreeNode::getNbChildren() const {
+
+    int32 nbChildren = 0;
+    while (nbChildren < NB_CHILDREN && children[nbChildren] != EMPTY_CHILD) nbChildren++;
+    return nbChildren;
+}
+
+// Return the number of internal nodes in the tree
+RP3D_FORCE_INLINE int32 WideAABBTree::getNbNodes() const {
+    return mNbNodes;
+}
+
+// Return the number of leaves in the tree
+RP3D_FORCE_INLINE int32 WideAABBTree::getNbLeaves() const {
+    return mNbLeaves;
+}
+
+// Return the number of bytes used by the nodes and leaves of the tree
+RP3D_FORCE_INLINE size_t WideAABBTree::getNodesSizeInBytes() const {
+    return static_cast<size_t>(mNbNodes) * sizeof(WideTreeNode) + static_cast<size_t>(mNbLeaves) * sizeof(WideTreeLeaf);
+}
+
+// Return the AABB of the root of the tree
+RP3D_FORCE_INLINE const AABB& WideAABBTree::getRootAABB() const {
+    return mRootAABB;
+}
+
+// Return the pointer to the data array of a given leaf of the tree
+RP3D_FORCE_INLINE const int32* WideAABBTree::getNodeDataInt(int32 leafIndex) const {
+    assert(leafIndex >= 0 && leafIndex < mNbLeaves);
+    return mLeaves[leafIndex].dataInt;
+}
+
+// Return the data pointer of a given leaf of the tree
+RP3D_FORCE_INLINE void* WideAABBTree::getNodeDataPointer(int32 leafIndex) const {
+    assert(leafIndex >= 0 && leafIndex < mNbLeaves);
+    return mLeaves[leafIndex].dataPointer;
+}
+
+// Return the ID of a leaf in the dynamic AABB tree the tree has been built from
+RP3D_FORCE_INLINE int32 WideAABBTree::getSourceNodeID(int32 leafIndex) const {
+    assert(leafIndex >= 0 && leafIndex < mNbLeaves);
+    return mLeaves[leafIndex].sourceNodeID;
+}
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+// Set the profiler
+RP3D_FORCE_INLINE void WideAABBTree::setProfiler(Profiler* profiler) {
+	mProfiler = profiler;
+}
+
+#endif
+
+}
+
+#endif
@@ -29,7 +29,9 @@
 // Libraries
 #include <reactphysics3d/engine/OverlappingPairs.h>
 #include <reactphysics3d/collision/ContactPointInfo.h>
+#include <reactphysics3d/containers/Array.h>
 #include <reactphysics3d/configuration.h>
+#include <limits>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -43,78 +45,94 @@ struct ContactPointInfo;
 // Struct NarrowPhaseInfoBatch
 /**
  * This structure collects all the potential collisions from the middle-phase algorithm
- * that have to be tested during narrow-phase collision detection.
+ * that have to be tested during narrow-phase collision detection. The data of the items
+ * is stored as a structure of arrays. Most of the tested items do not collide. Therefore, the
+ * contact points are not stored with each item but in pools of contact points where only the
+ * colliding items append their contact points. The items of the batch can be split into
+ * ranges that use their own pool so that different ranges can be tested concurrently.
  */
 struct NarrowPhaseInfoBatch {
 
-    struct NarrowPhaseInfo {
+    protected:
 
-        /// Broadphase overlapping pairs ids
-        uint64 overlappingPairId;
+        /// Reference to the memory allocator
+        MemoryAllocator& mMemoryAllocator;
 
-        /// Entity of the first collider to test collision with
-        Entity colliderEntity1;
+        /// Reference to all the broad-phase overlapping pairs
+        OverlappingPairs& mOverlappingPairs;
 
-        /// Entity of the second collider to test collision with
-        Entity colliderEntity2;
+        /// Cached capacity
+        uint32 mCachedCapacity = 0;
 
-        /// Collision info of the previous frame
-        LastFrameCollisionInfo* lastFrameCollisionInfo;
+        /// Number of items in the batch
+        uint32 mNbObjects;
 
-        /// Memory allocator for the collision shape (Used to release TriangleShape memory in destructor)
-        MemoryAllocator* collisionShapeAllocator;
+        /// Number of allocated items
+        uint32 mNbAllocatedObjects;
 
-        /// Shape local to world transform of sphere 1
-        Transform shape1ToWorldTransform;
+        /// Size (in bytes) of the data of a single item
+        size_t mObjectDataSize;
 
-        /// Shape local to world transform of sphere 2
-        Transform shape2ToWorldTransform;
+        /// Allocated memory for all the data of the items
+        void* mBuffer;
 
-        /// Pointer to the first collision shapes to test collision with
-        CollisionShape* collisionShape1;
+        /// Number of consecutive items that share the same contact point pool
+        uint32 mNbItemsPerContactPointPool;
 
-        /// Pointer to the second collision shapes to test collision with
-        CollisionShape* collisionShape2;
+        /// Pools of contact points created during the narrow-phase
+        Array<Array<ContactPointInfo>> mContactPointPools;
 
-        /// True if we need to report contacts (false for triggers for instance)
-        bool reportContacts;
+        // -------------------- Methods -------------------- //
 
-        /// Result of the narrow-phase collision detection test
-        bool isColliding;
+        /// Allocate memory for a given number of items
+        void allocate(uint32 nbObjectsToAllocate);
 
-        /// Number of contact points
-        uint8 nbContactPoints;
+        /// Return the pool of contact points of a given item
+        Array<ContactPointInfo>& getContactPointPool(uint32 index);
 
-        /// Array of contact points created during the narrow-phase
-        ContactPointInfo contactPoints[NB_MAX_CONTACT_POINTS_IN_NARROWPHASE_INFO];
+        /// Return the pool of contact points of a given item
+        const Array<ContactPointInfo>& getContactPointPool(uint32 index) const;
 
-        /// Constructor
-        NarrowPhaseInfo(uint64 pairId, Entity collider1, Entity collider2, LastFrameCollisionInfo* lastFrameInfo, MemoryAllocator& shapeAllocator,
-                             const Transform& shape1ToWorldTransform, const Transform& shape2ToWorldTransform, CollisionShape* shape1,
-                             CollisionShape* shape2, bool needToReportContacts)
-                      : overlappingPairId(pairId), colliderEntity1(collider1), colliderEntity2(collider2), lastFrameCollisionInfo(lastFrameInfo),
-                         collisionShapeAllocator(&shapeAllocator), shape1ToWorldTransform(shape1ToWorldTransform),
-                         shape2ToWorldTransform(shape2ToWorldTransform), collisionShape1(shape1),
-                        collisionShape2(shape2), reportContacts(needToReportContacts), isColliding(false), nbContactPoints(0) {
+    public:
 
-        }
-    };
+        /// Broadphase overlapping pairs ids
+        uint64* overlappingPairIds;
 
-    protected:
+        /// Collision infos of the previous frame
+        LastFrameCollisionInfo** lastFrameCollisionInfos;
 
-        /// Reference to the memory allocator
-        MemoryAllocator& mMemoryAllocator;
+        /// Memory allocators for the collision shapes (Used to release TriangleShape memory in destructor)
+        MemoryAllocator** collisionShapeAllocators;
 
-        /// Reference to all the broad-phase overlapping pairs
-        OverlappingPairs& mOverlappingPairs;
+        /// Pointers to the first collision shapes to test collision with
+        CollisionShape** collisionShapes1;
 
-        /// Cached capacity
-        uint32 mCachedCapacity = 0;
+        /// Pointers to the second collision shapes to test collision with
+        CollisionShape** collisionShapes2;
 
-    public:
+        /// Local-to-world transforms of the first shapes
+        Transform* shape1ToWorldTransforms;
+
+        /// Local-to-world transforms of the second shapes
+        Transform* shape2ToWorldTransforms;
+
+        /// Entities of the first colliders to test collision with
+        Entity* colliderEntities1;
 
-        /// For each collision test, we keep some meta data
-        Array<NarrowPhaseInfo> narrowPhaseInfos;
+        /// Entities of the second colliders to test collision with
+        Entity* colliderEntities2;
+
+        /// Indices of the first contact point of each item in its contact point pool
+        uint32* contactPointsIndices;
+
+        /// True if we need to report contacts (false for triggers for instance)
+        bool* reportContacts;
+
+        /// Results of the narrow-phase collision detection tests
+        bool* isColliding;
+
+        /// Number of contact points of each item
+        uint8* nbContactPoints;
 
         /// Constructor
         NarrowPhaseInfoBatch(OverlappingPairs& overlappingPairs, MemoryAllocator& allocator);
@@ -137,6 +155,12 @@ struct NarrowPhaseInfoBatch {
         /// Reset the remaining contact points
         void resetContactPoints(uint32 index);
 
+        /// Return a contact point of a given item
+        const ContactPointInfo& getContactPoint(uint32 index, uint32 contactPointIndex) const;
+
+        /// Split the items into ranges of a given size that use their own contact point pool
+        void setNbItemsPerContactPointPool(uint32 nbItemsPerPool);
+
         // Initialize the containers using cached capacity
         void reserveMemory();
 
@@ -146,7 +170,7 @@ struct NarrowPhaseInfoBatch {
 
 /// Return the number of objects in the batch
 RP3D_FORCE_INLINE uint32 NarrowPhaseInfoBatch::getNbObjects() const {
-    return static_cast<uint32>(narrowPhaseInfos.size());
+    return mNbObjects;
 }
 
 // Add shapes to be tested during narrow-phase collision detection into the batch
@@ -154,34 +178,103 @@ RP3D_FORCE_INLINE void NarrowPhaseInfoBatch::addNarrowPhaseInfo(uint64 pairId, E
                                               CollisionShape* shape2, const Transform& shape1Transform, const Transform& shape2Transform,
                                               bool needToReportContacts, LastFrameCollisionInfo* lastFrameInfo, MemoryAllocator& shapeAllocator) {
 
-    // Create a meta data object
-    narrowPhaseInfos.emplace(pairId, collider1, collider2, lastFrameInfo, shapeAllocator, shape1Transform, shape2Transform, shape1, shape2, needToReportContacts);
+    // If we need to allocate more memory
+    if (mNbObjects == mNbAllocatedObjects) {
+        allocate(mNbAllocatedObjects > 0 ? mNbAllocatedObjects * 2 : 16);
+    }
+
+    const uint32 index = mNbObjects;
+
+    // Insert the data of the new item
+    overlappingPairIds[index] = pairId;
+    lastFrameCollisionInfos[index] = lastFrameInfo;
+    collisionShapeAllocators[index] = &shapeAllocator;
+    collisionShapes1[index] = shape1;
+    collisionShapes2[index] = shape2;
+    new (shape1ToWorldTransforms + index) Transform(shape1Transform);
+    new (shape2ToWorldTransforms + index) Transform(shape2Transform);
+    new (colliderEntities1 + index) Entity(collider1);
+    new (colliderEntities2 + index) Entity(collider2);
+    contactPointsIndices[index] = 0;
+    reportContacts[index] = needToReportContacts;
+    isColliding[index] = false;
+    nbContactPoints[index] = 0;
+
+    mNbObjects++;
+}
+
+// Return the pool of contact points of a given item
+RP3D_FORCE_INLINE Array<ContactPointInfo>& NarrowPhaseInfoBatch::getContactPointPool(uint32 index) {
+
+    // If the items have not been split into ranges, all the items use a single pool
+    if (mContactPointPools.size() == 0) {
+        assert(mNbItemsPerContactPointPool == std::numeric_limits<uint32>::max());
+        mContactPointPools.emplace(mMemoryAllocator);
+    }
+
+    return mContactPointPools[index / mNbItemsPerContactPointPool];
+}
+
+// Return the pool of contact points of a given item
+RP3D_FORCE_INLINE const Array<ContactPointInfo>& NarrowPhaseInfoBatch::getContactPointPool(uint32 index) const {
+    return mContactPointPools[index / mNbItemsPerContactPointPool];
 }
 
 // Add a new contact point
+/// The contact points of an item are contiguous in its contact point pool because an algorithm
+/// always adds all the contact points of an item before moving to the next item.
 RP3D_FORCE_INLINE void NarrowPhaseInfoBatch::addContactPoint(uint32 index, const Vector3& contactNormal, decimal penDepth, const Vector3& localPt1, const Vector3& localPt2) {
 
     assert(penDepth > decimal(0.0));
 
-    if (narrowPhaseInfos[index].nbContactPoints < NB_MAX_CONTACT_POINTS_IN_NARROWPHASE_INFO) {
+    if (nbContactPoints[index] < NB_MAX_CONTACT_POINTS_IN_NARROWPHASE_INFO) {
 
         assert(contactNormal.length() > 0.8f);
 
-        // Add it into the array of contact points
-        narrowPhaseInfos[index].contactPoints[narrowPhaseInfos[index].nbContactPoints].normal = contactNormal;
-        narrowPhaseInfos[index].contactPoints[narrowPhaseInfos[index].nbContactPoints].penetrationDepth = penDepth;
-        narrowPhaseInfos[index].contactPoints[narrowPhaseInfos[index].nbContactPoints].localPoint1 = localPt1;
-        narrowPhaseInfos[index].contactPoints[narrowPhaseInfos[index].nbContactPoints].localPoint2 = localPt2;
-        narrowPhaseInfos[index].nbContactPoints++;
+        Array<ContactPointInfo>& pool = getContactPointPool(index);
+
+        // If this is the first contact point of the item
+        if (nbContactPoints[index] == 0) {
+            contactPointsIndices[index] = static_cast<uint32>(pool.size());
+        }
+
+        assert(contactPointsIndices[index] + nbContactPoints[index] == pool.size());
+
+        // Add it into the pool of contact points
+        ContactPointInfo contactPoint;
+        contactPoint.normal = contactNormal;
+        contactPoint.penetrationDepth = penDepth;
+        contactPoint.localPoint1 = localPt1;
+        contactPoint.localPoint2 = localPt2;
+        pool.add(contactPoint);
+        nbContactPoints[index]++;
     }
 }
 
 // Reset the remaining contact points
+/// If the contact points of the item are at the end of its pool, they are removed from the pool.
+/// Otherwise, they are simply forgotten and the new contact points of the item (if any) will be
+/// added at the end of the pool.
 RP3D_FORCE_INLINE void NarrowPhaseInfoBatch::resetContactPoints(uint32 index) {
-    narrowPhaseInfos[index].nbContactPoints = 0;
+
+    if (nbContactPoints[index] == 0) return;
+
+    Array<ContactPointInfo>& pool = getContactPointPool(index);
+    if (contactPointsIndices[index] + nbContactPoints[index] == pool.size()) {
+        for (uint32 i=0; i < nbContactPoints[index]; i++) {
+            pool.removeAt(pool.size() - 1);
+        }
+    }
+
+    nbContactPoints[index] = 0;
 }
 
+// Return a contact point of a given item
+RP3D_FORCE_INLINE const ContactPointInfo& NarrowPhaseInfoBatch::getContactPoint(uint32 index, uint32 contactPointIndex) const {
+    assert(contactPointIndex < nbContactPoints[index]);
+    return getContactPointPool(index)[contactPointsIndices[index] + contactPointIndex];
 }
 
-#endif
+}
 
+#endif
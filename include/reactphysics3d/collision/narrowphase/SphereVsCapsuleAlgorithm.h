@@ -28,6 +28,7 @@
 
 // Libraries
 #include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
+#include <reactphysics3d/mathematics/Simd.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -48,6 +49,18 @@ class SphereVsCapsuleAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Methods -------------------- //
+
+        /// Compute the narrow-phase collision detection of a single item of the batch
+        bool testItemCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex);
+
+#ifdef RP3D_USE_SIMD
+
+        /// Return a mask where the bit i is set if the sphere and the capsule of the item (batchIndex + i) overlap
+        static uint32 computeOverlapMask(const NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex);
+
+#endif
+
     public :
 
         // -------------------- Methods -------------------- //
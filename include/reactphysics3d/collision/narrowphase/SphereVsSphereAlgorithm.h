@@ -28,6 +28,7 @@
 
 // Libraries
 #include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
+#include <reactphysics3d/mathematics/Simd.h>
 
 /// Namespace ReactPhysics3D
 namespace reactphysics3d {
@@ -48,6 +49,18 @@ class SphereVsSphereAlgorithm : public NarrowPhaseAlgorithm {
 
     protected :
 
+        // -------------------- Methods -------------------- //
+
+        /// Compute the narrow-phase collision detection of a single item of the batch
+        bool testItemCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex);
+
+#ifdef RP3D_USE_SIMD
+
+        /// Return a mask where the bit i is set if the two spheres of the item (batchIndex + i) are colliding
+        static uint32 computeCollidingMask(const NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex);
+
+#endif
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -88,6 +88,9 @@ class AABB {
         /// Return the volume of the AABB
         decimal getVolume() const;
 
+        /// Return the surface area of the AABB
+        decimal getSurfaceArea() const;
+
         /// Merge the AABB in parameter with the current one
         void mergeWithAABB(const AABB& aabb);
 
@@ -174,6 +177,12 @@ RP3D_FORCE_INLINE decimal AABB::getVolume() const {
     return (diff.x * diff.y * diff.z);
 }
 
+// Return the surface area of the AABB
+RP3D_FORCE_INLINE decimal AABB::getSurfaceArea() const {
+    const Vector3 diff = mMaxCoordinates - mMinCoordinates;
+    return decimal(2.0) * (diff.x * diff.y + diff.y * diff.z + diff.z * diff.x);
+}
+
 // Return true if the AABB of a triangle intersects the AABB
 RP3D_FORCE_INLINE bool AABB::testCollisionTriangleAABB(const Vector3* trianglePoints) const {
 
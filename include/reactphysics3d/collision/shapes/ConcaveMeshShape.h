@@ -29,6 +29,7 @@
 // Libraries
 #include <reactphysics3d/collision/shapes/ConcaveShape.h>
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
 #include <reactphysics3d/containers/Array.h>
 
 namespace reactphysics3d {
@@ -49,15 +50,15 @@ class ConvexTriangleAABBOverlapCallback : public DynamicAABBTreeOverlapCallback
         // Reference to the concave mesh shape
         const ConcaveMeshShape& mConcaveMeshShape;
 
-        // Reference to the Dynamic AABB tree
-        const DynamicAABBTree& mDynamicAABBTree;
+        // Reference to the AABB tree of the triangles
+        const WideAABBTree& mAABBTree;
 
     public:
 
         // Constructor
         ConvexTriangleAABBOverlapCallback(TriangleCallback& triangleCallback, const ConcaveMeshShape& concaveShape,
-                                          const DynamicAABBTree& dynamicAABBTree)
-          : mTriangleTestCallback(triangleCallback), mConcaveMeshShape(concaveShape), mDynamicAABBTree(dynamicAABBTree) {
+                                          const WideAABBTree& aabbTree)
+          : mTriangleTestCallback(triangleCallback), mConcaveMeshShape(concaveShape), mAABBTree(aabbTree) {
 
         }
 
@@ -73,7 +74,7 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
     private :
 
         Array<int32> mHitAABBNodes;
-        const DynamicAABBTree& mDynamicAABBTree;
+        const WideAABBTree& mAABBTree;
         const ConcaveMeshShape& mConcaveMeshShape;
         Collider* mCollider;
         RaycastInfo& mRaycastInfo;
@@ -92,9 +93,9 @@ class ConcaveMeshRaycastCallback : public DynamicAABBTreeRaycastCallback {
     public:
 
         // Constructor
-        ConcaveMeshRaycastCallback(const DynamicAABBTree& dynamicAABBTree, const ConcaveMeshShape& concaveMeshShape,
+        ConcaveMeshRaycastCallback(const WideAABBTree& aabbTree, const ConcaveMeshShape& concaveMeshShape,
                                    Collider* collider, RaycastInfo& raycastInfo, const Ray& ray, const Vector3& meshScale, MemoryAllocator& allocator)
-            : mHitAABBNodes(allocator), mDynamicAABBTree(dynamicAABBTree), mConcaveMeshShape(concaveMeshShape), mCollider(collider),
+            : mHitAABBNodes(allocator), mAABBTree(aabbTree), mConcaveMeshShape(concaveMeshShape), mCollider(collider),
               mRaycastInfo(raycastInfo), mRay(ray), mIsHit(false), mAllocator(allocator), mMeshScale(meshScale) {
 
         }
@@ -135,8 +136,8 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Pointer to the triangle mesh
         TriangleMesh* mTriangleMesh;
 
-        /// Dynamic AABB tree to accelerate collision with the triangles
-        DynamicAABBTree mDynamicAABBTree;
+        /// Compact wide AABB tree to accelerate collision with the triangles
+        WideAABBTree mAABBTree;
 
         /// Array with computed vertices normals for each TriangleVertexArray of the triangle mesh (only
         /// if the user did not provide its own vertices normals)
@@ -156,8 +157,8 @@ class ConcaveMeshShape : public ConcaveShape {
         /// Return the number of bytes used by the collision shape
         virtual size_t getSizeInBytes() const override;
 
-        /// Insert all the triangles into the dynamic AABB tree
-        void initBVHTree();
+        /// Build the AABB tree with all the triangles of the mesh
+        void initBVHTree(MemoryAllocator& allocator);
 
         /// Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
         void getTriangleVertices(uint32 subPart, uint32 triangleIndex, Vector3* outTriangleVertices) const;
@@ -228,7 +229,7 @@ RP3D_FORCE_INLINE size_t ConcaveMeshShape::getSizeInBytes() const {
 RP3D_FORCE_INLINE void ConcaveMeshShape::getLocalBounds(Vector3& min, Vector3& max) const {
 
     // Get the AABB of the whole tree
-    AABB treeAABB = mDynamicAABBTree.getRootAABB();
+    const AABB& treeAABB = mAABBTree.getRootAABB();
 
     min = treeAABB.getMin();
     max = treeAABB.getMax();
@@ -239,7 +240,7 @@ RP3D_FORCE_INLINE void ConcaveMeshShape::getLocalBounds(Vector3& min, Vector3& m
 RP3D_FORCE_INLINE void ConvexTriangleAABBOverlapCallback::notifyOverlappingNode(int nodeId) {
 
     // Get the node data (triangle index and mesh subpart index)
-    int32* data = mDynamicAABBTree.getNodeDataInt(nodeId);
+    const int32* data = mAABBTree.getNodeDataInt(nodeId);
 
     // Get the triangle vertices for this node from the concave mesh shape
     Vector3 trianglePoints[3];
@@ -260,7 +261,7 @@ RP3D_FORCE_INLINE void ConcaveMeshShape::setProfiler(Profiler* profiler) {
 
     CollisionShape::setProfiler(profiler);
 
-    mDynamicAABBTree.setProfiler(profiler);
+    mAABBTree.setProfiler(profiler);
 }
 
 
@@ -155,6 +155,24 @@ class ColliderComponents : public Components {
         /// Add a component
         void addComponent(Entity colliderEntity, bool isSleeping, const ColliderComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
+        /// Save only the state of the components that changes during the simulation into a snapshot
+        virtual void saveDynamicState(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components saved with the saveDynamicState() method
+        virtual void restoreDynamicState(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot of the dynamic state
+        virtual void skipDynamicState(SnapshotReader& reader) const override;
+
         /// Return the body entity of a given collider
         Entity getBody(Entity colliderEntity) const;
 
@@ -104,6 +104,15 @@ class CollisionBodyComponents : public Components {
         /// Add a component
         void addComponent(Entity bodyEntity, bool isSleeping, const CollisionBodyComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
         /// Add a collider to a body component
         void addColliderToBody(Entity bodyEntity, Entity colliderEntity);
 
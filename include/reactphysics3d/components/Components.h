@@ -29,7 +29,7 @@
 // Libraries
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/engine/Entity.h>
-#include <reactphysics3d/containers/Map.h>
+#include <reactphysics3d/containers/EntitySparseSet.h>
 
 // ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -37,6 +37,8 @@ namespace reactphysics3d {
 // Class declarations
 class MemoryAllocator;
 class EntityManager;
+class SnapshotWriter;
+class SnapshotReader;
 
 // Class Components
 /**
@@ -70,7 +72,7 @@ class Components {
         void* mBuffer;
 
         /// Map an entity to the index of its component in the array
-        Map<Entity, uint32> mMapEntityToComponentIndex;
+        EntitySparseSet mMapEntityToComponentIndex;
 
         /// Index of the first component of a disabled (sleeping or inactive) entity
         /// Disabled components are stored at the end of the components array
@@ -91,6 +93,12 @@ class Components {
         /// Swap two components in the array
         virtual void swapComponents(uint32 index1, uint32 index2)=0;
 
+        /// Write the number of components and their entities into a snapshot
+        void saveEntitiesToSnapshot(SnapshotWriter& writer, const Entity* entities) const;
+
+        /// Read the entities of a snapshot and reorder the components in the same order
+        void restoreEntitiesFromSnapshot(SnapshotReader& reader);
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -104,6 +112,9 @@ class Components {
         /// Remove a component
         void removeComponent(Entity entity);
 
+        /// Allocate memory for at least a given number of components
+        void reserve(uint32 nbComponents);
+
         /// Return true if an entity is disabled
         bool getIsEntityDisabled(Entity entity) const;
 
@@ -124,6 +135,27 @@ class Components {
 
         /// Return the index in the arrays for a given entity
         uint32 getEntityIndex(Entity entity) const;
+
+        /// Return true if a snapshot of the components contains exactly the same entities and valid data
+        bool canRestoreSnapshot(SnapshotReader reader, bool isDynamicStateOnly) const;
+
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const=0;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader)=0;
+
+        /// Save only the state of the components that changes during the simulation into a snapshot
+        virtual void saveDynamicState(SnapshotWriter& writer) const;
+
+        /// Restore the state of the components saved with the saveDynamicState() method
+        virtual void restoreDynamicState(SnapshotReader& reader);
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const=0;
+
+        /// Skip the data of the components that follows their entities in a snapshot of the dynamic state
+        virtual void skipDynamicState(SnapshotReader& reader) const;
 };
 
 // Return true if an entity is sleeping
@@ -140,14 +172,7 @@ RP3D_FORCE_INLINE bool Components::hasComponent(Entity entity) const {
 // Return true if there is a component for a given entity and if so set the entity index
 RP3D_FORCE_INLINE bool Components::hasComponentGetIndex(Entity entity, uint32& entityIndex) const {
 
-    auto it = mMapEntityToComponentIndex.find(entity);
-
-    if (it != mMapEntityToComponentIndex.end()) {
-        entityIndex = it->second;
-        return true;
-    }
-
-    return false;
+    return mMapEntityToComponentIndex.tryGetComponentIndex(entity, entityIndex);
 }
 
 // Return the number of components
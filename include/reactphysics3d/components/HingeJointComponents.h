@@ -204,6 +204,15 @@ class HingeJointComponents : public Components {
         /// Add a component
         void addComponent(Entity jointEntity, bool isSleeping, const HingeJointComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
         /// Return a pointer to a given joint
         HingeJoint* getJoint(Entity jointEntity) const;
 
@@ -122,6 +122,15 @@ class JointComponents : public Components {
         /// Add a component
         void addComponent(Entity jointEntity, bool isSleeping, const JointComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
         /// Return the entity of the first body of a joint
         Entity getBody1Entity(Entity jointEntity) const;
 
@@ -161,6 +170,7 @@ class JointComponents : public Components {
         friend class SolveFixedJointSystem;
         friend class SolveHingeJointSystem;
         friend class SolveSliderJointSystem;
+        friend struct SolverBodies;
 
 };
 
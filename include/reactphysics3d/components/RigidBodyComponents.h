@@ -139,6 +139,10 @@ class RigidBodyComponents : public Components {
         /// Array of center of mass of each component (in world-space coordinates)
         Vector3* mCentersOfMassWorld;
 
+        /// Array with the persistent island of each awake body (IslandGraph::INVALID_ISLAND_ID if the
+        /// body is not part of an island yet)
+        uint32* mIslandIds;
+
         /// True if the gravity needs to be applied to this component
         bool* mIsGravityEnabled;
 
@@ -148,7 +152,8 @@ class RigidBodyComponents : public Components {
         /// For each body, the array of joints entities the body is part of
         Array<Entity>* mJoints;
 
-        /// For each body, the array of the indices of contact pairs in which the body is involved
+        /// For each awake non-static body, the array of the indices of the contact pairs of the current
+        /// frame with another rigid body (used to create the islands)
         Array<uint>* mContactPairs;
 
         /// For each body, the vector of lock translation vectors
@@ -198,6 +203,24 @@ class RigidBodyComponents : public Components {
         /// Add a component
         void addComponent(Entity bodyEntity, bool isSleeping, const RigidBodyComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
+        /// Save only the state of the components that changes during the simulation into a snapshot
+        virtual void saveDynamicState(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components saved with the saveDynamicState() method
+        virtual void restoreDynamicState(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot of the dynamic state
+        virtual void skipDynamicState(SnapshotReader& reader) const override;
+
         /// Return a pointer to a rigid body
         RigidBody* getRigidBody(Entity bodyEntity);
 
@@ -318,6 +341,9 @@ class RigidBodyComponents : public Components {
         /// Return true if the entity is already in an island
         bool getIsAlreadyInIsland(Entity bodyEntity) const;
 
+        /// Return the persistent island of an entity
+        uint32 getIslandId(Entity bodyEntity) const;
+
         /// Return the lock translation factor
         const Vector3& getLinearLockAxisFactor(Entity bodyEntity) const;
 
@@ -354,6 +380,9 @@ class RigidBodyComponents : public Components {
         /// Set the value to know if the entity is already in an island
         void setIsAlreadyInIsland(Entity bodyEntity, bool isAlreadyInIsland);
 
+        /// Set the persistent island of an entity
+        void setIslandId(Entity bodyEntity, uint32 islandId);
+
         /// Set the linear lock axis factor
         void setLinearLockAxisFactor(Entity bodyEntity, const Vector3& linearLockAxisFactor);
 
@@ -369,19 +398,18 @@ class RigidBodyComponents : public Components {
         /// Remove a joint from a body component
         void removeJointFromBody(Entity bodyEntity, Entity jointEntity);
 
-        /// A an associated contact pairs into the contact pairs array of the body
-        void addContacPair(Entity bodyEntity, uint32 contactPairIndex);
-
         // -------------------- Friendship -------------------- //
 
         friend class PhysicsWorld;
         friend class ContactSolverSystem;
         friend class CollisionDetectionSystem;
+        friend class BroadPhaseSystem;
         friend class SolveBallAndSocketJointSystem;
         friend class SolveFixedJointSystem;
         friend class SolveHingeJointSystem;
         friend class SolveSliderJointSystem;
         friend class DynamicsSystem;
+        friend struct SolverBodies;
         friend class BallAndSocketJoint;
         friend class FixedJoint;
         friend class HingeJoint;
@@ -772,6 +800,14 @@ RP3D_FORCE_INLINE bool RigidBodyComponents::getIsAlreadyInIsland(Entity bodyEnti
    return mIsAlreadyInIsland[mMapEntityToComponentIndex[bodyEntity]];
 }
 
+// Return the persistent island of an entity
+RP3D_FORCE_INLINE uint32 RigidBodyComponents::getIslandId(Entity bodyEntity) const {
+
+   assert(mMapEntityToComponentIndex.containsKey(bodyEntity));
+
+   return mIslandIds[mMapEntityToComponentIndex[bodyEntity]];
+}
+
 
 // Return the linear lock axis factor
 RP3D_FORCE_INLINE const Vector3& RigidBodyComponents::getLinearLockAxisFactor(Entity bodyEntity) const {
@@ -804,6 +840,13 @@ RP3D_FORCE_INLINE void RigidBodyComponents::setIsAlreadyInIsland(Entity bodyEnti
    mIsAlreadyInIsland[mMapEntityToComponentIndex[bodyEntity]] = isAlreadyInIsland;
 }
 
+// Set the persistent island of an entity
+RP3D_FORCE_INLINE void RigidBodyComponents::setIslandId(Entity bodyEntity, uint32 islandId) {
+
+   assert(mMapEntityToComponentIndex.containsKey(bodyEntity));
+   mIslandIds[mMapEntityToComponentIndex[bodyEntity]] = islandId;
+}
+
 // Set the linear lock axis factor
 RP3D_FORCE_INLINE void RigidBodyComponents::setLinearLockAxisFactor(Entity bodyEntity, const Vector3& linearLockAxisFactor) {
 
@@ -839,13 +882,6 @@ RP3D_FORCE_INLINE void RigidBodyComponents::removeJointFromBody(Entity bodyEntit
     mJoints[mMapEntityToComponentIndex[bodyEntity]].remove(jointEntity);
 }
 
-// A an associated contact pairs into the contact pairs array of the body
-RP3D_FORCE_INLINE void RigidBodyComponents::addContacPair(Entity bodyEntity, uint32 contactPairIndex) {
-
-    assert(mMapEntityToComponentIndex.containsKey(bodyEntity));
-    mContactPairs[mMapEntityToComponentIndex[bodyEntity]].add(contactPairIndex);
-}
-
 }
 
 #endif
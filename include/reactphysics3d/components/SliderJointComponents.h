@@ -219,6 +219,15 @@ class SliderJointComponents : public Components {
         /// Add a component
         void addComponent(Entity jointEntity, bool isSleeping, const SliderJointComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
         /// Return a pointer to a given joint
         SliderJoint* getJoint(Entity jointEntity) const;
 
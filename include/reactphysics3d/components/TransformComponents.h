@@ -57,6 +57,9 @@ class TransformComponents : public Components {
         /// Array of transform of each component
         Transform* mTransforms;
 
+        /// Array with the boolean value to know if the transform has been changed by the last update of the bodies state
+        bool* mHasTransformChanged;
+
         // -------------------- Methods -------------------- //
 
         /// Allocate memory for a given number of components
@@ -95,15 +98,31 @@ class TransformComponents : public Components {
         /// Add a component
         void addComponent(Entity bodyEntity, bool isSleeping, const TransformComponent& component);
 
+        /// Save the state of the components into a snapshot
+        virtual void saveSnapshot(SnapshotWriter& writer) const override;
+
+        /// Restore the state of the components from a snapshot
+        virtual void restoreSnapshot(SnapshotReader& reader) override;
+
+        /// Skip the data of the components that follows their entities in a snapshot
+        virtual void skipSnapshot(SnapshotReader& reader) const override;
+
         /// Return the transform of an entity
         Transform& getTransform(Entity bodyEntity) const;
 
         /// Set the transform of an entity
         void setTransform(Entity bodyEntity, const Transform& transform);
 
+        /// Return true if the transform of an entity has been changed by the last update of the bodies state
+        bool getHasTransformChanged(Entity bodyEntity) const;
+
+        /// Set whether the transform of an entity has been changed by the last update of the bodies state
+        void setHasTransformChanged(Entity bodyEntity, bool hasTransformChanged);
+
         // -------------------- Friendship -------------------- //
 
         friend class BroadPhaseSystem;
+        friend class DynamicsSystem;
 };
 
 // Return the transform of an entity
@@ -118,6 +137,18 @@ RP3D_FORCE_INLINE void TransformComponents::setTransform(Entity bodyEntity, cons
     mTransforms[mMapEntityToComponentIndex[bodyEntity]] = transform;
 }
 
+// Return true if the transform of an entity has been changed by the last update of the bodies state
+RP3D_FORCE_INLINE bool TransformComponents::getHasTransformChanged(Entity bodyEntity) const {
+    assert(mMapEntityToComponentIndex.containsKey(bodyEntity));
+    return mHasTransformChanged[mMapEntityToComponentIndex[bodyEntity]];
+}
+
+// Set whether the transform of an entity has been changed by the last update of the bodies state
+RP3D_FORCE_INLINE void TransformComponents::setHasTransformChanged(Entity bodyEntity, bool hasTransformChanged) {
+    assert(mMapEntityToComponentIndex.containsKey(bodyEntity));
+    mHasTransformChanged[mMapEntityToComponentIndex[bodyEntity]] = hasTransformChanged;
+}
+
 }
 
 #endif
@@ -114,6 +114,11 @@ constexpr decimal PI_TIMES_2 = decimal(6.28318530);
 /// without triggering a large modification of the tree each frame which can be costly
 constexpr decimal DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE = decimal(0.08);
 
+/// When the fat AABBs of the broad-phase are extruded along the displacement of the bodies,
+/// the displacement of a body during a step is multiplied by this factor so that a body
+/// moving at a constant velocity stays inside its fat AABB during a few frames
+constexpr decimal DYNAMIC_TREE_FAT_AABB_DISPLACEMENT_FACTOR = decimal(4.0);
+
 /// Maximum number of contact points in a narrow phase info object
 constexpr uint8 NB_MAX_CONTACT_POINTS_IN_NARROWPHASE_INFO = 16;
 
@@ -0,0 +1,168 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_ENTITY_SPARSE_SET_H
+#define REACTPHYSICS3D_ENTITY_SPARSE_SET_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/engine/Entity.h>
+#include <reactphysics3d/containers/Array.h>
+#include <cassert>
+
+namespace reactphysics3d {
+
+// Class EntitySparseSet
+/**
+ * This class maps an entity to the index of its component in the (dense) arrays of
+ * a components table. The mapping is stored in a sparse array indexed by the index part
+ * of the entity. Therefore, finding the component index of an entity only needs a single
+ * array read instead of a hash map lookup. Each entry of the sparse array also stores the
+ * id of the entity, which is used to ignore an older entity that had the same index but a
+ * different generation. The size of the sparse array grows with the largest entity index.
+ */
+class EntitySparseSet {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Invalid component index
+        static constexpr uint32 INVALID_INDEX = static_cast<uint32>(-1);
+
+        // Structure Entry
+        /**
+         * Entry of the sparse array
+         */
+        struct Entry {
+
+            /// Id of the entity of this entry
+            uint32 entityId;
+
+            /// Index of the component of the entity (or INVALID_INDEX if there is none)
+            uint32 componentIndex;
+        };
+
+        // -------------------- Attributes -------------------- //
+
+        /// Sparse array indexed by the index part of the entities
+        Array<Entry> mEntries;
+
+        /// Number of entities in the set
+        uint64 mNbEntities;
+
+        // -------------------- Methods -------------------- //
+
+        /// Return the entry of an entity (or nullptr if the entity is not in the set)
+        const Entry* findEntry(Entity entity) const {
+
+            const uint32 index = entity.getIndex();
+            if (index < mEntries.size() && mEntries[index].entityId == entity.id &&
+                mEntries[index].componentIndex != INVALID_INDEX) {
+
+                return &(mEntries[index]);
+            }
+
+            return nullptr;
+        }
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        EntitySparseSet(MemoryAllocator& allocator) : mEntries(allocator), mNbEntities(0) {
+
+        }
+
+        /// Add an entity with the index of its component (the entity must not be in the set already)
+        void add(Entity entity, uint32 componentIndex) {
+
+            assert(!containsKey(entity));
+            assert(componentIndex != INVALID_INDEX);
+
+            const uint32 index = entity.getIndex();
+
+            // Grow the sparse array if necessary
+            if (index >= mEntries.size()) {
+
+                const uint64 oldSize = mEntries.size();
+                mEntries.addWithoutInit(index + 1 - oldSize);
+                for (uint64 i = oldSize; i < mEntries.size(); i++) {
+                    mEntries[i].entityId = 0;
+                    mEntries[i].componentIndex = INVALID_INDEX;
+                }
+            }
+
+            mEntries[index].entityId = entity.id;
+            mEntries[index].componentIndex = componentIndex;
+
+            mNbEntities++;
+        }
+
+        /// Remove an entity from the set
+        void remove(Entity entity) {
+
+            assert(containsKey(entity));
+
+            mEntries[entity.getIndex()].componentIndex = INVALID_INDEX;
+
+            mNbEntities--;
+        }
+
+        /// Return true if the entity is in the set
+        bool containsKey(Entity entity) const {
+            return findEntry(entity) != nullptr;
+        }
+
+        /// Return true if the entity is in the set and if so set the index of its component
+        bool tryGetComponentIndex(Entity entity, uint32& componentIndex) const {
+
+            const Entry* entry = findEntry(entity);
+            if (entry != nullptr) {
+                componentIndex = entry->componentIndex;
+                return true;
+            }
+
+            return false;
+        }
+
+        /// Return the number of entities in the set
+        uint64 size() const {
+            return mNbEntities;
+        }
+
+        /// Return the index of the component of an entity (the entity must be in the set)
+        uint32 operator[](Entity entity) const {
+
+            assert(containsKey(entity));
+
+            return mEntries[entity.getIndex()].componentIndex;
+        }
+};
+
+}
+
+#endif
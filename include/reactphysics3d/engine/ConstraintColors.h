@@ -0,0 +1,128 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_CONSTRAINT_COLORS_H
+#define REACTPHYSICS3D_CONSTRAINT_COLORS_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/containers/Array.h>
+#include <reactphysics3d/components/RigidBodyComponents.h>
+
+namespace reactphysics3d {
+
+// Structure ConstraintColors
+/**
+ * This structure partitions the constraints (contact manifolds or joints) of the islands
+ * into colors. Two constraints with the same color never share a dynamic body. Therefore,
+ * the constraints of a color can be solved in parallel while the colors of an island are
+ * solved one after the other in increasing order. The constraints of an island are greedily
+ * colored in their order and then sorted by color so that the order of the constraints
+ * only depends on the island and not on the number of threads that solve them. A constraint
+ * whose dynamic bodies already use all the colors cannot be colored and has to be solved
+ * after the colors of its island.
+ */
+struct ConstraintColors {
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of colors in an island
+        static constexpr uint32 NB_MAX_COLORS = 32;
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Color of each constraint of the island that is being colored
+        Array<uint8> mConstraintColors;
+
+        /// For each solver body, bit mask of the colors of its constraints
+        Array<uint32> mSolverBodiesColors;
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Indices of the colored constraints. The constraints of an island are stored
+        /// after the ones of the previous island and are sorted by color.
+        Array<uint32> constraints;
+
+        /// For each color, index of its first constraint in the "constraints" array. The colors of
+        /// an island are stored after the ones of the previous island. The last item is the total
+        /// number of colored constraints.
+        Array<uint32> colorsStartIndices;
+
+        /// For each island, index of its first color in the "colorsStartIndices" array. The last item
+        /// is the total number of colors.
+        Array<uint32> islandsColorsStartIndices;
+
+        /// Indices of the constraints that could not be colored
+        Array<uint32> remainingConstraints;
+
+        /// For each island, index of its first constraint in the "remainingConstraints" array. The last
+        /// item is the total number of remaining constraints.
+        Array<uint32> islandsRemainingConstraintsStartIndices;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ConstraintColors(MemoryAllocator& allocator);
+
+        /// Destructor
+        ~ConstraintColors() = default;
+
+        /// Assignment operator
+        ConstraintColors& operator=(const ConstraintColors& constraintColors) = delete;
+
+        /// Copy-constructor
+        ConstraintColors(const ConstraintColors& constraintColors) = delete;
+
+        /// Remove all the colors before coloring the islands of a new frame
+        void reset(uint32 nbSolverBodies);
+
+        /// Color the constraints of the next island
+        void addIsland(uint32 startConstraintIndex, uint32 endConstraintIndex, const Array<uint32>& solverBodies1Indices,
+                       const Array<uint32>& solverBodies2Indices, const Array<BodyType>& solverBodiesTypes);
+
+        /// Add the next island without coloring its constraints
+        void addUncoloredIsland();
+
+        /// Terminate the coloring once all the islands have been added
+        void finish();
+
+        /// Return true if the constraints of a given island are colored
+        bool isIslandColored(uint32 islandIndex) const;
+};
+
+// Return true if the constraints of a given island are colored
+RP3D_FORCE_INLINE bool ConstraintColors::isIslandColored(uint32 islandIndex) const {
+    return islandsColorsStartIndices[islandIndex] < islandsColorsStartIndices[islandIndex + 1];
+}
+
+}
+
+#endif
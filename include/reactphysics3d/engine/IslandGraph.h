@@ -0,0 +1,185 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_ISLAND_GRAPH_H
+#define REACTPHYSICS3D_ISLAND_GRAPH_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/containers/Array.h>
+#include <reactphysics3d/engine/Entity.h>
+
+namespace reactphysics3d {
+
+// Structure IslandGraph
+/**
+ * This structure contains the persistent islands of the awake bodies. Each awake non-static
+ * rigid body stores the id of its island. The islands are updated from events instead of being
+ * computed again at each frame: the islands of two bodies are merged (with a union-find that
+ * is kept from one frame to the next) when a new contact or joint connects them, and an island
+ * is marked to be split (with a search through its constraint graph) when it loses a body, a
+ * contact or a joint. The ids of the islands are only used to group the bodies and do not
+ * change the order in which the islands are solved.
+ */
+struct IslandGraph {
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Id of the island of a body that is not part of an island
+        static constexpr uint32 INVALID_ISLAND_ID = static_cast<uint32>(-1);
+
+        // -------------------- Attributes -------------------- //
+
+        /// Union-find parent of each island id (an island id is the root of its set if it is its own parent)
+        Array<uint32> parents;
+
+        /// For each island id, true if the island must be split in the next frame
+        Array<bool> isSplitNeeded;
+
+        /// Ids of the islands that are not used anymore
+        Array<uint32> freeIslandIds;
+
+        /// Ids of the islands that have been marked to be split since the last time the islands have been split
+        Array<uint32> islandsToSplit;
+
+        /// Ids of the islands that have been merged into another island since the last time the islands have been created
+        Array<uint32> mergedIslandIds;
+
+        /// Bodies whose contacts and joints must be added into the islands in the next frame
+        /// (bodies that have been created, woken up or modified)
+        Array<Entity> bodiesToAdd;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        IslandGraph(MemoryAllocator& allocator)
+            : parents(allocator), isSplitNeeded(allocator), freeIslandIds(allocator), islandsToSplit(allocator),
+              mergedIslandIds(allocator), bodiesToAdd(allocator) {
+
+        }
+
+        /// Return the number of island ids (used or free)
+        uint32 getNbIslandIds() const {
+            return static_cast<uint32>(parents.size());
+        }
+
+        /// Create a new island and return its id
+        uint32 createIsland() {
+
+            uint32 islandId;
+            if (freeIslandIds.size() > 0) {
+
+                islandId = freeIslandIds[freeIslandIds.size() - 1];
+                freeIslandIds.removeAt(freeIslandIds.size() - 1);
+            }
+            else {
+
+                islandId = static_cast<uint32>(parents.size());
+                parents.add(islandId);
+                isSplitNeeded.add(false);
+            }
+
+            parents[islandId] = islandId;
+            isSplitNeeded[islandId] = false;
+
+            return islandId;
+        }
+
+        /// Release the id of an island that is not referenced by any body anymore
+        void destroyIsland(uint32 islandId) {
+
+            parents[islandId] = islandId;
+            isSplitNeeded[islandId] = false;
+            freeIslandIds.add(islandId);
+        }
+
+        /// Mark the island (the root of the set of an island id) to be split in the next frame
+        void markSplitNeeded(uint32 islandId) {
+
+            if (islandId != INVALID_ISLAND_ID) {
+
+                assert(islandId < getNbIslandIds());
+
+                const uint32 rootIslandId = findRoot(islandId);
+                if (!isSplitNeeded[rootIslandId]) {
+
+                    isSplitNeeded[rootIslandId] = true;
+                    islandsToSplit.add(rootIslandId);
+                }
+            }
+        }
+
+        /// Return the root island of the set of an island (the path to the root is halved)
+        uint32 findRoot(uint32 islandId) {
+
+            while (parents[islandId] != islandId) {
+
+                parents[islandId] = parents[parents[islandId]];
+                islandId = parents[islandId];
+            }
+
+            return islandId;
+        }
+
+        /// Merge the sets of two islands
+        void merge(uint32 islandId1, uint32 islandId2) {
+
+            uint32 root1 = findRoot(islandId1);
+            uint32 root2 = findRoot(islandId2);
+            if (root1 == root2) return;
+
+            // The root with the smallest id becomes the root of the merged set
+            if (root2 < root1) {
+                const uint32 tmp = root1;
+                root1 = root2;
+                root2 = tmp;
+            }
+            parents[root2] = root1;
+            mergedIslandIds.add(root2);
+
+            // The merged island must be split if one of its two islands had to be split
+            if (isSplitNeeded[root2]) {
+
+                isSplitNeeded[root2] = false;
+                markSplitNeeded(root1);
+            }
+        }
+
+        /// Remove all the islands
+        void clear() {
+
+            parents.clear();
+            isSplitNeeded.clear();
+            freeIslandIds.clear();
+            islandsToSplit.clear();
+            mergedIslandIds.clear();
+            bodiesToAdd.clear();
+        }
+};
+}
+
+#endif
@@ -43,6 +43,8 @@ namespace reactphysics3d {
 
 // Declarations
 struct NarrowPhaseInfoBatch;
+class SnapshotWriter;
+class SnapshotReader;
 enum class NarrowPhaseAlgorithmType;
 class CollisionShape;
 class CollisionDispatch;
@@ -104,6 +106,9 @@ class OverlappingPairs {
 
     public:
 
+        /// Invalid index of a contact pair
+        static constexpr uint32 INVALID_INDEX = static_cast<uint32>(-1);
+
         struct OverlappingPair {
 
             /// Ids of the convex vs convex pairs
@@ -135,12 +140,20 @@ class OverlappingPairs {
             /// True if the colliders of the overlapping pair are colliding in the current frame
             bool collidingInCurrentFrame;
 
+            /// Index of the contact pair of this overlapping pair in the array of contact pairs that is
+            /// being filled (only valid if the contact pair at this index has the same pair id)
+            uint32 contactPairIndex;
+
+            /// Index of the contact pair of this overlapping pair in the array of contact pairs of the
+            /// previous frame (only valid if the contact pair at this index has the same pair id)
+            uint32 previousContactPairIndex;
+
             /// Constructor
             OverlappingPair(uint64 pairId, int32 broadPhaseId1, int32 broadPhaseId2, Entity collider1, Entity collider2,
                             NarrowPhaseAlgorithmType narrowPhaseAlgorithmType)
                : pairID(pairId), broadPhaseId1(broadPhaseId1), broadPhaseId2(broadPhaseId2), collider1(collider1) , collider2(collider2),
                  needToTestOverlap(false), narrowPhaseAlgorithmType(narrowPhaseAlgorithmType), collidingInPreviousFrame(false),
-                 collidingInCurrentFrame(false) {
+                 collidingInCurrentFrame(false), contactPairIndex(INVALID_INDEX), previousContactPairIndex(INVALID_INDEX) {
 
             }
 
@@ -181,15 +194,16 @@ class OverlappingPairs {
                 /// Temporal coherence data store collision information about the last frame.
                 /// If two convex shapes overlap, we have a single collision data but if one shape is concave,
                 /// we might have collision data for several overlapping triangles. The key in the map is the
-                /// shape Ids of the two collision shapes.
+                /// shape Ids of the two collision shapes. The map is allocated with the pool allocator
+                /// because pairs are created and destroyed at each frame when the bodies move.
                 Map<uint64, LastFrameCollisionInfo*> lastFrameCollisionInfos;
 
                 /// Constructor
                 ConcaveOverlappingPair(uint64 pairId, int32 broadPhaseId1, int32 broadPhaseId2, Entity collider1, Entity collider2,
                                 NarrowPhaseAlgorithmType narrowPhaseAlgorithmType,
-                                bool isShape1Convex, MemoryAllocator& poolAllocator, MemoryAllocator& heapAllocator)
+                                bool isShape1Convex, MemoryAllocator& poolAllocator)
                   : OverlappingPair(pairId, broadPhaseId1, broadPhaseId2, collider1, collider2, narrowPhaseAlgorithmType), mPoolAllocator(&poolAllocator),
-                    isShape1Convex(isShape1Convex), lastFrameCollisionInfos(heapAllocator, 16) {
+                    isShape1Convex(isShape1Convex), lastFrameCollisionInfos(poolAllocator, 16) {
 
                 }
 
@@ -271,25 +285,48 @@ class OverlappingPairs {
 
     private:
 
+        // Structure PairSlot
+        /**
+         * Entry of the table that maps the id of an overlapping pair to the index of the
+         * pair in the convex or concave pairs array. The id of a pair is made of the index
+         * of its slot (lower 32 bits) and of the generation of the slot (upper 32 bits).
+         * This way, a pair is found with a single array read and the id of a removed pair
+         * never points to another pair that reuses the same slot.
+         */
+        struct PairSlot {
+
+            /// Index of the pair in the convex or concave pairs array
+            uint32 pairIndex;
+
+            /// Generation of the slot (incremented each time the slot is released)
+            uint32 generation;
+
+            /// True if the pair is in the convex pairs array
+            bool isConvexVsConvex;
+
+            /// Constructor
+            PairSlot(uint32 pairIndex, uint32 generation, bool isConvexVsConvex)
+                : pairIndex(pairIndex), generation(generation), isConvexVsConvex(isConvexVsConvex) {
+
+            }
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Pool memory allocator
         MemoryAllocator& mPoolAllocator;
 
-        /// Heap memory allocator
-        MemoryAllocator& mHeapAllocator;
-
         /// Array of convex vs convex overlapping pairs
         Array<ConvexOverlappingPair> mConvexPairs;
 
         /// Array of convex vs concave overlapping pairs
         Array<ConcaveOverlappingPair> mConcavePairs;
 
-        /// Map a pair id to the internal array index
-        Map<uint64, uint64> mMapConvexPairIdToPairIndex;
+        /// Slots of the pairs (the index of a slot is stored in the lower 32 bits of a pair id)
+        Array<PairSlot> mPairSlots;
 
-        /// Map a pair id to the internal array index
-        Map<uint64, uint64> mMapConcavePairIdToPairIndex;
+        /// Indices of the slots that are not used by any pair
+        Array<uint32> mFreePairSlots;
 
         /// Reference to the colliders components
         ColliderComponents& mColliderComponents;
@@ -321,6 +358,27 @@ class OverlappingPairs {
         /// Swap two pairs in the array
         void swapPairs(uint64 index1, uint64 index2);
 
+        /// Allocate a slot for a new pair and return the id of the pair
+        uint64 allocatePairSlot(uint32 pairIndex, bool isConvexVsConvex);
+
+        /// Release the slot of a removed pair
+        void releasePairSlot(uint64 pairId);
+
+        /// Return the slot of a pair (or nullptr if the pair does not exist anymore)
+        const PairSlot* getPairSlot(uint64 pairId) const;
+
+        /// Return the index of a pair in the convex or concave pairs array
+        uint32 getPairIndex(uint64 pairId) const;
+
+        /// Write the attributes of a pair into a snapshot
+        static void savePairToSnapshot(SnapshotWriter& writer, const OverlappingPair& pair);
+
+        /// Read the attributes of a pair from a snapshot
+        static void restorePairFromSnapshot(SnapshotReader& reader, OverlappingPair& pair);
+
+        /// Skip the attributes of a pair in a snapshot
+        static void skipPairFromSnapshot(SnapshotReader& reader);
+
     public:
 
         // -------------------- Methods -------------------- //
@@ -364,6 +422,18 @@ class OverlappingPairs {
         /// Return a reference to an overlapping pair
         OverlappingPair* getOverlappingPair(uint64 pairId);
 
+        /// Return the overlapping pair between two colliders (or nullptr if there is none)
+        OverlappingPair* findOverlappingPair(uint32 collider1Index, uint32 collider2Index);
+
+        /// Save the overlapping pairs and their temporal coherence data into a snapshot
+        void saveSnapshot(SnapshotWriter& writer) const;
+
+        /// Restore the overlapping pairs and their temporal coherence data from a snapshot
+        void restoreSnapshot(SnapshotReader& reader);
+
+        /// Skip the overlapping pairs in a snapshot and return true if they can be restored
+        bool skipSnapshot(SnapshotReader& reader) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Set the profiler
@@ -388,30 +458,73 @@ RP3D_FORCE_INLINE bodypair OverlappingPairs::computeBodiesIndexPair(Entity body1
     return indexPair;
 }
 
+// Return the slot of a pair (or nullptr if the pair does not exist anymore)
+RP3D_FORCE_INLINE const OverlappingPairs::PairSlot* OverlappingPairs::getPairSlot(uint64 pairId) const {
+
+    const uint32 slotIndex = static_cast<uint32>(pairId & 0xFFFFFFFF);
+    const uint32 generation = static_cast<uint32>(pairId >> 32);
+
+    if (slotIndex >= mPairSlots.size() || mPairSlots[slotIndex].generation != generation) {
+        return nullptr;
+    }
+
+    return &(mPairSlots[slotIndex]);
+}
+
+// Return the index of a pair in the convex or concave pairs array
+RP3D_FORCE_INLINE uint32 OverlappingPairs::getPairIndex(uint64 pairId) const {
+
+    const PairSlot* slot = getPairSlot(pairId);
+    assert(slot != nullptr);
+
+    return slot->pairIndex;
+}
+
 // Set if we need to test a given pair for overlap
 RP3D_FORCE_INLINE void OverlappingPairs::setNeedToTestOverlap(uint64 pairId, bool needToTestOverlap) {
 
-    assert(mMapConvexPairIdToPairIndex.containsKey(pairId) || mMapConcavePairIdToPairIndex.containsKey(pairId));
+    OverlappingPair* pair = getOverlappingPair(pairId);
+    assert(pair != nullptr);
 
-    auto it = mMapConvexPairIdToPairIndex.find(pairId);
-    if (it != mMapConvexPairIdToPairIndex.end()) {
-        mConvexPairs[static_cast<uint32>(it->second)].needToTestOverlap = needToTestOverlap;
-    }
-    else {
-        mConcavePairs[static_cast<uint32>(mMapConcavePairIdToPairIndex[pairId])].needToTestOverlap = needToTestOverlap;
-    }
+    pair->needToTestOverlap = needToTestOverlap;
 }
 
 // Return a reference to an overlapping pair
 RP3D_FORCE_INLINE OverlappingPairs::OverlappingPair* OverlappingPairs::getOverlappingPair(uint64 pairId) {
 
-    auto it = mMapConvexPairIdToPairIndex.find(pairId);
-    if (it != mMapConvexPairIdToPairIndex.end()) {
-        return &(mConvexPairs[static_cast<uint32>(it->second)]);
+    const PairSlot* slot = getPairSlot(pairId);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+
+    if (slot->isConvexVsConvex) {
+        return &(mConvexPairs[slot->pairIndex]);
     }
-    it = mMapConcavePairIdToPairIndex.find(pairId);
-    if (it != mMapConcavePairIdToPairIndex.end()) {
-        return &(mConcavePairs[static_cast<uint32>(it->second)]);
+
+    return &(mConcavePairs[slot->pairIndex]);
+}
+
+// Return the overlapping pair between two colliders (or nullptr if there is none)
+/// The pair is searched in the array of overlapping pairs of the collider that has
+/// the fewest of them, which avoids any hashing of the pair.
+RP3D_FORCE_INLINE OverlappingPairs::OverlappingPair* OverlappingPairs::findOverlappingPair(uint32 collider1Index, uint32 collider2Index) {
+
+    const Array<uint64>* colliderPairs = &(mColliderComponents.mOverlappingPairs[collider1Index]);
+    int32 otherBroadPhaseId = mColliderComponents.mBroadPhaseIds[collider2Index];
+    if (mColliderComponents.mOverlappingPairs[collider2Index].size() < colliderPairs->size()) {
+        colliderPairs = &(mColliderComponents.mOverlappingPairs[collider2Index]);
+        otherBroadPhaseId = mColliderComponents.mBroadPhaseIds[collider1Index];
+    }
+
+    const uint64 nbPairs = colliderPairs->size();
+    for (uint64 i=0; i < nbPairs; i++) {
+
+        OverlappingPair* pair = getOverlappingPair((*colliderPairs)[i]);
+        assert(pair != nullptr);
+
+        if (pair->broadPhaseId1 == otherBroadPhaseId || pair->broadPhaseId2 == otherBroadPhaseId) {
+            return pair;
+        }
     }
 
     return nullptr;
@@ -37,6 +37,7 @@
 #include <reactphysics3d/collision/shapes/ConcaveMeshShape.h>
 #include <reactphysics3d/collision/TriangleMesh.h>
 #include <reactphysics3d/utils/DefaultLogger.h>
+#include <reactphysics3d/utils/DefaultTaskScheduler.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -92,6 +93,9 @@ class PhysicsCommon {
         /// Set of default loggers
         Set<DefaultLogger*> mDefaultLoggers;
 
+        /// Set of default task schedulers
+        Set<DefaultTaskScheduler*> mDefaultTaskSchedulers;
+
         /// Half-edge structure of a box polyhedron
         HalfEdgeStructure mBoxShapeHalfEdgeStructure;
 
@@ -136,6 +140,9 @@ class PhysicsCommon {
         /// Delete a default logger
         void deleteDefaultLogger(DefaultLogger* logger);
 
+        /// Delete a default task scheduler
+        void deleteDefaultTaskScheduler(DefaultTaskScheduler* taskScheduler);
+
         /// Initialize the half-edge structure of a BoxShape
         void initBoxShapeHalfEdgeStructure();
 
@@ -229,6 +236,12 @@ class PhysicsCommon {
         /// Destroy a default logger
         void destroyDefaultLogger(DefaultLogger* logger);
 
+        /// Create and return a new default task scheduler
+        DefaultTaskScheduler* createDefaultTaskScheduler(uint32 nbWorkers = 0);
+
+        /// Destroy a default task scheduler
+        void destroyDefaultTaskScheduler(DefaultTaskScheduler* taskScheduler);
+
         /// Return the current logger
         static Logger* getLogger();
 
@@ -43,6 +43,7 @@
 #include <reactphysics3d/components/SliderJointComponents.h>
 #include <reactphysics3d/collision/CollisionCallback.h>
 #include <reactphysics3d/collision/OverlapCallback.h>
+#include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/utils/Logger.h>
 #include <reactphysics3d/systems/ConstraintSolverSystem.h>
@@ -50,7 +51,10 @@
 #include <reactphysics3d/systems/ContactSolverSystem.h>
 #include <reactphysics3d/systems/DynamicsSystem.h>
 #include <reactphysics3d/engine/Islands.h>
+#include <reactphysics3d/engine/IslandGraph.h>
+#include <reactphysics3d/engine/SolverBodies.h>
 #include <reactphysics3d/utils/DebugRenderer.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
 #include <sstream>
 
 /// Namespace ReactPhysics3D
@@ -61,6 +65,7 @@ class Island;
 class RigidBody;
 class PhysicsCommon;
 struct JointInfo;
+class WorldSnapshot;
 
 // Class PhysicsWorld
 /**
@@ -119,6 +124,46 @@ class PhysicsWorld {
             /// than the value bellow, the manifold are considered to be similar.
             decimal cosAngleSimilarContactManifold;
 
+            /// True if the contact manifolds are solved by groups with SIMD instructions. The
+            /// manifolds are solved in a different order and the results are slightly different.
+            bool isWideContactSolverEnabled;
+
+            /// Minimum number of constraints (joints and contact manifolds) of an island to partition
+            /// them into colors that are solved in parallel when a task scheduler is set (zero to never
+            /// do it). The result does not depend on the number of threads but it is slightly different
+            /// from the result of solving the constraints of the island one after the other.
+            uint32 minNbConstraintsIslandSolvedByColors;
+
+            /// True if the simulation must give bit-identical results for the same sequence of calls
+            /// whatever the number of threads and the hash containers ordering. The moved shapes are
+            /// tested in the broad-phase in a stable order and the large islands are solved by colors
+            /// even without task scheduler. The results are not independent of the insertion order:
+            /// the order in which the bodies, colliders and joints are created and destroyed is part
+            /// of the sequence of calls and two worlds with the same objects created in a different
+            /// order can give different results. To get the same results with different compilers and
+            /// platforms, the library must also be compiled with the RP3D_STRICT_FP_ENABLED option.
+            bool isDeterministic;
+
+            /// Number of checkpoints in the ring buffer used by the PhysicsWorld::saveState() method
+            uint32 nbStateCheckpoints;
+
+            /// The broad-phase tree of the dynamic and kinematic colliders is periodically rebuilt when its cost
+            /// becomes larger than the cost it had after its last rebuild multiplied by this ratio (zero to
+            /// never rebuild it automatically)
+            decimal broadPhaseTreeRebuildCostRatio;
+
+            /// True if the fat AABBs of the colliders in the broad-phase are extruded along the predicted
+            /// displacement of their body and their margins are clamped between broadPhaseFatAABBMinMargin
+            /// and broadPhaseFatAABBMaxMargin. Otherwise, the fat AABBs are inflated by a constant percentage
+            /// of their size. This avoids reinserting small fast bodies into the tree at every frame.
+            bool isBroadPhaseFatAABBPredictive;
+
+            /// Minimum margin (in meters) between the AABB of a collider and its predictive fat AABB
+            decimal broadPhaseFatAABBMinMargin;
+
+            /// Maximum margin (in meters) between the AABB of a collider and its predictive fat AABB in each direction
+            decimal broadPhaseFatAABBMaxMargin;
+
             WorldSettings() {
 
                 worldName = "";
@@ -134,6 +179,14 @@ class PhysicsWorld {
                 defaultSleepLinearVelocity = decimal(0.02);
                 defaultSleepAngularVelocity = decimal(3.0) * (PI_RP3D / decimal(180.0));
                 cosAngleSimilarContactManifold = decimal(0.95);
+                isWideContactSolverEnabled = false;
+                minNbConstraintsIslandSolvedByColors = 1024;
+                isDeterministic = false;
+                nbStateCheckpoints = 16;
+                broadPhaseTreeRebuildCostRatio = decimal(1.5);
+                isBroadPhaseFatAABBPredictive = false;
+                broadPhaseFatAABBMinMargin = decimal(0.02);
+                broadPhaseFatAABBMaxMargin = decimal(2.0);
             }
 
             ~WorldSettings() = default;
@@ -156,6 +209,14 @@ class PhysicsWorld {
                 ss << "defaultSleepLinearVelocity=" << defaultSleepLinearVelocity << std::endl;
                 ss << "defaultSleepAngularVelocity=" << defaultSleepAngularVelocity << std::endl;
                 ss << "cosAngleSimilarContactManifold=" << cosAngleSimilarContactManifold << std::endl;
+                ss << "isWideContactSolverEnabled=" << isWideContactSolverEnabled << std::endl;
+                ss << "minNbConstraintsIslandSolvedByColors=" << minNbConstraintsIslandSolvedByColors << std::endl;
+                ss << "isDeterministic=" << isDeterministic << std::endl;
+                ss << "nbStateCheckpoints=" << nbStateCheckpoints << std::endl;
+                ss << "broadPhaseTreeRebuildCostRatio=" << broadPhaseTreeRebuildCostRatio << std::endl;
+                ss << "isBroadPhaseFatAABBPredictive=" << isBroadPhaseFatAABBPredictive << std::endl;
+                ss << "broadPhaseFatAABBMinMargin=" << broadPhaseFatAABBMinMargin << std::endl;
+                ss << "broadPhaseFatAABBMaxMargin=" << broadPhaseFatAABBMaxMargin << std::endl;
 
                 return ss.str();
             }
@@ -231,6 +292,12 @@ class PhysicsWorld {
         /// All the islands of bodies of the current frame
         Islands mIslands;
 
+        /// Persistent islands of the awake bodies (kept from one frame to the next)
+        IslandGraph mIslandGraph;
+
+        /// Packed state of the bodies of the islands used by the contact and joint solvers
+        SolverBodies mSolverBodies;
+
         /// Order in which to process the ContactPairs for contact creation such that
         /// all the contact manifolds and contact points of a given island are packed together
         /// This array contains the indices of the ContactPairs.
@@ -270,6 +337,18 @@ class PhysicsWorld {
         /// becomes smaller than the sleep velocity.
         decimal mTimeBeforeSleep;
 
+        /// Task scheduler used to execute independent work on several threads (null if none)
+        TaskScheduler* mTaskScheduler;
+
+        /// All the snapshots created by the world
+        Array<WorldSnapshot*> mSnapshots;
+
+        /// Ring buffer of checkpoints of the dynamic state of the world (see saveState())
+        Array<WorldSnapshot*> mStateCheckpoints;
+
+        /// Number of states saved with the saveState() method
+        uint32 mNbSavedStates;
+
         // -------------------- Methods -------------------- //
 
         /// Constructor
@@ -293,6 +372,24 @@ class PhysicsWorld {
         /// Compute the islands using potential contacts and joints and create the actual contacts.
         void createIslands();
 
+        /// Split the islands that have lost a body or a constraint since they have been created
+        void splitIslands();
+
+        /// Add a body with its contacts and joints into the islands in the next frame
+        void addBodyToIslands(Entity bodyEntity);
+
+        /// Remove a body from its island (the island will be split in the next frame)
+        void removeBodyFromIsland(Entity bodyEntity);
+
+        /// Add a constraint between an awake non-static body and another body into the islands
+        void addConstraintToIslands(uint32 bodyIndex, Entity otherBodyEntity);
+
+        /// Update the islands when the contacts of a collider start or stop being constraints
+        void updateIslandsOfCollider(Entity colliderEntity);
+
+        /// Return true if a rigid body component is an awake non-static body (a body that is part of an island)
+        bool isIslandBody(uint32 bodyIndex) const;
+
         /// Put bodies to sleep if needed.
         void updateSleepingBodies(decimal timeStep);
 
@@ -302,6 +399,15 @@ class PhysicsWorld {
         /// Update the world inverse inertia tensors of rigid bodies
         void updateBodiesInverseWorldInertiaTensors();
 
+        /// Destroy a rigid body that has already been removed from the array of rigid bodies
+        void releaseRigidBody(RigidBody* rigidBody);
+
+        /// Save the state of the world into the data of a snapshot
+        void saveWorldState(Array<uint8>& data, bool isDynamicStateOnly) const;
+
+        /// Restore the state of the world from the data of a snapshot
+        bool restoreWorldState(const Array<uint8>& data, bool isDynamicStateOnly);
+
         /// Destructor
         ~PhysicsWorld();
 
@@ -321,6 +427,11 @@ class PhysicsWorld {
         /// Ray cast method
         void raycast(const Ray& ray, RaycastCallback* raycastCallback, unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
 
+        /// Ray cast method for a batch of rays
+        void raycastBatch(const Ray* rays, uint32 nbRays, RaycastHit* outHits,
+                          RaycastBatchMode mode = RaycastBatchMode::CLOSEST_HIT,
+                          unsigned short raycastWithCategoryMaskBits = 0xFFFF) const;
+
         /// Return true if two bodies overlap (collide)
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
@@ -372,6 +483,18 @@ class PhysicsWorld {
         /// Set the position correction technique used for contacts
         void setContactsPositionCorrectionTechnique(ContactsPositionCorrectionTechnique technique);
 
+        /// Return true if the contacts are solved with the wide (SIMD) contact solver
+        bool isWideContactSolverEnabled() const;
+
+        /// Enable/Disable the wide (SIMD) contact solver
+        void enableWideContactSolver(bool isEnabled);
+
+        /// Return true if the simulation is deterministic
+        bool isDeterministic() const;
+
+        /// Enable/Disable the deterministic simulation
+        void setIsDeterministic(bool isDeterministic);
+
         /// Create a rigid body into the physics world.
         RigidBody* createRigidBody(const Transform& transform);
 
@@ -381,12 +504,76 @@ class PhysicsWorld {
         /// Destroy a rigid body and all the joints which it belongs
         void destroyRigidBody(RigidBody* rigidBody);
 
+        /// Create several rigid bodies at once
+        void createRigidBodies(const Transform* transforms, uint32 nbBodies, RigidBody** outBodies);
+
+        /// Add several colliders to rigid bodies at once
+        void addColliders(RigidBody* const* rigidBodies, CollisionShape* const* collisionShapes,
+                          const Transform* transforms, uint32 nbColliders, Collider** outColliders);
+
+        /// Destroy several rigid bodies at once
+        void destroyRigidBodies(RigidBody* const* rigidBodies, uint32 nbBodies);
+
         /// Create a joint between two bodies in the world and return a pointer to the new joint
         Joint* createJoint(const JointInfo& jointInfo);
 
         /// Destroy a joint
         void destroyJoint(Joint* joint);
 
+        /// Create a snapshot that can store the state of the world
+        WorldSnapshot* createSnapshot();
+
+        /// Destroy a snapshot
+        void destroySnapshot(WorldSnapshot* snapshot);
+
+        /// Save the state of the world into a snapshot
+        void saveSnapshot(WorldSnapshot* snapshot) const;
+
+        /// Restore the state of the world from a snapshot
+        bool restoreSnapshot(const WorldSnapshot* snapshot);
+
+        /// Save the dynamic state of the world into the next checkpoint and return its id
+        uint32 saveState();
+
+        /// Restore the dynamic state of the world from a checkpoint
+        bool restoreState(uint32 checkpointId);
+
+        /// Return the number of checkpoints used by the saveState() method
+        uint32 getNbStateCheckpoints() const;
+
+        /// Set the number of checkpoints used by the saveState() method
+        void setNbStateCheckpoints(uint32 nbCheckpoints);
+
+        /// Return the surface area heuristic (SAH) cost of the broad-phase tree of the dynamic and kinematic colliders
+        decimal getBroadPhaseDynamicTreeCost() const;
+
+        /// Return the surface area heuristic (SAH) cost of the broad-phase tree of the static colliders
+        decimal getBroadPhaseStaticTreeCost() const;
+
+        /// Rebuild the broad-phase trees using the surface area heuristic (SAH)
+        void rebuildBroadPhaseTrees();
+
+        /// Return the cost ratio above which the broad-phase dynamic tree is automatically rebuilt
+        decimal getBroadPhaseTreeRebuildCostRatio() const;
+
+        /// Set the cost ratio above which the broad-phase dynamic tree is automatically rebuilt
+        void setBroadPhaseTreeRebuildCostRatio(decimal ratio);
+
+        /// Return true if the fat AABBs of the broad-phase are extruded along the predicted displacement of the bodies
+        bool isBroadPhaseFatAABBPredictive() const;
+
+        /// Enable or disable the extrusion of the fat AABBs of the broad-phase along the predicted displacement of the bodies
+        void setIsBroadPhaseFatAABBPredictive(bool isPredictive);
+
+        /// Set the minimum and maximum margins of the predictive fat AABBs of the broad-phase
+        void setBroadPhaseFatAABBMargins(decimal minMargin, decimal maxMargin);
+
+        /// Return the number of colliders whose AABB has been updated in the broad-phase during the last update of the world
+        uint32 getNbBroadPhaseUpdatedColliders() const;
+
+        /// Return the number of colliders that have left their fat AABB during the last update of the world
+        uint32 getNbBroadPhaseReinsertedColliders() const;
+
         /// Return the gravity vector of the world
         Vector3 getGravity() const;
 
@@ -453,6 +640,12 @@ class PhysicsWorld {
         /// Return a reference to the Debug Renderer of the world
         DebugRenderer& getDebugRenderer();
 
+        /// Return the task scheduler of the world (null if none)
+        TaskScheduler* getTaskScheduler() const;
+
+        /// Set the task scheduler used to execute the simulation on several threads
+        void setTaskScheduler(TaskScheduler* taskScheduler);
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Return a reference to the profiler
@@ -504,6 +697,24 @@ RP3D_FORCE_INLINE void PhysicsWorld::raycast(const Ray& ray,
     mCollisionDetection.raycast(raycastCallback, ray, raycastWithCategoryMaskBits);
 }
 
+// Ray cast method for a batch of rays
+/// The result of each ray is written in the output array without calling any callback. The
+/// consecutive rays are grouped into packets of four rays that traverse the broad-phase trees
+/// together, so the consecutive rays should be coherent (close origins and similar directions)
+/// to get the best performance. The rays are cast in parallel if a task scheduler is set.
+/**
+ * @param rays Array of rays to use for raycasting
+ * @param nbRays Number of rays in the array
+ * @param outHits Output array (with nbRays elements) where the result of each ray is written
+ * @param mode Result to find for each ray (closest hit or any hit)
+ * @param raycastWithCategoryMaskBits Bits mask corresponding to the category of
+ *                                    bodies to be raycasted
+ */
+RP3D_FORCE_INLINE void PhysicsWorld::raycastBatch(const Ray* rays, uint32 nbRays, RaycastHit* outHits,
+                                                  RaycastBatchMode mode, unsigned short raycastWithCategoryMaskBits) const {
+    mCollisionDetection.raycastBatch(rays, nbRays, outHits, mode, raycastWithCategoryMaskBits);
+}
+
 // Test collision and report contacts between two bodies.
 /// Use this method if you only want to get all the contacts between two bodies.
 /// All the contacts will be reported using the callback object in paramater.
@@ -621,6 +832,150 @@ RP3D_FORCE_INLINE void PhysicsWorld::setContactsPositionCorrectionTechnique(
     }
 }
 
+// Return true if the contacts are solved with the wide (SIMD) contact solver
+/**
+ * @return True if the wide contact solver is enabled
+ */
+RP3D_FORCE_INLINE bool PhysicsWorld::isWideContactSolverEnabled() const {
+    return mContactSolverSystem.isWideSolverEnabled();
+}
+
+// Enable/Disable the wide (SIMD) contact solver
+/// The wide contact solver colors the contact manifolds of each island such that
+/// the manifolds with the same color do not share any dynamic body and solves them
+/// by groups of four with SIMD instructions. Because the manifolds are not solved in
+/// the same order, the results are slightly different from the default contact solver.
+/// This has no effect if the library is not compiled with SIMD instructions (see
+/// the RP3D_SIMD_ENABLED option) or with double precision.
+/**
+ * @param isEnabled True if the wide contact solver must be used
+ */
+RP3D_FORCE_INLINE void PhysicsWorld::enableWideContactSolver(bool isEnabled) {
+    mContactSolverSystem.setIsWideSolverEnabled(isEnabled);
+}
+
+// Return true if the simulation is deterministic
+/**
+ * @return True if the simulation gives the same results whatever the number of threads
+ */
+RP3D_FORCE_INLINE bool PhysicsWorld::isDeterministic() const {
+    return mConfig.isDeterministic;
+}
+
+// Enable/Disable the deterministic simulation
+/// In the deterministic mode, the same sequence of calls always gives bit-identical
+/// results whatever the number of threads of the task scheduler (or without task scheduler).
+/// The bodies, colliders and joints must be created in the same order to get the same results.
+/// See the WorldSettings::isDeterministic setting.
+/**
+ * @param isDeterministic True if the simulation must be deterministic
+ */
+RP3D_FORCE_INLINE void PhysicsWorld::setIsDeterministic(bool isDeterministic) {
+    mConfig.isDeterministic = isDeterministic;
+    mCollisionDetection.setIsDeterministic(isDeterministic);
+}
+
+// Return the number of checkpoints used by the saveState() method
+/**
+ * @return The number of checkpoints of the ring buffer
+ */
+RP3D_FORCE_INLINE uint32 PhysicsWorld::getNbStateCheckpoints() const {
+    return static_cast<uint32>(mStateCheckpoints.size());
+}
+
+// Return the surface area heuristic (SAH) cost of the broad-phase tree of the dynamic and kinematic colliders
+/// This is the sum of the surface areas of the internal nodes of the tree divided by the surface
+/// area of its root. A smaller cost means that the broad-phase queries visit less nodes.
+/**
+ * @return The cost of the broad-phase dynamic tree
+ */
+RP3D_FORCE_INLINE decimal PhysicsWorld::getBroadPhaseDynamicTreeCost() const {
+    return mCollisionDetection.getBroadPhaseDynamicTreeCost();
+}
+
+// Return the surface area heuristic (SAH) cost of the broad-phase tree of the static colliders
+/**
+ * @return The cost of the broad-phase static tree
+ */
+RP3D_FORCE_INLINE decimal PhysicsWorld::getBroadPhaseStaticTreeCost() const {
+    return mCollisionDetection.getBroadPhaseStaticTreeCost();
+}
+
+// Rebuild the broad-phase trees using the surface area heuristic (SAH)
+/// The tree of the static colliders is never rebuilt automatically. This can be used after
+/// many static colliders have been added one by one or after many bodies have been created
+/// or moved to make the broad-phase faster.
+RP3D_FORCE_INLINE void PhysicsWorld::rebuildBroadPhaseTrees() {
+    mCollisionDetection.rebuildBroadPhaseTrees();
+}
+
+// Return the cost ratio above which the broad-phase dynamic tree is automatically rebuilt
+/**
+ * @return The ratio (zero if the tree is never rebuilt automatically)
+ */
+RP3D_FORCE_INLINE decimal PhysicsWorld::getBroadPhaseTreeRebuildCostRatio() const {
+    return mConfig.broadPhaseTreeRebuildCostRatio;
+}
+
+// Set the cost ratio above which the broad-phase dynamic tree is automatically rebuilt
+/// See the WorldSettings::broadPhaseTreeRebuildCostRatio setting.
+/**
+ * @param ratio The ratio (at least one or zero to never rebuild the tree automatically)
+ */
+RP3D_FORCE_INLINE void PhysicsWorld::setBroadPhaseTreeRebuildCostRatio(decimal ratio) {
+    mConfig.broadPhaseTreeRebuildCostRatio = ratio;
+    mCollisionDetection.setBroadPhaseTreeRebuildCostRatio(ratio);
+}
+
+// Return true if the fat AABBs of the broad-phase are extruded along the predicted displacement of the bodies
+/**
+ * @return True if the fat AABBs are predictive
+ */
+RP3D_FORCE_INLINE bool PhysicsWorld::isBroadPhaseFatAABBPredictive() const {
+    return mConfig.isBroadPhaseFatAABBPredictive;
+}
+
+// Enable or disable the extrusion of the fat AABBs of the broad-phase along the predicted displacement of the bodies
+/// See the WorldSettings::isBroadPhaseFatAABBPredictive setting. The fat AABBs that are already
+/// in the broad-phase keep their size until their collider leaves them.
+/**
+ * @param isPredictive True if the fat AABBs must be extruded along the displacement of the bodies
+ */
+RP3D_FORCE_INLINE void PhysicsWorld::setIsBroadPhaseFatAABBPredictive(bool isPredictive) {
+    mConfig.isBroadPhaseFatAABBPredictive = isPredictive;
+    mCollisionDetection.setBroadPhaseFatAABBMargins(isPredictive, mConfig.broadPhaseFatAABBMinMargin, mConfig.broadPhaseFatAABBMaxMargin);
+}
+
+// Set the minimum and maximum margins of the predictive fat AABBs of the broad-phase
+/**
+ * @param minMargin Minimum margin between the AABB of a collider and its fat AABB (in meters)
+ * @param maxMargin Maximum margin between the AABB of a collider and its fat AABB in each direction (in meters)
+ */
+RP3D_FORCE_INLINE void PhysicsWorld::setBroadPhaseFatAABBMargins(decimal minMargin, decimal maxMargin) {
+    mConfig.broadPhaseFatAABBMinMargin = minMargin;
+    mConfig.broadPhaseFatAABBMaxMargin = maxMargin;
+    mCollisionDetection.setBroadPhaseFatAABBMargins(mConfig.isBroadPhaseFatAABBPredictive, minMargin, maxMargin);
+}
+
+// Return the number of colliders whose AABB has been updated in the broad-phase during the last update of the world
+/// Only the colliders of the bodies that have moved are updated.
+/**
+ * @return The number of updated colliders
+ */
+RP3D_FORCE_INLINE uint32 PhysicsWorld::getNbBroadPhaseUpdatedColliders() const {
+    return mCollisionDetection.getNbBroadPhaseUpdatedColliders();
+}
+
+// Return the number of colliders that have left their fat AABB during the last update of the world
+/// These colliders have been reinserted into the broad-phase tree and are tested again for overlap
+/// with the other colliders in the next update.
+/**
+ * @return The number of reinserted colliders
+ */
+RP3D_FORCE_INLINE uint32 PhysicsWorld::getNbBroadPhaseReinsertedColliders() const {
+    return mCollisionDetection.getNbBroadPhaseReinsertedColliders();
+}
+
 // Return the gravity vector of the world
 /**
  * @return The current gravity vector (in meter per seconds squared)
@@ -720,6 +1075,19 @@ RP3D_FORCE_INLINE DebugRenderer& PhysicsWorld::getDebugRenderer() {
     return mDebugRenderer;
 }
 
+// Return the task scheduler of the world (null if none)
+/**
+ * @return A pointer to the task scheduler of the world or null if the simulation runs on a single thread
+ */
+RP3D_FORCE_INLINE TaskScheduler* PhysicsWorld::getTaskScheduler() const {
+    return mTaskScheduler;
+}
+
+// Return true if a rigid body component is an awake non-static body (a body that is part of an island)
+RP3D_FORCE_INLINE bool PhysicsWorld::isIslandBody(uint32 bodyIndex) const {
+    return bodyIndex < mRigidBodyComponents.getNbEnabledComponents() && mRigidBodyComponents.mBodyTypes[bodyIndex] != BodyType::STATIC;
+}
+
 }
 
 #endif
@@ -0,0 +1,190 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SOLVER_BODIES_H
+#define REACTPHYSICS3D_SOLVER_BODIES_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/containers/Array.h>
+#include <reactphysics3d/mathematics/mathematics.h>
+#include <reactphysics3d/components/RigidBodyComponents.h>
+
+namespace reactphysics3d {
+
+// Declarations
+struct Islands;
+class JointComponents;
+class ContactManifold;
+
+// Structure SolverBodies
+/**
+ * This structure contains the state of the bodies that is read and written by the
+ * contact and joint solvers during a frame. Before solving, the bodies of each island
+ * are copied into packed arrays in island order and the two bodies of each joint and
+ * contact manifold are resolved once into indices in those arrays. This way, the solver
+ * iterations do not need any entity lookup and only access contiguous memory. At the end
+ * of the solver, the state of the bodies is written back into the rigid body components.
+ * Note that a static body has one solver body in each island that it touches so that
+ * two islands never share a solver body and can be solved on different threads.
+ * The constraints of a large island can also be partitioned into colors that are solved
+ * in parallel. In such an island, each joint and contact manifold gets its own solver body
+ * for a static or kinematic body so that the constraints of a color never share a solver body.
+ */
+struct SolverBodies {
+
+    private:
+
+        // -------------------- Constants -------------------- //
+
+        /// Index used for a joint or contact manifold whose bodies are not resolved yet
+        static constexpr uint32 INVALID_INDEX = static_cast<uint32>(-1);
+
+        // -------------------- Attributes -------------------- //
+
+        /// Reference to the islands
+        Islands& mIslands;
+
+        /// Reference to the rigid body components
+        RigidBodyComponents& mRigidBodyComponents;
+
+        /// Reference to the joint components
+        JointComponents& mJointComponents;
+
+        /// For each rigid body component, index of its last solver body. This index
+        /// might be stale and has to be validated with the rigidBodyComponentIndices array.
+        Array<uint32> mRigidBodySolverIndices;
+
+        // -------------------- Methods -------------------- //
+
+        /// Add a solver body for a rigid body component and return its index
+        uint32 addSolverBody(uint32 rigidBodyComponentIndex);
+
+        /// Return the index of the solver body of a rigid body component (create it if necessary)
+        uint32 getOrAddSolverBody(uint32 rigidBodyComponentIndex);
+
+        /// Return the index of the solver body of a body of a constraint in a given island
+        uint32 getConstraintSolverBody(uint32 rigidBodyComponentIndex, bool isIslandSolvedByColors);
+
+    public:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Index of the rigid body component of each solver body
+        Array<uint32> rigidBodyComponentIndices;
+
+        /// Type of each solver body
+        Array<BodyType> bodyTypes;
+
+        /// Constrained linear velocity of each solver body
+        Array<Vector3> linearVelocities;
+
+        /// Constrained angular velocity of each solver body
+        Array<Vector3> angularVelocities;
+
+        /// Split linear velocity of each solver body (used for position error correction)
+        Array<Vector3> splitLinearVelocities;
+
+        /// Split angular velocity of each solver body (used for position error correction)
+        Array<Vector3> splitAngularVelocities;
+
+        /// Constrained position of each solver body
+        Array<Vector3> positions;
+
+        /// Constrained orientation of each solver body
+        Array<Quaternion> orientations;
+
+        /// Inverse mass of each solver body
+        Array<decimal> inverseMasses;
+
+        /// Linear lock axis factor of each solver body
+        Array<Vector3> linearLockAxisFactors;
+
+        /// Angular lock axis factor of each solver body
+        Array<Vector3> angularLockAxisFactors;
+
+        /// Inverse of the local inertia tensor (diagonal) of each solver body
+        Array<Vector3> inverseInertiaTensorsLocal;
+
+        /// Local center of mass of each solver body
+        Array<Vector3> centersOfMassLocal;
+
+        /// For each enabled joint component, index of the solver body of the first body of the joint
+        Array<uint32> jointsBody1Indices;
+
+        /// For each enabled joint component, index of the solver body of the second body of the joint
+        Array<uint32> jointsBody2Indices;
+
+        /// For each contact manifold of an island, index of the solver body of the first body
+        Array<uint32> contactManifoldsBody1Indices;
+
+        /// For each contact manifold of an island, index of the solver body of the second body
+        Array<uint32> contactManifoldsBody2Indices;
+
+        /// For each island, true if the constraints of the island are solved by colors in parallel
+        Array<bool> islandsSolvedByColors;
+
+        /// Number of islands whose constraints are solved by colors in parallel
+        uint32 nbIslandsSolvedByColors;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SolverBodies(MemoryAllocator& allocator, Islands& islands, RigidBodyComponents& rigidBodyComponents,
+                     JointComponents& jointComponents);
+
+        /// Destructor
+        ~SolverBodies() = default;
+
+        /// Assignment operator
+        SolverBodies& operator=(const SolverBodies& solverBodies) = delete;
+
+        /// Copy-constructor
+        SolverBodies(const SolverBodies& solverBodies) = delete;
+
+        /// Return the number of solver bodies
+        uint32 getNbBodies() const;
+
+        /// Create the solver bodies of the islands and resolve the bodies of the joints and contact manifolds
+        void initialize(const Array<ContactManifold>& contactManifolds, uint32 minNbConstraintsSolvedByColors);
+
+        /// Write the constrained and split velocities back into the rigid body components
+        void storeVelocities();
+
+        /// Read the constrained positions and orientations from the rigid body components
+        void loadPositions();
+
+        /// Write the constrained positions and orientations back into the rigid body components
+        void storePositions();
+};
+
+// Return the number of solver bodies
+RP3D_FORCE_INLINE uint32 SolverBodies::getNbBodies() const {
+    return static_cast<uint32>(rigidBodyComponentIndices.size());
+}
+
+}
+
+#endif
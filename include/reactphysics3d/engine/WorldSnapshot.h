@@ -0,0 +1,339 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_WORLD_SNAPSHOT_H
+#define REACTPHYSICS3D_WORLD_SNAPSHOT_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/containers/Array.h>
+#include <cstring>
+#include <type_traits>
+
+namespace reactphysics3d {
+
+// Class SnapshotWriter
+/**
+ * This class appends the raw bytes of the state of a world at the end of the data
+ * of a snapshot. Only trivially copyable types can be written. The data is organized
+ * in sections that start with their size in bytes so that a reader can skip them.
+ */
+class SnapshotWriter {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Data of the snapshot
+        Array<uint8>& mData;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SnapshotWriter(Array<uint8>& data) : mData(data) {
+
+        }
+
+        /// Append raw bytes at the end of the snapshot
+        void write(const void* data, size_t size);
+
+        /// Append a value at the end of the snapshot
+        template<typename T>
+        void writeValue(const T& value);
+
+        /// Append an array of values at the end of the snapshot
+        template<typename T>
+        void writeValues(const T* values, uint32 nbValues);
+
+        /// Append the size and the elements of an array at the end of the snapshot
+        template<typename T>
+        void writeArray(const Array<T>& array);
+
+        /// Start a new section and return its start position
+        uint32 beginSection();
+
+        /// Write the size of the section that starts at a given position
+        void endSection(uint32 sectionStart);
+};
+
+// Class SnapshotReader
+/**
+ * This class reads the raw bytes of the state of a world from the data of a snapshot.
+ * All the reads are bounds checked. If the end of the data is reached before a read,
+ * the reader becomes invalid and the values that are read are zero.
+ */
+class SnapshotReader {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Data of the snapshot
+        const uint8* mData;
+
+        /// Size (in bytes) of the data
+        uint32 mSize;
+
+        /// Current read position in the data
+        uint32 mPosition;
+
+        /// False if we tried to read after the end of the data
+        bool mIsValid;
+
+    public:
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        SnapshotReader(const uint8* data, uint32 size)
+            : mData(data), mSize(size), mPosition(0), mIsValid(true) {
+
+        }
+
+        /// Read raw bytes from the snapshot
+        void read(void* data, size_t size);
+
+        /// Read a value from the snapshot
+        template<typename T>
+        void readValue(T& value);
+
+        /// Read an array of values from the snapshot
+        template<typename T>
+        void readValues(T* values, uint32 nbValues);
+
+        /// Read the size and the elements of an array from the snapshot
+        template<typename T>
+        void readArray(Array<T>& array);
+
+        /// Skip raw bytes of the snapshot
+        void skip(size_t size);
+
+        /// Skip a value of the same type as a given value
+        template<typename T>
+        void skipValue(const T& value);
+
+        /// Skip an array of values of the same type as the given values
+        template<typename T>
+        void skipValues(const T* values, uint32 nbValues);
+
+        /// Skip the size and the elements of an array of the same type as a given array
+        template<typename T>
+        void skipArray(const Array<T>& array);
+
+        /// Return a reader for the next section and move after the end of this section
+        SnapshotReader readSection();
+
+        /// Return the number of bytes that remain to be read
+        uint32 getNbRemainingBytes() const;
+
+        /// Return true if there are no remaining bytes to read
+        bool isAtEnd() const;
+
+        /// Return false if we tried to read after the end of the data
+        bool isValid() const;
+};
+
+// Class WorldSnapshot
+/**
+ * This class contains a binary snapshot of the state of a physics world. The snapshot
+ * contains the raw data of the component tables, the overlapping pairs with their
+ * temporal coherence data, the broad-phase tree and the contacts used for warm starting.
+ * A snapshot can be restored into the same world or into another world built with the
+ * same bodies, colliders and joints (created in the same order). The collision shapes and
+ * the user data are part of the structure of the world and are not stored in the snapshot.
+ * The data of a snapshot can be copied (to a file or over the network) with
+ * getData() and setData() between two builds of the library with the same memory layout.
+ */
+class WorldSnapshot {
+
+    private:
+
+        // -------------------- Attributes -------------------- //
+
+        /// Binary data of the snapshot
+        Array<uint8> mData;
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        WorldSnapshot(MemoryAllocator& allocator);
+
+        /// Write the header of a snapshot
+        static void writeHeader(SnapshotWriter& writer);
+
+        /// Read the header of a snapshot and return true if the snapshot can be read by this build
+        static bool readHeader(SnapshotReader& reader);
+
+    public:
+
+        // -------------------- Constants -------------------- //
+
+        /// Magic number at the beginning of a snapshot ("RP3S")
+        static constexpr uint32 MAGIC_NUMBER = 0x53335052;
+
+        /// Version of the format of a snapshot
+        static constexpr uint32 VERSION = 3;
+
+        // -------------------- Methods -------------------- //
+
+        /// Deleted copy-constructor
+        WorldSnapshot(const WorldSnapshot& snapshot) = delete;
+
+        /// Deleted assignment operator
+        WorldSnapshot& operator=(const WorldSnapshot& snapshot) = delete;
+
+        /// Return a pointer to the binary data of the snapshot
+        const uint8* getData() const;
+
+        /// Return the size (in bytes) of the binary data of the snapshot
+        uint32 getSize() const;
+
+        /// Replace the binary data of the snapshot with a copy of the given data
+        void setData(const uint8* data, uint32 size);
+
+        // -------------------- Friendship -------------------- //
+
+        friend class PhysicsWorld;
+};
+
+// Append a value at the end of the snapshot
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotWriter::writeValue(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written in a snapshot");
+    write(&value, sizeof(T));
+}
+
+// Append an array of values at the end of the snapshot
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotWriter::writeValues(const T* values, uint32 nbValues) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written in a snapshot");
+    write(values, nbValues * sizeof(T));
+}
+
+// Append the size and the elements of an array at the end of the snapshot
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotWriter::writeArray(const Array<T>& array) {
+    const uint32 nbValues = static_cast<uint32>(array.size());
+    writeValue(nbValues);
+    if (nbValues > 0) {
+        writeValues(&(array[0]), nbValues);
+    }
+}
+
+// Read a value from the snapshot
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotReader::readValue(T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read from a snapshot");
+    read(&value, sizeof(T));
+}
+
+// Read an array of values from the snapshot
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotReader::readValues(T* values, uint32 nbValues) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read from a snapshot");
+    read(values, nbValues * sizeof(T));
+}
+
+// Read the size and the elements of an array from the snapshot
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotReader::readArray(Array<T>& array) {
+
+    uint32 nbValues = 0;
+    readValue(nbValues);
+
+    // Make sure that a corrupted size cannot allocate more than the remaining data
+    if (static_cast<uint64>(nbValues) * sizeof(T) > mSize - mPosition) {
+        mIsValid = false;
+        nbValues = 0;
+    }
+
+    array.clear();
+    if (nbValues > 0) {
+        array.addWithoutInit(nbValues);
+        readValues(&(array[0]), nbValues);
+    }
+}
+
+// Skip a value of the same type as a given value
+/// The value is only used to get the type of the data to skip
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotReader::skipValue(const T& /*value*/) {
+    skip(sizeof(T));
+}
+
+// Skip an array of values of the same type as the given values
+/// The values are only used to get the type of the data to skip
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotReader::skipValues(const T* /*values*/, uint32 nbValues) {
+    skip(nbValues * sizeof(T));
+}
+
+// Skip the size and the elements of an array of the same type as a given array
+/// The array is only used to get the type of the data to skip
+template<typename T>
+RP3D_FORCE_INLINE void SnapshotReader::skipArray(const Array<T>& /*array*/) {
+
+    uint32 nbValues = 0;
+    readValue(nbValues);
+
+    // Make sure that a corrupted size cannot overflow the size to skip
+    if (static_cast<uint64>(nbValues) * sizeof(T) > mSize - mPosition) {
+        mIsValid = false;
+        return;
+    }
+
+    skip(nbValues * sizeof(T));
+}
+
+// Return the number of bytes that remain to be read
+RP3D_FORCE_INLINE uint32 SnapshotReader::getNbRemainingBytes() const {
+    return mSize - mPosition;
+}
+
+// Return true if there are no remaining bytes to read
+RP3D_FORCE_INLINE bool SnapshotReader::isAtEnd() const {
+    return mPosition == mSize;
+}
+
+// Return false if we tried to read after the end of the data
+RP3D_FORCE_INLINE bool SnapshotReader::isValid() const {
+    return mIsValid;
+}
+
+// Return a pointer to the binary data of the snapshot
+RP3D_FORCE_INLINE const uint8* WorldSnapshot::getData() const {
+    return mData.size() > 0 ? &(mData[0]) : nullptr;
+}
+
+// Return the size (in bytes) of the binary data of the snapshot
+RP3D_FORCE_INLINE uint32 WorldSnapshot::getSize() const {
+    return static_cast<uint32>(mData.size());
+}
+
+}
+
+#endif
@@ -0,0 +1,255 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_SIMD_H
+#define REACTPHYSICS3D_SIMD_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <reactphysics3d/decimal.h>
+
+// Select the SIMD instruction set. The SIMD code paths are only used with single precision
+// and when the instruction set provides IEEE compliant division and square root so that
+// they compute exactly the same values as the scalar code paths.
+#if defined(IS_RP3D_SIMD_ENABLED) && !defined(IS_RP3D_DOUBLE_PRECISION_ENABLED)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define RP3D_USE_SIMD_SSE
+        #define RP3D_USE_SIMD
+        #include <emmintrin.h>
+    #elif defined(__ARM_NEON) && defined(__aarch64__)
+        #define RP3D_USE_SIMD_NEON
+        #define RP3D_USE_SIMD
+        #include <arm_neon.h>
+    #endif
+#endif
+
+#ifdef RP3D_USE_SIMD
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Struct SimdFloat4
+/**
+ * This structure represents four single precision values that are processed
+ * with a single instruction. The functions below only use operations that
+ * are correctly rounded (no fused multiply-add) so that each lane gives
+ * exactly the same result as the equivalent scalar expression.
+ */
+struct SimdFloat4 {
+
+#if defined(RP3D_USE_SIMD_SSE)
+    __m128 value;
+#elif defined(RP3D_USE_SIMD_NEON)
+    float32x4_t value;
+#endif
+
+};
+
+// Struct SimdMask4
+/**
+ * This structure represents the result of a comparison of four values (one bit per lane).
+ */
+struct SimdMask4 {
+
+#if defined(RP3D_USE_SIMD_SSE)
+    __m128 value;
+#elif defined(RP3D_USE_SIMD_NEON)
+    uint32x4_t value;
+#endif
+
+};
+
+/// Number of values processed by a SIMD instruction
+constexpr uint32 SIMD_WIDTH = 4;
+
+/// Load four values (no alignment required)
+RP3D_FORCE_INLINE SimdFloat4 simdLoad(const float* values) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_loadu_ps(values)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vld1q_f32(values)};
+#endif
+}
+
+/// Store the four values (no alignment required)
+RP3D_FORCE_INLINE void simdStore(float* values, const SimdFloat4& a) {
+#if defined(RP3D_USE_SIMD_SSE)
+    _mm_storeu_ps(values, a.value);
+#elif defined(RP3D_USE_SIMD_NEON)
+    vst1q_f32(values, a.value);
+#endif
+}
+
+/// Load four unsigned 16 bits integers and convert them into single precision values (no alignment required)
+RP3D_FORCE_INLINE SimdFloat4 simdLoadUint16(const uint16* values) {
+#if defined(RP3D_USE_SIMD_SSE)
+    const __m128i integers = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(values));
+    return {_mm_cvtepi32_ps(_mm_unpacklo_epi16(integers, _mm_setzero_si128()))};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vcvtq_f32_u32(vmovl_u16(vld1_u16(values)))};
+#endif
+}
+
+/// Return four copies of a value
+RP3D_FORCE_INLINE SimdFloat4 simdSet(float value) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_set1_ps(value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vdupq_n_f32(value)};
+#endif
+}
+
+/// Overloaded operator for addition
+RP3D_FORCE_INLINE SimdFloat4 operator+(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_add_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vaddq_f32(a.value, b.value)};
+#endif
+}
+
+/// Overloaded operator for substraction
+RP3D_FORCE_INLINE SimdFloat4 operator-(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_sub_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vsubq_f32(a.value, b.value)};
+#endif
+}
+
+/// Overloaded operator for multiplication
+RP3D_FORCE_INLINE SimdFloat4 operator*(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_mul_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vmulq_f32(a.value, b.value)};
+#endif
+}
+
+/// Overloaded operator for division
+RP3D_FORCE_INLINE SimdFloat4 operator/(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_div_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vdivq_f32(a.value, b.value)};
+#endif
+}
+
+/// Negate the values (flip the sign bit as the scalar unary minus does)
+RP3D_FORCE_INLINE SimdFloat4 operator-(const SimdFloat4& a) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_xor_ps(a.value, _mm_set1_ps(-0.0f))};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vnegq_f32(a.value)};
+#endif
+}
+
+/// Return the square roots of the values
+RP3D_FORCE_INLINE SimdFloat4 simdSqrt(const SimdFloat4& a) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_sqrt_ps(a.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vsqrtq_f32(a.value)};
+#endif
+}
+
+/// Return the minimum values (same result as std::min(a, b) in each lane)
+RP3D_FORCE_INLINE SimdFloat4 simdMin(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_min_ps(b.value, a.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vbslq_f32(vcltq_f32(b.value, a.value), b.value, a.value)};
+#endif
+}
+
+/// Return the maximum values (same result as std::max(a, b) in each lane)
+RP3D_FORCE_INLINE SimdFloat4 simdMax(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_max_ps(b.value, a.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vbslq_f32(vcltq_f32(a.value, b.value), b.value, a.value)};
+#endif
+}
+
+/// Return the lanes where a < b
+RP3D_FORCE_INLINE SimdMask4 operator<(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_cmplt_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vcltq_f32(a.value, b.value)};
+#endif
+}
+
+/// Return the lanes where a > b
+RP3D_FORCE_INLINE SimdMask4 operator>(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_cmpgt_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vcgtq_f32(a.value, b.value)};
+#endif
+}
+
+/// Return the lanes where a >= b
+RP3D_FORCE_INLINE SimdMask4 operator>=(const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_cmpge_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vcgeq_f32(a.value, b.value)};
+#endif
+}
+
+/// Return the lanes that are set in both masks
+RP3D_FORCE_INLINE SimdMask4 operator&(const SimdMask4& a, const SimdMask4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_and_ps(a.value, b.value)};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vandq_u32(a.value, b.value)};
+#endif
+}
+
+/// Return the values of a in the lanes of the mask and the values of b in the other lanes
+RP3D_FORCE_INLINE SimdFloat4 simdSelect(const SimdMask4& mask, const SimdFloat4& a, const SimdFloat4& b) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return {_mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value))};
+#elif defined(RP3D_USE_SIMD_NEON)
+    return {vbslq_f32(mask.value, a.value, b.value)};
+#endif
+}
+
+/// Return the mask as an integer where the bit i is set if the lane i is set
+RP3D_FORCE_INLINE uint32 simdMoveMask(const SimdMask4& mask) {
+#if defined(RP3D_USE_SIMD_SSE)
+    return static_cast<uint32>(_mm_movemask_ps(mask.value));
+#elif defined(RP3D_USE_SIMD_NEON)
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(mask.value, bits));
+#endif
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_ALLOCATOR_MUTEX_H
+#define REACTPHYSICS3D_ALLOCATOR_MUTEX_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+#include <atomic>
+#include <mutex>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class AllocatorMutex
+/**
+ * This class is the mutex that protects the shared state of a memory allocator. It counts
+ * the number of times it has been locked and the number of times it was already locked by
+ * another thread so that the contention on each allocator can be measured. It can be used
+ * with std::lock_guard.
+ */
+class AllocatorMutex {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Mutex
+        std::mutex mMutex;
+
+        /// Number of times the mutex has been locked
+        std::atomic<uint64> mNbLocks;
+
+        /// Number of times the mutex was already locked by another thread
+        std::atomic<uint64> mNbContendedLocks;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        AllocatorMutex() : mNbLocks(0), mNbContendedLocks(0) {
+
+        }
+
+        /// Deleted copy-constructor
+        AllocatorMutex(const AllocatorMutex& mutex) = delete;
+
+        /// Deleted assignment operator
+        AllocatorMutex& operator=(const AllocatorMutex& mutex) = delete;
+
+        /// Lock the mutex
+        void lock() {
+
+            // Try to lock the mutex first to know if another thread holds it
+            if (!mMutex.try_lock()) {
+                mNbContendedLocks.fetch_add(1, std::memory_order_relaxed);
+                mMutex.lock();
+            }
+
+            mNbLocks.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /// Unlock the mutex
+        void unlock() {
+            mMutex.unlock();
+        }
+
+        /// Return the number of times the mutex has been locked
+        uint64 getNbLocks() const {
+            return mNbLocks.load(std::memory_order_relaxed);
+        }
+
+        /// Return the number of times the mutex was already locked by another thread
+        uint64 getNbContendedLocks() const {
+            return mNbContendedLocks.load(std::memory_order_relaxed);
+        }
+
+        /// Reset the counters of the mutex
+        void resetStatistics() {
+            mNbLocks.store(0, std::memory_order_relaxed);
+            mNbContendedLocks.store(0, std::memory_order_relaxed);
+        }
+};
+
+}
+
+#endif
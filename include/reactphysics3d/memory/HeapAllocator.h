@@ -29,8 +29,8 @@
 // Libraries
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/memory/AllocatorMutex.h>
 #include <cassert>
-#include <mutex>
 #include <reactphysics3d/containers/Map.h>
 
 /// ReactPhysics3D namespace
@@ -40,6 +40,8 @@ namespace reactphysics3d {
 /**
  * This class is used to efficiently allocate memory on the heap.
  * It is used to allocate memory that cannot be allocated in a single frame allocator or a pool allocator.
+ * The free memory units are stored in segregated lists by size class (power of two) so that a large
+ * enough free unit is found without walking through all the memory units.
  */
 class HeapAllocator : public MemoryAllocator {
 
@@ -72,11 +74,18 @@ class HeapAllocator : public MemoryAllocator {
                 /// True if the next memory unit has been allocated with the same call to malloc()
                 bool isNextContiguousMemory;
 
+                /// Pointer to the previous free memory unit of the same size class (if the unit is free)
+                MemoryUnitHeader* previousFreeUnit;
+
+                /// Pointer to the next free memory unit of the same size class (if the unit is free)
+                MemoryUnitHeader* nextFreeUnit;
+
                 // -------------------- Methods -------------------- //
 
                 MemoryUnitHeader(size_t size, MemoryUnitHeader* previousUnit, MemoryUnitHeader* nextUnit, bool isNextContiguousMemory)
                     : size(size), isAllocated(false), previousUnit(previousUnit),
-                      nextUnit(nextUnit), isNextContiguousMemory(isNextContiguousMemory) {
+                      nextUnit(nextUnit), isNextContiguousMemory(isNextContiguousMemory),
+                      previousFreeUnit(nullptr), nextFreeUnit(nullptr) {
 
                     assert(size > 0);
                 }
@@ -87,10 +96,14 @@ class HeapAllocator : public MemoryAllocator {
 
         static size_t INIT_ALLOCATED_SIZE;
 
+        /// Number of size classes of the free memory units. The class i contains
+        /// the free units with a size in [2^i, 2^(i+1)).
+        static const int NB_SIZE_CLASSES = 64;
+
         // -------------------- Attributes -------------------- //
 
         // Mutex
-        std::mutex mMutex;
+        AllocatorMutex mMutex;
 
         /// Base memory allocator
         MemoryAllocator& mBaseAllocator;
@@ -101,8 +114,17 @@ class HeapAllocator : public MemoryAllocator {
         /// Pointer to the first memory unit of the linked-list
         MemoryUnitHeader* mMemoryUnits;
 
-        /// Pointer to a cached free memory unit
-        MemoryUnitHeader* mCachedFreeUnit;
+        /// Pointers to the first free memory unit of each size class
+        MemoryUnitHeader* mFreeUnits[NB_SIZE_CLASSES];
+
+        /// Bit i is set if there is at least one free memory unit in the size class i
+        uint64 mNonEmptySizeClasses;
+
+        /// Number of bytes currently allocated by the users of the allocator
+        size_t mNbUsedBytes;
+
+        /// Maximum number of bytes allocated at the same time by the users of the allocator
+        size_t mPeakNbUsedBytes;
 
 #ifndef NDEBUG
         /// This variable is incremented by one when the allocate() method has been
@@ -124,6 +146,18 @@ class HeapAllocator : public MemoryAllocator {
         /// Reserve more memory for the allocator
         void reserve(size_t sizeToAllocate);
 
+        /// Return the size class of a free memory unit of a given size
+        static int computeSizeClass(size_t size);
+
+        /// Add a free memory unit into the list of its size class
+        void addFreeUnit(MemoryUnitHeader* unit);
+
+        /// Remove a free memory unit from the list of its size class
+        void removeFreeUnit(MemoryUnitHeader* unit);
+
+        /// Return a free memory unit large enough for a given size (null if there is none)
+        MemoryUnitHeader* findFreeUnit(size_t size) const;
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -143,8 +177,46 @@ class HeapAllocator : public MemoryAllocator {
 
         /// Release previously allocated memory.
         virtual void release(void* pointer, size_t size) override;
+
+        /// Return the mutex of the allocator (to measure the contention)
+        AllocatorMutex& getMutex();
+
+        /// Return the number of bytes currently allocated by the users of the allocator
+        size_t getNbUsedBytes();
+
+        /// Return the maximum number of bytes allocated at the same time by the users of the allocator
+        size_t getPeakNbUsedBytes();
+
+        /// Reset the maximum number of allocated bytes to the current number of allocated bytes
+        void resetPeakNbUsedBytes();
 };
 
+// Return the mutex of the allocator (to measure the contention)
+RP3D_FORCE_INLINE AllocatorMutex& HeapAllocator::getMutex() {
+    return mMutex;
+}
+
+// Return the number of bytes currently allocated by the users of the allocator
+/// Unlike the memory reserved from the base allocator, this does not include the free memory
+/// units of the heap. Note that the memory blocks of the pool allocator and the buffer of the
+/// single frame allocator are allocated from the heap allocator and are therefore included.
+RP3D_FORCE_INLINE size_t HeapAllocator::getNbUsedBytes() {
+    std::lock_guard<AllocatorMutex> lock(mMutex);
+    return mNbUsedBytes;
+}
+
+// Return the maximum number of bytes allocated at the same time by the users of the allocator
+RP3D_FORCE_INLINE size_t HeapAllocator::getPeakNbUsedBytes() {
+    std::lock_guard<AllocatorMutex> lock(mMutex);
+    return mPeakNbUsedBytes;
+}
+
+// Reset the maximum number of allocated bytes to the current number of allocated bytes
+RP3D_FORCE_INLINE void HeapAllocator::resetPeakNbUsedBytes() {
+    std::lock_guard<AllocatorMutex> lock(mMutex);
+    mPeakNbUsedBytes = mNbUsedBytes;
+}
+
 }
 
 #endif
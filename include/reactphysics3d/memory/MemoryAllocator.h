@@ -40,6 +40,15 @@ class MemoryAllocator {
 
     public:
 
+        /// Alignment (in bytes) of the memory returned by the allocators. The allocators
+        /// that split their memory round the requested sizes up to a multiple of this value.
+        static constexpr size_t GLOBAL_ALIGNMENT = 8;
+
+        /// Return the size rounded up to a multiple of the global alignment
+        static size_t alignSize(size_t size) {
+            return (size + GLOBAL_ALIGNMENT - 1) & ~(GLOBAL_ALIGNMENT - 1);
+        }
+
         /// Constructor
         MemoryAllocator() = default;
 
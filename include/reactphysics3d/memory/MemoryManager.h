@@ -45,7 +45,9 @@ class MemoryAllocator;
  * allocated specified by the user. The HeapAllocator is used on top of the base allocator.
  * The SingleFrameAllocator is used for memory that is allocated only during a frame and the PoolAllocator
  * is used to allocated objects of small size. Both SingleFrameAllocator and PoolAllocator will fall back to
- * HeapAllocator if an allocation request cannot be fulfilled.
+ * HeapAllocator if an allocation request cannot be fulfilled. The number of times each allocator has been
+ * locked and the number of times another thread was holding the lock can be queried to measure the
+ * contention between the threads.
  */
 class MemoryManager {
 
@@ -99,6 +101,15 @@ class MemoryManager {
 
         /// Reset the single frame allocator
         void resetFrameAllocator();
+
+        /// Return the number of times the allocator of a given type has been locked
+        uint64 getNbLocks(AllocationType allocationType);
+
+        /// Return the number of times the allocator of a given type was already locked by another thread
+        uint64 getNbContendedLocks(AllocationType allocationType);
+
+        /// Reset the number of locks of the allocators
+        void resetLockStatistics();
 };
 
 // Allocate memory of a given type
@@ -145,6 +156,41 @@ RP3D_FORCE_INLINE void MemoryManager::resetFrameAllocator() {
    mSingleFrameAllocator.reset();
 }
 
+// Return the number of times the allocator of a given type has been locked
+/// The base allocator is not measured (zero is returned).
+RP3D_FORCE_INLINE uint64 MemoryManager::getNbLocks(AllocationType allocationType) {
+
+    switch (allocationType) {
+       case AllocationType::Base: return 0;
+       case AllocationType::Pool: return mPoolAllocator.getMutex().getNbLocks();
+       case AllocationType::Heap: return mHeapAllocator.getMutex().getNbLocks();
+       case AllocationType::Frame: return mSingleFrameAllocator.getMutex().getNbLocks();
+    }
+
+    return 0;
+}
+
+// Return the number of times the allocator of a given type was already locked by another thread
+/// The base allocator is not measured (zero is returned).
+RP3D_FORCE_INLINE uint64 MemoryManager::getNbContendedLocks(AllocationType allocationType) {
+
+    switch (allocationType) {
+       case AllocationType::Base: return 0;
+       case AllocationType::Pool: return mPoolAllocator.getMutex().getNbContendedLocks();
+       case AllocationType::Heap: return mHeapAllocator.getMutex().getNbContendedLocks();
+       case AllocationType::Frame: return mSingleFrameAllocator.getMutex().getNbContendedLocks();
+    }
+
+    return 0;
+}
+
+// Reset the number of locks of the allocators
+RP3D_FORCE_INLINE void MemoryManager::resetLockStatistics() {
+   mPoolAllocator.getMutex().resetStatistics();
+   mHeapAllocator.getMutex().resetStatistics();
+   mSingleFrameAllocator.getMutex().resetStatistics();
+}
+
 }
 
 #endif
@@ -29,6 +29,8 @@
 // Libraries
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/memory/AllocatorMutex.h>
+#include <atomic>
 #include <mutex>
 
 /// ReactPhysics3D namespace
@@ -40,6 +42,9 @@ namespace reactphysics3d {
  * It allows us to allocate small blocks of memory (smaller or equal to 1024 bytes)
  * efficiently. This implementation is inspired by the small block allocator
  * described here : http://www.codeproject.com/useritems/Small_Block_Allocator.asp
+ * Each thread keeps a cache of free memory units for each heap so that most allocation
+ * and release requests do not lock the allocator. The memory units are moved between the
+ * cache of a thread and the free memory units of the allocator by batches.
  */
 class PoolAllocator : public MemoryAllocator {
 
@@ -81,6 +86,15 @@ class PoolAllocator : public MemoryAllocator {
         /// Number of heaps
         static const int NB_HEAPS = 128;
 
+        /// Number of allocators a thread can keep a cache for
+        static const int NB_CACHES_PER_THREAD = 4;
+
+        /// Size (in bytes) of the memory units moved at once between a thread cache and the allocator
+        static const size_t BATCH_SIZE = 4096;
+
+        /// Maximum number of memory units moved at once between a thread cache and the allocator
+        static const uint32 MAX_NB_UNITS_PER_BATCH = 32;
+
         /// Maximum memory unit size. An allocation request of a size smaller or equal to
         /// this size will be handled using the small block allocator. However, for an
         /// allocation request larger than the maximum block size, the standard malloc()
@@ -90,6 +104,64 @@ class PoolAllocator : public MemoryAllocator {
         /// Size a memory chunk
         static const size_t BLOCK_SIZE = 16 * MAX_UNIT_SIZE;
 
+        // -------------------- Internal Classes -------------------- //
+
+        // Structure ThreadCache
+        /**
+         * Free memory units of each heap cached by a thread for a given allocator
+         */
+        struct ThreadCache {
+
+            public :
+
+                /// Identifier of the allocator (zero if the cache is not used)
+                uint64 allocatorId;
+
+                /// Pointers to the first free memory unit of each heap
+                MemoryUnit* freeMemoryUnits[NB_HEAPS];
+
+                /// Number of free memory units of each heap
+                uint32 nbFreeMemoryUnits[NB_HEAPS];
+        };
+
+        // Structure ThreadCaches
+        /**
+         * Caches of a thread for the last allocators used by this thread. This structure
+         * is trivially destructible so that it can still be used while the thread exits.
+         */
+        struct ThreadCaches {
+
+            public :
+
+                /// Caches of the thread
+                ThreadCache caches[NB_CACHES_PER_THREAD];
+
+                /// Index of the next cache to reuse when all the caches are used
+                uint32 nextReusedCache;
+
+                /// True if the releaser of the caches has been created for the thread
+                bool isReleaserCreated;
+
+                /// True if the thread is exiting (the caches are not used anymore)
+                bool isThreadExiting;
+        };
+
+        // Structure ThreadCachesReleaser
+        /**
+         * Object destroyed when a thread exits that gives the free memory units of the
+         * caches of this thread back to their allocators.
+         */
+        struct ThreadCachesReleaser {
+
+            public :
+
+                /// Constructor
+                ThreadCachesReleaser();
+
+                /// Destructor
+                ~ThreadCachesReleaser();
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Size of the memory units that each heap is responsible to allocate
@@ -99,11 +171,38 @@ class PoolAllocator : public MemoryAllocator {
         /// corresponding heap we will use for the allocation.
         static int mMapSizeToHeapIndex[MAX_UNIT_SIZE + 1];
 
+        /// Number of memory units moved at once between a thread cache and the allocator for each heap
+        static uint32 mNbUnitsPerBatch[NB_HEAPS];
+
         /// True if the mMapSizeToHeapIndex array has already been initialized
         static bool isMapSizeToHeadIndexInitialized;
 
-        /// Mutex
-        std::mutex mMutex;
+        /// Number of allocators created so far (used to identify the allocators)
+        static std::atomic<uint64> mNbCreatedAllocators;
+
+        /// Caches of the calling thread
+        static thread_local ThreadCaches mThreadCaches;
+
+        /// Releaser of the caches of the calling thread
+        static thread_local ThreadCachesReleaser mThreadCachesReleaser;
+
+        /// Mutex that protects the list of the existing allocators
+        static std::mutex mExistingAllocatorsMutex;
+
+        /// First allocator of the list of the existing allocators
+        static PoolAllocator* mExistingAllocators;
+
+        /// Unique identifier of the allocator
+        uint64 mId;
+
+        /// Previous allocator in the list of the existing allocators
+        PoolAllocator* mPreviousExistingAllocator;
+
+        /// Next allocator in the list of the existing allocators
+        PoolAllocator* mNextExistingAllocator;
+
+        /// Mutex that protects the free memory units and the memory blocks
+        AllocatorMutex mMutex;
 
         /// Base memory allocator
         MemoryAllocator& mBaseAllocator;
@@ -125,9 +224,26 @@ class PoolAllocator : public MemoryAllocator {
         /// called and decreased by one when the release() method has been called.
         /// This variable is used in debug mode to check that the allocate() and release()
         /// methods are called the same number of times
-        int mNbTimesAllocateMethodCalled;
+        std::atomic<int> mNbTimesAllocateMethodCalled;
 #endif
 
+        // -------------------- Methods -------------------- //
+
+        /// Return the cache of the calling thread for this allocator (null if the thread is exiting)
+        ThreadCache* getThreadCache();
+
+        /// Move a batch of free memory units of a heap from the allocator to a thread cache
+        void fillThreadCache(ThreadCache& cache, int indexHeap);
+
+        /// Move a batch of free memory units of a heap from a thread cache to the allocator
+        void releaseBatch(ThreadCache& cache, int indexHeap, uint32 nbUnits);
+
+        /// Allocate a new memory block for a heap and add its memory units into the free memory units
+        void allocateMemoryBlock(int indexHeap);
+
+        /// Give the free memory units of a thread cache back to its allocator (if it still exists)
+        static void flushThreadCache(ThreadCache& cache);
+
     public :
 
         // -------------------- Methods -------------------- //
@@ -147,8 +263,19 @@ class PoolAllocator : public MemoryAllocator {
 
         /// Release previously allocated memory.
         virtual void release(void* pointer, size_t size) override;
+
+        /// Give the free memory units cached by the calling thread back to the allocator
+        void releaseThreadCache();
+
+        /// Return the mutex of the allocator (to measure the contention)
+        AllocatorMutex& getMutex();
 };
 
+// Return the mutex of the allocator (to measure the contention)
+RP3D_FORCE_INLINE AllocatorMutex& PoolAllocator::getMutex() {
+    return mMutex;
+}
+
 }
 
 #endif
@@ -28,8 +28,8 @@
 
 // Libraries
 #include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/memory/AllocatorMutex.h>
 #include <reactphysics3d/configuration.h>
-#include <mutex>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -55,7 +55,7 @@ class SingleFrameAllocator : public MemoryAllocator {
         // -------------------- Attributes -------------------- //
 
         /// Mutex
-        std::mutex mMutex;
+        AllocatorMutex mMutex;
 
         /// Reference to the base memory allocator
         MemoryAllocator& mBaseAllocator;
@@ -97,8 +97,16 @@ class SingleFrameAllocator : public MemoryAllocator {
 
         /// Reset the marker of the current allocated memory
         virtual void reset();
+
+        /// Return the mutex of the allocator (to measure the contention)
+        AllocatorMutex& getMutex();
 };
 
+// Return the mutex of the allocator (to measure the contention)
+RP3D_FORCE_INLINE AllocatorMutex& SingleFrameAllocator::getMutex() {
+    return mMutex;
+}
+
 }
 
 #endif
@@ -43,6 +43,7 @@
 #include <reactphysics3d/engine/PhysicsWorld.h>
 #include <reactphysics3d/engine/Material.h>
 #include <reactphysics3d/engine/EventListener.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/collision/shapes/CollisionShape.h>
 #include <reactphysics3d/collision/shapes/BoxShape.h>
 #include <reactphysics3d/collision/shapes/SphereShape.h>
@@ -65,6 +66,8 @@
 #include <reactphysics3d/constraint/HingeJoint.h>
 #include <reactphysics3d/constraint/FixedJoint.h>
 #include <reactphysics3d/containers/Array.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
+#include <reactphysics3d/utils/DefaultTaskScheduler.h>
 
 /// Alias to the ReactPhysics3D namespace
 namespace rp3d = reactphysics3d;
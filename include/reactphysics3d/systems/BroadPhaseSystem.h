@@ -28,11 +28,13 @@
 
 // Libraries
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
 #include <reactphysics3d/containers/LinkedList.h>
 #include <reactphysics3d/containers/Set.h>
 #include <reactphysics3d/components/ColliderComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
 #include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
 #include <cstring>
 
 /// Namespace ReactPhysics3D
@@ -45,6 +47,10 @@ class CollisionBody;
 class Collider;
 class MemoryManager;
 class Profiler;
+class SnapshotWriter;
+class SnapshotReader;
+struct RaycastBatchTest;
+struct RayPacket;
 
 // class AABBOverlapCallback
 class AABBOverlapCallback : public DynamicAABBTreeOverlapCallback {
@@ -73,7 +79,11 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
     private :
 
-        const DynamicAABBTree& mDynamicAABBTree;
+        // Tree that is traversed (null if the wide tree is traversed)
+        const DynamicAABBTree* mDynamicAABBTree;
+
+        // Wide tree that is traversed (null if the dynamic tree is traversed)
+        const WideAABBTree* mWideAABBTree;
 
         unsigned short mRaycastWithCategoryMaskBits;
 
@@ -84,8 +94,16 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
         // Constructor
         BroadPhaseRaycastCallback(const DynamicAABBTree& dynamicAABBTree, unsigned short raycastWithCategoryMaskBits,
                                   RaycastTest& raycastTest)
-            : mDynamicAABBTree(dynamicAABBTree), mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits),
-              mRaycastTest(raycastTest) {
+            : mDynamicAABBTree(&dynamicAABBTree), mWideAABBTree(nullptr),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mRaycastTest(raycastTest) {
+
+        }
+
+        // Constructor
+        BroadPhaseRaycastCallback(const WideAABBTree& wideAABBTree, unsigned short raycastWithCategoryMaskBits,
+                                  RaycastTest& raycastTest)
+            : mDynamicAABBTree(nullptr), mWideAABBTree(&wideAABBTree),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mRaycastTest(raycastTest) {
 
         }
 
@@ -97,23 +115,98 @@ class BroadPhaseRaycastCallback : public DynamicAABBTreeRaycastCallback {
 
 };
 
+// Class BroadPhaseRaycastPacketCallback
+/**
+ * Callback called when the AABB of a leaf node is hit by some rays of a
+ * packet in a broad-phase tree.
+ */
+class BroadPhaseRaycastPacketCallback : public DynamicAABBTreeRaycastPacketCallback {
+
+    private :
+
+        // Tree that is traversed (null if the wide tree is traversed)
+        const DynamicAABBTree* mDynamicAABBTree;
+
+        // Wide tree that is traversed (null if the dynamic tree is traversed)
+        const WideAABBTree* mWideAABBTree;
+
+        unsigned short mRaycastWithCategoryMaskBits;
+
+        RaycastBatchTest& mRaycastBatchTest;
+
+    public:
+
+        // Constructor
+        BroadPhaseRaycastPacketCallback(const DynamicAABBTree& dynamicAABBTree, unsigned short raycastWithCategoryMaskBits,
+                                        RaycastBatchTest& raycastBatchTest)
+            : mDynamicAABBTree(&dynamicAABBTree), mWideAABBTree(nullptr),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mRaycastBatchTest(raycastBatchTest) {
+
+        }
+
+        // Constructor
+        BroadPhaseRaycastPacketCallback(const WideAABBTree& wideAABBTree, unsigned short raycastWithCategoryMaskBits,
+                                        RaycastBatchTest& raycastBatchTest)
+            : mDynamicAABBTree(nullptr), mWideAABBTree(&wideAABBTree),
+              mRaycastWithCategoryMaskBits(raycastWithCategoryMaskBits), mRaycastBatchTest(raycastBatchTest) {
+
+        }
+
+        // Destructor
+        virtual ~BroadPhaseRaycastPacketCallback() override = default;
+
+        // Called for a broad-phase shape that has to be tested against some rays of a packet
+        virtual void raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 raysMask) override;
+
+};
+
 // Class BroadPhaseSystem
 /**
  * This class represents the broad-phase collision detection. The
  * goal of the broad-phase collision detection is to compute the pairs of colliders
  * that have their AABBs overlapping. Only those pairs of bodies will be tested
  * later for collision during the narrow-phase collision detection. A dynamic AABB
- * tree data structure is used for fast broad-phase collision detection.
+ * tree data structure is used for fast broad-phase collision detection. The colliders
+ * of the static bodies are stored in a separate tree that is only modified when those
+ * colliders are added, removed or moved by the user. The shapes that have moved are
+ * tested against both trees but two static colliders are never tested together. The
+ * lowest bit of a broad-phase id tells the tree of the collider and the other bits are
+ * the id of its node in this tree. The static tree is queried through a compact wide copy
+ * that is only built again after the static tree has been modified. It is used both to
+ * find the overlapping pairs and for raycasting. This copy takes about 48 bytes per
+ * static collider (a 16 bytes leaf and its share of the 64 bytes nodes) in addition to
+ * the 96 bytes per static collider of the static tree itself.
  */
 class BroadPhaseSystem {
 
     protected :
 
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of moved shapes tested for overlap by a single task
+        static const uint32 NB_MIN_MOVED_SHAPES_PER_TASK;
+
+        /// Minimum number of ray packets of a batch raycast traversed by a single task
+        static const uint32 NB_MIN_RAY_PACKETS_PER_TASK;
+
+        /// Number of updates of the colliders between two computations of the cost of the tree
+        static const uint32 NB_UPDATES_BETWEEN_TREE_COST_CHECKS;
+
         // -------------------- Attributes -------------------- //
 
-        /// Dynamic AABB tree
+        /// Dynamic AABB tree with the colliders of the dynamic and kinematic bodies
         DynamicAABBTree mDynamicAABBTree;
 
+        /// Dynamic AABB tree with the colliders of the static bodies
+        DynamicAABBTree mStaticAABBTree;
+
+        /// Compact copy of the static tree with four children per node used to find the
+        /// overlapping pairs and for raycasting
+        WideAABBTree mStaticWideTree;
+
+        /// True if the static tree has been modified since its compact copy has been built
+        bool mIsStaticWideTreeOutdated;
+
         /// Reference to the colliders components
         ColliderComponents& mCollidersComponents;
 
@@ -131,6 +224,35 @@ class BroadPhaseSystem {
         /// Reference to the collision detection object
         CollisionDetectionSystem& mCollisionDetection;
 
+        /// Task scheduler used to find the overlapping pairs on several threads (null if none)
+        TaskScheduler* mTaskScheduler;
+
+        /// True if the moved shapes are tested in the order of their broad-phase ids instead
+        /// of the order of the hash set (which depends on the platform and on its history)
+        bool mIsDeterministic;
+
+        /// Overlapping nodes found for each range of moved shapes before they are merged together
+        Array<Array<Pair<int32, int32>>> mRangesOverlappingNodes;
+
+        /// The dynamic tree is rebuilt when its cost becomes larger than its reference cost
+        /// multiplied by this ratio (zero to never rebuild the tree automatically)
+        decimal mTreeRebuildCostRatio;
+
+        /// Smallest cost of the dynamic tree since it has been rebuilt for the last time (zero if unknown)
+        decimal mReferenceTreeCost;
+
+        /// Number of updates of the colliders since the cost of the dynamic tree has been computed
+        uint32 mNbUpdatesSinceTreeCostCheck;
+
+        /// True if the fat AABBs of the dynamic tree are extruded along the displacement of the bodies
+        bool mIsFatAABBExtrudedAlongDisplacement;
+
+        /// Number of colliders whose AABB has been updated during the last update of the colliders
+        uint32 mNbUpdatedColliders;
+
+        /// Number of colliders reinserted into a tree during the last update of the colliders
+        uint32 mNbReinsertedColliders;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Pointer to the profiler
@@ -139,12 +261,42 @@ class BroadPhaseSystem {
 #endif
         // -------------------- Methods -------------------- //
 
+        /// Return the broad-phase id of a node of the static or dynamic tree
+        static int32 computeBroadPhaseId(int32 nodeId, bool isStaticTree);
+
+        /// Return true if a broad-phase id corresponds to the static tree
+        static bool isInStaticTree(int32 broadPhaseId);
+
+        /// Return the id of the node of a broad-phase id in its tree
+        static int32 getNodeId(int32 broadPhaseId);
+
+        /// Return the tree that contains a given broad-phase id
+        DynamicAABBTree& getTree(int32 broadPhaseId);
+
+        /// Return the tree that contains a given broad-phase id
+        const DynamicAABBTree& getTree(int32 broadPhaseId) const;
+
+        /// Return true if a collider must be stored in the static tree
+        bool isColliderStatic(const Collider* collider) const;
+
         /// Notify the Dynamic AABB tree that a collider needs to be updated
-        void updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
-                                    bool forceReInsert);
+        bool updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
+                                    bool forceReInsert, const Vector3& displacement);
 
         /// Update the broad-phase state of some colliders components
-        void updateCollidersComponents(uint32 startIndex, uint32 nbItems);
+        void updateCollidersComponents(uint32 startIndex, uint32 nbItems, bool areUnmovedCollidersSkipped, decimal timeStep);
+
+        /// Add several colliders into one of the two trees at once
+        void addCollidersToTree(Collider* const* colliders, const AABB* aabbs, uint32 nbColliders, bool isStaticTree);
+
+        /// Add the overlapping nodes of a range of moved shapes into the final array without duplicates
+        void mergeOverlappingNodes(const Array<Pair<int32, int32>>& rangeOverlappingNodes, Array<Pair<int32, int32>>& overlappingNodes) const;
+
+        /// Rebuild the dynamic tree if its quality has degraded too much
+        void checkTreeQuality();
+
+        /// Build the compact copy of the static tree again if the static tree has been modified
+        void updateStaticWideTree();
 
     public :
 
@@ -166,6 +318,9 @@ class BroadPhaseSystem {
         /// Add a collider into the broad-phase collision detection
         void addCollider(Collider* collider, const AABB& aabb);
 
+        /// Add several colliders into the broad-phase collision detection at once
+        void addColliders(Collider* const* colliders, const AABB* aabbs, uint32 nbColliders);
+
         /// Remove a collider from the broad-phase collision detection
         void removeCollider(Collider* collider);
 
@@ -173,7 +328,7 @@ class BroadPhaseSystem {
         void updateCollider(Entity colliderEntity);
 
         /// Update the broad-phase state of all the enabled colliders
-        void updateColliders();
+        void updateColliders(decimal timeStep);
 
         /// Add a collider in the array of colliders that have moved in the last simulation step
         /// and that need to be tested again for broad-phase overlapping.
@@ -183,6 +338,33 @@ class BroadPhaseSystem {
         /// step and that need to be tested again for broad-phase overlapping.
         void removeMovedCollider(int broadPhaseID);
 
+        /// Set the task scheduler used to find the overlapping pairs on several threads
+        void setTaskScheduler(TaskScheduler* taskScheduler);
+
+        /// Set to true if the moved shapes must be tested in a deterministic order
+        void setIsDeterministic(bool isDeterministic);
+
+        /// Return the surface area heuristic (SAH) cost of the tree of the dynamic and kinematic colliders
+        decimal getDynamicTreeCost() const;
+
+        /// Return the surface area heuristic (SAH) cost of the tree of the static colliders
+        decimal getStaticTreeCost() const;
+
+        /// Rebuild the two trees using the surface area heuristic (SAH)
+        void rebuildTrees();
+
+        /// Set the ratio between the cost of the dynamic tree and its reference cost above which the tree is rebuilt
+        void setTreeRebuildCostRatio(decimal ratio);
+
+        /// Set the margins of the fat AABBs of the dynamic tree
+        void setFatAABBMargins(bool isExtrudedAlongDisplacement, decimal minMargin, decimal maxMargin);
+
+        /// Return the number of colliders whose AABB has been updated during the last update of the colliders
+        uint32 getNbUpdatedColliders() const;
+
+        /// Return the number of colliders reinserted into a tree during the last update of the colliders
+        uint32 getNbReinsertedColliders() const;
+
         /// Compute all the overlapping pairs of collision shapes
         void computeOverlappingPairs(MemoryManager& memoryManager, Array<Pair<int32, int32>>& overlappingNodes);
 
@@ -198,6 +380,19 @@ class BroadPhaseSystem {
         /// Ray casting method
         void raycast(const Ray& ray, RaycastTest& raycastTest, unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Ray casting method for a batch of rays
+        void raycastBatch(MemoryManager& memoryManager, const Ray* rays, uint32 nbRays, RaycastBatchTest& raycastBatchTest,
+                          unsigned short raycastWithCategoryMaskBits) const;
+
+        /// Save the broad-phase trees and the moved colliders into a snapshot
+        void saveSnapshot(SnapshotWriter& writer, bool isStaticTreeSaved) const;
+
+        /// Restore the broad-phase trees and the moved colliders from a snapshot
+        void restoreSnapshot(SnapshotReader& reader, bool isStaticTreeSaved);
+
+        /// Skip the broad-phase trees and the moved colliders in a snapshot and return true if they can be restored
+        bool skipSnapshot(SnapshotReader& reader, bool isStaticTreeSaved) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -207,9 +402,37 @@ class BroadPhaseSystem {
 
 };
 
+// Return the broad-phase id of a node of the static or dynamic tree
+RP3D_FORCE_INLINE int32 BroadPhaseSystem::computeBroadPhaseId(int32 nodeId, bool isStaticTree) {
+    assert(nodeId >= 0);
+    return nodeId * 2 + (isStaticTree ? 1 : 0);
+}
+
+// Return true if a broad-phase id corresponds to the static tree
+RP3D_FORCE_INLINE bool BroadPhaseSystem::isInStaticTree(int32 broadPhaseId) {
+    assert(broadPhaseId >= 0);
+    return (broadPhaseId & 1) != 0;
+}
+
+// Return the id of the node of a broad-phase id in its tree
+RP3D_FORCE_INLINE int32 BroadPhaseSystem::getNodeId(int32 broadPhaseId) {
+    assert(broadPhaseId >= 0);
+    return broadPhaseId >> 1;
+}
+
+// Return the tree that contains a given broad-phase id
+RP3D_FORCE_INLINE DynamicAABBTree& BroadPhaseSystem::getTree(int32 broadPhaseId) {
+    return isInStaticTree(broadPhaseId) ? mStaticAABBTree : mDynamicAABBTree;
+}
+
+// Return the tree that contains a given broad-phase id
+RP3D_FORCE_INLINE const DynamicAABBTree& BroadPhaseSystem::getTree(int32 broadPhaseId) const {
+    return isInStaticTree(broadPhaseId) ? mStaticAABBTree : mDynamicAABBTree;
+}
+
 // Return the fat AABB of a given broad-phase shape
 RP3D_FORCE_INLINE const AABB& BroadPhaseSystem::getFatAABB(int broadPhaseId) const  {
-    return mDynamicAABBTree.getFatAABB(broadPhaseId);
+    return getTree(broadPhaseId).getFatAABB(getNodeId(broadPhaseId));
 }
 
 // Remove a collider from the array of colliders that have moved in the last simulation step
@@ -220,9 +443,45 @@ RP3D_FORCE_INLINE void BroadPhaseSystem::removeMovedCollider(int broadPhaseID) {
     mMovedShapes.remove(broadPhaseID);
 }
 
+// Set the task scheduler used to find the overlapping pairs on several threads
+RP3D_FORCE_INLINE void BroadPhaseSystem::setTaskScheduler(TaskScheduler* taskScheduler) {
+    mTaskScheduler = taskScheduler;
+}
+
+// Set to true if the moved shapes must be tested in a deterministic order
+RP3D_FORCE_INLINE void BroadPhaseSystem::setIsDeterministic(bool isDeterministic) {
+    mIsDeterministic = isDeterministic;
+}
+
+// Return the surface area heuristic (SAH) cost of the tree of the dynamic and kinematic colliders
+RP3D_FORCE_INLINE decimal BroadPhaseSystem::getDynamicTreeCost() const {
+    return mDynamicAABBTree.computeSAHCost();
+}
+
+// Return the surface area heuristic (SAH) cost of the tree of the static colliders
+RP3D_FORCE_INLINE decimal BroadPhaseSystem::getStaticTreeCost() const {
+    return mStaticAABBTree.computeSAHCost();
+}
+
+// Set the ratio between the cost of the dynamic tree and its reference cost above which the tree is rebuilt
+RP3D_FORCE_INLINE void BroadPhaseSystem::setTreeRebuildCostRatio(decimal ratio) {
+    assert(ratio == decimal(0.0) || ratio >= decimal(1.0));
+    mTreeRebuildCostRatio = ratio;
+}
+
+// Return the number of colliders whose AABB has been updated during the last update of the colliders
+RP3D_FORCE_INLINE uint32 BroadPhaseSystem::getNbUpdatedColliders() const {
+    return mNbUpdatedColliders;
+}
+
+// Return the number of colliders reinserted into a tree during the last update of the colliders
+RP3D_FORCE_INLINE uint32 BroadPhaseSystem::getNbReinsertedColliders() const {
+    return mNbReinsertedColliders;
+}
+
 // Return the collider corresponding to the broad-phase node id in parameter
 RP3D_FORCE_INLINE Collider* BroadPhaseSystem::getColliderForBroadPhaseId(int broadPhaseId) const {
-    return static_cast<Collider*>(mDynamicAABBTree.getNodeDataPointer(broadPhaseId));
+    return static_cast<Collider*>(getTree(broadPhaseId).getNodeDataPointer(getNodeId(broadPhaseId)));
 }
 
 #ifdef IS_RP3D_PROFILING_ENABLED
@@ -231,6 +490,8 @@ RP3D_FORCE_INLINE Collider* BroadPhaseSystem::getColliderForBroadPhaseId(int bro
 RP3D_FORCE_INLINE void BroadPhaseSystem::setProfiler(Profiler* profiler) {
 	mProfiler = profiler;
 	mDynamicAABBTree.setProfiler(profiler);
+	mStaticAABBTree.setProfiler(profiler);
+	mStaticWideTree.setProfiler(profiler);
 }
 
 #endif
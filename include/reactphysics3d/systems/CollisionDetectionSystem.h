@@ -44,6 +44,8 @@
 #include <reactphysics3d/components/ColliderComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
 #include <reactphysics3d/collision/HalfEdgeStructure.h>
+#include <reactphysics3d/memory/SingleFrameAllocator.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -53,10 +55,14 @@ class PhysicsWorld;
 class CollisionCallback;
 class OverlapCallback;
 class RaycastCallback;
+struct RaycastHit;
+enum class RaycastBatchMode;
 class ContactPoint;
 class MemoryManager;
 class EventListener;
 class CollisionDispatch;
+class SnapshotWriter;
+class SnapshotReader;
 
 // Class CollisionDetectionSystem
 /**
@@ -76,6 +82,36 @@ class CollisionDetectionSystem {
         /// Maximum number of contact points in a reduced contact manifold
         static const int8 MAX_CONTACT_POINTS_IN_MANIFOLD = 4;
 
+        /// Minimum number of narrow-phase infos of a batch tested by a single task
+        static const uint32 NB_MIN_NARROW_PHASE_ITEMS_PER_TASK = 32;
+
+        // -------------------- Types -------------------- //
+
+        /// Range of items of a narrow-phase batch that is tested by a single task
+        struct NarrowPhaseBatchRange {
+
+            /// Narrow-phase algorithm of the batch
+            NarrowPhaseAlgorithmType algorithmType;
+
+            /// Narrow-phase batch
+            NarrowPhaseInfoBatch* batch;
+
+            /// Index of the first item of the range in the batch
+            uint32 startIndex;
+
+            /// Number of items in the range
+            uint32 nbItems;
+
+            /// True if a contact has been found in the range
+            bool contactFound;
+
+            /// Constructor
+            NarrowPhaseBatchRange(NarrowPhaseAlgorithmType algorithmType, NarrowPhaseInfoBatch* batch, uint32 startIndex, uint32 nbItems)
+                : algorithmType(algorithmType), batch(batch), startIndex(startIndex), nbItems(nbItems), contactFound(false) {
+
+            }
+        };
+
         // -------------------- Attributes -------------------- //
 
         /// Memory manager
@@ -132,10 +168,6 @@ class CollisionDetectionSystem {
         /// Array of lost contact pairs (contact pairs in contact in previous frame but not in the current one)
         Array<ContactPair> mLostContactPairs;
 
-        /// Pointer to the map of overlappingPairId to the index of contact pair of the previous frame
-        /// (either mMapPairIdToContactPairIndex1 or mMapPairIdToContactPairIndex2)
-        Map<uint64, uint> mPreviousMapPairIdToContactPairIndex;
-
         /// First array with the contact manifolds
         Array<ContactManifold> mContactManifolds1;
 
@@ -163,6 +195,9 @@ class CollisionDetectionSystem {
         /// Array with the indices of all the contact pairs that have at least one CollisionBody
         Array<uint32> mCollisionBodyContactPairsIndices;
 
+        /// Array with the indices of the contact pairs between two rigid bodies that were not touching in the previous frame
+        Array<uint32> mNewContactPairsIndices;
+
         /// Number of potential contact manifolds in the previous frame
         uint32 mNbPreviousPotentialContactManifolds;
 
@@ -172,6 +207,13 @@ class CollisionDetectionSystem {
         /// Reference to the half-edge structure of the triangle polyhedron
         HalfEdgeStructure& mTriangleHalfEdgeStructure;
 
+        /// Task scheduler used to execute the broad-phase and narrow-phase on several threads (null if none)
+        TaskScheduler* mTaskScheduler;
+
+        /// Single frame allocators of the workers of the task scheduler (the worker
+        /// with index 0 is the calling thread and uses the allocator of the caller)
+        Array<SingleFrameAllocator*> mWorkerFrameAllocators;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
     /// Pointer to the profiler
@@ -219,6 +261,16 @@ class CollisionDetectionSystem {
         /// Execute the narrow-phase collision detection algorithm on batches
         bool testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput, bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator);
 
+        /// Execute the narrow-phase collision detection algorithm on a range of items of a batch
+        bool testNarrowPhaseCollision(NarrowPhaseAlgorithmType algorithmType, NarrowPhaseInfoBatch& batch, uint32 startIndex, uint32 nbItems,
+                                      bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator);
+
+        /// Execute the narrow-phase collision detection algorithm on batches using the task scheduler
+        bool testNarrowPhaseCollisionParallel(NarrowPhaseInput& narrowPhaseInput, bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator);
+
+        /// Destroy the single frame allocators of the workers
+        void destroyWorkerFrameAllocators();
+
         /// Compute the concave vs convex middle-phase algorithm for a given pair of bodies
         void computeConvexVsConcaveMiddlePhase(OverlappingPairs::ConcaveOverlappingPair& overlappingPair, MemoryAllocator& allocator,
                                                NarrowPhaseInput& narrowPhaseInput, bool reportContacts);
@@ -230,7 +282,7 @@ class CollisionDetectionSystem {
         void processPotentialContacts(NarrowPhaseInfoBatch& narrowPhaseInfoBatch,
                                       bool updateLastFrameInfo, Array<ContactPointInfo>& potentialContactPoints,
                                       Array<ContactManifoldInfo>& potentialContactManifolds,
-                                      Map<uint64, uint>& mapPairIdToContactPairIndex, Array<ContactPair>* contactPairs);
+                                      Array<ContactPair>* contactPairs);
 
         /// Process the potential contacts after narrow-phase collision detection
         void processAllPotentialContacts(NarrowPhaseInput& narrowPhaseInput, bool updateLastFrameInfo, Array<ContactPointInfo>& potentialContactPoints,
@@ -246,8 +298,8 @@ class CollisionDetectionSystem {
         /// Add the contact pairs to the corresponding bodies
         void addContactPairsToBodies();
 
-        /// Compute the map from contact pairs ids to contact pair for the next frame
-        void computeMapPreviousContactPairs();
+        /// Store the index of the contact pair of each overlapping pair for the next frame
+        void updatePreviousContactPairIndices();
 
         /// Compute the lost contact pairs (contact pairs in contact in the previous frame but not in the current one)
         void computeLostContactPairs();
@@ -304,7 +356,7 @@ class CollisionDetectionSystem {
                            MemoryManager& memoryManager, HalfEdgeStructure& triangleHalfEdgeStructure);
 
         /// Destructor
-        ~CollisionDetectionSystem() = default;
+        ~CollisionDetectionSystem();
 
         /// Deleted copy-constructor
         CollisionDetectionSystem(const CollisionDetectionSystem& collisionDetection) = delete;
@@ -318,6 +370,9 @@ class CollisionDetectionSystem {
         /// Add a collider to the collision detection
         void addCollider(Collider* collider, const AABB& aabb);
 
+        /// Add several colliders to the collision detection at once
+        void addColliders(Collider* const* colliders, const AABB* aabbs, uint32 nbColliders);
+
         /// Remove a collider from the collision detection
         void removeCollider(Collider* collider);
 
@@ -325,7 +380,7 @@ class CollisionDetectionSystem {
         void updateCollider(Entity colliderEntity);
 
         /// Update all the enabled colliders
-        void updateColliders();
+        void updateColliders(decimal timeStep);
 
         /// Add a pair of bodies that cannot collide with each other
         void addNoCollisionPair(Entity body1Entity, Entity body2Entity);
@@ -349,6 +404,10 @@ class CollisionDetectionSystem {
         void raycast(RaycastCallback* raycastCallback, const Ray& ray,
                      unsigned short raycastWithCategoryMaskBits) const;
 
+        /// Ray casting method for a batch of rays
+        void raycastBatch(const Ray* rays, uint32 nbRays, RaycastHit* outHits, RaycastBatchMode mode,
+                          unsigned short raycastWithCategoryMaskBits) const;
+
         /// Return true if two bodies (collide) overlap
         bool testOverlap(CollisionBody* body1, CollisionBody* body2);
 
@@ -376,6 +435,42 @@ class CollisionDetectionSystem {
         /// Return the world event listener
         EventListener* getWorldEventListener();
 
+        /// Set the task scheduler used to execute the broad-phase and narrow-phase on several threads
+        void setTaskScheduler(TaskScheduler* taskScheduler);
+
+        /// Set to true if the pairs must be found in a deterministic order
+        void setIsDeterministic(bool isDeterministic);
+
+        /// Return the surface area heuristic (SAH) cost of the broad-phase tree of the dynamic and kinematic colliders
+        decimal getBroadPhaseDynamicTreeCost() const;
+
+        /// Return the surface area heuristic (SAH) cost of the broad-phase tree of the static colliders
+        decimal getBroadPhaseStaticTreeCost() const;
+
+        /// Rebuild the broad-phase trees using the surface area heuristic (SAH)
+        void rebuildBroadPhaseTrees();
+
+        /// Set the ratio between the cost of the broad-phase dynamic tree and its reference cost above which the tree is rebuilt
+        void setBroadPhaseTreeRebuildCostRatio(decimal ratio);
+
+        /// Set the margins of the fat AABBs of the broad-phase dynamic tree
+        void setBroadPhaseFatAABBMargins(bool isExtrudedAlongDisplacement, decimal minMargin, decimal maxMargin);
+
+        /// Return the number of colliders whose AABB has been updated in the broad-phase during the last update
+        uint32 getNbBroadPhaseUpdatedColliders() const;
+
+        /// Return the number of colliders reinserted into a broad-phase tree during the last update
+        uint32 getNbBroadPhaseReinsertedColliders() const;
+
+        /// Save the overlapping pairs, the broad-phase and the contacts into a snapshot
+        void saveSnapshot(SnapshotWriter& writer, bool isDynamicStateOnly) const;
+
+        /// Restore the overlapping pairs, the broad-phase and the contacts from a snapshot
+        void restoreSnapshot(SnapshotReader& reader, bool isDynamicStateOnly);
+
+        /// Skip the overlapping pairs, the broad-phase and the contacts in a snapshot and return true if they can be restored
+        bool skipSnapshot(SnapshotReader& reader, bool isDynamicStateOnly) const;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -446,8 +541,48 @@ RP3D_FORCE_INLINE void CollisionDetectionSystem::updateCollider(Entity colliderE
 }
 
 // Update all the enabled colliders
-RP3D_FORCE_INLINE void CollisionDetectionSystem::updateColliders() {
-    mBroadPhaseSystem.updateColliders();
+RP3D_FORCE_INLINE void CollisionDetectionSystem::updateColliders(decimal timeStep) {
+    mBroadPhaseSystem.updateColliders(timeStep);
+}
+
+// Set to true if the pairs must be found in a deterministic order
+RP3D_FORCE_INLINE void CollisionDetectionSystem::setIsDeterministic(bool isDeterministic) {
+    mBroadPhaseSystem.setIsDeterministic(isDeterministic);
+}
+
+// Return the surface area heuristic (SAH) cost of the broad-phase tree of the dynamic and kinematic colliders
+RP3D_FORCE_INLINE decimal CollisionDetectionSystem::getBroadPhaseDynamicTreeCost() const {
+    return mBroadPhaseSystem.getDynamicTreeCost();
+}
+
+// Return the surface area heuristic (SAH) cost of the broad-phase tree of the static colliders
+RP3D_FORCE_INLINE decimal CollisionDetectionSystem::getBroadPhaseStaticTreeCost() const {
+    return mBroadPhaseSystem.getStaticTreeCost();
+}
+
+// Rebuild the broad-phase trees using the surface area heuristic (SAH)
+RP3D_FORCE_INLINE void CollisionDetectionSystem::rebuildBroadPhaseTrees() {
+    mBroadPhaseSystem.rebuildTrees();
+}
+
+// Set the ratio between the cost of the broad-phase dynamic tree and its reference cost above which the tree is rebuilt
+RP3D_FORCE_INLINE void CollisionDetectionSystem::setBroadPhaseTreeRebuildCostRatio(decimal ratio) {
+    mBroadPhaseSystem.setTreeRebuildCostRatio(ratio);
+}
+
+// Set the margins of the fat AABBs of the broad-phase dynamic tree
+RP3D_FORCE_INLINE void CollisionDetectionSystem::setBroadPhaseFatAABBMargins(bool isExtrudedAlongDisplacement, decimal minMargin, decimal maxMargin) {
+    mBroadPhaseSystem.setFatAABBMargins(isExtrudedAlongDisplacement, minMargin, maxMargin);
+}
+
+// Return the number of colliders whose AABB has been updated in the broad-phase during the last update
+RP3D_FORCE_INLINE uint32 CollisionDetectionSystem::getNbBroadPhaseUpdatedColliders() const {
+    return mBroadPhaseSystem.getNbUpdatedColliders();
+}
+
+// Return the number of colliders reinserted into a broad-phase tree during the last update
+RP3D_FORCE_INLINE uint32 CollisionDetectionSystem::getNbBroadPhaseReinsertedColliders() const {
+    return mBroadPhaseSystem.getNbReinsertedColliders();
 }
 
 #ifdef IS_RP3D_PROFILING_ENABLED
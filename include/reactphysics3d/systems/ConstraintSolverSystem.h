@@ -33,6 +33,8 @@
 #include <reactphysics3d/systems/SolveFixedJointSystem.h>
 #include <reactphysics3d/systems/SolveHingeJointSystem.h>
 #include <reactphysics3d/systems/SolveSliderJointSystem.h>
+#include <reactphysics3d/engine/ConstraintColors.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
 
 namespace reactphysics3d {
 
@@ -44,6 +46,7 @@ class Profiler;
 class RigidBodyComponents;
 class JointComponents;
 class DynamicsComponents;
+struct SolverBodies;
 
 // Structure ConstraintSolverData
 /**
@@ -147,6 +150,11 @@ class ConstraintSolverSystem {
 
     private :
 
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of joints of a color to solve in a single task
+        static const uint32 NB_MIN_JOINTS_PER_TASK;
+
         // -------------------- Attributes -------------------- //
 
         /// Current time step
@@ -158,9 +166,49 @@ class ConstraintSolverSystem {
         /// Reference to the islands
         Islands& mIslands;
 
+        /// Reference to the solver bodies
+        SolverBodies& mSolverBodies;
+
+        /// For each joint of the islands (in the same order as the joint entities of the islands),
+        /// type of the joint
+        Array<JointType> mIslandJointTypes;
+
+        /// For each joint of the islands (in the same order as the joint entities of the islands),
+        /// index of the joint in the components of its type
+        Array<uint32> mIslandJointComponentIndices;
+
+        /// For each joint of the islands (in the same order as the joint entities of the islands),
+        /// index of the solver body of the first body of the joint
+        Array<uint32> mIslandJointSolverBody1Indices;
+
+        /// For each joint of the islands (in the same order as the joint entities of the islands),
+        /// index of the solver body of the second body of the joint
+        Array<uint32> mIslandJointSolverBody2Indices;
+
+        /// Colors of the joints of the islands that are solved by colors
+        ConstraintColors mColors;
+
+        /// True if the joints of some islands have been colored in the current frame
+        bool mIsUsingColors;
+
+        /// Task scheduler used to solve the joints of a color on several threads (null if none)
+        TaskScheduler* mTaskScheduler;
+
         /// Constraint solver data used to initialize and solve the constraints
         ConstraintSolverData mConstraintSolverData;
 
+        /// Reference to the ball-and-socket joint components
+        BallAndSocketJointComponents& mBallAndSocketJointComponents;
+
+        /// Reference to the fixed joint components
+        FixedJointComponents& mFixedJointComponents;
+
+        /// Reference to the hinge joint components
+        HingeJointComponents& mHingeJointComponents;
+
+        /// Reference to the slider joint components
+        SliderJointComponents& mSliderJointComponents;
+
         /// Solver for the BallAndSocketJoint constraints
         SolveBallAndSocketJointSystem mSolveBallAndSocketJointSystem;
 
@@ -179,12 +227,24 @@ class ConstraintSolverSystem {
 		Profiler* mProfiler;
 #endif
 
+        // -------------------- Methods -------------------- //
+
+        /// Solve the velocity constraint of a joint of the islands
+        void solveVelocityConstraint(uint32 islandJointIndex);
+
+        /// Solve the position constraint of a joint of the islands
+        void solvePositionConstraint(uint32 islandJointIndex);
+
+        /// Solve the velocity or position constraints of the joints of a given island color by color
+        void solveIslandByColors(uint32 islandIndex, bool isPositionSolver);
+
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ConstraintSolverSystem(PhysicsWorld& world, Islands& islands, RigidBodyComponents& rigidBodyComponents,
+        ConstraintSolverSystem(PhysicsWorld& world, MemoryAllocator& allocator, Islands& islands, SolverBodies& solverBodies,
+                               RigidBodyComponents& rigidBodyComponents,
                                TransformComponents& transformComponents,
                                JointComponents& jointComponents,
                                BallAndSocketJointComponents& ballAndSocketJointComponents,
@@ -203,6 +263,15 @@ class ConstraintSolverSystem {
         /// Solve the position constraints
         void solvePositionConstraints();
 
+        /// Solve the velocity constraints of the joints of a given island
+        void solveVelocityConstraintsIsland(uint32 islandIndex);
+
+        /// Solve the position constraints of the joints of a given island
+        void solvePositionConstraintsIsland(uint32 islandIndex);
+
+        /// Set the task scheduler used to solve the joints of a color on several threads
+        void setTaskScheduler(TaskScheduler* taskScheduler);
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -215,6 +284,11 @@ class ConstraintSolverSystem {
         friend class HingeJoint;
 };
 
+// Set the task scheduler used to solve the joints of a color on several threads
+RP3D_FORCE_INLINE void ConstraintSolverSystem::setTaskScheduler(TaskScheduler* taskScheduler) {
+    mTaskScheduler = taskScheduler;
+}
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 // Set the profiler
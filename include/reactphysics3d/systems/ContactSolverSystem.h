@@ -30,8 +30,12 @@
 #include <reactphysics3d/configuration.h>
 #include <reactphysics3d/mathematics/Vector3.h>
 #include <reactphysics3d/mathematics/Matrix3x3.h>
+#include <reactphysics3d/mathematics/Simd.h>
 #include <reactphysics3d/containers/Array.h>
 #include <reactphysics3d/engine/Material.h>
+#include <reactphysics3d/collision/ContactManifold.h>
+#include <reactphysics3d/engine/ConstraintColors.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
 
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
@@ -44,6 +48,7 @@ class MemoryManager;
 class Profiler;
 class Island;
 struct Islands;
+struct SolverBodies;
 class RigidBody;
 class Collider;
 class PhysicsWorld;
@@ -120,6 +125,16 @@ class ColliderComponents;
  * constraints at the center of the contact manifold, we need two constraints for tangential
  * friction but also another twist friction constraint to prevent spin of the body around the
  * contact manifold center.
+ *
+ * When the wide solver is enabled (and SIMD instructions are available), the contact manifolds
+ * of each island are colored such that two manifolds with the same color never share a dynamic
+ * body. The manifolds of a color are then packed into lane groups of SIMD_WIDTH manifolds that
+ * are solved at the same time (one manifold per SIMD lane). The few manifolds that cannot be
+ * colored are solved one at a time after the lane groups of their island.
+ *
+ * The contact manifolds of an island with many constraints can also be colored in order to
+ * solve a single island on several threads. The colors are then solved one after the other
+ * and the manifolds (or lane groups) of a color are solved in parallel.
  */
 class ContactSolverSystem {
 
@@ -179,11 +194,11 @@ class ContactSolverSystem {
             /// Pointer to the external contact manifold
             ContactManifold* externalContactManifold;
 
-            /// Index of body 1 in the dynamics components arrays
-            uint32 rigidBodyComponentIndexBody1;
+            /// Index of body 1 in the solver bodies arrays
+            uint32 solverBodyIndexBody1;
 
-            /// Index of body 2 in the dynamics components arrays
-            uint32 rigidBodyComponentIndexBody2;
+            /// Index of body 2 in the solver bodies arrays
+            uint32 solverBodyIndexBody2;
 
             /// Inverse of the mass of body 1
             decimal massInverseBody1;
@@ -275,6 +290,148 @@ class ContactSolverSystem {
             int8 nbContacts;
         };
 
+#ifdef RP3D_USE_SIMD
+
+        // Structure ContactPointLanes
+        /**
+         * Contact solver internal data structure that stores the contact points with the
+         * same index in the contact manifolds of a lane group (one lane per contact manifold).
+         * A lane without contact point only contains zeros and never applies any impulse.
+         */
+        struct ContactPointLanes {
+
+            /// Normal vector of the contact
+            decimal normal[3][SIMD_WIDTH];
+
+            /// Vector from the body 1 center to the contact point
+            decimal r1[3][SIMD_WIDTH];
+
+            /// Vector from the body 2 center to the contact point
+            decimal r2[3][SIMD_WIDTH];
+
+            /// Penetration depth
+            decimal penetrationDepth[SIMD_WIDTH];
+
+            /// Velocity restitution bias
+            decimal restitutionBias[SIMD_WIDTH];
+
+            /// Inverse of the matrix K for the penenetration
+            decimal inversePenetrationMass[SIMD_WIDTH];
+
+            /// Cross product of r1 with the contact normal
+            decimal i1TimesR1CrossN[3][SIMD_WIDTH];
+
+            /// Cross product of r2 with the contact normal
+            decimal i2TimesR2CrossN[3][SIMD_WIDTH];
+
+            /// Accumulated normal impulse
+            decimal penetrationImpulse[SIMD_WIDTH];
+
+            /// Accumulated split impulse for penetration correction
+            decimal penetrationSplitImpulse[SIMD_WIDTH];
+        };
+
+        // Structure ContactLaneGroupSolver
+        /**
+         * Contact solver internal data structure that stores up to SIMD_WIDTH contact manifolds
+         * in structure-of-arrays layout (one manifold per SIMD lane). The contact manifolds of a
+         * lane group never share a dynamic body and are therefore solved at the same time.
+         */
+        struct ContactLaneGroupSolver {
+
+            /// Index of the contact manifold of each lane in the contact constraints array
+            uint32 manifoldIndices[SIMD_WIDTH];
+
+            /// Index of body 1 of each lane in the solver bodies arrays
+            uint32 solverBodyIndicesBody1[SIMD_WIDTH];
+
+            /// Index of body 2 of each lane in the solver bodies arrays
+            uint32 solverBodyIndicesBody2[SIMD_WIDTH];
+
+            /// Number of used lanes (the used lanes are the first ones)
+            uint32 nbLanes;
+
+            /// Largest number of contact points of the contact manifolds of the lanes
+            uint32 nbContacts;
+
+            /// Inverse of the mass of body 1
+            decimal massInverseBody1[SIMD_WIDTH];
+
+            /// Inverse of the mass of body 2
+            decimal massInverseBody2[SIMD_WIDTH];
+
+            /// Linear lock axis factor of body 1
+            decimal linearLockAxisFactorBody1[3][SIMD_WIDTH];
+
+            /// Linear lock axis factor of body 2
+            decimal linearLockAxisFactorBody2[3][SIMD_WIDTH];
+
+            /// Angular lock axis factor of body 1
+            decimal angularLockAxisFactorBody1[3][SIMD_WIDTH];
+
+            /// Angular lock axis factor of body 2
+            decimal angularLockAxisFactorBody2[3][SIMD_WIDTH];
+
+            /// Inverse inertia tensor of body 1 (row-major)
+            decimal inverseInertiaTensorBody1[9][SIMD_WIDTH];
+
+            /// Inverse inertia tensor of body 2 (row-major)
+            decimal inverseInertiaTensorBody2[9][SIMD_WIDTH];
+
+            /// Mix friction coefficient for the two bodies
+            decimal frictionCoefficient[SIMD_WIDTH];
+
+            /// Average normal vector of the contact manifold
+            decimal normal[3][SIMD_WIDTH];
+
+            /// R1 vector for the friction constraints
+            decimal r1Friction[3][SIMD_WIDTH];
+
+            /// R2 vector for the friction constraints
+            decimal r2Friction[3][SIMD_WIDTH];
+
+            /// Cross product of r1 with 1st friction vector
+            decimal r1CrossT1[3][SIMD_WIDTH];
+
+            /// Cross product of r1 with 2nd friction vector
+            decimal r1CrossT2[3][SIMD_WIDTH];
+
+            /// Cross product of r2 with 1st friction vector
+            decimal r2CrossT1[3][SIMD_WIDTH];
+
+            /// Cross product of r2 with 2nd friction vector
+            decimal r2CrossT2[3][SIMD_WIDTH];
+
+            /// First friction direction at contact manifold center
+            decimal frictionVector1[3][SIMD_WIDTH];
+
+            /// Second friction direction at contact manifold center
+            decimal frictionVector2[3][SIMD_WIDTH];
+
+            /// Matrix K for the first friction constraint
+            decimal inverseFriction1Mass[SIMD_WIDTH];
+
+            /// Matrix K for the second friction constraint
+            decimal inverseFriction2Mass[SIMD_WIDTH];
+
+            /// Matrix K for the twist friction constraint
+            decimal inverseTwistFrictionMass[SIMD_WIDTH];
+
+            /// First friction direction impulse at manifold center
+            decimal friction1Impulse[SIMD_WIDTH];
+
+            /// Second friction direction impulse at manifold center
+            decimal friction2Impulse[SIMD_WIDTH];
+
+            /// Twist friction impulse at contact manifold center
+            decimal frictionTwistImpulse[SIMD_WIDTH];
+
+            /// Contact points of the lanes
+            ContactPointLanes contactPoints[ContactManifold::MAX_CONTACT_POINTS_IN_MANIFOLD];
+        };
+
+#endif
+
         // -------------------- Constants --------------------- //
 
         /// Beta value for the penetration depth position correction without split impulses
@@ -286,6 +443,9 @@ class ContactSolverSystem {
         /// Slop distance (allowed penetration distance between bodies)
         static const decimal SLOP;
 
+        /// Minimum number of contact manifolds of a color to solve in a single task
+        static const uint32 NB_MIN_MANIFOLDS_PER_TASK;
+
         // -------------------- Attributes -------------------- //
 
         /// Memory manager
@@ -315,6 +475,9 @@ class ContactSolverSystem {
         /// Reference to the islands
         Islands& mIslands;
 
+        /// Reference to the solver bodies
+        SolverBodies& mSolverBodies;
+
         /// Pointer to the array of contact manifolds from narrow-phase
         Array<ContactManifold>* mAllContactManifolds;
 
@@ -333,6 +496,34 @@ class ContactSolverSystem {
         /// True if the split impulse position correction is active
         bool mIsSplitImpulseActive;
 
+        /// True if the contact manifolds are solved by lane groups with SIMD instructions
+        bool mIsWideSolverEnabled;
+
+        /// Colors of the contact manifolds of the islands
+        ConstraintColors mColors;
+
+        /// True if the contact manifolds of some islands have been colored in the current frame
+        bool mIsUsingColors;
+
+        /// Task scheduler used to solve the contact manifolds of a color on several threads (null if none)
+        TaskScheduler* mTaskScheduler;
+
+#ifdef RP3D_USE_SIMD
+
+        /// True if the lane groups have been created for the current frame
+        bool mIsUsingLaneGroups;
+
+        /// Lane groups of contact manifolds (in color order)
+        ContactLaneGroupSolver* mLaneGroups;
+
+        /// Number of lane groups
+        uint32 mNbLaneGroups;
+
+        /// Index of the first lane group of each color (with an extra last element)
+        Array<uint32> mColorsLaneGroupsStartIndices;
+
+#endif
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Pointer to the profiler
@@ -357,13 +548,39 @@ class ContactSolverSystem {
         /// Warm start the solver.
         void warmStart();
 
+        /// Solve the contact manifolds in the range [startManifoldIndex, endManifoldIndex)
+        void solve(uint32 startManifoldIndex, uint32 endManifoldIndex, uint32 startContactPointIndex);
+
+        /// Color the contact manifolds of the islands
+        void createColors(bool isColoringAllIslands);
+
+        /// Solve the contact manifolds of a given island color by color
+        void solveIslandByColors(uint32 islandIndex, bool isReverseColorOrder);
+
+#ifdef RP3D_USE_SIMD
+
+        /// Pack the colored contact manifolds into lane groups
+        void createLaneGroups();
+
+        /// Copy a contact manifold into a lane of a lane group
+        void addManifoldToLaneGroup(uint32 manifoldIndex, ContactLaneGroupSolver& laneGroup);
+
+        /// Solve the contact manifolds of a lane group
+        void solveLaneGroup(ContactLaneGroupSolver& laneGroup);
+
+        /// Copy the accumulated impulses of the lane groups back into the contact constraints
+        void storeLaneGroupsImpulses();
+
+#endif
+
    public:
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ContactSolverSystem(MemoryManager& memoryManager, PhysicsWorld& world, Islands& islands, CollisionBodyComponents& bodyComponents,
-                      RigidBodyComponents& rigidBodyComponents, ColliderComponents& colliderComponents, decimal& restitutionVelocityThreshold);
+        ContactSolverSystem(MemoryManager& memoryManager, PhysicsWorld& world, Islands& islands, SolverBodies& solverBodies,
+                      CollisionBodyComponents& bodyComponents, RigidBodyComponents& rigidBodyComponents,
+                      ColliderComponents& colliderComponents, decimal& restitutionVelocityThreshold);
 
         /// Destructor
         ~ContactSolverSystem() = default;
@@ -378,8 +595,11 @@ class ContactSolverSystem {
         /// warm start the solver at the next iteration
         void storeImpulses();
 
-        /// Solve the contacts
-        void solve();
+        /// Solve the contacts at a given iteration of the velocity solver
+        void solve(uint32 iteration);
+
+        /// Solve the contacts of a given island at a given iteration of the velocity solver
+        void solveIsland(uint32 islandIndex, uint32 iteration);
 
         /// Release allocated memory
         void reset();
@@ -390,6 +610,15 @@ class ContactSolverSystem {
         /// Activate or Deactivate the split impulses for contacts
         void setIsSplitImpulseActive(bool isActive);
 
+        /// Return true if the contact manifolds are solved by lane groups with SIMD instructions
+        bool isWideSolverEnabled() const;
+
+        /// Enable/Disable the wide solver for contacts
+        void setIsWideSolverEnabled(bool isEnabled);
+
+        /// Set the task scheduler used to solve the contact manifolds of a color on several threads
+        void setTaskScheduler(TaskScheduler* taskScheduler);
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 		/// Set the profiler
@@ -408,6 +637,22 @@ RP3D_FORCE_INLINE void ContactSolverSystem::setIsSplitImpulseActive(bool isActiv
     mIsSplitImpulseActive = isActive;
 }
 
+// Return true if the contact manifolds are solved by lane groups with SIMD instructions
+RP3D_FORCE_INLINE bool ContactSolverSystem::isWideSolverEnabled() const {
+    return mIsWideSolverEnabled;
+}
+
+// Enable/Disable the wide solver for contacts
+/// This has no effect if the library has been compiled without SIMD instructions
+RP3D_FORCE_INLINE void ContactSolverSystem::setIsWideSolverEnabled(bool isEnabled) {
+    mIsWideSolverEnabled = isEnabled;
+}
+
+// Set the task scheduler used to solve the contact manifolds of a color on several threads
+RP3D_FORCE_INLINE void ContactSolverSystem::setTaskScheduler(TaskScheduler* taskScheduler) {
+    mTaskScheduler = taskScheduler;
+}
+
 // Compute the collision restitution factor from the restitution factor of each collider
 RP3D_FORCE_INLINE decimal ContactSolverSystem::computeMixedRestitutionFactor(const Material& material1, const Material& material2) const {
 
@@ -32,6 +32,7 @@
 #include <reactphysics3d/components/RigidBodyComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
 #include <reactphysics3d/components/ColliderComponents.h>
+#include <reactphysics3d/utils/TaskScheduler.h>
 
 namespace reactphysics3d {
 
@@ -46,6 +47,11 @@ class DynamicsSystem {
 
     private :
 
+        // -------------------- Constants -------------------- //
+
+        /// Minimum number of bodies (or colliders) processed by a single task
+        static const uint32 NB_MIN_ITEMS_PER_TASK;
+
         // -------------------- Attributes -------------------- //
 
         /// Physics world
@@ -69,6 +75,17 @@ class DynamicsSystem {
         /// Reference to the world gravity vector
         Vector3& mGravity;
 
+        /// Task scheduler used to process the bodies on several threads (null if none)
+        TaskScheduler* mTaskScheduler;
+
+        // -------------------- Methods -------------------- //
+
+        /// Integrate the velocities of the rigid bodies in the range [startIndex, endIndex)
+        void integrateRigidBodiesVelocities(decimal timeStep, uint32 startIndex, uint32 endIndex);
+
+        /// Integrate the positions and orientations of the rigid bodies in the range [startIndex, endIndex)
+        void integrateRigidBodiesPositions(decimal timeStep, decimal isSplitImpulseFactor, uint32 startIndex, uint32 endIndex);
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Pointer to the profiler
@@ -94,6 +111,9 @@ class DynamicsSystem {
 
 #endif
 
+        /// Set the task scheduler used to process the bodies on several threads
+        void setTaskScheduler(TaskScheduler* taskScheduler);
+
         /// Integrate the positions and orientations of rigid bodies.
         void integrateRigidBodiesPositions(decimal timeStep, bool isSplitImpulseActive);
 
@@ -111,6 +131,11 @@ class DynamicsSystem {
 
 };
 
+// Set the task scheduler used to process the bodies on several threads
+RP3D_FORCE_INLINE void DynamicsSystem::setTaskScheduler(TaskScheduler* taskScheduler) {
+    mTaskScheduler = taskScheduler;
+}
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 // Set the profiler
@@ -32,6 +32,7 @@
 #include <reactphysics3d/components/JointComponents.h>
 #include <reactphysics3d/components/BallAndSocketJointComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
+#include <reactphysics3d/engine/SolverBodies.h>
 
 namespace reactphysics3d {
 
@@ -56,6 +57,9 @@ class SolveBallAndSocketJointSystem {
         /// Physics world
         PhysicsWorld& mWorld;
 
+        /// Reference to the solver bodies
+        SolverBodies& mSolverBodies;
+
         /// Reference to the rigid body components
         RigidBodyComponents& mRigidBodyComponents;
 
@@ -74,6 +78,15 @@ class SolveBallAndSocketJointSystem {
         /// True if warm starting of the solver is active
         bool mIsWarmStartingActive;
 
+        /// For each enabled joint component, index of the solver body of the first body
+        Array<uint32> mSolverBody1Indices;
+
+        /// For each enabled joint component, index of the solver body of the second body
+        Array<uint32> mSolverBody2Indices;
+
+        /// For each enabled joint component, position correction technique of the joint
+        Array<JointsPositionCorrectionTechnique> mPositionCorrectionTechniques;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Pointer to the profiler
@@ -85,7 +98,8 @@ class SolveBallAndSocketJointSystem {
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        SolveBallAndSocketJointSystem(PhysicsWorld& world, RigidBodyComponents& rigidBodyComponents,
+        SolveBallAndSocketJointSystem(PhysicsWorld& world, MemoryAllocator& allocator, SolverBodies& solverBodies,
+                                      RigidBodyComponents& rigidBodyComponents,
                                       TransformComponents& transformComponents,
                                       JointComponents& jointComponents,
                                       BallAndSocketJointComponents& ballAndSocketJointComponents);
@@ -105,6 +119,12 @@ class SolveBallAndSocketJointSystem {
         /// Solve the position constraint (for position error correction)
         void solvePositionConstraint();
 
+        /// Solve the velocity constraint of a single joint
+        void solveVelocityConstraint(uint32 jointComponentIndex);
+
+        /// Solve the position constraint (for position error correction) of a single joint
+        void solvePositionConstraint(uint32 jointComponentIndex);
+
         /// Set the time step
         void setTimeStep(decimal timeStep);
 
@@ -32,6 +32,7 @@
 #include <reactphysics3d/components/JointComponents.h>
 #include <reactphysics3d/components/HingeJointComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
+#include <reactphysics3d/engine/SolverBodies.h>
 
 namespace reactphysics3d {
 
@@ -55,6 +56,9 @@ class SolveHingeJointSystem {
         /// Physics world
         PhysicsWorld& mWorld;
 
+        /// Reference to the solver bodies
+        SolverBodies& mSolverBodies;
+
         /// Reference to the rigid body components
         RigidBodyComponents& mRigidBodyComponents;
 
@@ -73,6 +77,15 @@ class SolveHingeJointSystem {
         /// True if warm starting of the solver is active
         bool mIsWarmStartingActive;
 
+        /// For each enabled joint component, index of the solver body of the first body
+        Array<uint32> mSolverBody1Indices;
+
+        /// For each enabled joint component, index of the solver body of the second body
+        Array<uint32> mSolverBody2Indices;
+
+        /// For each enabled joint component, position correction technique of the joint
+        Array<JointsPositionCorrectionTechnique> mPositionCorrectionTechniques;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Pointer to the profiler
@@ -92,14 +105,15 @@ class SolveHingeJointSystem {
                                                     decimal upperLimitAngle) const;
 
         /// Compute the current angle around the hinge axis
-        decimal computeCurrentHingeAngle(Entity jointEntity, const Quaternion& orientationBody1, const Quaternion& orientationBody2);
+        decimal computeCurrentHingeAngle(uint32 jointComponentIndex, const Quaternion& orientationBody1, const Quaternion& orientationBody2);
 
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        SolveHingeJointSystem(PhysicsWorld& world, RigidBodyComponents& rigidBodyComponents,
+        SolveHingeJointSystem(PhysicsWorld& world, MemoryAllocator& allocator, SolverBodies& solverBodies,
+                              RigidBodyComponents& rigidBodyComponents,
                               TransformComponents& transformComponents,
                               JointComponents& jointComponents,
                               HingeJointComponents& hingeJointComponents);
@@ -119,6 +133,12 @@ class SolveHingeJointSystem {
         /// Solve the position constraint (for position error correction)
         void solvePositionConstraint();
 
+        /// Solve the velocity constraint of a single joint
+        void solveVelocityConstraint(uint32 jointComponentIndex);
+
+        /// Solve the position constraint (for position error correction) of a single joint
+        void solvePositionConstraint(uint32 jointComponentIndex);
+
         /// Set the time step
         void setTimeStep(decimal timeStep);
 
@@ -32,6 +32,7 @@
 #include <reactphysics3d/components/JointComponents.h>
 #include <reactphysics3d/components/SliderJointComponents.h>
 #include <reactphysics3d/components/TransformComponents.h>
+#include <reactphysics3d/engine/SolverBodies.h>
 
 namespace reactphysics3d {
 
@@ -55,6 +56,9 @@ class SolveSliderJointSystem {
         /// Physics world
         PhysicsWorld& mWorld;
 
+        /// Reference to the solver bodies
+        SolverBodies& mSolverBodies;
+
         /// Reference to the rigid body components
         RigidBodyComponents& mRigidBodyComponents;
 
@@ -73,6 +77,15 @@ class SolveSliderJointSystem {
         /// True if warm starting of the solver is active
         bool mIsWarmStartingActive;
 
+        /// For each enabled joint component, index of the solver body of the first body
+        Array<uint32> mSolverBody1Indices;
+
+        /// For each enabled joint component, index of the solver body of the second body
+        Array<uint32> mSolverBody2Indices;
+
+        /// For each enabled joint component, position correction technique of the joint
+        Array<JointsPositionCorrectionTechnique> mPositionCorrectionTechniques;
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
         /// Pointer to the profiler
@@ -86,7 +99,8 @@ class SolveSliderJointSystem {
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        SolveSliderJointSystem(PhysicsWorld& world, RigidBodyComponents& rigidBodyComponents,
+        SolveSliderJointSystem(PhysicsWorld& world, MemoryAllocator& allocator, SolverBodies& solverBodies,
+                               RigidBodyComponents& rigidBodyComponents,
                               TransformComponents& transformComponents,
                               JointComponents& jointComponents,
                               SliderJointComponents& sliderJointComponents);
@@ -106,6 +120,12 @@ class SolveSliderJointSystem {
         /// Solve the position constraint (for position error correction)
         void solvePositionConstraint();
 
+        /// Solve the velocity constraint of a single joint
+        void solveVelocityConstraint(uint32 jointComponentIndex);
+
+        /// Solve the position constraint (for position error correction) of a single joint
+        void solvePositionConstraint(uint32 jointComponentIndex);
+
         /// Set the time step
         void setTimeStep(decimal timeStep);
 
@@ -0,0 +1,150 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_DEFAULT_TASK_SCHEDULER_H
+#define REACTPHYSICS3D_DEFAULT_TASK_SCHEDULER_H
+
+// Libraries
+#include <reactphysics3d/utils/TaskScheduler.h>
+#include <reactphysics3d/containers/Array.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class DefaultTaskScheduler
+/**
+ * This class is the default task scheduler of the library. It owns a pool of worker
+ * threads that are sleeping while there is no work. When parallelFor() is called, the
+ * range of items is split into chunks and the workers (and the calling thread) keep
+ * grabbing the next available chunk until all of them have been processed. This way,
+ * a worker that finishes early automatically takes work that would otherwise wait
+ * for a slower worker.
+ */
+class DefaultTaskScheduler : public TaskScheduler {
+
+    protected:
+
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of chunks per worker for a single parallelFor() call
+        static const uint32 NB_MAX_CHUNKS_PER_WORKER;
+
+        // -------------------- Attributes -------------------- //
+
+        /// Memory allocator
+        MemoryAllocator& mAllocator;
+
+        /// Total number of workers (including the thread calling parallelFor())
+        uint32 mNbWorkers;
+
+        /// Worker threads
+        Array<std::thread*> mThreads;
+
+        /// Mutex used to synchronize the workers with the calling thread
+        std::mutex mMutex;
+
+        /// Mutex used to make sure that only one parallelFor() call is running at a time
+        std::mutex mParallelForMutex;
+
+        /// Condition variable used to wake up the workers when there is a new job
+        std::condition_variable mWorkCondition;
+
+        /// Condition variable used to notify the calling thread that the current job is done
+        std::condition_variable mDoneCondition;
+
+        /// Task of the current job
+        Task* mTask;
+
+        /// Number of items of the current job
+        uint32 mNbItems;
+
+        /// Number of items per chunk of the current job
+        uint32 mNbItemsPerChunk;
+
+        /// Number of chunks of the current job
+        uint32 mNbChunks;
+
+        /// Index of the next chunk to process
+        std::atomic<uint32> mNextChunk;
+
+        /// Number of chunks that are not processed yet
+        std::atomic<uint32> mNbRemainingChunks;
+
+        /// Number of worker threads that are currently working on the current job
+        uint32 mNbActiveWorkers;
+
+        /// Identifier of the current job (incremented for each new job)
+        uint64 mJobId;
+
+        /// True if the worker threads need to stop
+        bool mIsQuitting;
+
+        // -------------------- Methods -------------------- //
+
+        /// Main function of a worker thread
+        void runWorker(uint32 workerIndex);
+
+        /// Process chunks of the current job until all of them have been grabbed
+        void processChunks(uint32 workerIndex);
+
+        /// Constructor
+        DefaultTaskScheduler(MemoryAllocator& allocator, uint32 nbWorkers);
+
+        /// Destructor
+        virtual ~DefaultTaskScheduler() override;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Deleted copy-constructor
+        DefaultTaskScheduler(const DefaultTaskScheduler& taskScheduler) = delete;
+
+        /// Deleted assignment operator
+        DefaultTaskScheduler& operator=(const DefaultTaskScheduler& taskScheduler) = delete;
+
+        /// Return the maximum number of workers (including the calling thread) that can execute tasks concurrently
+        virtual uint32 getNbWorkers() const override;
+
+        /// Execute a task on the range [0, nbItems) using the worker threads
+        virtual void parallelFor(uint32 nbItems, uint32 minNbItemsPerTask, Task& task) override;
+
+        // ---------- Friendship ---------- //
+
+        friend class PhysicsCommon;
+};
+
+// Return the maximum number of workers (including the calling thread) that can execute tasks concurrently
+RP3D_FORCE_INLINE uint32 DefaultTaskScheduler::getNbWorkers() const {
+    return mNbWorkers;
+}
+
+}
+
+#endif
@@ -33,13 +33,114 @@
 #include <reactphysics3d/configuration.h>
 #include <fstream>
 #include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include <reactphysics3d/containers/Array.h>
 
+// Use the time-stamp counter of the CPU for the timestamps of the profile events if available
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define RP3D_PROFILER_USE_TSC
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
 /// ReactPhysics3D namespace
 namespace reactphysics3d {
 
 using clock = std::chrono::high_resolution_clock;
 
+// Structure ProfileEvent
+/**
+ * This structure represents one execution of a profiled block of code.
+ */
+struct ProfileEvent {
+
+    /// Name of the block of code
+    const char* name;
+
+    /// Timestamp at the beginning of the block of code
+    uint64 startTime;
+
+    /// Timestamp at the end of the block of code
+    uint64 endTime;
+
+    /// Number of profiled blocks of code of the same thread that enclose this one
+    uint32 depth;
+};
+
+// Class ProfileEventBuffer
+/**
+ * This class is a ring buffer where a thread records its profile events. Each thread
+ * has its own buffer and is the only one writing into it. When the buffer is full, the
+ * oldest events are overwritten. The events are recorded when the blocks of code end.
+ */
+class ProfileEventBuffer {
+
+    private :
+
+        // -------------------- Attributes -------------------- //
+
+        /// Array with the events (the capacity is a power of two)
+        ProfileEvent* mEvents;
+
+        /// Number of events that the buffer can contain
+        uint32 mCapacity;
+
+        /// Total number of events recorded in the buffer since its creation
+        std::atomic<uint64> mNbRecordedEvents;
+
+        /// Number of blocks of code that are currently executed by the thread
+        uint32 mDepth;
+
+        /// Index of the thread in the profiler
+        uint32 mThreadIndex;
+
+        /// Thread that owns the buffer
+        std::thread::id mThreadId;
+
+        /// Number of recorded events before the first event that can be exported
+        uint64 mFirstEventIndex;
+
+        /// Number of recorded events that have already been added to the profiler tree
+        uint64 mNbEventsInTree;
+
+    public :
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        ProfileEventBuffer(uint32 capacity, uint32 threadIndex, std::thread::id threadId);
+
+        /// Destructor
+        ~ProfileEventBuffer();
+
+        /// Deleted copy-constructor
+        ProfileEventBuffer(const ProfileEventBuffer& buffer) = delete;
+
+        /// Deleted assignment operator
+        ProfileEventBuffer& operator=(const ProfileEventBuffer& buffer) = delete;
+
+        /// Called when the thread enters a profiled block of code
+        void beginEvent();
+
+        /// Called when the thread exits a profiled block of code
+        void endEvent(const char* name, uint64 startTime, uint64 endTime);
+
+        /// Return the index of the oldest event that is still in the buffer
+        uint64 getOldestEventIndex(uint64 nbRecordedEvents) const;
+
+        /// Return an event given its index
+        const ProfileEvent& getEvent(uint64 index) const;
+
+        // ---------- Friendship ---------- //
+
+        friend class Profiler;
+};
+
 // Class ProfileNode
 /**
  * It represents a profile sample in the profiler tree.
@@ -56,15 +157,9 @@ class ProfileNode {
         /// Total number of calls of this node
         uint mNbTotalCalls;
 
-        /// Starting time of the sampling of corresponding block of code
-        std::chrono::time_point<clock> mStartingTime;
-
         /// Total time spent in the block of code
         std::chrono::duration<double, std::milli> mTotalTime;
 
-        /// Recursion counter
-        int mRecursionCounter;
-
         /// Pointer to the parent node
         ProfileNode* mParentNode;
 
@@ -105,11 +200,8 @@ class ProfileNode {
         /// Return the total time spent in the block of code
         std::chrono::duration<double, std::milli> getTotalTime() const;
 
-        /// Called when we enter the block of code corresponding to this profile node
-        void enterBlockOfCode();
-
-        /// Called when we exit the block of code corresponding to this profile node
-        bool exitBlockOfCode();
+        /// Add a call of the block of code to the node
+        void addCall(std::chrono::duration<double, std::milli> duration);
 
         /// Reset the profiling of the node
         void reset();
@@ -180,8 +272,13 @@ class ProfileNodeIterator {
 
 // Class Profiler
 /**
- * This is the main class of the profiler. This profiler is based on "Real-Time Hierarchical
- * Profiling" article from "Game Programming Gems 3" by Greg Hjelstrom and Byon Garrabrant.
+ * This is the main class of the profiler. Each thread records the profiled blocks of code that
+ * it executes as events in its own ring buffer. The recent events of all the threads can be
+ * exported as a Chrome trace (JSON) to see the timeline of the frames in chrome://tracing or
+ * Perfetto. The events of the thread that updates the world are also accumulated into a profiler
+ * tree for the text report. This tree is based on "Real-Time Hierarchical Profiling" article from
+ * "Game Programming Gems 3" by Greg Hjelstrom and Byon Garrabrant. The profiling can be disabled
+ * at runtime, in which case a profiled block of code only costs a test.
  */
 class Profiler {
 
@@ -279,20 +376,62 @@ class Profiler {
 
     private :
 
+        // -------------------- Constants -------------------- //
+
+        /// Maximum number of events in the ring buffer of a thread (power of two)
+        static const uint32 NB_MAX_EVENTS_PER_THREAD;
+
+        /// Maximum depth of the profiler tree
+        static const uint32 MAX_TREE_DEPTH;
+
         // -------------------- Attributes -------------------- //
 
+        /// Number of profilers created so far (used to identify the profilers)
+        static std::atomic<uint64> mNbCreatedProfilers;
+
+        /// Unique identifier of the profiler
+        uint64 mId;
+
+        /// True if the blocks of code are profiled
+        std::atomic<bool> mIsEnabled;
+
         /// Root node of the profiler tree
         ProfileNode mRootNode;
 
-        /// Current node in the current execution
-        ProfileNode* mCurrentNode;
-
         /// Frame counter
         uint mFrameCounter;
 
+        /// Thread that updates the world. Only the events of this thread are
+        /// accumulated in the profiler tree
+        std::thread::id mProfilingThreadId;
+
         /// Starting profiling time
         std::chrono::time_point<clock> mProfilingStartTime;
 
+        /// Timestamp at the start of the profiling
+        uint64 mProfilingStartTimestamp;
+
+        /// Time when the profiler has been created (used to compute the timestamp frequency)
+        std::chrono::time_point<std::chrono::steady_clock> mCalibrationTime;
+
+        /// Timestamp when the profiler has been created (used to compute the timestamp frequency)
+        uint64 mCalibrationTimestamp;
+
+        /// Number of timestamp ticks per millisecond
+        double mNbTicksPerMillisecond;
+
+        /// Mutex to protect the array of event buffers
+        std::mutex mEventBuffersMutex;
+
+        /// Number of allocated event buffers
+        uint32 mNbAllocatedEventBuffers;
+
+        /// Number of event buffers (one per thread)
+        uint32 mNbEventBuffers;
+
+        /// Event buffers of the threads
+        ProfileEventBuffer** mEventBuffers;
+
         /// Number of allocated destinations
         uint mNbAllocatedDestinations;
 
@@ -312,6 +451,15 @@ class Profiler {
 		/// Destroy the profiler (release the memory)
 		void destroy();
 
+        /// Create the event buffer of the calling thread
+        ProfileEventBuffer* createThreadEventBuffer();
+
+        /// Update the number of timestamp ticks per millisecond
+        void updateTimestampFrequency();
+
+        /// Add the new events of the profiling thread to the profiler tree
+        void updateProfilerTree();
+
 
     public :
 
@@ -323,12 +471,17 @@ class Profiler {
         /// Destructor
         ~Profiler();
 
-        /// Method called when we want to start profiling a block of code.
-        void startProfilingBlock(const char *name);
+        /// Return true if the blocks of code are profiled
+        bool isEnabled() const;
+
+        /// Enable or disable the profiling of the blocks of code at runtime
+        void setIsEnabled(bool isEnabled);
 
-        /// Method called at the end of the scope where the
-        /// startProfilingBlock() method has been called.
-        void stopProfilingBlock();
+        /// Return the event buffer of the calling thread
+        ProfileEventBuffer* getThreadEventBuffer();
+
+        /// Return the current timestamp used for the profile events
+        static uint64 getTimestamp();
 
         /// Reset the timing data of the profiler (but not the profiler tree structure)
         void reset();
@@ -360,6 +513,12 @@ class Profiler {
         /// Print the report of the profiler in every output destinations
         void printReport();
 
+        /// Export the recent events of all the threads as a Chrome trace (JSON)
+        void exportChromeTrace(std::ostream& outputStream);
+
+        /// Export the recent events of all the threads as a Chrome trace (JSON) into a file
+        void exportChromeTrace(const std::string& filePath);
+
         // ---------- Friendship ---------- //
         friend class PhysicsCommon;
 };
@@ -374,26 +533,38 @@ class ProfileSample {
 
 	private:
 
-		Profiler* mProfiler;
+        /// Name of the profiled block of code
+        const char* mName;
+
+        /// Event buffer of the current thread (null if the profiling is disabled)
+        ProfileEventBuffer* mEventBuffer;
+
+        /// Timestamp at the beginning of the block of code
+        uint64 mStartTime;
 
     public :
 
         // -------------------- Methods -------------------- //
 
         /// Constructor
-        ProfileSample(const char* name, Profiler* profiler) :mProfiler(profiler) {
+        ProfileSample(const char* name, Profiler* profiler) : mName(name), mEventBuffer(nullptr), mStartTime(0) {
 
 			assert(profiler != nullptr);
 
-            // Ask the profiler to start profiling a block of code
-			mProfiler->startProfilingBlock(name);
+            if (profiler->isEnabled()) {
+                mEventBuffer = profiler->getThreadEventBuffer();
+                mEventBuffer->beginEvent();
+                mStartTime = Profiler::getTimestamp();
+            }
         }
 
         /// Destructor
         ~ProfileSample() {
 
-            // Tell the profiler to stop profiling a block of code
-			mProfiler->stopProfilingBlock();
+            // Record the event of the block of code
+            if (mEventBuffer != nullptr) {
+                mEventBuffer->endEvent(mName, mStartTime, Profiler::getTimestamp());
+            }
         }
 };
 
@@ -401,6 +572,38 @@ class ProfileSample {
 // Use this macro to start profile a block of code
 #define RP3D_PROFILE(name, profiler) ProfileSample profileSample(name, profiler)
 
+// Called when the thread enters a profiled block of code
+RP3D_FORCE_INLINE void ProfileEventBuffer::beginEvent() {
+    mDepth++;
+}
+
+// Called when the thread exits a profiled block of code
+RP3D_FORCE_INLINE void ProfileEventBuffer::endEvent(const char* name, uint64 startTime, uint64 endTime) {
+
+    mDepth--;
+
+    // Only this thread writes into the buffer
+    const uint64 index = mNbRecordedEvents.load(std::memory_order_relaxed);
+    ProfileEvent& event = mEvents[index & (mCapacity - 1)];
+    event.name = name;
+    event.startTime = startTime;
+    event.endTime = endTime;
+    event.depth = mDepth;
+
+    // Publish the event for the threads that read the buffer
+    mNbRecordedEvents.store(index + 1, std::memory_order_release);
+}
+
+// Return the index of the oldest event that is still in the buffer
+RP3D_FORCE_INLINE uint64 ProfileEventBuffer::getOldestEventIndex(uint64 nbRecordedEvents) const {
+    return nbRecordedEvents > mCapacity ? nbRecordedEvents - mCapacity : 0;
+}
+
+// Return an event given its index
+RP3D_FORCE_INLINE const ProfileEvent& ProfileEventBuffer::getEvent(uint64 index) const {
+    return mEvents[index & (mCapacity - 1)];
+}
+
 // Return true if we are at the root of the profiler tree
 RP3D_FORCE_INLINE bool ProfileNodeIterator::isRoot() {
     return (mCurrentParentNode->getParentNode() == nullptr);
@@ -491,14 +694,28 @@ RP3D_FORCE_INLINE std::chrono::duration<double, std::milli> Profiler::getElapsed
     return (clock::now() - mProfilingStartTime);
 }
 
-// Increment the frame counter
-RP3D_FORCE_INLINE void Profiler::incrementFrameCounter() {
-    mFrameCounter++;
+// Return true if the blocks of code are profiled
+RP3D_FORCE_INLINE bool Profiler::isEnabled() const {
+    return mIsEnabled.load(std::memory_order_relaxed);
 }
 
-// Return an iterator over the profiler tree starting at the root
-RP3D_FORCE_INLINE ProfileNodeIterator* Profiler::getIterator() {
-    return new ProfileNodeIterator(&mRootNode);
+// Enable or disable the profiling of the blocks of code at runtime
+/**
+ * @param isEnabled True if the blocks of code must be profiled
+ */
+RP3D_FORCE_INLINE void Profiler::setIsEnabled(bool isEnabled) {
+    mIsEnabled.store(isEnabled, std::memory_order_relaxed);
+}
+
+// Return the current timestamp used for the profile events
+RP3D_FORCE_INLINE uint64 Profiler::getTimestamp() {
+
+#ifdef RP3D_PROFILER_USE_TSC
+    return __rdtsc();
+#else
+    return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
 }
 
 // Destroy a previously allocated iterator
@@ -0,0 +1,129 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef REACTPHYSICS3D_TASK_SCHEDULER_H
+#define REACTPHYSICS3D_TASK_SCHEDULER_H
+
+// Libraries
+#include <reactphysics3d/configuration.h>
+
+/// ReactPhysics3D namespace
+namespace reactphysics3d {
+
+// Class TaskScheduler
+/**
+ * This abstract class is the interface used by the physics world to dispatch
+ * independent work (islands, bodies, ...) to several threads. You can implement
+ * this interface to plug the library into your own job system or use the
+ * DefaultTaskScheduler that comes with the library. When no task scheduler is
+ * set on a world, everything is executed on the thread that calls PhysicsWorld::update().
+ */
+class TaskScheduler {
+
+    public:
+
+        // Class Task
+        /**
+         * A task processes a contiguous range of items. The same task object can be
+         * executed concurrently by several workers on disjoint ranges.
+         */
+        class Task {
+
+            public:
+
+                /// Destructor
+                virtual ~Task() = default;
+
+                /// Process the items in the range [startIndex, endIndex). The worker index is
+                /// in the range [0, getNbWorkers()) and can be used to access per-thread data.
+                virtual void execute(uint32 startIndex, uint32 endIndex, uint32 workerIndex)=0;
+        };
+
+        // -------------------- Methods -------------------- //
+
+        /// Constructor
+        TaskScheduler() = default;
+
+        /// Destructor
+        virtual ~TaskScheduler() = default;
+
+        /// Return the maximum number of workers (including the calling thread) that can execute tasks concurrently
+        virtual uint32 getNbWorkers() const=0;
+
+        /// Split the range [0, nbItems) into ranges of at least minNbItemsPerTask items, execute
+        /// the task on each range and only return when all the ranges have been processed. A call
+        /// from inside a task (nested call) must execute the task with the worker index of the
+        /// calling thread so that two threads never use the per-thread data of the same worker.
+        virtual void parallelFor(uint32 nbItems, uint32 minNbItemsPerTask, Task& task)=0;
+};
+
+// Class FunctionTask
+/**
+ * Task that forwards the execution to a function object with the
+ * signature void(uint32 startIndex, uint32 endIndex, uint32 workerIndex).
+ */
+template<typename Function>
+class FunctionTask : public TaskScheduler::Task {
+
+    private:
+
+        /// Function to execute
+        const Function& mFunction;
+
+    public:
+
+        /// Constructor
+        FunctionTask(const Function& function) : mFunction(function) {
+
+        }
+
+        /// Process the items in the range [startIndex, endIndex)
+        virtual void execute(uint32 startIndex, uint32 endIndex, uint32 workerIndex) override {
+            mFunction(startIndex, endIndex, workerIndex);
+        }
+};
+
+// Execute a function on the range [0, nbItems) using a task scheduler. If the task scheduler
+// is null, the function is directly called on the calling thread. Otherwise, the call is always
+// forwarded to the task scheduler because only the scheduler knows the worker index of the calling
+// thread (for a nested call with a few items for instance).
+template<typename Function>
+RP3D_FORCE_INLINE void parallelFor(TaskScheduler* taskScheduler, uint32 nbItems, uint32 minNbItemsPerTask,
+                                   const Function& function) {
+
+    if (nbItems == 0) return;
+
+    if (taskScheduler == nullptr) {
+        function(0, nbItems, 0);
+        return;
+    }
+
+    FunctionTask<Function> task(function);
+    taskScheduler->parallelFor(nbItems, minNbItemsPerTask, task);
+}
+
+}
+
+#endif
@@ -66,10 +66,30 @@ BodyType RigidBody::getType() const {
  */
 void RigidBody::setType(BodyType type) {
 
-    if (mWorld.mRigidBodyComponents.getBodyType(mEntity) == type) return;
+    const BodyType oldType = mWorld.mRigidBodyComponents.getBodyType(mEntity);
+    if (oldType == type) return;
 
     mWorld.mRigidBodyComponents.setBodyType(mEntity, type);
 
+    // If the body becomes static or stops being static
+    if (oldType == BodyType::STATIC || type == BodyType::STATIC) {
+
+        // The colliders of the static bodies are in a separate broad-phase tree
+        const Array<Entity>& colliderEntities = mWorld.mCollisionBodyComponents.getColliders(mEntity);
+        for (uint32 i=0; i < colliderEntities.size(); i++) {
+
+            Collider* collider = mWorld.mCollidersComponents.getCollider(colliderEntities[i]);
+
+            if (collider->getBroadPhaseId() != -1) {
+
+                // Move the collider into the other broad-phase tree
+                const AABB aabb = collider->getWorldAABB();
+                mWorld.mCollisionDetection.removeCollider(collider);
+                mWorld.mCollisionDetection.addCollider(collider, aabb);
+            }
+        }
+    }
+
     // If it is a static body
     if (type == BodyType::STATIC) {
 
@@ -104,6 +124,10 @@ void RigidBody::setType(BodyType type) {
         mWorld.mRigidBodyComponents.setInverseInertiaTensorLocal(mEntity, inverseInertiaTensorLocal);
     }
 
+    // The body leaves its island and is added into the islands again (if it is not static)
+    mWorld.removeBodyFromIsland(mEntity);
+    mWorld.addBodyToIslands(mEntity);
+
     // Awake the body
     setIsSleeping(false);
 
@@ -650,6 +674,34 @@ void RigidBody::setMass(decimal mass) {
  */
 Collider* RigidBody::addCollider(CollisionShape* collisionShape, const Transform& transform) {
 
+    // Create the collider and compute the world-space AABB of its collision shape
+    AABB aabb;
+    Collider* collider = createCollider(collisionShape, transform, aabb);
+
+    // Notify the collision detection about this new collision shape
+    mWorld.mCollisionDetection.addCollider(collider, aabb);
+
+    RP3D_LOG(mWorld.mConfig.worldName, Logger::Level::Information, Logger::Category::Body,
+             "Body " + std::to_string(mEntity.id) + ": Collider " + std::to_string(collider->getBroadPhaseId()) + " added to body",  __FILE__, __LINE__);
+
+    RP3D_LOG(mWorld.mConfig.worldName, Logger::Level::Information, Logger::Category::Collider,
+             "Collider " + std::to_string(collider->getBroadPhaseId()) + ":  collisionShape=" +
+             collider->getCollisionShape()->to_string(),  __FILE__, __LINE__);
+
+    // Return a pointer to the collider
+    return collider;
+}
+
+// Create a new collider without adding it to the broad-phase and compute its world-space AABB
+/**
+ * @param collisionShape The collision shape of the new collider
+ * @param transform The transformation of the collider that transforms the local-space
+ *                  of the collider into the local-space of the body
+ * @param outWorldAABB The world-space AABB of the collision shape of the collider
+ * @return A pointer to the collider that has been created
+ */
+Collider* RigidBody::createCollider(CollisionShape* collisionShape, const Transform& transform, AABB& outWorldAABB) {
+
     // Create a new entity for the collider
     Entity colliderEntity = mWorld.mEntityManager.createEntity();
 
@@ -690,20 +742,8 @@ Collider* RigidBody::addCollider(CollisionShape* collisionShape, const Transform
 #endif
 
     // Compute the world-space AABB of the new collision shape
-    AABB aabb;
-    collisionShape->computeAABB(aabb, mWorld.mTransformComponents.getTransform(mEntity) * transform);
-
-    // Notify the collision detection about this new collision shape
-    mWorld.mCollisionDetection.addCollider(collider, aabb);
-
-    RP3D_LOG(mWorld.mConfig.worldName, Logger::Level::Information, Logger::Category::Body,
-             "Body " + std::to_string(mEntity.id) + ": Collider " + std::to_string(collider->getBroadPhaseId()) + " added to body",  __FILE__, __LINE__);
-
-    RP3D_LOG(mWorld.mConfig.worldName, Logger::Level::Information, Logger::Category::Collider,
-             "Collider " + std::to_string(collider->getBroadPhaseId()) + ":  collisionShape=" +
-             collider->getCollisionShape()->to_string(),  __FILE__, __LINE__);
+    collisionShape->computeAABB(outWorldAABB, localToWorldTransform);
 
-    // Return a pointer to the collider
     return collider;
 }
 
@@ -716,6 +756,10 @@ void RigidBody::removeCollider(Collider* collider) {
 
     // Remove the collision shape
     CollisionBody::removeCollider(collider);
+
+    // The contacts of the collider are removed without being reported as lost
+    // contacts. Therefore, the island of the body might have to be split.
+    mWorld.mIslandGraph.markSplitNeeded(mWorld.mRigidBodyComponents.getIslandId(mEntity));
 }
 
 // Set the variable to know if the gravity is applied to this rigid body
@@ -248,7 +248,11 @@ bool Collider::getIsTrigger() const {
  * @param isTrigger True if you want to set this collider as a trigger and false otherwise
  */
 void Collider::setIsTrigger(bool isTrigger) const {
+
    mBody->mWorld.mCollidersComponents.setIsTrigger(mEntity, isTrigger);
+
+   // The contacts of the collider start or stop being constraints of the islands
+   mBody->mWorld.updateIslandsOfCollider(mEntity);
 }
 
 // Return a reference to the material properties of the collider
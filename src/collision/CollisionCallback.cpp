@@ -79,7 +79,7 @@ CollisionCallback::ContactPair::EventType CollisionCallback::ContactPair::getEve
 CollisionCallback::CallbackData::CallbackData(Array<reactphysics3d::ContactPair>* contactPairs, Array<ContactManifold>* manifolds,
                                               Array<reactphysics3d::ContactPoint>* contactPoints, Array<reactphysics3d::ContactPair>& lostContactPairs, PhysicsWorld& world)
                       :mContactPairs(contactPairs), mContactManifolds(manifolds), mContactPoints(contactPoints), mLostContactPairs(lostContactPairs),
-                       mContactPairsIndices(world.mMemoryManager.getHeapAllocator(), contactPairs->size()), mLostContactPairsIndices(world.mMemoryManager.getHeapAllocator(), lostContactPairs.size()),
+                       mContactPairsIndices(world.mMemoryManager.getSingleFrameAllocator(), contactPairs->size()), mLostContactPairsIndices(world.mMemoryManager.getSingleFrameAllocator(), lostContactPairs.size()),
                        mWorld(world) {
 
     // Filter the contact pairs to only keep the contact events (not the overlap/trigger events)
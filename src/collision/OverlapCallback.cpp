@@ -69,7 +69,7 @@ OverlapCallback::OverlapPair::EventType OverlapCallback::OverlapPair::getEventTy
 // CollisionCallbackData Constructor
 OverlapCallback::CallbackData::CallbackData(Array<ContactPair>& contactPairs, Array<ContactPair>& lostContactPairs, bool onlyReportTriggers, PhysicsWorld& world)
                 :mContactPairs(contactPairs), mLostContactPairs(lostContactPairs),
-                 mContactPairsIndices(world.mMemoryManager.getHeapAllocator()), mLostContactPairsIndices(world.mMemoryManager.getHeapAllocator()), mWorld(world) {
+                 mContactPairsIndices(world.mMemoryManager.getSingleFrameAllocator()), mLostContactPairsIndices(world.mMemoryManager.getSingleFrameAllocator()), mWorld(world) {
 
     // Filter the contact pairs to only keep the overlap/trigger events (not the contact events)
     const uint64 nbContactPairs = mContactPairs.size();
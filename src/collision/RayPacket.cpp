@@ -0,0 +1,152 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/mathematics/Simd.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Add a ray into the packet
+/// The first ray is copied into all the lanes so that the unused lanes of an incomplete
+/// packet contain a valid ray. These lanes are never part of the active rays.
+void RayPacket::addRay(const Ray& ray, uint32 rayIndex) {
+
+    assert(nbRays < NB_MAX_RAYS);
+
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+    const Vector3 rayDirectionInverse(decimal(1.0) / rayDirection.x, decimal(1.0) / rayDirection.y, decimal(1.0) / rayDirection.z);
+
+    const uint32 endLane = nbRays == 0 ? NB_MAX_RAYS : nbRays + 1;
+    for (uint32 i=nbRays; i < endLane; i++) {
+
+        originX[i] = ray.point1.x;
+        originY[i] = ray.point1.y;
+        originZ[i] = ray.point1.z;
+        directionInverseX[i] = rayDirectionInverse.x;
+        directionInverseY[i] = rayDirectionInverse.y;
+        directionInverseZ[i] = rayDirectionInverse.z;
+        maxFractions[i] = ray.maxFraction;
+        rays[i] = &ray;
+        rayIndices[i] = rayIndex;
+    }
+
+    activeRaysMask |= 1u << nbRays;
+    nbRays++;
+}
+
+// Return the mask of the rays (among a given mask) that hit an AABB
+/// The enter fraction of each ray into the AABB is written in the output array. It is only
+/// valid for the rays that hit the AABB.
+uint32 RayPacket::testAABB(const Vector3& aabbMin, const Vector3& aabbMax, uint32 raysMask, decimal* outEnterFractions) const {
+
+#ifdef RP3D_USE_SIMD
+
+    static_assert(NB_MAX_RAYS == SIMD_WIDTH, "A packet must have one ray per SIMD lane");
+
+    const SimdFloat4 rayOriginX = simdLoad(originX);
+    const SimdFloat4 rayOriginY = simdLoad(originY);
+    const SimdFloat4 rayOriginZ = simdLoad(originZ);
+    const SimdFloat4 rayDirectionInverseX = simdLoad(directionInverseX);
+    const SimdFloat4 rayDirectionInverseY = simdLoad(directionInverseY);
+    const SimdFloat4 rayDirectionInverseZ = simdLoad(directionInverseZ);
+
+    // Slab test on the x, y and z axis (same as AABB::testRayIntersect() for each ray)
+    SimdFloat4 t1 = (simdSet(aabbMin.x) - rayOriginX) * rayDirectionInverseX;
+    SimdFloat4 t2 = (simdSet(aabbMax.x) - rayOriginX) * rayDirectionInverseX;
+    SimdFloat4 tMin = simdMin(t1, t2);
+    SimdFloat4 tMax = simdMin(simdMax(t1, t2), simdLoad(maxFractions));
+
+    t1 = (simdSet(aabbMin.y) - rayOriginY) * rayDirectionInverseY;
+    t2 = (simdSet(aabbMax.y) - rayOriginY) * rayDirectionInverseY;
+    tMin = simdMax(tMin, simdMin(t1, t2));
+    tMax = simdMin(tMax, simdMax(t1, t2));
+
+    t1 = (simdSet(aabbMin.z) - rayOriginZ) * rayDirectionInverseZ;
+    t2 = (simdSet(aabbMax.z) - rayOriginZ) * rayDirectionInverseZ;
+    tMin = simdMax(tMin, simdMin(t1, t2));
+    tMax = simdMin(tMax, simdMax(t1, t2));
+
+    const SimdFloat4 tEnter = simdMax(tMin, simdSet(decimal(0.0)));
+    simdStore(outEnterFractions, tEnter);
+
+    const uint32 hitMask = simdMoveMask(tMax >= tEnter) & raysMask;
+
+#ifdef IS_RP3D_SIMD_VALIDATION_ENABLED
+
+    // The SIMD test must give exactly the same result as the scalar test
+    decimal enterFractions[NB_MAX_RAYS];
+    assert(hitMask == testAABBScalar(aabbMin, aabbMax, raysMask, enterFractions));
+    for (uint32 i=0; i < NB_MAX_RAYS; i++) {
+        assert((hitMask & (1u << i)) == 0 || enterFractions[i] == outEnterFractions[i]);
+    }
+
+#endif
+
+    return hitMask;
+
+#else
+
+    return testAABBScalar(aabbMin, aabbMax, raysMask, outEnterFractions);
+
+#endif
+
+}
+
+// Return the mask of the rays (among a given mask) that hit an AABB (scalar version)
+uint32 RayPacket::testAABBScalar(const Vector3& aabbMin, const Vector3& aabbMax, uint32 raysMask, decimal* outEnterFractions) const {
+
+    uint32 hitMask = 0;
+    for (uint32 i=0; i < NB_MAX_RAYS; i++) {
+
+        if ((raysMask & (1u << i)) == 0) continue;
+
+        const Vector3 rayOrigin(originX[i], originY[i], originZ[i]);
+        const Vector3 rayDirectionInverse(directionInverseX[i], directionInverseY[i], directionInverseZ[i]);
+
+        // Same slab test as AABB::testRayIntersect()
+        decimal t1 = (aabbMin[0] - rayOrigin[0]) * rayDirectionInverse[0];
+        decimal t2 = (aabbMax[0] - rayOrigin[0]) * rayDirectionInverse[0];
+        decimal tMin = std::min(t1, t2);
+        decimal tMax = std::min(std::max(t1, t2), maxFractions[i]);
+
+        for (int j=1; j < 3; j++) {
+
+            t1 = (aabbMin[j] - rayOrigin[j]) * rayDirectionInverse[j];
+            t2 = (aabbMax[j] - rayOrigin[j]) * rayDirectionInverse[j];
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+
+        outEnterFractions[i] = std::max(tMin, decimal(0.0));
+
+        if (tMax >= outEnterFractions[i]) {
+            hitMask |= 1u << i;
+        }
+    }
+
+    return hitMask;
+}
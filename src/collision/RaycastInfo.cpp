@@ -27,6 +27,7 @@
 #include <reactphysics3d/decimal.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/collision/Collider.h>
+#include <reactphysics3d/collision/RayPacket.h>
 
 using namespace reactphysics3d;
 
@@ -47,3 +48,41 @@ decimal RaycastTest::raycastAgainstShape(Collider* shape, const Ray& ray) {
 
     return ray.maxFraction;
 }
+
+// Ray cast test of some rays of a packet against a collider
+/// The result of each ray that hits the collider is written in the array of hits. With the
+/// closest hit mode, the ray is clipped at the hit fraction so that only the closer colliders
+/// are tested afterwards. With the any hit mode, the ray is terminated at its first hit.
+void RaycastBatchTest::raycastAgainstShape(Collider* shape, RayPacket& packet, uint32 raysMask) {
+
+    for (uint32 i=0; raysMask != 0; i++, raysMask >>= 1) {
+
+        if ((raysMask & 1) == 0) continue;
+
+        // Ray casting test against the collision shape with the current maximum fraction of the ray
+        const Ray& batchRay = *packet.rays[i];
+        const Ray ray(batchRay.point1, batchRay.point2, packet.maxFractions[i]);
+        RaycastInfo raycastInfo;
+        if (!shape->raycast(ray, raycastInfo)) continue;
+
+        RaycastHit& hit = hits[packet.rayIndices[i]];
+
+        // Keep the previous hit if it is at the same distance
+        if (hit.isHit() && raycastInfo.hitFraction >= hit.hitFraction) continue;
+
+        hit.worldPoint = raycastInfo.worldPoint;
+        hit.worldNormal = raycastInfo.worldNormal;
+        hit.hitFraction = raycastInfo.hitFraction;
+        hit.meshSubpart = raycastInfo.meshSubpart;
+        hit.triangleIndex = raycastInfo.triangleIndex;
+        hit.body = raycastInfo.body;
+        hit.collider = raycastInfo.collider;
+
+        if (mode == RaycastBatchMode::ANY_HIT) {
+            packet.terminateRay(i);
+        }
+        else {
+            packet.maxFractions[i] = raycastInfo.hitFraction;
+        }
+    }
+}
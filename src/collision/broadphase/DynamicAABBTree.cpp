@@ -26,17 +26,22 @@
 // Libraries
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
 #include <reactphysics3d/systems/BroadPhaseSystem.h>
+#include <reactphysics3d/collision/RayPacket.h>
 #include <reactphysics3d/containers/Stack.h>
 #include <reactphysics3d/utils/Profiler.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
+#include <algorithm>
 
 using namespace reactphysics3d;
 
 // Initialization of static variables
 const int32 TreeNode::NULL_TREE_NODE = -1;
+const int32 DynamicAABBTree::NB_SAH_BINS = 16;
 
 // Constructor
 DynamicAABBTree::DynamicAABBTree(MemoryAllocator& allocator, decimal fatAABBInflatePercentage)
-                : mAllocator(allocator), mFatAABBInflatePercentage(fatAABBInflatePercentage) {
+                : mAllocator(allocator), mFatAABBInflatePercentage(fatAABBInflatePercentage),
+                  mFatAABBMinMargin(decimal(0.0)), mFatAABBMaxMargin(DECIMAL_LARGEST), mFatAABBDisplacementFactor(decimal(0.0)) {
 
     init();
 }
@@ -98,26 +103,7 @@ int32 DynamicAABBTree::allocateNode() {
         assert(mNbNodes == mNbAllocatedNodes);
 
         // Allocate more nodes in the tree
-        int32 oldNbAllocatedNodes = mNbAllocatedNodes;
-        mNbAllocatedNodes *= 2;
-        TreeNode* oldNodes = mNodes;
-        mNodes = static_cast<TreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode)));
-        assert(mNodes);
-
-        // Copy the elements to the new allocated memory location
-        std::uninitialized_copy(oldNodes, oldNodes + mNbNodes, mNodes);
-
-        mAllocator.release(oldNodes, static_cast<size_t>(oldNbAllocatedNodes) * sizeof(TreeNode));
-
-        // Initialize the allocated nodes
-        for (int32 i=mNbNodes; i<mNbAllocatedNodes - 1; i++) {
-            new (mNodes + i) TreeNode();
-            mNodes[i].nextNodeID = i + 1;
-            mNodes[i].height = -1;
-        }
-        mNodes[mNbAllocatedNodes - 1].nextNodeID = TreeNode::NULL_TREE_NODE;
-        mNodes[mNbAllocatedNodes - 1].height = -1;
-        mFreeNodeID = mNbNodes;
+        reserveNodes(mNbAllocatedNodes * 2);
     }
 
     // Get the next free node
@@ -130,6 +116,35 @@ int32 DynamicAABBTree::allocateNode() {
     return freeNodeID;
 }
 
+// Allocate memory for at least a given number of nodes
+/// The new nodes are added at the beginning of the free nodes
+void DynamicAABBTree::reserveNodes(int32 nbNodes) {
+
+    if (nbNodes <= mNbAllocatedNodes) return;
+
+    int32 oldNbAllocatedNodes = mNbAllocatedNodes;
+    mNbAllocatedNodes = nbNodes;
+    TreeNode* oldNodes = mNodes;
+    mNodes = static_cast<TreeNode*>(mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode)));
+    assert(mNodes);
+
+    // Copy the elements to the new allocated memory location
+    std::uninitialized_copy(oldNodes, oldNodes + oldNbAllocatedNodes, mNodes);
+
+    mAllocator.release(oldNodes, static_cast<size_t>(oldNbAllocatedNodes) * sizeof(TreeNode));
+
+    // Initialize the allocated nodes
+    for (int32 i=oldNbAllocatedNodes; i<mNbAllocatedNodes - 1; i++) {
+        new (mNodes + i) TreeNode();
+        mNodes[i].nextNodeID = i + 1;
+        mNodes[i].height = -1;
+    }
+    new (mNodes + mNbAllocatedNodes - 1) TreeNode();
+    mNodes[mNbAllocatedNodes - 1].nextNodeID = mFreeNodeID;
+    mNodes[mNbAllocatedNodes - 1].height = -1;
+    mFreeNodeID = oldNbAllocatedNodes;
+}
+
 // Release a node
 void DynamicAABBTree::releaseNode(int nodeID) {
 
@@ -142,20 +157,59 @@ void DynamicAABBTree::releaseNode(int nodeID) {
     mNbNodes--;
 }
 
-// Internally add an object into the tree
-int32 DynamicAABBTree::addObjectInternal(const AABB& aabb) {
+// Allocate a new leaf node with the fat AABB of an object
+int32 DynamicAABBTree::createLeafNode(const AABB& aabb) {
 
     // Get the next available node (or allocate new ones if necessary)
     int32 nodeID = allocateNode();
 
-    // Create the fat aabb to use in the tree (inflate the aabb by a constant percentage of its size)
-    const Vector3 gap(aabb.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
-    mNodes[nodeID].aabb.setMin(aabb.getMin() - gap);
-    mNodes[nodeID].aabb.setMax(aabb.getMax() + gap);
+    // Create the fat aabb to use in the tree
+    mNodes[nodeID].aabb = computeFatAABB(aabb, Vector3::zero());
 
     // Set the height of the node in the tree
     mNodes[nodeID].height = 0;
 
+    return nodeID;
+}
+
+// Compute the fat AABB of an object
+/// The AABB is inflated by a constant percentage of its size clamped between the minimum and
+/// maximum margins. It is then extruded along the displacement of the object multiplied by the
+/// displacement factor so that a fast object stays inside its fat AABB during a few frames. The
+/// extrusion is also clamped to the maximum margin.
+AABB DynamicAABBTree::computeFatAABB(const AABB& aabb, const Vector3& displacement) const {
+
+    const Vector3 minMargin(mFatAABBMinMargin, mFatAABBMinMargin, mFatAABBMinMargin);
+    const Vector3 maxMargin(mFatAABBMaxMargin, mFatAABBMaxMargin, mFatAABBMaxMargin);
+    const Vector3 gap = Vector3::max(minMargin, Vector3::min(aabb.getExtent() * mFatAABBInflatePercentage * decimal(0.5f), maxMargin));
+    const Vector3 extrusion = Vector3::max(-maxMargin, Vector3::min(displacement * mFatAABBDisplacementFactor, maxMargin));
+
+    return AABB(aabb.getMin() - gap + Vector3::min(extrusion, Vector3::zero()),
+                aabb.getMax() + gap + Vector3::max(extrusion, Vector3::zero()));
+}
+
+// Set the margins of the fat AABBs and the factor of their extrusion along the displacement of the objects
+/// The new margins are only used for the objects added or reinserted into the tree after this call.
+/**
+ * @param minMargin Minimum margin between an AABB and its fat AABB
+ * @param maxMargin Maximum margin between an AABB and its fat AABB in each direction
+ * @param displacementFactor Factor of the displacement of an object used to extrude its fat AABB (zero for no extrusion)
+ */
+void DynamicAABBTree::setFatAABBMargins(decimal minMargin, decimal maxMargin, decimal displacementFactor) {
+
+    assert(minMargin >= decimal(0.0) && minMargin <= maxMargin);
+    assert(displacementFactor >= decimal(0.0));
+
+    mFatAABBMinMargin = minMargin;
+    mFatAABBMaxMargin = maxMargin;
+    mFatAABBDisplacementFactor = displacementFactor;
+}
+
+// Internally add an object into the tree
+int32 DynamicAABBTree::addObjectInternal(const AABB& aabb) {
+
+    int32 nodeID = createLeafNode(aabb);
+
     // Insert the new leaf node in the tree
     insertLeafNode(nodeID);
     assert(mNodes[nodeID].isLeaf());
@@ -166,6 +220,231 @@ int32 DynamicAABBTree::addObjectInternal(const AABB& aabb) {
     return nodeID;
 }
 
+// Add several objects into the tree at once
+/// The memory for all the new nodes is allocated only once. If there are less new objects than
+/// objects already in the tree, the new leaf nodes are inserted one by one. Otherwise, the internal
+/// nodes of the tree are released and the whole tree is built again with the surface area heuristic,
+/// which is faster than inserting many leaf nodes one after the other and gives a better tree. The ids
+/// of the leaf nodes of the objects already in the tree do not change. The data of the new leaf nodes
+/// must be set with the setNodeDataPointer() or setNodeDataInt() methods. Like addObject(), this method
+/// is not profiled because it is used to build the trees of the collision shapes before they have a profiler.
+/**
+ * @param aabbs Array with the AABBs of the objects to add
+ * @param nbObjects Number of objects to add
+ * @param outNodeIDs Array where to write the ids of the leaf nodes of the new objects
+ */
+void DynamicAABBTree::addObjects(const AABB* aabbs, uint32 nbObjects, int32* outNodeIDs) {
+
+    if (nbObjects == 0) return;
+
+    // Number of leaf nodes already in the tree
+    const int32 nbLeafNodes = mRootNodeID == TreeNode::NULL_TREE_NODE ? 0 : (mNbNodes + 1) / 2;
+
+    // Allocate the memory for the new leaf nodes and their parents only once
+    reserveNodes(mNbNodes + 2 * static_cast<int32>(nbObjects));
+
+    // If there are only a few new objects compared to the size of the tree
+    if (static_cast<int32>(nbObjects) < nbLeafNodes) {
+
+        // Insert the new leaf nodes one by one
+        for (uint32 i=0; i < nbObjects; i++) {
+            outNodeIDs[i] = createLeafNode(aabbs[i]);
+            insertLeafNode(outNodeIDs[i]);
+        }
+
+        return;
+    }
+
+    buildTree(aabbs, nbObjects, outNodeIDs);
+}
+
+// Rebuild the whole tree using the surface area heuristic (SAH)
+/// The quality of the tree slowly degrades when the objects are inserted one by one or when
+/// they move. This method builds the tree again from its leaf nodes. The ids and the data of the
+/// leaf nodes do not change.
+void DynamicAABBTree::rebuild() {
+
+    RP3D_PROFILE("DynamicAABBTree::rebuild()", mProfiler);
+
+    // Nothing to do if there are less than three leaf nodes
+    if (mNbNodes < 5) return;
+
+    buildTree(nullptr, 0, nullptr);
+}
+
+// Build the whole tree with the leaf nodes already in the tree and some new objects
+/// The internal nodes of the tree are released and the tree is built top-down with the surface area
+/// heuristic. The memory for the new nodes must have been reserved before.
+void DynamicAABBTree::buildTree(const AABB* aabbs, uint32 nbObjects, int32* outNodeIDs) {
+
+    // Number of leaf nodes already in the tree
+    const int32 nbLeafNodes = mRootNodeID == TreeNode::NULL_TREE_NODE ? 0 : (mNbNodes + 1) / 2;
+
+    Array<BulkLeafNode> leafNodes(mAllocator, static_cast<uint64>(nbLeafNodes) + nbObjects);
+
+    // Keep the leaf nodes already in the tree and release its internal nodes
+    if (nbLeafNodes > 0) {
+        for (int32 i=0; i < mNbAllocatedNodes; i++) {
+            if (mNodes[i].height == 0) {
+                leafNodes.add({mNodes[i].aabb, mNodes[i].aabb.getCenter(), i});
+            }
+            else if (mNodes[i].height > 0) {
+                releaseNode(i);
+            }
+        }
+    }
+    assert(static_cast<int32>(leafNodes.size()) == nbLeafNodes);
+
+    // Create the new leaf nodes
+    for (uint32 i=0; i < nbObjects; i++) {
+        outNodeIDs[i] = createLeafNode(aabbs[i]);
+        const AABB& aabb = mNodes[outNodeIDs[i]].aabb;
+        leafNodes.add({aabb, aabb.getCenter(), outNodeIDs[i]});
+    }
+
+    // Build the tree with all the leaf nodes
+    mRootNodeID = buildSubTree(&(leafNodes[0]), static_cast<int32>(leafNodes.size()));
+    mNodes[mRootNodeID].parentID = TreeNode::NULL_TREE_NODE;
+}
+
+// Build a sub-tree with some leaf nodes using the surface area heuristic (SAH) and return its root node
+/// The centers of the leaf nodes are put into bins along the largest axis of their bounds. The leaf
+/// nodes are split between two consecutive bins where the sum of the surface areas of the two children
+/// weighted by their number of leaf nodes is minimal. The two halves are built recursively. The leaf
+/// nodes are split by their number if all their centers are at the same position.
+int32 DynamicAABBTree::buildSubTree(BulkLeafNode* leafNodes, int32 nbLeafNodes) {
+
+    assert(nbLeafNodes > 0);
+
+    if (nbLeafNodes == 1) {
+        return leafNodes[0].nodeID;
+    }
+
+    int32 nbLeftNodes = nbLeafNodes / 2;
+
+    // Compute the bounds of the centers of the leaf nodes
+    Vector3 minCenter = leafNodes[0].center;
+    Vector3 maxCenter = minCenter;
+    for (int32 i=1; i < nbLeafNodes; i++) {
+        minCenter = Vector3::min(minCenter, leafNodes[i].center);
+        maxCenter = Vector3::max(maxCenter, leafNodes[i].center);
+    }
+    const int axis = (maxCenter - minCenter).getMaxAxis();
+    const decimal minAxis = minCenter[axis];
+    const decimal extentAxis = maxCenter[axis] - minAxis;
+
+    if (nbLeafNodes > 2 && extentAxis > MACHINE_EPSILON) {
+
+        const decimal binFactor = decimal(NB_SAH_BINS) * (decimal(1.0) - MACHINE_EPSILON) / extentAxis;
+        auto computeBinIndex = [&](const BulkLeafNode& leafNode) {
+            return std::min(static_cast<int32>((leafNode.center[axis] - minAxis) * binFactor), NB_SAH_BINS - 1);
+        };
+
+        // Put the leaf nodes into the bins
+        SAHBin bins[NB_SAH_BINS];
+        for (int32 b=0; b < NB_SAH_BINS; b++) {
+            bins[b].nbLeafNodes = 0;
+        }
+        for (int32 i=0; i < nbLeafNodes; i++) {
+            SAHBin& bin = bins[computeBinIndex(leafNodes[i])];
+            if (bin.nbLeafNodes == 0) {
+                bin.aabb = leafNodes[i].aabb;
+            }
+            else {
+                bin.aabb.mergeWithAABB(leafNodes[i].aabb);
+            }
+            bin.nbLeafNodes++;
+        }
+
+        // Compute the cost of the right side of each split (the split b is between the bins b-1 and b)
+        decimal rightCosts[NB_SAH_BINS];
+        AABB rightAABB;
+        int32 nbRightNodes = 0;
+        for (int32 b=NB_SAH_BINS - 1; b > 0; b--) {
+            if (bins[b].nbLeafNodes > 0) {
+                if (nbRightNodes == 0) {
+                    rightAABB = bins[b].aabb;
+                }
+                else {
+                    rightAABB.mergeWithAABB(bins[b].aabb);
+                }
+                nbRightNodes += bins[b].nbLeafNodes;
+            }
+            rightCosts[b] = nbRightNodes > 0 ? decimal(nbRightNodes) * rightAABB.getSurfaceArea() : DECIMAL_LARGEST;
+        }
+
+        // Find the split with the smallest cost
+        decimal bestCost = DECIMAL_LARGEST;
+        int32 bestSplit = -1;
+        AABB leftAABB;
+        int32 nbLeftNodesSplit = 0;
+        for (int32 b=1; b < NB_SAH_BINS; b++) {
+            if (bins[b-1].nbLeafNodes > 0) {
+                if (nbLeftNodesSplit == 0) {
+                    leftAABB = bins[b-1].aabb;
+                }
+                else {
+                    leftAABB.mergeWithAABB(bins[b-1].aabb);
+                }
+                nbLeftNodesSplit += bins[b-1].nbLeafNodes;
+            }
+            if (nbLeftNodesSplit > 0 && nbLeftNodesSplit < nbLeafNodes) {
+                const decimal cost = decimal(nbLeftNodesSplit) * leftAABB.getSurfaceArea() + rightCosts[b];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = b;
+                }
+            }
+        }
+
+        // Move the leaf nodes of the left side at the beginning of the array
+        if (bestSplit > 0) {
+            BulkLeafNode* firstRightNode = std::partition(leafNodes, leafNodes + nbLeafNodes, [&](const BulkLeafNode& leafNode) {
+                return computeBinIndex(leafNode) < bestSplit;
+            });
+            nbLeftNodes = static_cast<int32>(firstRightNode - leafNodes);
+        }
+    }
+
+    assert(nbLeftNodes > 0 && nbLeftNodes < nbLeafNodes);
+
+    const int32 leftChildID = buildSubTree(leafNodes, nbLeftNodes);
+    const int32 rightChildID = buildSubTree(leafNodes + nbLeftNodes, nbLeafNodes - nbLeftNodes);
+
+    // Create the parent node of the two sub-trees
+    const int32 nodeID = allocateNode();
+    mNodes[nodeID].children[0] = leftChildID;
+    mNodes[nodeID].children[1] = rightChildID;
+    mNodes[leftChildID].parentID = nodeID;
+    mNodes[rightChildID].parentID = nodeID;
+    mNodes[nodeID].aabb.mergeTwoAABBs(mNodes[leftChildID].aabb, mNodes[rightChildID].aabb);
+    mNodes[nodeID].height = std::max(mNodes[leftChildID].height, mNodes[rightChildID].height) + 1;
+
+    return nodeID;
+}
+
+// Return the surface area heuristic (SAH) cost of the tree
+/// This is the sum of the surface areas of the internal nodes divided by the surface area of the
+/// root node. It is proportional to the expected number of internal nodes visited by a query with
+/// a random ray or AABB and can be used to measure the quality of the tree. The cost is zero if the
+/// tree has less than two leaf nodes.
+decimal DynamicAABBTree::computeSAHCost() const {
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE || mNodes[mRootNodeID].isLeaf()) return decimal(0.0);
+
+    const decimal rootArea = mNodes[mRootNodeID].aabb.getSurfaceArea();
+    if (rootArea < MACHINE_EPSILON) return decimal(0.0);
+
+    decimal sumAreas = decimal(0.0);
+    for (int32 i=0; i < mNbAllocatedNodes; i++) {
+        if (mNodes[i].height > 0) {
+            sumAreas += mNodes[i].aabb.getSurfaceArea();
+        }
+    }
+
+    return sumAreas / rootArea;
+}
+
 // Remove an object from the tree
 void DynamicAABBTree::removeObject(int32 nodeID) {
 
@@ -184,7 +463,9 @@ void DynamicAABBTree::removeObject(int32 nodeID) {
 /// If the "forceReInsert" parameter is true, we force the existing AABB to take the size
 /// of the "newAABB" parameter even if it is larger than "newAABB". This can be used to shrink the
 /// AABB in the tree for instance if the corresponding collision shape has been shrunk.
-bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert) {
+/// The fat AABB of a reinserted object is extruded along its displacement (see the
+/// setFatAABBMargins() method).
+bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool forceReinsert, const Vector3& displacement) {
 
     RP3D_PROFILE("DynamicAABBTree::updateObject()", mProfiler);
 
@@ -200,11 +481,8 @@ bool DynamicAABBTree::updateObject(int32 nodeID, const AABB& newAABB, bool force
     // If the new AABB is outside the fat AABB, we remove the corresponding node
     removeLeafNode(nodeID);
 
-    // Compute the fat AABB by inflating the AABB with by a constant percentage of the size of the AABB
-    mNodes[nodeID].aabb = newAABB;
-    const Vector3 gap(newAABB.getExtent() * mFatAABBInflatePercentage * decimal(0.5f));
-    mNodes[nodeID].aabb.mMinCoordinates -= gap;
-    mNodes[nodeID].aabb.mMaxCoordinates += gap;
+    // Compute the fat AABB of the object
+    mNodes[nodeID].aabb = computeFatAABB(newAABB, displacement);
 
     assert(mNodes[nodeID].aabb.contains(newAABB));
 
@@ -600,41 +878,49 @@ void DynamicAABBTree::reportAllShapesOverlappingWithShapes(const Array<int32>& n
 
         assert(nodesToTest[i] != -1);
 
-        stack.push(mRootNodeID);
+        reportAllShapesOverlappingWithShape(nodesToTest[i], getFatAABB(nodesToTest[i]), stack, outOverlappingNodes);
+    }
+}
 
-        const AABB& shapeAABB = getFatAABB(nodesToTest[i]);
+// Report all the leaf nodes overlapping with the AABB of a shape
+/// The shape does not need to be in this tree. A pair (shapeID, leaf node ID) is added into
+/// the output array for each overlapping leaf node. The stack is used to visit the nodes and
+/// can be reused for several shapes to avoid allocating memory for each one.
+void DynamicAABBTree::reportAllShapesOverlappingWithShape(int32 shapeID, const AABB& shapeAABB, Stack<int32>& stack,
+                                                          Array<Pair<int32, int32>>& outOverlappingNodes) const {
 
-        // While there are still nodes to visit
-        while(stack.size() > 0) {
+    assert(stack.size() == 0);
 
-            // Get the next node ID to visit
-            const int32 nodeIDToVisit = stack.pop();
+    stack.push(mRootNodeID);
 
-            // Skip it if it is a null node
-            if (nodeIDToVisit == TreeNode::NULL_TREE_NODE) continue;
+    // While there are still nodes to visit
+    while(stack.size() > 0) {
 
-            // Get the corresponding node
-            const TreeNode* nodeToVisit = mNodes + nodeIDToVisit;
+        // Get the next node ID to visit
+        const int32 nodeIDToVisit = stack.pop();
+
+        // Skip it if it is a null node
+        if (nodeIDToVisit == TreeNode::NULL_TREE_NODE) continue;
 
-            // If the AABB in parameter overlaps with the AABB of the node to visit
-            if (shapeAABB.testCollision(nodeToVisit->aabb)) {
+        // Get the corresponding node
+        const TreeNode* nodeToVisit = mNodes + nodeIDToVisit;
 
-                // If the node is a leaf
-                if (nodeToVisit->isLeaf()) {
+        // If the AABB in parameter overlaps with the AABB of the node to visit
+        if (shapeAABB.testCollision(nodeToVisit->aabb)) {
 
-                    // Add the node in the array of overlapping nodes
-                    outOverlappingNodes.add(Pair<int32, int32>(nodesToTest[i], nodeIDToVisit));
-                }
-                else {  // If the node is not a leaf
+            // If the node is a leaf
+            if (nodeToVisit->isLeaf()) {
 
-                    // We need to visit its children
-                    stack.push(nodeToVisit->children[0]);
-                    stack.push(nodeToVisit->children[1]);
-                }
+                // Add the node in the array of overlapping nodes
+                outOverlappingNodes.add(Pair<int32, int32>(shapeID, nodeIDToVisit));
             }
-        }
+            else {  // If the node is not a leaf
 
-        stack.clear();
+                // We need to visit its children
+                stack.push(nodeToVisit->children[0]);
+                stack.push(nodeToVisit->children[1]);
+            }
+        }
     }
 }
 
@@ -682,7 +968,9 @@ void DynamicAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, Array
 }
 
 // Ray casting method
-void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+/// The method returns the maximum fraction of the ray after the raycast (the smallest hit fraction
+/// returned by the callback) or zero if the callback has stopped the raycast.
+decimal DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
 
     RP3D_PROFILE("DynamicAABBTree::raycast()", mProfiler);
 
@@ -722,7 +1010,7 @@ void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& ca
             // If the user returned a hitFraction of zero, it means that
             // the raycasting should stop here
             if (hitFraction == decimal(0.0)) {
-                return;
+                return decimal(0.0);
             }
 
             // If the user returned a positive fraction
@@ -745,6 +1033,159 @@ void DynamicAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& ca
             stack.push(node->children[1]);
         }
     }
+
+    return maxFraction;
+}
+
+// Ray casting method for a packet of rays
+/// The rays of the packet traverse the tree together. Each node is tested against all the
+/// rays that hit its parent at once and the callback is called with the mask of the rays that
+/// hit the AABB of a leaf. The stack of (node, rays mask) entries is given in parameter so
+/// that it can be reused for all the packets of a batch.
+void DynamicAABBTree::raycastPacket(RayPacket& packet, DynamicAABBTreeRaycastPacketCallback& callback,
+                                    Stack<Pair<int32, uint32>>& stack) const {
+
+    RP3D_PROFILE("DynamicAABBTree::raycastPacket()", mProfiler);
+
+    if (mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    stack.clear();
+    stack.push(Pair<int32, uint32>(mRootNodeID, packet.activeRaysMask));
+
+    while (stack.size() > 0) {
+
+        const Pair<int32, uint32> entry = stack.pop();
+
+        // The rays that have been terminated since the node has been pushed are not tested
+        const uint32 raysMask = entry.second & packet.activeRaysMask;
+        if (raysMask == 0) continue;
+
+        const TreeNode* node = mNodes + entry.first;
+
+        // Test all the rays of the packet against the AABB of the node at once
+        decimal enterFractions[RayPacket::NB_MAX_RAYS];
+        const uint32 hitRaysMask = packet.testAABB(node->aabb.getMin(), node->aabb.getMax(), raysMask, enterFractions);
+        if (hitRaysMask == 0) continue;
+
+        // If the node is a leaf of the tree
+        if (node->isLeaf()) {
+
+            // Call the callback that will raycast again the broad-phase shape
+            callback.raycastBroadPhaseShape(entry.first, packet, hitRaysMask);
+        }
+        else {  // If the node has children
+
+            // Push its children in the stack of nodes to explore with the rays that hit the node
+            stack.push(Pair<int32, uint32>(node->children[0], hitRaysMask));
+            stack.push(Pair<int32, uint32>(node->children[1], hitRaysMask));
+        }
+    }
+}
+
+// Save the nodes of the tree into a snapshot
+void DynamicAABBTree::saveSnapshot(SnapshotWriter& writer) const {
+
+    writer.writeValue(mRootNodeID);
+    writer.writeValue(mFreeNodeID);
+    writer.writeValue(mNbAllocatedNodes);
+    writer.writeValue(mNbNodes);
+    writer.writeValues(mNodes, static_cast<uint32>(mNbAllocatedNodes));
+}
+
+// Restore the nodes of the tree from a snapshot
+/// The nodes are copied as they are (the tree is not rebuilt). Therefore, if the data of the
+/// leaves are pointers, they must be set again with the setNodeDataPointer() method.
+void DynamicAABBTree::restoreSnapshot(SnapshotReader& reader) {
+
+    int32 rootNodeID = TreeNode::NULL_TREE_NODE;
+    int32 freeNodeID = TreeNode::NULL_TREE_NODE;
+    int32 nbAllocatedNodes = 0;
+    int32 nbNodes = 0;
+
+    // If the snapshot is not valid, we keep the current tree
+    if (!readSnapshotHeader(reader, rootNodeID, freeNodeID, nbAllocatedNodes, nbNodes)) {
+        return;
+    }
+
+    // If there are not enough allocated nodes, we need to allocate the nodes again
+    if (nbAllocatedNodes > mNbAllocatedNodes) {
+
+        mAllocator.release(mNodes, static_cast<size_t>(mNbAllocatedNodes) * sizeof(TreeNode));
+        mNodes = static_cast<TreeNode*>(mAllocator.allocate(static_cast<size_t>(nbAllocatedNodes) * sizeof(TreeNode)));
+        assert(mNodes);
+        mNbAllocatedNodes = nbAllocatedNodes;
+    }
+
+    mRootNodeID = rootNodeID;
+    mFreeNodeID = freeNodeID;
+    mNbNodes = nbNodes;
+    reader.readValues(mNodes, static_cast<uint32>(nbAllocatedNodes));
+
+    // If we have more allocated nodes than the saved tree, the additional nodes are added at
+    // the end of the free nodes. This way, we do not release memory that will probably be needed
+    // again and the new nodes get the same ids as in the saved tree when it grows.
+    if (mNbAllocatedNodes > nbAllocatedNodes) {
+
+        for (int32 i=nbAllocatedNodes; i < mNbAllocatedNodes - 1; i++) {
+            mNodes[i].nextNodeID = i + 1;
+            mNodes[i].height = -1;
+        }
+        mNodes[mNbAllocatedNodes - 1].nextNodeID = TreeNode::NULL_TREE_NODE;
+        mNodes[mNbAllocatedNodes - 1].height = -1;
+
+        if (mFreeNodeID == TreeNode::NULL_TREE_NODE) {
+            mFreeNodeID = nbAllocatedNodes;
+        }
+        else {
+
+            int32 lastFreeNodeID = mFreeNodeID;
+            while (mNodes[lastFreeNodeID].nextNodeID != TreeNode::NULL_TREE_NODE) {
+                lastFreeNodeID = mNodes[lastFreeNodeID].nextNodeID;
+            }
+            mNodes[lastFreeNodeID].nextNodeID = nbAllocatedNodes;
+        }
+    }
+}
+
+// Skip the nodes of a tree in a snapshot and return true if they can be restored
+/// The tree is not modified
+bool DynamicAABBTree::skipSnapshot(SnapshotReader& reader) const {
+
+    int32 rootNodeID = TreeNode::NULL_TREE_NODE;
+    int32 freeNodeID = TreeNode::NULL_TREE_NODE;
+    int32 nbAllocatedNodes = 0;
+    int32 nbNodes = 0;
+    if (!readSnapshotHeader(reader, rootNodeID, freeNodeID, nbAllocatedNodes, nbNodes)) {
+        return false;
+    }
+
+    reader.skipValues(mNodes, static_cast<uint32>(nbAllocatedNodes));
+
+    return reader.isValid();
+}
+
+// Read the attributes of a tree in a snapshot and return true if its nodes can be read
+/// The number of nodes comes from the snapshot data. Therefore, we check that the nodes
+/// are in the remaining data before the tree allocates memory for them.
+bool DynamicAABBTree::readSnapshotHeader(SnapshotReader& reader, int32& rootNodeID, int32& freeNodeID,
+                                         int32& nbAllocatedNodes, int32& nbNodes) {
+
+    reader.readValue(rootNodeID);
+    reader.readValue(freeNodeID);
+    reader.readValue(nbAllocatedNodes);
+    reader.readValue(nbNodes);
+
+    if (!reader.isValid() || nbAllocatedNodes <= 0 || nbNodes < 0 || nbNodes > nbAllocatedNodes) {
+        return false;
+    }
+
+    if (rootNodeID < TreeNode::NULL_TREE_NODE || rootNodeID >= nbAllocatedNodes ||
+        freeNodeID < TreeNode::NULL_TREE_NODE || freeNodeID >= nbAllocatedNodes) {
+        return false;
+    }
+
+    // Make sure that a corrupted number of nodes cannot allocate more than the remaining data
+    return static_cast<uint64>(nbAllocatedNodes) * sizeof(TreeNode) <= reader.getNbRemainingBytes();
 }
 
 #ifndef NDEBUG
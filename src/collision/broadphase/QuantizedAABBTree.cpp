@@ -0,0 +1,322 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/QuantizedAABBTree.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <cmath>
+#include <cstdint>
+
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const decimal QuantizedAABBTree::MAX_QUANTIZED_VALUE = decimal(65535.0);
+const size_t QuantizedAABBTree::NODES_ALIGNMENT = 64;
+
+// Constructor
+QuantizedAABBTree::QuantizedAABBTree(MemoryAllocator& allocator)
+                  : mAllocator(allocator), mNodesMemory(nullptr), mNodes(nullptr), mNbNodes(0), mNbAllocatedNodes(0),
+                    mRootAABB(Vector3(0, 0, 0), Vector3(0, 0, 0)), mQuantizationScale(0, 0, 0), mDequantizationScale(0, 0, 0),
+                    mDequantizationMinOrigin(0, 0, 0), mDequantizationMaxOrigin(0, 0, 0) {
+
+    static_assert(sizeof(QuantizedTreeNode) == 32, "A quantized tree node must be 32 bytes large");
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Destructor
+QuantizedAABBTree::~QuantizedAABBTree() {
+
+    if (mNodesMemory != nullptr) {
+        mAllocator.release(mNodesMemory, static_cast<size_t>(mNbAllocatedNodes) * sizeof(QuantizedTreeNode) + NODES_ALIGNMENT);
+    }
+}
+
+// Allocate memory for at least a given number of nodes
+/// The memory is only allocated again if the current one is too small. The array of nodes
+/// is aligned on a cache line such that a node never straddles two cache lines.
+void QuantizedAABBTree::reserveNodes(int32 nbNodes) {
+
+    if (nbNodes <= mNbAllocatedNodes) return;
+
+    if (mNodesMemory != nullptr) {
+        mAllocator.release(mNodesMemory, static_cast<size_t>(mNbAllocatedNodes) * sizeof(QuantizedTreeNode) + NODES_ALIGNMENT);
+    }
+
+    mNbAllocatedNodes = nbNodes;
+    mNodesMemory = mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(QuantizedTreeNode) + NODES_ALIGNMENT);
+    assert(mNodesMemory != nullptr);
+
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(mNodesMemory);
+    mNodes = reinterpret_cast<QuantizedTreeNode*>((address + NODES_ALIGNMENT - 1) & ~(NODES_ALIGNMENT - 1));
+}
+
+// Clear all the nodes of the tree
+/// The memory of the nodes is kept to build the tree again
+void QuantizedAABBTree::reset() {
+
+    mNbNodes = 0;
+    mRootAABB = AABB(Vector3(0, 0, 0), Vector3(0, 0, 0));
+    mQuantizationScale.setToZero();
+    mDequantizationScale.setToZero();
+    mDequantizationMinOrigin.setToZero();
+    mDequantizationMaxOrigin.setToZero();
+}
+
+// Build the tree from a dynamic AABB tree
+/// The nodes of the dynamic AABB tree are copied in depth-first order and the data of the
+/// leaf nodes are copied with them. The leaf nodes of this tree are not in the same order
+/// as the ones of the dynamic AABB tree. Their IDs in the dynamic AABB tree are returned by
+/// the getSourceNodeID() method.
+void QuantizedAABBTree::build(const DynamicAABBTree& tree) {
+
+    RP3D_PROFILE("QuantizedAABBTree::build()", mProfiler);
+
+    reset();
+
+    if (tree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    reserveNodes(tree.mNbNodes);
+
+    // The coordinates are quantized relative to the AABB of the root
+    mRootAABB = tree.getRootAABB();
+    const Vector3 extent = mRootAABB.getMax() - mRootAABB.getMin();
+    for (int i=0; i < 3; i++) {
+        mQuantizationScale[i] = extent[i] > decimal(0.0) ? MAX_QUANTIZED_VALUE / extent[i] : decimal(0.0);
+        mDequantizationScale[i] = extent[i] / MAX_QUANTIZED_VALUE;
+
+        // The rounding errors of the dequantization (rootMin + q * scale) are proportional to the largest
+        // world-space coordinate of the root AABB which can be much larger than the extent of the root AABB
+        const decimal largestCoordinate = std::max(std::abs(mRootAABB.getMin()[i]), std::abs(mRootAABB.getMax()[i]));
+        const decimal roundingMargin = decimal(4.0) * std::numeric_limits<decimal>::epsilon() * largestCoordinate;
+        mDequantizationMinOrigin[i] = mRootAABB.getMin()[i] - roundingMargin;
+        mDequantizationMaxOrigin[i] = mRootAABB.getMin()[i] + roundingMargin;
+    }
+
+    mNbNodes = copySubTree(tree, tree.mRootNodeID, 0);
+    assert(mNbNodes == tree.mNbNodes);
+}
+
+// Copy a sub-tree of a dynamic AABB tree in depth-first order and return the next free index
+int32 QuantizedAABBTree::copySubTree(const DynamicAABBTree& tree, int32 sourceNodeID, int32 index) {
+
+    assert(index < mNbAllocatedNodes);
+
+    const TreeNode& sourceNode = tree.mNodes[sourceNodeID];
+
+    QuantizedTreeNode& node = mNodes[index];
+    quantizeAABB(sourceNode.aabb, node.quantizedMin, node.quantizedMax);
+    node.padding = 0;
+
+    int32 nextIndex;
+
+    // If the node is a leaf
+    if (sourceNode.isLeaf()) {
+
+        node.dataInt[0] = sourceNode.dataInt[0];
+        node.dataInt[1] = sourceNode.dataInt[1];
+        node.sourceNodeID = sourceNodeID;
+
+        nextIndex = index + 1;
+    }
+    else {  // If the node is not a leaf
+
+        node.dataPointer = nullptr;
+        node.sourceNodeID = TreeNode::NULL_TREE_NODE;
+
+        // The left child directly follows its parent and the right child follows the sub-tree of the left child
+        nextIndex = copySubTree(tree, sourceNode.children[0], index + 1);
+        nextIndex = copySubTree(tree, sourceNode.children[1], nextIndex);
+    }
+
+    // A leaf is the only node whose escape node is the next one
+    node.escapeIndex = nextIndex;
+
+    return nextIndex;
+}
+
+// Quantize the minimum and maximum coordinates of an AABB (rounded outwards)
+/// The quantized values are enlarged by one more unit to make sure that rounding errors
+/// never make the quantized AABB smaller than the original one. The coordinates outside
+/// of the root AABB are clamped.
+void QuantizedAABBTree::quantizeAABB(const AABB& aabb, uint16* outQuantizedMin, uint16* outQuantizedMax) const {
+
+    for (int i=0; i < 3; i++) {
+
+        const decimal min = std::floor((aabb.getMin()[i] - mRootAABB.getMin()[i]) * mQuantizationScale[i]) - decimal(1.0);
+        const decimal max = std::ceil((aabb.getMax()[i] - mRootAABB.getMin()[i]) * mQuantizationScale[i]) + decimal(1.0);
+
+        outQuantizedMin[i] = static_cast<uint16>(clamp(min, decimal(0.0), MAX_QUANTIZED_VALUE));
+        outQuantizedMax[i] = static_cast<uint16>(clamp(max, decimal(0.0), MAX_QUANTIZED_VALUE));
+    }
+}
+
+// Return the AABB of a node in world-space coordinates
+AABB QuantizedAABBTree::dequantizeAABB(const QuantizedTreeNode& node) const {
+
+    const Vector3& minOrigin = mDequantizationMinOrigin;
+    const Vector3& maxOrigin = mDequantizationMaxOrigin;
+
+    return AABB(Vector3(minOrigin.x + node.quantizedMin[0] * mDequantizationScale.x,
+                        minOrigin.y + node.quantizedMin[1] * mDequantizationScale.y,
+                        minOrigin.z + node.quantizedMin[2] * mDequantizationScale.z),
+                Vector3(maxOrigin.x + node.quantizedMax[0] * mDequantizationScale.x,
+                        maxOrigin.y + node.quantizedMax[1] * mDequantizationScale.y,
+                        maxOrigin.z + node.quantizedMax[2] * mDequantizationScale.z));
+}
+
+// Report all the leaf nodes overlapping with the AABB given in parameter
+/// The AABB is quantized and compared with the quantized AABBs of the nodes. Because the
+/// quantized AABBs are larger than the original ones, a few leaf nodes that do not overlap
+/// with the AABB can also be reported. The nodes are visited in depth-first order without
+/// a stack: the traversal jumps to the escape node of a node that does not overlap.
+void QuantizedAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, Array<int32>& overlappingNodes) const {
+
+    RP3D_PROFILE("QuantizedAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    if (mNbNodes == 0 || !aabb.testCollision(mRootAABB)) return;
+
+    uint16 quantizedMin[3];
+    uint16 quantizedMax[3];
+    quantizeAABB(aabb, quantizedMin, quantizedMax);
+
+    int32 nodeIndex = 0;
+    while (nodeIndex < mNbNodes) {
+
+        const QuantizedTreeNode& node = mNodes[nodeIndex];
+
+        // If the AABB in parameter overlaps with the AABB of the node to visit
+        if (quantizedMin[0] <= node.quantizedMax[0] && quantizedMax[0] >= node.quantizedMin[0] &&
+            quantizedMin[1] <= node.quantizedMax[1] && quantizedMax[1] >= node.quantizedMin[1] &&
+            quantizedMin[2] <= node.quantizedMax[2] && quantizedMax[2] >= node.quantizedMin[2]) {
+
+            // If the node is a leaf
+            if (node.escapeIndex == nodeIndex + 1) {
+                overlappingNodes.add(nodeIndex);
+            }
+
+            // Visit the children of the node (or the next node after a leaf)
+            nodeIndex++;
+        }
+        else {
+
+            // Skip the sub-tree of the node
+            nodeIndex = node.escapeIndex;
+        }
+    }
+}
+
+// Report all the leaf nodes overlapping with the AABB of a shape
+/// A pair (shapeID, leaf node index) is added into the output array for each overlapping leaf node.
+void QuantizedAABBTree::reportAllShapesOverlappingWithShape(int32 shapeID, const AABB& shapeAABB,
+                                                            Array<Pair<int32, int32>>& outOverlappingNodes) const {
+
+    if (mNbNodes == 0 || !shapeAABB.testCollision(mRootAABB)) return;
+
+    uint16 quantizedMin[3];
+    uint16 quantizedMax[3];
+    quantizeAABB(shapeAABB, quantizedMin, quantizedMax);
+
+    int32 nodeIndex = 0;
+    while (nodeIndex < mNbNodes) {
+
+        const QuantizedTreeNode& node = mNodes[nodeIndex];
+
+        // If the AABB of the shape overlaps with the AABB of the node to visit
+        if (quantizedMin[0] <= node.quantizedMax[0] && quantizedMax[0] >= node.quantizedMin[0] &&
+            quantizedMin[1] <= node.quantizedMax[1] && quantizedMax[1] >= node.quantizedMin[1] &&
+            quantizedMin[2] <= node.quantizedMax[2] && quantizedMax[2] >= node.quantizedMin[2]) {
+
+            // If the node is a leaf
+            if (node.escapeIndex == nodeIndex + 1) {
+                outOverlappingNodes.add(Pair<int32, int32>(shapeID, nodeIndex));
+            }
+
+            nodeIndex++;
+        }
+        else {
+            nodeIndex = node.escapeIndex;
+        }
+    }
+}
+
+// Ray casting method
+/// The callback is called with the index of each leaf node whose quantized AABB is hit by
+/// the ray. The method returns the maximum fraction of the ray after the raycast (the smallest
+/// hit fraction returned by the callback) or zero if the callback has stopped the raycast.
+decimal QuantizedAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("QuantizedAABBTree::raycast()", mProfiler);
+
+    decimal maxFraction = ray.maxFraction;
+
+    // Compute the inverse ray direction
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+    const Vector3 rayDirectionInverse(decimal(1.0) / rayDirection.x, decimal(1.0) / rayDirection.y, decimal(1.0) / rayDirection.z);
+
+    int32 nodeIndex = 0;
+    while (nodeIndex < mNbNodes) {
+
+        const QuantizedTreeNode& node = mNodes[nodeIndex];
+
+        // If the ray does not intersect with the node AABB, skip its sub-tree
+        if (!dequantizeAABB(node).testRayIntersect(ray.point1, rayDirectionInverse, maxFraction)) {
+            nodeIndex = node.escapeIndex;
+            continue;
+        }
+
+        // If the node is a leaf of the tree
+        if (node.escapeIndex == nodeIndex + 1) {
+
+            Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+            // Call the callback that will raycast again the shape
+            decimal hitFraction = callback.raycastBroadPhaseShape(nodeIndex, rayTemp);
+
+            // If the user returned a hitFraction of zero, it means that
+            // the raycasting should stop here
+            if (hitFraction == decimal(0.0)) {
+                return decimal(0.0);
+            }
+
+            // If the user returned a positive fraction, we update the maximum fraction of the ray
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+
+            // If the user returned a negative fraction, we continue
+            // the raycasting as if the shape did not exist
+        }
+
+        nodeIndex++;
+    }
+
+    return maxFraction;
+}
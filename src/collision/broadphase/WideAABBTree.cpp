@@ -0,0 +1,667 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/RayPacket.h>
+#include <reactphysics3d/containers/Stack.h>
+#include <reactphysics3d/mathematics/Simd.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <reactphysics3d/utils/Profiler.h>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace reactphysics3d;
+
+// Initialization of static variables
+const decimal WideAABBTree::MAX_QUANTIZED_VALUE = decimal(65535.0);
+const size_t WideAABBTree::NODES_ALIGNMENT = 64;
+
+// Constructor
+WideAABBTree::WideAABBTree(MemoryAllocator& allocator)
+             : mAllocator(allocator), mNodesMemory(nullptr), mNodes(nullptr), mLeaves(nullptr), mNbNodes(0), mNbLeaves(0),
+               mNbAllocatedNodes(0), mNbAllocatedLeaves(0), mRootAABB(Vector3(0, 0, 0), Vector3(0, 0, 0)),
+               mQuantizationScale(0, 0, 0), mDequantizationScale(0, 0, 0),
+               mDequantizationMinOrigin(0, 0, 0), mDequantizationMaxOrigin(0, 0, 0) {
+
+    static_assert(sizeof(WideTreeNode) == 64, "A wide tree node must be 64 bytes large");
+    static_assert(sizeof(WideTreeLeaf) == 16, "A wide tree leaf must be 16 bytes large");
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+    mProfiler = nullptr;
+#endif
+
+}
+
+// Destructor
+WideAABBTree::~WideAABBTree() {
+    releaseNodes();
+}
+
+// Release the memory of the nodes and leaves
+void WideAABBTree::releaseNodes() {
+
+    if (mNodesMemory != nullptr) {
+        mAllocator.release(mNodesMemory, static_cast<size_t>(mNbAllocatedNodes) * sizeof(WideTreeNode) +
+                                         static_cast<size_t>(mNbAllocatedLeaves) * sizeof(WideTreeLeaf) + NODES_ALIGNMENT);
+        mNodesMemory = nullptr;
+    }
+}
+
+// Allocate memory for at least a given number of nodes and leaves
+/// The nodes and the leaves are allocated in a single block that is only allocated again if
+/// the current one is too small. The array of nodes is aligned on a cache line such that a
+/// node never straddles two cache lines. The leaves are stored after the nodes.
+void WideAABBTree::reserveNodes(int32 nbNodes, int32 nbLeaves) {
+
+    if (nbNodes <= mNbAllocatedNodes && nbLeaves <= mNbAllocatedLeaves) return;
+
+    releaseNodes();
+
+    mNbAllocatedNodes = std::max(nbNodes, mNbAllocatedNodes);
+    mNbAllocatedLeaves = std::max(nbLeaves, mNbAllocatedLeaves);
+    mNodesMemory = mAllocator.allocate(static_cast<size_t>(mNbAllocatedNodes) * sizeof(WideTreeNode) +
+                                       static_cast<size_t>(mNbAllocatedLeaves) * sizeof(WideTreeLeaf) + NODES_ALIGNMENT);
+    assert(mNodesMemory != nullptr);
+
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(mNodesMemory);
+    mNodes = reinterpret_cast<WideTreeNode*>((address + NODES_ALIGNMENT - 1) & ~(NODES_ALIGNMENT - 1));
+    mLeaves = reinterpret_cast<WideTreeLeaf*>(mNodes + mNbAllocatedNodes);
+}
+
+// Clear all the nodes of the tree
+/// The memory of the nodes is kept to build the tree again
+void WideAABBTree::reset() {
+
+    mNbNodes = 0;
+    mNbLeaves = 0;
+    mRootAABB = AABB(Vector3(0, 0, 0), Vector3(0, 0, 0));
+    mQuantizationScale.setToZero();
+    mDequantizationScale.setToZero();
+    mDequantizationMinOrigin.setToZero();
+    mDequantizationMaxOrigin.setToZero();
+}
+
+// Build the tree from a dynamic AABB tree
+/// The leaves of this tree are not in the same order as the ones of the dynamic AABB tree.
+/// Their IDs in the dynamic AABB tree are returned by the getSourceNodeID() method. This method
+/// is not profiled because the tree of a concave mesh shape is built before the shape has a profiler.
+void WideAABBTree::build(const DynamicAABBTree& tree) {
+
+    reset();
+
+    if (tree.mRootNodeID == TreeNode::NULL_TREE_NODE) return;
+
+    // A binary tree with n leaves has n - 1 internal nodes and each node of the wide
+    // tree replaces at least one of them
+    const int32 nbSourceLeaves = (tree.mNbNodes + 1) / 2;
+    reserveNodes(std::max(tree.mNbNodes - nbSourceLeaves, 1), nbSourceLeaves);
+
+    // The coordinates are quantized relative to the AABB of the root
+    mRootAABB = tree.getRootAABB();
+    const Vector3 extent = mRootAABB.getMax() - mRootAABB.getMin();
+    for (int i=0; i < 3; i++) {
+        mQuantizationScale[i] = extent[i] > decimal(0.0) ? MAX_QUANTIZED_VALUE / extent[i] : decimal(0.0);
+        mDequantizationScale[i] = extent[i] / MAX_QUANTIZED_VALUE;
+
+        // The rounding errors of the dequantization (rootMin + q * scale) are proportional to the largest
+        // world-space coordinate of the root AABB which can be much larger than the extent of the root AABB
+        const decimal largestCoordinate = std::max(std::abs(mRootAABB.getMin()[i]), std::abs(mRootAABB.getMax()[i]));
+        const decimal roundingMargin = decimal(4.0) * std::numeric_limits<decimal>::epsilon() * largestCoordinate;
+        mDequantizationMinOrigin[i] = mRootAABB.getMin()[i] - roundingMargin;
+        mDequantizationMaxOrigin[i] = mRootAABB.getMin()[i] + roundingMargin;
+    }
+
+    // If the root is a leaf, the tree has a single node with one child
+    if (tree.mNodes[tree.mRootNodeID].isLeaf()) {
+
+        mNbNodes = 1;
+        WideTreeNode& root = mNodes[0];
+        std::memset(&root, 0, sizeof(WideTreeNode));
+        setChild(root, 0, tree, tree.mRootNodeID);
+    }
+    else {
+        collapseSubTree(tree, tree.mRootNodeID);
+    }
+
+    assert(mNbLeaves == nbSourceLeaves);
+}
+
+// Collapse a sub-tree of a dynamic AABB tree into a new node and return the index of the node
+/// The two children of the internal node of the dynamic tree are replaced by their own
+/// children (largest surface area first) until the new node has four children. The nodes
+/// are stored in depth-first order.
+int32 WideAABBTree::collapseSubTree(const DynamicAABBTree& tree, int32 sourceNodeID) {
+
+    const TreeNode& sourceNode = tree.mNodes[sourceNodeID];
+    assert(!sourceNode.isLeaf());
+
+    const int32 index = mNbNodes;
+    mNbNodes++;
+    assert(index < mNbAllocatedNodes);
+
+    int32 sourceChildren[WideTreeNode::NB_CHILDREN];
+    sourceChildren[0] = sourceNode.children[0];
+    sourceChildren[1] = sourceNode.children[1];
+    int32 nbChildren = 2;
+
+    while (nbChildren < WideTreeNode::NB_CHILDREN) {
+
+        // Find the internal child with the largest surface area
+        int32 largestChild = -1;
+        decimal largestArea = decimal(-1.0);
+        for (int32 i=0; i < nbChildren; i++) {
+
+            const TreeNode& child = tree.mNodes[sourceChildren[i]];
+            if (!child.isLeaf() && child.aabb.getSurfaceArea() > largestArea) {
+                largestArea = child.aabb.getSurfaceArea();
+                largestChild = i;
+            }
+        }
+
+        // If all the children are leaves, the node cannot be expanded anymore
+        if (largestChild < 0) break;
+
+        // Replace the child by its two children
+        const TreeNode& child = tree.mNodes[sourceChildren[largestChild]];
+        sourceChildren[largestChild] = child.children[0];
+        sourceChildren[nbChildren] = child.children[1];
+        nbChildren++;
+    }
+
+    // The unused slots are empty
+    WideTreeNode& node = mNodes[index];
+    std::memset(&node, 0, sizeof(WideTreeNode));
+
+    for (int32 i=0; i < nbChildren; i++) {
+        setChild(node, i, tree, sourceChildren[i]);
+    }
+
+    return index;
+}
+
+// Set a child of a node
+void WideAABBTree::setChild(WideTreeNode& node, int32 childIndex, const DynamicAABBTree& tree, int32 sourceNodeID) {
+
+    const TreeNode& sourceNode = tree.mNodes[sourceNodeID];
+
+    uint16 quantizedMin[3];
+    uint16 quantizedMax[3];
+    quantizeAABB(sourceNode.aabb, quantizedMin, quantizedMax);
+    node.quantizedMinX[childIndex] = quantizedMin[0];
+    node.quantizedMinY[childIndex] = quantizedMin[1];
+    node.quantizedMinZ[childIndex] = quantizedMin[2];
+    node.quantizedMaxX[childIndex] = quantizedMax[0];
+    node.quantizedMaxY[childIndex] = quantizedMax[1];
+    node.quantizedMaxZ[childIndex] = quantizedMax[2];
+
+    // If the child is a leaf
+    if (sourceNode.isLeaf()) {
+
+        const int32 leafIndex = mNbLeaves;
+        mNbLeaves++;
+        assert(leafIndex < mNbAllocatedLeaves);
+
+        WideTreeLeaf& leaf = mLeaves[leafIndex];
+        leaf.dataInt[0] = sourceNode.dataInt[0];
+        leaf.dataInt[1] = sourceNode.dataInt[1];
+        leaf.sourceNodeID = sourceNodeID;
+        leaf.padding = 0;
+
+        node.children[childIndex] = -(leafIndex + 1);
+    }
+    else {
+        node.children[childIndex] = collapseSubTree(tree, sourceNodeID);
+    }
+}
+
+// Quantize the minimum and maximum coordinates of an AABB (rounded outwards)
+/// The quantized values are enlarged by one more unit to make sure that rounding errors
+/// never make the quantized AABB smaller than the original one. The coordinates outside
+/// of the root AABB are clamped.
+void WideAABBTree::quantizeAABB(const AABB& aabb, uint16* outQuantizedMin, uint16* outQuantizedMax) const {
+
+    for (int i=0; i < 3; i++) {
+
+        const decimal min = std::floor((aabb.getMin()[i] - mRootAABB.getMin()[i]) * mQuantizationScale[i]) - decimal(1.0);
+        const decimal max = std::ceil((aabb.getMax()[i] - mRootAABB.getMin()[i]) * mQuantizationScale[i]) + decimal(1.0);
+
+        outQuantizedMin[i] = static_cast<uint16>(clamp(min, decimal(0.0), MAX_QUANTIZED_VALUE));
+        outQuantizedMax[i] = static_cast<uint16>(clamp(max, decimal(0.0), MAX_QUANTIZED_VALUE));
+    }
+}
+
+// Return the children of a node whose quantized AABB overlaps with a quantized AABB (one bit per child)
+uint32 WideAABBTree::testOverlapWithChildren(const WideTreeNode& node, const uint16* quantizedMin, const uint16* quantizedMax) const {
+
+    const uint32 usedChildrenMask = (1u << node.getNbChildren()) - 1;
+
+#ifdef RP3D_USE_SIMD
+
+    // The 16 bits integers are exactly represented in single precision
+    const SimdMask4 overlapX = (simdLoadUint16(node.quantizedMaxX) >= simdSet(quantizedMin[0])) &
+                               (simdSet(quantizedMax[0]) >= simdLoadUint16(node.quantizedMinX));
+    const SimdMask4 overlapY = (simdLoadUint16(node.quantizedMaxY) >= simdSet(quantizedMin[1])) &
+                               (simdSet(quantizedMax[1]) >= simdLoadUint16(node.quantizedMinY));
+    const SimdMask4 overlapZ = (simdLoadUint16(node.quantizedMaxZ) >= simdSet(quantizedMin[2])) &
+                               (simdSet(quantizedMax[2]) >= simdLoadUint16(node.quantizedMinZ));
+
+    return simdMoveMask(overlapX & overlapY & overlapZ) & usedChildrenMask;
+
+#else
+
+    uint32 overlapMask = 0;
+    for (int32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+
+        if (quantizedMin[0] <= node.quantizedMaxX[i] && quantizedMax[0] >= node.quantizedMinX[i] &&
+            quantizedMin[1] <= node.quantizedMaxY[i] && quantizedMax[1] >= node.quantizedMinY[i] &&
+            quantizedMin[2] <= node.quantizedMaxZ[i] && quantizedMax[2] >= node.quantizedMinZ[i]) {
+            overlapMask |= 1u << i;
+        }
+    }
+
+    return overlapMask & usedChildrenMask;
+
+#endif
+
+}
+
+// Return the children of a node whose AABB is hit by a ray (one bit per child)
+/// The four slab tests are computed at once with SIMD instructions when they are available.
+/// They give exactly the same result as the scalar slab test of AABB::testRayIntersect().
+/// The fraction of the ray where it enters the AABB of each child is also returned.
+uint32 WideAABBTree::testRayWithChildren(const WideTreeNode& node, const Vector3& rayOrigin, const Vector3& rayDirectionInverse,
+                                         decimal maxFraction, decimal* outEnterFractions) const {
+
+#ifdef RP3D_USE_SIMD
+
+    const Vector3& minOrigin = mDequantizationMinOrigin;
+    const Vector3& maxOrigin = mDequantizationMaxOrigin;
+
+    // Dequantize the bounds of the children
+    const SimdFloat4 minX = simdSet(minOrigin.x) + simdLoadUint16(node.quantizedMinX) * simdSet(mDequantizationScale.x);
+    const SimdFloat4 minY = simdSet(minOrigin.y) + simdLoadUint16(node.quantizedMinY) * simdSet(mDequantizationScale.y);
+    const SimdFloat4 minZ = simdSet(minOrigin.z) + simdLoadUint16(node.quantizedMinZ) * simdSet(mDequantizationScale.z);
+    const SimdFloat4 maxX = simdSet(maxOrigin.x) + simdLoadUint16(node.quantizedMaxX) * simdSet(mDequantizationScale.x);
+    const SimdFloat4 maxY = simdSet(maxOrigin.y) + simdLoadUint16(node.quantizedMaxY) * simdSet(mDequantizationScale.y);
+    const SimdFloat4 maxZ = simdSet(maxOrigin.z) + simdLoadUint16(node.quantizedMaxZ) * simdSet(mDequantizationScale.z);
+
+    // Slab test on the x, y and z axis
+    const SimdFloat4 originX = simdSet(rayOrigin.x);
+    const SimdFloat4 originY = simdSet(rayOrigin.y);
+    const SimdFloat4 originZ = simdSet(rayOrigin.z);
+    const SimdFloat4 directionInverseX = simdSet(rayDirectionInverse.x);
+    const SimdFloat4 directionInverseY = simdSet(rayDirectionInverse.y);
+    const SimdFloat4 directionInverseZ = simdSet(rayDirectionInverse.z);
+
+    SimdFloat4 t1 = (minX - originX) * directionInverseX;
+    SimdFloat4 t2 = (maxX - originX) * directionInverseX;
+    SimdFloat4 tMin = simdMin(t1, t2);
+    SimdFloat4 tMax = simdMin(simdMax(t1, t2), simdSet(maxFraction));
+
+    t1 = (minY - originY) * directionInverseY;
+    t2 = (maxY - originY) * directionInverseY;
+    tMin = simdMax(tMin, simdMin(t1, t2));
+    tMax = simdMin(tMax, simdMax(t1, t2));
+
+    t1 = (minZ - originZ) * directionInverseZ;
+    t2 = (maxZ - originZ) * directionInverseZ;
+    tMin = simdMax(tMin, simdMin(t1, t2));
+    tMax = simdMin(tMax, simdMax(t1, t2));
+
+    const SimdFloat4 tEnter = simdMax(tMin, simdSet(decimal(0.0)));
+    simdStore(outEnterFractions, tEnter);
+
+    const uint32 hitMask = simdMoveMask(tMax >= tEnter) & ((1u << node.getNbChildren()) - 1);
+
+#ifdef IS_RP3D_SIMD_VALIDATION_ENABLED
+
+    // The SIMD test must give exactly the same result as the scalar test
+    decimal enterFractions[WideTreeNode::NB_CHILDREN];
+    assert(hitMask == testRayWithChildrenScalar(node, rayOrigin, rayDirectionInverse, maxFraction, enterFractions));
+    for (int32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+        assert((hitMask & (1u << i)) == 0 || enterFractions[i] == outEnterFractions[i]);
+    }
+
+#endif
+
+    return hitMask;
+
+#else
+
+    return testRayWithChildrenScalar(node, rayOrigin, rayDirectionInverse, maxFraction, outEnterFractions);
+
+#endif
+
+}
+
+// Return the children of a node whose AABB is hit by a ray (scalar version)
+uint32 WideAABBTree::testRayWithChildrenScalar(const WideTreeNode& node, const Vector3& rayOrigin, const Vector3& rayDirectionInverse,
+                                               decimal maxFraction, decimal* outEnterFractions) const {
+
+    const Vector3& minOrigin = mDequantizationMinOrigin;
+    const Vector3& maxOrigin = mDequantizationMaxOrigin;
+    const int32 nbChildren = node.getNbChildren();
+
+    uint32 hitMask = 0;
+    for (int32 i=0; i < nbChildren; i++) {
+
+        const Vector3 min(minOrigin.x + node.quantizedMinX[i] * mDequantizationScale.x,
+                          minOrigin.y + node.quantizedMinY[i] * mDequantizationScale.y,
+                          minOrigin.z + node.quantizedMinZ[i] * mDequantizationScale.z);
+        const Vector3 max(maxOrigin.x + node.quantizedMaxX[i] * mDequantizationScale.x,
+                          maxOrigin.y + node.quantizedMaxY[i] * mDequantizationScale.y,
+                          maxOrigin.z + node.quantizedMaxZ[i] * mDequantizationScale.z);
+
+        // Same slab test as AABB::testRayIntersect()
+        decimal t1 = (min[0] - rayOrigin[0]) * rayDirectionInverse[0];
+        decimal t2 = (max[0] - rayOrigin[0]) * rayDirectionInverse[0];
+        decimal tMin = std::min(t1, t2);
+        decimal tMax = std::min(std::max(t1, t2), maxFraction);
+
+        for (int j=1; j < 3; j++) {
+
+            t1 = (min[j] - rayOrigin[j]) * rayDirectionInverse[j];
+            t2 = (max[j] - rayOrigin[j]) * rayDirectionInverse[j];
+            tMin = std::max(tMin, std::min(t1, t2));
+            tMax = std::min(tMax, std::max(t1, t2));
+        }
+
+        outEnterFractions[i] = std::max(tMin, decimal(0.0));
+
+        if (tMax >= outEnterFractions[i]) {
+            hitMask |= 1u << i;
+        }
+    }
+
+    return hitMask;
+}
+
+// Report all the leaves overlapping with the AABB given in parameter
+/// The AABB is quantized and compared with the quantized AABBs of the nodes. Because the
+/// quantized AABBs are larger than the original ones, a few leaves that do not overlap
+/// with the AABB can also be reported.
+void WideAABBTree::reportAllShapesOverlappingWithAABB(const AABB& aabb, Array<int32>& overlappingNodes) const {
+
+    RP3D_PROFILE("WideAABBTree::reportAllShapesOverlappingWithAABB()", mProfiler);
+
+    if (mNbNodes == 0 || !aabb.testCollision(mRootAABB)) return;
+
+    uint16 quantizedMin[3];
+    uint16 quantizedMax[3];
+    quantizeAABB(aabb, quantizedMin, quantizedMax);
+
+    Stack<int32> stack(mAllocator, 64);
+    stack.push(0);
+
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test the AABB in parameter against the four children of the node at once
+        uint32 overlapMask = testOverlapWithChildren(node, quantizedMin, quantizedMax);
+
+        for (int32 i=0; overlapMask != 0; i++, overlapMask >>= 1) {
+
+            if ((overlapMask & 1) == 0) continue;
+
+            const int32 child = node.children[i];
+
+            // If the child is a leaf
+            if (child < 0) {
+                overlappingNodes.add(-child - 1);
+            }
+            else {
+                stack.push(child);
+            }
+        }
+    }
+}
+
+// Report all the leaves overlapping with the AABB of a shape
+/// A pair (shapeID, leaf index) is added into the output array for each overlapping leaf.
+/// The stack of nodes to visit is given by the caller so that its memory is reused between
+/// the queries.
+void WideAABBTree::reportAllShapesOverlappingWithShape(int32 shapeID, const AABB& shapeAABB, Stack<int32>& stack,
+                                                       Array<Pair<int32, int32>>& outOverlappingNodes) const {
+
+    assert(stack.size() == 0);
+
+    if (mNbNodes == 0 || !shapeAABB.testCollision(mRootAABB)) return;
+
+    uint16 quantizedMin[3];
+    uint16 quantizedMax[3];
+    quantizeAABB(shapeAABB, quantizedMin, quantizedMax);
+
+    stack.push(0);
+
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        uint32 overlapMask = testOverlapWithChildren(node, quantizedMin, quantizedMax);
+
+        for (int32 i=0; overlapMask != 0; i++, overlapMask >>= 1) {
+
+            if ((overlapMask & 1) == 0) continue;
+
+            const int32 child = node.children[i];
+
+            if (child < 0) {
+                outOverlappingNodes.add(Pair<int32, int32>(shapeID, -child - 1));
+            }
+            else {
+                stack.push(child);
+            }
+        }
+    }
+}
+
+// Ray casting method
+/// The callback is called with the index of each leaf whose quantized AABB is hit by the ray.
+/// The children of a node that are hit by the ray are visited from the nearest to the farthest
+/// one so that the maximum fraction of the ray is reduced as soon as possible. The method
+/// returns the maximum fraction of the ray after the raycast (the smallest hit fraction returned
+/// by the callback) or zero if the callback has stopped the raycast.
+decimal WideAABBTree::raycast(const Ray& ray, DynamicAABBTreeRaycastCallback& callback) const {
+
+    RP3D_PROFILE("WideAABBTree::raycast()", mProfiler);
+
+    decimal maxFraction = ray.maxFraction;
+
+    if (mNbNodes == 0) return maxFraction;
+
+    // Compute the inverse ray direction
+    const Vector3 rayDirection = ray.point2 - ray.point1;
+    const Vector3 rayDirectionInverse(decimal(1.0) / rayDirection.x, decimal(1.0) / rayDirection.y, decimal(1.0) / rayDirection.z);
+
+    Stack<int32> stack(mAllocator, 64);
+    stack.push(0);
+
+    while (stack.size() > 0) {
+
+        const WideTreeNode& node = mNodes[stack.pop()];
+
+        // Test the ray against the four children of the node at once
+        decimal enterFractions[WideTreeNode::NB_CHILDREN];
+        const uint32 hitMask = testRayWithChildren(node, ray.point1, rayDirectionInverse, maxFraction, enterFractions);
+
+        if (hitMask == 0) continue;
+
+        // Sort the children that are hit by the ray from the nearest to the farthest one
+        int32 hitChildren[WideTreeNode::NB_CHILDREN];
+        int32 nbHitChildren = 0;
+        for (int32 i=0; i < WideTreeNode::NB_CHILDREN; i++) {
+
+            if ((hitMask & (1u << i)) == 0) continue;
+
+            int32 j = nbHitChildren;
+            while (j > 0 && enterFractions[hitChildren[j - 1]] > enterFractions[i]) {
+                hitChildren[j] = hitChildren[j - 1];
+                j--;
+            }
+            hitChildren[j] = i;
+            nbHitChildren++;
+        }
+
+        // Call the callback for the leaves from the nearest to the farthest one
+        for (int32 i=0; i < nbHitChildren; i++) {
+
+            const int32 child = node.children[hitChildren[i]];
+
+            // Skip the leaves that are beyond a hit found with a previous leaf
+            if (child >= 0 || enterFractions[hitChildren[i]] > maxFraction) continue;
+
+            Ray rayTemp(ray.point1, ray.point2, maxFraction);
+
+            // Call the callback that will raycast again the shape
+            decimal hitFraction = callback.raycastBroadPhaseShape(-child - 1, rayTemp);
+
+            // If the user returned a hitFraction of zero, it means that
+            // the raycasting should stop here
+            if (hitFraction == decimal(0.0)) {
+                return decimal(0.0);
+            }
+
+            // If the user returned a positive fraction, we update the maximum fraction of the ray
+            if (hitFraction > decimal(0.0) && hitFraction < maxFraction) {
+                maxFraction = hitFraction;
+            }
+
+            // If the user returned a negative fraction, we continue
+            // the raycasting as if the shape did not exist
+        }
+
+        // Push the internal children from the farthest to the nearest one so that the nearest one is visited first
+        for (int32 i=nbHitChildren - 1; i >= 0; i--) {
+
+            const int32 child = node.children[hitChildren[i]];
+            if (child >= 0 && enterFractions[hitChildren[i]] <= maxFraction) {
+                stack.push(child);
+            }
+        }
+    }
+
+    return maxFraction;
+}
+
+// Ray casting method for a packet of rays
+/// The rays of the packet traverse the tree together. The children of a node are tested
+/// against all the rays that hit the node and the children hit by at least one ray are visited
+/// from the nearest to the farthest one (using the smallest enter fraction of the rays). The
+/// callback is called with the index of a leaf and the mask of the rays that hit its quantized
+/// AABB. The stack of (node, rays mask) entries is given in parameter so that it can be reused
+/// for all the packets of a batch.
+void WideAABBTree::raycastPacket(RayPacket& packet, DynamicAABBTreeRaycastPacketCallback& callback,
+                                 Stack<Pair<int32, uint32>>& stack) const {
+
+    RP3D_PROFILE("WideAABBTree::raycastPacket()", mProfiler);
+
+    if (mNbNodes == 0) return;
+
+    const Vector3& minOrigin = mDequantizationMinOrigin;
+    const Vector3& maxOrigin = mDequantizationMaxOrigin;
+
+    stack.clear();
+    stack.push(Pair<int32, uint32>(0, packet.activeRaysMask));
+
+    while (stack.size() > 0) {
+
+        const Pair<int32, uint32> entry = stack.pop();
+
+        // The rays that have been terminated since the node has been pushed are not tested
+        const uint32 raysMask = entry.second & packet.activeRaysMask;
+        if (raysMask == 0) continue;
+
+        const WideTreeNode& node = mNodes[entry.first];
+        const int32 nbChildren = node.getNbChildren();
+
+        // Test all the rays of the packet against each child of the node
+        Vector3 childrenMin[WideTreeNode::NB_CHILDREN];
+        Vector3 childrenMax[WideTreeNode::NB_CHILDREN];
+        uint32 childrenRaysMasks[WideTreeNode::NB_CHILDREN];
+        decimal childrenEnterFractions[WideTreeNode::NB_CHILDREN];
+        int32 hitChildren[WideTreeNode::NB_CHILDREN];
+        int32 nbHitChildren = 0;
+        for (int32 i=0; i < nbChildren; i++) {
+
+            childrenMin[i] = Vector3(minOrigin.x + node.quantizedMinX[i] * mDequantizationScale.x,
+                                     minOrigin.y + node.quantizedMinY[i] * mDequantizationScale.y,
+                                     minOrigin.z + node.quantizedMinZ[i] * mDequantizationScale.z);
+            childrenMax[i] = Vector3(maxOrigin.x + node.quantizedMaxX[i] * mDequantizationScale.x,
+                                     maxOrigin.y + node.quantizedMaxY[i] * mDequantizationScale.y,
+                                     maxOrigin.z + node.quantizedMaxZ[i] * mDequantizationScale.z);
+
+            decimal enterFractions[RayPacket::NB_MAX_RAYS];
+            childrenRaysMasks[i] = packet.testAABB(childrenMin[i], childrenMax[i], raysMask, enterFractions);
+            if (childrenRaysMasks[i] == 0) continue;
+
+            // Smallest enter fraction of the rays that hit the child
+            childrenEnterFractions[i] = DECIMAL_LARGEST;
+            for (uint32 j=0; j < RayPacket::NB_MAX_RAYS; j++) {
+                if ((childrenRaysMasks[i] & (1u << j)) != 0) {
+                    childrenEnterFractions[i] = std::min(childrenEnterFractions[i], enterFractions[j]);
+                }
+            }
+
+            // Insert the child in the array of hit children sorted from the nearest to the farthest one
+            int32 j = nbHitChildren;
+            while (j > 0 && childrenEnterFractions[hitChildren[j - 1]] > childrenEnterFractions[i]) {
+                hitChildren[j] = hitChildren[j - 1];
+                j--;
+            }
+            hitChildren[j] = i;
+            nbHitChildren++;
+        }
+
+        // Call the callback for the leaves from the nearest to the farthest one
+        for (int32 i=0; i < nbHitChildren; i++) {
+
+            const int32 childIndex = hitChildren[i];
+            const int32 child = node.children[childIndex];
+            if (child >= 0) continue;
+
+            // Test the leaf again with the rays that have not been terminated or clipped
+            // before the leaf by a hit found with a previous leaf
+            decimal enterFractions[RayPacket::NB_MAX_RAYS];
+            const uint32 leafRaysMask = packet.testAABB(childrenMin[childIndex], childrenMax[childIndex],
+                                                        childrenRaysMasks[childIndex] & packet.activeRaysMask, enterFractions);
+            if (leafRaysMask != 0) {
+                callback.raycastBroadPhaseShape(-child - 1, packet, leafRaysMask);
+            }
+        }
+
+        // Push the internal children from the farthest to the nearest one so that the nearest one is visited first
+        for (int32 i=nbHitChildren - 1; i >= 0; i--) {
+
+            const int32 child = node.children[hitChildren[i]];
+            if (child >= 0) {
+                stack.push(Pair<int32, uint32>(child, childrenRaysMasks[hitChildren[i]]));
+            }
+        }
+    }
+}
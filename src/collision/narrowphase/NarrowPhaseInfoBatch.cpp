@@ -28,13 +28,20 @@
 #include <reactphysics3d/collision/ContactPointInfo.h>
 #include <reactphysics3d/collision/shapes/TriangleShape.h>
 #include <reactphysics3d/engine/OverlappingPairs.h>
-#include <iostream>
+#include <cstring>
 
 using namespace reactphysics3d;
 
 // Constructor
 NarrowPhaseInfoBatch::NarrowPhaseInfoBatch(OverlappingPairs& overlappingPairs, MemoryAllocator& allocator)
-                     : mMemoryAllocator(allocator), mOverlappingPairs(overlappingPairs), narrowPhaseInfos(allocator){
+                     : mMemoryAllocator(allocator), mOverlappingPairs(overlappingPairs), mNbObjects(0), mNbAllocatedObjects(0),
+                       mObjectDataSize(sizeof(uint64) + sizeof(LastFrameCollisionInfo*) + sizeof(MemoryAllocator*) + 2 * sizeof(CollisionShape*) +
+                                       2 * sizeof(Transform) + 2 * sizeof(Entity) + sizeof(uint32) + 2 * sizeof(bool) + sizeof(uint8)),
+                       mBuffer(nullptr), mNbItemsPerContactPointPool(std::numeric_limits<uint32>::max()), mContactPointPools(allocator),
+                       overlappingPairIds(nullptr), lastFrameCollisionInfos(nullptr), collisionShapeAllocators(nullptr),
+                       collisionShapes1(nullptr), collisionShapes2(nullptr), shape1ToWorldTransforms(nullptr), shape2ToWorldTransforms(nullptr),
+                       colliderEntities1(nullptr), colliderEntities2(nullptr), contactPointsIndices(nullptr), reportContacts(nullptr),
+                       isColliding(nullptr), nbContactPoints(nullptr) {
 
 }
 
@@ -43,31 +50,118 @@ NarrowPhaseInfoBatch::~NarrowPhaseInfoBatch() {
     clear();
 }
 
+// Allocate memory for a given number of items
+void NarrowPhaseInfoBatch::allocate(uint32 nbObjectsToAllocate) {
+
+    assert(nbObjectsToAllocate > mNbAllocatedObjects);
+
+    // Size for the data of all the items (in bytes)
+    const size_t totalSizeBytes = nbObjectsToAllocate * mObjectDataSize;
+
+    // Allocate memory
+    void* newBuffer = mMemoryAllocator.allocate(totalSizeBytes);
+    assert(newBuffer != nullptr);
+
+    // New pointers to the data of the items
+    uint64* newOverlappingPairIds = static_cast<uint64*>(newBuffer);
+    LastFrameCollisionInfo** newLastFrameCollisionInfos = reinterpret_cast<LastFrameCollisionInfo**>(newOverlappingPairIds + nbObjectsToAllocate);
+    MemoryAllocator** newCollisionShapeAllocators = reinterpret_cast<MemoryAllocator**>(newLastFrameCollisionInfos + nbObjectsToAllocate);
+    CollisionShape** newCollisionShapes1 = reinterpret_cast<CollisionShape**>(newCollisionShapeAllocators + nbObjectsToAllocate);
+    CollisionShape** newCollisionShapes2 = reinterpret_cast<CollisionShape**>(newCollisionShapes1 + nbObjectsToAllocate);
+    Transform* newShape1ToWorldTransforms = reinterpret_cast<Transform*>(newCollisionShapes2 + nbObjectsToAllocate);
+    Transform* newShape2ToWorldTransforms = reinterpret_cast<Transform*>(newShape1ToWorldTransforms + nbObjectsToAllocate);
+    Entity* newColliderEntities1 = reinterpret_cast<Entity*>(newShape2ToWorldTransforms + nbObjectsToAllocate);
+    Entity* newColliderEntities2 = reinterpret_cast<Entity*>(newColliderEntities1 + nbObjectsToAllocate);
+    uint32* newContactPointsIndices = reinterpret_cast<uint32*>(newColliderEntities2 + nbObjectsToAllocate);
+    bool* newReportContacts = reinterpret_cast<bool*>(newContactPointsIndices + nbObjectsToAllocate);
+    bool* newIsColliding = reinterpret_cast<bool*>(newReportContacts + nbObjectsToAllocate);
+    uint8* newNbContactPoints = reinterpret_cast<uint8*>(newIsColliding + nbObjectsToAllocate);
+
+    // If there was already items before
+    if (mNbObjects > 0) {
+
+        // Copy the data from the previous buffer to the new one
+        memcpy(newOverlappingPairIds, overlappingPairIds, mNbObjects * sizeof(uint64));
+        memcpy(newLastFrameCollisionInfos, lastFrameCollisionInfos, mNbObjects * sizeof(LastFrameCollisionInfo*));
+        memcpy(newCollisionShapeAllocators, collisionShapeAllocators, mNbObjects * sizeof(MemoryAllocator*));
+        memcpy(newCollisionShapes1, collisionShapes1, mNbObjects * sizeof(CollisionShape*));
+        memcpy(newCollisionShapes2, collisionShapes2, mNbObjects * sizeof(CollisionShape*));
+        memcpy(newShape1ToWorldTransforms, shape1ToWorldTransforms, mNbObjects * sizeof(Transform));
+        memcpy(newShape2ToWorldTransforms, shape2ToWorldTransforms, mNbObjects * sizeof(Transform));
+        memcpy(newColliderEntities1, colliderEntities1, mNbObjects * sizeof(Entity));
+        memcpy(newColliderEntities2, colliderEntities2, mNbObjects * sizeof(Entity));
+        memcpy(newContactPointsIndices, contactPointsIndices, mNbObjects * sizeof(uint32));
+        memcpy(newReportContacts, reportContacts, mNbObjects * sizeof(bool));
+        memcpy(newIsColliding, isColliding, mNbObjects * sizeof(bool));
+        memcpy(newNbContactPoints, nbContactPoints, mNbObjects * sizeof(uint8));
+    }
+
+    // Deallocate previous memory
+    if (mBuffer != nullptr) {
+        mMemoryAllocator.release(mBuffer, mNbAllocatedObjects * mObjectDataSize);
+    }
+
+    mBuffer = newBuffer;
+    overlappingPairIds = newOverlappingPairIds;
+    lastFrameCollisionInfos = newLastFrameCollisionInfos;
+    collisionShapeAllocators = newCollisionShapeAllocators;
+    collisionShapes1 = newCollisionShapes1;
+    collisionShapes2 = newCollisionShapes2;
+    shape1ToWorldTransforms = newShape1ToWorldTransforms;
+    shape2ToWorldTransforms = newShape2ToWorldTransforms;
+    colliderEntities1 = newColliderEntities1;
+    colliderEntities2 = newColliderEntities2;
+    contactPointsIndices = newContactPointsIndices;
+    reportContacts = newReportContacts;
+    isColliding = newIsColliding;
+    nbContactPoints = newNbContactPoints;
+    mNbAllocatedObjects = nbObjectsToAllocate;
+}
+
+// Split the items into ranges of a given size that use their own contact point pool
+/// The items in the range [i * nbItemsPerPool, (i+1) * nbItemsPerPool) add their contact points
+/// into the pool i. This must be called before testing the items and allows to test the ranges
+/// concurrently.
+void NarrowPhaseInfoBatch::setNbItemsPerContactPointPool(uint32 nbItemsPerPool) {
+
+    assert(nbItemsPerPool > 0);
+
+    assert(mContactPointPools.size() == 0 || mNbItemsPerContactPointPool == nbItemsPerPool);
+
+    mNbItemsPerContactPointPool = nbItemsPerPool;
+
+    // Create the contact point pools (they must exist before the ranges are tested concurrently)
+    const uint32 nbPools = mNbObjects > 0 ? (mNbObjects - 1) / nbItemsPerPool + 1 : 1;
+    mContactPointPools.reserve(nbPools);
+    while (mContactPointPools.size() < nbPools) {
+        mContactPointPools.emplace(mMemoryAllocator);
+    }
+}
+
 // Initialize the containers using cached capacity
 void NarrowPhaseInfoBatch::reserveMemory() {
 
-    narrowPhaseInfos.reserve(mCachedCapacity);
+    if (mCachedCapacity > mNbAllocatedObjects) {
+        allocate(mCachedCapacity);
+    }
 }
 
 // Clear all the objects in the batch
 void NarrowPhaseInfoBatch::clear() {
 
-    const uint32 nbNarrowPhaseInfos = static_cast<uint32>(narrowPhaseInfos.size());
-    for (uint32 i=0; i < nbNarrowPhaseInfos; i++) {
-
-        assert(narrowPhaseInfos[i].nbContactPoints == 0);
+    for (uint32 i=0; i < mNbObjects; i++) {
 
         // TODO OPTI : Better manage this
 
         // Release the memory of the TriangleShape (this memory was allocated in the
         // MiddlePhaseTriangleCallback::testTriangle() method)
-        if (narrowPhaseInfos[i].collisionShape1->getName() == CollisionShapeName::TRIANGLE) {
-            narrowPhaseInfos[i].collisionShape1->~CollisionShape();
-            narrowPhaseInfos[i].collisionShapeAllocator->release(narrowPhaseInfos[i].collisionShape1, sizeof(TriangleShape));
+        if (collisionShapes1[i]->getName() == CollisionShapeName::TRIANGLE) {
+            collisionShapes1[i]->~CollisionShape();
+            collisionShapeAllocators[i]->release(collisionShapes1[i], sizeof(TriangleShape));
         }
-        if (narrowPhaseInfos[i].collisionShape2->getName() == CollisionShapeName::TRIANGLE) {
-            narrowPhaseInfos[i].collisionShape2->~CollisionShape();
-            narrowPhaseInfos[i].collisionShapeAllocator->release(narrowPhaseInfos[i].collisionShape2, sizeof(TriangleShape));
+        if (collisionShapes2[i]->getName() == CollisionShapeName::TRIANGLE) {
+            collisionShapes2[i]->~CollisionShape();
+            collisionShapeAllocators[i]->release(collisionShapes2[i], sizeof(TriangleShape));
         }
     }
 
@@ -76,7 +170,15 @@ void NarrowPhaseInfoBatch::clear() {
     // allocated in the next frame at a possibly different location in memory (remember that the
     // location of the allocated memory of a single frame allocator might change between two frames)
 
-    mCachedCapacity = static_cast<uint32>(narrowPhaseInfos.capacity());
+    mCachedCapacity = mNbAllocatedObjects;
+
+    if (mBuffer != nullptr) {
+        mMemoryAllocator.release(mBuffer, mNbAllocatedObjects * mObjectDataSize);
+        mBuffer = nullptr;
+    }
+    mNbObjects = 0;
+    mNbAllocatedObjects = 0;
 
-    narrowPhaseInfos.clear(true);
+    mContactPointPools.clear(true);
+    mNbItemsPerContactPointPool = std::numeric_limits<uint32>::max();
 }
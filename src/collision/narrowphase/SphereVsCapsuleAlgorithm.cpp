@@ -1,152 +1,297 @@
-/********************************************************************************
-* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
-* Copyright (c) 2010-2022 Daniel Chappuis                                       *
-*********************************************************************************
-*                                                                               *
-* This software is provided 'as-is', without any express or implied warranty.   *
-* In no event will the authors be held liable for any damages arising from the  *
-* use of this software.                                                         *
-*                                                                               *
-* Permission is granted to anyone to use this software for any purpose,         *
-* including commercial applications, and to alter it and redistribute it        *
-* freely, subject to the following restrictions:                                *
-*                                                                               *
-* 1. The origin of this software must not be misrepresented; you must not claim *
-*    that you wrote the original software. If you use this software in a        *
-*    product, an acknowledgment in the product documentation would be           *
-*    appreciated but is not required.                                           *
-*                                                                               *
-* 2. Altered source versions must be plainly marked as such, and must not be    *
-*    misrepresented as being the original software.                             *
-*                                                                               *
-* 3. This notice may not be removed or altered from any source distribution.    *
-*                                                                               *
-********************************************************************************/
-
-// Libraries
-#include <reactphysics3d/collision/narrowphase/SphereVsCapsuleAlgorithm.h>
-#include <reactphysics3d/collision/shapes/SphereShape.h>
-#include <reactphysics3d/collision/shapes/CapsuleShape.h>
-#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
-
-// We want to use the ReactPhysics3D namespace
-using namespace reactphysics3d;  
-
-// Compute the narrow-phase collision detection between a sphere and a capsule
-// This technique is based on the "Robust Contact Creation for Physics Simulations" presentation
-// by Dirk Gregorius.
-bool SphereVsCapsuleAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& /*memoryAllocator*/) {
-
-    bool isCollisionFound = false;
-
-    for (uint32 batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
-
-        assert(!narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].isColliding);
-        assert(narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].nbContactPoints == 0);
-
-        const bool isSphereShape1 = narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape1->getType() == CollisionShapeType::SPHERE;
-
-        const SphereShape* sphereShape = static_cast<SphereShape*>(isSphereShape1 ? narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape1 : narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape2);
-        const CapsuleShape* capsuleShape = static_cast<CapsuleShape*>(isSphereShape1 ? narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape2 : narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape1);
-
-        const decimal capsuleHeight = capsuleShape->getHeight();
-        const decimal sphereRadius = sphereShape->getRadius();
-        const decimal capsuleRadius = capsuleShape->getRadius();
-
-        // Get the transform from sphere local-space to capsule local-space
-        const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].shape1ToWorldTransform : narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].shape2ToWorldTransform;
-        const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].shape2ToWorldTransform : narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].shape1ToWorldTransform;
-        const Transform worldToCapsuleTransform = capsuleToWorldTransform.getInverse();
-        const Transform sphereToCapsuleSpaceTransform = worldToCapsuleTransform * sphereToWorldTransform;
-
-        // Transform the center of the sphere into the local-space of the capsule shape
-        const Vector3 sphereCenter = sphereToCapsuleSpaceTransform.getPosition();
-
-        // Compute the end-points of the inner segment of the capsule
-        const decimal capsuleHalfHeight = capsuleHeight * decimal(0.5);
-        const Vector3 capsuleSegA(0, -capsuleHalfHeight, 0);
-        const Vector3 capsuleSegB(0, capsuleHalfHeight, 0);
-
-        // Compute the point on the inner capsule segment that is the closes to center of sphere
-        const Vector3 closestPointOnSegment = computeClosestPointOnSegment(capsuleSegA, capsuleSegB, sphereCenter);
-
-        // Compute the distance between the sphere center and the closest point on the segment
-        Vector3 sphereCenterToSegment = (closestPointOnSegment - sphereCenter);
-        const decimal sphereSegmentDistanceSquare = sphereCenterToSegment.lengthSquare();
-
-        // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
-        decimal sumRadius = sphereRadius + capsuleRadius;
-
-        // If the collision shapes overlap
-        if (sphereSegmentDistanceSquare < sumRadius * sumRadius) {
-
-            decimal penetrationDepth;
-            Vector3 normalWorld;
-            Vector3 contactPointSphereLocal;
-            Vector3 contactPointCapsuleLocal;
-
-            // If we need to report contacts
-            if (narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].reportContacts) {
-
-                // If the sphere center is not on the capsule inner segment
-                if (sphereSegmentDistanceSquare > MACHINE_EPSILON) {
-
-                    decimal sphereSegmentDistance = std::sqrt(sphereSegmentDistanceSquare);
-                    sphereCenterToSegment /= sphereSegmentDistance;
-
-                    contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + sphereCenterToSegment * sphereRadius);
-                    contactPointCapsuleLocal = closestPointOnSegment - sphereCenterToSegment * capsuleRadius;
-
-                    normalWorld = capsuleToWorldTransform.getOrientation() * sphereCenterToSegment;
-
-                    penetrationDepth = sumRadius - sphereSegmentDistance;
-
-                    if (!isSphereShape1) {
-                        normalWorld = -normalWorld;
-                    }
-                }
-                else {  // If the sphere center is on the capsule inner segment (degenerate case)
-
-                    // We take any direction that is orthogonal to the inner capsule segment as a contact normal
-
-                    // Capsule inner segment
-                    Vector3 capsuleSegment = (capsuleSegB - capsuleSegA).getUnit();
-
-                    Vector3 vec1(1, 0, 0);
-                    Vector3 vec2(0, 1, 0);
-
-                    // Get the vectors (among vec1 and vec2) that is the most orthogonal to the capsule inner segment (smallest absolute dot product)
-                    decimal cosA1 = std::abs(capsuleSegment.x);		// abs(vec1.dot(seg2))
-                    decimal cosA2 = std::abs(capsuleSegment.y);	    // abs(vec2.dot(seg2))
-
-                    penetrationDepth = sumRadius;
-
-                    // We choose as a contact normal, any direction that is perpendicular to the inner capsule segment
-                    Vector3 normalCapsuleSpace = cosA1 < cosA2 ? capsuleSegment.cross(vec1) : capsuleSegment.cross(vec2);
-                    normalWorld = capsuleToWorldTransform.getOrientation() * normalCapsuleSpace;
-
-                    // Compute the two local contact points
-                    contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + normalCapsuleSpace * sphereRadius);
-                    contactPointCapsuleLocal = sphereCenter - normalCapsuleSpace * capsuleRadius;
-                }
-
-                if (penetrationDepth <= decimal(0.0)) {
-
-                    // No collision
-                    continue;
-                }
-
-                // Create the contact info object
-                narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
-                                                 isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
-                                                 isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
-            }
-
-            narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].isColliding = true;
-            isCollisionFound = true;
-            continue;
-        }
-    }
-
-    return isCollisionFound;
-}
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/SphereVsCapsuleAlgorithm.h>
+#include <reactphysics3d/collision/shapes/SphereShape.h>
+#include <reactphysics3d/collision/shapes/CapsuleShape.h>
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
+#include <reactphysics3d/mathematics/Simd.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;  
+
+// Compute the narrow-phase collision detection between a sphere and a capsule
+// This technique is based on the "Robust Contact Creation for Physics Simulations" presentation
+// by Dirk Gregorius.
+bool SphereVsCapsuleAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& /*memoryAllocator*/) {
+
+    bool isCollisionFound = false;
+
+    const uint32 batchEndIndex = batchStartIndex + batchNbItems;
+    uint32 batchIndex = batchStartIndex;
+
+#ifdef RP3D_USE_SIMD
+
+    // Test the items four at a time and only compute the contacts of the overlapping items
+    for (; batchIndex + SIMD_WIDTH <= batchEndIndex; batchIndex += SIMD_WIDTH) {
+
+        const uint32 overlapMask = computeOverlapMask(narrowPhaseInfoBatch, batchIndex);
+
+        for (uint32 i=0; i < SIMD_WIDTH; i++) {
+
+            if ((overlapMask & (1 << i)) != 0) {
+                isCollisionFound |= testItemCollision(narrowPhaseInfoBatch, batchIndex + i);
+            }
+#ifdef IS_RP3D_SIMD_VALIDATION_ENABLED
+            else if (testItemCollision(narrowPhaseInfoBatch, batchIndex + i)) {
+
+                // The SIMD test must give exactly the same result as the scalar test
+                assert(false);
+                isCollisionFound = true;
+            }
+#endif
+        }
+    }
+
+#endif
+
+    // Test the remaining items
+    for (; batchIndex < batchEndIndex; batchIndex++) {
+        isCollisionFound |= testItemCollision(narrowPhaseInfoBatch, batchIndex);
+    }
+
+    return isCollisionFound;
+}
+
+// Compute the narrow-phase collision detection of a single item of the batch
+bool SphereVsCapsuleAlgorithm::testItemCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex) {
+
+    assert(!narrowPhaseInfoBatch.isColliding[batchIndex]);
+    assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
+
+    const bool isSphereShape1 = narrowPhaseInfoBatch.collisionShapes1[batchIndex]->getType() == CollisionShapeType::SPHERE;
+
+    const SphereShape* sphereShape = static_cast<SphereShape*>(isSphereShape1 ? narrowPhaseInfoBatch.collisionShapes1[batchIndex] : narrowPhaseInfoBatch.collisionShapes2[batchIndex]);
+    const CapsuleShape* capsuleShape = static_cast<CapsuleShape*>(isSphereShape1 ? narrowPhaseInfoBatch.collisionShapes2[batchIndex] : narrowPhaseInfoBatch.collisionShapes1[batchIndex]);
+
+    const decimal capsuleHeight = capsuleShape->getHeight();
+    const decimal sphereRadius = sphereShape->getRadius();
+    const decimal capsuleRadius = capsuleShape->getRadius();
+
+    // Get the transform from sphere local-space to capsule local-space
+    const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex] : narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+    const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex] : narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+    const Transform worldToCapsuleTransform = capsuleToWorldTransform.getInverse();
+    const Transform sphereToCapsuleSpaceTransform = worldToCapsuleTransform * sphereToWorldTransform;
+
+    // Transform the center of the sphere into the local-space of the capsule shape
+    const Vector3 sphereCenter = sphereToCapsuleSpaceTransform.getPosition();
+
+    // Compute the end-points of the inner segment of the capsule
+    const decimal capsuleHalfHeight = capsuleHeight * decimal(0.5);
+    const Vector3 capsuleSegA(0, -capsuleHalfHeight, 0);
+    const Vector3 capsuleSegB(0, capsuleHalfHeight, 0);
+
+    // Compute the point on the inner capsule segment that is the closes to center of sphere
+    const Vector3 closestPointOnSegment = computeClosestPointOnSegment(capsuleSegA, capsuleSegB, sphereCenter);
+
+    // Compute the distance between the sphere center and the closest point on the segment
+    Vector3 sphereCenterToSegment = (closestPointOnSegment - sphereCenter);
+    const decimal sphereSegmentDistanceSquare = sphereCenterToSegment.lengthSquare();
+
+    // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
+    decimal sumRadius = sphereRadius + capsuleRadius;
+
+    // If the collision shapes overlap
+    if (sphereSegmentDistanceSquare < sumRadius * sumRadius) {
+
+        decimal penetrationDepth;
+        Vector3 normalWorld;
+        Vector3 contactPointSphereLocal;
+        Vector3 contactPointCapsuleLocal;
+
+        // If we need to report contacts
+        if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+            // If the sphere center is not on the capsule inner segment
+            if (sphereSegmentDistanceSquare > MACHINE_EPSILON) {
+
+                decimal sphereSegmentDistance = std::sqrt(sphereSegmentDistanceSquare);
+                sphereCenterToSegment /= sphereSegmentDistance;
+
+                contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + sphereCenterToSegment * sphereRadius);
+                contactPointCapsuleLocal = closestPointOnSegment - sphereCenterToSegment * capsuleRadius;
+
+                normalWorld = capsuleToWorldTransform.getOrientation() * sphereCenterToSegment;
+
+                penetrationDepth = sumRadius - sphereSegmentDistance;
+
+                if (!isSphereShape1) {
+                    normalWorld = -normalWorld;
+                }
+            }
+            else {  // If the sphere center is on the capsule inner segment (degenerate case)
+
+                // We take any direction that is orthogonal to the inner capsule segment as a contact normal
+
+                // Capsule inner segment
+                Vector3 capsuleSegment = (capsuleSegB - capsuleSegA).getUnit();
+
+                Vector3 vec1(1, 0, 0);
+                Vector3 vec2(0, 1, 0);
+
+                // Get the vectors (among vec1 and vec2) that is the most orthogonal to the capsule inner segment (smallest absolute dot product)
+                decimal cosA1 = std::abs(capsuleSegment.x);		// abs(vec1.dot(seg2))
+                decimal cosA2 = std::abs(capsuleSegment.y);	    // abs(vec2.dot(seg2))
+
+                penetrationDepth = sumRadius;
+
+                // We choose as a contact normal, any direction that is perpendicular to the inner capsule segment
+                Vector3 normalCapsuleSpace = cosA1 < cosA2 ? capsuleSegment.cross(vec1) : capsuleSegment.cross(vec2);
+                normalWorld = capsuleToWorldTransform.getOrientation() * normalCapsuleSpace;
+
+                // Compute the two local contact points
+                contactPointSphereLocal = sphereToCapsuleSpaceTransform.getInverse() * (sphereCenter + normalCapsuleSpace * sphereRadius);
+                contactPointCapsuleLocal = sphereCenter - normalCapsuleSpace * capsuleRadius;
+            }
+
+            if (penetrationDepth <= decimal(0.0)) {
+
+                // No collision
+                return false;
+            }
+
+            // Create the contact info object
+            narrowPhaseInfoBatch.addContactPoint(batchIndex, normalWorld, penetrationDepth,
+                                             isSphereShape1 ? contactPointSphereLocal : contactPointCapsuleLocal,
+                                             isSphereShape1 ? contactPointCapsuleLocal : contactPointSphereLocal);
+        }
+
+        narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+        return true;
+    }
+
+    return false;
+}
+
+#ifdef RP3D_USE_SIMD
+
+// Return a mask where the bit i is set if the sphere and the capsule of the item (batchIndex + i) overlap
+/// This method performs exactly the same operations as the testItemCollision() method (including the
+/// operations of the Transform and Quaternion methods) on four items at a time. Therefore, it gives
+/// exactly the same results (this file is compiled without contraction of the operations into fused
+/// multiply-add).
+uint32 SphereVsCapsuleAlgorithm::computeOverlapMask(const NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex) {
+
+    float spherePositionX[SIMD_WIDTH], spherePositionY[SIMD_WIDTH], spherePositionZ[SIMD_WIDTH];
+    float capsulePositionX[SIMD_WIDTH], capsulePositionY[SIMD_WIDTH], capsulePositionZ[SIMD_WIDTH];
+    float capsuleOrientationX[SIMD_WIDTH], capsuleOrientationY[SIMD_WIDTH], capsuleOrientationZ[SIMD_WIDTH];
+    float capsuleOrientationW[SIMD_WIDTH];
+    float capsuleHeights[SIMD_WIDTH], sphereRadiuses[SIMD_WIDTH], capsuleRadiuses[SIMD_WIDTH];
+
+    // Gather the data of the items
+    for (uint32 i=0; i < SIMD_WIDTH; i++) {
+
+        const uint32 index = batchIndex + i;
+        const bool isSphereShape1 = narrowPhaseInfoBatch.collisionShapes1[index]->getType() == CollisionShapeType::SPHERE;
+
+        const SphereShape* sphereShape = static_cast<const SphereShape*>(isSphereShape1 ? narrowPhaseInfoBatch.collisionShapes1[index] : narrowPhaseInfoBatch.collisionShapes2[index]);
+        const CapsuleShape* capsuleShape = static_cast<const CapsuleShape*>(isSphereShape1 ? narrowPhaseInfoBatch.collisionShapes2[index] : narrowPhaseInfoBatch.collisionShapes1[index]);
+
+        const Transform& sphereToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape1ToWorldTransforms[index] : narrowPhaseInfoBatch.shape2ToWorldTransforms[index];
+        const Transform& capsuleToWorldTransform = isSphereShape1 ? narrowPhaseInfoBatch.shape2ToWorldTransforms[index] : narrowPhaseInfoBatch.shape1ToWorldTransforms[index];
+
+        spherePositionX[i] = sphereToWorldTransform.getPosition().x;
+        spherePositionY[i] = sphereToWorldTransform.getPosition().y;
+        spherePositionZ[i] = sphereToWorldTransform.getPosition().z;
+        capsulePositionX[i] = capsuleToWorldTransform.getPosition().x;
+        capsulePositionY[i] = capsuleToWorldTransform.getPosition().y;
+        capsulePositionZ[i] = capsuleToWorldTransform.getPosition().z;
+        capsuleOrientationX[i] = capsuleToWorldTransform.getOrientation().x;
+        capsuleOrientationY[i] = capsuleToWorldTransform.getOrientation().y;
+        capsuleOrientationZ[i] = capsuleToWorldTransform.getOrientation().z;
+        capsuleOrientationW[i] = capsuleToWorldTransform.getOrientation().w;
+
+        capsuleHeights[i] = capsuleShape->getHeight();
+        sphereRadiuses[i] = sphereShape->getRadius();
+        capsuleRadiuses[i] = capsuleShape->getRadius();
+    }
+
+    const SimdFloat4 zero = simdSet(0.0f);
+
+    // Inverse of the capsule orientation (Quaternion::getInverse())
+    const SimdFloat4 qx = -simdLoad(capsuleOrientationX);
+    const SimdFloat4 qy = -simdLoad(capsuleOrientationY);
+    const SimdFloat4 qz = -simdLoad(capsuleOrientationZ);
+    const SimdFloat4 qw = simdLoad(capsuleOrientationW);
+
+    // Position of the world-space to capsule-space transform (Transform::getInverse())
+    const SimdFloat4 px = -simdLoad(capsulePositionX);
+    const SimdFloat4 py = -simdLoad(capsulePositionY);
+    const SimdFloat4 pz = -simdLoad(capsulePositionZ);
+    SimdFloat4 prodX = qw * px + qy * pz - qz * py;
+    SimdFloat4 prodY = qw * py + qz * px - qx * pz;
+    SimdFloat4 prodZ = qw * pz + qx * py - qy * px;
+    SimdFloat4 prodW = -qx * px - qy * py - qz * pz;
+    const SimdFloat4 worldToCapsuleX = qw * prodX - prodY * qz + prodZ * qy - prodW * qx;
+    const SimdFloat4 worldToCapsuleY = qw * prodY - prodZ * qx + prodX * qz - prodW * qy;
+    const SimdFloat4 worldToCapsuleZ = qw * prodZ - prodX * qy + prodY * qx - prodW * qz;
+
+    // Transform the center of the sphere into the local-space of the capsule shape (Transform::operator*(const Transform&))
+    const SimdFloat4 sx = simdLoad(spherePositionX);
+    const SimdFloat4 sy = simdLoad(spherePositionY);
+    const SimdFloat4 sz = simdLoad(spherePositionZ);
+    prodX = qw * sx + qy * sz - qz * sy;
+    prodY = qw * sy + qz * sx - qx * sz;
+    prodZ = qw * sz + qx * sy - qy * sx;
+    prodW = -qx * sx - qy * sy - qz * sz;
+    const SimdFloat4 sphereCenterX = worldToCapsuleX + qw * prodX - prodY * qz + prodZ * qy - prodW * qx;
+    const SimdFloat4 sphereCenterY = worldToCapsuleY + qw * prodY - prodZ * qx + prodX * qz - prodW * qy;
+    const SimdFloat4 sphereCenterZ = worldToCapsuleZ + qw * prodZ - prodX * qy + prodY * qx - prodW * qz;
+
+    // Compute the end-points of the inner segment of the capsule
+    const SimdFloat4 capsuleHalfHeight = simdLoad(capsuleHeights) * simdSet(0.5f);
+    const SimdFloat4 capsuleSegAY = -capsuleHalfHeight;
+    const SimdFloat4 capsuleSegBY = capsuleHalfHeight;
+
+    // Compute the point on the inner capsule segment that is the closes to center of sphere (computeClosestPointOnSegment())
+    const SimdFloat4 abX = zero - zero;
+    const SimdFloat4 abY = capsuleSegBY - capsuleSegAY;
+    const SimdFloat4 abZ = zero - zero;
+    const SimdFloat4 abLengthSquare = abX * abX + abY * abY + abZ * abZ;
+    SimdFloat4 t = ((sphereCenterX - zero) * abX + (sphereCenterY - capsuleSegAY) * abY + (sphereCenterZ - zero) * abZ) / abLengthSquare;
+    t = simdSelect(t < zero, zero, t);
+    t = simdSelect(t > simdSet(1.0f), simdSet(1.0f), t);
+    const SimdMask4 isSegmentDegenerate = abLengthSquare < simdSet(MACHINE_EPSILON);
+    const SimdFloat4 closestPointOnSegmentX = simdSelect(isSegmentDegenerate, zero, zero + abX * t);
+    const SimdFloat4 closestPointOnSegmentY = simdSelect(isSegmentDegenerate, capsuleSegAY, capsuleSegAY + abY * t);
+    const SimdFloat4 closestPointOnSegmentZ = simdSelect(isSegmentDegenerate, zero, zero + abZ * t);
+
+    // Compute the distance between the sphere center and the closest point on the segment
+    const SimdFloat4 sphereCenterToSegmentX = closestPointOnSegmentX - sphereCenterX;
+    const SimdFloat4 sphereCenterToSegmentY = closestPointOnSegmentY - sphereCenterY;
+    const SimdFloat4 sphereCenterToSegmentZ = closestPointOnSegmentZ - sphereCenterZ;
+    const SimdFloat4 sphereSegmentDistanceSquare = sphereCenterToSegmentX * sphereCenterToSegmentX +
+                                                   sphereCenterToSegmentY * sphereCenterToSegmentY +
+                                                   sphereCenterToSegmentZ * sphereCenterToSegmentZ;
+
+    // Compute the sum of the radius of the sphere and the capsule (virtual sphere)
+    const SimdFloat4 sumRadius = simdLoad(sphereRadiuses) + simdLoad(capsuleRadiuses);
+
+    return simdMoveMask(sphereSegmentDistanceSquare < sumRadius * sumRadius);
+}
+
+#endif
@@ -1,113 +1,199 @@
-/********************************************************************************
-* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
-* Copyright (c) 2010-2022 Daniel Chappuis                                       *
-*********************************************************************************
-*                                                                               *
-* This software is provided 'as-is', without any express or implied warranty.   *
-* In no event will the authors be held liable for any damages arising from the  *
-* use of this software.                                                         *
-*                                                                               *
-* Permission is granted to anyone to use this software for any purpose,         *
-* including commercial applications, and to alter it and redistribute it        *
-* freely, subject to the following restrictions:                                *
-*                                                                               *
-* 1. The origin of this software must not be misrepresented; you must not claim *
-*    that you wrote the original software. If you use this software in a        *
-*    product, an acknowledgment in the product documentation would be           *
-*    appreciated but is not required.                                           *
-*                                                                               *
-* 2. Altered source versions must be plainly marked as such, and must not be    *
-*    misrepresented as being the original software.                             *
-*                                                                               *
-* 3. This notice may not be removed or altered from any source distribution.    *
-*                                                                               *
-********************************************************************************/
-
-// Libraries
-#include <reactphysics3d/collision/narrowphase/SphereVsSphereAlgorithm.h>
-#include <reactphysics3d/collision/shapes/SphereShape.h>
-#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
-
-// We want to use the ReactPhysics3D namespace
-using namespace reactphysics3d;  
-
-bool SphereVsSphereAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& /*memoryAllocator*/) {
-
-    bool isCollisionFound = false;
-
-    // For each item in the batch
-    for (uint32 batchIndex = batchStartIndex; batchIndex < batchStartIndex + batchNbItems; batchIndex++) {
-
-        assert(narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].nbContactPoints == 0);
-        assert(!narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].isColliding);
-
-        // Get the local-space to world-space transforms
-        const Transform& transform1 = narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].shape1ToWorldTransform;
-        const Transform& transform2 = narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].shape2ToWorldTransform;
-
-        // Compute the distance between the centers
-        Vector3 vectorBetweenCenters = transform2.getPosition() - transform1.getPosition();
-        decimal squaredDistanceBetweenCenters = vectorBetweenCenters.lengthSquare();
-
-        const SphereShape* sphereShape1 = static_cast<SphereShape*>(narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape1);
-        const SphereShape* sphereShape2 = static_cast<SphereShape*>(narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].collisionShape2);
-
-        const decimal sphere1Radius = sphereShape1->getRadius();
-        const decimal sphere2Radius = sphereShape2->getRadius();
-
-        // Compute the sum of the radius
-        const decimal sumRadiuses = sphere1Radius + sphere2Radius;
-
-        // Compute the product of the sum of the radius
-        const decimal sumRadiusesProducts = sumRadiuses * sumRadiuses;
-
-        // If the sphere collision shapes intersect
-        if (squaredDistanceBetweenCenters < sumRadiusesProducts) {
-
-            const decimal penetrationDepth = sumRadiuses - std::sqrt(squaredDistanceBetweenCenters);
-
-            // Make sure the penetration depth is not zero (even if the previous condition test was true the penetration depth can still be
-            // zero because of precision issue of the computation at the previous line)
-            if (penetrationDepth > 0) {
-
-                // If we need to report contacts
-                if (narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].reportContacts) {
-
-                    const Transform transform1Inverse = transform1.getInverse();
-                    const Transform transform2Inverse = transform2.getInverse();
-
-                    Vector3 intersectionOnBody1;
-                    Vector3 intersectionOnBody2;
-                    Vector3 normal;
-
-                    // If the two sphere centers are not at the same position
-                    if (squaredDistanceBetweenCenters > MACHINE_EPSILON) {
-
-                        const Vector3 centerSphere2InBody1LocalSpace = transform1Inverse * transform2.getPosition();
-                        const Vector3 centerSphere1InBody2LocalSpace = transform2Inverse * transform1.getPosition();
-
-                        intersectionOnBody1 = sphere1Radius * centerSphere2InBody1LocalSpace.getUnit();
-                        intersectionOnBody2 = sphere2Radius * centerSphere1InBody2LocalSpace.getUnit();
-                        normal = vectorBetweenCenters.getUnit();
-                    }
-                    else {    // If the sphere centers are at the same position (degenerate case)
-
-                        // Take any contact normal direction
-                        normal.setAllValues(0, 1, 0);
-
-                        intersectionOnBody1 = sphere1Radius * (transform1Inverse.getOrientation() * normal);
-                        intersectionOnBody2 = sphere2Radius * (transform2Inverse.getOrientation() * normal);
-                    }
-
-                    // Create the contact info object
-                    narrowPhaseInfoBatch.addContactPoint(batchIndex, normal, penetrationDepth, intersectionOnBody1, intersectionOnBody2);
-                }
-
-                narrowPhaseInfoBatch.narrowPhaseInfos[batchIndex].isColliding = true;
-                isCollisionFound = true;
-            }
-        }
-    }
-
-    return isCollisionFound;
-}
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/collision/narrowphase/SphereVsSphereAlgorithm.h>
+#include <reactphysics3d/collision/shapes/SphereShape.h>
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
+#include <reactphysics3d/mathematics/Simd.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;  
+
+// Compute the narrow-phase collision detection between two spheres
+bool SphereVsSphereAlgorithm::testCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchStartIndex, uint32 batchNbItems, MemoryAllocator& /*memoryAllocator*/) {
+
+    bool isCollisionFound = false;
+
+    const uint32 batchEndIndex = batchStartIndex + batchNbItems;
+    uint32 batchIndex = batchStartIndex;
+
+#ifdef RP3D_USE_SIMD
+
+    // Test the items four at a time and only compute the contacts of the colliding items
+    for (; batchIndex + SIMD_WIDTH <= batchEndIndex; batchIndex += SIMD_WIDTH) {
+
+        const uint32 collidingMask = computeCollidingMask(narrowPhaseInfoBatch, batchIndex);
+
+        for (uint32 i=0; i < SIMD_WIDTH; i++) {
+
+            if ((collidingMask & (1 << i)) != 0) {
+                isCollisionFound |= testItemCollision(narrowPhaseInfoBatch, batchIndex + i);
+            }
+#ifdef IS_RP3D_SIMD_VALIDATION_ENABLED
+            else if (testItemCollision(narrowPhaseInfoBatch, batchIndex + i)) {
+
+                // The SIMD test must give exactly the same result as the scalar test
+                assert(false);
+                isCollisionFound = true;
+            }
+#endif
+        }
+    }
+
+#endif
+
+    // Test the remaining items
+    for (; batchIndex < batchEndIndex; batchIndex++) {
+        isCollisionFound |= testItemCollision(narrowPhaseInfoBatch, batchIndex);
+    }
+
+    return isCollisionFound;
+}
+
+// Compute the narrow-phase collision detection of a single item of the batch
+bool SphereVsSphereAlgorithm::testItemCollision(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex) {
+
+    assert(narrowPhaseInfoBatch.nbContactPoints[batchIndex] == 0);
+    assert(!narrowPhaseInfoBatch.isColliding[batchIndex]);
+
+    // Get the local-space to world-space transforms
+    const Transform& transform1 = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex];
+    const Transform& transform2 = narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex];
+
+    // Compute the distance between the centers
+    Vector3 vectorBetweenCenters = transform2.getPosition() - transform1.getPosition();
+    decimal squaredDistanceBetweenCenters = vectorBetweenCenters.lengthSquare();
+
+    const SphereShape* sphereShape1 = static_cast<SphereShape*>(narrowPhaseInfoBatch.collisionShapes1[batchIndex]);
+    const SphereShape* sphereShape2 = static_cast<SphereShape*>(narrowPhaseInfoBatch.collisionShapes2[batchIndex]);
+
+    const decimal sphere1Radius = sphereShape1->getRadius();
+    const decimal sphere2Radius = sphereShape2->getRadius();
+
+    // Compute the sum of the radius
+    const decimal sumRadiuses = sphere1Radius + sphere2Radius;
+
+    // Compute the product of the sum of the radius
+    const decimal sumRadiusesProducts = sumRadiuses * sumRadiuses;
+
+    // If the sphere collision shapes intersect
+    if (squaredDistanceBetweenCenters < sumRadiusesProducts) {
+
+        const decimal penetrationDepth = sumRadiuses - std::sqrt(squaredDistanceBetweenCenters);
+
+        // Make sure the penetration depth is not zero (even if the previous condition test was true the penetration depth can still be
+        // zero because of precision issue of the computation at the previous line)
+        if (penetrationDepth > 0) {
+
+            // If we need to report contacts
+            if (narrowPhaseInfoBatch.reportContacts[batchIndex]) {
+
+                const Transform transform1Inverse = transform1.getInverse();
+                const Transform transform2Inverse = transform2.getInverse();
+
+                Vector3 intersectionOnBody1;
+                Vector3 intersectionOnBody2;
+                Vector3 normal;
+
+                // If the two sphere centers are not at the same position
+                if (squaredDistanceBetweenCenters > MACHINE_EPSILON) {
+
+                    const Vector3 centerSphere2InBody1LocalSpace = transform1Inverse * transform2.getPosition();
+                    const Vector3 centerSphere1InBody2LocalSpace = transform2Inverse * transform1.getPosition();
+
+                    intersectionOnBody1 = sphere1Radius * centerSphere2InBody1LocalSpace.getUnit();
+                    intersectionOnBody2 = sphere2Radius * centerSphere1InBody2LocalSpace.getUnit();
+                    normal = vectorBetweenCenters.getUnit();
+                }
+                else {    // If the sphere centers are at the same position (degenerate case)
+
+                    // Take any contact normal direction
+                    normal.setAllValues(0, 1, 0);
+
+                    intersectionOnBody1 = sphere1Radius * (transform1Inverse.getOrientation() * normal);
+                    intersectionOnBody2 = sphere2Radius * (transform2Inverse.getOrientation() * normal);
+                }
+
+                // Create the contact info object
+                narrowPhaseInfoBatch.addContactPoint(batchIndex, normal, penetrationDepth, intersectionOnBody1, intersectionOnBody2);
+            }
+
+            narrowPhaseInfoBatch.isColliding[batchIndex] = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef RP3D_USE_SIMD
+
+// Return a mask where the bit i is set if the two spheres of the item (batchIndex + i) are colliding
+/// This method performs exactly the same operations as the testItemCollision() method on four items
+/// at a time. Therefore, it gives exactly the same results (this file is compiled without contraction
+/// of the operations into fused multiply-add).
+uint32 SphereVsSphereAlgorithm::computeCollidingMask(const NarrowPhaseInfoBatch& narrowPhaseInfoBatch, uint32 batchIndex) {
+
+    float position1X[SIMD_WIDTH], position1Y[SIMD_WIDTH], position1Z[SIMD_WIDTH];
+    float position2X[SIMD_WIDTH], position2Y[SIMD_WIDTH], position2Z[SIMD_WIDTH];
+    float radius1[SIMD_WIDTH], radius2[SIMD_WIDTH];
+
+    // Gather the data of the items
+    for (uint32 i=0; i < SIMD_WIDTH; i++) {
+
+        const Vector3& position1 = narrowPhaseInfoBatch.shape1ToWorldTransforms[batchIndex + i].getPosition();
+        const Vector3& position2 = narrowPhaseInfoBatch.shape2ToWorldTransforms[batchIndex + i].getPosition();
+
+        position1X[i] = position1.x;
+        position1Y[i] = position1.y;
+        position1Z[i] = position1.z;
+        position2X[i] = position2.x;
+        position2Y[i] = position2.y;
+        position2Z[i] = position2.z;
+
+        radius1[i] = static_cast<const SphereShape*>(narrowPhaseInfoBatch.collisionShapes1[batchIndex + i])->getRadius();
+        radius2[i] = static_cast<const SphereShape*>(narrowPhaseInfoBatch.collisionShapes2[batchIndex + i])->getRadius();
+    }
+
+    // Compute the distance between the centers
+    const SimdFloat4 vectorBetweenCentersX = simdLoad(position2X) - simdLoad(position1X);
+    const SimdFloat4 vectorBetweenCentersY = simdLoad(position2Y) - simdLoad(position1Y);
+    const SimdFloat4 vectorBetweenCentersZ = simdLoad(position2Z) - simdLoad(position1Z);
+    const SimdFloat4 squaredDistanceBetweenCenters = vectorBetweenCentersX * vectorBetweenCentersX +
+                                                     vectorBetweenCentersY * vectorBetweenCentersY +
+                                                     vectorBetweenCentersZ * vectorBetweenCentersZ;
+
+    // Compute the sum of the radius
+    const SimdFloat4 sumRadiuses = simdLoad(radius1) + simdLoad(radius2);
+
+    // Compute the penetration depth
+    const SimdFloat4 penetrationDepth = sumRadiuses - simdSqrt(squaredDistanceBetweenCenters);
+
+    // The spheres are colliding if they intersect and if the penetration depth is not zero
+    return simdMoveMask((squaredDistanceBetweenCenters < sumRadiuses * sumRadiuses) & (penetrationDepth > simdSet(0.0f)));
+}
+
+#endif
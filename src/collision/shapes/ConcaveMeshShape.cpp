@@ -35,19 +35,30 @@ using namespace reactphysics3d;
 
 // Constructor
 ConcaveMeshShape::ConcaveMeshShape(TriangleMesh* triangleMesh, MemoryAllocator& allocator, HalfEdgeStructure& triangleHalfEdgeStructure, const Vector3& scaling)
-                 : ConcaveShape(CollisionShapeName::TRIANGLE_MESH, allocator, scaling), mDynamicAABBTree(allocator), mTriangleHalfEdgeStructure(triangleHalfEdgeStructure) {
+                 : ConcaveShape(CollisionShapeName::TRIANGLE_MESH, allocator, scaling), mAABBTree(allocator), mTriangleHalfEdgeStructure(triangleHalfEdgeStructure) {
 
     mTriangleMesh = triangleMesh;
     mRaycastTestType = TriangleRaycastSide::FRONT;
 
-    // Insert all the triangles into the dynamic AABB tree
-    initBVHTree();
+    // Insert all the triangles into the AABB tree
+    initBVHTree(allocator);
 }
 
-// Insert all the triangles into the dynamic AABB tree
-void ConcaveMeshShape::initBVHTree() {
+// Build the AABB tree with all the triangles of the mesh
+/// All the triangles are added in bulk into a temporary dynamic AABB tree such that the tree
+/// is built with the surface area heuristic instead of inserting the triangles one by one.
+/// Since the mesh never changes, the tree is then copied into a compact wide tree and
+/// the dynamic AABB tree is released.
+void ConcaveMeshShape::initBVHTree(MemoryAllocator& allocator) {
 
-    // TODO : Try to randomly add the triangles into the tree to obtain a better tree
+    // Compute the total number of triangles of the mesh
+    uint32 nbTriangles = 0;
+    for (uint32 subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
+        nbTriangles += mTriangleMesh->getSubpart(subPart)->getNbTriangles();
+    }
+    if (nbTriangles == 0) return;
+
+    Array<AABB> aabbs(allocator, nbTriangles);
 
     // For each sub-part of the mesh
     for (uint32 subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
@@ -64,12 +75,27 @@ void ConcaveMeshShape::initBVHTree() {
             triangleVertexArray->getTriangleVertices(triangleIndex, trianglePoints);
 
             // Create the AABB for the triangle
-            AABB aabb = AABB::createAABBForTriangle(trianglePoints);
+            aabbs.add(AABB::createAABBForTriangle(trianglePoints));
+        }
+    }
 
-            // Add the AABB with the index of the triangle into the dynamic AABB tree
-            mDynamicAABBTree.addObject(aabb, subPart, triangleIndex);
+    Array<int32> nodeIds(allocator, nbTriangles);
+    nodeIds.addWithoutInit(nbTriangles);
+
+    // Add the AABBs of all the triangles into the dynamic AABB tree
+    DynamicAABBTree dynamicAABBTree(allocator);
+    dynamicAABBTree.addObjects(&(aabbs[0]), nbTriangles, &(nodeIds[0]));
+
+    // Store the sub-part and the index of its triangle in each leaf node of the tree
+    uint32 i = 0;
+    for (uint32 subPart=0; subPart<mTriangleMesh->getNbSubparts(); subPart++) {
+        for (uint32 triangleIndex=0; triangleIndex<mTriangleMesh->getSubpart(subPart)->getNbTriangles(); triangleIndex++) {
+            dynamicAABBTree.setNodeDataInt(nodeIds[i], subPart, triangleIndex);
+            i++;
         }
     }
+
+    mAABBTree.build(dynamicAABBTree);
 }
 
 // Return the three vertices coordinates (in the array outTriangleVertices) of a triangle
@@ -134,13 +160,13 @@ void ConcaveMeshShape::computeOverlappingTriangles(const AABB& localAABB, Array<
     RP3D_PROFILE("ConcaveMeshShape::computeOverlappingTriangles()", mProfiler);
 
     // Scale the input AABB with the inverse scale of the concave mesh (because
-    // we store the vertices without scale inside the dynamic AABB tree
+    // we store the vertices without scale inside the AABB tree
     AABB aabb(localAABB);
     aabb.applyScale(Vector3(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z));
 
     // Compute the nodes of the internal AABB tree that are overlapping with the AABB
     Array<int> overlappingNodes(allocator, 64);
-    mDynamicAABBTree.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+    mAABBTree.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
 
     const uint32 nbOverlappingNodes = static_cast<uint32>(overlappingNodes.size());
 
@@ -154,7 +180,7 @@ void ConcaveMeshShape::computeOverlappingTriangles(const AABB& localAABB, Array<
         int nodeId = overlappingNodes[i];
 
         // Get the node data (triangle index and mesh subpart index)
-        int32* data = mDynamicAABBTree.getNodeDataInt(nodeId);
+        const int32* data = mAABBTree.getNodeDataInt(nodeId);
 
         // Get the triangle vertices for this node from the concave mesh shape
         getTriangleVertices(data[0], data[1], &(triangleVertices[i * 3]));
@@ -175,12 +201,12 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collide
     RP3D_PROFILE("ConcaveMeshShape::raycast()", mProfiler);
 
     // Apply the concave mesh inverse scale factor because the mesh is stored without scaling
-    // inside the dynamic AABB tree
+    // inside the AABB tree
     const Vector3 inverseScale(decimal(1.0) / mScale.x, decimal(1.0) / mScale.y, decimal(1.0) / mScale.z);
     Ray scaledRay(ray.point1 * inverseScale, ray.point2 * inverseScale, ray.maxFraction);
 
     // Create the callback object that will compute ray casting against triangles
-    ConcaveMeshRaycastCallback raycastCallback(mDynamicAABBTree, *this, collider, raycastInfo, scaledRay, mScale, allocator);
+    ConcaveMeshRaycastCallback raycastCallback(mAABBTree, *this, collider, raycastInfo, scaledRay, mScale, allocator);
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -190,10 +216,10 @@ bool ConcaveMeshShape::raycast(const Ray& ray, RaycastInfo& raycastInfo, Collide
 
 #endif
 
-    // Ask the Dynamic AABB Tree to report all AABB nodes that are hit by the ray.
+    // Ask the AABB Tree to report all AABB nodes that are hit by the ray.
     // The raycastCallback object will then compute ray casting against the triangles
     // in the hit AABBs.
-    mDynamicAABBTree.raycast(scaledRay, raycastCallback);
+    mAABBTree.raycast(scaledRay, raycastCallback);
 
     raycastCallback.raycastTriangles();
 
@@ -236,7 +262,7 @@ void ConcaveMeshRaycastCallback::raycastTriangles() {
     for (it = mHitAABBNodes.begin(); it != mHitAABBNodes.end(); ++it) {
 
         // Get the node data (triangle index and mesh subpart index)
-        int32* data = mDynamicAABBTree.getNodeDataInt(*it);
+        const int32* data = mAABBTree.getNodeDataInt(*it);
 
         // Get the triangle vertices for this node from the concave mesh shape
         Vector3 trianglePoints[3];
@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/BallAndSocketJointComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <reactphysics3d/mathematics/Matrix3x3.h>
 #include <cassert>
@@ -152,7 +153,7 @@ void BallAndSocketJointComponents::addComponent(Entity jointEntity, bool isSleep
     new (mConeLimitACrossB + index) Vector3(0, 0, 0);
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity, index));
+    mMapEntityToComponentIndex.add(jointEntity, index);
 
     mNbComponents++;
 
@@ -192,7 +193,7 @@ void BallAndSocketJointComponents::moveComponentToIndex(uint32 srcIndex, uint32
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mJointEntities[destIndex]] == destIndex);
 }
@@ -246,7 +247,7 @@ void BallAndSocketJointComponents::swapComponents(uint32 index1, uint32 index2)
     new (mConeLimitACrossB + index2) Vector3(coneLimitAcrossB);
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity1, index2));
+    mMapEntityToComponentIndex.add(jointEntity1, index2);
 
     assert(mMapEntityToComponentIndex[mJointEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mJointEntities[index2]] == index2);
@@ -275,3 +276,70 @@ void BallAndSocketJointComponents::destroyComponent(uint32 index) {
     mImpulse[index].~Vector3();
     mConeLimitACrossB[index].~Vector3();
 }
+
+// Save the state of the components into a snapshot
+void BallAndSocketJointComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mJointEntities);
+
+    writer.writeValues(mLocalAnchorPointBody1, mNbComponents);
+    writer.writeValues(mLocalAnchorPointBody2, mNbComponents);
+    writer.writeValues(mR1World, mNbComponents);
+    writer.writeValues(mR2World, mNbComponents);
+    writer.writeValues(mI1, mNbComponents);
+    writer.writeValues(mI2, mNbComponents);
+    writer.writeValues(mBiasVector, mNbComponents);
+    writer.writeValues(mInverseMassMatrix, mNbComponents);
+    writer.writeValues(mImpulse, mNbComponents);
+    writer.writeValues(mIsConeLimitEnabled, mNbComponents);
+    writer.writeValues(mConeLimitImpulse, mNbComponents);
+    writer.writeValues(mConeLimitHalfAngle, mNbComponents);
+    writer.writeValues(mInverseMassMatrixConeLimit, mNbComponents);
+    writer.writeValues(mBConeLimit, mNbComponents);
+    writer.writeValues(mIsConeLimitViolated, mNbComponents);
+    writer.writeValues(mConeLimitACrossB, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void BallAndSocketJointComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.readValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.readValues(mR1World, mNbComponents);
+    reader.readValues(mR2World, mNbComponents);
+    reader.readValues(mI1, mNbComponents);
+    reader.readValues(mI2, mNbComponents);
+    reader.readValues(mBiasVector, mNbComponents);
+    reader.readValues(mInverseMassMatrix, mNbComponents);
+    reader.readValues(mImpulse, mNbComponents);
+    reader.readValues(mIsConeLimitEnabled, mNbComponents);
+    reader.readValues(mConeLimitImpulse, mNbComponents);
+    reader.readValues(mConeLimitHalfAngle, mNbComponents);
+    reader.readValues(mInverseMassMatrixConeLimit, mNbComponents);
+    reader.readValues(mBConeLimit, mNbComponents);
+    reader.readValues(mIsConeLimitViolated, mNbComponents);
+    reader.readValues(mConeLimitACrossB, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void BallAndSocketJointComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.skipValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.skipValues(mR1World, mNbComponents);
+    reader.skipValues(mR2World, mNbComponents);
+    reader.skipValues(mI1, mNbComponents);
+    reader.skipValues(mI2, mNbComponents);
+    reader.skipValues(mBiasVector, mNbComponents);
+    reader.skipValues(mInverseMassMatrix, mNbComponents);
+    reader.skipValues(mImpulse, mNbComponents);
+    reader.skipValues(mIsConeLimitEnabled, mNbComponents);
+    reader.skipValues(mConeLimitImpulse, mNbComponents);
+    reader.skipValues(mConeLimitHalfAngle, mNbComponents);
+    reader.skipValues(mInverseMassMatrixConeLimit, mNbComponents);
+    reader.skipValues(mBConeLimit, mNbComponents);
+    reader.skipValues(mIsConeLimitViolated, mNbComponents);
+    reader.skipValues(mConeLimitACrossB, mNbComponents);
+}
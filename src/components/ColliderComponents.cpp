@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/ColliderComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <reactphysics3d/collision/Collider.h>
 #include <cassert>
@@ -134,7 +135,7 @@ void ColliderComponents::addComponent(Entity colliderEntity, bool isSleeping, co
     mMaterials[index] = component.material;
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(colliderEntity, index));
+    mMapEntityToComponentIndex.add(colliderEntity, index);
 
     mNbComponents++;
 
@@ -168,7 +169,7 @@ void ColliderComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex)
     assert(!mMapEntityToComponentIndex.containsKey(colliderEntity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(colliderEntity, destIndex));
+    mMapEntityToComponentIndex.add(colliderEntity, destIndex);
 
     assert(mMapEntityToComponentIndex[mCollidersEntities[destIndex]] == destIndex);
 }
@@ -212,7 +213,7 @@ void ColliderComponents::swapComponents(uint32 index1, uint32 index2) {
     mMaterials[index2] = material;
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(colliderEntity1, index2));
+    mMapEntityToComponentIndex.add(colliderEntity1, index2);
 
     assert(mMapEntityToComponentIndex[mCollidersEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mCollidersEntities[index2]] == index2);
@@ -237,3 +238,104 @@ void ColliderComponents::destroyComponent(uint32 index) {
     mOverlappingPairs[index].~Array<uint64>();
     mMaterials[index].~Material();
 }
+
+// Save the state of the components into a snapshot
+void ColliderComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mCollidersEntities);
+
+    writer.writeValues(mBroadPhaseIds, mNbComponents);
+    writer.writeValues(mLocalToBodyTransforms, mNbComponents);
+    writer.writeValues(mCollisionCategoryBits, mNbComponents);
+    writer.writeValues(mCollideWithMaskBits, mNbComponents);
+    writer.writeValues(mLocalToWorldTransforms, mNbComponents);
+    writer.writeValues(mHasCollisionShapeChangedSize, mNbComponents);
+    writer.writeValues(mIsTrigger, mNbComponents);
+    writer.writeValues(mMaterials, mNbComponents);
+
+    // Overlapping pairs of each collider
+    for (uint32 i=0; i < mNbComponents; i++) {
+        writer.writeArray(mOverlappingPairs[i]);
+    }
+}
+
+// Restore the state of the components from a snapshot
+void ColliderComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mBroadPhaseIds, mNbComponents);
+    reader.readValues(mLocalToBodyTransforms, mNbComponents);
+    reader.readValues(mCollisionCategoryBits, mNbComponents);
+    reader.readValues(mCollideWithMaskBits, mNbComponents);
+    reader.readValues(mLocalToWorldTransforms, mNbComponents);
+    reader.readValues(mHasCollisionShapeChangedSize, mNbComponents);
+    reader.readValues(mIsTrigger, mNbComponents);
+    reader.readValues(mMaterials, mNbComponents);
+
+    // Overlapping pairs of each collider
+    for (uint32 i=0; i < mNbComponents; i++) {
+        reader.readArray(mOverlappingPairs[i]);
+    }
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void ColliderComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mBroadPhaseIds, mNbComponents);
+    reader.skipValues(mLocalToBodyTransforms, mNbComponents);
+    reader.skipValues(mCollisionCategoryBits, mNbComponents);
+    reader.skipValues(mCollideWithMaskBits, mNbComponents);
+    reader.skipValues(mLocalToWorldTransforms, mNbComponents);
+    reader.skipValues(mHasCollisionShapeChangedSize, mNbComponents);
+    reader.skipValues(mIsTrigger, mNbComponents);
+    reader.skipValues(mMaterials, mNbComponents);
+
+    // Overlapping pairs of each collider
+    for (uint32 i=0; i < mNbComponents; i++) {
+        reader.skipArray(mOverlappingPairs[i]);
+    }
+}
+
+// Save only the state of the components that changes during the simulation into a snapshot
+void ColliderComponents::saveDynamicState(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mCollidersEntities);
+
+    writer.writeValues(mBroadPhaseIds, mNbComponents);
+    writer.writeValues(mLocalToWorldTransforms, mNbComponents);
+    writer.writeValues(mHasCollisionShapeChangedSize, mNbComponents);
+
+    // Overlapping pairs of each collider
+    for (uint32 i=0; i < mNbComponents; i++) {
+        writer.writeArray(mOverlappingPairs[i]);
+    }
+}
+
+// Restore the state of the components saved with the saveDynamicState() method
+void ColliderComponents::restoreDynamicState(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mBroadPhaseIds, mNbComponents);
+    reader.readValues(mLocalToWorldTransforms, mNbComponents);
+    reader.readValues(mHasCollisionShapeChangedSize, mNbComponents);
+
+    // Overlapping pairs of each collider
+    for (uint32 i=0; i < mNbComponents; i++) {
+        reader.readArray(mOverlappingPairs[i]);
+    }
+}
+
+// Skip the data of the components that follows their entities in a snapshot of the dynamic state
+void ColliderComponents::skipDynamicState(SnapshotReader& reader) const {
+
+    reader.skipValues(mBroadPhaseIds, mNbComponents);
+    reader.skipValues(mLocalToWorldTransforms, mNbComponents);
+    reader.skipValues(mHasCollisionShapeChangedSize, mNbComponents);
+
+    // Overlapping pairs of each collider
+    for (uint32 i=0; i < mNbComponents; i++) {
+        reader.skipArray(mOverlappingPairs[i]);
+    }
+}
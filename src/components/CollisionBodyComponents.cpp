@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/CollisionBodyComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <cassert>
 #include <random>
@@ -97,7 +98,7 @@ void CollisionBodyComponents::addComponent(Entity bodyEntity, bool isSleeping, c
     mUserData[index] = nullptr;
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(bodyEntity, index));
+    mMapEntityToComponentIndex.add(bodyEntity, index);
 
     mNbComponents++;
 
@@ -124,7 +125,7 @@ void CollisionBodyComponents::moveComponentToIndex(uint32 srcIndex, uint32 destI
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mBodiesEntities[destIndex]] == destIndex);
 }
@@ -152,7 +153,7 @@ void CollisionBodyComponents::swapComponents(uint32 index1, uint32 index2) {
     mUserData[index2] = userData1;
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity1, index2));
+    mMapEntityToComponentIndex.add(entity1, index2);
 
     assert(mMapEntityToComponentIndex[mBodiesEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mBodiesEntities[index2]] == index2);
@@ -173,3 +174,25 @@ void CollisionBodyComponents::destroyComponent(uint32 index) {
     mColliders[index].~Array<Entity>();
     mUserData[index] = nullptr;
 }
+
+// Save the state of the components into a snapshot
+void CollisionBodyComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mBodiesEntities);
+
+    writer.writeValues(mIsActive, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void CollisionBodyComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mIsActive, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void CollisionBodyComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mIsActive, mNbComponents);
+}
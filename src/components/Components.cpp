@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/Components.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <cassert>
 
 // We want to use the ReactPhysics3D namespace
@@ -91,6 +92,23 @@ uint32 Components::prepareAddComponent(bool isSleeping) {
     return index;
 }
 
+// Allocate memory for at least a given number of components
+/// This is used to avoid growing the arrays several times when many components are added
+void Components::reserve(uint32 nbComponents) {
+
+    if (nbComponents > mNbAllocatedComponents) {
+
+        // The allocate() method only releases the previous memory if it contains components
+        if (mNbComponents == 0 && mBuffer != nullptr) {
+            mMemoryAllocator.release(mBuffer, mNbAllocatedComponents * mComponentDataSize);
+            mBuffer = nullptr;
+            mNbAllocatedComponents = 0;
+        }
+
+        allocate(nbComponents);
+    }
+}
+
 // Destroy a component at a given index
 void Components::destroyComponent(uint32 index) {
 
@@ -185,3 +203,95 @@ void Components::setIsEntityDisabled(Entity entity, bool isDisabled) {
     assert(mDisabledStartIndex <= mNbComponents);
     assert(mNbComponents == static_cast<uint32>(mMapEntityToComponentIndex.size()));
 }
+
+// Write the number of components and their entities into a snapshot
+void Components::saveEntitiesToSnapshot(SnapshotWriter& writer, const Entity* entities) const {
+
+    writer.writeValue(mNbComponents);
+    writer.writeValue(mDisabledStartIndex);
+    writer.writeValues(entities, mNbComponents);
+}
+
+// Return true if a snapshot of the components contains exactly the same entities and valid data
+/// Nothing is modified. Therefore, all the sections of a snapshot can be checked before restoring any of them.
+/**
+ * @param reader Reader of the snapshot section of the components (it is read by copy)
+ * @param isDynamicStateOnly True if the section has been saved with the saveDynamicState() method
+ * @return True if the components have the same entities as the snapshot and the section has the expected size
+ */
+bool Components::canRestoreSnapshot(SnapshotReader reader, bool isDynamicStateOnly) const {
+
+    uint32 nbComponents = 0;
+    uint32 disabledStartIndex = 0;
+    reader.readValue(nbComponents);
+    reader.readValue(disabledStartIndex);
+
+    if (!reader.isValid() || nbComponents != mNbComponents || disabledStartIndex > nbComponents) {
+        return false;
+    }
+
+    // Since the entities of the snapshot are all different, they are the same
+    // entities as the components if each of them has a component
+    for (uint32 i=0; i < nbComponents; i++) {
+
+        Entity entity(0, 0);
+        reader.readValue(entity);
+        if (!reader.isValid() || !hasComponent(entity)) {
+            return false;
+        }
+    }
+
+    // The data of the components must fill the rest of the section
+    if (isDynamicStateOnly) {
+        skipDynamicState(reader);
+    }
+    else {
+        skipSnapshot(reader);
+    }
+
+    return reader.isValid() && reader.isAtEnd();
+}
+
+// Read the entities of a snapshot and reorder the components in the same order
+/// The canRestoreSnapshot() method must have been called to check that the snapshot
+/// contains the same entities as the components.
+void Components::restoreEntitiesFromSnapshot(SnapshotReader& reader) {
+
+    uint32 nbComponents = 0;
+    reader.readValue(nbComponents);
+    reader.readValue(mDisabledStartIndex);
+
+    assert(nbComponents == mNbComponents);
+
+    // Move each component at the index of its entity in the snapshot. The components
+    // before the index i are already at their final location.
+    for (uint32 i=0; i < nbComponents; i++) {
+
+        Entity entity(0, 0);
+        reader.readValue(entity);
+
+        const uint32 index = mMapEntityToComponentIndex[entity];
+        assert(index >= i);
+        if (index != i) {
+            swapComponents(i, index);
+        }
+    }
+
+    assert(mDisabledStartIndex <= mNbComponents);
+}
+
+// Save only the state of the components that changes during the simulation into a snapshot
+/// By default, all the state of the components is saved
+void Components::saveDynamicState(SnapshotWriter& writer) const {
+    saveSnapshot(writer);
+}
+
+// Restore the state of the components saved with the saveDynamicState() method
+void Components::restoreDynamicState(SnapshotReader& reader) {
+    restoreSnapshot(reader);
+}
+
+// Skip the data of the components that follows their entities in a snapshot of the dynamic state
+void Components::skipDynamicState(SnapshotReader& reader) const {
+    skipSnapshot(reader);
+}
@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/FixedJointComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <reactphysics3d/mathematics/Matrix3x3.h>
 #include <cassert>
@@ -140,7 +141,7 @@ void FixedJointComponents::addComponent(Entity jointEntity, bool isSleeping, con
     new (mInitOrientationDifferenceInv + index) Quaternion(0, 0, 0, 0);
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity, index));
+    mMapEntityToComponentIndex.add(jointEntity, index);
 
     mNbComponents++;
 
@@ -177,7 +178,7 @@ void FixedJointComponents::moveComponentToIndex(uint32 srcIndex, uint32 destInde
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mJointEntities[destIndex]] == destIndex);
 }
@@ -225,7 +226,7 @@ void FixedJointComponents::swapComponents(uint32 index1, uint32 index2) {
     new (mInitOrientationDifferenceInv + index2) Quaternion(initOrientationDifferenceInv1);
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity1, index2));
+    mMapEntityToComponentIndex.add(jointEntity1, index2);
 
     assert(mMapEntityToComponentIndex[mJointEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mJointEntities[index2]] == index2);
@@ -257,3 +258,61 @@ void FixedJointComponents::destroyComponent(uint32 index) {
     mBiasRotation[index].~Vector3();
     mInitOrientationDifferenceInv[index].~Quaternion();
 }
+
+// Save the state of the components into a snapshot
+void FixedJointComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mJointEntities);
+
+    writer.writeValues(mLocalAnchorPointBody1, mNbComponents);
+    writer.writeValues(mLocalAnchorPointBody2, mNbComponents);
+    writer.writeValues(mR1World, mNbComponents);
+    writer.writeValues(mR2World, mNbComponents);
+    writer.writeValues(mI1, mNbComponents);
+    writer.writeValues(mI2, mNbComponents);
+    writer.writeValues(mImpulseTranslation, mNbComponents);
+    writer.writeValues(mImpulseRotation, mNbComponents);
+    writer.writeValues(mInverseMassMatrixTranslation, mNbComponents);
+    writer.writeValues(mInverseMassMatrixRotation, mNbComponents);
+    writer.writeValues(mBiasTranslation, mNbComponents);
+    writer.writeValues(mBiasRotation, mNbComponents);
+    writer.writeValues(mInitOrientationDifferenceInv, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void FixedJointComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.readValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.readValues(mR1World, mNbComponents);
+    reader.readValues(mR2World, mNbComponents);
+    reader.readValues(mI1, mNbComponents);
+    reader.readValues(mI2, mNbComponents);
+    reader.readValues(mImpulseTranslation, mNbComponents);
+    reader.readValues(mImpulseRotation, mNbComponents);
+    reader.readValues(mInverseMassMatrixTranslation, mNbComponents);
+    reader.readValues(mInverseMassMatrixRotation, mNbComponents);
+    reader.readValues(mBiasTranslation, mNbComponents);
+    reader.readValues(mBiasRotation, mNbComponents);
+    reader.readValues(mInitOrientationDifferenceInv, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void FixedJointComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.skipValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.skipValues(mR1World, mNbComponents);
+    reader.skipValues(mR2World, mNbComponents);
+    reader.skipValues(mI1, mNbComponents);
+    reader.skipValues(mI2, mNbComponents);
+    reader.skipValues(mImpulseTranslation, mNbComponents);
+    reader.skipValues(mImpulseRotation, mNbComponents);
+    reader.skipValues(mInverseMassMatrixTranslation, mNbComponents);
+    reader.skipValues(mInverseMassMatrixRotation, mNbComponents);
+    reader.skipValues(mBiasTranslation, mNbComponents);
+    reader.skipValues(mBiasRotation, mNbComponents);
+    reader.skipValues(mInitOrientationDifferenceInv, mNbComponents);
+}
@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/HingeJointComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <reactphysics3d/mathematics/Matrix3x3.h>
 #include <cassert>
@@ -225,7 +226,7 @@ void HingeJointComponents::addComponent(Entity jointEntity, bool isSleeping, con
     mMaxMotorTorque[index] = component.maxMotorTorque;
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity, index));
+    mMapEntityToComponentIndex.add(jointEntity, index);
 
     mNbComponents++;
 
@@ -282,7 +283,7 @@ void HingeJointComponents::moveComponentToIndex(uint32 srcIndex, uint32 destInde
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mJointEntities[destIndex]] == destIndex);
 }
@@ -370,7 +371,7 @@ void HingeJointComponents::swapComponents(uint32 index1, uint32 index2) {
     mMaxMotorTorque[index2] = maxMotorTorque;
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity1, index2));
+    mMapEntityToComponentIndex.add(jointEntity1, index2);
 
     assert(mMapEntityToComponentIndex[mJointEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mJointEntities[index2]] == index2);
@@ -407,3 +408,121 @@ void HingeJointComponents::destroyComponent(uint32 index) {
     mB2CrossA1[index].~Vector3();
     mC2CrossA1[index].~Vector3();
 }
+
+// Save the state of the components into a snapshot
+void HingeJointComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mJointEntities);
+
+    writer.writeValues(mLocalAnchorPointBody1, mNbComponents);
+    writer.writeValues(mLocalAnchorPointBody2, mNbComponents);
+    writer.writeValues(mR1World, mNbComponents);
+    writer.writeValues(mR2World, mNbComponents);
+    writer.writeValues(mI1, mNbComponents);
+    writer.writeValues(mI2, mNbComponents);
+    writer.writeValues(mImpulseTranslation, mNbComponents);
+    writer.writeValues(mImpulseRotation, mNbComponents);
+    writer.writeValues(mInverseMassMatrixTranslation, mNbComponents);
+    writer.writeValues(mInverseMassMatrixRotation, mNbComponents);
+    writer.writeValues(mBiasTranslation, mNbComponents);
+    writer.writeValues(mBiasRotation, mNbComponents);
+    writer.writeValues(mInitOrientationDifferenceInv, mNbComponents);
+    writer.writeValues(mHingeLocalAxisBody1, mNbComponents);
+    writer.writeValues(mHingeLocalAxisBody2, mNbComponents);
+    writer.writeValues(mA1, mNbComponents);
+    writer.writeValues(mB2CrossA1, mNbComponents);
+    writer.writeValues(mC2CrossA1, mNbComponents);
+    writer.writeValues(mImpulseLowerLimit, mNbComponents);
+    writer.writeValues(mImpulseUpperLimit, mNbComponents);
+    writer.writeValues(mImpulseMotor, mNbComponents);
+    writer.writeValues(mInverseMassMatrixLimitMotor, mNbComponents);
+    writer.writeValues(mInverseMassMatrixMotor, mNbComponents);
+    writer.writeValues(mBLowerLimit, mNbComponents);
+    writer.writeValues(mBUpperLimit, mNbComponents);
+    writer.writeValues(mIsLimitEnabled, mNbComponents);
+    writer.writeValues(mIsMotorEnabled, mNbComponents);
+    writer.writeValues(mLowerLimit, mNbComponents);
+    writer.writeValues(mUpperLimit, mNbComponents);
+    writer.writeValues(mIsLowerLimitViolated, mNbComponents);
+    writer.writeValues(mIsUpperLimitViolated, mNbComponents);
+    writer.writeValues(mMotorSpeed, mNbComponents);
+    writer.writeValues(mMaxMotorTorque, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void HingeJointComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.readValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.readValues(mR1World, mNbComponents);
+    reader.readValues(mR2World, mNbComponents);
+    reader.readValues(mI1, mNbComponents);
+    reader.readValues(mI2, mNbComponents);
+    reader.readValues(mImpulseTranslation, mNbComponents);
+    reader.readValues(mImpulseRotation, mNbComponents);
+    reader.readValues(mInverseMassMatrixTranslation, mNbComponents);
+    reader.readValues(mInverseMassMatrixRotation, mNbComponents);
+    reader.readValues(mBiasTranslation, mNbComponents);
+    reader.readValues(mBiasRotation, mNbComponents);
+    reader.readValues(mInitOrientationDifferenceInv, mNbComponents);
+    reader.readValues(mHingeLocalAxisBody1, mNbComponents);
+    reader.readValues(mHingeLocalAxisBody2, mNbComponents);
+    reader.readValues(mA1, mNbComponents);
+    reader.readValues(mB2CrossA1, mNbComponents);
+    reader.readValues(mC2CrossA1, mNbComponents);
+    reader.readValues(mImpulseLowerLimit, mNbComponents);
+    reader.readValues(mImpulseUpperLimit, mNbComponents);
+    reader.readValues(mImpulseMotor, mNbComponents);
+    reader.readValues(mInverseMassMatrixLimitMotor, mNbComponents);
+    reader.readValues(mInverseMassMatrixMotor, mNbComponents);
+    reader.readValues(mBLowerLimit, mNbComponents);
+    reader.readValues(mBUpperLimit, mNbComponents);
+    reader.readValues(mIsLimitEnabled, mNbComponents);
+    reader.readValues(mIsMotorEnabled, mNbComponents);
+    reader.readValues(mLowerLimit, mNbComponents);
+    reader.readValues(mUpperLimit, mNbComponents);
+    reader.readValues(mIsLowerLimitViolated, mNbComponents);
+    reader.readValues(mIsUpperLimitViolated, mNbComponents);
+    reader.readValues(mMotorSpeed, mNbComponents);
+    reader.readValues(mMaxMotorTorque, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void HingeJointComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.skipValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.skipValues(mR1World, mNbComponents);
+    reader.skipValues(mR2World, mNbComponents);
+    reader.skipValues(mI1, mNbComponents);
+    reader.skipValues(mI2, mNbComponents);
+    reader.skipValues(mImpulseTranslation, mNbComponents);
+    reader.skipValues(mImpulseRotation, mNbComponents);
+    reader.skipValues(mInverseMassMatrixTranslation, mNbComponents);
+    reader.skipValues(mInverseMassMatrixRotation, mNbComponents);
+    reader.skipValues(mBiasTranslation, mNbComponents);
+    reader.skipValues(mBiasRotation, mNbComponents);
+    reader.skipValues(mInitOrientationDifferenceInv, mNbComponents);
+    reader.skipValues(mHingeLocalAxisBody1, mNbComponents);
+    reader.skipValues(mHingeLocalAxisBody2, mNbComponents);
+    reader.skipValues(mA1, mNbComponents);
+    reader.skipValues(mB2CrossA1, mNbComponents);
+    reader.skipValues(mC2CrossA1, mNbComponents);
+    reader.skipValues(mImpulseLowerLimit, mNbComponents);
+    reader.skipValues(mImpulseUpperLimit, mNbComponents);
+    reader.skipValues(mImpulseMotor, mNbComponents);
+    reader.skipValues(mInverseMassMatrixLimitMotor, mNbComponents);
+    reader.skipValues(mInverseMassMatrixMotor, mNbComponents);
+    reader.skipValues(mBLowerLimit, mNbComponents);
+    reader.skipValues(mBUpperLimit, mNbComponents);
+    reader.skipValues(mIsLimitEnabled, mNbComponents);
+    reader.skipValues(mIsMotorEnabled, mNbComponents);
+    reader.skipValues(mLowerLimit, mNbComponents);
+    reader.skipValues(mUpperLimit, mNbComponents);
+    reader.skipValues(mIsLowerLimitViolated, mNbComponents);
+    reader.skipValues(mIsUpperLimitViolated, mNbComponents);
+    reader.skipValues(mMotorSpeed, mNbComponents);
+    reader.skipValues(mMaxMotorTorque, mNbComponents);
+}
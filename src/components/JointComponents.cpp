@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/JointComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <cassert>
 
@@ -109,7 +110,7 @@ void JointComponents::addComponent(Entity jointEntity, bool isSleeping, const Jo
     mIsAlreadyInIsland[index] = false;
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity, index));
+    mMapEntityToComponentIndex.add(jointEntity, index);
 
     mNbComponents++;
 
@@ -139,7 +140,7 @@ void JointComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex) {
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mJointEntities[destIndex]] == destIndex);
 }
@@ -173,7 +174,7 @@ void JointComponents::swapComponents(uint32 index1, uint32 index2) {
     mIsAlreadyInIsland[index2] = isAlreadyInIsland;
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity1, index2));
+    mMapEntityToComponentIndex.add(jointEntity1, index2);
 
     assert(mMapEntityToComponentIndex[mJointEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mJointEntities[index2]] == index2);
@@ -194,3 +195,34 @@ void JointComponents::destroyComponent(uint32 index) {
     mBody2Entities[index].~Entity();
     mJoints[index] = nullptr;
 }
+
+// Save the state of the components into a snapshot
+void JointComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mJointEntities);
+
+    writer.writeValues(mTypes, mNbComponents);
+    writer.writeValues(mPositionCorrectionTechniques, mNbComponents);
+    writer.writeValues(mIsCollisionEnabled, mNbComponents);
+    writer.writeValues(mIsAlreadyInIsland, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void JointComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mTypes, mNbComponents);
+    reader.readValues(mPositionCorrectionTechniques, mNbComponents);
+    reader.readValues(mIsCollisionEnabled, mNbComponents);
+    reader.readValues(mIsAlreadyInIsland, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void JointComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mTypes, mNbComponents);
+    reader.skipValues(mPositionCorrectionTechniques, mNbComponents);
+    reader.skipValues(mIsCollisionEnabled, mNbComponents);
+    reader.skipValues(mIsAlreadyInIsland, mNbComponents);
+}
@@ -25,7 +25,9 @@
 
 // Libraries
 #include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
+#include <reactphysics3d/engine/IslandGraph.h>
 #include <reactphysics3d/body/RigidBody.h>
 #include <cassert>
 #include <random>
@@ -42,7 +44,7 @@ RigidBodyComponents::RigidBodyComponents(MemoryAllocator& allocator)
                                 sizeof(decimal) + sizeof(decimal) + sizeof(Vector3) +
                                 sizeof(Vector3) + + sizeof(Matrix3x3) + sizeof(Vector3) + sizeof(Vector3) +
                                 sizeof(Vector3) + sizeof(Vector3) + sizeof(Vector3) +
-                                sizeof(Quaternion) + sizeof(Vector3) + sizeof(Vector3) +
+                                sizeof(Quaternion) + sizeof(Vector3) + sizeof(Vector3) + sizeof(uint32) +
                                 sizeof(bool) + sizeof(bool) + sizeof(Array<Entity>) + sizeof(Array<uint>) +
                                 sizeof(Vector3) + sizeof(Vector3)) {
 
@@ -88,7 +90,8 @@ void RigidBodyComponents::allocate(uint32 nbComponentsToAllocate) {
     Quaternion* newConstrainedOrientations = reinterpret_cast<Quaternion*>(newConstrainedPositions + nbComponentsToAllocate);
     Vector3* newCentersOfMassLocal = reinterpret_cast<Vector3*>(newConstrainedOrientations + nbComponentsToAllocate);
     Vector3* newCentersOfMassWorld = reinterpret_cast<Vector3*>(newCentersOfMassLocal + nbComponentsToAllocate);
-    bool* newIsGravityEnabled = reinterpret_cast<bool*>(newCentersOfMassWorld + nbComponentsToAllocate);
+    uint32* newIslandIds = reinterpret_cast<uint32*>(newCentersOfMassWorld + nbComponentsToAllocate);
+    bool* newIsGravityEnabled = reinterpret_cast<bool*>(newIslandIds + nbComponentsToAllocate);
     bool* newIsAlreadyInIsland = reinterpret_cast<bool*>(newIsGravityEnabled + nbComponentsToAllocate);
     Array<Entity>* newJoints = reinterpret_cast<Array<Entity>*>(newIsAlreadyInIsland + nbComponentsToAllocate);
     Array<uint>* newContactPairs = reinterpret_cast<Array<uint>*>(newJoints + nbComponentsToAllocate);
@@ -124,6 +127,7 @@ void RigidBodyComponents::allocate(uint32 nbComponentsToAllocate) {
         memcpy(newConstrainedOrientations, mConstrainedOrientations, mNbComponents * sizeof(Quaternion));
         memcpy(newCentersOfMassLocal, mCentersOfMassLocal, mNbComponents * sizeof(Vector3));
         memcpy(newCentersOfMassWorld, mCentersOfMassWorld, mNbComponents * sizeof(Vector3));
+        memcpy(newIslandIds, mIslandIds, mNbComponents * sizeof(uint32));
         memcpy(newIsGravityEnabled, mIsGravityEnabled, mNbComponents * sizeof(bool));
         memcpy(newIsAlreadyInIsland, mIsAlreadyInIsland, mNbComponents * sizeof(bool));
         memcpy(newJoints, mJoints, mNbComponents * sizeof(Array<Entity>));
@@ -162,6 +166,7 @@ void RigidBodyComponents::allocate(uint32 nbComponentsToAllocate) {
     mConstrainedOrientations = newConstrainedOrientations;
     mCentersOfMassLocal = newCentersOfMassLocal;
     mCentersOfMassWorld = newCentersOfMassWorld;
+    mIslandIds = newIslandIds;
     mIsGravityEnabled = newIsGravityEnabled;
     mIsAlreadyInIsland = newIsAlreadyInIsland;
     mJoints = newJoints;
@@ -202,6 +207,7 @@ void RigidBodyComponents::addComponent(Entity bodyEntity, bool isSleeping, const
     new (mConstrainedOrientations + index) Quaternion(0, 0, 0, 1);
     new (mCentersOfMassLocal + index) Vector3(0, 0, 0);
     new (mCentersOfMassWorld + index) Vector3(component.worldPosition);
+    mIslandIds[index] = IslandGraph::INVALID_ISLAND_ID;
     mIsGravityEnabled[index] = true;
     mIsAlreadyInIsland[index] = false;
     new (mJoints + index) Array<Entity>(mMemoryAllocator);
@@ -210,7 +216,7 @@ void RigidBodyComponents::addComponent(Entity bodyEntity, bool isSleeping, const
     new (mAngularLockAxisFactors + index) Vector3(1, 1, 1);
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(bodyEntity, index));
+    mMapEntityToComponentIndex.add(bodyEntity, index);
 
     mNbComponents++;
 
@@ -250,6 +256,7 @@ void RigidBodyComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex
     new (mConstrainedOrientations + destIndex) Quaternion(mConstrainedOrientations[srcIndex]);
     new (mCentersOfMassLocal + destIndex) Vector3(mCentersOfMassLocal[srcIndex]);
     new (mCentersOfMassWorld + destIndex) Vector3(mCentersOfMassWorld[srcIndex]);
+    mIslandIds[destIndex] = mIslandIds[srcIndex];
     mIsGravityEnabled[destIndex] = mIsGravityEnabled[srcIndex];
     mIsAlreadyInIsland[destIndex] = mIsAlreadyInIsland[srcIndex];
     new (mJoints + destIndex) Array<Entity>(mJoints[srcIndex]);
@@ -263,7 +270,7 @@ void RigidBodyComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mBodiesEntities[destIndex]] == destIndex);
 }
@@ -297,6 +304,7 @@ void RigidBodyComponents::swapComponents(uint32 index1, uint32 index2) {
     Quaternion constrainedOrientation1 = mConstrainedOrientations[index1];
     Vector3 centerOfMassLocal1 = mCentersOfMassLocal[index1];
     Vector3 centerOfMassWorld1 = mCentersOfMassWorld[index1];
+    uint32 islandId1 = mIslandIds[index1];
     bool isGravityEnabled1 = mIsGravityEnabled[index1];
     bool isAlreadyInIsland1 = mIsAlreadyInIsland[index1];
     Array<Entity> joints1 = mJoints[index1];
@@ -335,6 +343,7 @@ void RigidBodyComponents::swapComponents(uint32 index1, uint32 index2) {
     mConstrainedOrientations[index2] = constrainedOrientation1;
     mCentersOfMassLocal[index2] = centerOfMassLocal1;
     mCentersOfMassWorld[index2] = centerOfMassWorld1;
+    mIslandIds[index2] = islandId1;
     mIsGravityEnabled[index2] = isGravityEnabled1;
     mIsAlreadyInIsland[index2] = isAlreadyInIsland1;
     new (mJoints + index2) Array<Entity>(joints1);
@@ -343,7 +352,7 @@ void RigidBodyComponents::swapComponents(uint32 index1, uint32 index2) {
     new (mAngularLockAxisFactors + index2) Vector3(angularLockAxisFactor1);
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity1, index2));
+    mMapEntityToComponentIndex.add(entity1, index2);
 
     assert(mMapEntityToComponentIndex[mBodiesEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mBodiesEntities[index2]] == index2);
@@ -381,3 +390,161 @@ void RigidBodyComponents::destroyComponent(uint32 index) {
     mLinearLockAxisFactors[index].~Vector3();
     mAngularLockAxisFactors[index].~Vector3();
 }
+
+// Save the state of the components into a snapshot
+void RigidBodyComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mBodiesEntities);
+
+    writer.writeValues(mIsAllowedToSleep, mNbComponents);
+    writer.writeValues(mIsSleeping, mNbComponents);
+    writer.writeValues(mSleepTimes, mNbComponents);
+    writer.writeValues(mBodyTypes, mNbComponents);
+    writer.writeValues(mLinearVelocities, mNbComponents);
+    writer.writeValues(mAngularVelocities, mNbComponents);
+    writer.writeValues(mExternalForces, mNbComponents);
+    writer.writeValues(mExternalTorques, mNbComponents);
+    writer.writeValues(mLinearDampings, mNbComponents);
+    writer.writeValues(mAngularDampings, mNbComponents);
+    writer.writeValues(mMasses, mNbComponents);
+    writer.writeValues(mInverseMasses, mNbComponents);
+    writer.writeValues(mLocalInertiaTensors, mNbComponents);
+    writer.writeValues(mInverseInertiaTensorsLocal, mNbComponents);
+    writer.writeValues(mInverseInertiaTensorsWorld, mNbComponents);
+    writer.writeValues(mConstrainedLinearVelocities, mNbComponents);
+    writer.writeValues(mConstrainedAngularVelocities, mNbComponents);
+    writer.writeValues(mSplitLinearVelocities, mNbComponents);
+    writer.writeValues(mSplitAngularVelocities, mNbComponents);
+    writer.writeValues(mConstrainedPositions, mNbComponents);
+    writer.writeValues(mConstrainedOrientations, mNbComponents);
+    writer.writeValues(mCentersOfMassLocal, mNbComponents);
+    writer.writeValues(mCentersOfMassWorld, mNbComponents);
+    writer.writeValues(mIsGravityEnabled, mNbComponents);
+    writer.writeValues(mIsAlreadyInIsland, mNbComponents);
+    writer.writeValues(mLinearLockAxisFactors, mNbComponents);
+    writer.writeValues(mAngularLockAxisFactors, mNbComponents);
+
+    // Joints of each body
+    for (uint32 i=0; i < mNbComponents; i++) {
+        writer.writeArray(mJoints[i]);
+    }
+}
+
+// Restore the state of the components from a snapshot
+void RigidBodyComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mIsAllowedToSleep, mNbComponents);
+    reader.readValues(mIsSleeping, mNbComponents);
+    reader.readValues(mSleepTimes, mNbComponents);
+    reader.readValues(mBodyTypes, mNbComponents);
+    reader.readValues(mLinearVelocities, mNbComponents);
+    reader.readValues(mAngularVelocities, mNbComponents);
+    reader.readValues(mExternalForces, mNbComponents);
+    reader.readValues(mExternalTorques, mNbComponents);
+    reader.readValues(mLinearDampings, mNbComponents);
+    reader.readValues(mAngularDampings, mNbComponents);
+    reader.readValues(mMasses, mNbComponents);
+    reader.readValues(mInverseMasses, mNbComponents);
+    reader.readValues(mLocalInertiaTensors, mNbComponents);
+    reader.readValues(mInverseInertiaTensorsLocal, mNbComponents);
+    reader.readValues(mInverseInertiaTensorsWorld, mNbComponents);
+    reader.readValues(mConstrainedLinearVelocities, mNbComponents);
+    reader.readValues(mConstrainedAngularVelocities, mNbComponents);
+    reader.readValues(mSplitLinearVelocities, mNbComponents);
+    reader.readValues(mSplitAngularVelocities, mNbComponents);
+    reader.readValues(mConstrainedPositions, mNbComponents);
+    reader.readValues(mConstrainedOrientations, mNbComponents);
+    reader.readValues(mCentersOfMassLocal, mNbComponents);
+    reader.readValues(mCentersOfMassWorld, mNbComponents);
+    reader.readValues(mIsGravityEnabled, mNbComponents);
+    reader.readValues(mIsAlreadyInIsland, mNbComponents);
+    reader.readValues(mLinearLockAxisFactors, mNbComponents);
+    reader.readValues(mAngularLockAxisFactors, mNbComponents);
+
+    // Joints of each body
+    for (uint32 i=0; i < mNbComponents; i++) {
+        reader.readArray(mJoints[i]);
+    }
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void RigidBodyComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mIsAllowedToSleep, mNbComponents);
+    reader.skipValues(mIsSleeping, mNbComponents);
+    reader.skipValues(mSleepTimes, mNbComponents);
+    reader.skipValues(mBodyTypes, mNbComponents);
+    reader.skipValues(mLinearVelocities, mNbComponents);
+    reader.skipValues(mAngularVelocities, mNbComponents);
+    reader.skipValues(mExternalForces, mNbComponents);
+    reader.skipValues(mExternalTorques, mNbComponents);
+    reader.skipValues(mLinearDampings, mNbComponents);
+    reader.skipValues(mAngularDampings, mNbComponents);
+    reader.skipValues(mMasses, mNbComponents);
+    reader.skipValues(mInverseMasses, mNbComponents);
+    reader.skipValues(mLocalInertiaTensors, mNbComponents);
+    reader.skipValues(mInverseInertiaTensorsLocal, mNbComponents);
+    reader.skipValues(mInverseInertiaTensorsWorld, mNbComponents);
+    reader.skipValues(mConstrainedLinearVelocities, mNbComponents);
+    reader.skipValues(mConstrainedAngularVelocities, mNbComponents);
+    reader.skipValues(mSplitLinearVelocities, mNbComponents);
+    reader.skipValues(mSplitAngularVelocities, mNbComponents);
+    reader.skipValues(mConstrainedPositions, mNbComponents);
+    reader.skipValues(mConstrainedOrientations, mNbComponents);
+    reader.skipValues(mCentersOfMassLocal, mNbComponents);
+    reader.skipValues(mCentersOfMassWorld, mNbComponents);
+    reader.skipValues(mIsGravityEnabled, mNbComponents);
+    reader.skipValues(mIsAlreadyInIsland, mNbComponents);
+    reader.skipValues(mLinearLockAxisFactors, mNbComponents);
+    reader.skipValues(mAngularLockAxisFactors, mNbComponents);
+
+    // Joints of each body
+    for (uint32 i=0; i < mNbComponents; i++) {
+        reader.skipArray(mJoints[i]);
+    }
+}
+
+// Save only the state of the components that changes during the simulation into a snapshot
+void RigidBodyComponents::saveDynamicState(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mBodiesEntities);
+
+    writer.writeValues(mIsSleeping, mNbComponents);
+    writer.writeValues(mSleepTimes, mNbComponents);
+    writer.writeValues(mLinearVelocities, mNbComponents);
+    writer.writeValues(mAngularVelocities, mNbComponents);
+    writer.writeValues(mExternalForces, mNbComponents);
+    writer.writeValues(mExternalTorques, mNbComponents);
+    writer.writeValues(mInverseInertiaTensorsWorld, mNbComponents);
+    writer.writeValues(mCentersOfMassWorld, mNbComponents);
+}
+
+// Restore the state of the components saved with the saveDynamicState() method
+void RigidBodyComponents::restoreDynamicState(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mIsSleeping, mNbComponents);
+    reader.readValues(mSleepTimes, mNbComponents);
+    reader.readValues(mLinearVelocities, mNbComponents);
+    reader.readValues(mAngularVelocities, mNbComponents);
+    reader.readValues(mExternalForces, mNbComponents);
+    reader.readValues(mExternalTorques, mNbComponents);
+    reader.readValues(mInverseInertiaTensorsWorld, mNbComponents);
+    reader.readValues(mCentersOfMassWorld, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot of the dynamic state
+void RigidBodyComponents::skipDynamicState(SnapshotReader& reader) const {
+
+    reader.skipValues(mIsSleeping, mNbComponents);
+    reader.skipValues(mSleepTimes, mNbComponents);
+    reader.skipValues(mLinearVelocities, mNbComponents);
+    reader.skipValues(mAngularVelocities, mNbComponents);
+    reader.skipValues(mExternalForces, mNbComponents);
+    reader.skipValues(mExternalTorques, mNbComponents);
+    reader.skipValues(mInverseInertiaTensorsWorld, mNbComponents);
+    reader.skipValues(mCentersOfMassWorld, mNbComponents);
+}
@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/SliderJointComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <reactphysics3d/mathematics/Matrix3x3.h>
 #include <cassert>
@@ -247,7 +248,7 @@ void SliderJointComponents::addComponent(Entity jointEntity, bool isSleeping, co
     new (mR1PlusUCrossSliderAxis + index) Vector3(0, 0, 0);
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity, index));
+    mMapEntityToComponentIndex.add(jointEntity, index);
 
     mNbComponents++;
 
@@ -309,7 +310,7 @@ void SliderJointComponents::moveComponentToIndex(uint32 srcIndex, uint32 destInd
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mJointEntities[destIndex]] == destIndex);
 }
@@ -407,7 +408,7 @@ void SliderJointComponents::swapComponents(uint32 index1, uint32 index2) {
     new (mR1PlusUCrossSliderAxis + index2) Vector3(r1PlusUCrossSliderAxis);
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(jointEntity1, index2));
+    mMapEntityToComponentIndex.add(jointEntity1, index2);
 
     assert(mMapEntityToComponentIndex[mJointEntities[index1]] == index1);
     assert(mMapEntityToComponentIndex[mJointEntities[index2]] == index2);
@@ -449,3 +450,136 @@ void SliderJointComponents::destroyComponent(uint32 index) {
     mR1PlusUCrossN2[index].~Vector3();
     mR1PlusUCrossSliderAxis[index].~Vector3();
 }
+
+// Save the state of the components into a snapshot
+void SliderJointComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mJointEntities);
+
+    writer.writeValues(mLocalAnchorPointBody1, mNbComponents);
+    writer.writeValues(mLocalAnchorPointBody2, mNbComponents);
+    writer.writeValues(mI1, mNbComponents);
+    writer.writeValues(mI2, mNbComponents);
+    writer.writeValues(mImpulseTranslation, mNbComponents);
+    writer.writeValues(mImpulseRotation, mNbComponents);
+    writer.writeValues(mInverseMassMatrixTranslation, mNbComponents);
+    writer.writeValues(mInverseMassMatrixRotation, mNbComponents);
+    writer.writeValues(mBiasTranslation, mNbComponents);
+    writer.writeValues(mBiasRotation, mNbComponents);
+    writer.writeValues(mInitOrientationDifferenceInv, mNbComponents);
+    writer.writeValues(mSliderAxisBody1, mNbComponents);
+    writer.writeValues(mSliderAxisWorld, mNbComponents);
+    writer.writeValues(mR1, mNbComponents);
+    writer.writeValues(mR2, mNbComponents);
+    writer.writeValues(mN1, mNbComponents);
+    writer.writeValues(mN2, mNbComponents);
+    writer.writeValues(mImpulseLowerLimit, mNbComponents);
+    writer.writeValues(mImpulseUpperLimit, mNbComponents);
+    writer.writeValues(mImpulseMotor, mNbComponents);
+    writer.writeValues(mInverseMassMatrixLimit, mNbComponents);
+    writer.writeValues(mInverseMassMatrixMotor, mNbComponents);
+    writer.writeValues(mBLowerLimit, mNbComponents);
+    writer.writeValues(mBUpperLimit, mNbComponents);
+    writer.writeValues(mIsLimitEnabled, mNbComponents);
+    writer.writeValues(mIsMotorEnabled, mNbComponents);
+    writer.writeValues(mLowerLimit, mNbComponents);
+    writer.writeValues(mUpperLimit, mNbComponents);
+    writer.writeValues(mIsLowerLimitViolated, mNbComponents);
+    writer.writeValues(mIsUpperLimitViolated, mNbComponents);
+    writer.writeValues(mMotorSpeed, mNbComponents);
+    writer.writeValues(mMaxMotorForce, mNbComponents);
+    writer.writeValues(mR2CrossN1, mNbComponents);
+    writer.writeValues(mR2CrossN2, mNbComponents);
+    writer.writeValues(mR2CrossSliderAxis, mNbComponents);
+    writer.writeValues(mR1PlusUCrossN1, mNbComponents);
+    writer.writeValues(mR1PlusUCrossN2, mNbComponents);
+    writer.writeValues(mR1PlusUCrossSliderAxis, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void SliderJointComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.readValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.readValues(mI1, mNbComponents);
+    reader.readValues(mI2, mNbComponents);
+    reader.readValues(mImpulseTranslation, mNbComponents);
+    reader.readValues(mImpulseRotation, mNbComponents);
+    reader.readValues(mInverseMassMatrixTranslation, mNbComponents);
+    reader.readValues(mInverseMassMatrixRotation, mNbComponents);
+    reader.readValues(mBiasTranslation, mNbComponents);
+    reader.readValues(mBiasRotation, mNbComponents);
+    reader.readValues(mInitOrientationDifferenceInv, mNbComponents);
+    reader.readValues(mSliderAxisBody1, mNbComponents);
+    reader.readValues(mSliderAxisWorld, mNbComponents);
+    reader.readValues(mR1, mNbComponents);
+    reader.readValues(mR2, mNbComponents);
+    reader.readValues(mN1, mNbComponents);
+    reader.readValues(mN2, mNbComponents);
+    reader.readValues(mImpulseLowerLimit, mNbComponents);
+    reader.readValues(mImpulseUpperLimit, mNbComponents);
+    reader.readValues(mImpulseMotor, mNbComponents);
+    reader.readValues(mInverseMassMatrixLimit, mNbComponents);
+    reader.readValues(mInverseMassMatrixMotor, mNbComponents);
+    reader.readValues(mBLowerLimit, mNbComponents);
+    reader.readValues(mBUpperLimit, mNbComponents);
+    reader.readValues(mIsLimitEnabled, mNbComponents);
+    reader.readValues(mIsMotorEnabled, mNbComponents);
+    reader.readValues(mLowerLimit, mNbComponents);
+    reader.readValues(mUpperLimit, mNbComponents);
+    reader.readValues(mIsLowerLimitViolated, mNbComponents);
+    reader.readValues(mIsUpperLimitViolated, mNbComponents);
+    reader.readValues(mMotorSpeed, mNbComponents);
+    reader.readValues(mMaxMotorForce, mNbComponents);
+    reader.readValues(mR2CrossN1, mNbComponents);
+    reader.readValues(mR2CrossN2, mNbComponents);
+    reader.readValues(mR2CrossSliderAxis, mNbComponents);
+    reader.readValues(mR1PlusUCrossN1, mNbComponents);
+    reader.readValues(mR1PlusUCrossN2, mNbComponents);
+    reader.readValues(mR1PlusUCrossSliderAxis, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void SliderJointComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mLocalAnchorPointBody1, mNbComponents);
+    reader.skipValues(mLocalAnchorPointBody2, mNbComponents);
+    reader.skipValues(mI1, mNbComponents);
+    reader.skipValues(mI2, mNbComponents);
+    reader.skipValues(mImpulseTranslation, mNbComponents);
+    reader.skipValues(mImpulseRotation, mNbComponents);
+    reader.skipValues(mInverseMassMatrixTranslation, mNbComponents);
+    reader.skipValues(mInverseMassMatrixRotation, mNbComponents);
+    reader.skipValues(mBiasTranslation, mNbComponents);
+    reader.skipValues(mBiasRotation, mNbComponents);
+    reader.skipValues(mInitOrientationDifferenceInv, mNbComponents);
+    reader.skipValues(mSliderAxisBody1, mNbComponents);
+    reader.skipValues(mSliderAxisWorld, mNbComponents);
+    reader.skipValues(mR1, mNbComponents);
+    reader.skipValues(mR2, mNbComponents);
+    reader.skipValues(mN1, mNbComponents);
+    reader.skipValues(mN2, mNbComponents);
+    reader.skipValues(mImpulseLowerLimit, mNbComponents);
+    reader.skipValues(mImpulseUpperLimit, mNbComponents);
+    reader.skipValues(mImpulseMotor, mNbComponents);
+    reader.skipValues(mInverseMassMatrixLimit, mNbComponents);
+    reader.skipValues(mInverseMassMatrixMotor, mNbComponents);
+    reader.skipValues(mBLowerLimit, mNbComponents);
+    reader.skipValues(mBUpperLimit, mNbComponents);
+    reader.skipValues(mIsLimitEnabled, mNbComponents);
+    reader.skipValues(mIsMotorEnabled, mNbComponents);
+    reader.skipValues(mLowerLimit, mNbComponents);
+    reader.skipValues(mUpperLimit, mNbComponents);
+    reader.skipValues(mIsLowerLimitViolated, mNbComponents);
+    reader.skipValues(mIsUpperLimitViolated, mNbComponents);
+    reader.skipValues(mMotorSpeed, mNbComponents);
+    reader.skipValues(mMaxMotorForce, mNbComponents);
+    reader.skipValues(mR2CrossN1, mNbComponents);
+    reader.skipValues(mR2CrossN2, mNbComponents);
+    reader.skipValues(mR2CrossSliderAxis, mNbComponents);
+    reader.skipValues(mR1PlusUCrossN1, mNbComponents);
+    reader.skipValues(mR1PlusUCrossN2, mNbComponents);
+    reader.skipValues(mR1PlusUCrossSliderAxis, mNbComponents);
+}
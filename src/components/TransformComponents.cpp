@@ -25,6 +25,7 @@
 
 // Libraries
 #include <reactphysics3d/components/TransformComponents.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/EntityManager.h>
 #include <cassert>
 #include <random>
@@ -35,7 +36,7 @@ using namespace reactphysics3d;
 
 // Constructor
 TransformComponents::TransformComponents(MemoryAllocator& allocator)
-                    :Components(allocator, sizeof(Entity) + sizeof(Transform)) {
+                    :Components(allocator, sizeof(Entity) + sizeof(Transform) + sizeof(bool)) {
 
     // Allocate memory for the components data
     allocate(INIT_NB_ALLOCATED_COMPONENTS);
@@ -56,6 +57,7 @@ void TransformComponents::allocate(uint32 nbComponentsToAllocate) {
     // New pointers to components data
     Entity* newEntities = static_cast<Entity*>(newBuffer);
     Transform* newTransforms = reinterpret_cast<Transform*>(newEntities + nbComponentsToAllocate);
+    bool* newHasTransformChanged = reinterpret_cast<bool*>(newTransforms + nbComponentsToAllocate);
 
     // If there was already components before
     if (mNbComponents > 0) {
@@ -63,6 +65,7 @@ void TransformComponents::allocate(uint32 nbComponentsToAllocate) {
         // Copy component data from the previous buffer to the new one
         memcpy(newTransforms, mTransforms, mNbComponents * sizeof(Transform));
         memcpy(newEntities, mBodies, mNbComponents * sizeof(Entity));
+        memcpy(newHasTransformChanged, mHasTransformChanged, mNbComponents * sizeof(bool));
 
         // Deallocate previous memory
         mMemoryAllocator.release(mBuffer, mNbAllocatedComponents * mComponentDataSize);
@@ -71,6 +74,7 @@ void TransformComponents::allocate(uint32 nbComponentsToAllocate) {
     mBuffer = newBuffer;
     mBodies = newEntities;
     mTransforms = newTransforms;
+    mHasTransformChanged = newHasTransformChanged;
     mNbAllocatedComponents = nbComponentsToAllocate;
 }
 
@@ -83,9 +87,10 @@ void TransformComponents::addComponent(Entity bodyEntity, bool isSleeping, const
     // Insert the new component data
     new (mBodies + index) Entity(bodyEntity);
     new (mTransforms + index) Transform(component.transform);
+    mHasTransformChanged[index] = false;
 
     // Map the entity with the new component lookup index
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(bodyEntity, index));
+    mMapEntityToComponentIndex.add(bodyEntity, index);
 
     mNbComponents++;
 
@@ -102,6 +107,7 @@ void TransformComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex
     // Copy the data of the source component to the destination location
     new (mBodies + destIndex) Entity(mBodies[srcIndex]);
     new (mTransforms + destIndex) Transform(mTransforms[srcIndex]);
+    mHasTransformChanged[destIndex] = mHasTransformChanged[srcIndex];
 
     // Destroy the source component
     destroyComponent(srcIndex);
@@ -109,7 +115,7 @@ void TransformComponents::moveComponentToIndex(uint32 srcIndex, uint32 destIndex
     assert(!mMapEntityToComponentIndex.containsKey(entity));
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity, destIndex));
+    mMapEntityToComponentIndex.add(entity, destIndex);
 
     assert(mMapEntityToComponentIndex[mBodies[destIndex]] == destIndex);
 }
@@ -120,6 +126,7 @@ void TransformComponents::swapComponents(uint32 index1, uint32 index2) {
     // Copy component 1 data
     Entity entity1(mBodies[index1]);
     Transform transform1(mTransforms[index1]);
+    bool hasTransformChanged1 = mHasTransformChanged[index1];
 
     // Destroy component 1
     destroyComponent(index1);
@@ -129,9 +136,10 @@ void TransformComponents::swapComponents(uint32 index1, uint32 index2) {
     // Reconstruct component 1 at component 2 location
     new (mBodies + index2) Entity(entity1);
     new (mTransforms + index2) Transform(transform1);
+    mHasTransformChanged[index2] = hasTransformChanged1;
 
     // Update the entity to component index mapping
-    mMapEntityToComponentIndex.add(Pair<Entity, uint32>(entity1, index2));
+    mMapEntityToComponentIndex.add(entity1, index2);
 
     assert(mMapEntityToComponentIndex[mBodies[index1]] == index1);
     assert(mMapEntityToComponentIndex[mBodies[index2]] == index2);
@@ -150,3 +158,25 @@ void TransformComponents::destroyComponent(uint32 index) {
     mBodies[index].~Entity();
     mTransforms[index].~Transform();
 }
+
+// Save the state of the components into a snapshot
+void TransformComponents::saveSnapshot(SnapshotWriter& writer) const {
+
+    saveEntitiesToSnapshot(writer, mBodies);
+
+    writer.writeValues(mTransforms, mNbComponents);
+}
+
+// Restore the state of the components from a snapshot
+void TransformComponents::restoreSnapshot(SnapshotReader& reader) {
+
+    restoreEntitiesFromSnapshot(reader);
+
+    reader.readValues(mTransforms, mNbComponents);
+}
+
+// Skip the data of the components that follows their entities in a snapshot
+void TransformComponents::skipSnapshot(SnapshotReader& reader) const {
+
+    reader.skipValues(mTransforms, mNbComponents);
+}
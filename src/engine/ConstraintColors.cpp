@@ -0,0 +1,149 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/engine/ConstraintColors.h>
+#include <algorithm>
+
+using namespace reactphysics3d;
+
+// Constructor
+ConstraintColors::ConstraintColors(MemoryAllocator& allocator)
+                 :mConstraintColors(allocator), mSolverBodiesColors(allocator), constraints(allocator),
+                  colorsStartIndices(allocator), islandsColorsStartIndices(allocator), remainingConstraints(allocator),
+                  islandsRemainingConstraintsStartIndices(allocator) {
+
+}
+
+// Remove all the colors before coloring the islands of a new frame
+void ConstraintColors::reset(uint32 nbSolverBodies) {
+
+    constraints.clear();
+    colorsStartIndices.clear();
+    islandsColorsStartIndices.clear();
+    remainingConstraints.clear();
+    islandsRemainingConstraintsStartIndices.clear();
+
+    mSolverBodiesColors.clear();
+    mSolverBodiesColors.reserve(nbSolverBodies);
+    for (uint32 b=0; b < nbSolverBodies; b++) {
+        mSolverBodiesColors.add(0);
+    }
+}
+
+// Color the constraints of the next island
+/**
+ * @param startConstraintIndex Index of the first constraint of the island
+ * @param endConstraintIndex Index after the last constraint of the island
+ * @param solverBodies1Indices Index of the solver body of the first body of each constraint
+ * @param solverBodies2Indices Index of the solver body of the second body of each constraint
+ * @param solverBodiesTypes Type of each solver body
+ */
+void ConstraintColors::addIsland(uint32 startConstraintIndex, uint32 endConstraintIndex, const Array<uint32>& solverBodies1Indices,
+                                 const Array<uint32>& solverBodies2Indices, const Array<BodyType>& solverBodiesTypes) {
+
+    assert(startConstraintIndex <= endConstraintIndex);
+
+    islandsColorsStartIndices.add(static_cast<uint32>(colorsStartIndices.size()));
+    islandsRemainingConstraintsStartIndices.add(static_cast<uint32>(remainingConstraints.size()));
+
+    const uint32 nbConstraints = endConstraintIndex - startConstraintIndex;
+    mConstraintColors.clear();
+    mConstraintColors.reserve(nbConstraints);
+
+    uint32 nbConstraintsPerColor[NB_MAX_COLORS];
+    for (uint32 c=0; c < NB_MAX_COLORS; c++) {
+        nbConstraintsPerColor[c] = 0;
+    }
+    uint32 nbColors = 0;
+
+    // Give to each constraint the first color that is not used yet by its dynamic bodies (the
+    // solver never changes the velocities of static and kinematic bodies)
+    for (uint32 i=startConstraintIndex; i < endConstraintIndex; i++) {
+
+        const uint32 solverBody1Index = solverBodies1Indices[i];
+        const uint32 solverBody2Index = solverBodies2Indices[i];
+        const bool isBody1Dynamic = solverBodiesTypes[solverBody1Index] == BodyType::DYNAMIC;
+        const bool isBody2Dynamic = solverBodiesTypes[solverBody2Index] == BodyType::DYNAMIC;
+
+        uint32 usedColors = 0;
+        if (isBody1Dynamic) usedColors |= mSolverBodiesColors[solverBody1Index];
+        if (isBody2Dynamic) usedColors |= mSolverBodiesColors[solverBody2Index];
+
+        uint32 color = 0;
+        while (color < NB_MAX_COLORS && (usedColors & (uint32(1) << color)) != 0) {
+            color++;
+        }
+
+        if (color < NB_MAX_COLORS) {
+
+            if (isBody1Dynamic) mSolverBodiesColors[solverBody1Index] |= uint32(1) << color;
+            if (isBody2Dynamic) mSolverBodiesColors[solverBody2Index] |= uint32(1) << color;
+
+            nbConstraintsPerColor[color]++;
+            nbColors = std::max(nbColors, color + 1);
+        }
+        else {
+            remainingConstraints.add(i);
+        }
+
+        mConstraintColors.add(static_cast<uint8>(color));
+    }
+
+    // Compute the index of the first constraint of each color
+    uint32 colorsNextIndices[NB_MAX_COLORS];
+    uint32 constraintIndex = static_cast<uint32>(constraints.size());
+    for (uint32 c=0; c < nbColors; c++) {
+        colorsStartIndices.add(constraintIndex);
+        colorsNextIndices[c] = constraintIndex;
+        constraintIndex += nbConstraintsPerColor[c];
+    }
+
+    // Store the colored constraints sorted by color (and in their order inside a color)
+    constraints.addWithoutInit(constraintIndex - static_cast<uint32>(constraints.size()));
+    for (uint32 i=startConstraintIndex; i < endConstraintIndex; i++) {
+
+        const uint8 color = mConstraintColors[i - startConstraintIndex];
+        if (color < NB_MAX_COLORS) {
+            constraints[colorsNextIndices[color]] = i;
+            colorsNextIndices[color]++;
+        }
+    }
+}
+
+// Add the next island without coloring its constraints
+void ConstraintColors::addUncoloredIsland() {
+
+    islandsColorsStartIndices.add(static_cast<uint32>(colorsStartIndices.size()));
+    islandsRemainingConstraintsStartIndices.add(static_cast<uint32>(remainingConstraints.size()));
+}
+
+// Terminate the coloring once all the islands have been added
+void ConstraintColors::finish() {
+
+    colorsStartIndices.add(static_cast<uint32>(constraints.size()));
+    islandsColorsStartIndices.add(static_cast<uint32>(colorsStartIndices.size()) - 1);
+    islandsRemainingConstraintsStartIndices.add(static_cast<uint32>(remainingConstraints.size()));
+}
@@ -31,14 +31,15 @@
 #include <reactphysics3d/collision/narrowphase/NarrowPhaseAlgorithm.h>
 #include <reactphysics3d/collision/narrowphase/CollisionDispatch.h>
 #include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 
 using namespace reactphysics3d;
 
 // Constructor
 OverlappingPairs::OverlappingPairs(MemoryManager& memoryManager, ColliderComponents& colliderComponents,
                                    CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents, Set<bodypair> &noCollisionPairs, CollisionDispatch &collisionDispatch)
-                : mPoolAllocator(memoryManager.getPoolAllocator()), mHeapAllocator(memoryManager.getHeapAllocator()), mConvexPairs(memoryManager.getHeapAllocator()),
-                  mConcavePairs(memoryManager.getHeapAllocator()), mMapConvexPairIdToPairIndex(memoryManager.getHeapAllocator()), mMapConcavePairIdToPairIndex(memoryManager.getHeapAllocator()),
+                : mPoolAllocator(memoryManager.getPoolAllocator()), mConvexPairs(memoryManager.getHeapAllocator()),
+                  mConcavePairs(memoryManager.getHeapAllocator()), mPairSlots(memoryManager.getHeapAllocator()), mFreePairSlots(memoryManager.getHeapAllocator()),
                   mColliderComponents(colliderComponents), mCollisionBodyComponents(collisionBodyComponents),
                   mRigidBodyComponents(rigidBodyComponents), mNoCollisionPairs(noCollisionPairs), mCollisionDispatch(collisionDispatch) {
     
@@ -63,15 +64,10 @@ OverlappingPairs::~OverlappingPairs() {
 // Remove a component at a given index
 void OverlappingPairs::removePair(uint64 pairId) {
 
-    assert(mMapConvexPairIdToPairIndex.containsKey(pairId) || mMapConcavePairIdToPairIndex.containsKey(pairId));
+    const PairSlot* slot = getPairSlot(pairId);
+    assert(slot != nullptr);
 
-    auto it = mMapConvexPairIdToPairIndex.find(pairId);
-    if (it != mMapConvexPairIdToPairIndex.end()) {
-        removePair(it->second, true);
-    }
-    else {
-        removePair(mMapConcavePairIdToPairIndex[pairId], false);
-    }
+    removePair(slot->pairIndex, slot->isConvexVsConvex);
 }
 
 // Remove a component at a given index
@@ -91,13 +87,13 @@ void OverlappingPairs::removePair(uint64 pairIndex, bool isConvexVsConvex) {
         mColliderComponents.getOverlappingPairs(mConvexPairs[pairIndex].collider1).remove(mConvexPairs[pairIndex].pairID);
         mColliderComponents.getOverlappingPairs(mConvexPairs[pairIndex].collider2).remove(mConvexPairs[pairIndex].pairID);
 
-        assert(mMapConvexPairIdToPairIndex[mConvexPairs[pairIndex].pairID] == pairIndex);
-        mMapConvexPairIdToPairIndex.remove(mConvexPairs[pairIndex].pairID);
+        assert(getPairIndex(mConvexPairs[pairIndex].pairID) == pairIndex);
+        releasePairSlot(mConvexPairs[pairIndex].pairID);
 
         // Change the mapping between the pairId and the index in the convex pairs array if we swap the last item with the one to remove
         if (mConvexPairs.size() > 1 && pairIndex < (nbConvexPairs - 1)) {
 
-            mMapConvexPairIdToPairIndex[mConvexPairs[nbConvexPairs - 1].pairID] = pairIndex;
+            mPairSlots[static_cast<uint32>(mConvexPairs[nbConvexPairs - 1].pairID & 0xFFFFFFFF)].pairIndex = static_cast<uint32>(pairIndex);
         }
 
         // We want to keep the arrays tightly packed. Therefore, when a pair is removed,
@@ -116,8 +112,8 @@ void OverlappingPairs::removePair(uint64 pairIndex, bool isConvexVsConvex) {
         mColliderComponents.getOverlappingPairs(mConcavePairs[pairIndex].collider1).remove(mConcavePairs[pairIndex].pairID);
         mColliderComponents.getOverlappingPairs(mConcavePairs[pairIndex].collider2).remove(mConcavePairs[pairIndex].pairID);
 
-        assert(mMapConcavePairIdToPairIndex[mConcavePairs[pairIndex].pairID] == pairIndex);
-        mMapConcavePairIdToPairIndex.remove(mConcavePairs[pairIndex].pairID);
+        assert(getPairIndex(mConcavePairs[pairIndex].pairID) == pairIndex);
+        releasePairSlot(mConcavePairs[pairIndex].pairID);
 
         // Destroy all the LastFrameCollisionInfo objects
         mConcavePairs[pairIndex].destroyLastFrameCollisionInfos();
@@ -125,7 +121,7 @@ void OverlappingPairs::removePair(uint64 pairIndex, bool isConvexVsConvex) {
         // Change the mapping between the pairId and the index in the convex pairs array if we swap the last item with the one to remove
         if (mConcavePairs.size() > 1 && pairIndex < (nbConcavePairs - 1)) {
 
-            mMapConcavePairIdToPairIndex[mConcavePairs[nbConcavePairs - 1].pairID] = pairIndex;
+            mPairSlots[static_cast<uint32>(mConcavePairs[nbConcavePairs - 1].pairID & 0xFFFFFFFF)].pairIndex = static_cast<uint32>(pairIndex);
         }
 
         // We want to keep the arrays tightly packed. Therefore, when a pair is removed,
@@ -150,17 +146,15 @@ uint64 OverlappingPairs::addPair(uint32 collider1Index, uint32 collider2Index, b
     const uint32 broadPhase1Id = static_cast<uint32>(mColliderComponents.mBroadPhaseIds[collider1Index]);
     const uint32 broadPhase2Id = static_cast<uint32>(mColliderComponents.mBroadPhaseIds[collider2Index]);
 
-    // Compute a unique id for the overlapping pair
-    const uint64 pairId = pairNumbers(std::max(broadPhase1Id, broadPhase2Id), std::min(broadPhase1Id, broadPhase2Id));
+    uint64 pairId;
 
     // Select the narrow phase algorithm to use according to the two collision shapes
     if (isConvexVsConvex) {
 
-        assert(!mMapConvexPairIdToPairIndex.containsKey(pairId));
         NarrowPhaseAlgorithmType algorithmType = mCollisionDispatch.selectNarrowPhaseAlgorithm(collisionShape1->getType(), collisionShape2->getType());
 
-        // Map the entity with the new component lookup index
-        mMapConvexPairIdToPairIndex.add(Pair<uint64, uint64>(pairId, mConvexPairs.size()));
+        // Compute a unique id for the overlapping pair that maps to its index in the array
+        pairId = allocatePairSlot(static_cast<uint32>(mConvexPairs.size()), true);
 
         // Create and add a new convex pair
         mConvexPairs.emplace(pairId, broadPhase1Id, broadPhase2Id, collider1Entity, collider2Entity, algorithmType);
@@ -169,15 +163,14 @@ uint64 OverlappingPairs::addPair(uint32 collider1Index, uint32 collider2Index, b
 
         const bool isShape1Convex = collisionShape1->isConvex();
 
-        assert(!mMapConcavePairIdToPairIndex.containsKey(pairId));
         NarrowPhaseAlgorithmType algorithmType = mCollisionDispatch.selectNarrowPhaseAlgorithm(isShape1Convex ? collisionShape1->getType() : collisionShape2->getType(),
                                                                       CollisionShapeType::CONVEX_POLYHEDRON);
-        // Map the entity with the new component lookup index
-        mMapConcavePairIdToPairIndex.add(Pair<uint64, uint64>(pairId, mConcavePairs.size()));
+        // Compute a unique id for the overlapping pair that maps to its index in the array
+        pairId = allocatePairSlot(static_cast<uint32>(mConcavePairs.size()), false);
 
         // Create and add a new concave pair
         mConcavePairs.emplace(pairId, broadPhase1Id, broadPhase2Id, collider1Entity, collider2Entity, algorithmType,
-                              isShape1Convex, mPoolAllocator, mHeapAllocator);
+                              isShape1Convex, mPoolAllocator);
     }
 
     // Add the involved overlapping pair to the two colliders
@@ -189,6 +182,42 @@ uint64 OverlappingPairs::addPair(uint32 collider1Index, uint32 collider2Index, b
     return pairId;
 }
 
+// Allocate a slot for a new pair and return the id of the pair
+uint64 OverlappingPairs::allocatePairSlot(uint32 pairIndex, bool isConvexVsConvex) {
+
+    uint32 slotIndex;
+
+    // If there is a free slot, we reuse it
+    if (mFreePairSlots.size() > 0) {
+
+        slotIndex = mFreePairSlots[mFreePairSlots.size() - 1];
+        mFreePairSlots.removeAt(mFreePairSlots.size() - 1);
+
+        mPairSlots[slotIndex].pairIndex = pairIndex;
+        mPairSlots[slotIndex].isConvexVsConvex = isConvexVsConvex;
+    }
+    else {
+
+        slotIndex = static_cast<uint32>(mPairSlots.size());
+        mPairSlots.emplace(pairIndex, 0, isConvexVsConvex);
+    }
+
+    return (static_cast<uint64>(mPairSlots[slotIndex].generation) << 32) | slotIndex;
+}
+
+// Release the slot of a removed pair
+void OverlappingPairs::releasePairSlot(uint64 pairId) {
+
+    const uint32 slotIndex = static_cast<uint32>(pairId & 0xFFFFFFFF);
+    assert(getPairSlot(pairId) != nullptr);
+
+    // Change the generation of the slot so that the id of the removed pair becomes invalid
+    mPairSlots[slotIndex].generation++;
+    mPairSlots[slotIndex].pairIndex = INVALID_INDEX;
+
+    mFreePairSlots.add(slotIndex);
+}
+
 // Delete all the obsolete last frame collision info
 void OverlappingPairs::clearObsoleteLastFrameCollisionInfos() {
 
@@ -221,3 +250,171 @@ void OverlappingPairs::updateCollidingInPreviousFrame() {
         mConcavePairs[i].collidingInPreviousFrame = mConcavePairs[i].collidingInCurrentFrame;
     }
 }
+
+// Write the attributes of a pair into a snapshot
+void OverlappingPairs::savePairToSnapshot(SnapshotWriter& writer, const OverlappingPair& pair) {
+
+    writer.writeValue(pair.pairID);
+    writer.writeValue(pair.broadPhaseId1);
+    writer.writeValue(pair.broadPhaseId2);
+    writer.writeValue(pair.collider1);
+    writer.writeValue(pair.collider2);
+    writer.writeValue(pair.needToTestOverlap);
+    writer.writeValue(pair.narrowPhaseAlgorithmType);
+    writer.writeValue(pair.collidingInPreviousFrame);
+    writer.writeValue(pair.collidingInCurrentFrame);
+    writer.writeValue(pair.contactPairIndex);
+    writer.writeValue(pair.previousContactPairIndex);
+}
+
+// Read the attributes of a pair from a snapshot
+void OverlappingPairs::restorePairFromSnapshot(SnapshotReader& reader, OverlappingPair& pair) {
+
+    reader.readValue(pair.pairID);
+    reader.readValue(pair.broadPhaseId1);
+    reader.readValue(pair.broadPhaseId2);
+    reader.readValue(pair.collider1);
+    reader.readValue(pair.collider2);
+    reader.readValue(pair.needToTestOverlap);
+    reader.readValue(pair.narrowPhaseAlgorithmType);
+    reader.readValue(pair.collidingInPreviousFrame);
+    reader.readValue(pair.collidingInCurrentFrame);
+    reader.readValue(pair.contactPairIndex);
+    reader.readValue(pair.previousContactPairIndex);
+}
+
+// Skip the attributes of a pair in a snapshot
+void OverlappingPairs::skipPairFromSnapshot(SnapshotReader& reader) {
+
+    reader.skip(sizeof(OverlappingPair::pairID) + sizeof(OverlappingPair::broadPhaseId1) + sizeof(OverlappingPair::broadPhaseId2) +
+                sizeof(OverlappingPair::collider1) + sizeof(OverlappingPair::collider2) + sizeof(OverlappingPair::needToTestOverlap) +
+                sizeof(OverlappingPair::narrowPhaseAlgorithmType) + sizeof(OverlappingPair::collidingInPreviousFrame) +
+                sizeof(OverlappingPair::collidingInCurrentFrame) + sizeof(OverlappingPair::contactPairIndex) +
+                sizeof(OverlappingPair::previousContactPairIndex));
+}
+
+// Save the overlapping pairs and their temporal coherence data into a snapshot
+void OverlappingPairs::saveSnapshot(SnapshotWriter& writer) const {
+
+    // Convex vs convex pairs
+    const uint32 nbConvexPairs = static_cast<uint32>(mConvexPairs.size());
+    writer.writeValue(nbConvexPairs);
+    for (uint32 i=0; i < nbConvexPairs; i++) {
+
+        savePairToSnapshot(writer, mConvexPairs[i]);
+        writer.writeValue(mConvexPairs[i].lastFrameCollisionInfo);
+    }
+
+    // Convex vs concave pairs
+    const uint32 nbConcavePairs = static_cast<uint32>(mConcavePairs.size());
+    writer.writeValue(nbConcavePairs);
+    for (uint32 i=0; i < nbConcavePairs; i++) {
+
+        savePairToSnapshot(writer, mConcavePairs[i]);
+        writer.writeValue(mConcavePairs[i].isShape1Convex);
+
+        // Temporal coherence data of each overlapping triangle
+        writer.writeValue(static_cast<uint32>(mConcavePairs[i].lastFrameCollisionInfos.size()));
+        for (auto it = mConcavePairs[i].lastFrameCollisionInfos.begin(); it != mConcavePairs[i].lastFrameCollisionInfos.end(); ++it) {
+            writer.writeValue(it->first);
+            writer.writeValue(*(it->second));
+        }
+    }
+
+    // Slots of the pair ids
+    writer.writeArray(mPairSlots);
+    writer.writeArray(mFreePairSlots);
+}
+
+// Restore the overlapping pairs and their temporal coherence data from a snapshot
+/// The arrays of overlapping pairs of the colliders are restored with the colliders components
+void OverlappingPairs::restoreSnapshot(SnapshotReader& reader) {
+
+    // Convex vs convex pairs
+    mConvexPairs.clear();
+    uint32 nbConvexPairs = 0;
+    reader.readValue(nbConvexPairs);
+    for (uint32 i=0; i < nbConvexPairs && reader.isValid(); i++) {
+
+        mConvexPairs.emplace(0, 0, 0, Entity(0, 0), Entity(0, 0), NarrowPhaseAlgorithmType::None);
+        restorePairFromSnapshot(reader, mConvexPairs[i]);
+        reader.readValue(mConvexPairs[i].lastFrameCollisionInfo);
+    }
+
+    // Convex vs concave pairs. The current pairs are reused in order to keep the memory
+    // of their maps of temporal coherence data.
+    uint32 nbConcavePairs = 0;
+    reader.readValue(nbConcavePairs);
+    while (mConcavePairs.size() > nbConcavePairs) {
+
+        mConcavePairs[mConcavePairs.size() - 1].destroyLastFrameCollisionInfos();
+        mConcavePairs.removeAt(mConcavePairs.size() - 1);
+    }
+    for (uint32 i=0; i < nbConcavePairs && reader.isValid(); i++) {
+
+        if (i < mConcavePairs.size()) {
+            mConcavePairs[i].destroyLastFrameCollisionInfos();
+        }
+        else {
+            mConcavePairs.emplace(0, 0, 0, Entity(0, 0), Entity(0, 0), NarrowPhaseAlgorithmType::None, false,
+                                  mPoolAllocator);
+        }
+        ConcaveOverlappingPair& pair = mConcavePairs[i];
+        restorePairFromSnapshot(reader, pair);
+        reader.readValue(pair.isShape1Convex);
+
+        // Temporal coherence data of each overlapping triangle
+        uint32 nbLastFrameInfos = 0;
+        reader.readValue(nbLastFrameInfos);
+        for (uint32 j=0; j < nbLastFrameInfos && reader.isValid(); j++) {
+
+            uint64 shapesId = 0;
+            reader.readValue(shapesId);
+            LastFrameCollisionInfo* lastFrameInfo = new (mPoolAllocator.allocate(sizeof(LastFrameCollisionInfo))) LastFrameCollisionInfo();
+            reader.readValue(*lastFrameInfo);
+            pair.lastFrameCollisionInfos.add(Pair<uint64, LastFrameCollisionInfo*>(shapesId, lastFrameInfo));
+        }
+    }
+
+    // Slots of the pair ids
+    reader.readArray(mPairSlots);
+    reader.readArray(mFreePairSlots);
+}
+
+// Skip the overlapping pairs in a snapshot and return true if they can be restored
+/// The pairs are not modified
+bool OverlappingPairs::skipSnapshot(SnapshotReader& reader) const {
+
+    // Convex vs convex pairs
+    uint32 nbConvexPairs = 0;
+    reader.readValue(nbConvexPairs);
+    for (uint32 i=0; i < nbConvexPairs && reader.isValid(); i++) {
+
+        skipPairFromSnapshot(reader);
+        reader.skip(sizeof(LastFrameCollisionInfo));
+    }
+
+    // Convex vs concave pairs
+    uint32 nbConcavePairs = 0;
+    reader.readValue(nbConcavePairs);
+    for (uint32 i=0; i < nbConcavePairs && reader.isValid(); i++) {
+
+        skipPairFromSnapshot(reader);
+        reader.skip(sizeof(ConcaveOverlappingPair::isShape1Convex));
+
+        // Make sure that a corrupted number of triangles cannot allocate more than the remaining data
+        uint32 nbLastFrameInfos = 0;
+        reader.readValue(nbLastFrameInfos);
+        const uint64 lastFrameInfosSize = static_cast<uint64>(nbLastFrameInfos) * (sizeof(uint64) + sizeof(LastFrameCollisionInfo));
+        if (lastFrameInfosSize > reader.getNbRemainingBytes()) {
+            return false;
+        }
+        reader.skip(static_cast<size_t>(lastFrameInfosSize));
+    }
+
+    // Slots of the pair ids
+    reader.skipArray(mPairSlots);
+    reader.skipArray(mFreePairSlots);
+
+    return reader.isValid();
+}
@@ -43,6 +43,7 @@ PhysicsCommon::PhysicsCommon(MemoryAllocator* baseMemoryAllocator)
                 mHeightFieldShapes(mMemoryManager.getHeapAllocator()), mPolyhedronMeshes(mMemoryManager.getHeapAllocator()),
                 mTriangleMeshes(mMemoryManager.getHeapAllocator()),
                 mProfilers(mMemoryManager.getHeapAllocator()), mDefaultLoggers(mMemoryManager.getHeapAllocator()),
+                mDefaultTaskSchedulers(mMemoryManager.getHeapAllocator()),
                 mBoxShapeHalfEdgeStructure(mMemoryManager.getHeapAllocator(), 6, 8, 24),
                 mTriangleShapeHalfEdgeStructure(mMemoryManager.getHeapAllocator(), 2, 3, 6) {
 
@@ -190,6 +191,12 @@ void PhysicsCommon::release() {
     }
     mDefaultLoggers.clear();
 
+    // Destroy the default task schedulers
+    for (auto it = mDefaultTaskSchedulers.begin(); it != mDefaultTaskSchedulers.end(); ++it) {
+        deleteDefaultTaskScheduler(*it);
+    }
+    mDefaultTaskSchedulers.clear();
+
 // If profiling is enabled
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -677,6 +684,49 @@ void PhysicsCommon::deleteDefaultLogger(DefaultLogger* logger) {
    mMemoryManager.release(MemoryManager::AllocationType::Pool, logger, sizeof(DefaultLogger));
 }
 
+// Create and return a new default task scheduler
+/// The task scheduler can then be set to one or several physics worlds using
+/// the PhysicsWorld::setTaskScheduler() method.
+/**
+ * @param nbWorkers Total number of threads that will execute the tasks (including the thread
+ *                  calling PhysicsWorld::update()). If zero, the number of hardware threads is used.
+ * @return A pointer to the created default task scheduler
+ */
+DefaultTaskScheduler* PhysicsCommon::createDefaultTaskScheduler(uint32 nbWorkers) {
+
+    DefaultTaskScheduler* taskScheduler = new (mMemoryManager.allocate(MemoryManager::AllocationType::Pool, sizeof(DefaultTaskScheduler)))
+                                               DefaultTaskScheduler(mMemoryManager.getHeapAllocator(), nbWorkers);
+
+    mDefaultTaskSchedulers.add(taskScheduler);
+
+    return taskScheduler;
+}
+
+// Destroy a default task scheduler
+/// The task scheduler must not be used by a physics world anymore.
+/**
+ * @param taskScheduler A pointer to the default task scheduler to destroy
+ */
+void PhysicsCommon::destroyDefaultTaskScheduler(DefaultTaskScheduler* taskScheduler) {
+
+    deleteDefaultTaskScheduler(taskScheduler);
+
+    mDefaultTaskSchedulers.remove(taskScheduler);
+}
+
+// Delete a default task scheduler
+/**
+ * @param taskScheduler A pointer to the default task scheduler to destroy
+ */
+void PhysicsCommon::deleteDefaultTaskScheduler(DefaultTaskScheduler* taskScheduler) {
+
+   // Call the destructor of the task scheduler
+   taskScheduler->~DefaultTaskScheduler();
+
+   // Release allocated memory
+   mMemoryManager.release(MemoryManager::AllocationType::Pool, taskScheduler, sizeof(DefaultTaskScheduler));
+}
+
 // If profiling is enabled
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -35,6 +35,7 @@
 #include <reactphysics3d/engine/Island.h>
 #include <reactphysics3d/collision/ContactManifold.h>
 #include <reactphysics3d/containers/Stack.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 
 // Namespaces
 using namespace reactphysics3d;
@@ -57,6 +58,7 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, PhysicsCommon& physicsC
                            Profiler* /*profiler*/)
 #endif
               : mMemoryManager(memoryManager), mConfig(worldSettings), mEntityManager(mMemoryManager.getHeapAllocator()), mDebugRenderer(mMemoryManager.getHeapAllocator()),
+                mIsDebugRenderingEnabled(false),
                 mCollisionBodyComponents(mMemoryManager.getHeapAllocator()), mRigidBodyComponents(mMemoryManager.getHeapAllocator()),
                 mTransformComponents(mMemoryManager.getHeapAllocator()), mCollidersComponents(mMemoryManager.getHeapAllocator()),
                 mJointsComponents(mMemoryManager.getHeapAllocator()), mBallAndSocketJointsComponents(mMemoryManager.getHeapAllocator()),
@@ -64,10 +66,14 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, PhysicsCommon& physicsC
                 mSliderJointsComponents(mMemoryManager.getHeapAllocator()), mCollisionDetection(this, mCollidersComponents, mTransformComponents, mCollisionBodyComponents, mRigidBodyComponents,
                                         mMemoryManager, physicsCommon.mTriangleShapeHalfEdgeStructure),
                 mCollisionBodies(mMemoryManager.getHeapAllocator()), mEventListener(nullptr),
-                mName(worldSettings.worldName),  mIslands(mMemoryManager.getSingleFrameAllocator()), mProcessContactPairsOrderIslands(mMemoryManager.getSingleFrameAllocator()),
-                mContactSolverSystem(mMemoryManager, *this, mIslands, mCollisionBodyComponents, mRigidBodyComponents,
+                mName(worldSettings.worldName),  mIslands(mMemoryManager.getSingleFrameAllocator()),
+                mIslandGraph(mMemoryManager.getHeapAllocator()),
+                mSolverBodies(mMemoryManager.getHeapAllocator(), mIslands, mRigidBodyComponents, mJointsComponents),
+                mProcessContactPairsOrderIslands(mMemoryManager.getSingleFrameAllocator()),
+                mContactSolverSystem(mMemoryManager, *this, mIslands, mSolverBodies, mCollisionBodyComponents, mRigidBodyComponents,
                                mCollidersComponents, mConfig.restitutionVelocityThreshold),
-                mConstraintSolverSystem(*this, mIslands, mRigidBodyComponents, mTransformComponents, mJointsComponents,
+                mConstraintSolverSystem(*this, mMemoryManager.getHeapAllocator(), mIslands, mSolverBodies, mRigidBodyComponents,
+                                        mTransformComponents, mJointsComponents,
                                         mBallAndSocketJointsComponents, mFixedJointsComponents, mHingeJointsComponents,
                                         mSliderJointsComponents),
                 mDynamicsSystem(*this, mCollisionBodyComponents, mRigidBodyComponents, mTransformComponents, mCollidersComponents, mIsGravityEnabled, mConfig.gravity),
@@ -75,7 +81,9 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, PhysicsCommon& physicsC
                 mNbPositionSolverIterations(mConfig.defaultPositionSolverNbIterations), 
                 mIsSleepingEnabled(mConfig.isSleepingEnabled), mRigidBodies(mMemoryManager.getPoolAllocator()),
                 mIsGravityEnabled(true), mSleepLinearVelocity(mConfig.defaultSleepLinearVelocity),
-                mSleepAngularVelocity(mConfig.defaultSleepAngularVelocity), mTimeBeforeSleep(mConfig.defaultTimeBeforeSleep) {
+                mSleepAngularVelocity(mConfig.defaultSleepAngularVelocity), mTimeBeforeSleep(mConfig.defaultTimeBeforeSleep),
+                mTaskScheduler(nullptr), mSnapshots(mMemoryManager.getHeapAllocator()),
+                mStateCheckpoints(mMemoryManager.getHeapAllocator()), mNbSavedStates(0) {
 
     // Automatically generate a name for the world
     if (mName == "") {
@@ -90,6 +98,13 @@ PhysicsWorld::PhysicsWorld(MemoryManager& memoryManager, PhysicsCommon& physicsC
         mName = ss.str();
     }
 
+    mContactSolverSystem.setIsWideSolverEnabled(mConfig.isWideContactSolverEnabled);
+    mCollisionDetection.setIsDeterministic(mConfig.isDeterministic);
+    mCollisionDetection.setBroadPhaseTreeRebuildCostRatio(mConfig.broadPhaseTreeRebuildCostRatio);
+    mCollisionDetection.setBroadPhaseFatAABBMargins(mConfig.isBroadPhaseFatAABBPredictive, mConfig.broadPhaseFatAABBMinMargin,
+                                                    mConfig.broadPhaseFatAABBMaxMargin);
+    setNbStateCheckpoints(mConfig.nbStateCheckpoints);
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
 
@@ -143,10 +158,23 @@ PhysicsWorld::~PhysicsWorld() {
     }
 
     // Destroy all the rigid bodies that have not been removed
-    i = static_cast<uint32>(mRigidBodies.size());
+    while (mRigidBodies.size() > 0) {
+        RigidBody* rigidBody = mRigidBodies[mRigidBodies.size() - 1];
+        mRigidBodies.removeAt(mRigidBodies.size() - 1);
+        releaseRigidBody(rigidBody);
+    }
+
+    // Destroy all the snapshots that have not been removed
+    i = static_cast<uint32>(mSnapshots.size());
     while (i != 0) {
         i--;
-        destroyRigidBody(mRigidBodies[i]);
+        destroySnapshot(mSnapshots[i]);
+    }
+
+    // Destroy the checkpoints of the saveState() method
+    for (uint32 c=0; c < mStateCheckpoints.size(); c++) {
+        mStateCheckpoints[c]->~WorldSnapshot();
+        mMemoryManager.release(MemoryManager::AllocationType::Heap, mStateCheckpoints[c], sizeof(WorldSnapshot));
     }
 
     assert(mJointsComponents.getNbComponents() == 0);
@@ -246,6 +274,14 @@ void PhysicsWorld::setBodyDisabled(Entity bodyEntity, bool isDisabled) {
 
     mRigidBodyComponents.setIsEntityDisabled(bodyEntity, isDisabled);
 
+    // The body leaves its island when it is disabled and is added into the islands again when it is enabled
+    if (isDisabled) {
+        removeBodyFromIsland(bodyEntity);
+    }
+    else {
+        addBodyToIslands(bodyEntity);
+    }
+
     // For each collider of the body
     const Array<Entity>& collidersEntities = mCollisionBodyComponents.getColliders(bodyEntity);
     const uint32 nbColliderEntities = static_cast<uint32>(collidersEntities.size());
@@ -355,7 +391,7 @@ void PhysicsWorld::update(decimal timeStep) {
     mDynamicsSystem.updateBodiesState();
 
     // Update the colliders components
-    mCollisionDetection.updateColliders();
+    mCollisionDetection.updateColliders(timeStep);
 
     if (mIsSleepingEnabled) updateSleepingBodies(timeStep);
 
@@ -394,19 +430,76 @@ void PhysicsWorld::solveContactsAndConstraints(decimal timeStep) {
 
     // ---------- Solve velocity constraints for joints and contacts ---------- //
 
+    // Copy the state of the bodies of the islands into the packed solver bodies arrays
+    // (the constraints of the large islands are solved by colors if they can be solved on several threads
+    // or if the result must be the same with and without task scheduler)
+    const bool isSolvingLargeIslandsByColors = mTaskScheduler != nullptr || mConfig.isDeterministic;
+    mSolverBodies.initialize(*mCollisionDetection.mCurrentContactManifolds,
+                             isSolvingLargeIslandsByColors ? mConfig.minNbConstraintsIslandSolvedByColors : 0);
+
     // Initialize the contact solver
     mContactSolverSystem.init(mCollisionDetection.mCurrentContactManifolds, mCollisionDetection.mCurrentContactPoints, timeStep);
 
     // Initialize the constraint solver
     mConstraintSolverSystem.initialize(timeStep);
 
-    // For each iteration of the velocity solver
-    for (uint32 i=0; i<mNbVelocitySolverIterations; i++) {
+    const uint32 nbIslands = mIslands.getNbIslands();
+    const bool isSolvingIslandsInParallel = mTaskScheduler != nullptr && nbIslands > 1;
+
+    // If the islands can be solved on several threads
+    if (isSolvingIslandsInParallel) {
+
+        // Each island only contains its own joints, contacts and solver bodies (a static body shared
+        // by several islands has a different solver body in each island) and is solved independently.
+        parallelFor(mTaskScheduler, nbIslands, 1, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+
+            for (uint32 islandIndex = startIndex; islandIndex < endIndex; islandIndex++) {
+
+                // The islands solved by colors are solved below
+                if (mSolverBodies.islandsSolvedByColors[islandIndex]) continue;
+
+                // For each iteration of the velocity solver
+                for (uint32 i=0; i<mNbVelocitySolverIterations; i++) {
+
+                    mConstraintSolverSystem.solveVelocityConstraintsIsland(islandIndex);
+
+                    mContactSolverSystem.solveIsland(islandIndex, i);
+                }
+            }
+        });
+    }
+
+    // Solve the large islands one after the other. The constraints of such an island are partitioned
+    // into colors and the constraints of each color are solved on several threads. Without parallel
+    // islands, the other islands are also solved here.
+    if (mSolverBodies.nbIslandsSolvedByColors > 0) {
+
+        for (uint32 islandIndex = 0; islandIndex < nbIslands; islandIndex++) {
 
-        mConstraintSolverSystem.solveVelocityConstraints();
+            if (isSolvingIslandsInParallel && !mSolverBodies.islandsSolvedByColors[islandIndex]) continue;
 
-        mContactSolverSystem.solve();
+            // For each iteration of the velocity solver
+            for (uint32 i=0; i<mNbVelocitySolverIterations; i++) {
+
+                mConstraintSolverSystem.solveVelocityConstraintsIsland(islandIndex);
+
+                mContactSolverSystem.solveIsland(islandIndex, i);
+            }
+        }
     }
+    else if (!isSolvingIslandsInParallel) {
+
+        // For each iteration of the velocity solver
+        for (uint32 i=0; i<mNbVelocitySolverIterations; i++) {
+
+            mConstraintSolverSystem.solveVelocityConstraints();
+
+            mContactSolverSystem.solve(i);
+        }
+    }
+
+    // Write the velocities of the solver bodies back into the rigid body components
+    mSolverBodies.storeVelocities();
 
     mContactSolverSystem.storeImpulses();
 
@@ -421,12 +514,61 @@ void PhysicsWorld::solvePositionCorrection() {
 
     // ---------- Solve the position error correction for the constraints ---------- //
 
-    // For each iteration of the position (error correction) solver
-    for (uint32 i=0; i<mNbPositionSolverIterations; i++) {
+    // If there are no joints, there is no position error to correct
+    if (mJointsComponents.getNbEnabledComponents() == 0) return;
+
+    // Copy the positions of the bodies (computed by the integration) into the solver bodies
+    mSolverBodies.loadPositions();
+
+    const uint32 nbIslands = mIslands.getNbIslands();
+    const bool isSolvingIslandsInParallel = mTaskScheduler != nullptr && nbIslands > 1;
+
+    // If the islands can be solved on several threads
+    if (isSolvingIslandsInParallel) {
+
+        parallelFor(mTaskScheduler, nbIslands, 1, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+
+            for (uint32 islandIndex = startIndex; islandIndex < endIndex; islandIndex++) {
+
+                // The islands solved by colors are solved below
+                if (mSolverBodies.islandsSolvedByColors[islandIndex]) continue;
+
+                // For each iteration of the position (error correction) solver
+                for (uint32 i=0; i<mNbPositionSolverIterations; i++) {
+
+                    // Solve the position constraints of the joints of the island
+                    mConstraintSolverSystem.solvePositionConstraintsIsland(islandIndex);
+                }
+            }
+        });
+    }
+
+    // Solve the joints of the large islands color by color on several threads (and the joints
+    // of the other islands if they are not solved in parallel)
+    if (mSolverBodies.nbIslandsSolvedByColors > 0) {
+
+        for (uint32 islandIndex = 0; islandIndex < nbIslands; islandIndex++) {
+
+            if (isSolvingIslandsInParallel && !mSolverBodies.islandsSolvedByColors[islandIndex]) continue;
 
-        // Solve the position constraints
-        mConstraintSolverSystem.solvePositionConstraints();
+            // For each iteration of the position (error correction) solver
+            for (uint32 i=0; i<mNbPositionSolverIterations; i++) {
+                mConstraintSolverSystem.solvePositionConstraintsIsland(islandIndex);
+            }
+        }
     }
+    else if (!isSolvingIslandsInParallel) {
+
+        // For each iteration of the position (error correction) solver
+        for (uint32 i=0; i<mNbPositionSolverIterations; i++) {
+
+            // Solve the position constraints
+            mConstraintSolverSystem.solvePositionConstraints();
+        }
+    }
+
+    // Write the corrected positions of the solver bodies back into the rigid body components
+    mSolverBodies.storePositions();
 }
 
 // Enable or disable the joints
@@ -434,7 +576,7 @@ void PhysicsWorld::enableDisableJoints() {
 
     const uint32 nbJointComponents = mJointsComponents.getNbComponents();
 
-    Array<Entity> jointsEntites(mMemoryManager.getHeapAllocator(), nbJointComponents);
+    Array<Entity> jointsEntites(mMemoryManager.getSingleFrameAllocator(), nbJointComponents);
 
     // Get all the joints entities
     for (uint32 i = 0; i < nbJointComponents; i++) {
@@ -499,6 +641,9 @@ RigidBody* PhysicsWorld::createRigidBody(const Transform& transform) {
     // Add the rigid body to the physics world
     mRigidBodies.add(rigidBody);
 
+    // Add the body into the islands in the next frame
+    addBodyToIslands(entity);
+
 #ifdef IS_RP3D_PROFILING_ENABLED
 
     rigidBody->setProfiler(mProfiler);
@@ -517,6 +662,112 @@ RigidBody* PhysicsWorld::createRigidBody(const Transform& transform) {
  */
 void PhysicsWorld::destroyRigidBody(RigidBody* rigidBody) {
 
+    // Remove the rigid body from the array of rigid bodies
+    mRigidBodies.remove(rigidBody);
+
+    releaseRigidBody(rigidBody);
+}
+
+// Create several rigid bodies at once and add them to the physics world
+/// This is faster than calling createRigidBody() for each body because the memory
+/// of the components of all the new bodies is allocated only once.
+/**
+ * @param transforms Array with the transformations mapping the local-space of each body to world-space
+ * @param nbBodies Number of bodies to create
+ * @param outBodies Array where to write the pointers to the new bodies (of size nbBodies)
+ */
+void PhysicsWorld::createRigidBodies(const Transform* transforms, uint32 nbBodies, RigidBody** outBodies) {
+
+    RP3D_PROFILE("PhysicsWorld::createRigidBodies()", mProfiler);
+
+    // Allocate the memory for all the new bodies
+    mTransformComponents.reserve(mTransformComponents.getNbComponents() + nbBodies);
+    mCollisionBodyComponents.reserve(mCollisionBodyComponents.getNbComponents() + nbBodies);
+    mRigidBodyComponents.reserve(mRigidBodyComponents.getNbComponents() + nbBodies);
+    mRigidBodies.reserve(mRigidBodies.size() + nbBodies);
+
+    for (uint32 i=0; i < nbBodies; i++) {
+        outBodies[i] = createRigidBody(transforms[i]);
+    }
+}
+
+// Add several colliders to rigid bodies at once
+/// The i-th collider is added to the i-th body with the i-th collision shape and transform (a
+/// body can appear several times to add several colliders to it). This is faster than calling
+/// RigidBody::addCollider() for each collider because the memory of the components of all the new
+/// colliders is allocated only once and because the broad-phase tree is built in bulk instead of
+/// inserting the colliders one by one.
+/**
+ * @param rigidBodies Array with the bodies where to add the colliders
+ * @param collisionShapes Array with the collision shapes of the new colliders
+ * @param transforms Array with the transformations of the colliders that transform
+ *                   the local-space of each collider into the local-space of its body
+ * @param nbColliders Number of colliders to add
+ * @param outColliders Array where to write the pointers to the new colliders (of size nbColliders)
+ */
+void PhysicsWorld::addColliders(RigidBody* const* rigidBodies, CollisionShape* const* collisionShapes,
+                                const Transform* transforms, uint32 nbColliders, Collider** outColliders) {
+
+    RP3D_PROFILE("PhysicsWorld::addColliders()", mProfiler);
+
+    if (nbColliders == 0) return;
+
+    // Allocate the memory for all the new colliders
+    mCollidersComponents.reserve(mCollidersComponents.getNbComponents() + nbColliders);
+
+    // Create the colliders and compute their world-space AABBs
+    Array<AABB> aabbs(mMemoryManager.getHeapAllocator(), nbColliders);
+    aabbs.addWithoutInit(nbColliders);
+    for (uint32 i=0; i < nbColliders; i++) {
+        outColliders[i] = rigidBodies[i]->createCollider(collisionShapes[i], transforms[i], aabbs[i]);
+    }
+
+    // Add all the colliders into the collision detection at once
+    mCollisionDetection.addColliders(outColliders, &(aabbs[0]), nbColliders);
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: " + std::to_string(nbColliders) + " colliders added to bodies",  __FILE__, __LINE__);
+}
+
+// Destroy several rigid bodies at once and all the joints which they belong
+/// This is faster than calling destroyRigidBody() for each body because the bodies are
+/// removed from the array of rigid bodies of the world in a single pass.
+/**
+ * @param rigidBodies Array with the pointers to the bodies to destroy
+ * @param nbBodies Number of bodies to destroy
+ */
+void PhysicsWorld::destroyRigidBodies(RigidBody* const* rigidBodies, uint32 nbBodies) {
+
+    RP3D_PROFILE("PhysicsWorld::destroyRigidBodies()", mProfiler);
+
+    if (nbBodies == 0) return;
+
+    Set<RigidBody*> bodiesToDestroy(mMemoryManager.getHeapAllocator(), nbBodies);
+    for (uint32 i=0; i < nbBodies; i++) {
+        bodiesToDestroy.add(rigidBodies[i]);
+    }
+
+    // Remove the bodies from the array of rigid bodies (keeping the order of the other bodies)
+    uint64 nbKeptBodies = 0;
+    for (uint64 i=0; i < mRigidBodies.size(); i++) {
+        if (!bodiesToDestroy.contains(mRigidBodies[i])) {
+            mRigidBodies[nbKeptBodies] = mRigidBodies[i];
+            nbKeptBodies++;
+        }
+    }
+    assert(mRigidBodies.size() - nbKeptBodies == bodiesToDestroy.size());
+    while (mRigidBodies.size() > nbKeptBodies) {
+        mRigidBodies.removeAt(mRigidBodies.size() - 1);
+    }
+
+    for (uint32 i=0; i < nbBodies; i++) {
+        releaseRigidBody(rigidBodies[i]);
+    }
+}
+
+// Destroy a rigid body that has already been removed from the array of rigid bodies
+void PhysicsWorld::releaseRigidBody(RigidBody* rigidBody) {
+
     RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::Body,
              "Body " + std::to_string(rigidBody->getEntity().id) + ": rigid body destroyed",  __FILE__, __LINE__);
 
@@ -529,6 +780,9 @@ void PhysicsWorld::destroyRigidBody(RigidBody* rigidBody) {
         destroyJoint(mJointsComponents.getJoint(joints[0]));
     }
 
+    // The island of the body might not be connected anymore without it
+    removeBodyFromIsland(rigidBody->getEntity());
+
     // Destroy the corresponding entity and its components
     mCollisionBodyComponents.removeComponent(rigidBody->getEntity());
     mRigidBodyComponents.removeComponent(rigidBody->getEntity());
@@ -538,9 +792,6 @@ void PhysicsWorld::destroyRigidBody(RigidBody* rigidBody) {
     // Call the destructor of the rigid body
     rigidBody->~RigidBody();
 
-    // Remove the rigid body from the array of rigid bodies
-    mRigidBodies.remove(rigidBody);
-
     // Free the object from the memory allocator
     mMemoryManager.release(MemoryManager::AllocationType::Pool, rigidBody, sizeof(RigidBody));
 }
@@ -665,6 +916,10 @@ Joint* PhysicsWorld::createJoint(const JointInfo& jointInfo) {
     // Add the joint into the joint array of the bodies involved in the joint
     addJointToBodies(jointInfo.body1->getEntity(), jointInfo.body2->getEntity(), entity);
 
+    // The islands of the two bodies will be merged in the next frame
+    addBodyToIslands(jointInfo.body1->getEntity());
+    addBodyToIslands(jointInfo.body2->getEntity());
+
     // Return the pointer to the created joint
     return newJoint;
 }
@@ -694,6 +949,10 @@ void PhysicsWorld::destroyJoint(Joint* joint) {
     body1->setIsSleeping(false);
     body2->setIsSleeping(false);
 
+    // The island of the bodies might not be connected anymore without the joint
+    mIslandGraph.markSplitNeeded(mRigidBodyComponents.getIslandId(body1->getEntity()));
+    mIslandGraph.markSplitNeeded(mRigidBodyComponents.getIslandId(body2->getEntity()));
+
     // Remove the joint from the joint array of the bodies involved in the joint
     mRigidBodyComponents.removeJointFromBody(body1->getEntity(), joint->getEntity());
     mRigidBodyComponents.removeJointFromBody(body2->getEntity(), joint->getEntity());
@@ -725,6 +984,274 @@ void PhysicsWorld::destroyJoint(Joint* joint) {
     mMemoryManager.release(MemoryManager::AllocationType::Pool, joint, nbBytes);
 }
 
+// Create a snapshot that can store the state of the world
+/**
+ * @return A pointer to the snapshot that has been created (the snapshot is empty)
+ */
+WorldSnapshot* PhysicsWorld::createSnapshot() {
+
+    WorldSnapshot* snapshot = new (mMemoryManager.allocate(MemoryManager::AllocationType::Heap, sizeof(WorldSnapshot)))
+                                   WorldSnapshot(mMemoryManager.getHeapAllocator());
+    mSnapshots.add(snapshot);
+
+    return snapshot;
+}
+
+// Destroy a snapshot
+/**
+ * @param snapshot Pointer to the snapshot to destroy
+ */
+void PhysicsWorld::destroySnapshot(WorldSnapshot* snapshot) {
+
+    assert(snapshot != nullptr);
+    assert(mSnapshots.find(snapshot) != mSnapshots.end());
+
+    mSnapshots.remove(snapshot);
+
+    // Call the destructor of the snapshot
+    snapshot->~WorldSnapshot();
+
+    // Release the allocated memory
+    mMemoryManager.release(MemoryManager::AllocationType::Heap, snapshot, sizeof(WorldSnapshot));
+}
+
+// Save the state of the world into a snapshot
+/// The snapshot contains the raw data of the components of the bodies, colliders and joints,
+/// the overlapping pairs with their temporal coherence data, the broad-phase tree and the
+/// contacts of the last frame used to warm start the contact solver. This method must be
+/// called between two calls to update().
+/**
+ * @param snapshot Pointer to the snapshot where to save the state of the world
+ */
+void PhysicsWorld::saveSnapshot(WorldSnapshot* snapshot) const {
+
+    RP3D_PROFILE("PhysicsWorld::saveSnapshot()", mProfiler);
+
+    assert(snapshot != nullptr);
+
+    saveWorldState(snapshot->mData, false);
+}
+
+// Restore the state of the world from a snapshot
+/// The world must contain the same bodies, colliders and joints (with the same entities) as the
+/// world that has been saved into the snapshot. For instance, it can be the same world or
+/// another world where the bodies, colliders and joints have been created in the same order.
+/// The data of the snapshot is copied directly into the components without creating the
+/// bodies and colliders again. If the snapshot cannot be restored into this world, the
+/// world is not modified and this method returns false.
+/**
+ * @param snapshot Pointer to the snapshot to restore
+ * @return True if the snapshot has been restored
+ */
+bool PhysicsWorld::restoreSnapshot(const WorldSnapshot* snapshot) {
+
+    RP3D_PROFILE("PhysicsWorld::restoreSnapshot()", mProfiler);
+
+    assert(snapshot != nullptr);
+
+    if (!restoreWorldState(snapshot->mData, false)) {
+        return false;
+    }
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: Snapshot restored",  __FILE__, __LINE__);
+
+    return true;
+}
+
+// Save the dynamic state of the world into the next checkpoint and return its id
+/// A checkpoint only contains the state of the world that changes during the simulation
+/// (transforms, velocities, sleeping state, overlapping pairs, broad-phase tree of the dynamic
+/// and kinematic colliders and contacts used for warm starting). The checkpoints are stored in a ring buffer of
+/// WorldSettings::nbStateCheckpoints checkpoints and saving a state overwrites the oldest
+/// checkpoint. The memory of a checkpoint is reused the next time it is overwritten. This method
+/// must be called between two calls to update().
+/**
+ * @return The id of the checkpoint to use with the restoreState() method
+ */
+uint32 PhysicsWorld::saveState() {
+
+    RP3D_PROFILE("PhysicsWorld::saveState()", mProfiler);
+
+    assert(mStateCheckpoints.size() > 0);
+
+    const uint32 checkpointId = mNbSavedStates;
+    mNbSavedStates++;
+
+    saveWorldState(mStateCheckpoints[checkpointId % mStateCheckpoints.size()]->mData, true);
+
+    return checkpointId;
+}
+
+// Restore the dynamic state of the world from a checkpoint
+/// The configuration of the bodies (type, mass, damping, ...) and the bodies, colliders and
+/// joints of the world and the transforms of the static bodies are not part of a checkpoint.
+/// Therefore, they must be the same as when the state has been saved. After a restore, the next frames can be simulated again from the
+/// checkpoint without rebuilding the broad-phase tree. However, the island graph is not part of a
+/// checkpoint: it is cleared and all the bodies are added to it again, so that the first frame after
+/// a restore computes all the islands again. The checkpoints saved after this one remain valid until
+/// they are overwritten.
+/**
+ * @param checkpointId Id of the checkpoint returned by the saveState() method
+ * @return True if the state has been restored and false if the checkpoint has
+ *         already been overwritten or if the world does not have the same bodies anymore
+ */
+bool PhysicsWorld::restoreState(uint32 checkpointId) {
+
+    RP3D_PROFILE("PhysicsWorld::restoreState()", mProfiler);
+
+    const uint32 nbCheckpoints = static_cast<uint32>(mStateCheckpoints.size());
+
+    // If the checkpoint does not exist or has been overwritten
+    if (checkpointId >= mNbSavedStates || mNbSavedStates - checkpointId > nbCheckpoints) {
+
+        RP3D_LOG(mConfig.worldName, Logger::Level::Error, Logger::Category::World,
+                 "Physics World: Cannot restore the state " + std::to_string(checkpointId) + " (the checkpoint does not exist anymore)",  __FILE__, __LINE__);
+        return false;
+    }
+
+    return restoreWorldState(mStateCheckpoints[checkpointId % nbCheckpoints]->mData, true);
+}
+
+// Set the number of checkpoints used by the saveState() method
+/// The existing checkpoints are destroyed
+/**
+ * @param nbCheckpoints Number of checkpoints of the ring buffer (at least one)
+ */
+void PhysicsWorld::setNbStateCheckpoints(uint32 nbCheckpoints) {
+
+    assert(nbCheckpoints > 0);
+
+    // Destroy the current checkpoints
+    for (uint32 i=0; i < mStateCheckpoints.size(); i++) {
+        mStateCheckpoints[i]->~WorldSnapshot();
+        mMemoryManager.release(MemoryManager::AllocationType::Heap, mStateCheckpoints[i], sizeof(WorldSnapshot));
+    }
+    mStateCheckpoints.clear();
+
+    // Create the new checkpoints
+    for (uint32 i=0; i < nbCheckpoints; i++) {
+        mStateCheckpoints.add(new (mMemoryManager.allocate(MemoryManager::AllocationType::Heap, sizeof(WorldSnapshot)))
+                                   WorldSnapshot(mMemoryManager.getHeapAllocator()));
+    }
+
+    mConfig.nbStateCheckpoints = nbCheckpoints;
+    mNbSavedStates = 0;
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             "Physics World: Set the number of state checkpoints to " + std::to_string(nbCheckpoints),  __FILE__, __LINE__);
+}
+
+// Save the state of the world into the data of a snapshot
+/**
+ * @param data Array where to write the data (the previous data is overwritten but the memory is reused)
+ * @param isDynamicStateOnly True if only the state that changes during the simulation must be saved
+ */
+void PhysicsWorld::saveWorldState(Array<uint8>& data, bool isDynamicStateOnly) const {
+
+    const Components* components[] = {&mCollisionBodyComponents, &mRigidBodyComponents, &mTransformComponents,
+                                      &mCollidersComponents, &mJointsComponents, &mBallAndSocketJointsComponents,
+                                      &mFixedJointsComponents, &mHingeJointsComponents, &mSliderJointsComponents};
+
+    data.clear();
+    SnapshotWriter writer(data);
+
+    WorldSnapshot::writeHeader(writer);
+
+    // Each table of components is saved in its own section
+    for (const Components* table : components) {
+
+        const uint32 sectionStart = writer.beginSection();
+        if (isDynamicStateOnly) {
+            table->saveDynamicState(writer);
+        }
+        else {
+            table->saveSnapshot(writer);
+        }
+        writer.endSection(sectionStart);
+    }
+
+    // Overlapping pairs, broad-phase and contacts
+    const uint32 sectionStart = writer.beginSection();
+    mCollisionDetection.saveSnapshot(writer, isDynamicStateOnly);
+    writer.endSection(sectionStart);
+}
+
+// Restore the state of the world from the data of a snapshot
+/**
+ * @param data Data of the snapshot
+ * @param isDynamicStateOnly True if the data only contains the state that changes during the simulation
+ * @return True if the state has been restored (the world is not modified otherwise)
+ */
+bool PhysicsWorld::restoreWorldState(const Array<uint8>& data, bool isDynamicStateOnly) {
+
+    Components* components[] = {&mCollisionBodyComponents, &mRigidBodyComponents, &mTransformComponents,
+                                &mCollidersComponents, &mJointsComponents, &mBallAndSocketJointsComponents,
+                                &mFixedJointsComponents, &mHingeJointsComponents, &mSliderJointsComponents};
+
+    SnapshotReader reader(data.size() > 0 ? &(data[0]) : nullptr, static_cast<uint32>(data.size()));
+
+    if (!WorldSnapshot::readHeader(reader)) {
+
+        RP3D_LOG(mConfig.worldName, Logger::Level::Error, Logger::Category::World,
+                 "Physics World: Cannot restore the snapshot (invalid format or version)",  __FILE__, __LINE__);
+        return false;
+    }
+
+    // Parse and check all the sections of the snapshot before modifying the world. The world must
+    // have the same structure as the snapshot and each section must contain exactly the data to restore.
+    SnapshotReader validationReader(reader);
+    bool isValid = true;
+    for (const Components* table : components) {
+
+        const SnapshotReader section = validationReader.readSection();
+        isValid = isValid && validationReader.isValid() && table->canRestoreSnapshot(section, isDynamicStateOnly);
+    }
+    SnapshotReader collisionDetectionSection = validationReader.readSection();
+    isValid = isValid && validationReader.isValid() && validationReader.isAtEnd() &&
+              mCollisionDetection.skipSnapshot(collisionDetectionSection, isDynamicStateOnly) &&
+              collisionDetectionSection.isAtEnd();
+    if (!isValid) {
+
+        RP3D_LOG(mConfig.worldName, Logger::Level::Error, Logger::Category::World,
+                 "Physics World: Cannot restore the snapshot (the data is corrupted or the bodies, colliders and joints are not the same)",  __FILE__, __LINE__);
+        return false;
+    }
+
+    // Restore each table of components. Since all the sections have been checked, the
+    // readers cannot become invalid anymore.
+    bool isRestored = true;
+    for (Components* table : components) {
+
+        SnapshotReader section = reader.readSection();
+        if (isDynamicStateOnly) {
+            table->restoreDynamicState(section);
+        }
+        else {
+            table->restoreSnapshot(section);
+        }
+        assert(section.isValid() && section.isAtEnd());
+        isRestored = isRestored && section.isValid();
+    }
+
+    // Restore the overlapping pairs, broad-phase and contacts
+    SnapshotReader section = reader.readSection();
+    mCollisionDetection.restoreSnapshot(section, isDynamicStateOnly);
+    assert(section.isValid() && section.isAtEnd());
+    isRestored = isRestored && section.isValid() && reader.isValid();
+
+    // The islands are computed again from the restored contacts and joints
+    mIslandGraph.clear();
+    const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbComponents();
+    for (uint32 i=0; i < nbRigidBodyComponents; i++) {
+
+        mRigidBodyComponents.mIslandIds[i] = IslandGraph::INVALID_ISLAND_ID;
+        addBodyToIslands(mRigidBodyComponents.mBodiesEntities[i]);
+    }
+
+    return isRestored;
+}
+
 
 // Set the number of iterations for the velocity constraint solver
 /**
@@ -757,149 +1284,289 @@ void PhysicsWorld::addJointToBodies(Entity body1, Entity body2, Entity joint) {
 /// the contact manifolds and contact points of the same island
 /// to be packed together into linear arrays of manifolds and contacts for better caching.
 /// An island is an isolated group of rigid bodies that have constraints (joints or contacts)
-/// between each other. This method computes the islands at each time step as follows: For each
-/// awake rigid body, we run a Depth First Search (DFS) through the constraint graph of that body
-/// (graph where nodes are the bodies and where the edges are the constraints between the bodies) to
-/// find all the bodies that are connected with it (the bodies that share joints or contacts with
-/// it). Then, we create an island with this group of connected bodies.
+/// between each other. The islands are persistent: each awake non-static body keeps the id of
+/// its island from one frame to the next (see IslandGraph). The islands are only updated from
+/// the events of the frame: the islands of two bodies are merged when they start touching each
+/// other or when a body is added with its contacts and joints (new, woken up or modified body).
+/// An island is split again with a Depth First Search (DFS) through its constraint graph only if it
+/// has lost a body, a contact or a joint. The contacts and joints of the islands are then gathered
+/// from the contact pairs and joints of their bodies. The islands are ordered by their first body in
+/// the rigid body components so that this order does not depend on their ids.
 void PhysicsWorld::createIslands() {
 
     RP3D_PROFILE("PhysicsWorld::createIslands()", mProfiler);
 
     assert(mProcessContactPairsOrderIslands.size() == 0);
 
-    // Reset all the isAlreadyInIsland variables of bodies and joints
-    const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbComponents();
-    for (uint32 b=0; b < nbRigidBodyComponents; b++) {
-        mRigidBodyComponents.mIsAlreadyInIsland[b] = false;
+    const uint32 invalidIndex = static_cast<uint32>(-1);
+
+    MemoryAllocator& allocator = mMemoryManager.getSingleFrameAllocator();
+
+    Array<ContactPair>& contactPairs = *(mCollisionDetection.mCurrentContactPairs);
+
+    // Mark the islands that have lost a contact between two of their bodies to be split
+    const Array<ContactPair>& lostContactPairs = mCollisionDetection.mLostContactPairs;
+    const uint32 nbLostContactPairs = static_cast<uint32>(lostContactPairs.size());
+    for (uint32 p=0; p < nbLostContactPairs; p++) {
+
+        const ContactPair& lostContactPair = lostContactPairs[p];
+
+        uint32 body1Index, body2Index;
+        if (!lostContactPair.isTrigger && mRigidBodyComponents.hasComponentGetIndex(lostContactPair.body1Entity, body1Index) &&
+            mRigidBodyComponents.hasComponentGetIndex(lostContactPair.body2Entity, body2Index) &&
+            isIslandBody(body1Index) && isIslandBody(body2Index)) {
+
+            mIslandGraph.markSplitNeeded(mRigidBodyComponents.mIslandIds[body1Index]);
+        }
     }
-    const uint32 nbJointsComponents = mJointsComponents.getNbComponents();
-    for (uint32 i=0; i < nbJointsComponents; i++) {
-        mJointsComponents.mIsAlreadyInIsland[i] = false;
+
+    // Merge the islands of the bodies that start touching each other (a sleeping body that starts
+    // touching an awake body is woken up)
+    const Array<uint32>& newContactPairsIndices = mCollisionDetection.mNewContactPairsIndices;
+    const uint32 nbNewContactPairs = static_cast<uint32>(newContactPairsIndices.size());
+    for (uint32 p=0; p < nbNewContactPairs; p++) {
+
+        const ContactPair& pair = contactPairs[newContactPairsIndices[p]];
+
+        const uint32 body1Index = mRigidBodyComponents.getEntityIndex(pair.body1Entity);
+        if (isIslandBody(body1Index)) {
+            addConstraintToIslands(body1Index, pair.body2Entity);
+        }
+        else {
+
+            const uint32 body2Index = mRigidBodyComponents.getEntityIndex(pair.body2Entity);
+            if (isIslandBody(body2Index)) {
+                addConstraintToIslands(body2Index, pair.body1Entity);
+            }
+        }
     }
 
-    // Reserve memory for the islands
-    mIslands.reserveMemory();
+    // Add the new, woken up and modified bodies into the islands with their contacts and joints. The bodies that
+    // are woken up by them are added at the end of the array and are processed in the same loop.
+    for (uint32 i=0; i < mIslandGraph.bodiesToAdd.size(); i++) {
 
-    // Create a stack for the bodies to visit during the Depth First Search
-    Stack<Entity> bodyEntitiesToVisit(mMemoryManager.getSingleFrameAllocator(), mIslands.getNbMaxBodiesInIslandPreviousFrame());
+        const Entity bodyEntity = mIslandGraph.bodiesToAdd[i];
 
-    // Array of static bodies added to the current island (used to reset the isAlreadyInIsland variable of static bodies)
-    Array<Entity> staticBodiesAddedToIsland(mMemoryManager.getSingleFrameAllocator(), 16);
+        // If the body has been destroyed or is not an awake non-static body anymore
+        uint32 bodyIndex;
+        if (!mRigidBodyComponents.hasComponentGetIndex(bodyEntity, bodyIndex) || !isIslandBody(bodyIndex)) continue;
 
-    uint32 nbTotalManifolds = 0;
+        if (mRigidBodyComponents.mIslandIds[bodyIndex] == IslandGraph::INVALID_ISLAND_ID) {
+            mRigidBodyComponents.mIslandIds[bodyIndex] = mIslandGraph.createIsland();
+        }
+
+        // For each contact pair in which the body is involved
+        const uint32 nbBodyContactPairs = static_cast<uint32>(mRigidBodyComponents.mContactPairs[bodyIndex].size());
+        for (uint32 p=0; p < nbBodyContactPairs; p++) {
 
-    // For each rigid body component
-    for (uint32 b=0; b < mRigidBodyComponents.getNbEnabledComponents(); b++) {
+            const ContactPair& pair = contactPairs[mRigidBodyComponents.mContactPairs[bodyIndex][p]];
+            addConstraintToIslands(bodyIndex, pair.body1Entity == bodyEntity ? pair.body2Entity : pair.body1Entity);
+        }
+
+        // For each joint in which the body is involved
+        const uint32 nbBodyJoints = static_cast<uint32>(mRigidBodyComponents.mJoints[bodyIndex].size());
+        for (uint32 j=0; j < nbBodyJoints; j++) {
+
+            const uint32 jointIndex = mJointsComponents.getEntityIndex(mRigidBodyComponents.mJoints[bodyIndex][j]);
+            const Entity body1Entity = mJointsComponents.mBody1Entities[jointIndex];
+            addConstraintToIslands(bodyIndex, body1Entity == bodyEntity ? mJointsComponents.mBody2Entities[jointIndex] : body1Entity);
+        }
+    }
+    mIslandGraph.bodiesToAdd.clear();
+
+    // Split the islands that have lost a body or a constraint
+    splitIslands();
 
-        // If the body has already been added to an island, we go to the next body
-        if (mRigidBodyComponents.mIsAlreadyInIsland[b]) continue;
+    const uint32 nbEnabledBodies = mRigidBodyComponents.getNbEnabledComponents();
+    const uint32 nbIslandIds = mIslandGraph.getNbIslandIds();
+
+    // Index (in the order of the first body of each island in the components) of each island
+    Array<uint32> islandIndices(allocator, nbIslandIds);
+    for (uint32 i=0; i < nbIslandIds; i++) {
+        islandIndices.add(invalidIndex);
+    }
+    Array<uint32> startBodiesIndices(allocator);
+    Array<uint32> startPairsIndices(allocator);
+    Array<uint32> startJointsIndices(allocator);
+    Array<uint32> nbIslandsContactManifolds(allocator);
+    uint32 nbIslands = 0;
+
+    // Contact pairs and joints of the islands (in the order of their bodies in the components) with the index of
+    // their island and the index of their other body if it is static (invalid index otherwise)
+    Array<uint32> pairs(allocator, static_cast<uint32>(contactPairs.size()));
+    Array<uint32> pairsIslandIndices(allocator, static_cast<uint32>(contactPairs.size()));
+    Array<uint32> pairsStaticBodyIndices(allocator, static_cast<uint32>(contactPairs.size()));
+    Array<Entity> jointEntities(allocator);
+    Array<uint32> jointsIslandIndices(allocator);
+    Array<uint32> jointsStaticBodyIndices(allocator);
+
+    // For each awake non-static body
+    for (uint32 b=0; b < nbEnabledBodies; b++) {
 
-        // If the body is static, we go to the next body
         if (mRigidBodyComponents.mBodyTypes[b] == BodyType::STATIC) continue;
 
-        // Reset the stack of bodies to visit
-        bodyEntitiesToVisit.clear();
+        assert(mRigidBodyComponents.mIslandIds[b] != IslandGraph::INVALID_ISLAND_ID);
 
-        // Add the body into the stack of bodies to visit
-        mRigidBodyComponents.mIsAlreadyInIsland[b] = true;
-        bodyEntitiesToVisit.push(mRigidBodyComponents.mBodiesEntities[b]);
+        // Move the body into the root island of its set
+        const uint32 islandId = mIslandGraph.findRoot(mRigidBodyComponents.mIslandIds[b]);
+        mRigidBodyComponents.mIslandIds[b] = islandId;
 
-        // Create the new island
-        uint32 islandIndex = mIslands.addIsland(nbTotalManifolds);
+        if (islandIndices[islandId] == invalidIndex) {
+            islandIndices[islandId] = nbIslands;
+            startBodiesIndices.add(0);
+            startPairsIndices.add(0);
+            startJointsIndices.add(0);
+            nbIslandsContactManifolds.add(0);
+            nbIslands++;
+        }
+        const uint32 islandIndex = islandIndices[islandId];
+        startBodiesIndices[islandIndex]++;
 
-        // While there are still some bodies to visit in the stack
-        while (bodyEntitiesToVisit.size() > 0) {
+        const Entity bodyEntity = mRigidBodyComponents.mBodiesEntities[b];
 
-            // Get the body entity
-            const Entity bodyToVisitEntity = bodyEntitiesToVisit.pop();
+        // Add the contact pairs of the body that have not been added by their other body yet
+        const uint32 nbBodyContactPairs = static_cast<uint32>(mRigidBodyComponents.mContactPairs[b].size());
+        for (uint32 p=0; p < nbBodyContactPairs; p++) {
 
-            // Add the body into the island
-            mIslands.addBodyToIsland(bodyToVisitEntity);
+            const uint32 contactPairIndex = mRigidBodyComponents.mContactPairs[b][p];
+            ContactPair& pair = contactPairs[contactPairIndex];
+            if (pair.isAlreadyInIsland) continue;
 
-            RigidBody* rigidBodyToVisit = mRigidBodyComponents.getRigidBody(bodyToVisitEntity);
+            pair.isAlreadyInIsland = true;
 
-            // Awake the body if it is sleeping (note that this called might change the body index in the mRigidBodyComponents array)
-            rigidBodyToVisit->setIsSleeping(false);
+            const uint32 otherBodyIndex = mRigidBodyComponents.getEntityIndex(pair.body1Entity == bodyEntity ? pair.body2Entity : pair.body1Entity);
+            assert(!isIslandBody(otherBodyIndex) || mIslandGraph.findRoot(mRigidBodyComponents.mIslandIds[otherBodyIndex]) == islandId);
 
-            // Compute the body index in the array (Note that it could have changed because of the previous call to rigidBodyToVisit->setIsSleeping(false))
-            const uint32 bodyToVisitIndex = mRigidBodyComponents.getEntityIndex(bodyToVisitEntity);
+            assert(pair.nbPotentialContactManifolds > 0);
+            pairs.add(contactPairIndex);
+            pairsIslandIndices.add(islandIndex);
+            pairsStaticBodyIndices.add(isIslandBody(otherBodyIndex) ? invalidIndex : otherBodyIndex);
+            startPairsIndices[islandIndex]++;
+            nbIslandsContactManifolds[islandIndex] += pair.nbPotentialContactManifolds;
+        }
+        mRigidBodyComponents.mContactPairs[b].clear();
 
-            // If the current body is static, we do not want to perform the DFS search across that body
-            if (mRigidBodyComponents.mBodyTypes[bodyToVisitIndex] == BodyType::STATIC) {
+        // For each joint of the body
+        const uint32 nbBodyJoints = static_cast<uint32>(mRigidBodyComponents.mJoints[b].size());
+        for (uint32 j=0; j < nbBodyJoints; j++) {
 
-                staticBodiesAddedToIsland.add(bodyToVisitEntity);
+            const Entity jointEntity = mRigidBodyComponents.mJoints[b][j];
+            const uint32 jointIndex = mJointsComponents.getEntityIndex(jointEntity);
+            const Entity body1Entity = mJointsComponents.mBody1Entities[jointIndex];
+            const Entity otherBodyEntity = body1Entity == bodyEntity ? mJointsComponents.mBody2Entities[jointIndex] : body1Entity;
+            const uint32 otherBodyIndex = mRigidBodyComponents.getEntityIndex(otherBodyEntity);
 
-                // Go to the next body
-                continue;
-            }
+            // The joints with a disabled body are not part of the islands
+            if (otherBodyIndex >= nbEnabledBodies) continue;
 
-            // If the body is involved in contacts with other bodies
-            // For each contact pair in which the current body is involded
-            const uint32 nbBodyContactPairs = static_cast<uint32>(mRigidBodyComponents.mContactPairs[bodyToVisitIndex].size());
-            for (uint32 p=0; p < nbBodyContactPairs; p++) {
+            // The joint is added to the island of its first body (or of its second body if the first
+            // one is static) so that it is only added once
+            if (body1Entity != bodyEntity && isIslandBody(otherBodyIndex)) continue;
 
-                const uint32 contactPairIndex = mRigidBodyComponents.mContactPairs[bodyToVisitIndex][p];
-                ContactPair& pair = (*mCollisionDetection.mCurrentContactPairs)[contactPairIndex];
+            jointEntities.add(jointEntity);
+            jointsIslandIndices.add(islandIndex);
+            jointsStaticBodyIndices.add(isIslandBody(otherBodyIndex) ? invalidIndex : otherBodyIndex);
+            startJointsIndices[islandIndex]++;
+        }
+    }
 
-                // Check if the current contact pair has already been added into an island
-                if (pair.isAlreadyInIsland) continue;
+    const uint32 nbIslandPairs = static_cast<uint32>(pairs.size());
+    const uint32 nbIslandJoints = static_cast<uint32>(jointEntities.size());
 
-                const Entity otherBodyEntity = pair.body1Entity == bodyToVisitEntity ? pair.body2Entity : pair.body1Entity;
+    // Sort the bodies, the contact pairs and the joints by island (the counts become the start index of each island)
+    uint32 nbSortedBodies = 0;
+    uint32 nbSortedPairs = 0;
+    uint32 nbSortedJoints = 0;
+    for (uint32 i=0; i < nbIslands; i++) {
 
-                // If the colliding body is a RigidBody (and not a CollisionBody) and is not a trigger
-                uint32 otherBodyIndex;
-                if (mRigidBodyComponents.hasComponentGetIndex(otherBodyEntity, otherBodyIndex)
-                    && !mCollidersComponents.getIsTrigger(pair.collider1Entity) && !mCollidersComponents.getIsTrigger(pair.collider2Entity)) {
+        const uint32 nbIslandBodies = startBodiesIndices[i];
+        startBodiesIndices[i] = nbSortedBodies;
+        nbSortedBodies += nbIslandBodies;
 
-                    mProcessContactPairsOrderIslands.add(contactPairIndex);
+        const uint32 nbPairs = startPairsIndices[i];
+        startPairsIndices[i] = nbSortedPairs;
+        nbSortedPairs += nbPairs;
 
-                    assert(pair.nbPotentialContactManifolds > 0);
-                    nbTotalManifolds += pair.nbPotentialContactManifolds;
+        const uint32 nbJoints = startJointsIndices[i];
+        startJointsIndices[i] = nbSortedJoints;
+        nbSortedJoints += nbJoints;
+    }
+    Array<uint32> sortedBodies(allocator, nbSortedBodies);
+    for (uint32 i=0; i < nbSortedBodies; i++) {
+        sortedBodies.add(0);
+    }
+    Array<uint32> sortedPairs(allocator, nbIslandPairs);
+    for (uint32 i=0; i < nbIslandPairs; i++) {
+        sortedPairs.add(0);
+        mProcessContactPairsOrderIslands.add(0);
+    }
+    Array<uint32> sortedJoints(allocator, nbIslandJoints);
+    for (uint32 i=0; i < nbIslandJoints; i++) {
+        sortedJoints.add(0);
+    }
+    for (uint32 b=0; b < nbEnabledBodies; b++) {
 
-                    // Add the contact manifold into the island
-                    mIslands.nbContactManifolds[islandIndex] += pair.nbPotentialContactManifolds;
-                    pair.isAlreadyInIsland = true;
+        if (mRigidBodyComponents.mBodyTypes[b] != BodyType::STATIC) {
+            sortedBodies[startBodiesIndices[islandIndices[mRigidBodyComponents.mIslandIds[b]]]++] = b;
+        }
+    }
+    for (uint32 p=0; p < nbIslandPairs; p++) {
 
-                    // Check if the other body has already been added to the island
-                    if (mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex]) continue;
+        const uint32 sortedIndex = startPairsIndices[pairsIslandIndices[p]]++;
+        sortedPairs[sortedIndex] = p;
+        mProcessContactPairsOrderIslands[sortedIndex] = pairs[p];
+    }
+    for (uint32 j=0; j < nbIslandJoints; j++) {
+        sortedJoints[startJointsIndices[jointsIslandIndices[j]]++] = j;
+    }
 
-                    // Insert the other body into the stack of bodies to visit
-                    bodyEntitiesToVisit.push(otherBodyEntity);
-                    mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex] = true;
-                }
-                else {
+    // Reserve memory for the islands
+    mIslands.reserveMemory();
 
-                    // Add the contact pair index in the array of contact pairs that won't be part of islands
-                    pair.isAlreadyInIsland = true;
-                }
-            }
+    // Array of static bodies added to the current island (used to reset the isAlreadyInIsland variable of static bodies)
+    Array<uint32> staticBodiesAddedToIsland(allocator, 16);
 
-            // For each joint in which the current body is involved
-            const Array<Entity>& joints = mRigidBodyComponents.getJoints(rigidBodyToVisit->getEntity());
-            const uint32 nbBodyJoints = static_cast<uint32>(joints.size());
-            for (uint32 i=0; i < nbBodyJoints; i++) {
+    // Create the islands (the start indices are now the end indices of the islands)
+    uint32 nbTotalManifolds = 0;
+    uint32 startBodyIndex = 0;
+    uint32 startPairIndex = 0;
+    uint32 startJointIndex = 0;
+    for (uint32 i=0; i < nbIslands; i++) {
 
-                const uint32 jointComponentIndex = mJointsComponents.getEntityIndex(joints[i]);
+        const uint32 islandIndex = mIslands.addIsland(nbTotalManifolds);
+        assert(islandIndex == i);
 
-                // Check if the current joint has already been added into an island
-                if (mJointsComponents.mIsAlreadyInIsland[jointComponentIndex]) continue;
+        // Add the awake non-static bodies into the island
+        for (uint32 b=startBodyIndex; b < startBodiesIndices[i]; b++) {
+            mIslands.addBodyToIsland(mRigidBodyComponents.mBodiesEntities[sortedBodies[b]]);
+        }
 
-                // Add the joint into the island
-                mJointsComponents.mIsAlreadyInIsland[jointComponentIndex] = true;
+        // Add the static bodies of the contacts of the island
+        for (uint32 p=startPairIndex; p < startPairsIndices[i]; p++) {
 
-                const Entity body1Entity = mJointsComponents.mBody1Entities[jointComponentIndex];
-                const Entity body2Entity = mJointsComponents.mBody2Entities[jointComponentIndex];
-                const Entity otherBodyEntity = body1Entity == bodyToVisitEntity ? body2Entity : body1Entity;
+            const uint32 staticBodyIndex = pairsStaticBodyIndices[sortedPairs[p]];
+            if (staticBodyIndex != invalidIndex && !mRigidBodyComponents.mIsAlreadyInIsland[staticBodyIndex]) {
 
-                const uint32 otherBodyIndex = mRigidBodyComponents.getEntityIndex(otherBodyEntity);
+                mRigidBodyComponents.mIsAlreadyInIsland[staticBodyIndex] = true;
+                mIslands.addBodyToIsland(mRigidBodyComponents.mBodiesEntities[staticBodyIndex]);
+                staticBodiesAddedToIsland.add(staticBodyIndex);
+            }
+        }
+        mIslands.nbContactManifolds[islandIndex] = nbIslandsContactManifolds[i];
+        nbTotalManifolds += nbIslandsContactManifolds[i];
 
-                // Check if the other body has already been added to the island
-                if (mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex]) continue;
+        // Add the joints into the island and the static bodies of its joints
+        for (uint32 j=startJointIndex; j < startJointsIndices[i]; j++) {
 
-                // Insert the other body into the stack of bodies to visit
-                bodyEntitiesToVisit.push(otherBodyEntity);
-                mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex] = true;
+            const uint32 jointIndex = sortedJoints[j];
+            mIslands.addJointToIsland(jointEntities[jointIndex]);
+
+            const uint32 staticBodyIndex = jointsStaticBodyIndices[jointIndex];
+            if (staticBodyIndex != invalidIndex && !mRigidBodyComponents.mIsAlreadyInIsland[staticBodyIndex]) {
+
+                mRigidBodyComponents.mIsAlreadyInIsland[staticBodyIndex] = true;
+                mIslands.addBodyToIsland(mRigidBodyComponents.mBodiesEntities[staticBodyIndex]);
+                staticBodiesAddedToIsland.add(staticBodyIndex);
             }
         }
 
@@ -907,18 +1574,191 @@ void PhysicsWorld::createIslands() {
         // can also be included in the other islands
         const uint32 nbStaticBodiesAddedToIsland = static_cast<uint32>(staticBodiesAddedToIsland.size());
         for (uint32 j=0; j < nbStaticBodiesAddedToIsland; j++) {
+            mRigidBodyComponents.mIsAlreadyInIsland[staticBodiesAddedToIsland[j]] = false;
+        }
+        staticBodiesAddedToIsland.clear();
+
+        startBodyIndex = startBodiesIndices[i];
+        startPairIndex = startPairsIndices[i];
+        startJointIndex = startJointsIndices[i];
+    }
+
+    // Release the ids of the islands that have been merged into another island (no body refers to them anymore)
+    const uint32 nbMergedIslands = static_cast<uint32>(mIslandGraph.mergedIslandIds.size());
+    for (uint32 i=0; i < nbMergedIslands; i++) {
+        mIslandGraph.destroyIsland(mIslandGraph.mergedIslandIds[i]);
+    }
+    mIslandGraph.mergedIslandIds.clear();
+}
+
+// Split the islands that have lost a body or a constraint since they have been created
+/// An island that has lost a body, a contact or a joint might not be connected anymore. The bodies
+/// of such an island are moved into new islands with a Depth First Search (DFS) through its constraint
+/// graph. The other islands are not visited.
+void PhysicsWorld::splitIslands() {
+
+    RP3D_PROFILE("PhysicsWorld::splitIslands()", mProfiler);
+
+    if (mIslandGraph.islandsToSplit.size() == 0) return;
+
+    MemoryAllocator& allocator = mMemoryManager.getSingleFrameAllocator();
+
+    const Array<ContactPair>& contactPairs = *(mCollisionDetection.mCurrentContactPairs);
+    const uint32 nbEnabledBodies = mRigidBodyComponents.getNbEnabledComponents();
+
+    // Create a stack for the bodies to visit during the Depth First Search
+    Stack<uint32> bodiesToVisit(allocator, mIslands.getNbMaxBodiesInIslandPreviousFrame());
+
+    // Array of the visited bodies (used to reset their isAlreadyInIsland variable)
+    Array<uint32> visitedBodies(allocator);
+
+    // For each body of an island to split that has not been visited yet
+    for (uint32 b=0; b < nbEnabledBodies; b++) {
+
+        if (mRigidBodyComponents.mBodyTypes[b] == BodyType::STATIC || mRigidBodyComponents.mIsAlreadyInIsland[b]) continue;
+
+        const uint32 rootIslandId = mIslandGraph.findRoot(mRigidBodyComponents.mIslandIds[b]);
+        if (!mIslandGraph.isSplitNeeded[rootIslandId]) continue;
+
+        // Create a new island with all the bodies that are connected to this body
+        const uint32 islandId = mIslandGraph.createIsland();
+
+        mRigidBodyComponents.mIsAlreadyInIsland[b] = true;
+        visitedBodies.add(b);
+        bodiesToVisit.push(b);
+
+        // While there are still some bodies to visit in the stack
+        while (bodiesToVisit.size() > 0) {
+
+            const uint32 bodyIndex = bodiesToVisit.pop();
+            const Entity bodyEntity = mRigidBodyComponents.mBodiesEntities[bodyIndex];
+            mRigidBodyComponents.mIslandIds[bodyIndex] = islandId;
+
+            // For each contact pair in which the body is involved
+            const uint32 nbBodyContactPairs = static_cast<uint32>(mRigidBodyComponents.mContactPairs[bodyIndex].size());
+            for (uint32 p=0; p < nbBodyContactPairs; p++) {
+
+                const ContactPair& pair = contactPairs[mRigidBodyComponents.mContactPairs[bodyIndex][p]];
+                const uint32 otherBodyIndex = mRigidBodyComponents.getEntityIndex(pair.body1Entity == bodyEntity ? pair.body2Entity : pair.body1Entity);
+                if (isIslandBody(otherBodyIndex) && !mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex]) {
+
+                    assert(mIslandGraph.findRoot(mRigidBodyComponents.mIslandIds[otherBodyIndex]) == rootIslandId);
+
+                    mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex] = true;
+                    visitedBodies.add(otherBodyIndex);
+                    bodiesToVisit.push(otherBodyIndex);
+                }
+            }
+
+            // For each joint in which the body is involved
+            const uint32 nbBodyJoints = static_cast<uint32>(mRigidBodyComponents.mJoints[bodyIndex].size());
+            for (uint32 j=0; j < nbBodyJoints; j++) {
+
+                const uint32 jointIndex = mJointsComponents.getEntityIndex(mRigidBodyComponents.mJoints[bodyIndex][j]);
+                const Entity body1Entity = mJointsComponents.mBody1Entities[jointIndex];
+                const Entity otherBodyEntity = body1Entity == bodyEntity ? mJointsComponents.mBody2Entities[jointIndex] : body1Entity;
+                const uint32 otherBodyIndex = mRigidBodyComponents.getEntityIndex(otherBodyEntity);
+
+                if (isIslandBody(otherBodyIndex) && !mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex]) {
 
-            assert(mRigidBodyComponents.getBodyType(staticBodiesAddedToIsland[j]) == BodyType::STATIC);
-            mRigidBodyComponents.setIsAlreadyInIsland(staticBodiesAddedToIsland[j], false);
+                    assert(mIslandGraph.findRoot(mRigidBodyComponents.mIslandIds[otherBodyIndex]) == rootIslandId);
+
+                    mRigidBodyComponents.mIsAlreadyInIsland[otherBodyIndex] = true;
+                    visitedBodies.add(otherBodyIndex);
+                    bodiesToVisit.push(otherBodyIndex);
+                }
+            }
         }
+    }
 
-        staticBodiesAddedToIsland.clear();
+    // Release the islands that have been split (an island merged into another one after it has been
+    // marked is not marked anymore)
+    const uint32 nbIslandsToSplit = static_cast<uint32>(mIslandGraph.islandsToSplit.size());
+    for (uint32 i=0; i < nbIslandsToSplit; i++) {
+
+        const uint32 islandId = mIslandGraph.islandsToSplit[i];
+        if (mIslandGraph.isSplitNeeded[islandId]) {
+            mIslandGraph.destroyIsland(islandId);
+        }
     }
+    mIslandGraph.islandsToSplit.clear();
 
-    // Clear the associated contacts pairs of rigid bodies
-    const uint32 nbRigidBodyEnabledComponents = mRigidBodyComponents.getNbEnabledComponents();
-    for (uint32 b=0; b < nbRigidBodyEnabledComponents; b++) {
-        mRigidBodyComponents.mContactPairs[b].clear();
+    // Reset the isAlreadyInIsland variable of the visited bodies
+    const uint32 nbVisitedBodies = static_cast<uint32>(visitedBodies.size());
+    for (uint32 i=0; i < nbVisitedBodies; i++) {
+        mRigidBodyComponents.mIsAlreadyInIsland[visitedBodies[i]] = false;
+    }
+}
+
+// Add a body with its contacts and joints into the islands in the next frame
+/// This is used for the bodies that become awake non-static bodies and for the bodies that have new
+/// constraints that are not reported as new contacts (a new joint for instance)
+void PhysicsWorld::addBodyToIslands(Entity bodyEntity) {
+    mIslandGraph.bodiesToAdd.add(bodyEntity);
+}
+
+// Remove a body from its island (the island will be split in the next frame)
+void PhysicsWorld::removeBodyFromIsland(Entity bodyEntity) {
+
+    const uint32 bodyIndex = mRigidBodyComponents.getEntityIndex(bodyEntity);
+    mIslandGraph.markSplitNeeded(mRigidBodyComponents.mIslandIds[bodyIndex]);
+    mRigidBodyComponents.mIslandIds[bodyIndex] = IslandGraph::INVALID_ISLAND_ID;
+}
+
+// Add a constraint between an awake non-static body and another body into the islands
+/// The other body is woken up if it is sleeping and the islands of the two bodies are merged if the
+/// other body is also an awake non-static body (an island is created for a body that is not part of
+/// an island yet)
+void PhysicsWorld::addConstraintToIslands(uint32 bodyIndex, Entity otherBodyEntity) {
+
+    assert(isIslandBody(bodyIndex));
+
+    uint32 otherBodyIndex = mRigidBodyComponents.getEntityIndex(otherBodyEntity);
+
+    // Awake the other body if it is sleeping. This only moves disabled components and
+    // therefore does not change the index of the awake body.
+    if (mRigidBodyComponents.mIsSleeping[otherBodyIndex]) {
+
+        mRigidBodyComponents.mRigidBodies[otherBodyIndex]->setIsSleeping(false);
+        otherBodyIndex = mRigidBodyComponents.getEntityIndex(otherBodyEntity);
+    }
+
+    if (!isIslandBody(otherBodyIndex)) return;
+
+    if (mRigidBodyComponents.mIslandIds[bodyIndex] == IslandGraph::INVALID_ISLAND_ID) {
+        mRigidBodyComponents.mIslandIds[bodyIndex] = mIslandGraph.createIsland();
+    }
+    if (mRigidBodyComponents.mIslandIds[otherBodyIndex] == IslandGraph::INVALID_ISLAND_ID) {
+        mRigidBodyComponents.mIslandIds[otherBodyIndex] = mIslandGraph.createIsland();
+    }
+
+    mIslandGraph.merge(mRigidBodyComponents.mIslandIds[bodyIndex], mRigidBodyComponents.mIslandIds[otherBodyIndex]);
+}
+
+// Update the islands when the contacts of a collider start or stop being constraints
+/// This is used when a collider becomes a trigger or stops being a trigger. The island of its body
+/// might have to be split and the bodies of its overlapping pairs are added again into the islands
+/// with their contacts (the contacts that stop being triggers are not reported as new contacts).
+void PhysicsWorld::updateIslandsOfCollider(Entity colliderEntity) {
+
+    const Entity bodyEntity = mCollidersComponents.getBody(colliderEntity);
+    if (!mRigidBodyComponents.hasComponent(bodyEntity)) return;
+
+    mIslandGraph.markSplitNeeded(mRigidBodyComponents.getIslandId(bodyEntity));
+    addBodyToIslands(bodyEntity);
+
+    // For each overlapping pair of the collider
+    const Array<uint64>& overlappingPairs = mCollidersComponents.getOverlappingPairs(colliderEntity);
+    const uint32 nbOverlappingPairs = static_cast<uint32>(overlappingPairs.size());
+    for (uint32 i=0; i < nbOverlappingPairs; i++) {
+
+        const OverlappingPairs::OverlappingPair* pair = mCollisionDetection.mOverlappingPairs.getOverlappingPair(overlappingPairs[i]);
+        assert(pair != nullptr);
+
+        const Entity otherBodyEntity = mCollidersComponents.getBody(pair->collider1 == colliderEntity ? pair->collider2 : pair->collider1);
+        if (mRigidBodyComponents.hasComponent(otherBodyEntity)) {
+            addBodyToIslands(otherBodyEntity);
+        }
     }
 }
 
@@ -1019,6 +1859,28 @@ void PhysicsWorld::setNbIterationsPositionSolver(uint32 nbIterations) {
              "Physics World: Set nb iterations position solver to " + std::to_string(nbIterations),  __FILE__, __LINE__);
 }
 
+// Set the task scheduler used to execute the simulation on several threads
+/// The broad-phase and narrow-phase collision detection, the islands of the world and the integration
+/// of the bodies are executed in parallel using the task scheduler. Set a null task
+/// scheduler to run the whole simulation on the thread that calls update(). The task
+/// scheduler must not be destroyed while it is used by the world.
+/**
+ * @param taskScheduler A pointer to the task scheduler (can be null)
+ */
+void PhysicsWorld::setTaskScheduler(TaskScheduler* taskScheduler) {
+
+    mTaskScheduler = taskScheduler;
+
+    mDynamicsSystem.setTaskScheduler(taskScheduler);
+    mCollisionDetection.setTaskScheduler(taskScheduler);
+    mContactSolverSystem.setTaskScheduler(taskScheduler);
+    mConstraintSolverSystem.setTaskScheduler(taskScheduler);
+
+    RP3D_LOG(mConfig.worldName, Logger::Level::Information, Logger::Category::World,
+             std::string("Physics World: Set task scheduler (") + (taskScheduler != nullptr ? std::to_string(taskScheduler->getNbWorkers()) : std::string("1")) +
+             " workers)",  __FILE__, __LINE__);
+}
+
 // Set the gravity vector of the world
 /**
  * @param gravity The gravity vector (in meter per seconds squared)
@@ -0,0 +1,257 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/engine/SolverBodies.h>
+#include <reactphysics3d/engine/Islands.h>
+#include <reactphysics3d/components/JointComponents.h>
+#include <reactphysics3d/collision/ContactManifold.h>
+
+using namespace reactphysics3d;
+
+// Constructor
+SolverBodies::SolverBodies(MemoryAllocator& allocator, Islands& islands, RigidBodyComponents& rigidBodyComponents,
+                           JointComponents& jointComponents)
+             :mIslands(islands), mRigidBodyComponents(rigidBodyComponents), mJointComponents(jointComponents),
+              mRigidBodySolverIndices(allocator), rigidBodyComponentIndices(allocator), bodyTypes(allocator),
+              linearVelocities(allocator), angularVelocities(allocator), splitLinearVelocities(allocator),
+              splitAngularVelocities(allocator), positions(allocator), orientations(allocator), inverseMasses(allocator),
+              linearLockAxisFactors(allocator), angularLockAxisFactors(allocator), inverseInertiaTensorsLocal(allocator),
+              centersOfMassLocal(allocator), jointsBody1Indices(allocator), jointsBody2Indices(allocator),
+              contactManifoldsBody1Indices(allocator), contactManifoldsBody2Indices(allocator),
+              islandsSolvedByColors(allocator), nbIslandsSolvedByColors(0) {
+
+}
+
+// Add a solver body for a rigid body component and return its index
+uint32 SolverBodies::addSolverBody(uint32 rigidBodyComponentIndex) {
+
+    const uint32 solverIndex = static_cast<uint32>(rigidBodyComponentIndices.size());
+
+    rigidBodyComponentIndices.add(rigidBodyComponentIndex);
+    bodyTypes.add(mRigidBodyComponents.mBodyTypes[rigidBodyComponentIndex]);
+    linearVelocities.add(mRigidBodyComponents.mConstrainedLinearVelocities[rigidBodyComponentIndex]);
+    angularVelocities.add(mRigidBodyComponents.mConstrainedAngularVelocities[rigidBodyComponentIndex]);
+    splitLinearVelocities.add(mRigidBodyComponents.mSplitLinearVelocities[rigidBodyComponentIndex]);
+    splitAngularVelocities.add(mRigidBodyComponents.mSplitAngularVelocities[rigidBodyComponentIndex]);
+    positions.add(mRigidBodyComponents.mConstrainedPositions[rigidBodyComponentIndex]);
+    orientations.add(mRigidBodyComponents.mConstrainedOrientations[rigidBodyComponentIndex]);
+    inverseMasses.add(mRigidBodyComponents.mInverseMasses[rigidBodyComponentIndex]);
+    linearLockAxisFactors.add(mRigidBodyComponents.mLinearLockAxisFactors[rigidBodyComponentIndex]);
+    angularLockAxisFactors.add(mRigidBodyComponents.mAngularLockAxisFactors[rigidBodyComponentIndex]);
+    inverseInertiaTensorsLocal.add(mRigidBodyComponents.mInverseInertiaTensorsLocal[rigidBodyComponentIndex]);
+    centersOfMassLocal.add(mRigidBodyComponents.mCentersOfMassLocal[rigidBodyComponentIndex]);
+
+    mRigidBodySolverIndices[rigidBodyComponentIndex] = solverIndex;
+
+    return solverIndex;
+}
+
+// Return the index of the solver body of a rigid body component (create it if necessary)
+uint32 SolverBodies::getOrAddSolverBody(uint32 rigidBodyComponentIndex) {
+
+    const uint32 solverIndex = mRigidBodySolverIndices[rigidBodyComponentIndex];
+    if (solverIndex < rigidBodyComponentIndices.size() && rigidBodyComponentIndices[solverIndex] == rigidBodyComponentIndex) {
+        return solverIndex;
+    }
+
+    return addSolverBody(rigidBodyComponentIndex);
+}
+
+// Return the index of the solver body of a body of a constraint in a given island
+/// If the constraints of the island are solved by colors, a static or kinematic body gets
+/// a new solver body for each constraint. Because the colors only separate the constraints
+/// that share a dynamic body, the constraints of a color would otherwise write into the same
+/// solver body from different threads.
+uint32 SolverBodies::getConstraintSolverBody(uint32 rigidBodyComponentIndex, bool isIslandSolvedByColors) {
+
+    if (isIslandSolvedByColors && mRigidBodyComponents.mBodyTypes[rigidBodyComponentIndex] != BodyType::DYNAMIC) {
+        return addSolverBody(rigidBodyComponentIndex);
+    }
+
+    return getOrAddSolverBody(rigidBodyComponentIndex);
+}
+
+// Create the solver bodies of the islands and resolve the bodies of the joints and contact manifolds
+/// This method must be called after the integration of the velocities of the bodies
+/**
+ * @param contactManifolds Contact manifolds of the current frame
+ * @param minNbConstraintsSolvedByColors Minimum number of constraints (joints and contact
+ *        manifolds) of an island to solve its constraints by colors in parallel (zero if
+ *        no island must be solved by colors)
+ */
+void SolverBodies::initialize(const Array<ContactManifold>& contactManifolds, uint32 minNbConstraintsSolvedByColors) {
+
+    rigidBodyComponentIndices.clear();
+    bodyTypes.clear();
+    linearVelocities.clear();
+    angularVelocities.clear();
+    splitLinearVelocities.clear();
+    splitAngularVelocities.clear();
+    positions.clear();
+    orientations.clear();
+    inverseMasses.clear();
+    linearLockAxisFactors.clear();
+    angularLockAxisFactors.clear();
+    inverseInertiaTensorsLocal.clear();
+    centersOfMassLocal.clear();
+    jointsBody1Indices.clear();
+    jointsBody2Indices.clear();
+    contactManifoldsBody1Indices.clear();
+    contactManifoldsBody2Indices.clear();
+    islandsSolvedByColors.clear();
+    nbIslandsSolvedByColors = 0;
+
+    const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbComponents();
+    while (mRigidBodySolverIndices.size() < nbRigidBodyComponents) {
+        mRigidBodySolverIndices.add(INVALID_INDEX);
+    }
+
+    const uint32 nbIslandBodies = static_cast<uint32>(mIslands.bodyEntities.size());
+    rigidBodyComponentIndices.reserve(nbIslandBodies);
+    bodyTypes.reserve(nbIslandBodies);
+    linearVelocities.reserve(nbIslandBodies);
+    angularVelocities.reserve(nbIslandBodies);
+    splitLinearVelocities.reserve(nbIslandBodies);
+    splitAngularVelocities.reserve(nbIslandBodies);
+    positions.reserve(nbIslandBodies);
+    orientations.reserve(nbIslandBodies);
+    inverseMasses.reserve(nbIslandBodies);
+    linearLockAxisFactors.reserve(nbIslandBodies);
+    angularLockAxisFactors.reserve(nbIslandBodies);
+    inverseInertiaTensorsLocal.reserve(nbIslandBodies);
+    centersOfMassLocal.reserve(nbIslandBodies);
+
+    const uint32 nbEnabledJoints = mJointComponents.getNbEnabledComponents();
+    for (uint32 i=0; i < nbEnabledJoints; i++) {
+        jointsBody1Indices.add(INVALID_INDEX);
+        jointsBody2Indices.add(INVALID_INDEX);
+    }
+
+    const uint32 nbContactManifolds = static_cast<uint32>(contactManifolds.size());
+    for (uint32 i=0; i < nbContactManifolds; i++) {
+        contactManifoldsBody1Indices.add(INVALID_INDEX);
+        contactManifoldsBody2Indices.add(INVALID_INDEX);
+    }
+
+    // For each island
+    const uint32 nbIslands = mIslands.getNbIslands();
+    islandsSolvedByColors.reserve(nbIslands);
+    for (uint32 islandIndex=0; islandIndex < nbIslands; islandIndex++) {
+
+        const uint32 nbIslandConstraints = mIslands.nbJointsInIsland[islandIndex] + mIslands.nbContactManifolds[islandIndex];
+        const bool isSolvedByColors = minNbConstraintsSolvedByColors > 0 && nbIslandConstraints >= minNbConstraintsSolvedByColors;
+        islandsSolvedByColors.add(isSolvedByColors);
+        if (isSolvedByColors) nbIslandsSolvedByColors++;
+
+        // Create the solver bodies of the island. A static body that is shared with
+        // another island gets a new solver body in each island.
+        const uint32 startBodyIndex = mIslands.startBodyEntitiesIndex[islandIndex];
+        const uint32 endBodyIndex = startBodyIndex + mIslands.nbBodiesInIsland[islandIndex];
+        for (uint32 b=startBodyIndex; b < endBodyIndex; b++) {
+            addSolverBody(mRigidBodyComponents.getEntityIndex(mIslands.bodyEntities[b]));
+        }
+
+        // Resolve the bodies of the joints of the island
+        const uint32 startJointIndex = mIslands.startJointEntitiesIndex[islandIndex];
+        const uint32 endJointIndex = startJointIndex + mIslands.nbJointsInIsland[islandIndex];
+        for (uint32 j=startJointIndex; j < endJointIndex; j++) {
+
+            const uint32 jointIndex = mJointComponents.getEntityIndex(mIslands.jointEntities[j]);
+            assert(jointIndex < nbEnabledJoints);
+
+            jointsBody1Indices[jointIndex] = getConstraintSolverBody(mRigidBodyComponents.getEntityIndex(mJointComponents.mBody1Entities[jointIndex]), isSolvedByColors);
+            jointsBody2Indices[jointIndex] = getConstraintSolverBody(mRigidBodyComponents.getEntityIndex(mJointComponents.mBody2Entities[jointIndex]), isSolvedByColors);
+        }
+
+        // Resolve the bodies of the contact manifolds of the island
+        const uint32 startManifoldIndex = mIslands.contactManifoldsIndices[islandIndex];
+        const uint32 endManifoldIndex = startManifoldIndex + mIslands.nbContactManifolds[islandIndex];
+        for (uint32 m=startManifoldIndex; m < endManifoldIndex; m++) {
+
+            contactManifoldsBody1Indices[m] = getConstraintSolverBody(mRigidBodyComponents.getEntityIndex(contactManifolds[m].bodyEntity1), isSolvedByColors);
+            contactManifoldsBody2Indices[m] = getConstraintSolverBody(mRigidBodyComponents.getEntityIndex(contactManifolds[m].bodyEntity2), isSolvedByColors);
+        }
+    }
+
+    // The enabled joints that are not part of an island (between two static bodies for instance)
+    // are still solved on the serial path so their bodies also need to be resolved
+    for (uint32 j=0; j < nbEnabledJoints; j++) {
+
+        if (jointsBody1Indices[j] == INVALID_INDEX) {
+
+            jointsBody1Indices[j] = getOrAddSolverBody(mRigidBodyComponents.getEntityIndex(mJointComponents.mBody1Entities[j]));
+            jointsBody2Indices[j] = getOrAddSolverBody(mRigidBodyComponents.getEntityIndex(mJointComponents.mBody2Entities[j]));
+        }
+    }
+}
+
+// Write the constrained and split velocities back into the rigid body components
+void SolverBodies::storeVelocities() {
+
+    const uint32 nbBodies = getNbBodies();
+    for (uint32 i=0; i < nbBodies; i++) {
+
+        // The velocities of a static body are never modified by the solver
+        if (bodyTypes[i] == BodyType::STATIC) continue;
+
+        const uint32 componentIndex = rigidBodyComponentIndices[i];
+
+        mRigidBodyComponents.mConstrainedLinearVelocities[componentIndex] = linearVelocities[i];
+        mRigidBodyComponents.mConstrainedAngularVelocities[componentIndex] = angularVelocities[i];
+        mRigidBodyComponents.mSplitLinearVelocities[componentIndex] = splitLinearVelocities[i];
+        mRigidBodyComponents.mSplitAngularVelocities[componentIndex] = splitAngularVelocities[i];
+    }
+}
+
+// Read the constrained positions and orientations from the rigid body components
+/// This method must be called after the integration of the positions of the bodies
+void SolverBodies::loadPositions() {
+
+    const uint32 nbBodies = getNbBodies();
+    for (uint32 i=0; i < nbBodies; i++) {
+
+        const uint32 componentIndex = rigidBodyComponentIndices[i];
+
+        positions[i] = mRigidBodyComponents.mConstrainedPositions[componentIndex];
+        orientations[i] = mRigidBodyComponents.mConstrainedOrientations[componentIndex];
+    }
+}
+
+// Write the constrained positions and orientations back into the rigid body components
+void SolverBodies::storePositions() {
+
+    const uint32 nbBodies = getNbBodies();
+    for (uint32 i=0; i < nbBodies; i++) {
+
+        // The position of a static body is never modified by the solver
+        if (bodyTypes[i] == BodyType::STATIC) continue;
+
+        const uint32 componentIndex = rigidBodyComponentIndices[i];
+
+        mRigidBodyComponents.mConstrainedPositions[componentIndex] = positions[i];
+        mRigidBodyComponents.mConstrainedOrientations[componentIndex] = orientations[i];
+    }
+}
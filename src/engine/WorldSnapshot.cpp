@@ -0,0 +1,164 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/engine/WorldSnapshot.h>
+#include <reactphysics3d/engine/OverlappingPairs.h>
+#include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/ContactPair.h>
+#include <reactphysics3d/collision/ContactManifold.h>
+#include <reactphysics3d/constraint/ContactPoint.h>
+
+// We want to use the ReactPhysics3D namespace
+using namespace reactphysics3d;
+
+// Append raw bytes at the end of the snapshot
+void SnapshotWriter::write(const void* data, size_t size) {
+
+    if (size == 0) return;
+
+    const uint64 position = mData.size();
+    mData.addWithoutInit(size);
+    std::memcpy(&(mData[position]), data, size);
+}
+
+// Start a new section and return its start position
+uint32 SnapshotWriter::beginSection() {
+
+    const uint32 sectionStart = static_cast<uint32>(mData.size());
+    writeValue(uint32(0));
+
+    return sectionStart;
+}
+
+// Write the size of the section that starts at a given position
+void SnapshotWriter::endSection(uint32 sectionStart) {
+
+    const uint32 sectionSize = static_cast<uint32>(mData.size()) - sectionStart - sizeof(uint32);
+    std::memcpy(&(mData[sectionStart]), &sectionSize, sizeof(uint32));
+}
+
+// Read raw bytes from the snapshot
+void SnapshotReader::read(void* data, size_t size) {
+
+    if (size == 0) return;
+
+    // If there is not enough remaining data
+    if (!mIsValid || size > mSize - mPosition) {
+
+        mIsValid = false;
+        std::memset(data, 0, size);
+        return;
+    }
+
+    std::memcpy(data, mData + mPosition, size);
+    mPosition += static_cast<uint32>(size);
+}
+
+// Skip raw bytes of the snapshot
+void SnapshotReader::skip(size_t size) {
+
+    if (size == 0) return;
+
+    // If there is not enough remaining data
+    if (!mIsValid || size > mSize - mPosition) {
+        mIsValid = false;
+        return;
+    }
+
+    mPosition += static_cast<uint32>(size);
+}
+
+// Return a reader for the next section and move after the end of this section
+SnapshotReader SnapshotReader::readSection() {
+
+    uint32 sectionSize = 0;
+    readValue(sectionSize);
+
+    // If the section goes after the end of the data
+    if (!mIsValid || sectionSize > mSize - mPosition) {
+
+        mIsValid = false;
+
+        SnapshotReader invalidReader(nullptr, 0);
+        invalidReader.mIsValid = false;
+        return invalidReader;
+    }
+
+    SnapshotReader sectionReader(mData + mPosition, sectionSize);
+    mPosition += sectionSize;
+
+    return sectionReader;
+}
+
+// Constructor
+WorldSnapshot::WorldSnapshot(MemoryAllocator& allocator) : mData(allocator) {
+
+}
+
+// Write the header of a snapshot
+void WorldSnapshot::writeHeader(SnapshotWriter& writer) {
+
+    writer.writeValue(MAGIC_NUMBER);
+    writer.writeValue(VERSION);
+
+    // Size of the types that are copied as they are in the snapshot. A snapshot
+    // can only be read by a build of the library with the same memory layout.
+    writer.writeValue(static_cast<uint32>(sizeof(decimal)));
+    writer.writeValue(static_cast<uint32>(sizeof(TreeNode)));
+    writer.writeValue(static_cast<uint32>(sizeof(LastFrameCollisionInfo)));
+    writer.writeValue(static_cast<uint32>(sizeof(ContactPair)));
+    writer.writeValue(static_cast<uint32>(sizeof(ContactManifold)));
+    writer.writeValue(static_cast<uint32>(sizeof(ContactPoint)));
+}
+
+// Read the header of a snapshot and return true if the snapshot can be read by this build
+bool WorldSnapshot::readHeader(SnapshotReader& reader) {
+
+    uint32 magicNumber = 0;
+    uint32 version = 0;
+    reader.readValue(magicNumber);
+    reader.readValue(version);
+
+    uint32 typesSizes[6];
+    reader.readValues(typesSizes, 6);
+
+    return reader.isValid() && magicNumber == MAGIC_NUMBER && version == VERSION &&
+           typesSizes[0] == sizeof(decimal) && typesSizes[1] == sizeof(TreeNode) &&
+           typesSizes[2] == sizeof(LastFrameCollisionInfo) && typesSizes[3] == sizeof(ContactPair) &&
+           typesSizes[4] == sizeof(ContactManifold) && typesSizes[5] == sizeof(ContactPoint);
+}
+
+// Replace the binary data of the snapshot with a copy of the given data
+/**
+ * @param data Pointer to the binary data of a snapshot
+ * @param size Size (in bytes) of the data
+ */
+void WorldSnapshot::setData(const uint8* data, uint32 size) {
+
+    mData.clear();
+    SnapshotWriter writer(mData);
+    writer.write(data, size);
+}
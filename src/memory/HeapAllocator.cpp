@@ -27,6 +27,7 @@
 #include <reactphysics3d/memory/HeapAllocator.h>
 #include <reactphysics3d/memory/MemoryManager.h>
 #include <cstdlib>
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 
@@ -34,9 +35,47 @@ using namespace reactphysics3d;
 
 size_t HeapAllocator::INIT_ALLOCATED_SIZE = 5 * 1048576;    // 5 Mb
 
+namespace {
+
+// Return the index of the most significant bit set in a non-zero value
+int findLastSetBit(uint64 value) {
+
+    assert(value != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int index = 0;
+    while (value >>= 1) index++;
+    return index;
+#endif
+}
+
+// Return the index of the least significant bit set in a non-zero value
+int findFirstSetBit(uint64 value) {
+
+    assert(value != 0);
+
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int index = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+}
+
 // Constructor
 HeapAllocator::HeapAllocator(MemoryAllocator& baseAllocator, size_t initAllocatedMemory)
-              : mBaseAllocator(baseAllocator), mAllocatedMemory(0), mMemoryUnits(nullptr), mCachedFreeUnit(nullptr) {
+              : mBaseAllocator(baseAllocator), mAllocatedMemory(0), mMemoryUnits(nullptr), mNonEmptySizeClasses(0),
+                mNbUsedBytes(0), mPeakNbUsedBytes(0) {
+
+    memset(mFreeUnits, 0, sizeof(mFreeUnits));
 
 #ifndef NDEBUG
         mNbTimesAllocateMethodCalled = 0;
@@ -73,7 +112,8 @@ HeapAllocator::~HeapAllocator() {
 }
 
 /// Split a memory unit in two units. One of size "size" and the second with
-/// left over space. The second unit is put into the free memory units
+/// left over space. The second unit is put into the free memory units. The unit
+/// to split must have been removed from the free memory units before.
 void HeapAllocator::splitMemoryUnit(MemoryUnitHeader* unit, size_t size) {
 
     assert(size <= unit->size);
@@ -97,6 +137,9 @@ void HeapAllocator::splitMemoryUnit(MemoryUnitHeader* unit, size_t size) {
         unit->isNextContiguousMemory = true;
         unit->size = size;
 
+        // The left over space is a new free memory unit
+        addFreeUnit(newUnit);
+
        assert(unit->previousUnit == nullptr || unit->previousUnit->nextUnit == unit);
        assert(unit->nextUnit == nullptr || unit->nextUnit->previousUnit == unit);
 
@@ -110,7 +153,7 @@ void HeapAllocator::splitMemoryUnit(MemoryUnitHeader* unit, size_t size) {
 void* HeapAllocator::allocate(size_t size) {
 
     // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::lock_guard<AllocatorMutex> lock(mMutex);
 
     assert(size > 0);
 
@@ -121,58 +164,37 @@ void* HeapAllocator::allocate(size_t size) {
         mNbTimesAllocateMethodCalled++;
 #endif
 
-    MemoryUnitHeader* currentUnit = mMemoryUnits;
-    assert(mMemoryUnits->previousUnit == nullptr);
+    // Keep the next memory units aligned
+    size = alignSize(size);
 
-    // If there is a cached free memory unit
-    if (mCachedFreeUnit != nullptr) {
-        assert(!mCachedFreeUnit->isAllocated);
-
-        // If the cached free memory unit matches the request
-        if (size <= mCachedFreeUnit->size) {
-            currentUnit = mCachedFreeUnit;
-            mCachedFreeUnit = nullptr;
-        }
-    }
-
-    // For each memory unit
-    while (currentUnit != nullptr) {
-
-        // If we have found a free memory unit with size large enough for the allocation request
-        if (!currentUnit->isAllocated && size <= currentUnit->size) {
-
-            // Split the free memory unit in two memory units, one with the requested memory size
-            // and a second one with the left over space
-            splitMemoryUnit(currentUnit, size);
-
-            break;
-        }
+    assert(mMemoryUnits->previousUnit == nullptr);
 
-        currentUnit = currentUnit->nextUnit;
-    }
+    // Find a free memory unit with size large enough for the allocation request
+    MemoryUnitHeader* currentUnit = findFreeUnit(size);
 
     // If we have not found a large enough memory unit we need to allocate more memory
     if (currentUnit == nullptr) {
 
         reserve((mAllocatedMemory + size) * 2);
 
-        assert(mCachedFreeUnit != nullptr);
-        assert(!mCachedFreeUnit->isAllocated);
+        // The new memory unit is large enough at this point
+        currentUnit = findFreeUnit(size);
+        assert(currentUnit != nullptr);
+    }
 
-        // The cached free memory unit is large enough at this point
-        currentUnit = mCachedFreeUnit;
+    assert(!currentUnit->isAllocated);
+    assert(currentUnit->size >= size);
 
-        assert(currentUnit->size >= size);
+    removeFreeUnit(currentUnit);
 
-        splitMemoryUnit(currentUnit, size);
-    }
+    // Split the free memory unit in two memory units, one with the requested memory size
+    // and a second one with the left over space
+    splitMemoryUnit(currentUnit, size);
 
     currentUnit->isAllocated = true;
 
-    // Cache the next memory unit if it is not allocated
-    if (currentUnit->nextUnit != nullptr && !currentUnit->nextUnit->isAllocated) {
-        mCachedFreeUnit = currentUnit->nextUnit;
-    }
+    mNbUsedBytes += size;
+    mPeakNbUsedBytes = std::max(mPeakNbUsedBytes, mNbUsedBytes);
 
     // Return a pointer to the memory area inside the unit
     return static_cast<void*>(reinterpret_cast<unsigned char*>(currentUnit) + sizeof(MemoryUnitHeader));
@@ -182,7 +204,7 @@ void* HeapAllocator::allocate(size_t size) {
 void HeapAllocator::release(void* pointer, size_t size) {
 
     // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::lock_guard<AllocatorMutex> lock(mMutex);
 
     assert(size > 0);
 
@@ -193,6 +215,9 @@ void HeapAllocator::release(void* pointer, size_t size) {
         mNbTimesAllocateMethodCalled--;
 #endif
 
+    assert(mNbUsedBytes >= alignSize(size));
+    mNbUsedBytes -= alignSize(size);
+
     unsigned char* unitLocation = static_cast<unsigned char*>(pointer) - sizeof(MemoryUnitHeader);
     MemoryUnitHeader* unit = reinterpret_cast<MemoryUnitHeader*>(unitLocation);
     assert(unit->isAllocated);
@@ -206,6 +231,7 @@ void HeapAllocator::release(void* pointer, size_t size) {
         currentUnit = unit->previousUnit;
 
         // Merge the two contiguous memory units
+        removeFreeUnit(currentUnit);
         mergeUnits(unit->previousUnit, unit);
     }
 
@@ -213,10 +239,11 @@ void HeapAllocator::release(void* pointer, size_t size) {
     if (currentUnit->nextUnit != nullptr && !currentUnit->nextUnit->isAllocated && currentUnit->isNextContiguousMemory) {
 
         // Merge the two contiguous memory units
+        removeFreeUnit(currentUnit->nextUnit);
         mergeUnits(currentUnit, currentUnit->nextUnit);
     }
 
-    mCachedFreeUnit = currentUnit;
+    addFreeUnit(currentUnit);
 }
 
 // Merge two contiguous memory units that are not allocated.
@@ -261,7 +288,79 @@ void HeapAllocator::reserve(size_t sizeToAllocate) {
     // Add the memory unit at the beginning of the linked-list of memory units
     mMemoryUnits = memoryUnit;
 
-    mCachedFreeUnit = mMemoryUnits;
+    addFreeUnit(memoryUnit);
 
     mAllocatedMemory += sizeToAllocate;
 }
+
+// Return the size class of a free memory unit of a given size
+int HeapAllocator::computeSizeClass(size_t size) {
+
+    assert(size > 0);
+
+    return findLastSetBit(static_cast<uint64>(size));
+}
+
+// Add a free memory unit into the list of its size class
+void HeapAllocator::addFreeUnit(MemoryUnitHeader* unit) {
+
+    assert(!unit->isAllocated);
+
+    const int sizeClass = computeSizeClass(unit->size);
+
+    unit->previousFreeUnit = nullptr;
+    unit->nextFreeUnit = mFreeUnits[sizeClass];
+    if (mFreeUnits[sizeClass] != nullptr) {
+        mFreeUnits[sizeClass]->previousFreeUnit = unit;
+    }
+    mFreeUnits[sizeClass] = unit;
+
+    mNonEmptySizeClasses |= uint64(1) << sizeClass;
+}
+
+// Remove a free memory unit from the list of its size class
+void HeapAllocator::removeFreeUnit(MemoryUnitHeader* unit) {
+
+    assert(!unit->isAllocated);
+
+    const int sizeClass = computeSizeClass(unit->size);
+
+    if (unit->previousFreeUnit != nullptr) {
+        unit->previousFreeUnit->nextFreeUnit = unit->nextFreeUnit;
+    }
+    else {
+        assert(mFreeUnits[sizeClass] == unit);
+        mFreeUnits[sizeClass] = unit->nextFreeUnit;
+    }
+    if (unit->nextFreeUnit != nullptr) {
+        unit->nextFreeUnit->previousFreeUnit = unit->previousFreeUnit;
+    }
+
+    unit->previousFreeUnit = nullptr;
+    unit->nextFreeUnit = nullptr;
+
+    if (mFreeUnits[sizeClass] == nullptr) {
+        mNonEmptySizeClasses &= ~(uint64(1) << sizeClass);
+    }
+}
+
+// Return a free memory unit large enough for a given size (null if there is none)
+/// All the free units of the size classes above the class of the size are large enough and
+/// the first one of the smallest non-empty class is taken. Otherwise, the units of the class of
+/// the size are searched because some of them might be large enough.
+HeapAllocator::MemoryUnitHeader* HeapAllocator::findFreeUnit(size_t size) const {
+
+    const int sizeClass = computeSizeClass(size);
+
+    const uint64 largerClasses = sizeClass + 1 < NB_SIZE_CLASSES ? mNonEmptySizeClasses & (~uint64(0) << (sizeClass + 1)) : 0;
+    if (largerClasses != 0) {
+        return mFreeUnits[findFirstSetBit(largerClasses)];
+    }
+
+    MemoryUnitHeader* unit = mFreeUnits[sizeClass];
+    while (unit != nullptr && unit->size < size) {
+        unit = unit->nextFreeUnit;
+    }
+
+    return unit;
+}
@@ -35,9 +35,17 @@ using namespace reactphysics3d;
 bool PoolAllocator::isMapSizeToHeadIndexInitialized = false;
 size_t PoolAllocator::mUnitSizes[NB_HEAPS];
 int PoolAllocator::mMapSizeToHeapIndex[MAX_UNIT_SIZE + 1];
+uint32 PoolAllocator::mNbUnitsPerBatch[NB_HEAPS];
+std::atomic<uint64> PoolAllocator::mNbCreatedAllocators(0);
+thread_local PoolAllocator::ThreadCaches PoolAllocator::mThreadCaches;
+thread_local PoolAllocator::ThreadCachesReleaser PoolAllocator::mThreadCachesReleaser;
+std::mutex PoolAllocator::mExistingAllocatorsMutex;
+PoolAllocator* PoolAllocator::mExistingAllocators = nullptr;
 
 // Constructor
-PoolAllocator::PoolAllocator(MemoryAllocator& baseAllocator) : mBaseAllocator(baseAllocator) {
+PoolAllocator::PoolAllocator(MemoryAllocator& baseAllocator)
+              : mId(mNbCreatedAllocators.fetch_add(1) + 1), mPreviousExistingAllocator(nullptr),
+                mNextExistingAllocator(nullptr), mBaseAllocator(baseAllocator) {
 
     // Allocate some memory to manage the blocks
     mNbAllocatedMemoryBlocks = 64;
@@ -58,6 +66,9 @@ PoolAllocator::PoolAllocator(MemoryAllocator& baseAllocator) : mBaseAllocator(ba
         // be allocated in each different heap
         for (uint i=0; i < NB_HEAPS; i++) {
             mUnitSizes[i] = (i+1) * 8;
+
+            // The small memory units are moved by larger batches between the thread caches and the allocator
+            mNbUnitsPerBatch[i] = static_cast<uint32>(std::max(std::min(BATCH_SIZE / mUnitSizes[i], size_t(MAX_NB_UNITS_PER_BATCH)), size_t(1)));
         }
 
         // Initialize the lookup table that maps the size to allocated to the
@@ -76,11 +87,43 @@ PoolAllocator::PoolAllocator(MemoryAllocator& baseAllocator) : mBaseAllocator(ba
 
         isMapSizeToHeadIndexInitialized = true;
     }
+
+    // Add the allocator into the list of the existing allocators
+    std::lock_guard<std::mutex> lock(mExistingAllocatorsMutex);
+    mNextExistingAllocator = mExistingAllocators;
+    if (mExistingAllocators != nullptr) {
+        mExistingAllocators->mPreviousExistingAllocator = this;
+    }
+    mExistingAllocators = this;
 }
 
 // Destructor
 PoolAllocator::~PoolAllocator() {
 
+    // Remove the allocator from the list of the existing allocators so that
+    // the threads that exit do not give their cached memory units back to it
+    {
+        std::lock_guard<std::mutex> lock(mExistingAllocatorsMutex);
+        if (mPreviousExistingAllocator != nullptr) {
+            mPreviousExistingAllocator->mNextExistingAllocator = mNextExistingAllocator;
+        }
+        else {
+            mExistingAllocators = mNextExistingAllocator;
+        }
+        if (mNextExistingAllocator != nullptr) {
+            mNextExistingAllocator->mPreviousExistingAllocator = mPreviousExistingAllocator;
+        }
+    }
+
+    // Forget the cache of the calling thread for this allocator
+    if (!mThreadCaches.isThreadExiting) {
+        for (int i=0; i < NB_CACHES_PER_THREAD; i++) {
+            if (mThreadCaches.caches[i].allocatorId == mId) {
+                memset(&mThreadCaches.caches[i], 0, sizeof(ThreadCache));
+            }
+        }
+    }
+
     // Release the memory allocated for each block
     for (uint i=0; i<mNbCurrentMemoryBlocks; i++) {
         mBaseAllocator.release(mMemoryBlocks[i].memoryUnits, BLOCK_SIZE);
@@ -96,13 +139,200 @@ PoolAllocator::~PoolAllocator() {
 
 }
 
+// Constructor
+PoolAllocator::ThreadCachesReleaser::ThreadCachesReleaser() {
+    mThreadCaches.isReleaserCreated = true;
+}
+
+// Destructor
+/// The free memory units of the caches of the exiting thread are given back to their allocators
+/// and the allocators do not use the caches of this thread anymore.
+PoolAllocator::ThreadCachesReleaser::~ThreadCachesReleaser() {
+
+    mThreadCaches.isThreadExiting = true;
+
+    for (int i=0; i < NB_CACHES_PER_THREAD; i++) {
+        flushThreadCache(mThreadCaches.caches[i]);
+    }
+}
+
+// Return the cache of the calling thread for this allocator (null if the thread is exiting)
+PoolAllocator::ThreadCache* PoolAllocator::getThreadCache() {
+
+    ThreadCaches& threadCaches = mThreadCaches;
+
+    if (threadCaches.isThreadExiting) return nullptr;
+
+    for (int i=0; i < NB_CACHES_PER_THREAD; i++) {
+        if (threadCaches.caches[i].allocatorId == mId) {
+            return &threadCaches.caches[i];
+        }
+    }
+
+    // The first time the thread uses a cache, create the object that will release
+    // the caches of the thread when it exits
+    if (!threadCaches.isReleaserCreated) {
+        static_cast<void>(mThreadCachesReleaser);
+        assert(threadCaches.isReleaserCreated);
+    }
+
+    // Find an unused cache or give the memory units of a used cache back to its allocator
+    int cacheIndex = -1;
+    for (int i=0; i < NB_CACHES_PER_THREAD && cacheIndex < 0; i++) {
+        if (threadCaches.caches[i].allocatorId == 0) {
+            cacheIndex = i;
+        }
+    }
+    if (cacheIndex < 0) {
+        cacheIndex = static_cast<int>(threadCaches.nextReusedCache % NB_CACHES_PER_THREAD);
+        threadCaches.nextReusedCache++;
+        flushThreadCache(threadCaches.caches[cacheIndex]);
+    }
+
+    ThreadCache& cache = threadCaches.caches[cacheIndex];
+    memset(&cache, 0, sizeof(ThreadCache));
+    cache.allocatorId = mId;
+
+    return &cache;
+}
+
+// Give the free memory units of a thread cache back to its allocator (if it still exists)
+void PoolAllocator::flushThreadCache(ThreadCache& cache) {
+
+    if (cache.allocatorId == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mExistingAllocatorsMutex);
+
+        // Find the allocator of the cache
+        PoolAllocator* allocator = mExistingAllocators;
+        while (allocator != nullptr && allocator->mId != cache.allocatorId) {
+            allocator = allocator->mNextExistingAllocator;
+        }
+
+        // If the allocator still exists
+        if (allocator != nullptr) {
+            for (int i=0; i < NB_HEAPS; i++) {
+                if (cache.nbFreeMemoryUnits[i] > 0) {
+                    allocator->releaseBatch(cache, i, cache.nbFreeMemoryUnits[i]);
+                }
+            }
+        }
+    }
+
+    memset(&cache, 0, sizeof(ThreadCache));
+}
+
+// Give the free memory units cached by the calling thread back to the allocator
+void PoolAllocator::releaseThreadCache() {
+
+    if (mThreadCaches.isThreadExiting) return;
+
+    for (int i=0; i < NB_CACHES_PER_THREAD; i++) {
+
+        ThreadCache& cache = mThreadCaches.caches[i];
+        if (cache.allocatorId != mId) continue;
+
+        for (int j=0; j < NB_HEAPS; j++) {
+            if (cache.nbFreeMemoryUnits[j] > 0) {
+                releaseBatch(cache, j, cache.nbFreeMemoryUnits[j]);
+            }
+        }
+    }
+}
+
+// Allocate a new memory block for a heap and add its memory units into the free memory units
+/// The mutex of the allocator must be locked.
+void PoolAllocator::allocateMemoryBlock(int indexHeap) {
+
+    // If we need to allocate more memory to contains the blocks
+    if (mNbCurrentMemoryBlocks == mNbAllocatedMemoryBlocks) {
+
+        // Allocate more memory to contain the blocks
+        MemoryBlock* currentMemoryBlocks = mMemoryBlocks;
+        mNbAllocatedMemoryBlocks += 64;
+        mMemoryBlocks = static_cast<MemoryBlock*>(mBaseAllocator.allocate(mNbAllocatedMemoryBlocks * sizeof(MemoryBlock)));
+        memcpy(mMemoryBlocks, currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
+        memset(mMemoryBlocks + mNbCurrentMemoryBlocks, 0, 64 * sizeof(MemoryBlock));
+        mBaseAllocator.release(currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
+    }
+
+    // Allocate a new memory blocks for the corresponding heap and divide it in many
+    // memory units
+    MemoryBlock* newBlock = mMemoryBlocks + mNbCurrentMemoryBlocks;
+    newBlock->memoryUnits = static_cast<MemoryUnit*>(mBaseAllocator.allocate(BLOCK_SIZE));
+    assert(newBlock->memoryUnits != nullptr);
+    size_t unitSize = mUnitSizes[indexHeap];
+    size_t nbUnits = BLOCK_SIZE / unitSize;
+    assert(nbUnits * unitSize <= BLOCK_SIZE);
+    void* memoryUnitsStart = static_cast<void*>(newBlock->memoryUnits);
+    char* memoryUnitsStartChar = static_cast<char*>(memoryUnitsStart);
+    for (size_t i=0; i < nbUnits - 1; i++) {
+        void* unitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * i);
+        void* nextUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * (i+1));
+        MemoryUnit* unit = static_cast<MemoryUnit*>(unitPointer);
+        MemoryUnit* nextUnit = static_cast<MemoryUnit*>(nextUnitPointer);
+        unit->nextUnit = nextUnit;
+    }
+    void* lastUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize*(nbUnits-1));
+    MemoryUnit* lastUnit = static_cast<MemoryUnit*>(lastUnitPointer);
+    lastUnit->nextUnit = mFreeMemoryUnits[indexHeap];
+
+    // Add the new allocated block into the list of free memory units in the heap
+    mFreeMemoryUnits[indexHeap] = newBlock->memoryUnits;
+    mNbCurrentMemoryBlocks++;
+}
+
+// Move a batch of free memory units of a heap from the allocator to a thread cache
+void PoolAllocator::fillThreadCache(ThreadCache& cache, int indexHeap) {
+
+    std::lock_guard<AllocatorMutex> lock(mMutex);
+
+    // If there is no more free memory units in the corresponding heap
+    if (mFreeMemoryUnits[indexHeap] == nullptr) {
+        allocateMemoryBlock(indexHeap);
+    }
+
+    // Take the first memory units of the heap
+    MemoryUnit* firstUnit = mFreeMemoryUnits[indexHeap];
+    MemoryUnit* lastUnit = firstUnit;
+    uint32 nbUnits = 1;
+    while (nbUnits < mNbUnitsPerBatch[indexHeap] && lastUnit->nextUnit != nullptr) {
+        lastUnit = lastUnit->nextUnit;
+        nbUnits++;
+    }
+    mFreeMemoryUnits[indexHeap] = lastUnit->nextUnit;
+
+    // Add them into the cache
+    lastUnit->nextUnit = cache.freeMemoryUnits[indexHeap];
+    cache.freeMemoryUnits[indexHeap] = firstUnit;
+    cache.nbFreeMemoryUnits[indexHeap] += nbUnits;
+}
+
+// Move a batch of free memory units of a heap from a thread cache to the allocator
+void PoolAllocator::releaseBatch(ThreadCache& cache, int indexHeap, uint32 nbUnits) {
+
+    assert(nbUnits > 0 && nbUnits <= cache.nbFreeMemoryUnits[indexHeap]);
+
+    // Take the first memory units of the cache (without locking the allocator)
+    MemoryUnit* firstUnit = cache.freeMemoryUnits[indexHeap];
+    MemoryUnit* lastUnit = firstUnit;
+    for (uint32 i=1; i < nbUnits; i++) {
+        lastUnit = lastUnit->nextUnit;
+    }
+    cache.freeMemoryUnits[indexHeap] = lastUnit->nextUnit;
+    cache.nbFreeMemoryUnits[indexHeap] -= nbUnits;
+
+    // Add them into the free memory units of the heap
+    std::lock_guard<AllocatorMutex> lock(mMutex);
+    lastUnit->nextUnit = mFreeMemoryUnits[indexHeap];
+    mFreeMemoryUnits[indexHeap] = firstUnit;
+}
+
 // Allocate memory of a given size (in bytes) and return a pointer to the
 // allocated memory.
 void* PoolAllocator::allocate(size_t size) {
 
-    // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
-
     assert(size > 0);
 
     // We cannot allocate zero bytes
@@ -123,64 +353,39 @@ void* PoolAllocator::allocate(size_t size) {
     int indexHeap = mMapSizeToHeapIndex[size];
     assert(indexHeap >= 0 && indexHeap < NB_HEAPS);
 
-    // If there still are free memory units in the corresponding heap
-    if (mFreeMemoryUnits[indexHeap] != nullptr) {
+    ThreadCache* cache = getThreadCache();
 
-        // Return a pointer to the memory unit
-        MemoryUnit* unit = mFreeMemoryUnits[indexHeap];
-        mFreeMemoryUnits[indexHeap] = unit->nextUnit;
-        return unit;
-    }
-    else {  // If there is no more free memory units in the corresponding heap
+    // If the thread is exiting, take the memory unit directly from the allocator
+    if (cache == nullptr) {
 
-        // If we need to allocate more memory to contains the blocks
-        if (mNbCurrentMemoryBlocks == mNbAllocatedMemoryBlocks) {
+        std::lock_guard<AllocatorMutex> lock(mMutex);
 
-            // Allocate more memory to contain the blocks
-            MemoryBlock* currentMemoryBlocks = mMemoryBlocks;
-            mNbAllocatedMemoryBlocks += 64;
-            mMemoryBlocks = static_cast<MemoryBlock*>(mBaseAllocator.allocate(mNbAllocatedMemoryBlocks * sizeof(MemoryBlock)));
-            memcpy(mMemoryBlocks, currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
-            memset(mMemoryBlocks + mNbCurrentMemoryBlocks, 0, 64 * sizeof(MemoryBlock));
-            mBaseAllocator.release(currentMemoryBlocks, mNbCurrentMemoryBlocks * sizeof(MemoryBlock));
+        if (mFreeMemoryUnits[indexHeap] == nullptr) {
+            allocateMemoryBlock(indexHeap);
         }
 
-        // Allocate a new memory blocks for the corresponding heap and divide it in many
-        // memory units
-        MemoryBlock* newBlock = mMemoryBlocks + mNbCurrentMemoryBlocks;
-        newBlock->memoryUnits = static_cast<MemoryUnit*>(mBaseAllocator.allocate(BLOCK_SIZE));
-        assert(newBlock->memoryUnits != nullptr);
-        size_t unitSize = mUnitSizes[indexHeap];
-        size_t nbUnits = BLOCK_SIZE / unitSize;
-        assert(nbUnits * unitSize <= BLOCK_SIZE);
-        void* memoryUnitsStart = static_cast<void*>(newBlock->memoryUnits);
-        char* memoryUnitsStartChar = static_cast<char*>(memoryUnitsStart);
-        for (size_t i=0; i < nbUnits - 1; i++) {
-            void* unitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * i);
-            void* nextUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize * (i+1));
-            MemoryUnit* unit = static_cast<MemoryUnit*>(unitPointer);
-            MemoryUnit* nextUnit = static_cast<MemoryUnit*>(nextUnitPointer);
-            unit->nextUnit = nextUnit;
-        }
-        void* lastUnitPointer = static_cast<void*>(memoryUnitsStartChar + unitSize*(nbUnits-1));
-        MemoryUnit* lastUnit = static_cast<MemoryUnit*>(lastUnitPointer);
-        lastUnit->nextUnit = nullptr;
+        MemoryUnit* unit = mFreeMemoryUnits[indexHeap];
+        mFreeMemoryUnits[indexHeap] = unit->nextUnit;
+        return unit;
+    }
 
-        // Add the new allocated block into the list of free memory units in the heap
-        mFreeMemoryUnits[indexHeap] = newBlock->memoryUnits->nextUnit;
-        mNbCurrentMemoryBlocks++;
+    // If there is no more free memory units in the cache of the thread
+    if (cache->nbFreeMemoryUnits[indexHeap] == 0) {
 
-        // Return the pointer to the first memory unit of the new allocated block
-        return newBlock->memoryUnits;
+        // Take a batch of memory units from the allocator (this locks the allocator)
+        fillThreadCache(*cache, indexHeap);
     }
+
+    // Return a pointer to the memory unit
+    MemoryUnit* unit = cache->freeMemoryUnits[indexHeap];
+    cache->freeMemoryUnits[indexHeap] = unit->nextUnit;
+    cache->nbFreeMemoryUnits[indexHeap]--;
+    return unit;
 }
 
 // Release previously allocated memory.
 void PoolAllocator::release(void* pointer, size_t size) {
 
-    // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
-
     assert(size > 0);
 
     // Cannot release a 0-byte allocated memory
@@ -202,9 +407,27 @@ void PoolAllocator::release(void* pointer, size_t size) {
     int indexHeap = mMapSizeToHeapIndex[size];
     assert(indexHeap >= 0 && indexHeap < NB_HEAPS);
 
-    // Insert the released memory unit into the list of free memory units of the
-    // corresponding heap
     MemoryUnit* releasedUnit = static_cast<MemoryUnit*>(pointer);
-    releasedUnit->nextUnit = mFreeMemoryUnits[indexHeap];
-    mFreeMemoryUnits[indexHeap] = releasedUnit;
+
+    ThreadCache* cache = getThreadCache();
+
+    // If the thread is exiting, give the memory unit directly back to the allocator
+    if (cache == nullptr) {
+
+        std::lock_guard<AllocatorMutex> lock(mMutex);
+
+        releasedUnit->nextUnit = mFreeMemoryUnits[indexHeap];
+        mFreeMemoryUnits[indexHeap] = releasedUnit;
+        return;
+    }
+
+    // Insert the released memory unit into the cache of the thread
+    releasedUnit->nextUnit = cache->freeMemoryUnits[indexHeap];
+    cache->freeMemoryUnits[indexHeap] = releasedUnit;
+    cache->nbFreeMemoryUnits[indexHeap]++;
+
+    // If the cache contains too many memory units, give a batch back to the allocator
+    if (cache->nbFreeMemoryUnits[indexHeap] > 2 * mNbUnitsPerBatch[indexHeap]) {
+        releaseBatch(*cache, indexHeap, mNbUnitsPerBatch[indexHeap]);
+    }
 }
@@ -54,7 +54,10 @@ SingleFrameAllocator::~SingleFrameAllocator() {
 void* SingleFrameAllocator::allocate(size_t size) {
 
     // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::lock_guard<AllocatorMutex> lock(mMutex);
+
+    // Keep the next allocated memory locations aligned
+    size = alignSize(size);
 
     // Check that there is enough remaining memory in the buffer
     if (mCurrentOffset + size > mTotalSizeBytes) {
@@ -80,7 +83,7 @@ void* SingleFrameAllocator::allocate(size_t size) {
 void SingleFrameAllocator::release(void* pointer, size_t size) {
 
     // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::lock_guard<AllocatorMutex> lock(mMutex);
 
     // If allocated memory is not within the single frame allocation range
     char* p = static_cast<char*>(pointer);
@@ -95,7 +98,7 @@ void SingleFrameAllocator::release(void* pointer, size_t size) {
 void SingleFrameAllocator::reset() {
 
     // Lock the method with a mutex
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::lock_guard<AllocatorMutex> lock(mMutex);
 
     // If too much memory is allocated
     if (mCurrentOffset < mTotalSizeBytes / 2) {
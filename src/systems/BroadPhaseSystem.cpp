@@ -28,19 +28,32 @@
 #include <reactphysics3d/systems/CollisionDetectionSystem.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
+#include <reactphysics3d/collision/RayPacket.h>
 #include <reactphysics3d/memory/MemoryManager.h>
 #include <reactphysics3d/engine/PhysicsWorld.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
+#include <algorithm>
 
 // We want to use the ReactPhysics3D namespace
 using namespace reactphysics3d;
 
+// Static variables definition
+const uint32 BroadPhaseSystem::NB_MIN_MOVED_SHAPES_PER_TASK = 64;
+const uint32 BroadPhaseSystem::NB_MIN_RAY_PACKETS_PER_TASK = 64;
+const uint32 BroadPhaseSystem::NB_UPDATES_BETWEEN_TREE_COST_CHECKS = 60;
+
 // Constructor
 BroadPhaseSystem::BroadPhaseSystem(CollisionDetectionSystem& collisionDetection, ColliderComponents& collidersComponents,
                                    TransformComponents& transformComponents, RigidBodyComponents& rigidBodyComponents)
                     :mDynamicAABBTree(collisionDetection.getMemoryManager().getHeapAllocator(), DYNAMIC_TREE_FAT_AABB_INFLATE_PERCENTAGE),
+                     mStaticAABBTree(collisionDetection.getMemoryManager().getHeapAllocator()),
+                     mStaticWideTree(collisionDetection.getMemoryManager().getHeapAllocator()), mIsStaticWideTreeOutdated(false),
                      mCollidersComponents(collidersComponents), mTransformsComponents(transformComponents),
                      mRigidBodyComponents(rigidBodyComponents), mMovedShapes(collisionDetection.getMemoryManager().getHeapAllocator()),
-                     mCollisionDetection(collisionDetection) {
+                     mCollisionDetection(collisionDetection), mTaskScheduler(nullptr), mIsDeterministic(false),
+                     mRangesOverlappingNodes(collisionDetection.getMemoryManager().getHeapAllocator()),
+                     mTreeRebuildCostRatio(decimal(0.0)), mReferenceTreeCost(decimal(0.0)), mNbUpdatesSinceTreeCostCheck(0),
+                     mIsFatAABBExtrudedAlongDisplacement(false), mNbUpdatedColliders(0), mNbReinsertedColliders(0) {
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -59,8 +72,8 @@ bool BroadPhaseSystem::testOverlappingShapes(int32 shape1BroadPhaseId, int32 sha
     assert(shape1BroadPhaseId != -1 && shape2BroadPhaseId != -1);
 
     // Get the two AABBs of the collision shapes
-    const AABB& aabb1 = mDynamicAABBTree.getFatAABB(shape1BroadPhaseId);
-    const AABB& aabb2 = mDynamicAABBTree.getFatAABB(shape2BroadPhaseId);
+    const AABB& aabb1 = getFatAABB(shape1BroadPhaseId);
+    const AABB& aabb2 = getFatAABB(shape2BroadPhaseId);
 
     // Check if the two AABBs are overlapping
     return aabb1.testCollision(aabb2);
@@ -71,13 +84,79 @@ void BroadPhaseSystem::raycast(const Ray& ray, RaycastTest& raycastTest, unsigne
 
     RP3D_PROFILE("BroadPhaseSystem::raycast()", mProfiler);
 
-    BroadPhaseRaycastCallback broadPhaseRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastTest);
+    BroadPhaseRaycastCallback dynamicTreeRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastTest);
+
+    // Raycast against the dynamic tree and then against the static tree with the part of the ray
+    // that has not been clipped by the callback (unless the callback has stopped the raycast)
+    const decimal maxFraction = mDynamicAABBTree.raycast(ray, dynamicTreeRaycastCallback);
+    if (maxFraction > decimal(0.0)) {
 
-    // Compute the inverse ray direction
-    const Vector3 rayDirection = ray.point2 - ray.point1;
-    const Vector3 rayDirectionInverse(decimal(1.0) / rayDirection.x, decimal(1.0) / rayDirection.y, decimal(1.0) / rayDirection.z);
+        const Ray staticRay(ray.point1, ray.point2, maxFraction);
 
-    mDynamicAABBTree.raycast(ray, broadPhaseRaycastCallback);
+        // The wide copy of the static tree is only used if it is up to date
+        if (mIsStaticWideTreeOutdated) {
+            BroadPhaseRaycastCallback staticTreeRaycastCallback(mStaticAABBTree, raycastWithCategoryMaskBits, raycastTest);
+            mStaticAABBTree.raycast(staticRay, staticTreeRaycastCallback);
+        }
+        else {
+            BroadPhaseRaycastCallback staticTreeRaycastCallback(mStaticWideTree, raycastWithCategoryMaskBits, raycastTest);
+            mStaticWideTree.raycast(staticRay, staticTreeRaycastCallback);
+        }
+    }
+}
+
+// Ray casting method for a batch of rays
+/// The consecutive rays of the batch are grouped into packets of four rays that traverse the
+/// trees together, so the rays should be sorted such that consecutive rays are coherent. The
+/// packets traverse the dynamic tree and then the static tree with the rays that have not been
+/// terminated. The packets are processed in parallel if a task scheduler is set. The result of
+/// each ray only depends on the rays of its packet so it does not depend on the number of threads.
+void BroadPhaseSystem::raycastBatch(MemoryManager& memoryManager, const Ray* rays, uint32 nbRays,
+                                    RaycastBatchTest& raycastBatchTest, unsigned short raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("BroadPhaseSystem::raycastBatch()", mProfiler);
+
+    const uint32 nbPackets = (nbRays + RayPacket::NB_MAX_RAYS - 1) / RayPacket::NB_MAX_RAYS;
+
+    parallelFor(mTaskScheduler, nbPackets, NB_MIN_RAY_PACKETS_PER_TASK, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+
+        Stack<Pair<int32, uint32>> stack(memoryManager.getHeapAllocator(), 64);
+
+        BroadPhaseRaycastPacketCallback dynamicTreeRaycastCallback(mDynamicAABBTree, raycastWithCategoryMaskBits, raycastBatchTest);
+        BroadPhaseRaycastPacketCallback staticTreeRaycastCallback(mStaticAABBTree, raycastWithCategoryMaskBits, raycastBatchTest);
+        BroadPhaseRaycastPacketCallback staticWideTreeRaycastCallback(mStaticWideTree, raycastWithCategoryMaskBits, raycastBatchTest);
+
+        for (uint32 p=startIndex; p < endIndex; p++) {
+
+            // Create the packet with the next rays of the batch
+            RayPacket packet;
+            const uint32 endRayIndex = std::min((p + 1) * RayPacket::NB_MAX_RAYS, nbRays);
+            for (uint32 i=p * RayPacket::NB_MAX_RAYS; i < endRayIndex; i++) {
+                packet.addRay(rays[i], i);
+                raycastBatchTest.hits[i] = RaycastHit();
+            }
+
+            // Raycast against the dynamic tree and then against the static tree with the part of
+            // the rays that has not been clipped (the wide copy of the static tree is only used if
+            // it is up to date)
+            mDynamicAABBTree.raycastPacket(packet, dynamicTreeRaycastCallback, stack);
+            if (mIsStaticWideTreeOutdated) {
+                mStaticAABBTree.raycastPacket(packet, staticTreeRaycastCallback, stack);
+            }
+            else {
+                mStaticWideTree.raycastPacket(packet, staticWideTreeRaycastCallback, stack);
+            }
+        }
+    });
+}
+
+// Return true if a collider must be stored in the static tree
+/// The colliders of the static rigid bodies are stored in the static tree. The colliders of
+/// the collision bodies are stored in the dynamic tree because they can be moved at any time.
+bool BroadPhaseSystem::isColliderStatic(const Collider* collider) const {
+
+    const Entity bodyEntity = collider->getBody()->getEntity();
+    return mRigidBodyComponents.hasComponent(bodyEntity) && mRigidBodyComponents.getBodyType(bodyEntity) == BodyType::STATIC;
 }
 
 // Add a collider into the broad-phase collision detection
@@ -85,17 +164,81 @@ void BroadPhaseSystem::addCollider(Collider* collider, const AABB& aabb) {
 
     assert(collider->getBroadPhaseId() == -1);
 
-    // Add the collision shape into the dynamic AABB tree and get its broad-phase ID
-    int nodeId = mDynamicAABBTree.addObject(aabb, collider);
+    // Add the collision shape into the static or dynamic AABB tree and get its broad-phase ID
+    const bool isStatic = isColliderStatic(collider);
+    DynamicAABBTree& tree = isStatic ? mStaticAABBTree : mDynamicAABBTree;
+    const int32 broadPhaseId = computeBroadPhaseId(tree.addObject(aabb, collider), isStatic);
+    mIsStaticWideTreeOutdated |= isStatic;
 
     // Set the broad-phase ID of the collider
-    mCollidersComponents.setBroadPhaseId(collider->getEntity(), nodeId);
+    mCollidersComponents.setBroadPhaseId(collider->getEntity(), broadPhaseId);
 
     // Add the collision shape into the array of bodies that have moved (or have been created)
     // during the last simulation step
     addMovedCollider(collider->getBroadPhaseId(), collider);
 }
 
+// Add several colliders into the broad-phase collision detection at once
+/// The colliders of each tree are added in bulk instead of inserting them one by one
+void BroadPhaseSystem::addColliders(Collider* const* colliders, const AABB* aabbs, uint32 nbColliders) {
+
+    RP3D_PROFILE("BroadPhaseSystem::addColliders()", mProfiler);
+
+    MemoryAllocator& allocator = mCollisionDetection.getMemoryManager().getHeapAllocator();
+
+    // Split the colliders between the static and the dynamic trees
+    Array<Collider*> staticColliders(allocator);
+    Array<AABB> staticAABBs(allocator);
+    Array<Collider*> dynamicColliders(allocator, nbColliders);
+    Array<AABB> dynamicAABBs(allocator, nbColliders);
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        if (isColliderStatic(colliders[i])) {
+            staticColliders.add(colliders[i]);
+            staticAABBs.add(aabbs[i]);
+        }
+        else {
+            dynamicColliders.add(colliders[i]);
+            dynamicAABBs.add(aabbs[i]);
+        }
+    }
+
+    if (staticColliders.size() > 0) {
+        addCollidersToTree(&(staticColliders[0]), &(staticAABBs[0]), static_cast<uint32>(staticColliders.size()), true);
+    }
+    if (dynamicColliders.size() > 0) {
+        addCollidersToTree(&(dynamicColliders[0]), &(dynamicAABBs[0]), static_cast<uint32>(dynamicColliders.size()), false);
+    }
+}
+
+// Add several colliders into one of the two trees at once
+void BroadPhaseSystem::addCollidersToTree(Collider* const* colliders, const AABB* aabbs, uint32 nbColliders, bool isStaticTree) {
+
+    DynamicAABBTree& tree = isStaticTree ? mStaticAABBTree : mDynamicAABBTree;
+
+    Array<int32> nodeIds(mCollisionDetection.getMemoryManager().getHeapAllocator(), nbColliders);
+    nodeIds.addWithoutInit(nbColliders);
+
+    // Add the collision shapes into the tree
+    tree.addObjects(aabbs, nbColliders, &(nodeIds[0]));
+    mIsStaticWideTreeOutdated |= isStaticTree;
+
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        assert(colliders[i]->getBroadPhaseId() == -1);
+
+        tree.setNodeDataPointer(nodeIds[i], colliders[i]);
+
+        // Set the broad-phase ID of the collider
+        const int32 broadPhaseId = computeBroadPhaseId(nodeIds[i], isStaticTree);
+        mCollidersComponents.setBroadPhaseId(colliders[i]->getEntity(), broadPhaseId);
+
+        // Add the collision shape into the array of bodies that have moved (or have been created)
+        // during the last simulation step
+        addMovedCollider(broadPhaseId, colliders[i]);
+    }
+}
+
 // Remove a collider from the broad-phase collision detection
 void BroadPhaseSystem::removeCollider(Collider* collider) {
 
@@ -105,8 +248,9 @@ void BroadPhaseSystem::removeCollider(Collider* collider) {
 
     mCollidersComponents.setBroadPhaseId(collider->getEntity(), -1);
 
-    // Remove the collision shape from the dynamic AABB tree
-    mDynamicAABBTree.removeObject(broadPhaseID);
+    // Remove the collision shape from its AABB tree
+    getTree(broadPhaseID).removeObject(getNodeId(broadPhaseID));
+    mIsStaticWideTreeOutdated |= isInStaticTree(broadPhaseID);
 
     // Remove the collision shape into the array of shapes that have moved (or have been created)
     // during the last simulation step
@@ -122,41 +266,132 @@ void BroadPhaseSystem::updateCollider(Entity colliderEntity) {
     uint32 index = mCollidersComponents.mMapEntityToComponentIndex[colliderEntity];
 
     // Update the collider component
-    updateCollidersComponents(index, 1);
+    updateCollidersComponents(index, 1, false, decimal(0.0));
 }
 
 // Update the broad-phase state of all the enabled colliders
-void BroadPhaseSystem::updateColliders() {
+void BroadPhaseSystem::updateColliders(decimal timeStep) {
 
     RP3D_PROFILE("BroadPhaseSystem::updateColliders()", mProfiler);
 
-    // Update all the enabled collider components
+    mNbUpdatedColliders = 0;
+    mNbReinsertedColliders = 0;
+
+    // Update the enabled collider components of the bodies that have moved during the last update of
+    // the bodies state (the colliders are also updated when their body, their local transform or the
+    // size of their collision shape is modified by the user)
     if (mCollidersComponents.getNbEnabledComponents() > 0) {
-        updateCollidersComponents(0, mCollidersComponents.getNbEnabledComponents());
+        updateCollidersComponents(0, mCollidersComponents.getNbEnabledComponents(), true, timeStep);
+    }
+
+    checkTreeQuality();
+}
+
+// Rebuild the dynamic tree if its quality has degraded too much
+/// The leaf nodes of the moving colliders are removed and inserted again in the dynamic tree and
+/// the tree slowly becomes less efficient. Every few updates, the surface area heuristic (SAH)
+/// cost of the tree is compared with the smallest cost since the tree has been rebuilt for the
+/// last time. If it has become too large, the whole tree is rebuilt. The first check always
+/// rebuilds the tree because its reference cost is not known yet. The static tree does not
+/// change during the simulation and is only rebuilt by the rebuildTrees() method.
+void BroadPhaseSystem::checkTreeQuality() {
+
+    if (mTreeRebuildCostRatio == decimal(0.0)) return;
+
+    mNbUpdatesSinceTreeCostCheck++;
+    if (mNbUpdatesSinceTreeCostCheck < NB_UPDATES_BETWEEN_TREE_COST_CHECKS) return;
+    mNbUpdatesSinceTreeCostCheck = 0;
+
+    RP3D_PROFILE("BroadPhaseSystem::checkTreeQuality()", mProfiler);
+
+    const decimal cost = mDynamicAABBTree.computeSAHCost();
+
+    if (mReferenceTreeCost == decimal(0.0) || cost > mTreeRebuildCostRatio * mReferenceTreeCost) {
+
+        mDynamicAABBTree.rebuild();
+
+        mReferenceTreeCost = mDynamicAABBTree.computeSAHCost();
+    }
+    else {
+        mReferenceTreeCost = std::min(mReferenceTreeCost, cost);
+    }
+}
+
+// Build the compact copy of the static tree again if the static tree has been modified
+/// This is done before the static tree is queried for the overlapping pairs. The copy is not
+/// built again when the static colliders do not change. Therefore, moving many static bodies
+/// at each frame is slower than moving kinematic bodies.
+void BroadPhaseSystem::updateStaticWideTree() {
+
+    if (!mIsStaticWideTreeOutdated) return;
+
+    mStaticWideTree.build(mStaticAABBTree);
+    mIsStaticWideTreeOutdated = false;
+}
+
+// Rebuild the two trees using the surface area heuristic (SAH)
+/// The broad-phase ids of the colliders do not change.
+void BroadPhaseSystem::rebuildTrees() {
+
+    mStaticAABBTree.rebuild();
+    mDynamicAABBTree.rebuild();
+    mIsStaticWideTreeOutdated = true;
+
+    mReferenceTreeCost = mDynamicAABBTree.computeSAHCost();
+    mNbUpdatesSinceTreeCostCheck = 0;
+}
+
+// Set the margins of the fat AABBs of the dynamic tree
+/// By default, the fat AABB of a collider is its AABB inflated by a constant percentage of its size.
+/// A small object moving fast leaves its fat AABB almost every frame and is reinserted into the tree.
+/// If the fat AABBs are extruded along the displacement of the bodies, the fat AABB of a reinserted
+/// collider is also extended in the direction of the predicted displacement of its body during the
+/// next steps. The margins of the fat AABB are then clamped between a minimum and a maximum margin.
+/**
+ * @param isExtrudedAlongDisplacement True if the fat AABBs are extruded along the displacement of the bodies
+ * @param minMargin Minimum margin between the AABB and the fat AABB of a collider (in meters)
+ * @param maxMargin Maximum margin between the AABB and the fat AABB of a collider in each direction (in meters)
+ */
+void BroadPhaseSystem::setFatAABBMargins(bool isExtrudedAlongDisplacement, decimal minMargin, decimal maxMargin) {
+
+    mIsFatAABBExtrudedAlongDisplacement = isExtrudedAlongDisplacement;
+
+    if (isExtrudedAlongDisplacement) {
+        mDynamicAABBTree.setFatAABBMargins(minMargin, maxMargin, DYNAMIC_TREE_FAT_AABB_DISPLACEMENT_FACTOR);
+    }
+    else {
+        mDynamicAABBTree.setFatAABBMargins(decimal(0.0), DECIMAL_LARGEST, decimal(0.0));
     }
 }
 
 // Notify the broad-phase that a collision shape has moved and need to be updated
-void BroadPhaseSystem::updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
-                                              bool forceReInsert) {
+/// The method returns true if the collider has been reinserted into its tree.
+bool BroadPhaseSystem::updateColliderInternal(int32 broadPhaseId, Collider* collider, const AABB& aabb,
+                                              bool forceReInsert, const Vector3& displacement) {
 
     assert(broadPhaseId >= 0);
 
-    // Update the dynamic AABB tree according to the movement of the collision shape
-    bool hasBeenReInserted = mDynamicAABBTree.updateObject(broadPhaseId, aabb, forceReInsert);
+    // Update the AABB tree according to the movement of the collision shape
+    bool hasBeenReInserted = getTree(broadPhaseId).updateObject(getNodeId(broadPhaseId), aabb, forceReInsert, displacement);
 
     // If the collision shape has moved out of its fat AABB (and therefore has been reinserted
     // into the tree).
     if (hasBeenReInserted) {
 
+        mIsStaticWideTreeOutdated |= isInStaticTree(broadPhaseId);
+
         // Add the collision shape into the array of shapes that have moved (or have been created)
         // during the last simulation step
         addMovedCollider(broadPhaseId, collider);
     }
+
+    return hasBeenReInserted;
 }
 
 // Update the broad-phase state of some colliders components
-void BroadPhaseSystem::updateCollidersComponents(uint32 startIndex, uint32 nbItems) {
+/// If the fat AABBs are extruded along the displacement of the bodies, the displacement of a body
+/// is predicted with its linear velocity and the time step (zero to not extrude the fat AABBs).
+void BroadPhaseSystem::updateCollidersComponents(uint32 startIndex, uint32 nbItems, bool areUnmovedCollidersSkipped, decimal timeStep) {
 
     RP3D_PROFILE("BroadPhaseSystem::updateCollidersComponents()", mProfiler);
 
@@ -173,23 +408,42 @@ void BroadPhaseSystem::updateCollidersComponents(uint32 startIndex, uint32 nbIte
     for (uint32 i = startIndex; i < startIndex + nbItems; i++) {
 
         const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[i];
-        if (broadPhaseId != -1) {
+        if (broadPhaseId == -1) continue;
 
-            const Entity& bodyEntity = mCollidersComponents.mBodiesEntities[i];
-            const Transform& transform = mTransformsComponents.getTransform(bodyEntity);
+        // If the size of the collision shape has been changed by the user,
+        // we need to reset the broad-phase AABB to its new size
+        const bool forceReInsert = mCollidersComponents.mHasCollisionShapeChangedSize[i];
 
-            // Recompute the world-space AABB of the collision shape
-            AABB aabb;
-            mCollidersComponents.mCollisionShapes[i]->computeAABB(aabb, transform * mCollidersComponents.mLocalToBodyTransforms[i]);
+        const uint32 transformIndex = mTransformsComponents.mMapEntityToComponentIndex[mCollidersComponents.mBodiesEntities[i]];
+
+        // The static colliders and the colliders of the bodies that have not moved keep their AABB
+        if (areUnmovedCollidersSkipped && !forceReInsert &&
+            (isInStaticTree(broadPhaseId) || !mTransformsComponents.mHasTransformChanged[transformIndex])) {
+            continue;
+        }
+
+        // Recompute the world-space AABB of the collision shape
+        AABB aabb;
+        mCollidersComponents.mCollisionShapes[i]->computeAABB(aabb, mTransformsComponents.mTransforms[transformIndex] *
+                                                                    mCollidersComponents.mLocalToBodyTransforms[i]);
+
+        // Predict the displacement of the body during the next step
+        Vector3 displacement(0, 0, 0);
+        uint32 rigidBodyIndex;
+        if (mIsFatAABBExtrudedAlongDisplacement && timeStep > decimal(0.0) &&
+            mRigidBodyComponents.hasComponentGetIndex(mCollidersComponents.mBodiesEntities[i], rigidBodyIndex)) {
+            displacement = mRigidBodyComponents.mLinearVelocities[rigidBodyIndex] * timeStep;
+        }
 
-            // If the size of the collision shape has been changed by the user,
-            // we need to reset the broad-phase AABB to its new size
-            const bool forceReInsert = mCollidersComponents.mHasCollisionShapeChangedSize[i];
+        // Update the broad-phase state of the collider
+        const bool hasBeenReInserted = updateColliderInternal(broadPhaseId, mCollidersComponents.mColliders[i], aabb,
+                                                              forceReInsert, displacement);
 
-            // Update the broad-phase state of the collider
-            updateColliderInternal(broadPhaseId, mCollidersComponents.mColliders[i], aabb, forceReInsert);
+        mCollidersComponents.mHasCollisionShapeChangedSize[i] = false;
 
-            mCollidersComponents.mHasCollisionShapeChangedSize[i] = false;
+        if (areUnmovedCollidersSkipped) {
+            mNbUpdatedColliders++;
+            mNbReinsertedColliders += hasBeenReInserted ? 1 : 0;
         }
     }
 }
@@ -209,21 +463,191 @@ void BroadPhaseSystem::addMovedCollider(int broadPhaseID, Collider* collider) {
 }
 
 // Compute all the overlapping pairs of collision shapes
+/// The moved shapes are split into ranges that are tested against the dynamic AABB tree on
+/// several threads (if a task scheduler is set). Each range has its own output array and the
+/// arrays are merged in the order of the ranges. Therefore, the result does not depend on
+/// the number of threads. In the deterministic mode, the moved shapes are also sorted by
+/// broad-phase id so that the order of the new pairs does not depend on the hash set. The
+/// moved dynamic shapes are tested against the two trees but the moved static shapes are
+/// only tested against the dynamic tree.
 void BroadPhaseSystem::computeOverlappingPairs(MemoryManager& memoryManager, Array<Pair<int32, int32>>& overlappingNodes) {
 
     RP3D_PROFILE("BroadPhaseSystem::computeOverlappingPairs()", mProfiler);
 
     // Get the array of the colliders that have moved or have been created in the last frame
-    Array<int> shapesToTest = mMovedShapes.toArray(memoryManager.getHeapAllocator());
+    Array<int> shapesToTest = mMovedShapes.toArray(memoryManager.getSingleFrameAllocator());
+    const uint32 nbShapesToTest = static_cast<uint32>(shapesToTest.size());
 
-    // Ask the dynamic AABB tree to report all collision shapes that overlap with the shapes to test
-    mDynamicAABBTree.reportAllShapesOverlappingWithShapes(shapesToTest, 0, static_cast<uint32>(shapesToTest.size()), overlappingNodes);
+    if (mIsDeterministic) {
+        std::sort(shapesToTest.begin(), shapesToTest.end());
+    }
+
+    updateStaticWideTree();
+
+    // Split the moved shapes into ranges
+    const uint32 nbWorkers = mTaskScheduler != nullptr ? mTaskScheduler->getNbWorkers() : 1;
+    const uint32 nbMaxRanges = std::max(1u, std::min(nbWorkers, nbShapesToTest / NB_MIN_MOVED_SHAPES_PER_TASK));
+    const uint32 nbShapesPerRange = std::max(1u, (nbShapesToTest + nbMaxRanges - 1) / nbMaxRanges);
+    const uint32 nbRanges = (nbShapesToTest + nbShapesPerRange - 1) / nbShapesPerRange;
+    while (mRangesOverlappingNodes.size() < nbRanges) {
+        mRangesOverlappingNodes.emplace(memoryManager.getHeapAllocator());
+    }
+
+    // Ask the AABB trees to report all collision shapes that overlap with the shapes to test
+    parallelFor(mTaskScheduler, nbRanges, 1, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+
+        Stack<int32> stack(memoryManager.getSingleFrameAllocator(), 64);
+
+        for (uint32 r=startIndex; r < endIndex; r++) {
+
+            const uint32 startShapeIndex = r * nbShapesPerRange;
+            const uint32 endShapeIndex = std::min(startShapeIndex + nbShapesPerRange, nbShapesToTest);
+            Array<Pair<int32, int32>>& rangeOverlappingNodes = mRangesOverlappingNodes[r];
+
+            for (uint32 i=startShapeIndex; i < endShapeIndex; i++) {
+
+                const int32 broadPhaseId = shapesToTest[i];
+                const AABB& shapeAABB = getFatAABB(broadPhaseId);
+
+                // Test the shape against the dynamic tree
+                uint32 firstNewPairIndex = static_cast<uint32>(rangeOverlappingNodes.size());
+                mDynamicAABBTree.reportAllShapesOverlappingWithShape(broadPhaseId, shapeAABB, stack, rangeOverlappingNodes);
+                for (uint32 j=firstNewPairIndex; j < rangeOverlappingNodes.size(); j++) {
+                    rangeOverlappingNodes[j].second = computeBroadPhaseId(rangeOverlappingNodes[j].second, false);
+                }
+
+                // Test a dynamic shape against the wide copy of the static tree
+                if (!isInStaticTree(broadPhaseId)) {
+
+                    firstNewPairIndex = static_cast<uint32>(rangeOverlappingNodes.size());
+                    mStaticWideTree.reportAllShapesOverlappingWithShape(broadPhaseId, shapeAABB, stack, rangeOverlappingNodes);
+
+                    // The quantized AABBs are slightly larger than the AABBs of the static colliders. Therefore,
+                    // we only keep the pairs whose exact AABBs are overlapping.
+                    uint32 nbPairs = firstNewPairIndex;
+                    for (uint32 j=firstNewPairIndex; j < rangeOverlappingNodes.size(); j++) {
+
+                        const int32 nodeId = mStaticWideTree.getSourceNodeID(rangeOverlappingNodes[j].second);
+                        if (shapeAABB.testCollision(mStaticAABBTree.getFatAABB(nodeId))) {
+                            rangeOverlappingNodes[nbPairs] = Pair<int32, int32>(broadPhaseId, computeBroadPhaseId(nodeId, true));
+                            nbPairs++;
+                        }
+                    }
+                    while (rangeOverlappingNodes.size() > nbPairs) {
+                        rangeOverlappingNodes.removeAt(rangeOverlappingNodes.size() - 1);
+                    }
+                }
+            }
+        }
+    });
+
+    // Merge the overlapping nodes of the ranges
+    for (uint32 r=0; r < nbRanges; r++) {
+        mergeOverlappingNodes(mRangesOverlappingNodes[r], overlappingNodes);
+        mRangesOverlappingNodes[r].clear();
+    }
 
     // Reset the array of collision shapes that have move (or have been created) during the
     // last simulation step
     mMovedShapes.clear();
 }
 
+// Add the overlapping nodes of a range of moved shapes into the final array without duplicates
+/// A shape always overlaps with itself and a pair of shapes that have both moved is reported
+/// by both shapes. In this last case, we only keep the pair reported by the shape with the
+/// smallest broad-phase id.
+void BroadPhaseSystem::mergeOverlappingNodes(const Array<Pair<int32, int32>>& rangeOverlappingNodes, Array<Pair<int32, int32>>& overlappingNodes) const {
+
+    overlappingNodes.reserve(overlappingNodes.size() + rangeOverlappingNodes.size());
+
+    const uint32 nbOverlappingNodes = static_cast<uint32>(rangeOverlappingNodes.size());
+    for (uint32 i=0; i < nbOverlappingNodes; i++) {
+
+        const Pair<int32, int32>& nodePair = rangeOverlappingNodes[i];
+
+        if (nodePair.first < nodePair.second || (nodePair.first > nodePair.second && !mMovedShapes.contains(nodePair.second))) {
+            overlappingNodes.add(nodePair);
+        }
+    }
+}
+
+// Save the broad-phase trees and the moved colliders into a snapshot
+/// The static tree can be left out of the snapshot if it does not change between the save
+/// and the restore (for the checkpoints of the dynamic state of the world for instance).
+void BroadPhaseSystem::saveSnapshot(SnapshotWriter& writer, bool isStaticTreeSaved) const {
+
+    mDynamicAABBTree.saveSnapshot(writer);
+    if (isStaticTreeSaved) {
+        mStaticAABBTree.saveSnapshot(writer);
+    }
+
+    writer.writeValue(mReferenceTreeCost);
+    writer.writeValue(mNbUpdatesSinceTreeCostCheck);
+
+    writer.writeValue(static_cast<uint32>(mMovedShapes.size()));
+    for (auto it = mMovedShapes.begin(); it != mMovedShapes.end(); ++it) {
+        writer.writeValue(*it);
+    }
+}
+
+// Restore the broad-phase trees and the moved colliders from a snapshot
+/// The broad-phase ids of the colliders must have been restored before
+void BroadPhaseSystem::restoreSnapshot(SnapshotReader& reader, bool isStaticTreeSaved) {
+
+    mDynamicAABBTree.restoreSnapshot(reader);
+    if (isStaticTreeSaved) {
+        mStaticAABBTree.restoreSnapshot(reader);
+        mIsStaticWideTreeOutdated = true;
+    }
+
+    // The leaves of the trees point to the colliders of this world
+    const uint32 nbColliders = mCollidersComponents.getNbComponents();
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[i];
+        if (broadPhaseId != -1 && (isStaticTreeSaved || !isInStaticTree(broadPhaseId))) {
+            getTree(broadPhaseId).setNodeDataPointer(getNodeId(broadPhaseId), mCollidersComponents.mColliders[i]);
+        }
+    }
+
+    reader.readValue(mReferenceTreeCost);
+    reader.readValue(mNbUpdatesSinceTreeCostCheck);
+
+    mMovedShapes.clear();
+    uint32 nbMovedShapes = 0;
+    reader.readValue(nbMovedShapes);
+    for (uint32 i=0; i < nbMovedShapes && reader.isValid(); i++) {
+
+        int broadPhaseId = 0;
+        reader.readValue(broadPhaseId);
+        mMovedShapes.add(broadPhaseId);
+    }
+}
+
+// Skip the broad-phase trees and the moved colliders in a snapshot and return true if they can be restored
+/// The broad-phase is not modified
+bool BroadPhaseSystem::skipSnapshot(SnapshotReader& reader, bool isStaticTreeSaved) const {
+
+    if (!mDynamicAABBTree.skipSnapshot(reader)) {
+        return false;
+    }
+    if (isStaticTreeSaved && !mStaticAABBTree.skipSnapshot(reader)) {
+        return false;
+    }
+
+    reader.skipValue(mReferenceTreeCost);
+    reader.skipValue(mNbUpdatesSinceTreeCostCheck);
+
+    uint32 nbMovedShapes = 0;
+    reader.readValue(nbMovedShapes);
+    if (static_cast<uint64>(nbMovedShapes) * sizeof(int) > reader.getNbRemainingBytes()) {
+        return false;
+    }
+    reader.skip(nbMovedShapes * sizeof(int));
+
+    return reader.isValid();
+}
+
 // Called when a overlapping node has been found during the call to
 // DynamicAABBTree:reportAllShapesOverlappingWithAABB()
 void AABBOverlapCallback::notifyOverlappingNode(int nodeId) {
@@ -236,7 +660,8 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
     decimal hitFraction = decimal(-1.0);
 
     // Get the collider from the node
-    Collider* collider = static_cast<Collider*>(mDynamicAABBTree.getNodeDataPointer(nodeId));
+    Collider* collider = static_cast<Collider*>(mWideAABBTree != nullptr ? mWideAABBTree->getNodeDataPointer(nodeId) :
+                                                                           mDynamicAABBTree->getNodeDataPointer(nodeId));
 
     // Check if the raycast filtering mask allows raycast against this shape
     if ((mRaycastWithCategoryMaskBits & collider->getCollisionCategoryBits()) != 0) {
@@ -249,3 +674,20 @@ decimal BroadPhaseRaycastCallback::raycastBroadPhaseShape(int32 nodeId, const Ra
 
     return hitFraction;
 }
+
+// Called for a broad-phase shape that has to be tested against some rays of a packet
+void BroadPhaseRaycastPacketCallback::raycastBroadPhaseShape(int32 nodeId, RayPacket& packet, uint32 raysMask) {
+
+    // Get the collider from the node
+    Collider* collider = static_cast<Collider*>(mWideAABBTree != nullptr ? mWideAABBTree->getNodeDataPointer(nodeId) :
+                                                                           mDynamicAABBTree->getNodeDataPointer(nodeId));
+
+    // Check if the raycast filtering mask allows raycast against this shape
+    if ((mRaycastWithCategoryMaskBits & collider->getCollisionCategoryBits()) != 0) {
+
+        // Ask the collision detection to perform a ray cast test of the rays against
+        // the collider of this node because the rays are overlapping with the shape
+        // in the broad-phase
+        mRaycastBatchTest.raycastAgainstShape(collider, packet, raysMask);
+    }
+}
@@ -41,7 +41,9 @@
 #include <reactphysics3d/engine/EventListener.h>
 #include <reactphysics3d/collision/RaycastInfo.h>
 #include <reactphysics3d/containers/Pair.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <cassert>
+#include <algorithm>
 #include <iostream>
 
 // We want to use the ReactPhysics3D namespace
@@ -63,12 +65,14 @@ CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, Collider
                      mNarrowPhaseInput(mMemoryManager.getSingleFrameAllocator(), mOverlappingPairs), mPotentialContactPoints(mMemoryManager.getSingleFrameAllocator()),
                      mPotentialContactManifolds(mMemoryManager.getSingleFrameAllocator()), mContactPairs1(mMemoryManager.getPoolAllocator()),
                      mContactPairs2(mMemoryManager.getPoolAllocator()), mPreviousContactPairs(&mContactPairs1), mCurrentContactPairs(&mContactPairs2),
-                     mLostContactPairs(mMemoryManager.getSingleFrameAllocator()), mPreviousMapPairIdToContactPairIndex(mMemoryManager.getHeapAllocator()),
+                     mLostContactPairs(mMemoryManager.getSingleFrameAllocator()),
                      mContactManifolds1(mMemoryManager.getPoolAllocator()), mContactManifolds2(mMemoryManager.getPoolAllocator()),
                      mPreviousContactManifolds(&mContactManifolds1), mCurrentContactManifolds(&mContactManifolds2),
                      mContactPoints1(mMemoryManager.getPoolAllocator()), mContactPoints2(mMemoryManager.getPoolAllocator()),
                      mPreviousContactPoints(&mContactPoints1), mCurrentContactPoints(&mContactPoints2), mCollisionBodyContactPairsIndices(mMemoryManager.getSingleFrameAllocator()),
-                     mNbPreviousPotentialContactManifolds(0), mNbPreviousPotentialContactPoints(0), mTriangleHalfEdgeStructure(triangleHalfEdgeStructure) {
+                     mNewContactPairsIndices(mMemoryManager.getSingleFrameAllocator()),
+                     mNbPreviousPotentialContactManifolds(0), mNbPreviousPotentialContactPoints(0), mTriangleHalfEdgeStructure(triangleHalfEdgeStructure),
+                     mTaskScheduler(nullptr), mWorkerFrameAllocators(mMemoryManager.getHeapAllocator()) {
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -81,6 +85,45 @@ CollisionDetectionSystem::CollisionDetectionSystem(PhysicsWorld* world, Collider
 
 }
 
+// Destructor
+CollisionDetectionSystem::~CollisionDetectionSystem() {
+
+    destroyWorkerFrameAllocators();
+}
+
+// Set the task scheduler used to execute the broad-phase and narrow-phase on several threads
+/**
+ * @param taskScheduler A pointer to the task scheduler (can be null)
+ */
+void CollisionDetectionSystem::setTaskScheduler(TaskScheduler* taskScheduler) {
+
+    destroyWorkerFrameAllocators();
+
+    mTaskScheduler = taskScheduler;
+    mBroadPhaseSystem.setTaskScheduler(taskScheduler);
+
+    // Create a single frame allocator for each worker except the calling thread
+    if (mTaskScheduler != nullptr) {
+
+        HeapAllocator& heapAllocator = mMemoryManager.getHeapAllocator();
+        for (uint32 i=1; i < mTaskScheduler->getNbWorkers(); i++) {
+            SingleFrameAllocator* allocator = new (heapAllocator.allocate(sizeof(SingleFrameAllocator))) SingleFrameAllocator(heapAllocator);
+            mWorkerFrameAllocators.add(allocator);
+        }
+    }
+}
+
+// Destroy the single frame allocators of the workers
+void CollisionDetectionSystem::destroyWorkerFrameAllocators() {
+
+    HeapAllocator& heapAllocator = mMemoryManager.getHeapAllocator();
+    for (uint32 i=0; i < mWorkerFrameAllocators.size(); i++) {
+        mWorkerFrameAllocators[i]->~SingleFrameAllocator();
+        heapAllocator.release(mWorkerFrameAllocators[i], sizeof(SingleFrameAllocator));
+    }
+    mWorkerFrameAllocators.clear();
+}
+
 // Compute the collision detection
 void CollisionDetectionSystem::computeCollisionDetection() {
 
@@ -280,11 +323,8 @@ void CollisionDetectionSystem::updateOverlappingPairs(const Array<Pair<int32, in
                     const bodypair bodiesIndex = OverlappingPairs::computeBodiesIndexPair(body1Entity, body2Entity);
                     if (!mNoCollisionPairs.contains(bodiesIndex)) {
 
-                        // Compute the overlapping pair ID
-                        const uint64 pairId = pairNumbers(std::max(nodePair.first, nodePair.second), std::min(nodePair.first, nodePair.second));
-
                         // Check if the overlapping pair already exists
-                        OverlappingPairs::OverlappingPair* overlappingPair = mOverlappingPairs.getOverlappingPair(pairId);
+                        OverlappingPairs::OverlappingPair* overlappingPair = mOverlappingPairs.findOverlappingPair(collider1Index, collider2Index);
                         if (overlappingPair == nullptr) {
 
                             const unsigned short shape1CollideWithMaskBits = mCollidersComponents.mCollideWithMaskBits[collider1Index];
@@ -404,7 +444,7 @@ void CollisionDetectionSystem::computeMiddlePhaseCollisionSnapshot(Array<uint64>
 
         const uint64 pairId = convexPairs[p];
 
-        const uint64 pairIndex = mOverlappingPairs.mMapConvexPairIdToPairIndex[pairId];
+        const uint64 pairIndex = mOverlappingPairs.getPairIndex(pairId);
         assert(pairIndex < mOverlappingPairs.mConvexPairs.size());
 
         const Entity collider1Entity = mOverlappingPairs.mConvexPairs[pairIndex].collider1;
@@ -436,7 +476,7 @@ void CollisionDetectionSystem::computeMiddlePhaseCollisionSnapshot(Array<uint64>
     for (uint32 p=0; p < nbConcavePairs; p++) {
 
         const uint64 pairId = concavePairs[p];
-        const uint64 pairIndex = mOverlappingPairs.mMapConcavePairIdToPairIndex[pairId];
+        const uint64 pairIndex = mOverlappingPairs.getPairIndex(pairId);
 
         assert(mCollidersComponents.getBroadPhaseId(mOverlappingPairs.mConcavePairs[pairIndex].collider1) != -1);
         assert(mCollidersComponents.getBroadPhaseId(mOverlappingPairs.mConcavePairs[pairIndex].collider2) != -1);
@@ -547,15 +587,12 @@ void CollisionDetectionSystem::computeConvexVsConcaveMiddlePhase(OverlappingPair
 bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseInput& narrowPhaseInput,
                                                         bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator) {
 
-    bool contactFound = false;
+    // If the narrow-phase can be executed on several threads
+    if (mTaskScheduler != nullptr && mTaskScheduler->getNbWorkers() > 1) {
+        return testNarrowPhaseCollisionParallel(narrowPhaseInput, clipWithPreviousAxisIfStillColliding, allocator);
+    }
 
-    // Get the narrow-phase collision detection algorithms for each kind of collision shapes
-    SphereVsSphereAlgorithm* sphereVsSphereAlgo = mCollisionDispatch.getSphereVsSphereAlgorithm();
-    SphereVsCapsuleAlgorithm* sphereVsCapsuleAlgo = mCollisionDispatch.getSphereVsCapsuleAlgorithm();
-    CapsuleVsCapsuleAlgorithm* capsuleVsCapsuleAlgo = mCollisionDispatch.getCapsuleVsCapsuleAlgorithm();
-    SphereVsConvexPolyhedronAlgorithm* sphereVsConvexPolyAlgo = mCollisionDispatch.getSphereVsConvexPolyhedronAlgorithm();
-    CapsuleVsConvexPolyhedronAlgorithm* capsuleVsConvexPolyAlgo = mCollisionDispatch.getCapsuleVsConvexPolyhedronAlgorithm();
-    ConvexPolyhedronVsConvexPolyhedronAlgorithm* convexPolyVsConvexPolyAlgo = mCollisionDispatch.getConvexPolyhedronVsConvexPolyhedronAlgorithm();
+    bool contactFound = false;
 
     // get the narrow-phase batches to test for collision for contacts
     NarrowPhaseInfoBatch& sphereVsSphereBatchContacts = narrowPhaseInput.getSphereVsSphereBatch();
@@ -566,23 +603,114 @@ bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseInput& narrow
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatchContacts = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
 
     // Compute the narrow-phase collision detection for each kind of collision shapes (for contacts)
-    if (sphereVsSphereBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsSphereAlgo->testCollision(sphereVsSphereBatchContacts, 0, sphereVsSphereBatchContacts.getNbObjects(), allocator);
-    }
-    if (sphereVsCapsuleBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsCapsuleAlgo->testCollision(sphereVsCapsuleBatchContacts, 0, sphereVsCapsuleBatchContacts.getNbObjects(), allocator);
-    }
-    if (capsuleVsCapsuleBatchContacts.getNbObjects() > 0) {
-        contactFound |= capsuleVsCapsuleAlgo->testCollision(capsuleVsCapsuleBatchContacts, 0, capsuleVsCapsuleBatchContacts.getNbObjects(), allocator);
+    contactFound |= testNarrowPhaseCollision(NarrowPhaseAlgorithmType::SphereVsSphere, sphereVsSphereBatchContacts, 0,
+                                             sphereVsSphereBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+    contactFound |= testNarrowPhaseCollision(NarrowPhaseAlgorithmType::SphereVsCapsule, sphereVsCapsuleBatchContacts, 0,
+                                             sphereVsCapsuleBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+    contactFound |= testNarrowPhaseCollision(NarrowPhaseAlgorithmType::CapsuleVsCapsule, capsuleVsCapsuleBatchContacts, 0,
+                                             capsuleVsCapsuleBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+    contactFound |= testNarrowPhaseCollision(NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron, sphereVsConvexPolyhedronBatchContacts, 0,
+                                             sphereVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+    contactFound |= testNarrowPhaseCollision(NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron, capsuleVsConvexPolyhedronBatchContacts, 0,
+                                             capsuleVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+    contactFound |= testNarrowPhaseCollision(NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron, convexPolyhedronVsConvexPolyhedronBatchContacts, 0,
+                                             convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    return contactFound;
+}
+
+// Execute the narrow-phase collision detection algorithm on a range of items of a batch
+bool CollisionDetectionSystem::testNarrowPhaseCollision(NarrowPhaseAlgorithmType algorithmType, NarrowPhaseInfoBatch& batch, uint32 startIndex,
+                                                        uint32 nbItems, bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator) {
+
+    if (nbItems == 0) return false;
+
+    switch(algorithmType) {
+
+        case NarrowPhaseAlgorithmType::SphereVsSphere:
+            return mCollisionDispatch.getSphereVsSphereAlgorithm()->testCollision(batch, startIndex, nbItems, allocator);
+        case NarrowPhaseAlgorithmType::SphereVsCapsule:
+            return mCollisionDispatch.getSphereVsCapsuleAlgorithm()->testCollision(batch, startIndex, nbItems, allocator);
+        case NarrowPhaseAlgorithmType::CapsuleVsCapsule:
+            return mCollisionDispatch.getCapsuleVsCapsuleAlgorithm()->testCollision(batch, startIndex, nbItems, allocator);
+        case NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron:
+            return mCollisionDispatch.getSphereVsConvexPolyhedronAlgorithm()->testCollision(batch, startIndex, nbItems,
+                                                                                            clipWithPreviousAxisIfStillColliding, allocator);
+        case NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron:
+            return mCollisionDispatch.getCapsuleVsConvexPolyhedronAlgorithm()->testCollision(batch, startIndex, nbItems,
+                                                                                             clipWithPreviousAxisIfStillColliding, allocator);
+        case NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron:
+            return mCollisionDispatch.getConvexPolyhedronVsConvexPolyhedronAlgorithm()->testCollision(batch, startIndex, nbItems,
+                                                                                                      clipWithPreviousAxisIfStillColliding, allocator);
+        case NarrowPhaseAlgorithmType::None:
+            break;
     }
-    if (sphereVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= sphereVsConvexPolyAlgo->testCollision(sphereVsConvexPolyhedronBatchContacts, 0, sphereVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    return false;
+}
+
+// Execute the narrow-phase collision detection algorithm on batches using the task scheduler
+/// Each batch is split into ranges of items and the ranges of all the batches are tested in parallel.
+/// The narrow-phase algorithms only write the results into the items of their own range and each
+/// worker uses its own single frame allocator for the temporary memory. The results are then merged
+/// in the order of the ranges so that the output does not depend on the number of workers.
+bool CollisionDetectionSystem::testNarrowPhaseCollisionParallel(NarrowPhaseInput& narrowPhaseInput,
+                                                                bool clipWithPreviousAxisIfStillColliding, MemoryAllocator& allocator) {
+
+    RP3D_PROFILE("CollisionDetectionSystem::testNarrowPhaseCollisionParallel()", mProfiler);
+
+    const uint32 nbWorkers = mTaskScheduler->getNbWorkers();
+    assert(mWorkerFrameAllocators.size() + 1 == nbWorkers);
+
+    NarrowPhaseInfoBatch* batches[] = {&narrowPhaseInput.getSphereVsSphereBatch(), &narrowPhaseInput.getSphereVsCapsuleBatch(),
+                                       &narrowPhaseInput.getCapsuleVsCapsuleBatch(), &narrowPhaseInput.getSphereVsConvexPolyhedronBatch(),
+                                       &narrowPhaseInput.getCapsuleVsConvexPolyhedronBatch(),
+                                       &narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch()};
+    const NarrowPhaseAlgorithmType algorithmTypes[] = {NarrowPhaseAlgorithmType::SphereVsSphere, NarrowPhaseAlgorithmType::SphereVsCapsule,
+                                                       NarrowPhaseAlgorithmType::CapsuleVsCapsule, NarrowPhaseAlgorithmType::SphereVsConvexPolyhedron,
+                                                       NarrowPhaseAlgorithmType::CapsuleVsConvexPolyhedron,
+                                                       NarrowPhaseAlgorithmType::ConvexPolyhedronVsConvexPolyhedron};
+
+    // Split each batch into ranges of items
+    Array<NarrowPhaseBatchRange> ranges(allocator, 6 * nbWorkers);
+    for (uint32 b=0; b < 6; b++) {
+
+        const uint32 nbObjects = batches[b]->getNbObjects();
+        if (nbObjects == 0) continue;
+
+        const uint32 nbRanges = std::max(1u, std::min(nbWorkers, nbObjects / NB_MIN_NARROW_PHASE_ITEMS_PER_TASK));
+        const uint32 nbItemsPerRange = (nbObjects + nbRanges - 1) / nbRanges;
+
+        // Each range adds its contact points into its own pool of the batch
+        batches[b]->setNbItemsPerContactPointPool(nbItemsPerRange);
+
+        for (uint32 startIndex=0; startIndex < nbObjects; startIndex += nbItemsPerRange) {
+            ranges.emplace(algorithmTypes[b], batches[b], startIndex, std::min(nbItemsPerRange, nbObjects - startIndex));
+        }
     }
-    if (capsuleVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= capsuleVsConvexPolyAlgo->testCollision(capsuleVsConvexPolyhedronBatchContacts, 0, capsuleVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    // Test the ranges in parallel
+    parallelFor(mTaskScheduler, static_cast<uint32>(ranges.size()), 1, [&](uint32 startIndex, uint32 endIndex, uint32 workerIndex) {
+
+        MemoryAllocator& workerAllocator = workerIndex == 0 ? allocator : *(mWorkerFrameAllocators[workerIndex - 1]);
+
+        for (uint32 r=startIndex; r < endIndex; r++) {
+
+            NarrowPhaseBatchRange& range = ranges[r];
+            range.contactFound = testNarrowPhaseCollision(range.algorithmType, *range.batch, range.startIndex, range.nbItems,
+                                                          clipWithPreviousAxisIfStillColliding, workerAllocator);
+        }
+    });
+
+    // Merge the results of the ranges
+    bool contactFound = false;
+    for (uint32 r=0; r < ranges.size(); r++) {
+        contactFound |= ranges[r].contactFound;
     }
-    if (convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects() > 0) {
-        contactFound |= convexPolyVsConvexPolyAlgo->testCollision(convexPolyhedronVsConvexPolyhedronBatchContacts, 0, convexPolyhedronVsConvexPolyhedronBatchContacts.getNbObjects(), clipWithPreviousAxisIfStillColliding, allocator);
+
+    // The temporary memory of the workers is not needed anymore
+    for (uint32 i=0; i < mWorkerFrameAllocators.size(); i++) {
+        mWorkerFrameAllocators[i]->reset();
     }
 
     return contactFound;
@@ -596,8 +724,6 @@ void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& nar
 
     assert(contactPairs->size() == 0);
 
-    Map<uint64, uint> mapPairIdToContactPairIndex(mMemoryManager.getHeapAllocator(), mPreviousMapPairIdToContactPairIndex.size());
-
     // get the narrow-phase batches to test for collision
     NarrowPhaseInfoBatch& sphereVsSphereBatch = narrowPhaseInput.getSphereVsSphereBatch();
     NarrowPhaseInfoBatch& sphereVsCapsuleBatch = narrowPhaseInput.getSphereVsCapsuleBatch();
@@ -607,13 +733,13 @@ void CollisionDetectionSystem::processAllPotentialContacts(NarrowPhaseInput& nar
     NarrowPhaseInfoBatch& convexPolyhedronVsConvexPolyhedronBatch = narrowPhaseInput.getConvexPolyhedronVsConvexPolyhedronBatch();
 
     // Process the potential contacts
-    processPotentialContacts(sphereVsSphereBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, mapPairIdToContactPairIndex, contactPairs);
-    processPotentialContacts(sphereVsCapsuleBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, mapPairIdToContactPairIndex, contactPairs);
-    processPotentialContacts(capsuleVsCapsuleBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, mapPairIdToContactPairIndex, contactPairs);
-    processPotentialContacts(sphereVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, mapPairIdToContactPairIndex, contactPairs);
-    processPotentialContacts(capsuleVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, mapPairIdToContactPairIndex, contactPairs);
+    processPotentialContacts(sphereVsSphereBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, contactPairs);
+    processPotentialContacts(sphereVsCapsuleBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, contactPairs);
+    processPotentialContacts(capsuleVsCapsuleBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, contactPairs);
+    processPotentialContacts(sphereVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, contactPairs);
+    processPotentialContacts(capsuleVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints, potentialContactManifolds, contactPairs);
     processPotentialContacts(convexPolyhedronVsConvexPolyhedronBatch, updateLastFrameInfo, potentialContactPoints,
-                             potentialContactManifolds, mapPairIdToContactPairIndex, contactPairs);
+                             potentialContactManifolds, contactPairs);
 }
 
 // Compute the narrow-phase collision detection
@@ -642,45 +768,71 @@ void CollisionDetectionSystem::computeNarrowPhase() {
     // Add the contact pairs to the bodies
     addContactPairsToBodies();
 
+    // Compute the lost contacts (contact pairs that were colliding in previous frame but not in this one).
+    // They are computed before the islands because an island that has lost a contact might have to be split.
+    computeLostContactPairs();
+
     assert(mCurrentContactManifolds->size() == 0);
     assert(mCurrentContactPoints->size() == 0);
 }
 
 // Add the contact pairs to the corresponding bodies
+/// A contact pair between two rigid bodies that is not a trigger is a constraint of the islands. It is
+/// added to the contact pairs of its awake non-static bodies (used to create the islands later) and
+/// its index is stored if its bodies were not touching in the previous frame (the islands of the two
+/// bodies will be merged).
 void CollisionDetectionSystem::addContactPairsToBodies() {
 
+    const uint32 nbEnabledRigidBodies = mRigidBodyComponents.getNbEnabledComponents();
     const uint32 nbContactPairs = static_cast<uint32>(mCurrentContactPairs->size());
     for (uint32 p=0 ; p < nbContactPairs; p++) {
 
         ContactPair& contactPair = (*mCurrentContactPairs)[p];
 
-        const bool isBody1Rigid = mRigidBodyComponents.hasComponent(contactPair.body1Entity);
-        const bool isBody2Rigid = mRigidBodyComponents.hasComponent(contactPair.body2Entity);
-
-        // Add the associated contact pair to both bodies of the pair (used to create islands later)
-        if (isBody1Rigid) {
-           mRigidBodyComponents.addContacPair(contactPair.body1Entity, p);
-        }
-        if (isBody2Rigid) {
-           mRigidBodyComponents.addContacPair(contactPair.body2Entity, p);
-        }
+        uint32 body1Index, body2Index;
+        const bool isBody1Rigid = mRigidBodyComponents.hasComponentGetIndex(contactPair.body1Entity, body1Index);
+        const bool isBody2Rigid = mRigidBodyComponents.hasComponentGetIndex(contactPair.body2Entity, body2Index);
 
         // If at least one of the two bodies is a CollisionBody
         if (!isBody1Rigid || !isBody2Rigid) {
 
             // Add the pair index to the array of pairs with CollisionBody
             mCollisionBodyContactPairsIndices.add(p);
+
+            continue;
+        }
+
+        if (contactPair.isTrigger) continue;
+
+        const bool isBody1Static = mRigidBodyComponents.mBodyTypes[body1Index] == BodyType::STATIC;
+        const bool isBody2Static = mRigidBodyComponents.mBodyTypes[body2Index] == BodyType::STATIC;
+
+        // Add the associated contact pair to the awake non-static bodies of the pair
+        if (!isBody1Static && body1Index < nbEnabledRigidBodies) {
+            mRigidBodyComponents.mContactPairs[body1Index].add(p);
+        }
+        if (!isBody2Static && body2Index < nbEnabledRigidBodies) {
+            mRigidBodyComponents.mContactPairs[body2Index].add(p);
+        }
+
+        // If the two bodies start touching each other (a static body that has been put to sleep
+        // with an island must also be woken up by an awake body)
+        if (!contactPair.collidingInPreviousFrame) {
+            mNewContactPairsIndices.add(p);
         }
     }
 }
 
-// Compute the map from contact pairs ids to contact pair for the next frame
-void CollisionDetectionSystem::computeMapPreviousContactPairs() {
+// Store the index of the contact pair of each overlapping pair for the next frame
+void CollisionDetectionSystem::updatePreviousContactPairIndices() {
 
-    mPreviousMapPairIdToContactPairIndex.clear();
     const uint32 nbCurrentContactPairs = static_cast<uint32>(mCurrentContactPairs->size());
     for (uint32 i=0; i < nbCurrentContactPairs; i++) {
-        mPreviousMapPairIdToContactPairIndex.add(Pair<uint64, uint>((*mCurrentContactPairs)[i].pairId, i));
+
+        OverlappingPairs::OverlappingPair* overlappingPair = mOverlappingPairs.getOverlappingPair((*mCurrentContactPairs)[i].pairId);
+        if (overlappingPair != nullptr) {
+            overlappingPair->previousContactPairIndex = i;
+        }
     }
 }
 
@@ -755,13 +907,13 @@ void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInf
     for(uint32 i=0; i < narrowPhaseInfoBatch.getNbObjects(); i++) {
 
         // If there is a collision
-        if (narrowPhaseInfoBatch.narrowPhaseInfos[i].isColliding) {
+        if (narrowPhaseInfoBatch.isColliding[i]) {
 
             // If the contact pair does not already exist
-            if (!setOverlapContactPairId.contains(narrowPhaseInfoBatch.narrowPhaseInfos[i].overlappingPairId)) {
+            if (!setOverlapContactPairId.contains(narrowPhaseInfoBatch.overlappingPairIds[i])) {
 
-                const Entity collider1Entity = narrowPhaseInfoBatch.narrowPhaseInfos[i].colliderEntity1;
-                const Entity collider2Entity = narrowPhaseInfoBatch.narrowPhaseInfos[i].colliderEntity2;
+                const Entity collider1Entity = narrowPhaseInfoBatch.colliderEntities1[i];
+                const Entity collider2Entity = narrowPhaseInfoBatch.colliderEntities2[i];
 
                 const uint32 collider1Index = mCollidersComponents.getEntityIndex(collider1Entity);
                 const uint32 collider2Index = mCollidersComponents.getEntityIndex(collider2Entity);
@@ -772,10 +924,10 @@ void CollisionDetectionSystem::computeOverlapSnapshotContactPairs(NarrowPhaseInf
                 const bool isTrigger = mCollidersComponents.mIsTrigger[collider1Index] || mCollidersComponents.mIsTrigger[collider2Index];
 
                 // Create a new contact pair
-                ContactPair contactPair(narrowPhaseInfoBatch.narrowPhaseInfos[i].overlappingPairId, body1Entity, body2Entity, collider1Entity, collider2Entity, static_cast<uint32>(contactPairs.size()), false, isTrigger);
+                ContactPair contactPair(narrowPhaseInfoBatch.overlappingPairIds[i], body1Entity, body2Entity, collider1Entity, collider2Entity, static_cast<uint32>(contactPairs.size()), false, isTrigger);
                 contactPairs.add(contactPair);
 
-                setOverlapContactPairId.add(narrowPhaseInfoBatch.narrowPhaseInfos[i].overlappingPairId);
+                setOverlapContactPairId.add(narrowPhaseInfoBatch.overlappingPairIds[i]);
             }
         }
 
@@ -901,9 +1053,6 @@ void CollisionDetectionSystem::createContacts() {
     // Initialize the current contacts with the contacts from the previous frame (for warmstarting)
     initContactsWithPreviousOnes();
 
-    // Compute the lost contacts (contact pairs that were colliding in previous frame but not in this one)
-    computeLostContactPairs();
-
     mPreviousContactPoints->clear();
     mPreviousContactManifolds->clear();
     mPreviousContactPairs->clear();
@@ -915,10 +1064,11 @@ void CollisionDetectionSystem::createContacts() {
     mPotentialContactPoints.clear(true);
     mPotentialContactManifolds.clear(true);
 
-    // Compute the map from contact pairs ids to contact pair for the next frame
-    computeMapPreviousContactPairs();
+    // Store the index of the contact pair of each overlapping pair for the next frame
+    updatePreviousContactPairIndices();
 
     mCollisionBodyContactPairsIndices.clear(true);
+    mNewContactPairsIndices.clear(true);
 
     mNarrowPhaseInput.clear();
 }
@@ -1025,12 +1175,14 @@ void CollisionDetectionSystem::initContactsWithPreviousOnes() {
         ContactPair& currentContactPair = (*mCurrentContactPairs)[i];
 
         // Find the corresponding contact pair in the previous frame (if any)
-        auto itPrevContactPair = mPreviousMapPairIdToContactPairIndex.find(currentContactPair.pairId);
+        const OverlappingPairs::OverlappingPair* overlappingPair = mOverlappingPairs.getOverlappingPair(currentContactPair.pairId);
+        const uint32 previousContactPairIndex = overlappingPair != nullptr ? overlappingPair->previousContactPairIndex :
+                                                                             OverlappingPairs::INVALID_INDEX;
 
         // If we have found a corresponding contact pair in the previous frame
-        if (itPrevContactPair != mPreviousMapPairIdToContactPairIndex.end()) {
+        if (previousContactPairIndex < mPreviousContactPairs->size() &&
+            (*mPreviousContactPairs)[previousContactPairIndex].pairId == currentContactPair.pairId) {
 
-            const uint32 previousContactPairIndex = itPrevContactPair->second;
             ContactPair& previousContactPair = (*mPreviousContactPairs)[previousContactPairIndex];
 
             // --------------------- Contact Manifolds --------------------- //
@@ -1131,6 +1283,23 @@ void CollisionDetectionSystem::removeCollider(Collider* collider) {
     mBroadPhaseSystem.removeCollider(collider);
 }
 
+// Add several colliders to the collision detection at once
+void CollisionDetectionSystem::addColliders(Collider* const* colliders, const AABB* aabbs, uint32 nbColliders) {
+
+    // Add the colliders to the broad-phase
+    mBroadPhaseSystem.addColliders(colliders, aabbs, nbColliders);
+
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        int broadPhaseId = mCollidersComponents.getBroadPhaseId(colliders[i]->getEntity());
+
+        assert(!mMapBroadPhaseIdToColliderEntity.containsKey(broadPhaseId));
+
+        // Add the mapping between the collider broad-phase id and its entity
+        mMapBroadPhaseIdToColliderEntity.add(Pair<int, Entity>(broadPhaseId, colliders[i]->getEntity()));
+    }
+}
+
 // Ray casting method
 void CollisionDetectionSystem::raycast(RaycastCallback* raycastCallback, const Ray& ray, unsigned short raycastWithCategoryMaskBits) const {
 
@@ -1143,11 +1312,23 @@ void CollisionDetectionSystem::raycast(RaycastCallback* raycastCallback, const R
     mBroadPhaseSystem.raycast(ray, rayCastTest, raycastWithCategoryMaskBits);
 }
 
+// Ray casting method for a batch of rays
+void CollisionDetectionSystem::raycastBatch(const Ray* rays, uint32 nbRays, RaycastHit* outHits, RaycastBatchMode mode,
+                                            unsigned short raycastWithCategoryMaskBits) const {
+
+    RP3D_PROFILE("CollisionDetectionSystem::raycastBatch()", mProfiler);
+
+    RaycastBatchTest raycastBatchTest(outHits, mode);
+
+    // Ask the broad-phase algorithm to test the rays of each packet against
+    // the colliders hit by some rays of the packet in the broad-phase
+    mBroadPhaseSystem.raycastBatch(mMemoryManager, rays, nbRays, raycastBatchTest, raycastWithCategoryMaskBits);
+}
+
 // Convert the potential contact into actual contacts
 void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& narrowPhaseInfoBatch, bool updateLastFrameInfo,
                                                         Array<ContactPointInfo>& potentialContactPoints,
                                                         Array<ContactManifoldInfo>& potentialContactManifolds,
-                                                        Map<uint64, uint>& mapPairIdToContactPairIndex,
                                                         Array<ContactPair>* contactPairs) {
 
     RP3D_PROFILE("CollisionDetectionSystem::processPotentialContacts()", mProfiler);
@@ -1159,10 +1340,10 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
         // For each narrow phase info object
         for(uint32 i=0; i < nbObjects; i++) {
 
-            narrowPhaseInfoBatch.narrowPhaseInfos[i].lastFrameCollisionInfo->wasColliding = narrowPhaseInfoBatch.narrowPhaseInfos[i].isColliding;
+            narrowPhaseInfoBatch.lastFrameCollisionInfos[i]->wasColliding = narrowPhaseInfoBatch.isColliding[i];
 
             // The previous frame collision info is now valid
-            narrowPhaseInfoBatch.narrowPhaseInfos[i].lastFrameCollisionInfo->isValid = true;
+            narrowPhaseInfoBatch.lastFrameCollisionInfos[i]->isValid = true;
         }
     }
 
@@ -1170,16 +1351,16 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
     for(uint32 i=0; i < nbObjects; i++) {
 
         // If the two colliders are colliding
-        if (narrowPhaseInfoBatch.narrowPhaseInfos[i].isColliding) {
+        if (narrowPhaseInfoBatch.isColliding[i]) {
 
-            const uint64 pairId = narrowPhaseInfoBatch.narrowPhaseInfos[i].overlappingPairId;
+            const uint64 pairId = narrowPhaseInfoBatch.overlappingPairIds[i];
             OverlappingPairs::OverlappingPair* overlappingPair = mOverlappingPairs.getOverlappingPair(pairId);
             assert(overlappingPair != nullptr);
 
             overlappingPair->collidingInCurrentFrame = true;
 
-            const Entity collider1Entity = narrowPhaseInfoBatch.narrowPhaseInfos[i].colliderEntity1;
-            const Entity collider2Entity = narrowPhaseInfoBatch.narrowPhaseInfos[i].colliderEntity2;
+            const Entity collider1Entity = narrowPhaseInfoBatch.colliderEntities1[i];
+            const Entity collider2Entity = narrowPhaseInfoBatch.colliderEntities2[i];
 
             const uint32 collider1Index = mCollidersComponents.getEntityIndex(collider1Entity);
             const uint32 collider2Index = mCollidersComponents.getEntityIndex(collider2Entity);
@@ -1211,7 +1392,7 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
                 const uint32 contactPointIndexStart = static_cast<uint>(potentialContactPoints.size());
 
                 // Add the potential contacts
-                for (uint32 j=0; j < narrowPhaseInfoBatch.narrowPhaseInfos[i].nbContactPoints; j++) {
+                for (uint32 j=0; j < narrowPhaseInfoBatch.nbContactPoints[i]; j++) {
 
                     if (contactManifoldInfo.nbPotentialContactPoints < NB_MAX_CONTACT_POINTS_IN_POTENTIAL_MANIFOLD) {
 
@@ -1220,7 +1401,7 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
                         contactManifoldInfo.nbPotentialContactPoints++;
 
                         // Add the contact point to the array of potential contact points
-                        const ContactPointInfo& contactPoint = narrowPhaseInfoBatch.narrowPhaseInfos[i].contactPoints[j];
+                        const ContactPointInfo& contactPoint = narrowPhaseInfoBatch.getContactPoint(i, j);
 
                         potentialContactPoints.add(contactPoint);
                     }
@@ -1234,9 +1415,9 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
             else {
 
                 // If there is not already a contact pair for this overlapping pair
-                auto it = mapPairIdToContactPairIndex.find(pairId);
+                const uint32 existingContactPairIndex = overlappingPair->contactPairIndex;
                 ContactPair* pairContact = nullptr;
-                if (it == mapPairIdToContactPairIndex.end()) {
+                if (existingContactPairIndex >= contactPairs->size() || (*contactPairs)[existingContactPairIndex].pairId != pairId) {
 
                     // Create a new ContactPair
 
@@ -1248,23 +1429,20 @@ void CollisionDetectionSystem::processPotentialContacts(NarrowPhaseInfoBatch& na
                     contactPairs->emplace(pairId, body1Entity, body2Entity, collider1Entity, collider2Entity,
                                                        newContactPairIndex, overlappingPair->collidingInPreviousFrame , isTrigger);
                     pairContact = &((*contactPairs)[newContactPairIndex]);
-                    mapPairIdToContactPairIndex.add(Pair<uint64, uint>(pairId, newContactPairIndex));
+                    overlappingPair->contactPairIndex = newContactPairIndex;
 
                 }
                 else { // If a ContactPair already exists for this overlapping pair, we use this one
 
-                    assert(it->first == pairId);
-
-                    const uint32 pairContactIndex = it->second;
-                    pairContact = &((*contactPairs)[pairContactIndex]);
+                    pairContact = &((*contactPairs)[existingContactPairIndex]);
                 }
 
                 assert(pairContact != nullptr);
 
                 // Add the potential contacts
-                for (uint32 j=0; j < narrowPhaseInfoBatch.narrowPhaseInfos[i].nbContactPoints; j++) {
+                for (uint32 j=0; j < narrowPhaseInfoBatch.nbContactPoints[i]; j++) {
 
-                    const ContactPointInfo& contactPoint = narrowPhaseInfoBatch.narrowPhaseInfos[i].contactPoints[j];
+                    const ContactPointInfo& contactPoint = narrowPhaseInfoBatch.getContactPoint(i, j);
 
                     // Add the contact point to the array of potential contact points
                     const uint32 contactPointIndex = static_cast<uint32>(potentialContactPoints.size());
@@ -1896,3 +2074,59 @@ const AABB CollisionDetectionSystem::getWorldAABB(const Collider* collider) cons
     assert(collider->getBroadPhaseId() > -1);
     return mBroadPhaseSystem.getFatAABB(collider->getBroadPhaseId());
 }
+
+// Save the overlapping pairs, the broad-phase and the contacts into a snapshot
+/// The broad-phase tree of the static colliders is not saved with the dynamic state only.
+void CollisionDetectionSystem::saveSnapshot(SnapshotWriter& writer, bool isDynamicStateOnly) const {
+
+    mOverlappingPairs.saveSnapshot(writer);
+    mBroadPhaseSystem.saveSnapshot(writer, !isDynamicStateOnly);
+
+    // Contacts of the last frame (used to warm start the contact solver in the next frame)
+    writer.writeArray(*mCurrentContactPairs);
+    writer.writeArray(*mCurrentContactManifolds);
+    writer.writeArray(*mCurrentContactPoints);
+}
+
+// Restore the overlapping pairs, the broad-phase and the contacts from a snapshot
+/// The colliders components must have been restored before
+void CollisionDetectionSystem::restoreSnapshot(SnapshotReader& reader, bool isDynamicStateOnly) {
+
+    mOverlappingPairs.restoreSnapshot(reader);
+    mBroadPhaseSystem.restoreSnapshot(reader, !isDynamicStateOnly);
+
+    // Map the broad-phase ids of the colliders to their entities
+    mMapBroadPhaseIdToColliderEntity.clear();
+    const uint32 nbColliders = mCollidersComponents.getNbComponents();
+    for (uint32 i=0; i < nbColliders; i++) {
+
+        const int32 broadPhaseId = mCollidersComponents.mBroadPhaseIds[i];
+        if (broadPhaseId != -1) {
+            mMapBroadPhaseIdToColliderEntity.add(Pair<int, Entity>(broadPhaseId, mCollidersComponents.mCollidersEntities[i]));
+        }
+    }
+
+    // Contacts of the last frame (used to warm start the contact solver in the next frame)
+    mPreviousContactPairs->clear();
+    mPreviousContactManifolds->clear();
+    mPreviousContactPoints->clear();
+    mLostContactPairs.clear();
+    reader.readArray(*mCurrentContactPairs);
+    reader.readArray(*mCurrentContactManifolds);
+    reader.readArray(*mCurrentContactPoints);
+}
+
+// Skip the overlapping pairs, the broad-phase and the contacts in a snapshot and return true if they can be restored
+/// Nothing is modified
+bool CollisionDetectionSystem::skipSnapshot(SnapshotReader& reader, bool isDynamicStateOnly) const {
+
+    if (!mOverlappingPairs.skipSnapshot(reader) || !mBroadPhaseSystem.skipSnapshot(reader, !isDynamicStateOnly)) {
+        return false;
+    }
+
+    reader.skipArray(*mCurrentContactPairs);
+    reader.skipArray(*mCurrentContactManifolds);
+    reader.skipArray(*mCurrentContactPoints);
+
+    return reader.isValid();
+}
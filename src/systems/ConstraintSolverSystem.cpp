@@ -29,23 +29,33 @@
 #include <reactphysics3d/components/BallAndSocketJointComponents.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/engine/Island.h>
+#include <reactphysics3d/engine/Islands.h>
+#include <reactphysics3d/engine/SolverBodies.h>
 
 using namespace reactphysics3d;
 
+// Constants initialization
+const uint32 ConstraintSolverSystem::NB_MIN_JOINTS_PER_TASK = 32;
+
 // Constructor
-ConstraintSolverSystem::ConstraintSolverSystem(PhysicsWorld& world, Islands& islands, RigidBodyComponents& rigidBodyComponents,
+ConstraintSolverSystem::ConstraintSolverSystem(PhysicsWorld& world, MemoryAllocator& allocator, Islands& islands,
+                                               SolverBodies& solverBodies, RigidBodyComponents& rigidBodyComponents,
                                                TransformComponents& transformComponents,
                                                JointComponents& jointComponents,
                                                BallAndSocketJointComponents& ballAndSocketJointComponents,
                                                FixedJointComponents& fixedJointComponents,
                                                HingeJointComponents& hingeJointComponents,
                                                SliderJointComponents& sliderJointComponents)
-                 : mIsWarmStartingActive(true), mIslands(islands),
+                 : mIsWarmStartingActive(true), mIslands(islands), mSolverBodies(solverBodies), mIslandJointTypes(allocator),
+                   mIslandJointComponentIndices(allocator), mIslandJointSolverBody1Indices(allocator),
+                   mIslandJointSolverBody2Indices(allocator), mColors(allocator), mIsUsingColors(false), mTaskScheduler(nullptr),
                    mConstraintSolverData(rigidBodyComponents, jointComponents),
-                   mSolveBallAndSocketJointSystem(world, rigidBodyComponents, transformComponents, jointComponents, ballAndSocketJointComponents),
-                   mSolveFixedJointSystem(world, rigidBodyComponents, transformComponents, jointComponents, fixedJointComponents),
-                   mSolveHingeJointSystem(world, rigidBodyComponents, transformComponents, jointComponents, hingeJointComponents),
-                   mSolveSliderJointSystem(world, rigidBodyComponents, transformComponents, jointComponents, sliderJointComponents) {
+                   mBallAndSocketJointComponents(ballAndSocketJointComponents), mFixedJointComponents(fixedJointComponents),
+                   mHingeJointComponents(hingeJointComponents), mSliderJointComponents(sliderJointComponents),
+                   mSolveBallAndSocketJointSystem(world, allocator, solverBodies, rigidBodyComponents, transformComponents, jointComponents, ballAndSocketJointComponents),
+                   mSolveFixedJointSystem(world, allocator, solverBodies, rigidBodyComponents, transformComponents, jointComponents, fixedJointComponents),
+                   mSolveHingeJointSystem(world, allocator, solverBodies, rigidBodyComponents, transformComponents, jointComponents, hingeJointComponents),
+                   mSolveSliderJointSystem(world, allocator, solverBodies, rigidBodyComponents, transformComponents, jointComponents, sliderJointComponents) {
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -77,6 +87,69 @@ void ConstraintSolverSystem::initialize(decimal dt) {
     mSolveSliderJointSystem.setTimeStep(dt);
     mSolveSliderJointSystem.setIsWarmStartingActive(mIsWarmStartingActive);
 
+    // Resolve the type and the component index of the joints of the islands once for all the iterations
+    const uint32 nbIslandJoints = static_cast<uint32>(mIslands.jointEntities.size());
+    mIslandJointTypes.clear();
+    mIslandJointComponentIndices.clear();
+    mIslandJointSolverBody1Indices.clear();
+    mIslandJointSolverBody2Indices.clear();
+    mIslandJointTypes.reserve(nbIslandJoints);
+    mIslandJointComponentIndices.reserve(nbIslandJoints);
+    mIslandJointSolverBody1Indices.reserve(nbIslandJoints);
+    mIslandJointSolverBody2Indices.reserve(nbIslandJoints);
+    for (uint32 j=0; j < nbIslandJoints; j++) {
+
+        const Entity jointEntity = mIslands.jointEntities[j];
+        const JointType jointType = mConstraintSolverData.jointComponents.getType(jointEntity);
+
+        uint32 componentIndex = 0;
+        switch(jointType) {
+
+            case JointType::BALLSOCKETJOINT:
+                componentIndex = mBallAndSocketJointComponents.getEntityIndex(jointEntity);
+                break;
+            case JointType::FIXEDJOINT:
+                componentIndex = mFixedJointComponents.getEntityIndex(jointEntity);
+                break;
+            case JointType::HINGEJOINT:
+                componentIndex = mHingeJointComponents.getEntityIndex(jointEntity);
+                break;
+            case JointType::SLIDERJOINT:
+                componentIndex = mSliderJointComponents.getEntityIndex(jointEntity);
+                break;
+        }
+
+        const uint32 jointIndex = mConstraintSolverData.jointComponents.getEntityIndex(jointEntity);
+
+        mIslandJointTypes.add(jointType);
+        mIslandJointComponentIndices.add(componentIndex);
+        mIslandJointSolverBody1Indices.add(mSolverBodies.jointsBody1Indices[jointIndex]);
+        mIslandJointSolverBody2Indices.add(mSolverBodies.jointsBody2Indices[jointIndex]);
+    }
+
+    // Partition the joints of the islands that are solved by colors
+    mIsUsingColors = mSolverBodies.nbIslandsSolvedByColors > 0;
+    if (mIsUsingColors) {
+
+        mColors.reset(mSolverBodies.getNbBodies());
+
+        const uint32 nbIslands = mIslands.getNbIslands();
+        for (uint32 i=0; i < nbIslands; i++) {
+
+            if (mSolverBodies.islandsSolvedByColors[i]) {
+
+                const uint32 startIndex = mIslands.startJointEntitiesIndex[i];
+                mColors.addIsland(startIndex, startIndex + mIslands.nbJointsInIsland[i], mIslandJointSolverBody1Indices,
+                                  mIslandJointSolverBody2Indices, mSolverBodies.bodyTypes);
+            }
+            else {
+                mColors.addUncoloredIsland();
+            }
+        }
+
+        mColors.finish();
+    }
+
     mSolveBallAndSocketJointSystem.initBeforeSolve();
     mSolveFixedJointSystem.initBeforeSolve();
     mSolveHingeJointSystem.initBeforeSolve();
@@ -111,3 +184,119 @@ void ConstraintSolverSystem::solvePositionConstraints() {
     mSolveHingeJointSystem.solvePositionConstraint();
     mSolveSliderJointSystem.solvePositionConstraint();
 }
+
+// Solve the velocity constraint of a joint of the islands
+void ConstraintSolverSystem::solveVelocityConstraint(uint32 islandJointIndex) {
+
+    const uint32 componentIndex = mIslandJointComponentIndices[islandJointIndex];
+
+    switch(mIslandJointTypes[islandJointIndex]) {
+
+        case JointType::BALLSOCKETJOINT:
+            mSolveBallAndSocketJointSystem.solveVelocityConstraint(componentIndex);
+            break;
+        case JointType::FIXEDJOINT:
+            mSolveFixedJointSystem.solveVelocityConstraint(componentIndex);
+            break;
+        case JointType::HINGEJOINT:
+            mSolveHingeJointSystem.solveVelocityConstraint(componentIndex);
+            break;
+        case JointType::SLIDERJOINT:
+            mSolveSliderJointSystem.solveVelocityConstraint(componentIndex);
+            break;
+    }
+}
+
+// Solve the position constraint of a joint of the islands
+void ConstraintSolverSystem::solvePositionConstraint(uint32 islandJointIndex) {
+
+    const uint32 componentIndex = mIslandJointComponentIndices[islandJointIndex];
+
+    switch(mIslandJointTypes[islandJointIndex]) {
+
+        case JointType::BALLSOCKETJOINT:
+            mSolveBallAndSocketJointSystem.solvePositionConstraint(componentIndex);
+            break;
+        case JointType::FIXEDJOINT:
+            mSolveFixedJointSystem.solvePositionConstraint(componentIndex);
+            break;
+        case JointType::HINGEJOINT:
+            mSolveHingeJointSystem.solvePositionConstraint(componentIndex);
+            break;
+        case JointType::SLIDERJOINT:
+            mSolveSliderJointSystem.solvePositionConstraint(componentIndex);
+            break;
+    }
+}
+
+// Solve the velocity constraints of the joints of a given island
+/// The joints of an island only constrain bodies of this island. Therefore, the
+/// islands can be solved independently.
+void ConstraintSolverSystem::solveVelocityConstraintsIsland(uint32 islandIndex) {
+
+    if (mIsUsingColors && mColors.isIslandColored(islandIndex)) {
+        solveIslandByColors(islandIndex, false);
+        return;
+    }
+
+    const uint32 startIndex = mIslands.startJointEntitiesIndex[islandIndex];
+    const uint32 endIndex = startIndex + mIslands.nbJointsInIsland[islandIndex];
+    for (uint32 j=startIndex; j < endIndex; j++) {
+        solveVelocityConstraint(j);
+    }
+}
+
+// Solve the position constraints of the joints of a given island
+void ConstraintSolverSystem::solvePositionConstraintsIsland(uint32 islandIndex) {
+
+    if (mIsUsingColors && mColors.isIslandColored(islandIndex)) {
+        solveIslandByColors(islandIndex, true);
+        return;
+    }
+
+    const uint32 startIndex = mIslands.startJointEntitiesIndex[islandIndex];
+    const uint32 endIndex = startIndex + mIslands.nbJointsInIsland[islandIndex];
+    for (uint32 j=startIndex; j < endIndex; j++) {
+        solvePositionConstraint(j);
+    }
+}
+
+// Solve the velocity or position constraints of the joints of a given island color by color
+/// The colors are solved one after the other in increasing order. The joints of a color do
+/// not share any solver body and are solved in parallel. Because each joint of a color is
+/// solved with the velocities computed by the previous colors, the result does not depend on
+/// the number of threads.
+void ConstraintSolverSystem::solveIslandByColors(uint32 islandIndex, bool isPositionSolver) {
+
+    const uint32 endColorIndex = mColors.islandsColorsStartIndices[islandIndex + 1];
+    for (uint32 c=mColors.islandsColorsStartIndices[islandIndex]; c < endColorIndex; c++) {
+
+        const uint32 startIndex = mColors.colorsStartIndices[c];
+        const uint32 nbJoints = mColors.colorsStartIndices[c + 1] - startIndex;
+
+        parallelFor(mTaskScheduler, nbJoints, NB_MIN_JOINTS_PER_TASK, [&](uint32 startJointIndex, uint32 endJointIndex, uint32 /*workerIndex*/) {
+
+            for (uint32 j=startIndex + startJointIndex; j < startIndex + endJointIndex; j++) {
+
+                if (isPositionSolver) {
+                    solvePositionConstraint(mColors.constraints[j]);
+                }
+                else {
+                    solveVelocityConstraint(mColors.constraints[j]);
+                }
+            }
+        });
+    }
+
+    // Solve the joints that could not be colored
+    const uint32 endRemainingIndex = mColors.islandsRemainingConstraintsStartIndices[islandIndex + 1];
+    for (uint32 r=mColors.islandsRemainingConstraintsStartIndices[islandIndex]; r < endRemainingIndex; r++) {
+
+        if (isPositionSolver) {
+            solvePositionConstraint(mColors.remainingConstraints[r]);
+        }
+        else {
+            solveVelocityConstraint(mColors.remainingConstraints[r]);
+        }
+    }
+}
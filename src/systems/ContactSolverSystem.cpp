@@ -30,6 +30,7 @@
 #include <reactphysics3d/constraint/ContactPoint.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <reactphysics3d/engine/Island.h>
+#include <reactphysics3d/engine/SolverBodies.h>
 #include <reactphysics3d/collision/Collider.h>
 #include <reactphysics3d/components/CollisionBodyComponents.h>
 #include <reactphysics3d/components/ColliderComponents.h>
@@ -43,16 +44,86 @@ using namespace std;
 const decimal ContactSolverSystem::BETA = decimal(0.2);
 const decimal ContactSolverSystem::BETA_SPLIT_IMPULSE = decimal(0.2);
 const decimal ContactSolverSystem::SLOP = decimal(0.01);
+const uint32 ContactSolverSystem::NB_MIN_MANIFOLDS_PER_TASK = 64;
+
+#ifdef RP3D_USE_SIMD
+
+namespace {
+
+// Structure SimdVector3
+/**
+ * Three-dimensional vectors of the four SIMD lanes
+ */
+struct SimdVector3 {
+
+    SimdFloat4 x;
+    SimdFloat4 y;
+    SimdFloat4 z;
+};
+
+// Load the vectors of the lanes
+RP3D_FORCE_INLINE SimdVector3 loadLanes(const decimal (&values)[3][SIMD_WIDTH]) {
+    return {simdLoad(values[0]), simdLoad(values[1]), simdLoad(values[2])};
+}
+
+// Set the vector of a given lane
+RP3D_FORCE_INLINE void setLane(decimal (&values)[3][SIMD_WIDTH], uint32 lane, const Vector3& vector) {
+    values[0][lane] = vector.x;
+    values[1][lane] = vector.y;
+    values[2][lane] = vector.z;
+}
+
+// Return the product of the matrices of the lanes (row-major) with the vectors of the lanes
+/// The operations are the same as in operator*(const Matrix3x3&, const Vector3&)
+RP3D_FORCE_INLINE SimdVector3 multiply(const SimdFloat4 (&matrix)[9], const SimdVector3& vector) {
+    return {matrix[0] * vector.x + matrix[1] * vector.y + matrix[2] * vector.z,
+            matrix[3] * vector.x + matrix[4] * vector.y + matrix[5] * vector.z,
+            matrix[6] * vector.x + matrix[7] * vector.y + matrix[8] * vector.z};
+}
+
+// Gather the vectors of the solver bodies of the used lanes (zero in the unused lanes)
+RP3D_FORCE_INLINE SimdVector3 gatherLanes(const Array<Vector3>& vectors, const uint32 (&solverBodyIndices)[SIMD_WIDTH], uint32 nbLanes) {
+
+    decimal values[3][SIMD_WIDTH] = {};
+    for (uint32 lane=0; lane < nbLanes; lane++) {
+        setLane(values, lane, vectors[solverBodyIndices[lane]]);
+    }
+
+    return loadLanes(values);
+}
+
+// Write the vectors of the used lanes back into their solver bodies
+RP3D_FORCE_INLINE void scatterLanes(const SimdVector3& lanes, const uint32 (&solverBodyIndices)[SIMD_WIDTH], uint32 nbLanes, Array<Vector3>& vectors) {
+
+    decimal values[3][SIMD_WIDTH];
+    simdStore(values[0], lanes.x);
+    simdStore(values[1], lanes.y);
+    simdStore(values[2], lanes.z);
+
+    for (uint32 lane=0; lane < nbLanes; lane++) {
+        vectors[solverBodyIndices[lane]].setAllValues(values[0][lane], values[1][lane], values[2][lane]);
+    }
+}
+
+}
+
+#endif
 
 // Constructor
 ContactSolverSystem::ContactSolverSystem(MemoryManager& memoryManager, PhysicsWorld& world, Islands& islands,
-                                         CollisionBodyComponents& bodyComponents, RigidBodyComponents& rigidBodyComponents,
+                                         SolverBodies& solverBodies, CollisionBodyComponents& bodyComponents, RigidBodyComponents& rigidBodyComponents,
                                          ColliderComponents& colliderComponents, decimal& restitutionVelocityThreshold)
               :mMemoryManager(memoryManager), mWorld(world), mRestitutionVelocityThreshold(restitutionVelocityThreshold),
                mContactConstraints(nullptr), mContactPoints(nullptr),
-               mIslands(islands), mAllContactManifolds(nullptr), mAllContactPoints(nullptr),
+               mIslands(islands), mSolverBodies(solverBodies), mAllContactManifolds(nullptr), mAllContactPoints(nullptr),
                mBodyComponents(bodyComponents), mRigidBodyComponents(rigidBodyComponents),
-               mColliderComponents(colliderComponents), mIsSplitImpulseActive(true) {
+               mColliderComponents(colliderComponents), mIsSplitImpulseActive(true), mIsWideSolverEnabled(false),
+               mColors(memoryManager.getHeapAllocator()), mIsUsingColors(false), mTaskScheduler(nullptr)
+#ifdef RP3D_USE_SIMD
+               , mIsUsingLaneGroups(false), mLaneGroups(nullptr), mNbLaneGroups(0),
+               mColorsLaneGroupsStartIndices(memoryManager.getHeapAllocator())
+#endif
+               {
 
 #ifdef IS_RP3D_PROFILING_ENABLED
 
@@ -79,6 +150,13 @@ void ContactSolverSystem::init(Array<ContactManifold>* contactManifolds, Array<C
 
     mContactConstraints = nullptr;
     mContactPoints = nullptr;
+    mIsUsingColors = false;
+
+#ifdef RP3D_USE_SIMD
+    mIsUsingLaneGroups = false;
+    mLaneGroups = nullptr;
+    mNbLaneGroups = 0;
+#endif
 
     if (nbContactManifolds == 0 || nbContactPoints == 0) return;
 
@@ -101,6 +179,22 @@ void ContactSolverSystem::init(Array<ContactManifold>* contactManifolds, Array<C
 
     // Warmstarting
     warmStart();
+
+#ifdef RP3D_USE_SIMD
+
+    // Color the contact manifolds of all the islands and pack them into lane groups for the wide solver
+    if (mIsWideSolverEnabled) {
+        createColors(true);
+        createLaneGroups();
+        return;
+    }
+
+#endif
+
+    // Color the contact manifolds of the islands that are solved by colors
+    if (mSolverBodies.nbIslandsSolvedByColors > 0) {
+        createColors(false);
+    }
 }
 
 // Release allocated memory
@@ -108,6 +202,15 @@ void ContactSolverSystem::reset() {
 
     if (mAllContactPoints->size() > 0) mMemoryManager.release(MemoryManager::AllocationType::Frame, mContactPoints, sizeof(ContactPointSolver) * mAllContactPoints->size());
     if (mAllContactManifolds->size() > 0) mMemoryManager.release(MemoryManager::AllocationType::Frame, mContactConstraints, sizeof(ContactManifoldSolver) * mAllContactManifolds->size());
+
+#ifdef RP3D_USE_SIMD
+    if (mNbLaneGroups > 0) mMemoryManager.release(MemoryManager::AllocationType::Frame, mLaneGroups, sizeof(ContactLaneGroupSolver) * mNbLaneGroups);
+    mLaneGroups = nullptr;
+    mNbLaneGroups = 0;
+    mIsUsingLaneGroups = false;
+#endif
+
+    mIsUsingColors = false;
 }
 
 // Initialize the constraint solver for a given island
@@ -143,8 +246,8 @@ void ContactSolverSystem::initializeForIsland(uint32 islandIndex) {
 
         // Initialize the internal contact manifold structure using the external contact manifold
         new (mContactConstraints + mNbContactManifolds) ContactManifoldSolver();
-        mContactConstraints[mNbContactManifolds].rigidBodyComponentIndexBody1 = rigidBodyIndex1;
-        mContactConstraints[mNbContactManifolds].rigidBodyComponentIndexBody2 = rigidBodyIndex2;
+        mContactConstraints[mNbContactManifolds].solverBodyIndexBody1 = mSolverBodies.contactManifoldsBody1Indices[m];
+        mContactConstraints[mNbContactManifolds].solverBodyIndexBody2 = mSolverBodies.contactManifoldsBody2Indices[m];
         mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody1 = mRigidBodyComponents.mInverseInertiaTensorsWorld[rigidBodyIndex1];
         mContactConstraints[mNbContactManifolds].inverseInertiaTensorBody2 = mRigidBodyComponents.mInverseInertiaTensorsWorld[rigidBodyIndex2];
         mContactConstraints[mNbContactManifolds].massInverseBody1 = mRigidBodyComponents.mInverseMasses[rigidBodyIndex1];
@@ -342,8 +445,8 @@ void ContactSolverSystem::warmStart() {
             // If it is not a new contact (this contact was already existing at last time step)
             if (mContactPoints[contactPointIndex].isRestingContact) {
 
-                const uint32 rigidBody1Index = mContactConstraints[c].rigidBodyComponentIndexBody1;
-                const uint32 rigidBody2Index = mContactConstraints[c].rigidBodyComponentIndexBody2;
+                const uint32 solverBody1Index = mContactConstraints[c].solverBodyIndexBody1;
+                const uint32 solverBody2Index = mContactConstraints[c].solverBodyIndexBody2;
 
                 atLeastOneRestingContactPoint = true;
 
@@ -353,22 +456,22 @@ void ContactSolverSystem::warmStart() {
                 Vector3 impulsePenetration(mContactPoints[contactPointIndex].normal.x * mContactPoints[contactPointIndex].penetrationImpulse,
                                            mContactPoints[contactPointIndex].normal.y * mContactPoints[contactPointIndex].penetrationImpulse,
                                            mContactPoints[contactPointIndex].normal.z * mContactPoints[contactPointIndex].penetrationImpulse);
-                mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].x -= mContactConstraints[c].massInverseBody1 * impulsePenetration.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
-                mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].y -= mContactConstraints[c].massInverseBody1 * impulsePenetration.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
-                mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].z -= mContactConstraints[c].massInverseBody1 * impulsePenetration.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
+                mSolverBodies.linearVelocities[solverBody1Index].x -= mContactConstraints[c].massInverseBody1 * impulsePenetration.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
+                mSolverBodies.linearVelocities[solverBody1Index].y -= mContactConstraints[c].massInverseBody1 * impulsePenetration.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
+                mSolverBodies.linearVelocities[solverBody1Index].z -= mContactConstraints[c].massInverseBody1 * impulsePenetration.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
 
-                mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * mContactConstraints[c].angularLockAxisFactorBody1.x * mContactPoints[contactPointIndex].penetrationImpulse;
-                mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * mContactConstraints[c].angularLockAxisFactorBody1.y * mContactPoints[contactPointIndex].penetrationImpulse;
-                mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * mContactConstraints[c].angularLockAxisFactorBody1.z * mContactPoints[contactPointIndex].penetrationImpulse;
+                mSolverBodies.angularVelocities[solverBody1Index].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * mContactConstraints[c].angularLockAxisFactorBody1.x * mContactPoints[contactPointIndex].penetrationImpulse;
+                mSolverBodies.angularVelocities[solverBody1Index].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * mContactConstraints[c].angularLockAxisFactorBody1.y * mContactPoints[contactPointIndex].penetrationImpulse;
+                mSolverBodies.angularVelocities[solverBody1Index].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * mContactConstraints[c].angularLockAxisFactorBody1.z * mContactPoints[contactPointIndex].penetrationImpulse;
 
                 // Update the velocities of the body 2 by applying the impulse P
-                mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].x += mContactConstraints[c].massInverseBody2 * impulsePenetration.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
-                mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].y += mContactConstraints[c].massInverseBody2 * impulsePenetration.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
-                mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].z += mContactConstraints[c].massInverseBody2 * impulsePenetration.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
+                mSolverBodies.linearVelocities[solverBody2Index].x += mContactConstraints[c].massInverseBody2 * impulsePenetration.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
+                mSolverBodies.linearVelocities[solverBody2Index].y += mContactConstraints[c].massInverseBody2 * impulsePenetration.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
+                mSolverBodies.linearVelocities[solverBody2Index].z += mContactConstraints[c].massInverseBody2 * impulsePenetration.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
 
-                mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * mContactConstraints[c].angularLockAxisFactorBody2.x * mContactPoints[contactPointIndex].penetrationImpulse;
-                mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * mContactConstraints[c].angularLockAxisFactorBody2.y * mContactPoints[contactPointIndex].penetrationImpulse;
-                mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * mContactConstraints[c].angularLockAxisFactorBody2.z * mContactPoints[contactPointIndex].penetrationImpulse;
+                mSolverBodies.angularVelocities[solverBody2Index].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * mContactConstraints[c].angularLockAxisFactorBody2.x * mContactPoints[contactPointIndex].penetrationImpulse;
+                mSolverBodies.angularVelocities[solverBody2Index].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * mContactConstraints[c].angularLockAxisFactorBody2.y * mContactPoints[contactPointIndex].penetrationImpulse;
+                mSolverBodies.angularVelocities[solverBody2Index].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * mContactConstraints[c].angularLockAxisFactorBody2.z * mContactPoints[contactPointIndex].penetrationImpulse;
             }
             else {  // If it is a new contact point
 
@@ -407,16 +510,16 @@ void ContactSolverSystem::warmStart() {
                                         mContactConstraints[c].r2CrossT1.y * mContactConstraints[c].friction1Impulse,
                                         mContactConstraints[c].r2CrossT1.z * mContactConstraints[c].friction1Impulse);
 
-            const uint32 rigidBody1Index = mContactConstraints[c].rigidBodyComponentIndexBody1;
-            const uint32 rigidBody2Index = mContactConstraints[c].rigidBodyComponentIndexBody2;
+            const uint32 solverBody1Index = mContactConstraints[c].solverBodyIndexBody1;
+            const uint32 solverBody2Index = mContactConstraints[c].solverBodyIndexBody2;
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index] -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2 * mContactConstraints[c].linearLockAxisFactorBody1;
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index] += mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1);
+            mSolverBodies.linearVelocities[solverBody1Index] -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2 * mContactConstraints[c].linearLockAxisFactorBody1;
+            mSolverBodies.angularVelocities[solverBody1Index] += mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1);
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index] += mContactConstraints[c].massInverseBody2 * linearImpulseBody2 * mContactConstraints[c].linearLockAxisFactorBody2;
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
+            mSolverBodies.linearVelocities[solverBody2Index] += mContactConstraints[c].massInverseBody2 * linearImpulseBody2 * mContactConstraints[c].linearLockAxisFactorBody2;
+            mSolverBodies.angularVelocities[solverBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
 
             // ------ Second friction constraint at the center of the contact manifold ----- //
 
@@ -432,18 +535,18 @@ void ContactSolverSystem::warmStart() {
             angularImpulseBody2.z = mContactConstraints[c].r2CrossT2.z * mContactConstraints[c].friction2Impulse;
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
+            mSolverBodies.linearVelocities[solverBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
+            mSolverBodies.linearVelocities[solverBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
+            mSolverBodies.linearVelocities[solverBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
 
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index] += mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1);
+            mSolverBodies.angularVelocities[solverBody1Index] += mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1);
 
             // Update the velocities of the body 2 by applying the impulse P
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
+            mSolverBodies.linearVelocities[solverBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
+            mSolverBodies.linearVelocities[solverBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
+            mSolverBodies.linearVelocities[solverBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
 
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
+            mSolverBodies.angularVelocities[solverBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
 
             // ------ Twist friction constraint at the center of the contact manifold ------ //
 
@@ -457,16 +560,16 @@ void ContactSolverSystem::warmStart() {
             angularImpulseBody2.z = mContactConstraints[c].normal.z * mContactConstraints[c].frictionTwistImpulse;
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index] += mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 *  angularImpulseBody1);
+            mSolverBodies.angularVelocities[solverBody1Index] += mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 *  angularImpulseBody1);
 
             // Update the velocities of the body 2 by applying the impulse P
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
+            mSolverBodies.angularVelocities[solverBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index] -= mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody2);
+            mSolverBodies.angularVelocities[solverBody1Index] -= mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody2);
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
+            mSolverBodies.angularVelocities[solverBody2Index] += mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
         }
         else {  // If it is a new contact manifold
 
@@ -478,30 +581,74 @@ void ContactSolverSystem::warmStart() {
     }
 }
 
-// Solve the contacts
-void ContactSolverSystem::solve() {
+// Solve the contacts at a given iteration of the velocity solver
+/**
+ * @param iteration Index of the current iteration of the velocity solver
+ */
+void ContactSolverSystem::solve(uint32 iteration) {
 
     RP3D_PROFILE("ContactSolverSystem::solve()", mProfiler);
 
+    if (mIsUsingColors) {
+
+        const uint32 nbIslands = mIslands.getNbIslands();
+        for (uint32 i=0; i < nbIslands; i++) {
+            solveIsland(i, iteration);
+        }
+
+        return;
+    }
+
+    solve(0, mNbContactManifolds, 0);
+}
+
+// Solve the contacts of a given island
+/// The contact manifolds of an island are packed together in the array of
+/// contact constraints. Therefore, the islands can be solved independently.
+/**
+ * @param islandIndex Index of the island
+ * @param iteration Index of the current iteration of the velocity solver
+ */
+void ContactSolverSystem::solveIsland(uint32 islandIndex, uint32 iteration) {
+
+    const uint32 nbContactManifolds = mIslands.nbContactManifolds[islandIndex];
+    if (nbContactManifolds == 0) return;
+
+    // The colors are solved in reverse order at every other iteration. In a stack, the contact manifolds
+    // alternate between two colors and solving them always in the same order makes the stack lean.
+    if (mIsUsingColors && mColors.isIslandColored(islandIndex)) {
+        solveIslandByColors(islandIndex, iteration % 2 == 1);
+        return;
+    }
+
+    const uint32 startManifoldIndex = mIslands.contactManifoldsIndices[islandIndex];
+    const uint32 startContactPointIndex = mContactConstraints[startManifoldIndex].externalContactManifold->contactPointsIndex;
+
+    solve(startManifoldIndex, startManifoldIndex + nbContactManifolds, startContactPointIndex);
+}
+
+// Solve the contact manifolds in the range [startManifoldIndex, endManifoldIndex)
+void ContactSolverSystem::solve(uint32 startManifoldIndex, uint32 endManifoldIndex, uint32 startContactPointIndex) {
+
     decimal deltaLambda;
     decimal lambdaTemp;
-    uint32 contactPointIndex = 0;
+    uint32 contactPointIndex = startContactPointIndex;
 
     const decimal beta = mIsSplitImpulseActive ? BETA_SPLIT_IMPULSE : BETA;
 
     // For each contact manifold
-    for (uint32 c=0; c<mNbContactManifolds; c++) {
+    for (uint32 c=startManifoldIndex; c<endManifoldIndex; c++) {
 
         decimal sumPenetrationImpulse = 0.0;
 
-        const uint32 rigidBody1Index = mContactConstraints[c].rigidBodyComponentIndexBody1;
-        const uint32 rigidBody2Index = mContactConstraints[c].rigidBodyComponentIndexBody2;
+        const uint32 solverBody1Index = mContactConstraints[c].solverBodyIndexBody1;
+        const uint32 solverBody2Index = mContactConstraints[c].solverBodyIndexBody2;
 
         // Get the constrained velocities
-        const Vector3& v1 = mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index];
-        const Vector3& w1 = mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index];
-        const Vector3& v2 = mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index];
-        const Vector3& w2 = mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index];
+        const Vector3& v1 = mSolverBodies.linearVelocities[solverBody1Index];
+        const Vector3& w1 = mSolverBodies.angularVelocities[solverBody1Index];
+        const Vector3& v2 = mSolverBodies.linearVelocities[solverBody2Index];
+        const Vector3& w2 = mSolverBodies.angularVelocities[solverBody2Index];
 
         for (short int i=0; i<mContactConstraints[c].nbContacts; i++) {
 
@@ -544,22 +691,22 @@ void ContactSolverSystem::solve() {
                                   mContactPoints[contactPointIndex].normal.z * deltaLambda);
 
             // Update the velocities of the body 1 by applying the impulse P
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
+            mSolverBodies.linearVelocities[solverBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
+            mSolverBodies.linearVelocities[solverBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
+            mSolverBodies.linearVelocities[solverBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
 
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * mContactConstraints[c].angularLockAxisFactorBody1.x * deltaLambda;
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * mContactConstraints[c].angularLockAxisFactorBody1.y * deltaLambda;
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * mContactConstraints[c].angularLockAxisFactorBody1.z * deltaLambda;
+            mSolverBodies.angularVelocities[solverBody1Index].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * mContactConstraints[c].angularLockAxisFactorBody1.x * deltaLambda;
+            mSolverBodies.angularVelocities[solverBody1Index].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * mContactConstraints[c].angularLockAxisFactorBody1.y * deltaLambda;
+            mSolverBodies.angularVelocities[solverBody1Index].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * mContactConstraints[c].angularLockAxisFactorBody1.z * deltaLambda;
 
             // Update the velocities of the body 2 by applying the impulse P
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
-            mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
+            mSolverBodies.linearVelocities[solverBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
+            mSolverBodies.linearVelocities[solverBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
+            mSolverBodies.linearVelocities[solverBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
 
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * mContactConstraints[c].angularLockAxisFactorBody2.x * deltaLambda;
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * mContactConstraints[c].angularLockAxisFactorBody2.y * deltaLambda;
-            mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * mContactConstraints[c].angularLockAxisFactorBody2.z * deltaLambda;
+            mSolverBodies.angularVelocities[solverBody2Index].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * mContactConstraints[c].angularLockAxisFactorBody2.x * deltaLambda;
+            mSolverBodies.angularVelocities[solverBody2Index].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * mContactConstraints[c].angularLockAxisFactorBody2.y * deltaLambda;
+            mSolverBodies.angularVelocities[solverBody2Index].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * mContactConstraints[c].angularLockAxisFactorBody2.z * deltaLambda;
 
             sumPenetrationImpulse += mContactPoints[contactPointIndex].penetrationImpulse;
 
@@ -567,10 +714,10 @@ void ContactSolverSystem::solve() {
             if (mIsSplitImpulseActive) {
 
                 // Split impulse (position correction)
-                const Vector3& v1Split = mRigidBodyComponents.mSplitLinearVelocities[rigidBody1Index];
-                const Vector3& w1Split = mRigidBodyComponents.mSplitAngularVelocities[rigidBody1Index];
-                const Vector3& v2Split = mRigidBodyComponents.mSplitLinearVelocities[rigidBody2Index];
-                const Vector3& w2Split = mRigidBodyComponents.mSplitAngularVelocities[rigidBody2Index];
+                const Vector3& v1Split = mSolverBodies.splitLinearVelocities[solverBody1Index];
+                const Vector3& w1Split = mSolverBodies.splitAngularVelocities[solverBody1Index];
+                const Vector3& v2Split = mSolverBodies.splitLinearVelocities[solverBody2Index];
+                const Vector3& w2Split = mSolverBodies.splitAngularVelocities[solverBody2Index];
 
                 //Vector3 deltaVSplit = v2Split + w2Split.cross(mContactPoints[contactPointIndex].r2) - v1Split - w1Split.cross(mContactPoints[contactPointIndex].r1);
                 Vector3 deltaVSplit(v2Split.x + w2Split.y * mContactPoints[contactPointIndex].r2.z - w2Split.z * mContactPoints[contactPointIndex].r2.y - v1Split.x -
@@ -595,22 +742,22 @@ void ContactSolverSystem::solve() {
                                       mContactPoints[contactPointIndex].normal.z * deltaLambdaSplit);
 
                 // Update the velocities of the body 1 by applying the impulse P
-                mRigidBodyComponents.mSplitLinearVelocities[rigidBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
-                mRigidBodyComponents.mSplitLinearVelocities[rigidBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
-                mRigidBodyComponents.mSplitLinearVelocities[rigidBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
+                mSolverBodies.splitLinearVelocities[solverBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
+                mSolverBodies.splitLinearVelocities[solverBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
+                mSolverBodies.splitLinearVelocities[solverBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
 
-                mRigidBodyComponents.mSplitAngularVelocities[rigidBody1Index].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * mContactConstraints[c].angularLockAxisFactorBody1.x * deltaLambdaSplit;
-                mRigidBodyComponents.mSplitAngularVelocities[rigidBody1Index].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * mContactConstraints[c].angularLockAxisFactorBody1.y * deltaLambdaSplit;
-                mRigidBodyComponents.mSplitAngularVelocities[rigidBody1Index].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * mContactConstraints[c].angularLockAxisFactorBody1.z * deltaLambdaSplit;
+                mSolverBodies.splitAngularVelocities[solverBody1Index].x -= mContactPoints[contactPointIndex].i1TimesR1CrossN.x * mContactConstraints[c].angularLockAxisFactorBody1.x * deltaLambdaSplit;
+                mSolverBodies.splitAngularVelocities[solverBody1Index].y -= mContactPoints[contactPointIndex].i1TimesR1CrossN.y * mContactConstraints[c].angularLockAxisFactorBody1.y * deltaLambdaSplit;
+                mSolverBodies.splitAngularVelocities[solverBody1Index].z -= mContactPoints[contactPointIndex].i1TimesR1CrossN.z * mContactConstraints[c].angularLockAxisFactorBody1.z * deltaLambdaSplit;
 
                 // Update the velocities of the body 1 by applying the impulse P
-                mRigidBodyComponents.mSplitLinearVelocities[rigidBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
-                mRigidBodyComponents.mSplitLinearVelocities[rigidBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
-                mRigidBodyComponents.mSplitLinearVelocities[rigidBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
+                mSolverBodies.splitLinearVelocities[solverBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulse.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
+                mSolverBodies.splitLinearVelocities[solverBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulse.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
+                mSolverBodies.splitLinearVelocities[solverBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulse.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
 
-                mRigidBodyComponents.mSplitAngularVelocities[rigidBody2Index].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * mContactConstraints[c].angularLockAxisFactorBody2.x * deltaLambdaSplit;
-                mRigidBodyComponents.mSplitAngularVelocities[rigidBody2Index].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * mContactConstraints[c].angularLockAxisFactorBody2.y * deltaLambdaSplit;
-                mRigidBodyComponents.mSplitAngularVelocities[rigidBody2Index].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * mContactConstraints[c].angularLockAxisFactorBody2.z * deltaLambdaSplit;
+                mSolverBodies.splitAngularVelocities[solverBody2Index].x += mContactPoints[contactPointIndex].i2TimesR2CrossN.x * mContactConstraints[c].angularLockAxisFactorBody2.x * deltaLambdaSplit;
+                mSolverBodies.splitAngularVelocities[solverBody2Index].y += mContactPoints[contactPointIndex].i2TimesR2CrossN.y * mContactConstraints[c].angularLockAxisFactorBody2.y * deltaLambdaSplit;
+                mSolverBodies.splitAngularVelocities[solverBody2Index].z += mContactPoints[contactPointIndex].i2TimesR2CrossN.z * mContactConstraints[c].angularLockAxisFactorBody2.z * deltaLambdaSplit;
             }
 
             contactPointIndex++;
@@ -653,24 +800,24 @@ void ContactSolverSystem::solve() {
                                     mContactConstraints[c].r2CrossT1.z * deltaLambda);
 
         // Update the velocities of the body 1 by applying the impulse P
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
+        mSolverBodies.linearVelocities[solverBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
+        mSolverBodies.linearVelocities[solverBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
+        mSolverBodies.linearVelocities[solverBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
 
         Vector3 angularVelocity1 = mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1);
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].x += angularVelocity1.x;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].y += angularVelocity1.y;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].z += angularVelocity1.z;
+        mSolverBodies.angularVelocities[solverBody1Index].x += angularVelocity1.x;
+        mSolverBodies.angularVelocities[solverBody1Index].y += angularVelocity1.y;
+        mSolverBodies.angularVelocities[solverBody1Index].z += angularVelocity1.z;
 
         // Update the velocities of the body 2 by applying the impulse P
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
+        mSolverBodies.linearVelocities[solverBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
+        mSolverBodies.linearVelocities[solverBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
+        mSolverBodies.linearVelocities[solverBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
 
         Vector3 angularVelocity2 = mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].x += angularVelocity2.x;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].y += angularVelocity2.y;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].z += angularVelocity2.z;
+        mSolverBodies.angularVelocities[solverBody2Index].x += angularVelocity2.x;
+        mSolverBodies.angularVelocities[solverBody2Index].y += angularVelocity2.y;
+        mSolverBodies.angularVelocities[solverBody2Index].z += angularVelocity2.z;
 
         // ------ Second friction constraint at the center of the contact manifold ----- //
 
@@ -708,24 +855,24 @@ void ContactSolverSystem::solve() {
         angularImpulseBody2.z = mContactConstraints[c].r2CrossT2.z * deltaLambda;
 
         // Update the velocities of the body 1 by applying the impulse P
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
+        mSolverBodies.linearVelocities[solverBody1Index].x -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody1.x;
+        mSolverBodies.linearVelocities[solverBody1Index].y -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody1.y;
+        mSolverBodies.linearVelocities[solverBody1Index].z -= mContactConstraints[c].massInverseBody1 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody1.z;
 
         angularVelocity1 = mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody1);
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].x += angularVelocity1.x;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].y += angularVelocity1.y;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].z += angularVelocity1.z;
+        mSolverBodies.angularVelocities[solverBody1Index].x += angularVelocity1.x;
+        mSolverBodies.angularVelocities[solverBody1Index].y += angularVelocity1.y;
+        mSolverBodies.angularVelocities[solverBody1Index].z += angularVelocity1.z;
 
         // Update the velocities of the body 2 by applying the impulse P
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
-        mRigidBodyComponents.mConstrainedLinearVelocities[rigidBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
+        mSolverBodies.linearVelocities[solverBody2Index].x += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.x * mContactConstraints[c].linearLockAxisFactorBody2.x;
+        mSolverBodies.linearVelocities[solverBody2Index].y += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.y * mContactConstraints[c].linearLockAxisFactorBody2.y;
+        mSolverBodies.linearVelocities[solverBody2Index].z += mContactConstraints[c].massInverseBody2 * linearImpulseBody2.z * mContactConstraints[c].linearLockAxisFactorBody2.z;
 
         angularVelocity2 = mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].x += angularVelocity2.x;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].y += angularVelocity2.y;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].z += angularVelocity2.z;
+        mSolverBodies.angularVelocities[solverBody2Index].x += angularVelocity2.x;
+        mSolverBodies.angularVelocities[solverBody2Index].y += angularVelocity2.y;
+        mSolverBodies.angularVelocities[solverBody2Index].z += angularVelocity2.z;
 
         // ------ Twist friction constraint at the center of the contact manifol ------ //
 
@@ -749,15 +896,15 @@ void ContactSolverSystem::solve() {
 
         // Update the velocities of the body 1 by applying the impulse P
         angularVelocity1 = mContactConstraints[c].angularLockAxisFactorBody1 * (mContactConstraints[c].inverseInertiaTensorBody1 * angularImpulseBody2);
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].x -= angularVelocity1.x;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].y -= angularVelocity1.y;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody1Index].z -= angularVelocity1.z;
+        mSolverBodies.angularVelocities[solverBody1Index].x -= angularVelocity1.x;
+        mSolverBodies.angularVelocities[solverBody1Index].y -= angularVelocity1.y;
+        mSolverBodies.angularVelocities[solverBody1Index].z -= angularVelocity1.z;
 
         // Update the velocities of the body 1 by applying the impulse P
         angularVelocity2 = mContactConstraints[c].angularLockAxisFactorBody2 * (mContactConstraints[c].inverseInertiaTensorBody2 * angularImpulseBody2);
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].x += angularVelocity2.x;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].y += angularVelocity2.y;
-        mRigidBodyComponents.mConstrainedAngularVelocities[rigidBody2Index].z += angularVelocity2.z;
+        mSolverBodies.angularVelocities[solverBody2Index].x += angularVelocity2.x;
+        mSolverBodies.angularVelocities[solverBody2Index].y += angularVelocity2.y;
+        mSolverBodies.angularVelocities[solverBody2Index].z += angularVelocity2.z;
     }
 }
 
@@ -767,6 +914,14 @@ void ContactSolverSystem::storeImpulses() {
 
     RP3D_PROFILE("ContactSolver::storeImpulses()", mProfiler);
 
+#ifdef RP3D_USE_SIMD
+
+    if (mIsUsingLaneGroups) {
+        storeLaneGroupsImpulses();
+    }
+
+#endif
+
     uint32 contactPointIndex = 0;
 
     // For each contact manifold
@@ -787,6 +942,478 @@ void ContactSolverSystem::storeImpulses() {
     }
 }
 
+// Color the contact manifolds of the islands
+/// The wide solver needs the contact manifolds of all the islands to be colored. Otherwise, only the
+/// contact manifolds of the islands that are solved by colors on several threads are colored.
+void ContactSolverSystem::createColors(bool isColoringAllIslands) {
+
+    RP3D_PROFILE("ContactSolver::createColors()", mProfiler);
+
+    mColors.reset(mSolverBodies.getNbBodies());
+
+    const uint32 nbIslands = mIslands.getNbIslands();
+    for (uint32 i=0; i < nbIslands; i++) {
+
+        if (isColoringAllIslands || mSolverBodies.islandsSolvedByColors[i]) {
+
+            const uint32 startManifoldIndex = mIslands.contactManifoldsIndices[i];
+            mColors.addIsland(startManifoldIndex, startManifoldIndex + mIslands.nbContactManifolds[i],
+                              mSolverBodies.contactManifoldsBody1Indices, mSolverBodies.contactManifoldsBody2Indices,
+                              mSolverBodies.bodyTypes);
+        }
+        else {
+            mColors.addUncoloredIsland();
+        }
+    }
+
+    mColors.finish();
+
+    mIsUsingColors = true;
+}
+
+// Solve the contact manifolds of a given island color by color
+/// The colors are solved one after the other in increasing (or decreasing) order. The contact manifolds
+/// (or lane groups) of a color do not share any dynamic body. If the island is solved by colors,
+/// they are solved in parallel and, because each of them only sees the velocities computed by
+/// the previous colors, the result does not depend on the number of threads.
+void ContactSolverSystem::solveIslandByColors(uint32 islandIndex, bool isReverseColorOrder) {
+
+    // The task scheduler is only used for the islands whose static and kinematic bodies
+    // have a different solver body for each contact manifold
+    TaskScheduler* taskScheduler = mSolverBodies.islandsSolvedByColors[islandIndex] ? mTaskScheduler : nullptr;
+
+    const uint32 startIslandColorIndex = mColors.islandsColorsStartIndices[islandIndex];
+    const uint32 endIslandColorIndex = mColors.islandsColorsStartIndices[islandIndex + 1];
+    for (uint32 k=startIslandColorIndex; k < endIslandColorIndex; k++) {
+
+        const uint32 c = isReverseColorOrder ? startIslandColorIndex + endIslandColorIndex - 1 - k : k;
+
+#ifdef RP3D_USE_SIMD
+
+        if (mIsUsingLaneGroups) {
+
+            const uint32 startLaneGroupIndex = mColorsLaneGroupsStartIndices[c];
+            const uint32 nbLaneGroups = mColorsLaneGroupsStartIndices[c + 1] - startLaneGroupIndex;
+
+            parallelFor(taskScheduler, nbLaneGroups, NB_MIN_MANIFOLDS_PER_TASK / SIMD_WIDTH, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+
+                for (uint32 g=startLaneGroupIndex + startIndex; g < startLaneGroupIndex + endIndex; g++) {
+                    solveLaneGroup(mLaneGroups[g]);
+                }
+            });
+
+            continue;
+        }
+
+#endif
+
+        const uint32 startColorIndex = mColors.colorsStartIndices[c];
+        const uint32 nbManifolds = mColors.colorsStartIndices[c + 1] - startColorIndex;
+
+        parallelFor(taskScheduler, nbManifolds, NB_MIN_MANIFOLDS_PER_TASK, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+
+            for (uint32 i=startColorIndex + startIndex; i < startColorIndex + endIndex; i++) {
+
+                const uint32 m = mColors.constraints[i];
+                solve(m, m + 1, mContactConstraints[m].externalContactManifold->contactPointsIndex);
+            }
+        });
+    }
+
+    // Solve the contact manifolds that could not be colored
+    const uint32 endRemainingIndex = mColors.islandsRemainingConstraintsStartIndices[islandIndex + 1];
+    for (uint32 r=mColors.islandsRemainingConstraintsStartIndices[islandIndex]; r < endRemainingIndex; r++) {
+
+        const uint32 m = mColors.remainingConstraints[r];
+        solve(m, m + 1, mContactConstraints[m].externalContactManifold->contactPointsIndex);
+    }
+}
+
+#ifdef RP3D_USE_SIMD
+
+// Pack the colored contact manifolds into lane groups
+/// The contact manifolds of each color are packed into lane groups of SIMD_WIDTH manifolds
+/// in their order. The lane groups are stored in color order.
+void ContactSolverSystem::createLaneGroups() {
+
+    RP3D_PROFILE("ContactSolver::createLaneGroups()", mProfiler);
+
+    const uint32 nbColors = static_cast<uint32>(mColors.colorsStartIndices.size()) - 1;
+
+    mColorsLaneGroupsStartIndices.clear();
+    mColorsLaneGroupsStartIndices.reserve(nbColors + 1);
+    for (uint32 c=0; c < nbColors; c++) {
+
+        mColorsLaneGroupsStartIndices.add(mNbLaneGroups);
+
+        const uint32 nbManifolds = mColors.colorsStartIndices[c + 1] - mColors.colorsStartIndices[c];
+        mNbLaneGroups += (nbManifolds + SIMD_WIDTH - 1) / SIMD_WIDTH;
+    }
+    mColorsLaneGroupsStartIndices.add(mNbLaneGroups);
+
+    mIsUsingLaneGroups = true;
+
+    if (mNbLaneGroups == 0) return;
+
+    mLaneGroups = static_cast<ContactLaneGroupSolver*>(mMemoryManager.allocate(MemoryManager::AllocationType::Frame,
+                                                                               sizeof(ContactLaneGroupSolver) * mNbLaneGroups));
+    assert(mLaneGroups != nullptr);
+
+    for (uint32 g=0; g < mNbLaneGroups; g++) {
+        new (mLaneGroups + g) ContactLaneGroupSolver();
+    }
+
+    // Add each colored contact manifold into the current lane group of its color
+    for (uint32 c=0; c < nbColors; c++) {
+
+        uint32 laneGroupIndex = mColorsLaneGroupsStartIndices[c];
+        for (uint32 i=mColors.colorsStartIndices[c]; i < mColors.colorsStartIndices[c + 1]; i++) {
+
+            ContactLaneGroupSolver& laneGroup = mLaneGroups[laneGroupIndex];
+            addManifoldToLaneGroup(mColors.constraints[i], laneGroup);
+
+            if (laneGroup.nbLanes == SIMD_WIDTH) {
+                laneGroupIndex++;
+            }
+        }
+    }
+}
+
+// Copy a contact manifold into a lane of a lane group
+void ContactSolverSystem::addManifoldToLaneGroup(uint32 manifoldIndex, ContactLaneGroupSolver& laneGroup) {
+
+    assert(laneGroup.nbLanes < SIMD_WIDTH);
+
+    const ContactManifoldSolver& manifold = mContactConstraints[manifoldIndex];
+    const uint32 lane = laneGroup.nbLanes;
+    laneGroup.nbLanes++;
+
+    laneGroup.manifoldIndices[lane] = manifoldIndex;
+    laneGroup.solverBodyIndicesBody1[lane] = manifold.solverBodyIndexBody1;
+    laneGroup.solverBodyIndicesBody2[lane] = manifold.solverBodyIndexBody2;
+    laneGroup.nbContacts = std::max(laneGroup.nbContacts, static_cast<uint32>(manifold.nbContacts));
+    laneGroup.massInverseBody1[lane] = manifold.massInverseBody1;
+    laneGroup.massInverseBody2[lane] = manifold.massInverseBody2;
+    setLane(laneGroup.linearLockAxisFactorBody1, lane, manifold.linearLockAxisFactorBody1);
+    setLane(laneGroup.linearLockAxisFactorBody2, lane, manifold.linearLockAxisFactorBody2);
+    setLane(laneGroup.angularLockAxisFactorBody1, lane, manifold.angularLockAxisFactorBody1);
+    setLane(laneGroup.angularLockAxisFactorBody2, lane, manifold.angularLockAxisFactorBody2);
+    for (int row=0; row < 3; row++) {
+        for (int column=0; column < 3; column++) {
+            laneGroup.inverseInertiaTensorBody1[row * 3 + column][lane] = manifold.inverseInertiaTensorBody1[row][column];
+            laneGroup.inverseInertiaTensorBody2[row * 3 + column][lane] = manifold.inverseInertiaTensorBody2[row][column];
+        }
+    }
+    laneGroup.frictionCoefficient[lane] = manifold.frictionCoefficient;
+    setLane(laneGroup.normal, lane, manifold.normal);
+    setLane(laneGroup.r1Friction, lane, manifold.r1Friction);
+    setLane(laneGroup.r2Friction, lane, manifold.r2Friction);
+    setLane(laneGroup.r1CrossT1, lane, manifold.r1CrossT1);
+    setLane(laneGroup.r1CrossT2, lane, manifold.r1CrossT2);
+    setLane(laneGroup.r2CrossT1, lane, manifold.r2CrossT1);
+    setLane(laneGroup.r2CrossT2, lane, manifold.r2CrossT2);
+    setLane(laneGroup.frictionVector1, lane, manifold.frictionVector1);
+    setLane(laneGroup.frictionVector2, lane, manifold.frictionVector2);
+    laneGroup.inverseFriction1Mass[lane] = manifold.inverseFriction1Mass;
+    laneGroup.inverseFriction2Mass[lane] = manifold.inverseFriction2Mass;
+    laneGroup.inverseTwistFrictionMass[lane] = manifold.inverseTwistFrictionMass;
+    laneGroup.friction1Impulse[lane] = manifold.friction1Impulse;
+    laneGroup.friction2Impulse[lane] = manifold.friction2Impulse;
+    laneGroup.frictionTwistImpulse[lane] = manifold.frictionTwistImpulse;
+
+    // For each contact point of the manifold
+    const uint32 startContactPointIndex = manifold.externalContactManifold->contactPointsIndex;
+    for (uint32 i=0; i < static_cast<uint32>(manifold.nbContacts); i++) {
+
+        const ContactPointSolver& contactPoint = mContactPoints[startContactPointIndex + i];
+        ContactPointLanes& contactPointLanes = laneGroup.contactPoints[i];
+
+        setLane(contactPointLanes.normal, lane, contactPoint.normal);
+        setLane(contactPointLanes.r1, lane, contactPoint.r1);
+        setLane(contactPointLanes.r2, lane, contactPoint.r2);
+        contactPointLanes.penetrationDepth[lane] = contactPoint.penetrationDepth;
+        contactPointLanes.restitutionBias[lane] = contactPoint.restitutionBias;
+        contactPointLanes.inversePenetrationMass[lane] = contactPoint.inversePenetrationMass;
+        setLane(contactPointLanes.i1TimesR1CrossN, lane, contactPoint.i1TimesR1CrossN);
+        setLane(contactPointLanes.i2TimesR2CrossN, lane, contactPoint.i2TimesR2CrossN);
+        contactPointLanes.penetrationImpulse[lane] = contactPoint.penetrationImpulse;
+        contactPointLanes.penetrationSplitImpulse[lane] = contactPoint.penetrationSplitImpulse;
+    }
+}
+
+// Solve the contact manifolds of a lane group
+/// This method performs the same operations as the solve() method in the same order
+/// but for the SIMD_WIDTH contact manifolds of the lane group at a time. Because the
+/// contact manifolds of a lane group do not share any dynamic body, each lane gives
+/// exactly the same result as solving its contact manifold alone.
+void ContactSolverSystem::solveLaneGroup(ContactLaneGroupSolver& laneGroup) {
+
+    const decimal beta = mIsSplitImpulseActive ? BETA_SPLIT_IMPULSE : BETA;
+    const SimdFloat4 zero = simdSet(decimal(0.0));
+    const SimdFloat4 slop = simdSet(SLOP);
+    const SimdFloat4 minusBetaOverTimeStep = simdSet(-(beta/mTimeStep));
+
+    const uint32 nbLanes = laneGroup.nbLanes;
+
+    // Get the constrained velocities
+    SimdVector3 v1 = gatherLanes(mSolverBodies.linearVelocities, laneGroup.solverBodyIndicesBody1, nbLanes);
+    SimdVector3 w1 = gatherLanes(mSolverBodies.angularVelocities, laneGroup.solverBodyIndicesBody1, nbLanes);
+    SimdVector3 v2 = gatherLanes(mSolverBodies.linearVelocities, laneGroup.solverBodyIndicesBody2, nbLanes);
+    SimdVector3 w2 = gatherLanes(mSolverBodies.angularVelocities, laneGroup.solverBodyIndicesBody2, nbLanes);
+
+    SimdVector3 v1Split = {zero, zero, zero};
+    SimdVector3 w1Split = {zero, zero, zero};
+    SimdVector3 v2Split = {zero, zero, zero};
+    SimdVector3 w2Split = {zero, zero, zero};
+    if (mIsSplitImpulseActive) {
+        v1Split = gatherLanes(mSolverBodies.splitLinearVelocities, laneGroup.solverBodyIndicesBody1, nbLanes);
+        w1Split = gatherLanes(mSolverBodies.splitAngularVelocities, laneGroup.solverBodyIndicesBody1, nbLanes);
+        v2Split = gatherLanes(mSolverBodies.splitLinearVelocities, laneGroup.solverBodyIndicesBody2, nbLanes);
+        w2Split = gatherLanes(mSolverBodies.splitAngularVelocities, laneGroup.solverBodyIndicesBody2, nbLanes);
+    }
+
+    const SimdFloat4 massInverseBody1 = simdLoad(laneGroup.massInverseBody1);
+    const SimdFloat4 massInverseBody2 = simdLoad(laneGroup.massInverseBody2);
+    const SimdVector3 linearLockAxisFactorBody1 = loadLanes(laneGroup.linearLockAxisFactorBody1);
+    const SimdVector3 linearLockAxisFactorBody2 = loadLanes(laneGroup.linearLockAxisFactorBody2);
+    const SimdVector3 angularLockAxisFactorBody1 = loadLanes(laneGroup.angularLockAxisFactorBody1);
+    const SimdVector3 angularLockAxisFactorBody2 = loadLanes(laneGroup.angularLockAxisFactorBody2);
+
+    SimdFloat4 sumPenetrationImpulse = zero;
+
+    for (uint32 i=0; i < laneGroup.nbContacts; i++) {
+
+        ContactPointLanes& contactPoint = laneGroup.contactPoints[i];
+
+        const SimdVector3 normal = loadLanes(contactPoint.normal);
+        const SimdVector3 r1 = loadLanes(contactPoint.r1);
+        const SimdVector3 r2 = loadLanes(contactPoint.r2);
+        const SimdVector3 i1TimesR1CrossN = loadLanes(contactPoint.i1TimesR1CrossN);
+        const SimdVector3 i2TimesR2CrossN = loadLanes(contactPoint.i2TimesR2CrossN);
+        const SimdFloat4 penetrationDepth = simdLoad(contactPoint.penetrationDepth);
+        const SimdFloat4 restitutionBias = simdLoad(contactPoint.restitutionBias);
+        const SimdFloat4 inversePenetrationMass = simdLoad(contactPoint.inversePenetrationMass);
+
+        // --------- Penetration --------- //
+
+        // Compute J*v
+        const SimdFloat4 deltaVX = v2.x + w2.y * r2.z - w2.z * r2.y - v1.x - w1.y * r1.z + w1.z * r1.y;
+        const SimdFloat4 deltaVY = v2.y + w2.z * r2.x - w2.x * r2.z - v1.y - w1.z * r1.x + w1.x * r1.z;
+        const SimdFloat4 deltaVZ = v2.z + w2.x * r2.y - w2.y * r2.x - v1.z - w1.x * r1.y + w1.y * r1.x;
+        const SimdFloat4 Jv = deltaVX * normal.x + deltaVY * normal.y + deltaVZ * normal.z;
+
+        // Compute the bias "b" of the constraint
+        const SimdFloat4 biasPenetrationDepth = simdSelect(penetrationDepth > slop,
+                                                           minusBetaOverTimeStep * simdMax(zero, penetrationDepth - slop), zero);
+
+        // Compute the Lagrange multiplier lambda
+        SimdFloat4 deltaLambda;
+        if (mIsSplitImpulseActive) {
+            deltaLambda = -(Jv + restitutionBias) * inversePenetrationMass;
+        }
+        else {
+            deltaLambda = -(Jv + (biasPenetrationDepth + restitutionBias)) * inversePenetrationMass;
+        }
+        const SimdFloat4 lambdaTemp = simdLoad(contactPoint.penetrationImpulse);
+        const SimdFloat4 penetrationImpulse = simdMax(lambdaTemp + deltaLambda, zero);
+        simdStore(contactPoint.penetrationImpulse, penetrationImpulse);
+        deltaLambda = penetrationImpulse - lambdaTemp;
+
+        const SimdVector3 linearImpulse = {normal.x * deltaLambda, normal.y * deltaLambda, normal.z * deltaLambda};
+
+        // Update the velocities of the body 1 by applying the impulse P
+        v1.x = v1.x - massInverseBody1 * linearImpulse.x * linearLockAxisFactorBody1.x;
+        v1.y = v1.y - massInverseBody1 * linearImpulse.y * linearLockAxisFactorBody1.y;
+        v1.z = v1.z - massInverseBody1 * linearImpulse.z * linearLockAxisFactorBody1.z;
+
+        w1.x = w1.x - i1TimesR1CrossN.x * angularLockAxisFactorBody1.x * deltaLambda;
+        w1.y = w1.y - i1TimesR1CrossN.y * angularLockAxisFactorBody1.y * deltaLambda;
+        w1.z = w1.z - i1TimesR1CrossN.z * angularLockAxisFactorBody1.z * deltaLambda;
+
+        // Update the velocities of the body 2 by applying the impulse P
+        v2.x = v2.x + massInverseBody2 * linearImpulse.x * linearLockAxisFactorBody2.x;
+        v2.y = v2.y + massInverseBody2 * linearImpulse.y * linearLockAxisFactorBody2.y;
+        v2.z = v2.z + massInverseBody2 * linearImpulse.z * linearLockAxisFactorBody2.z;
+
+        w2.x = w2.x + i2TimesR2CrossN.x * angularLockAxisFactorBody2.x * deltaLambda;
+        w2.y = w2.y + i2TimesR2CrossN.y * angularLockAxisFactorBody2.y * deltaLambda;
+        w2.z = w2.z + i2TimesR2CrossN.z * angularLockAxisFactorBody2.z * deltaLambda;
+
+        sumPenetrationImpulse = sumPenetrationImpulse + penetrationImpulse;
+
+        // If the split impulse position correction is active
+        if (mIsSplitImpulseActive) {
+
+            // Split impulse (position correction)
+            const SimdFloat4 deltaVSplitX = v2Split.x + w2Split.y * r2.z - w2Split.z * r2.y - v1Split.x -
+                                            w1Split.y * r1.z + w1Split.z * r1.y;
+            const SimdFloat4 deltaVSplitY = v2Split.y + w2Split.z * r2.x - w2Split.x * r2.z - v1Split.y -
+                                            w1Split.z * r1.x + w1Split.x * r1.z;
+            const SimdFloat4 deltaVSplitZ = v2Split.z + w2Split.x * r2.y - w2Split.y * r2.x - v1Split.z -
+                                            w1Split.x * r1.y + w1Split.y * r1.x;
+            const SimdFloat4 JvSplit = deltaVSplitX * normal.x + deltaVSplitY * normal.y + deltaVSplitZ * normal.z;
+            SimdFloat4 deltaLambdaSplit = -(JvSplit + biasPenetrationDepth) * inversePenetrationMass;
+            const SimdFloat4 lambdaTempSplit = simdLoad(contactPoint.penetrationSplitImpulse);
+            const SimdFloat4 penetrationSplitImpulse = simdMax(lambdaTempSplit + deltaLambdaSplit, zero);
+            simdStore(contactPoint.penetrationSplitImpulse, penetrationSplitImpulse);
+            deltaLambdaSplit = penetrationSplitImpulse - lambdaTempSplit;
+
+            const SimdVector3 linearImpulseSplit = {normal.x * deltaLambdaSplit, normal.y * deltaLambdaSplit,
+                                                    normal.z * deltaLambdaSplit};
+
+            // Update the velocities of the body 1 by applying the impulse P
+            v1Split.x = v1Split.x - massInverseBody1 * linearImpulseSplit.x * linearLockAxisFactorBody1.x;
+            v1Split.y = v1Split.y - massInverseBody1 * linearImpulseSplit.y * linearLockAxisFactorBody1.y;
+            v1Split.z = v1Split.z - massInverseBody1 * linearImpulseSplit.z * linearLockAxisFactorBody1.z;
+
+            w1Split.x = w1Split.x - i1TimesR1CrossN.x * angularLockAxisFactorBody1.x * deltaLambdaSplit;
+            w1Split.y = w1Split.y - i1TimesR1CrossN.y * angularLockAxisFactorBody1.y * deltaLambdaSplit;
+            w1Split.z = w1Split.z - i1TimesR1CrossN.z * angularLockAxisFactorBody1.z * deltaLambdaSplit;
+
+            // Update the velocities of the body 2 by applying the impulse P
+            v2Split.x = v2Split.x + massInverseBody2 * linearImpulseSplit.x * linearLockAxisFactorBody2.x;
+            v2Split.y = v2Split.y + massInverseBody2 * linearImpulseSplit.y * linearLockAxisFactorBody2.y;
+            v2Split.z = v2Split.z + massInverseBody2 * linearImpulseSplit.z * linearLockAxisFactorBody2.z;
+
+            w2Split.x = w2Split.x + i2TimesR2CrossN.x * angularLockAxisFactorBody2.x * deltaLambdaSplit;
+            w2Split.y = w2Split.y + i2TimesR2CrossN.y * angularLockAxisFactorBody2.y * deltaLambdaSplit;
+            w2Split.z = w2Split.z + i2TimesR2CrossN.z * angularLockAxisFactorBody2.z * deltaLambdaSplit;
+        }
+    }
+
+    SimdFloat4 inverseInertiaTensorBody1[9];
+    SimdFloat4 inverseInertiaTensorBody2[9];
+    for (uint32 i=0; i < 9; i++) {
+        inverseInertiaTensorBody1[i] = simdLoad(laneGroup.inverseInertiaTensorBody1[i]);
+        inverseInertiaTensorBody2[i] = simdLoad(laneGroup.inverseInertiaTensorBody2[i]);
+    }
+
+    const SimdFloat4 frictionCoefficient = simdLoad(laneGroup.frictionCoefficient);
+    const SimdVector3 r1Friction = loadLanes(laneGroup.r1Friction);
+    const SimdVector3 r2Friction = loadLanes(laneGroup.r2Friction);
+
+    // ------ First and second friction constraints at the center of the contact manifold ------ //
+
+    for (uint32 f=0; f < 2; f++) {
+
+        const SimdVector3 frictionVector = loadLanes(f == 0 ? laneGroup.frictionVector1 : laneGroup.frictionVector2);
+        const SimdVector3 r1CrossT = loadLanes(f == 0 ? laneGroup.r1CrossT1 : laneGroup.r1CrossT2);
+        const SimdVector3 r2CrossT = loadLanes(f == 0 ? laneGroup.r2CrossT1 : laneGroup.r2CrossT2);
+        const SimdFloat4 inverseFrictionMass = simdLoad(f == 0 ? laneGroup.inverseFriction1Mass : laneGroup.inverseFriction2Mass);
+        decimal (&frictionImpulseLanes)[SIMD_WIDTH] = f == 0 ? laneGroup.friction1Impulse : laneGroup.friction2Impulse;
+
+        // Compute J*v
+        const SimdFloat4 deltaVX = v2.x + w2.y * r2Friction.z - w2.z * r2Friction.y - v1.x -
+                                   w1.y * r1Friction.z + w1.z * r1Friction.y;
+        const SimdFloat4 deltaVY = v2.y + w2.z * r2Friction.x - w2.x * r2Friction.z - v1.y -
+                                   w1.z * r1Friction.x + w1.x * r1Friction.z;
+        const SimdFloat4 deltaVZ = v2.z + w2.x * r2Friction.y - w2.y * r2Friction.x - v1.z -
+                                   w1.x * r1Friction.y + w1.y * r1Friction.x;
+        const SimdFloat4 Jv = deltaVX * frictionVector.x + deltaVY * frictionVector.y + deltaVZ * frictionVector.z;
+
+        // Compute the Lagrange multiplier lambda
+        SimdFloat4 deltaLambda = -Jv * inverseFrictionMass;
+        const SimdFloat4 frictionLimit = frictionCoefficient * sumPenetrationImpulse;
+        const SimdFloat4 lambdaTemp = simdLoad(frictionImpulseLanes);
+        const SimdFloat4 frictionImpulse = simdMax(-frictionLimit, simdMin(lambdaTemp + deltaLambda, frictionLimit));
+        simdStore(frictionImpulseLanes, frictionImpulse);
+        deltaLambda = frictionImpulse - lambdaTemp;
+
+        // Compute the impulse P=J^T * lambda
+        const SimdVector3 angularImpulseBody1 = {-r1CrossT.x * deltaLambda, -r1CrossT.y * deltaLambda, -r1CrossT.z * deltaLambda};
+        const SimdVector3 linearImpulseBody2 = {frictionVector.x * deltaLambda, frictionVector.y * deltaLambda,
+                                                frictionVector.z * deltaLambda};
+        const SimdVector3 angularImpulseBody2 = {r2CrossT.x * deltaLambda, r2CrossT.y * deltaLambda, r2CrossT.z * deltaLambda};
+
+        // Update the velocities of the body 1 by applying the impulse P
+        v1.x = v1.x - massInverseBody1 * linearImpulseBody2.x * linearLockAxisFactorBody1.x;
+        v1.y = v1.y - massInverseBody1 * linearImpulseBody2.y * linearLockAxisFactorBody1.y;
+        v1.z = v1.z - massInverseBody1 * linearImpulseBody2.z * linearLockAxisFactorBody1.z;
+
+        const SimdVector3 angularVelocity1 = multiply(inverseInertiaTensorBody1, angularImpulseBody1);
+        w1.x = w1.x + angularLockAxisFactorBody1.x * angularVelocity1.x;
+        w1.y = w1.y + angularLockAxisFactorBody1.y * angularVelocity1.y;
+        w1.z = w1.z + angularLockAxisFactorBody1.z * angularVelocity1.z;
+
+        // Update the velocities of the body 2 by applying the impulse P
+        v2.x = v2.x + massInverseBody2 * linearImpulseBody2.x * linearLockAxisFactorBody2.x;
+        v2.y = v2.y + massInverseBody2 * linearImpulseBody2.y * linearLockAxisFactorBody2.y;
+        v2.z = v2.z + massInverseBody2 * linearImpulseBody2.z * linearLockAxisFactorBody2.z;
+
+        const SimdVector3 angularVelocity2 = multiply(inverseInertiaTensorBody2, angularImpulseBody2);
+        w2.x = w2.x + angularLockAxisFactorBody2.x * angularVelocity2.x;
+        w2.y = w2.y + angularLockAxisFactorBody2.y * angularVelocity2.y;
+        w2.z = w2.z + angularLockAxisFactorBody2.z * angularVelocity2.z;
+    }
+
+    // ------ Twist friction constraint at the center of the contact manifold ------ //
+
+    const SimdVector3 normal = loadLanes(laneGroup.normal);
+
+    // Compute J*v
+    const SimdFloat4 Jv = (w2.x - w1.x) * normal.x + (w2.y - w1.y) * normal.y + (w2.z - w1.z) * normal.z;
+
+    SimdFloat4 deltaLambda = -Jv * simdLoad(laneGroup.inverseTwistFrictionMass);
+    const SimdFloat4 frictionLimit = frictionCoefficient * sumPenetrationImpulse;
+    const SimdFloat4 lambdaTemp = simdLoad(laneGroup.frictionTwistImpulse);
+    const SimdFloat4 frictionTwistImpulse = simdMax(-frictionLimit, simdMin(lambdaTemp + deltaLambda, frictionLimit));
+    simdStore(laneGroup.frictionTwistImpulse, frictionTwistImpulse);
+    deltaLambda = frictionTwistImpulse - lambdaTemp;
+
+    // Compute the impulse P=J^T * lambda
+    const SimdVector3 angularImpulseBody2 = {normal.x * deltaLambda, normal.y * deltaLambda, normal.z * deltaLambda};
+
+    // Update the velocities of the body 1 by applying the impulse P
+    const SimdVector3 angularVelocity1 = multiply(inverseInertiaTensorBody1, angularImpulseBody2);
+    w1.x = w1.x - angularLockAxisFactorBody1.x * angularVelocity1.x;
+    w1.y = w1.y - angularLockAxisFactorBody1.y * angularVelocity1.y;
+    w1.z = w1.z - angularLockAxisFactorBody1.z * angularVelocity1.z;
+
+    // Update the velocities of the body 2 by applying the impulse P
+    const SimdVector3 angularVelocity2 = multiply(inverseInertiaTensorBody2, angularImpulseBody2);
+    w2.x = w2.x + angularLockAxisFactorBody2.x * angularVelocity2.x;
+    w2.y = w2.y + angularLockAxisFactorBody2.y * angularVelocity2.y;
+    w2.z = w2.z + angularLockAxisFactorBody2.z * angularVelocity2.z;
+
+    // Write the constrained velocities back into the solver bodies
+    scatterLanes(v1, laneGroup.solverBodyIndicesBody1, nbLanes, mSolverBodies.linearVelocities);
+    scatterLanes(w1, laneGroup.solverBodyIndicesBody1, nbLanes, mSolverBodies.angularVelocities);
+    scatterLanes(v2, laneGroup.solverBodyIndicesBody2, nbLanes, mSolverBodies.linearVelocities);
+    scatterLanes(w2, laneGroup.solverBodyIndicesBody2, nbLanes, mSolverBodies.angularVelocities);
+
+    if (mIsSplitImpulseActive) {
+        scatterLanes(v1Split, laneGroup.solverBodyIndicesBody1, nbLanes, mSolverBodies.splitLinearVelocities);
+        scatterLanes(w1Split, laneGroup.solverBodyIndicesBody1, nbLanes, mSolverBodies.splitAngularVelocities);
+        scatterLanes(v2Split, laneGroup.solverBodyIndicesBody2, nbLanes, mSolverBodies.splitLinearVelocities);
+        scatterLanes(w2Split, laneGroup.solverBodyIndicesBody2, nbLanes, mSolverBodies.splitAngularVelocities);
+    }
+}
+
+// Copy the accumulated impulses of the lane groups back into the contact constraints
+void ContactSolverSystem::storeLaneGroupsImpulses() {
+
+    for (uint32 g=0; g < mNbLaneGroups; g++) {
+
+        const ContactLaneGroupSolver& laneGroup = mLaneGroups[g];
+
+        for (uint32 lane=0; lane < laneGroup.nbLanes; lane++) {
+
+            ContactManifoldSolver& manifold = mContactConstraints[laneGroup.manifoldIndices[lane]];
+            manifold.friction1Impulse = laneGroup.friction1Impulse[lane];
+            manifold.friction2Impulse = laneGroup.friction2Impulse[lane];
+            manifold.frictionTwistImpulse = laneGroup.frictionTwistImpulse[lane];
+
+            const uint32 startContactPointIndex = manifold.externalContactManifold->contactPointsIndex;
+            for (uint32 i=0; i < static_cast<uint32>(manifold.nbContacts); i++) {
+                mContactPoints[startContactPointIndex + i].penetrationImpulse = laneGroup.contactPoints[i].penetrationImpulse[lane];
+                mContactPoints[startContactPointIndex + i].penetrationSplitImpulse = laneGroup.contactPoints[i].penetrationSplitImpulse[lane];
+            }
+        }
+    }
+}
+
+#endif
+
 // Compute the two unit orthogonal vectors "t1" and "t2" that span the tangential friction plane
 // for a contact manifold. The two vectors have to be such that : t1 x t2 = contactNormal.
 void ContactSolverSystem::computeFrictionVectors(const Vector3& deltaVelocity, ContactManifoldSolver& contact) const {
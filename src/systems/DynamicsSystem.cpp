@@ -30,11 +30,14 @@
 
 using namespace reactphysics3d;
 
+// Static variables definition
+const uint32 DynamicsSystem::NB_MIN_ITEMS_PER_TASK = 256;
+
 // Constructor
 DynamicsSystem::DynamicsSystem(PhysicsWorld& world, CollisionBodyComponents& collisionBodyComponents, RigidBodyComponents& rigidBodyComponents,
                                TransformComponents& transformComponents, ColliderComponents& colliderComponents, bool& isGravityEnabled, Vector3& gravity)
               :mWorld(world), mCollisionBodyComponents(collisionBodyComponents), mRigidBodyComponents(rigidBodyComponents), mTransformComponents(transformComponents), mColliderComponents(colliderComponents),
-               mIsGravityEnabled(isGravityEnabled), mGravity(gravity) {
+               mIsGravityEnabled(isGravityEnabled), mGravity(gravity), mTaskScheduler(nullptr) {
 
 }
 
@@ -48,7 +51,15 @@ void DynamicsSystem::integrateRigidBodiesPositions(decimal timeStep, bool isSpli
     const decimal isSplitImpulseFactor = isSplitImpulseActive ? decimal(1.0) : decimal(0.0);
 
     const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbEnabledComponents();
-    for (uint32 i=0; i < nbRigidBodyComponents; i++) {
+    parallelFor(mTaskScheduler, nbRigidBodyComponents, NB_MIN_ITEMS_PER_TASK, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+        integrateRigidBodiesPositions(timeStep, isSplitImpulseFactor, startIndex, endIndex);
+    });
+}
+
+// Integrate the positions and orientations of the rigid bodies in the range [startIndex, endIndex)
+void DynamicsSystem::integrateRigidBodiesPositions(decimal timeStep, decimal isSplitImpulseFactor, uint32 startIndex, uint32 endIndex) {
+
+    for (uint32 i=startIndex; i < endIndex; i++) {
 
         // Get the constrained velocity
         Vector3 newLinVelocity = mRigidBodyComponents.mConstrainedLinearVelocities[i];
@@ -71,42 +82,61 @@ void DynamicsSystem::integrateRigidBodiesPositions(decimal timeStep, bool isSpli
 }
 
 // Update the postion/orientation of the bodies
+/// The transform of a body is only changed if its center of mass or its orientation has changed
+/// and the bodies with a changed transform are marked in the transform components. Only the
+/// colliders of these bodies get a new local-to-world transform here and a new AABB in the
+/// broad-phase. Therefore, the bodies at rest (kinematic bodies without velocity for instance)
+/// cost almost nothing.
 void DynamicsSystem::updateBodiesState() {
 
     RP3D_PROFILE("DynamicsSystem::updateBodiesState()", mProfiler);
 
     const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbEnabledComponents();
-    for (uint32 i=0; i < nbRigidBodyComponents; i++) {
+    parallelFor(mTaskScheduler, nbRigidBodyComponents, NB_MIN_ITEMS_PER_TASK, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
 
-        // Update the linear and angular velocity of the body
-        mRigidBodyComponents.mLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i];
-        mRigidBodyComponents.mAngularVelocities[i] = mRigidBodyComponents.mConstrainedAngularVelocities[i];
+        for (uint32 i=startIndex; i < endIndex; i++) {
 
-        // Update the position of the center of mass of the body
-        mRigidBodyComponents.mCentersOfMassWorld[i] = mRigidBodyComponents.mConstrainedPositions[i];
+            // Update the linear and angular velocity of the body
+            mRigidBodyComponents.mLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i];
+            mRigidBodyComponents.mAngularVelocities[i] = mRigidBodyComponents.mConstrainedAngularVelocities[i];
 
-        // Update the orientation of the body
-        const Quaternion& constrainedOrientation = mRigidBodyComponents.mConstrainedOrientations[i];
-        mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]).setOrientation(constrainedOrientation.getUnit());
-    }
+            const uint32 transformIndex = mTransformComponents.mMapEntityToComponentIndex[mRigidBodyComponents.mBodiesEntities[i]];
+            Transform& transform = mTransformComponents.mTransforms[transformIndex];
+            const Quaternion& constrainedOrientation = mRigidBodyComponents.mConstrainedOrientations[i];
 
-    // Update the position of the body (using the new center of mass and new orientation)
-    for (uint32 i=0; i < nbRigidBodyComponents; i++) {
+            // If the body has not moved, its transform does not change
+            const bool hasTransformChanged = mRigidBodyComponents.mConstrainedPositions[i] != mRigidBodyComponents.mCentersOfMassWorld[i] ||
+                                             !(constrainedOrientation == transform.getOrientation());
+            mTransformComponents.mHasTransformChanged[transformIndex] = hasTransformChanged;
+            if (!hasTransformChanged) continue;
 
-        Transform& transform = mTransformComponents.getTransform(mRigidBodyComponents.mBodiesEntities[i]);
-        const Vector3& centerOfMassWorld = mRigidBodyComponents.mCentersOfMassWorld[i];
-        const Vector3& centerOfMassLocal = mRigidBodyComponents.mCentersOfMassLocal[i];
-        transform.setPosition(centerOfMassWorld - transform.getOrientation() * centerOfMassLocal);
-    }
+            // Update the position of the center of mass of the body
+            mRigidBodyComponents.mCentersOfMassWorld[i] = mRigidBodyComponents.mConstrainedPositions[i];
+
+            // Update the orientation of the body
+            transform.setOrientation(constrainedOrientation.getUnit());
+
+            // Update the position of the body (using the new center of mass and new orientation)
+            const Vector3& centerOfMassWorld = mRigidBodyComponents.mCentersOfMassWorld[i];
+            const Vector3& centerOfMassLocal = mRigidBodyComponents.mCentersOfMassLocal[i];
+            transform.setPosition(centerOfMassWorld - transform.getOrientation() * centerOfMassLocal);
+        }
+    });
 
-    // Update the local-to-world transform of the colliders
+    // Update the local-to-world transform of the colliders of the bodies that have moved
     const uint32 nbColliderComponents = mColliderComponents.getNbEnabledComponents();
-    for (uint32 i=0; i < nbColliderComponents; i++) {
+    parallelFor(mTaskScheduler, nbColliderComponents, NB_MIN_ITEMS_PER_TASK, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
 
-        // Update the local-to-world transform of the collider
-        mColliderComponents.mLocalToWorldTransforms[i] = mTransformComponents.getTransform(mColliderComponents.mBodiesEntities[i]) *
-                                                           mColliderComponents.mLocalToBodyTransforms[i];
-    }
+        for (uint32 i=startIndex; i < endIndex; i++) {
+
+            const uint32 transformIndex = mTransformComponents.mMapEntityToComponentIndex[mColliderComponents.mBodiesEntities[i]];
+            if (!mTransformComponents.mHasTransformChanged[transformIndex]) continue;
+
+            // Update the local-to-world transform of the collider
+            mColliderComponents.mLocalToWorldTransforms[i] = mTransformComponents.mTransforms[transformIndex] *
+                                                               mColliderComponents.mLocalToBodyTransforms[i];
+        }
+    });
 }
 
 // Integrate the velocities of rigid bodies.
@@ -118,15 +148,20 @@ void DynamicsSystem::integrateRigidBodiesVelocities(decimal timeStep) {
 
     RP3D_PROFILE("DynamicsSystem::integrateRigidBodiesVelocities()", mProfiler);
 
-    // Reset the split velocities of the bodies
-    resetSplitVelocities();
-
-    // Integration component velocities using force/torque
     const uint32 nbEnabledRigidBodyComponents = mRigidBodyComponents.getNbEnabledComponents();
-    for (uint32 i=0; i < nbEnabledRigidBodyComponents; i++) {
+    parallelFor(mTaskScheduler, nbEnabledRigidBodyComponents, NB_MIN_ITEMS_PER_TASK, [&](uint32 startIndex, uint32 endIndex, uint32 /*workerIndex*/) {
+        integrateRigidBodiesVelocities(timeStep, startIndex, endIndex);
+    });
+}
+
+// Integrate the velocities of the rigid bodies in the range [startIndex, endIndex)
+void DynamicsSystem::integrateRigidBodiesVelocities(decimal timeStep, uint32 startIndex, uint32 endIndex) {
 
-        assert(mRigidBodyComponents.mSplitLinearVelocities[i] == Vector3(0, 0, 0));
-        assert(mRigidBodyComponents.mSplitAngularVelocities[i] == Vector3(0, 0, 0));
+    for (uint32 i=startIndex; i < endIndex; i++) {
+
+        // Reset the split velocities of the body
+        mRigidBodyComponents.mSplitLinearVelocities[i].setToZero();
+        mRigidBodyComponents.mSplitAngularVelocities[i].setToZero();
 
         const Vector3& linearVelocity = mRigidBodyComponents.mLinearVelocities[i];
         const Vector3& angularVelocity = mRigidBodyComponents.mAngularVelocities[i];
@@ -136,43 +171,31 @@ void DynamicsSystem::integrateRigidBodiesVelocities(decimal timeStep) {
                                                                mRigidBodyComponents.mLinearLockAxisFactors[i] * mRigidBodyComponents.mExternalForces[i];
         mRigidBodyComponents.mConstrainedAngularVelocities[i] = angularVelocity + timeStep * mRigidBodyComponents.mAngularLockAxisFactors[i] *
                                                                 (mRigidBodyComponents.mInverseInertiaTensorsWorld[i] * mRigidBodyComponents.mExternalTorques[i]);
-    }
-
-    // Apply gravity force
-    if (mIsGravityEnabled) {
 
-        const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbEnabledComponents();
-        for (uint32 i=0; i < nbRigidBodyComponents; i++) {
+        // If the gravity has to be applied to this rigid body
+        if (mIsGravityEnabled && mRigidBodyComponents.mIsGravityEnabled[i]) {
 
-            // If the gravity has to be applied to this rigid body
-            if (mRigidBodyComponents.mIsGravityEnabled[i]) {
-
-                // Integrate the gravity force
-                mRigidBodyComponents.mConstrainedLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i] + timeStep *
-                                                                       mRigidBodyComponents.mInverseMasses[i] * mRigidBodyComponents.mLinearLockAxisFactors[i] *
-                                                                       mRigidBodyComponents.mMasses[i] * mGravity;
-            }
+            // Integrate the gravity force
+            mRigidBodyComponents.mConstrainedLinearVelocities[i] = mRigidBodyComponents.mConstrainedLinearVelocities[i] + timeStep *
+                                                                   mRigidBodyComponents.mInverseMasses[i] * mRigidBodyComponents.mLinearLockAxisFactors[i] *
+                                                                   mRigidBodyComponents.mMasses[i] * mGravity;
         }
-    }
-
-    // Apply the velocity damping
-    // Damping force : F_c = -c' * v (c=damping factor)
-    // Differential Equation      : m * dv/dt = -c' * v
-    //                              => dv/dt = -c * v (with c=c'/m)
-    //                              => dv/dt + c * v = 0
-    // Solution      : v(t) = v0 * e^(-c * t)
-    //                 => v(t + dt) = v0 * e^(-c(t + dt))
-    //                              = v0 * e^(-c * t) * e^(-c * dt)
-    //                              = v(t) * e^(-c * dt)
-    //                 => v2 = v1 * e^(-c * dt)
-    // Using Padé's approximation of the exponential function:
-    // Reference: https://mathworld.wolfram.com/PadeApproximant.html
-    //                   e^x ~ 1 / (1 - x)
-    //                      => e^(-c * dt) ~ 1 / (1 + c * dt)
-    //                      => v2 = v1 * 1 / (1 + c * dt)
-    const uint32 nbRigidBodyComponents = mRigidBodyComponents.getNbEnabledComponents();
-    for (uint32 i=0; i < nbRigidBodyComponents; i++) {
 
+        // Apply the velocity damping
+        // Damping force : F_c = -c' * v (c=damping factor)
+        // Differential Equation      : m * dv/dt = -c' * v
+        //                              => dv/dt = -c * v (with c=c'/m)
+        //                              => dv/dt + c * v = 0
+        // Solution      : v(t) = v0 * e^(-c * t)
+        //                 => v(t + dt) = v0 * e^(-c(t + dt))
+        //                              = v0 * e^(-c * t) * e^(-c * dt)
+        //                              = v(t) * e^(-c * dt)
+        //                 => v2 = v1 * e^(-c * dt)
+        // Using Padé's approximation of the exponential function:
+        // Reference: https://mathworld.wolfram.com/PadeApproximant.html
+        //                   e^x ~ 1 / (1 - x)
+        //                      => e^(-c * dt) ~ 1 / (1 + c * dt)
+        //                      => v2 = v1 * 1 / (1 + c * dt)
         const decimal linDampingFactor = mRigidBodyComponents.mLinearDampings[i];
         const decimal angDampingFactor = mRigidBodyComponents.mAngularDampings[i];
         const decimal linearDamping = decimal(1.0) / (decimal(1.0) + linDampingFactor * timeStep);
@@ -34,13 +34,15 @@ using namespace reactphysics3d;
 const decimal SolveFixedJointSystem::BETA = decimal(0.2);
 
 // Constructor
-SolveFixedJointSystem::SolveFixedJointSystem(PhysicsWorld& world, RigidBodyComponents& rigidBodyComponents,
+SolveFixedJointSystem::SolveFixedJointSystem(PhysicsWorld& world, MemoryAllocator& allocator, SolverBodies& solverBodies,
+                                             RigidBodyComponents& rigidBodyComponents,
                                              TransformComponents& transformComponents,
                                              JointComponents& jointComponents,
                                              FixedJointComponents& fixedJointComponents)
-              :mWorld(world), mRigidBodyComponents(rigidBodyComponents), mTransformComponents(transformComponents),
+              :mWorld(world), mSolverBodies(solverBodies), mRigidBodyComponents(rigidBodyComponents), mTransformComponents(transformComponents),
                mJointComponents(jointComponents), mFixedJointComponents(fixedJointComponents),
-               mTimeStep(0), mIsWarmStartingActive(true) {
+               mTimeStep(0), mIsWarmStartingActive(true), mSolverBody1Indices(allocator),
+               mSolverBody2Indices(allocator), mPositionCorrectionTechniques(allocator) {
 
 }
 
@@ -49,6 +51,10 @@ void SolveFixedJointSystem::initBeforeSolve() {
 
     const decimal biasFactor = BETA / mTimeStep;
 
+    mSolverBody1Indices.clear();
+    mSolverBody2Indices.clear();
+    mPositionCorrectionTechniques.clear();
+
     // For each joint
     const uint32 nbJoints = mFixedJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbJoints; i++) {
@@ -66,6 +72,11 @@ void SolveFixedJointSystem::initBeforeSolve() {
         assert(!mRigidBodyComponents.getIsEntityDisabled(body1Entity));
         assert(!mRigidBodyComponents.getIsEntityDisabled(body2Entity));
 
+        // Store the solver bodies and the position correction technique used by the solver iterations
+        mSolverBody1Indices.add(mSolverBodies.jointsBody1Indices[jointIndex]);
+        mSolverBody2Indices.add(mSolverBodies.jointsBody2Indices[jointIndex]);
+        mPositionCorrectionTechniques.add(mJointComponents.mPositionCorrectionTechniques[jointIndex]);
+
         // Get the inertia tensor of bodies
         mFixedJointComponents.mI1[i] = mRigidBodyComponents.mInverseInertiaTensorsWorld[componentIndexBody1];
         mFixedJointComponents.mI2[i] = mRigidBodyComponents.mInverseInertiaTensorsWorld[componentIndexBody2];
@@ -149,25 +160,19 @@ void SolveFixedJointSystem::warmstart() {
     const uint32 nbJoints = mFixedJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbJoints; i++) {
 
-        const Entity jointEntity = mFixedJointComponents.mJointEntities[i];
-        const uint32 jointIndex = mJointComponents.getEntityIndex(jointEntity);
-
-        // Get the bodies entities
-        const Entity body1Entity = mJointComponents.mBody1Entities[jointIndex];
-        const Entity body2Entity = mJointComponents.mBody2Entities[jointIndex];
-
-        const uint32 componentIndexBody1 = mRigidBodyComponents.getEntityIndex(body1Entity);
-        const uint32 componentIndexBody2 = mRigidBodyComponents.getEntityIndex(body2Entity);
+        // Get the solver bodies of the joint
+        const uint32 solverIndexBody1 = mSolverBody1Indices[i];
+        const uint32 solverIndexBody2 = mSolverBody2Indices[i];
 
         // Get the velocities
-        Vector3& v1 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody1];
-        Vector3& v2 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody2];
-        Vector3& w1 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody1];
-        Vector3& w2 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody2];
+        Vector3& v1 = mSolverBodies.linearVelocities[solverIndexBody1];
+        Vector3& v2 = mSolverBodies.linearVelocities[solverIndexBody2];
+        Vector3& w1 = mSolverBodies.angularVelocities[solverIndexBody1];
+        Vector3& w2 = mSolverBodies.angularVelocities[solverIndexBody2];
 
         // Get the inverse mass of the bodies
-        const decimal inverseMassBody1 = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-        const decimal inverseMassBody2 = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
+        const decimal inverseMassBody1 = mSolverBodies.inverseMasses[solverIndexBody1];
+        const decimal inverseMassBody2 = mSolverBodies.inverseMasses[solverIndexBody2];
 
         const Vector3& impulseTranslation = mFixedJointComponents.mImpulseTranslation[i];
         const Vector3& impulseRotation = mFixedJointComponents.mImpulseRotation[i];
@@ -185,8 +190,8 @@ void SolveFixedJointSystem::warmstart() {
         const Matrix3x3& i1 = mFixedJointComponents.mI1[i];
 
         // Apply the impulse to the body 1
-        v1 += inverseMassBody1 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody1] * linearImpulseBody1;
-        w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+        v1 += inverseMassBody1 * mSolverBodies.linearLockAxisFactors[solverIndexBody1] * linearImpulseBody1;
+        w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
         // Compute the impulse P=J^T * lambda for the 3 translation constraints for body 2
         Vector3 angularImpulseBody2 = -impulseTranslation.cross(r2World);
@@ -197,8 +202,8 @@ void SolveFixedJointSystem::warmstart() {
         const Matrix3x3& i2 = mFixedJointComponents.mI2[i];
 
         // Apply the impulse to the body 2
-        v2 += inverseMassBody2 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody2] * impulseTranslation;
-        w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
+        v2 += inverseMassBody2 * mSolverBodies.linearLockAxisFactors[solverIndexBody2] * impulseTranslation;
+        w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
     }
 }
 
@@ -208,81 +213,80 @@ void SolveFixedJointSystem::solveVelocityConstraint() {
     // For each joint
     const uint32 nbJoints = mFixedJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbJoints; i++) {
+        solveVelocityConstraint(i);
+    }
+}
 
-        const Entity jointEntity = mFixedJointComponents.mJointEntities[i];
-        const uint32 jointIndex = mJointComponents.getEntityIndex(jointEntity);
-
-        // Get the bodies entities
-        const Entity body1Entity = mJointComponents.mBody1Entities[jointIndex];
-        const Entity body2Entity = mJointComponents.mBody2Entities[jointIndex];
+// Solve the velocity constraint of a single joint
+void SolveFixedJointSystem::solveVelocityConstraint(uint32 jointComponentIndex) {
 
-        const uint32 componentIndexBody1 = mRigidBodyComponents.getEntityIndex(body1Entity);
-        const uint32 componentIndexBody2 = mRigidBodyComponents.getEntityIndex(body2Entity);
+    // Get the solver bodies of the joint
+    const uint32 solverIndexBody1 = mSolverBody1Indices[jointComponentIndex];
+    const uint32 solverIndexBody2 = mSolverBody2Indices[jointComponentIndex];
 
-        // Get the velocities
-        Vector3& v1 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody1];
-        Vector3& v2 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody2];
-        Vector3& w1 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody1];
-        Vector3& w2 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody2];
+    // Get the velocities
+    Vector3& v1 = mSolverBodies.linearVelocities[solverIndexBody1];
+    Vector3& v2 = mSolverBodies.linearVelocities[solverIndexBody2];
+    Vector3& w1 = mSolverBodies.angularVelocities[solverIndexBody1];
+    Vector3& w2 = mSolverBodies.angularVelocities[solverIndexBody2];
 
-        // Get the inverse mass of the bodies
-        decimal inverseMassBody1 = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-        decimal inverseMassBody2 = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
+    // Get the inverse mass of the bodies
+    decimal inverseMassBody1 = mSolverBodies.inverseMasses[solverIndexBody1];
+    decimal inverseMassBody2 = mSolverBodies.inverseMasses[solverIndexBody2];
 
-        const Vector3& r1World = mFixedJointComponents.mR1World[i];
-        const Vector3& r2World = mFixedJointComponents.mR2World[i];
+    const Vector3& r1World = mFixedJointComponents.mR1World[jointComponentIndex];
+    const Vector3& r2World = mFixedJointComponents.mR2World[jointComponentIndex];
 
-        // --------------- Translation Constraints --------------- //
+    // --------------- Translation Constraints --------------- //
 
-        // Compute J*v for the 3 translation constraints
-        const Vector3 JvTranslation = v2 + w2.cross(r2World) - v1 - w1.cross(r1World);
+    // Compute J*v for the 3 translation constraints
+    const Vector3 JvTranslation = v2 + w2.cross(r2World) - v1 - w1.cross(r1World);
 
-        const Matrix3x3& inverseMassMatrixTranslation = mFixedJointComponents.mInverseMassMatrixTranslation[i];
+    const Matrix3x3& inverseMassMatrixTranslation = mFixedJointComponents.mInverseMassMatrixTranslation[jointComponentIndex];
 
-        // Compute the Lagrange multiplier lambda
-        const Vector3 deltaLambda = inverseMassMatrixTranslation * (-JvTranslation - mFixedJointComponents.mBiasTranslation[i]);
-        mFixedJointComponents.mImpulseTranslation[i] += deltaLambda;
+    // Compute the Lagrange multiplier lambda
+    const Vector3 deltaLambda = inverseMassMatrixTranslation * (-JvTranslation - mFixedJointComponents.mBiasTranslation[jointComponentIndex]);
+    mFixedJointComponents.mImpulseTranslation[jointComponentIndex] += deltaLambda;
 
-        // Compute the impulse P=J^T * lambda for body 1
-        const Vector3 linearImpulseBody1 = -deltaLambda;
-        Vector3 angularImpulseBody1 = deltaLambda.cross(r1World);
+    // Compute the impulse P=J^T * lambda for body 1
+    const Vector3 linearImpulseBody1 = -deltaLambda;
+    Vector3 angularImpulseBody1 = deltaLambda.cross(r1World);
 
-        const Matrix3x3& i1 = mFixedJointComponents.mI1[i];
+    const Matrix3x3& i1 = mFixedJointComponents.mI1[jointComponentIndex];
 
-        // Apply the impulse to the body 1
-        v1 += inverseMassBody1 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody1] * linearImpulseBody1;
-        w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+    // Apply the impulse to the body 1
+    v1 += inverseMassBody1 * mSolverBodies.linearLockAxisFactors[solverIndexBody1] * linearImpulseBody1;
+    w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-        // Compute the impulse P=J^T * lambda  for body 2
-        const Vector3 angularImpulseBody2 = -deltaLambda.cross(r2World);
+    // Compute the impulse P=J^T * lambda  for body 2
+    const Vector3 angularImpulseBody2 = -deltaLambda.cross(r2World);
 
-        const Matrix3x3& i2 = mFixedJointComponents.mI2[i];
+    const Matrix3x3& i2 = mFixedJointComponents.mI2[jointComponentIndex];
 
-        // Apply the impulse to the body 2
-        v2 += inverseMassBody2 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody2] * deltaLambda;
-        w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
+    // Apply the impulse to the body 2
+    v2 += inverseMassBody2 * mSolverBodies.linearLockAxisFactors[solverIndexBody2] * deltaLambda;
+    w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
 
-        // --------------- Rotation Constraints --------------- //
+    // --------------- Rotation Constraints --------------- //
 
-        // Compute J*v for the 3 rotation constraints
-        const Vector3 JvRotation = w2 - w1;
+    // Compute J*v for the 3 rotation constraints
+    const Vector3 JvRotation = w2 - w1;
 
-        const Vector3& biasRotation = mFixedJointComponents.mBiasRotation[i];
-        const Matrix3x3& inverseMassMatrixRotation = mFixedJointComponents.mInverseMassMatrixRotation[i];
+    const Vector3& biasRotation = mFixedJointComponents.mBiasRotation[jointComponentIndex];
+    const Matrix3x3& inverseMassMatrixRotation = mFixedJointComponents.mInverseMassMatrixRotation[jointComponentIndex];
 
-        // Compute the Lagrange multiplier lambda for the 3 rotation constraints
-        Vector3 deltaLambda2 = inverseMassMatrixRotation * (-JvRotation - biasRotation);
-        mFixedJointComponents.mImpulseRotation[i] += deltaLambda2;
+    // Compute the Lagrange multiplier lambda for the 3 rotation constraints
+    Vector3 deltaLambda2 = inverseMassMatrixRotation * (-JvRotation - biasRotation);
+    mFixedJointComponents.mImpulseRotation[jointComponentIndex] += deltaLambda2;
 
-        // Compute the impulse P=J^T * lambda for the 3 rotation constraints for body 1
-        angularImpulseBody1 = -deltaLambda2;
+    // Compute the impulse P=J^T * lambda for the 3 rotation constraints for body 1
+    angularImpulseBody1 = -deltaLambda2;
 
-        // Apply the impulse to the body 1
-        w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+    // Apply the impulse to the body 1
+    w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-        // Apply the impulse to the body 2
-        w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * deltaLambda2);
-    }
+    // Apply the impulse to the body 2
+    w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * deltaLambda2);
 }
 
 // Solve the position constraint (for position error correction)
@@ -291,159 +295,158 @@ void SolveFixedJointSystem::solvePositionConstraint() {
     // For each joint
     const uint32 nbEnabledJoints = mFixedJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbEnabledJoints; i++) {
+        solvePositionConstraint(i);
+    }
+}
 
-        const Entity jointEntity = mFixedJointComponents.mJointEntities[i];
-        const uint32 jointIndex = mJointComponents.getEntityIndex(jointEntity);
+// Solve the position constraint (for position error correction) of a single joint
+void SolveFixedJointSystem::solvePositionConstraint(uint32 jointComponentIndex) {
 
-        // If the error position correction technique is not the non-linear-gauss-seidel, we do
-        // do not execute this method
-        if (mJointComponents.mPositionCorrectionTechniques[jointIndex] != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) continue;
+    // If the error position correction technique is not the non-linear-gauss-seidel, we do
+    // do not execute this method
+    if (mPositionCorrectionTechniques[jointComponentIndex] != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) return;
 
-        // Get the bodies entities
-        const Entity body1Entity = mJointComponents.mBody1Entities[jointIndex];
-        const Entity body2Entity = mJointComponents.mBody2Entities[jointIndex];
+    // Get the solver bodies of the joint
+    const uint32 solverIndexBody1 = mSolverBody1Indices[jointComponentIndex];
+    const uint32 solverIndexBody2 = mSolverBody2Indices[jointComponentIndex];
 
-        const uint32 componentIndexBody1 = mRigidBodyComponents.getEntityIndex(body1Entity);
-        const uint32 componentIndexBody2 = mRigidBodyComponents.getEntityIndex(body2Entity);
+    // Get the bodies positions and orientations
+    Quaternion& q1 = mSolverBodies.orientations[solverIndexBody1];
+    Quaternion& q2 = mSolverBodies.orientations[solverIndexBody2];
 
-        // Get the bodies positions and orientations
-        Quaternion& q1 = mRigidBodyComponents.mConstrainedOrientations[componentIndexBody1];
-        Quaternion& q2 = mRigidBodyComponents.mConstrainedOrientations[componentIndexBody2];
+    // Recompute the world inverse inertia tensors
+    RigidBody::computeWorldInertiaTensorInverse(q1.getMatrix(), mSolverBodies.inverseInertiaTensorsLocal[solverIndexBody1],
+                                                mFixedJointComponents.mI1[jointComponentIndex]);
 
-        // Recompute the world inverse inertia tensors
-        RigidBody::computeWorldInertiaTensorInverse(q1.getMatrix(), mRigidBodyComponents.getInertiaTensorLocalInverse(body1Entity),
-                                                    mFixedJointComponents.mI1[i]);
+    RigidBody::computeWorldInertiaTensorInverse(q2.getMatrix(), mSolverBodies.inverseInertiaTensorsLocal[solverIndexBody2],
+                                                mFixedJointComponents.mI2[jointComponentIndex]);
 
-        RigidBody::computeWorldInertiaTensorInverse(q2.getMatrix(), mRigidBodyComponents.getInertiaTensorLocalInverse(body2Entity),
-                                                    mFixedJointComponents.mI2[i]);
+    // Compute the vector from body center to the anchor point in world-space
+    mFixedJointComponents.mR1World[jointComponentIndex] = q1 * (mFixedJointComponents.mLocalAnchorPointBody1[jointComponentIndex] - mSolverBodies.centersOfMassLocal[solverIndexBody1]);
+    mFixedJointComponents.mR2World[jointComponentIndex] = q2 * (mFixedJointComponents.mLocalAnchorPointBody2[jointComponentIndex] - mSolverBodies.centersOfMassLocal[solverIndexBody2]);
 
-        // Compute the vector from body center to the anchor point in world-space
-        mFixedJointComponents.mR1World[i] = q1 * (mFixedJointComponents.mLocalAnchorPointBody1[i] - mRigidBodyComponents.mCentersOfMassLocal[componentIndexBody1]);
-        mFixedJointComponents.mR2World[i] = q2 * (mFixedJointComponents.mLocalAnchorPointBody2[i] - mRigidBodyComponents.mCentersOfMassLocal[componentIndexBody2]);
+    // Get the inverse mass and inverse inertia tensors of the bodies
+    decimal inverseMassBody1 = mSolverBodies.inverseMasses[solverIndexBody1];
+    decimal inverseMassBody2 = mSolverBodies.inverseMasses[solverIndexBody2];
 
-        // Get the inverse mass and inverse inertia tensors of the bodies
-        decimal inverseMassBody1 = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-        decimal inverseMassBody2 = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
+    const Vector3& r1World = mFixedJointComponents.mR1World[jointComponentIndex];
+    const Vector3& r2World = mFixedJointComponents.mR2World[jointComponentIndex];
 
-        const Vector3& r1World = mFixedJointComponents.mR1World[i];
-        const Vector3& r2World = mFixedJointComponents.mR2World[i];
+    // Compute the corresponding skew-symmetric matrices
+    Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(r1World);
+    Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(r2World);
 
-        // Compute the corresponding skew-symmetric matrices
-        Matrix3x3 skewSymmetricMatrixU1= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(r1World);
-        Matrix3x3 skewSymmetricMatrixU2= Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(r2World);
+    // --------------- Translation Constraints --------------- //
 
-        // --------------- Translation Constraints --------------- //
+    // Compute the matrix K=JM^-1J^t (3x3 matrix) for the 3 translation constraints
+    decimal inverseMassBodies = inverseMassBody1 + inverseMassBody2;
+    Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
+                                    0, inverseMassBodies, 0,
+                                    0, 0, inverseMassBodies) +
+                           skewSymmetricMatrixU1 * mFixedJointComponents.mI1[jointComponentIndex] * skewSymmetricMatrixU1.getTranspose() +
+                           skewSymmetricMatrixU2 * mFixedJointComponents.mI2[jointComponentIndex] * skewSymmetricMatrixU2.getTranspose();
+    mFixedJointComponents.mInverseMassMatrixTranslation[jointComponentIndex].setToZero();
+    decimal massMatrixDeterminant = massMatrix.getDeterminant();
+    if (std::abs(massMatrixDeterminant) > MACHINE_EPSILON) {
 
-        // Compute the matrix K=JM^-1J^t (3x3 matrix) for the 3 translation constraints
-        decimal inverseMassBodies = inverseMassBody1 + inverseMassBody2;
-        Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
-                                        0, inverseMassBodies, 0,
-                                        0, 0, inverseMassBodies) +
-                               skewSymmetricMatrixU1 * mFixedJointComponents.mI1[i] * skewSymmetricMatrixU1.getTranspose() +
-                               skewSymmetricMatrixU2 * mFixedJointComponents.mI2[i] * skewSymmetricMatrixU2.getTranspose();
-        mFixedJointComponents.mInverseMassMatrixTranslation[i].setToZero();
-        decimal massMatrixDeterminant = massMatrix.getDeterminant();
-        if (std::abs(massMatrixDeterminant) > MACHINE_EPSILON) {
+        if (mSolverBodies.bodyTypes[solverIndexBody1] == BodyType::DYNAMIC ||
+            mSolverBodies.bodyTypes[solverIndexBody2] == BodyType::DYNAMIC) {
+            mFixedJointComponents.mInverseMassMatrixTranslation[jointComponentIndex] = massMatrix.getInverse(massMatrixDeterminant);
+        }
 
-            if (mRigidBodyComponents.mBodyTypes[componentIndexBody1] == BodyType::DYNAMIC ||
-                mRigidBodyComponents.mBodyTypes[componentIndexBody2] == BodyType::DYNAMIC) {
-                mFixedJointComponents.mInverseMassMatrixTranslation[i] = massMatrix.getInverse(massMatrixDeterminant);
-            }
+        Vector3& x1 = mSolverBodies.positions[solverIndexBody1];
+        Vector3& x2 = mSolverBodies.positions[solverIndexBody2];
+        // Compute position error for the 3 translation constraints
+        const Vector3 errorTranslation = x2 + r2World - x1 - r1World;
+
+        // Compute the Lagrange multiplier lambda
+        const Vector3 lambdaTranslation = mFixedJointComponents.mInverseMassMatrixTranslation[jointComponentIndex] * (-errorTranslation);
 
-            Vector3& x1 = mRigidBodyComponents.mConstrainedPositions[componentIndexBody1];
-            Vector3& x2 = mRigidBodyComponents.mConstrainedPositions[componentIndexBody2];
-            // Compute position error for the 3 translation constraints
-            const Vector3 errorTranslation = x2 + r2World - x1 - r1World;
+        // Compute the impulse of body 1
+        Vector3 linearImpulseBody1 = -lambdaTranslation;
+        Vector3 angularImpulseBody1 = lambdaTranslation.cross(r1World);
 
-            // Compute the Lagrange multiplier lambda
-            const Vector3 lambdaTranslation = mFixedJointComponents.mInverseMassMatrixTranslation[i] * (-errorTranslation);
+        // Compute the pseudo velocity of body 1
+        const Vector3 v1 = inverseMassBody1 * mSolverBodies.linearLockAxisFactors[solverIndexBody1] * linearImpulseBody1;
+        Vector3 w1 = mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mFixedJointComponents.mI1[jointComponentIndex] * angularImpulseBody1);
 
-            // Compute the impulse of body 1
-            Vector3 linearImpulseBody1 = -lambdaTranslation;
-            Vector3 angularImpulseBody1 = lambdaTranslation.cross(r1World);
+        // Update the body position/orientation of body 1
+        x1 += v1;
+        q1 += Quaternion(0, w1) * q1 * decimal(0.5);
+        q1.normalize();
 
-            // Compute the pseudo velocity of body 1
-            const Vector3 v1 = inverseMassBody1 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody1] * linearImpulseBody1;
-            Vector3 w1 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mFixedJointComponents.mI1[i] * angularImpulseBody1);
+        // Compute the impulse of body 2
+        Vector3 angularImpulseBody2 = -lambdaTranslation.cross(r2World);
 
-            // Update the body position/orientation of body 1
-            x1 += v1;
-            q1 += Quaternion(0, w1) * q1 * decimal(0.5);
-            q1.normalize();
+        // Compute the pseudo velocity of body 2
+        const Vector3 v2 = inverseMassBody2 * mSolverBodies.linearLockAxisFactors[solverIndexBody2] * lambdaTranslation;
+        Vector3 w2 = mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mFixedJointComponents.mI2[jointComponentIndex] * angularImpulseBody2);
 
-            // Compute the impulse of body 2
-            Vector3 angularImpulseBody2 = -lambdaTranslation.cross(r2World);
+        // Update the body position/orientation of body 2
+        x2 += v2;
+        q2 += Quaternion(0, w2) * q2 * decimal(0.5);
+        q2.normalize();
+    }
+
+    // --------------- Rotation Constraints --------------- //
 
-            // Compute the pseudo velocity of body 2
-            const Vector3 v2 = inverseMassBody2 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody2] * lambdaTranslation;
-            Vector3 w2 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mFixedJointComponents.mI2[i] * angularImpulseBody2);
+    // Compute the inverse of the mass matrix K=JM^-1J^t for the 3 rotation
+    // contraints (3x3 matrix)
+    mFixedJointComponents.mInverseMassMatrixRotation[jointComponentIndex] = mFixedJointComponents.mI1[jointComponentIndex] + mFixedJointComponents.mI2[jointComponentIndex];
+    decimal massMatrixRotationDeterminant = mFixedJointComponents.mInverseMassMatrixRotation[jointComponentIndex].getDeterminant();
+    if (std::abs(massMatrixRotationDeterminant) > MACHINE_EPSILON) {
 
-            // Update the body position/orientation of body 2
-            x2 += v2;
-            q2 += Quaternion(0, w2) * q2 * decimal(0.5);
-            q2.normalize();
+        if (mSolverBodies.bodyTypes[solverIndexBody1] == BodyType::DYNAMIC ||
+            mSolverBodies.bodyTypes[solverIndexBody2] == BodyType::DYNAMIC) {
+            mFixedJointComponents.mInverseMassMatrixRotation[jointComponentIndex] = mFixedJointComponents.mInverseMassMatrixRotation[jointComponentIndex].getInverse(massMatrixRotationDeterminant);
         }
 
-        // --------------- Rotation Constraints --------------- //
+        // Calculate difference in rotation
+        //
+        // The rotation should be:
+        //
+        // q2 = q1 r0
+        //
+        // But because of drift the actual rotation is:
+        //
+        // q2 = qError q1 r0
+        // <=> qError = q2 r0^-1 q1^-1
+        //
+        // Where:
+        // q1 = current rotation of body 1
+        // q2 = current rotation of body 2
+        // qError = error that needs to be reduced to zero
+        Quaternion qError = q2 * mFixedJointComponents.mInitOrientationDifferenceInv[jointComponentIndex] * q1.getInverse();
+
+        // A quaternion can be seen as:
+        //
+        // q = [sin(theta / 2) * v, cos(theta/2)]
+        //
+        // Where:
+        // v = rotation vector
+        // theta = rotation angle
+        //
+        // If we assume theta is small (error is small) then sin(x) = x so an approximation of the error angles is:
+        const Vector3 errorRotation = decimal(2.0) * qError.getVectorV();
 
-        // Compute the inverse of the mass matrix K=JM^-1J^t for the 3 rotation
-        // contraints (3x3 matrix)
-        mFixedJointComponents.mInverseMassMatrixRotation[i] = mFixedJointComponents.mI1[i] + mFixedJointComponents.mI2[i];
-        decimal massMatrixRotationDeterminant = mFixedJointComponents.mInverseMassMatrixRotation[i].getDeterminant();
-        if (std::abs(massMatrixRotationDeterminant) > MACHINE_EPSILON) {
+        // Compute the Lagrange multiplier lambda for the 3 rotation constraints
+        Vector3 lambdaRotation = mFixedJointComponents.mInverseMassMatrixRotation[jointComponentIndex] * (-errorRotation);
 
-            if (mRigidBodyComponents.mBodyTypes[componentIndexBody1] == BodyType::DYNAMIC ||
-                mRigidBodyComponents.mBodyTypes[componentIndexBody2] == BodyType::DYNAMIC) {
-                mFixedJointComponents.mInverseMassMatrixRotation[i] = mFixedJointComponents.mInverseMassMatrixRotation[i].getInverse(massMatrixRotationDeterminant);
-            }
+        // Compute the impulse P=J^T * lambda for the 3 rotation constraints of body 1
+        Vector3 angularImpulseBody1 = -lambdaRotation;
 
-            // Calculate difference in rotation
-            //
-            // The rotation should be:
-            //
-            // q2 = q1 r0
-            //
-            // But because of drift the actual rotation is:
-            //
-            // q2 = qError q1 r0
-            // <=> qError = q2 r0^-1 q1^-1
-            //
-            // Where:
-            // q1 = current rotation of body 1
-            // q2 = current rotation of body 2
-            // qError = error that needs to be reduced to zero
-            Quaternion qError = q2 * mFixedJointComponents.mInitOrientationDifferenceInv[i] * q1.getInverse();
-
-            // A quaternion can be seen as:
-            //
-            // q = [sin(theta / 2) * v, cos(theta/2)]
-            //
-            // Where:
-            // v = rotation vector
-            // theta = rotation angle
-            //
-            // If we assume theta is small (error is small) then sin(x) = x so an approximation of the error angles is:
-            const Vector3 errorRotation = decimal(2.0) * qError.getVectorV();
-
-            // Compute the Lagrange multiplier lambda for the 3 rotation constraints
-            Vector3 lambdaRotation = mFixedJointComponents.mInverseMassMatrixRotation[i] * (-errorRotation);
-
-            // Compute the impulse P=J^T * lambda for the 3 rotation constraints of body 1
-            Vector3 angularImpulseBody1 = -lambdaRotation;
-
-            // Compute the pseudo velocity of body 1
-            Vector3 w1 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mFixedJointComponents.mI1[i] * angularImpulseBody1);
-
-            // Update the body position/orientation of body 1
-            q1 += Quaternion(0, w1) * q1 * decimal(0.5);
-            q1.normalize();
-
-            // Compute the pseudo velocity of body 2
-            Vector3 w2 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mFixedJointComponents.mI2[i] * lambdaRotation);
-
-            // Update the body position/orientation of body 2
-            q2 += Quaternion(0, w2) * q2 * decimal(0.5);
-            q2.normalize();
-        }
+        // Compute the pseudo velocity of body 1
+        Vector3 w1 = mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mFixedJointComponents.mI1[jointComponentIndex] * angularImpulseBody1);
+
+        // Update the body position/orientation of body 1
+        q1 += Quaternion(0, w1) * q1 * decimal(0.5);
+        q1.normalize();
+
+        // Compute the pseudo velocity of body 2
+        Vector3 w2 = mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mFixedJointComponents.mI2[jointComponentIndex] * lambdaRotation);
+
+        // Update the body position/orientation of body 2
+        q2 += Quaternion(0, w2) * q2 * decimal(0.5);
+        q2.normalize();
     }
 }
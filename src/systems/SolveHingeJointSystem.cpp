@@ -34,13 +34,15 @@ using namespace reactphysics3d;
 const decimal SolveHingeJointSystem::BETA = decimal(0.2);
 
 // Constructor
-SolveHingeJointSystem::SolveHingeJointSystem(PhysicsWorld& world, RigidBodyComponents& rigidBodyComponents,
+SolveHingeJointSystem::SolveHingeJointSystem(PhysicsWorld& world, MemoryAllocator& allocator, SolverBodies& solverBodies,
+                                                             RigidBodyComponents& rigidBodyComponents,
                                                              TransformComponents& transformComponents,
                                                              JointComponents& jointComponents,
                                                              HingeJointComponents& hingeJointComponents)
-              :mWorld(world), mRigidBodyComponents(rigidBodyComponents), mTransformComponents(transformComponents),
+              :mWorld(world), mSolverBodies(solverBodies), mRigidBodyComponents(rigidBodyComponents), mTransformComponents(transformComponents),
                mJointComponents(jointComponents), mHingeJointComponents(hingeJointComponents),
-               mTimeStep(0), mIsWarmStartingActive(true) {
+               mTimeStep(0), mIsWarmStartingActive(true), mSolverBody1Indices(allocator),
+               mSolverBody2Indices(allocator), mPositionCorrectionTechniques(allocator) {
 
 }
 
@@ -49,6 +51,10 @@ void SolveHingeJointSystem::initBeforeSolve() {
 
     const decimal biasFactor = (BETA / mTimeStep);
 
+    mSolverBody1Indices.clear();
+    mSolverBody2Indices.clear();
+    mPositionCorrectionTechniques.clear();
+
     // For each joint
     const uint32 nbJoints = mHingeJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbJoints; i++) {
@@ -66,6 +72,11 @@ void SolveHingeJointSystem::initBeforeSolve() {
         assert(!mRigidBodyComponents.getIsEntityDisabled(body1Entity));
         assert(!mRigidBodyComponents.getIsEntityDisabled(body2Entity));
 
+        // Store the solver bodies and the position correction technique used by the solver iterations
+        mSolverBody1Indices.add(mSolverBodies.jointsBody1Indices[jointIndex]);
+        mSolverBody2Indices.add(mSolverBodies.jointsBody2Indices[jointIndex]);
+        mPositionCorrectionTechniques.add(mJointComponents.mPositionCorrectionTechniques[jointIndex]);
+
         // Get the inertia tensor of bodies
         mHingeJointComponents.mI1[i] = mRigidBodyComponents.mInverseInertiaTensorsWorld[componentIndexBody1];
         mHingeJointComponents.mI2[i] = mRigidBodyComponents.mInverseInertiaTensorsWorld[componentIndexBody2];
@@ -164,7 +175,7 @@ void SolveHingeJointSystem::initBeforeSolve() {
         }
 
         // Compute the current angle around the hinge axis
-        decimal hingeAngle = computeCurrentHingeAngle(jointEntity, orientationBody1, orientationBody2);
+        decimal hingeAngle = computeCurrentHingeAngle(i, orientationBody1, orientationBody2);
 
         // Check if the limit constraints are violated or not
         decimal lowerLimitError = hingeAngle - mHingeJointComponents.mLowerLimit[i];
@@ -220,25 +231,19 @@ void SolveHingeJointSystem::warmstart() {
     const uint32 nbJoints = mHingeJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbJoints; i++) {
 
-        const Entity jointEntity = mHingeJointComponents.mJointEntities[i];
-        const uint32 jointIndex = mJointComponents.getEntityIndex(jointEntity);
-
-        // Get the bodies entities
-        const Entity body1Entity = mJointComponents.mBody1Entities[jointIndex];
-        const Entity body2Entity = mJointComponents.mBody2Entities[jointIndex];
-
-        const uint32 componentIndexBody1 = mRigidBodyComponents.getEntityIndex(body1Entity);
-        const uint32 componentIndexBody2 = mRigidBodyComponents.getEntityIndex(body2Entity);
+        // Get the solver bodies of the joint
+        const uint32 solverIndexBody1 = mSolverBody1Indices[i];
+        const uint32 solverIndexBody2 = mSolverBody2Indices[i];
 
         // Get the velocities
-        Vector3& v1 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody1];
-        Vector3& v2 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody2];
-        Vector3& w1 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody1];
-        Vector3& w2 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody2];
+        Vector3& v1 = mSolverBodies.linearVelocities[solverIndexBody1];
+        Vector3& v2 = mSolverBodies.linearVelocities[solverIndexBody2];
+        Vector3& w1 = mSolverBodies.angularVelocities[solverIndexBody1];
+        Vector3& w2 = mSolverBodies.angularVelocities[solverIndexBody2];
 
         // Get the inverse mass and inverse inertia tensors of the bodies
-        const decimal inverseMassBody1 = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-        const decimal inverseMassBody2 = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
+        const decimal inverseMassBody1 = mSolverBodies.inverseMasses[solverIndexBody1];
+        const decimal inverseMassBody2 = mSolverBodies.inverseMasses[solverIndexBody2];
 
         const Vector3& impulseTranslation = mHingeJointComponents.mImpulseTranslation[i];
         const Vector2& impulseRotation = mHingeJointComponents.mImpulseRotation[i];
@@ -272,8 +277,8 @@ void SolveHingeJointSystem::warmstart() {
         angularImpulseBody1 += motorImpulse;
 
         // Apply the impulse to the body 1
-        v1 += inverseMassBody1 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody1] * linearImpulseBody1;
-        w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mHingeJointComponents.mI1[i] * angularImpulseBody1);
+        v1 += inverseMassBody1 * mSolverBodies.linearLockAxisFactors[solverIndexBody1] * linearImpulseBody1;
+        w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mHingeJointComponents.mI1[i] * angularImpulseBody1);
 
         // Compute the impulse P=J^T * lambda for the 3 translation constraints of body 2
         Vector3 angularImpulseBody2 = -impulseTranslation.cross(mHingeJointComponents.mR2World[i]);
@@ -288,8 +293,8 @@ void SolveHingeJointSystem::warmstart() {
         angularImpulseBody2 += -motorImpulse;
 
         // Apply the impulse to the body 2
-        v2 += inverseMassBody2 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody2] * impulseTranslation;
-        w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mHingeJointComponents.mI2[i] * angularImpulseBody2);
+        v2 += inverseMassBody2 * mSolverBodies.linearLockAxisFactors[solverIndexBody2] * impulseTranslation;
+        w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mHingeJointComponents.mI2[i] * angularImpulseBody2);
     }
 }
 
@@ -299,171 +304,170 @@ void SolveHingeJointSystem::solveVelocityConstraint() {
     // For each joint component
     const uint32 nbJoints = mHingeJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbJoints; i++) {
+        solveVelocityConstraint(i);
+    }
+}
 
-        const Entity jointEntity = mHingeJointComponents.mJointEntities[i];
-        const uint32 jointIndex = mJointComponents.getEntityIndex(jointEntity);
+// Solve the velocity constraint of a single joint
+void SolveHingeJointSystem::solveVelocityConstraint(uint32 jointComponentIndex) {
 
-        // Get the bodies entities
-        const Entity body1Entity = mJointComponents.mBody1Entities[jointIndex];
-        const Entity body2Entity = mJointComponents.mBody2Entities[jointIndex];
-
-        const uint32 componentIndexBody1 = mRigidBodyComponents.getEntityIndex(body1Entity);
-        const uint32 componentIndexBody2 = mRigidBodyComponents.getEntityIndex(body2Entity);
+    // Get the solver bodies of the joint
+    const uint32 solverIndexBody1 = mSolverBody1Indices[jointComponentIndex];
+    const uint32 solverIndexBody2 = mSolverBody2Indices[jointComponentIndex];
 
-        // Get the velocities
-        Vector3& v1 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody1];
-        Vector3& v2 = mRigidBodyComponents.mConstrainedLinearVelocities[componentIndexBody2];
-        Vector3& w1 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody1];
-        Vector3& w2 = mRigidBodyComponents.mConstrainedAngularVelocities[componentIndexBody2];
+    // Get the velocities
+    Vector3& v1 = mSolverBodies.linearVelocities[solverIndexBody1];
+    Vector3& v2 = mSolverBodies.linearVelocities[solverIndexBody2];
+    Vector3& w1 = mSolverBodies.angularVelocities[solverIndexBody1];
+    Vector3& w2 = mSolverBodies.angularVelocities[solverIndexBody2];
 
-        // Get the inverse mass and inverse inertia tensors of the bodies
-        decimal inverseMassBody1 = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-        decimal inverseMassBody2 = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
+    // Get the inverse mass and inverse inertia tensors of the bodies
+    decimal inverseMassBody1 = mSolverBodies.inverseMasses[solverIndexBody1];
+    decimal inverseMassBody2 = mSolverBodies.inverseMasses[solverIndexBody2];
 
-        const Matrix3x3& i1 = mHingeJointComponents.mI1[i];
-        const Matrix3x3& i2 = mHingeJointComponents.mI2[i];
+    const Matrix3x3& i1 = mHingeJointComponents.mI1[jointComponentIndex];
+    const Matrix3x3& i2 = mHingeJointComponents.mI2[jointComponentIndex];
 
-        const Vector3& r1World = mHingeJointComponents.mR1World[i];
-        const Vector3& r2World = mHingeJointComponents.mR2World[i];
+    const Vector3& r1World = mHingeJointComponents.mR1World[jointComponentIndex];
+    const Vector3& r2World = mHingeJointComponents.mR2World[jointComponentIndex];
 
-        const Vector3& a1 = mHingeJointComponents.mA1[i];
+    const Vector3& a1 = mHingeJointComponents.mA1[jointComponentIndex];
 
-        const decimal inverseMassMatrixLimitMotor = mHingeJointComponents.mInverseMassMatrixLimitMotor[i];
+    const decimal inverseMassMatrixLimitMotor = mHingeJointComponents.mInverseMassMatrixLimitMotor[jointComponentIndex];
 
-        // --------------- Limits Constraints --------------- //
+    // --------------- Limits Constraints --------------- //
 
-        if (mHingeJointComponents.mIsLimitEnabled[i]) {
+    if (mHingeJointComponents.mIsLimitEnabled[jointComponentIndex]) {
 
-            // If the lower limit is violated
-            if (mHingeJointComponents.mIsLowerLimitViolated[i]) {
+        // If the lower limit is violated
+        if (mHingeJointComponents.mIsLowerLimitViolated[jointComponentIndex]) {
 
-                // Compute J*v for the lower limit constraint
-                const decimal JvLowerLimit = (w2 - w1).dot(a1);
+            // Compute J*v for the lower limit constraint
+            const decimal JvLowerLimit = (w2 - w1).dot(a1);
 
-                // Compute the Lagrange multiplier lambda for the lower limit constraint
-                decimal deltaLambdaLower = inverseMassMatrixLimitMotor * (-JvLowerLimit -mHingeJointComponents.mBLowerLimit[i]);
-                decimal lambdaTemp = mHingeJointComponents.mImpulseLowerLimit[i];
-                mHingeJointComponents.mImpulseLowerLimit[i] = std::max(mHingeJointComponents.mImpulseLowerLimit[i] + deltaLambdaLower, decimal(0.0));
-                deltaLambdaLower = mHingeJointComponents.mImpulseLowerLimit[i] - lambdaTemp;
+            // Compute the Lagrange multiplier lambda for the lower limit constraint
+            decimal deltaLambdaLower = inverseMassMatrixLimitMotor * (-JvLowerLimit -mHingeJointComponents.mBLowerLimit[jointComponentIndex]);
+            decimal lambdaTemp = mHingeJointComponents.mImpulseLowerLimit[jointComponentIndex];
+            mHingeJointComponents.mImpulseLowerLimit[jointComponentIndex] = std::max(mHingeJointComponents.mImpulseLowerLimit[jointComponentIndex] + deltaLambdaLower, decimal(0.0));
+            deltaLambdaLower = mHingeJointComponents.mImpulseLowerLimit[jointComponentIndex] - lambdaTemp;
 
-                // Compute the impulse P=J^T * lambda for the lower limit constraint of body 1
-                const Vector3 angularImpulseBody1 = -deltaLambdaLower * a1;
+            // Compute the impulse P=J^T * lambda for the lower limit constraint of body 1
+            const Vector3 angularImpulseBody1 = -deltaLambdaLower * a1;
 
-                // Apply the impulse to the body 1
-                w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+            // Apply the impulse to the body 1
+            w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-                // Compute the impulse P=J^T * lambda for the lower limit constraint of body 2
-                const Vector3 angularImpulseBody2 = deltaLambdaLower * a1;
+            // Compute the impulse P=J^T * lambda for the lower limit constraint of body 2
+            const Vector3 angularImpulseBody2 = deltaLambdaLower * a1;
 
-                // Apply the impulse to the body 2
-                w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
-            }
+            // Apply the impulse to the body 2
+            w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
+        }
 
-            // If the upper limit is violated
-            if (mHingeJointComponents.mIsUpperLimitViolated[i]) {
+        // If the upper limit is violated
+        if (mHingeJointComponents.mIsUpperLimitViolated[jointComponentIndex]) {
 
-                // Compute J*v for the upper limit constraint
-                const decimal JvUpperLimit = -(w2 - w1).dot(a1);
+            // Compute J*v for the upper limit constraint
+            const decimal JvUpperLimit = -(w2 - w1).dot(a1);
 
-                // Compute the Lagrange multiplier lambda for the upper limit constraint
-                decimal deltaLambdaUpper = inverseMassMatrixLimitMotor * (-JvUpperLimit -mHingeJointComponents.mBUpperLimit[i]);
-                decimal lambdaTemp = mHingeJointComponents.mImpulseUpperLimit[i];
-                mHingeJointComponents.mImpulseUpperLimit[i] = std::max(mHingeJointComponents.mImpulseUpperLimit[i] + deltaLambdaUpper, decimal(0.0));
-                deltaLambdaUpper = mHingeJointComponents.mImpulseUpperLimit[i] - lambdaTemp;
+            // Compute the Lagrange multiplier lambda for the upper limit constraint
+            decimal deltaLambdaUpper = inverseMassMatrixLimitMotor * (-JvUpperLimit -mHingeJointComponents.mBUpperLimit[jointComponentIndex]);
+            decimal lambdaTemp = mHingeJointComponents.mImpulseUpperLimit[jointComponentIndex];
+            mHingeJointComponents.mImpulseUpperLimit[jointComponentIndex] = std::max(mHingeJointComponents.mImpulseUpperLimit[jointComponentIndex] + deltaLambdaUpper, decimal(0.0));
+            deltaLambdaUpper = mHingeJointComponents.mImpulseUpperLimit[jointComponentIndex] - lambdaTemp;
 
-                // Compute the impulse P=J^T * lambda for the upper limit constraint of body 1
-                const Vector3 angularImpulseBody1 = deltaLambdaUpper * a1;
+            // Compute the impulse P=J^T * lambda for the upper limit constraint of body 1
+            const Vector3 angularImpulseBody1 = deltaLambdaUpper * a1;
 
-                // Apply the impulse to the body 1
-                w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+            // Apply the impulse to the body 1
+            w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-                // Compute the impulse P=J^T * lambda for the upper limit constraint of body 2
-                const Vector3 angularImpulseBody2 = -deltaLambdaUpper * a1;
+            // Compute the impulse P=J^T * lambda for the upper limit constraint of body 2
+            const Vector3 angularImpulseBody2 = -deltaLambdaUpper * a1;
 
-                // Apply the impulse to the body 2
-                w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
-            }
+            // Apply the impulse to the body 2
+            w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
         }
+    }
 
-        // --------------- Motor --------------- //
+    // --------------- Motor --------------- //
 
-        // If the motor is enabled
-        if (mHingeJointComponents.mIsMotorEnabled[i]) {
+    // If the motor is enabled
+    if (mHingeJointComponents.mIsMotorEnabled[jointComponentIndex]) {
 
-            // Compute J*v for the motor
-            const decimal JvMotor = a1.dot(w1 - w2);
+        // Compute J*v for the motor
+        const decimal JvMotor = a1.dot(w1 - w2);
 
-            // Compute the Lagrange multiplier lambda for the motor
-            const decimal maxMotorImpulse = mHingeJointComponents.mMaxMotorTorque[i] * mTimeStep;
-            decimal deltaLambdaMotor = mHingeJointComponents.mInverseMassMatrixLimitMotor[i] * (-JvMotor - mHingeJointComponents.mMotorSpeed[i]);
-            decimal lambdaTemp = mHingeJointComponents.mImpulseMotor[i];
-            mHingeJointComponents.mImpulseMotor[i] = clamp(mHingeJointComponents.mImpulseMotor[i] + deltaLambdaMotor, -maxMotorImpulse, maxMotorImpulse);
-            deltaLambdaMotor = mHingeJointComponents.mImpulseMotor[i] - lambdaTemp;
+        // Compute the Lagrange multiplier lambda for the motor
+        const decimal maxMotorImpulse = mHingeJointComponents.mMaxMotorTorque[jointComponentIndex] * mTimeStep;
+        decimal deltaLambdaMotor = mHingeJointComponents.mInverseMassMatrixLimitMotor[jointComponentIndex] * (-JvMotor - mHingeJointComponents.mMotorSpeed[jointComponentIndex]);
+        decimal lambdaTemp = mHingeJointComponents.mImpulseMotor[jointComponentIndex];
+        mHingeJointComponents.mImpulseMotor[jointComponentIndex] = clamp(mHingeJointComponents.mImpulseMotor[jointComponentIndex] + deltaLambdaMotor, -maxMotorImpulse, maxMotorImpulse);
+        deltaLambdaMotor = mHingeJointComponents.mImpulseMotor[jointComponentIndex] - lambdaTemp;
 
-            // Compute the impulse P=J^T * lambda for the motor of body 1
-            const Vector3 angularImpulseBody1 = -deltaLambdaMotor * a1;
+        // Compute the impulse P=J^T * lambda for the motor of body 1
+        const Vector3 angularImpulseBody1 = -deltaLambdaMotor * a1;
 
-            // Apply the impulse to the body 1
-            w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+        // Apply the impulse to the body 1
+        w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-            // Compute the impulse P=J^T * lambda for the motor of body 2
-            const Vector3 angularImpulseBody2 = deltaLambdaMotor * a1;
+        // Compute the impulse P=J^T * lambda for the motor of body 2
+        const Vector3 angularImpulseBody2 = deltaLambdaMotor * a1;
 
-            // Apply the impulse to the body 2
-            w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
-        }
+        // Apply the impulse to the body 2
+        w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
+    }
 
-        // --------------- Joint Rotation Constraints --------------- //
+    // --------------- Joint Rotation Constraints --------------- //
 
-        const Vector3& b2CrossA1 = mHingeJointComponents.mB2CrossA1[i];
-        const Vector3& c2CrossA1 = mHingeJointComponents.mC2CrossA1[i];
+    const Vector3& b2CrossA1 = mHingeJointComponents.mB2CrossA1[jointComponentIndex];
+    const Vector3& c2CrossA1 = mHingeJointComponents.mC2CrossA1[jointComponentIndex];
 
-        // Compute J*v for the 2 rotation constraints
-        const Vector2 JvRotation(-b2CrossA1.dot(w1) + b2CrossA1.dot(w2),
-                                 -c2CrossA1.dot(w1) + c2CrossA1.dot(w2));
+    // Compute J*v for the 2 rotation constraints
+    const Vector2 JvRotation(-b2CrossA1.dot(w1) + b2CrossA1.dot(w2),
+                             -c2CrossA1.dot(w1) + c2CrossA1.dot(w2));
 
-        // Compute the Lagrange multiplier lambda for the 2 rotation constraints
-        Vector2 deltaLambdaRotation = mHingeJointComponents.mInverseMassMatrixRotation[i] *
-                                      (-JvRotation - mHingeJointComponents.mBiasRotation[i]);
-        mHingeJointComponents.mImpulseRotation[i] += deltaLambdaRotation;
+    // Compute the Lagrange multiplier lambda for the 2 rotation constraints
+    Vector2 deltaLambdaRotation = mHingeJointComponents.mInverseMassMatrixRotation[jointComponentIndex] *
+                                  (-JvRotation - mHingeJointComponents.mBiasRotation[jointComponentIndex]);
+    mHingeJointComponents.mImpulseRotation[jointComponentIndex] += deltaLambdaRotation;
 
-        // Compute the impulse P=J^T * lambda for the 2 rotation constraints of body 1
-        Vector3 angularImpulseBody1 = -b2CrossA1 * deltaLambdaRotation.x - c2CrossA1 * deltaLambdaRotation.y;
+    // Compute the impulse P=J^T * lambda for the 2 rotation constraints of body 1
+    Vector3 angularImpulseBody1 = -b2CrossA1 * deltaLambdaRotation.x - c2CrossA1 * deltaLambdaRotation.y;
 
-        // Apply the impulse to the body 1
-        w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+    // Apply the impulse to the body 1
+    w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-        // Compute the impulse P=J^T * lambda for the 2 rotation constraints of body 2
-        Vector3 angularImpulseBody2 = b2CrossA1 * deltaLambdaRotation.x + c2CrossA1 * deltaLambdaRotation.y;
+    // Compute the impulse P=J^T * lambda for the 2 rotation constraints of body 2
+    Vector3 angularImpulseBody2 = b2CrossA1 * deltaLambdaRotation.x + c2CrossA1 * deltaLambdaRotation.y;
 
-        // Apply the impulse to the body 2
-        w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
+    // Apply the impulse to the body 2
+    w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
 
-        // --------------- Joint Translation Constraints --------------- //
+    // --------------- Joint Translation Constraints --------------- //
 
-        // Compute J*v
-        const Vector3 JvTranslation = v2 + w2.cross(r2World) - v1 - w1.cross(r1World);
+    // Compute J*v
+    const Vector3 JvTranslation = v2 + w2.cross(r2World) - v1 - w1.cross(r1World);
 
-        // Compute the Lagrange multiplier lambda
-        const Vector3 deltaLambdaTranslation = mHingeJointComponents.mInverseMassMatrixTranslation[i] *
-                                               (-JvTranslation - mHingeJointComponents.mBiasTranslation[i]);
-        mHingeJointComponents.mImpulseTranslation[i] += deltaLambdaTranslation;
+    // Compute the Lagrange multiplier lambda
+    const Vector3 deltaLambdaTranslation = mHingeJointComponents.mInverseMassMatrixTranslation[jointComponentIndex] *
+                                           (-JvTranslation - mHingeJointComponents.mBiasTranslation[jointComponentIndex]);
+    mHingeJointComponents.mImpulseTranslation[jointComponentIndex] += deltaLambdaTranslation;
 
-        // Compute the impulse P=J^T * lambda of body 1
-        const Vector3 linearImpulseBody1 = -deltaLambdaTranslation;
-        angularImpulseBody1 = deltaLambdaTranslation.cross(r1World);
+    // Compute the impulse P=J^T * lambda of body 1
+    const Vector3 linearImpulseBody1 = -deltaLambdaTranslation;
+    angularImpulseBody1 = deltaLambdaTranslation.cross(r1World);
 
-        // Apply the impulse to the body 1
-        v1 += inverseMassBody1 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody1] * linearImpulseBody1;
-        w1 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (i1 * angularImpulseBody1);
+    // Apply the impulse to the body 1
+    v1 += inverseMassBody1 * mSolverBodies.linearLockAxisFactors[solverIndexBody1] * linearImpulseBody1;
+    w1 += mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (i1 * angularImpulseBody1);
 
-        // Compute the impulse P=J^T * lambda of body 2
-        angularImpulseBody2 = -deltaLambdaTranslation.cross(r2World);
+    // Compute the impulse P=J^T * lambda of body 2
+    angularImpulseBody2 = -deltaLambdaTranslation.cross(r2World);
 
-        // Apply the impulse to the body 2
-        v2 += inverseMassBody2 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody2] * deltaLambdaTranslation;
-        w2 += mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (i2 * angularImpulseBody2);
-    }
+    // Apply the impulse to the body 2
+    v2 += inverseMassBody2 * mSolverBodies.linearLockAxisFactors[solverIndexBody2] * deltaLambdaTranslation;
+    w2 += mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (i2 * angularImpulseBody2);
 }
 
 // Solve the position constraint (for position error correction)
@@ -472,247 +476,246 @@ void SolveHingeJointSystem::solvePositionConstraint() {
     // For each joint component
     const uint32 nbEnabledJoints = mHingeJointComponents.getNbEnabledComponents();
     for (uint32 i=0; i < nbEnabledJoints; i++) {
+        solvePositionConstraint(i);
+    }
+}
 
-        const Entity jointEntity = mHingeJointComponents.mJointEntities[i];
-        const uint32 jointIndex = mJointComponents.getEntityIndex(jointEntity);
-
-        // If the error position correction technique is not the non-linear-gauss-seidel, we do not execute this method
-        if (mJointComponents.mPositionCorrectionTechniques[jointIndex] != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) continue;
-
-        // Get the bodies entities
-        Entity body1Entity = mJointComponents.mBody1Entities[jointIndex];
-        Entity body2Entity = mJointComponents.mBody2Entities[jointIndex];
-
-        const uint32 componentIndexBody1 = mRigidBodyComponents.getEntityIndex(body1Entity);
-        const uint32 componentIndexBody2 = mRigidBodyComponents.getEntityIndex(body2Entity);
-
-        Quaternion& q1 = mRigidBodyComponents.mConstrainedOrientations[componentIndexBody1];
-        Quaternion& q2 = mRigidBodyComponents.mConstrainedOrientations[componentIndexBody2];
-
-        // Recompute the world inverse inertia tensors
-        RigidBody::computeWorldInertiaTensorInverse(q1.getMatrix(), mRigidBodyComponents.mInverseInertiaTensorsLocal[componentIndexBody1],
-                                                    mHingeJointComponents.mI1[i]);
-
-        RigidBody::computeWorldInertiaTensorInverse(q2.getMatrix(), mRigidBodyComponents.mInverseInertiaTensorsLocal[componentIndexBody2],
-                                                    mHingeJointComponents.mI2[i]);
-
-        // Compute the vector from body center to the anchor point in world-space
-        mHingeJointComponents.mR1World[i] = q1 * (mHingeJointComponents.mLocalAnchorPointBody1[i] - mRigidBodyComponents.mCentersOfMassLocal[componentIndexBody1]);
-        mHingeJointComponents.mR2World[i] = q2 * (mHingeJointComponents.mLocalAnchorPointBody2[i] - mRigidBodyComponents.mCentersOfMassLocal[componentIndexBody2]);
-
-        // Compute the corresponding skew-symmetric matrices
-        Matrix3x3 skewSymmetricMatrixU1 = Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mHingeJointComponents.mR1World[i]);
-        Matrix3x3 skewSymmetricMatrixU2 = Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mHingeJointComponents.mR2World[i]);
-
+// Solve the position constraint (for position error correction) of a single joint
+void SolveHingeJointSystem::solvePositionConstraint(uint32 jointComponentIndex) {
 
-        Vector3& b2CrossA1 = mHingeJointComponents.mB2CrossA1[i];
-        Vector3& c2CrossA1 = mHingeJointComponents.mC2CrossA1[i];
+    // If the error position correction technique is not the non-linear-gauss-seidel, we do not execute this method
+    if (mPositionCorrectionTechniques[jointComponentIndex] != JointsPositionCorrectionTechnique::NON_LINEAR_GAUSS_SEIDEL) return;
 
-        Vector3& a1 = mHingeJointComponents.mA1[i];
+    // Get the solver bodies of the joint
+    const uint32 solverIndexBody1 = mSolverBody1Indices[jointComponentIndex];
+    const uint32 solverIndexBody2 = mSolverBody2Indices[jointComponentIndex];
 
-        // Compute vectors needed in the Jacobian
-        a1 = q1 * mHingeJointComponents.mHingeLocalAxisBody1[i];
-        Vector3 a2 = q2 * mHingeJointComponents.mHingeLocalAxisBody2[i];
-        a1.normalize();
-        mHingeJointComponents.mA1[i] = a1;
-        a2.normalize();
-        const Vector3 b2 = a2.getOneUnitOrthogonalVector();
-        const Vector3 c2 = a2.cross(b2);
-        b2CrossA1 = b2.cross(a1);
-        mHingeJointComponents.mB2CrossA1[i] = b2CrossA1;
-        c2CrossA1 = c2.cross(a1);
-        mHingeJointComponents.mC2CrossA1[i] = c2CrossA1;
+    Quaternion& q1 = mSolverBodies.orientations[solverIndexBody1];
+    Quaternion& q2 = mSolverBodies.orientations[solverIndexBody2];
 
-        // Compute the current angle around the hinge axis
-        const decimal hingeAngle = computeCurrentHingeAngle(jointEntity, q1, q2);
+    // Recompute the world inverse inertia tensors
+    RigidBody::computeWorldInertiaTensorInverse(q1.getMatrix(), mSolverBodies.inverseInertiaTensorsLocal[solverIndexBody1],
+                                                mHingeJointComponents.mI1[jointComponentIndex]);
 
-        // Check if the limit constraints are violated or not
-        decimal lowerLimitError = hingeAngle - mHingeJointComponents.mLowerLimit[i];
-        decimal upperLimitError = mHingeJointComponents.mUpperLimit[i] - hingeAngle;
-        mHingeJointComponents.mIsLowerLimitViolated[i] = lowerLimitError <= 0;
-        mHingeJointComponents.mIsUpperLimitViolated[i] = upperLimitError <= 0;
+    RigidBody::computeWorldInertiaTensorInverse(q2.getMatrix(), mSolverBodies.inverseInertiaTensorsLocal[solverIndexBody2],
+                                                mHingeJointComponents.mI2[jointComponentIndex]);
 
-        // --------------- Limits Constraints --------------- //
+    // Compute the vector from body center to the anchor point in world-space
+    mHingeJointComponents.mR1World[jointComponentIndex] = q1 * (mHingeJointComponents.mLocalAnchorPointBody1[jointComponentIndex] - mSolverBodies.centersOfMassLocal[solverIndexBody1]);
+    mHingeJointComponents.mR2World[jointComponentIndex] = q2 * (mHingeJointComponents.mLocalAnchorPointBody2[jointComponentIndex] - mSolverBodies.centersOfMassLocal[solverIndexBody2]);
 
-        if (mHingeJointComponents.mIsLimitEnabled[i]) {
+    // Compute the corresponding skew-symmetric matrices
+    Matrix3x3 skewSymmetricMatrixU1 = Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mHingeJointComponents.mR1World[jointComponentIndex]);
+    Matrix3x3 skewSymmetricMatrixU2 = Matrix3x3::computeSkewSymmetricMatrixForCrossProduct(mHingeJointComponents.mR2World[jointComponentIndex]);
 
-            decimal inverseMassMatrixLimitMotor = mHingeJointComponents.mInverseMassMatrixLimitMotor[i];
 
-            Vector3& a1 = mHingeJointComponents.mA1[i];
+    Vector3& b2CrossA1 = mHingeJointComponents.mB2CrossA1[jointComponentIndex];
+    Vector3& c2CrossA1 = mHingeJointComponents.mC2CrossA1[jointComponentIndex];
 
-            if (mHingeJointComponents.mIsLowerLimitViolated[i] || mHingeJointComponents.mIsUpperLimitViolated[i]) {
+    Vector3& a1 = mHingeJointComponents.mA1[jointComponentIndex];
 
-                // Compute the inverse of the mass matrix K=JM^-1J^t for the limits (1x1 matrix)
-                mHingeJointComponents.mInverseMassMatrixLimitMotor[i] = a1.dot(mHingeJointComponents.mI1[i] * a1) + a1.dot(mHingeJointComponents.mI2[i] * a1);
-                mHingeJointComponents.mInverseMassMatrixLimitMotor[i] = (inverseMassMatrixLimitMotor > decimal(0.0)) ?
-                                          decimal(1.0) / mHingeJointComponents.mInverseMassMatrixLimitMotor[i] : decimal(0.0);
-            }
+    // Compute vectors needed in the Jacobian
+    a1 = q1 * mHingeJointComponents.mHingeLocalAxisBody1[jointComponentIndex];
+    Vector3 a2 = q2 * mHingeJointComponents.mHingeLocalAxisBody2[jointComponentIndex];
+    a1.normalize();
+    mHingeJointComponents.mA1[jointComponentIndex] = a1;
+    a2.normalize();
+    const Vector3 b2 = a2.getOneUnitOrthogonalVector();
+    const Vector3 c2 = a2.cross(b2);
+    b2CrossA1 = b2.cross(a1);
+    mHingeJointComponents.mB2CrossA1[jointComponentIndex] = b2CrossA1;
+    c2CrossA1 = c2.cross(a1);
+    mHingeJointComponents.mC2CrossA1[jointComponentIndex] = c2CrossA1;
 
-            // If the lower limit is violated
-            if (mHingeJointComponents.mIsLowerLimitViolated[i]) {
+    // Compute the current angle around the hinge axis
+    const decimal hingeAngle = computeCurrentHingeAngle(jointComponentIndex, q1, q2);
 
-                // Compute the Lagrange multiplier lambda for the lower limit constraint
-                decimal lambdaLowerLimit = inverseMassMatrixLimitMotor * (-lowerLimitError );
+    // Check if the limit constraints are violated or not
+    decimal lowerLimitError = hingeAngle - mHingeJointComponents.mLowerLimit[jointComponentIndex];
+    decimal upperLimitError = mHingeJointComponents.mUpperLimit[jointComponentIndex] - hingeAngle;
+    mHingeJointComponents.mIsLowerLimitViolated[jointComponentIndex] = lowerLimitError <= 0;
+    mHingeJointComponents.mIsUpperLimitViolated[jointComponentIndex] = upperLimitError <= 0;
 
-                // Compute the impulse P=J^T * lambda of body 1
-                const Vector3 angularImpulseBody1 = -lambdaLowerLimit * a1;
+    // --------------- Limits Constraints --------------- //
 
-                // Compute the pseudo velocity of body 1
-                const Vector3 w1 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mHingeJointComponents.mI1[i] * angularImpulseBody1);
+    if (mHingeJointComponents.mIsLimitEnabled[jointComponentIndex]) {
 
-                // Update the body position/orientation of body 1
-                q1 += Quaternion(0, w1) * q1 * decimal(0.5);
-                q1.normalize();
+        decimal inverseMassMatrixLimitMotor = mHingeJointComponents.mInverseMassMatrixLimitMotor[jointComponentIndex];
 
-                // Compute the impulse P=J^T * lambda of body 2
-                const Vector3 angularImpulseBody2 = lambdaLowerLimit * a1;
+        Vector3& a1 = mHingeJointComponents.mA1[jointComponentIndex];
 
-                // Compute the pseudo velocity of body 2
-                const Vector3 w2 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mHingeJointComponents.mI2[i] * angularImpulseBody2);
+        if (mHingeJointComponents.mIsLowerLimitViolated[jointComponentIndex] || mHingeJointComponents.mIsUpperLimitViolated[jointComponentIndex]) {
 
-                // Update the body position/orientation of body 2
-                q2 += Quaternion(0, w2) * q2 * decimal(0.5);
-                q2.normalize();
-            }
+            // Compute the inverse of the mass matrix K=JM^-1J^t for the limits (1x1 matrix)
+            mHingeJointComponents.mInverseMassMatrixLimitMotor[jointComponentIndex] = a1.dot(mHingeJointComponents.mI1[jointComponentIndex] * a1) + a1.dot(mHingeJointComponents.mI2[jointComponentIndex] * a1);
+            mHingeJointComponents.mInverseMassMatrixLimitMotor[jointComponentIndex] = (inverseMassMatrixLimitMotor > decimal(0.0)) ?
+                                      decimal(1.0) / mHingeJointComponents.mInverseMassMatrixLimitMotor[jointComponentIndex] : decimal(0.0);
+        }
 
-            // If the upper limit is violated
-            if (mHingeJointComponents.mIsUpperLimitViolated[i]) {
+        // If the lower limit is violated
+        if (mHingeJointComponents.mIsLowerLimitViolated[jointComponentIndex]) {
 
-                // Compute the Lagrange multiplier lambda for the upper limit constraint
-                decimal lambdaUpperLimit = inverseMassMatrixLimitMotor * (-upperLimitError);
+            // Compute the Lagrange multiplier lambda for the lower limit constraint
+            decimal lambdaLowerLimit = inverseMassMatrixLimitMotor * (-lowerLimitError );
 
-                // Compute the impulse P=J^T * lambda of body 1
-                const Vector3 angularImpulseBody1 = lambdaUpperLimit * a1;
+            // Compute the impulse P=J^T * lambda of body 1
+            const Vector3 angularImpulseBody1 = -lambdaLowerLimit * a1;
 
-                // Compute the pseudo velocity of body 1
-                const Vector3 w1 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mHingeJointComponents.mI1[i] * angularImpulseBody1);
+            // Compute the pseudo velocity of body 1
+            const Vector3 w1 = mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mHingeJointComponents.mI1[jointComponentIndex] * angularImpulseBody1);
 
-                // Update the body position/orientation of body 1
-                q1 += Quaternion(0, w1) * q1 * decimal(0.5);
-                q1.normalize();
+            // Update the body position/orientation of body 1
+            q1 += Quaternion(0, w1) * q1 * decimal(0.5);
+            q1.normalize();
 
-                // Compute the impulse P=J^T * lambda of body 2
-                const Vector3 angularImpulseBody2 = -lambdaUpperLimit * a1;
+            // Compute the impulse P=J^T * lambda of body 2
+            const Vector3 angularImpulseBody2 = lambdaLowerLimit * a1;
 
-                // Compute the pseudo velocity of body 2
-                const Vector3 w2 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mHingeJointComponents.mI2[i] * angularImpulseBody2);
+            // Compute the pseudo velocity of body 2
+            const Vector3 w2 = mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mHingeJointComponents.mI2[jointComponentIndex] * angularImpulseBody2);
 
-                // Update the body position/orientation of body 2
-                q2 += Quaternion(0, w2) * q2 * decimal(0.5);
-                q2.normalize();
-            }
+            // Update the body position/orientation of body 2
+            q2 += Quaternion(0, w2) * q2 * decimal(0.5);
+            q2.normalize();
         }
 
-        // --------------- Rotation Constraints --------------- //
-
-        // Compute the inverse mass matrix K=JM^-1J^t for the 2 rotation constraints (2x2 matrix)
-        Vector3 I1B2CrossA1 = mHingeJointComponents.mI1[i] * b2CrossA1;
-        Vector3 I1C2CrossA1 = mHingeJointComponents.mI1[i] * c2CrossA1;
-        Vector3 I2B2CrossA1 = mHingeJointComponents.mI2[i] * b2CrossA1;
-        Vector3 I2C2CrossA1 = mHingeJointComponents.mI2[i] * c2CrossA1;
-        const decimal el11 = b2CrossA1.dot(I1B2CrossA1) +
-                             b2CrossA1.dot(I2B2CrossA1);
-        const decimal el12 = b2CrossA1.dot(I1C2CrossA1) +
-                             b2CrossA1.dot(I2C2CrossA1);
-        const decimal el21 = c2CrossA1.dot(I1B2CrossA1) +
-                             c2CrossA1.dot(I2B2CrossA1);
-        const decimal el22 = c2CrossA1.dot(I1C2CrossA1) +
-                             c2CrossA1.dot(I2C2CrossA1);
-        const Matrix2x2 matrixKRotation(el11, el12, el21, el22);
-        mHingeJointComponents.mInverseMassMatrixRotation[i].setToZero();
-        decimal matrixDeterminant = matrixKRotation.getDeterminant();
-        if (std::abs(matrixDeterminant) > MACHINE_EPSILON) {
-            if (mRigidBodyComponents.mBodyTypes[componentIndexBody1] == BodyType::DYNAMIC ||
-                mRigidBodyComponents.mBodyTypes[componentIndexBody2] == BodyType::DYNAMIC) {
-                mHingeJointComponents.mInverseMassMatrixRotation[i] = matrixKRotation.getInverse(matrixDeterminant);
-            }
-
-            // Compute the position error for the 3 rotation constraints
-            const Vector2 errorRotation = Vector2(a1.dot(b2), a1.dot(c2));
+        // If the upper limit is violated
+        if (mHingeJointComponents.mIsUpperLimitViolated[jointComponentIndex]) {
 
-            // Compute the Lagrange multiplier lambda for the 3 rotation constraints
-            Vector2 lambdaRotation = mHingeJointComponents.mInverseMassMatrixRotation[i] * (-errorRotation);
+            // Compute the Lagrange multiplier lambda for the upper limit constraint
+            decimal lambdaUpperLimit = inverseMassMatrixLimitMotor * (-upperLimitError);
 
-            // Compute the impulse P=J^T * lambda for the 3 rotation constraints of body 1
-            Vector3 angularImpulseBody1 = -b2CrossA1 * lambdaRotation.x - c2CrossA1 * lambdaRotation.y;
+            // Compute the impulse P=J^T * lambda of body 1
+            const Vector3 angularImpulseBody1 = lambdaUpperLimit * a1;
 
             // Compute the pseudo velocity of body 1
-            Vector3 w1 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mHingeJointComponents.mI1[i] * angularImpulseBody1);
+            const Vector3 w1 = mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mHingeJointComponents.mI1[jointComponentIndex] * angularImpulseBody1);
 
             // Update the body position/orientation of body 1
             q1 += Quaternion(0, w1) * q1 * decimal(0.5);
             q1.normalize();
 
-            // Compute the impulse of body 2
-            Vector3 angularImpulseBody2 = b2CrossA1 * lambdaRotation.x + c2CrossA1 * lambdaRotation.y;
+            // Compute the impulse P=J^T * lambda of body 2
+            const Vector3 angularImpulseBody2 = -lambdaUpperLimit * a1;
 
             // Compute the pseudo velocity of body 2
-            Vector3 w2 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mHingeJointComponents.mI2[i] * angularImpulseBody2);
+            const Vector3 w2 = mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mHingeJointComponents.mI2[jointComponentIndex] * angularImpulseBody2);
 
             // Update the body position/orientation of body 2
             q2 += Quaternion(0, w2) * q2 * decimal(0.5);
             q2.normalize();
         }
+    }
 
-        // --------------- Translation Constraints --------------- //
+    // --------------- Rotation Constraints --------------- //
+
+    // Compute the inverse mass matrix K=JM^-1J^t for the 2 rotation constraints (2x2 matrix)
+    Vector3 I1B2CrossA1 = mHingeJointComponents.mI1[jointComponentIndex] * b2CrossA1;
+    Vector3 I1C2CrossA1 = mHingeJointComponents.mI1[jointComponentIndex] * c2CrossA1;
+    Vector3 I2B2CrossA1 = mHingeJointComponents.mI2[jointComponentIndex] * b2CrossA1;
+    Vector3 I2C2CrossA1 = mHingeJointComponents.mI2[jointComponentIndex] * c2CrossA1;
+    const decimal el11 = b2CrossA1.dot(I1B2CrossA1) +
+                         b2CrossA1.dot(I2B2CrossA1);
+    const decimal el12 = b2CrossA1.dot(I1C2CrossA1) +
+                         b2CrossA1.dot(I2C2CrossA1);
+    const decimal el21 = c2CrossA1.dot(I1B2CrossA1) +
+                         c2CrossA1.dot(I2B2CrossA1);
+    const decimal el22 = c2CrossA1.dot(I1C2CrossA1) +
+                         c2CrossA1.dot(I2C2CrossA1);
+    const Matrix2x2 matrixKRotation(el11, el12, el21, el22);
+    mHingeJointComponents.mInverseMassMatrixRotation[jointComponentIndex].setToZero();
+    decimal matrixDeterminant = matrixKRotation.getDeterminant();
+    if (std::abs(matrixDeterminant) > MACHINE_EPSILON) {
+        if (mSolverBodies.bodyTypes[solverIndexBody1] == BodyType::DYNAMIC ||
+            mSolverBodies.bodyTypes[solverIndexBody2] == BodyType::DYNAMIC) {
+            mHingeJointComponents.mInverseMassMatrixRotation[jointComponentIndex] = matrixKRotation.getInverse(matrixDeterminant);
+        }
 
-        // Compute the matrix K=JM^-1J^t (3x3 matrix) for the 3 translation constraints
-        const decimal body1InverseMass = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-        const decimal body2InverseMass = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
-        decimal inverseMassBodies = body1InverseMass + body2InverseMass;
-        Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
-                                        0, inverseMassBodies, 0,
-                                        0, 0, inverseMassBodies) +
-                               skewSymmetricMatrixU1 * mHingeJointComponents.mI1[i] * skewSymmetricMatrixU1.getTranspose() +
-                               skewSymmetricMatrixU2 * mHingeJointComponents.mI2[i] * skewSymmetricMatrixU2.getTranspose();
-        mHingeJointComponents.mInverseMassMatrixTranslation[i].setToZero();
-        matrixDeterminant = massMatrix.getDeterminant();
-        if (std::abs(matrixDeterminant) > MACHINE_EPSILON) {
+        // Compute the position error for the 3 rotation constraints
+        const Vector2 errorRotation = Vector2(a1.dot(b2), a1.dot(c2));
 
-            if (mRigidBodyComponents.mBodyTypes[componentIndexBody1] == BodyType::DYNAMIC ||
-                mRigidBodyComponents.mBodyTypes[componentIndexBody2] == BodyType::DYNAMIC) {
-                mHingeJointComponents.mInverseMassMatrixTranslation[i] = massMatrix.getInverse(matrixDeterminant);
-            }
+        // Compute the Lagrange multiplier lambda for the 3 rotation constraints
+        Vector2 lambdaRotation = mHingeJointComponents.mInverseMassMatrixRotation[jointComponentIndex] * (-errorRotation);
 
+        // Compute the impulse P=J^T * lambda for the 3 rotation constraints of body 1
+        Vector3 angularImpulseBody1 = -b2CrossA1 * lambdaRotation.x - c2CrossA1 * lambdaRotation.y;
 
-            Vector3& x1 = mRigidBodyComponents.mConstrainedPositions[componentIndexBody1];
-            Vector3& x2 = mRigidBodyComponents.mConstrainedPositions[componentIndexBody2];
+        // Compute the pseudo velocity of body 1
+        Vector3 w1 = mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mHingeJointComponents.mI1[jointComponentIndex] * angularImpulseBody1);
 
-            // Compute position error for the 3 translation constraints
-            const Vector3 errorTranslation = x2 + mHingeJointComponents.mR2World[i] - x1 - mHingeJointComponents.mR1World[i];
+        // Update the body position/orientation of body 1
+        q1 += Quaternion(0, w1) * q1 * decimal(0.5);
+        q1.normalize();
 
-            // Compute the Lagrange multiplier lambda
-            const Vector3 lambdaTranslation = mHingeJointComponents.mInverseMassMatrixTranslation[i] * (-errorTranslation);
+        // Compute the impulse of body 2
+        Vector3 angularImpulseBody2 = b2CrossA1 * lambdaRotation.x + c2CrossA1 * lambdaRotation.y;
 
-            // Compute the impulse of body 1
-            Vector3 linearImpulseBody1 = -lambdaTranslation;
-            Vector3 angularImpulseBody1 = lambdaTranslation.cross(mHingeJointComponents.mR1World[i]);
+        // Compute the pseudo velocity of body 2
+        Vector3 w2 = mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mHingeJointComponents.mI2[jointComponentIndex] * angularImpulseBody2);
 
-            // Get the inverse mass and inverse inertia tensors of the bodies
-            decimal inverseMassBody1 = mRigidBodyComponents.mInverseMasses[componentIndexBody1];
-            decimal inverseMassBody2 = mRigidBodyComponents.mInverseMasses[componentIndexBody2];
+        // Update the body position/orientation of body 2
+        q2 += Quaternion(0, w2) * q2 * decimal(0.5);
+        q2.normalize();
+    }
 
-            // Compute the pseudo velocity of body 1
-            const Vector3 v1 = inverseMassBody1 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody1] * linearImpulseBody1;
-            Vector3 w1 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody1] * (mHingeJointComponents.mI1[i] * angularImpulseBody1);
+    // --------------- Translation Constraints --------------- //
+
+    // Compute the matrix K=JM^-1J^t (3x3 matrix) for the 3 translation constraints
+    const decimal body1InverseMass = mSolverBodies.inverseMasses[solverIndexBody1];
+    const decimal body2InverseMass = mSolverBodies.inverseMasses[solverIndexBody2];
+    decimal inverseMassBodies = body1InverseMass + body2InverseMass;
+    Matrix3x3 massMatrix = Matrix3x3(inverseMassBodies, 0, 0,
+                                    0, inverseMassBodies, 0,
+                                    0, 0, inverseMassBodies) +
+                           skewSymmetricMatrixU1 * mHingeJointComponents.mI1[jointComponentIndex] * skewSymmetricMatrixU1.getTranspose() +
+                           skewSymmetricMatrixU2 * mHingeJointComponents.mI2[jointComponentIndex] * skewSymmetricMatrixU2.getTranspose();
+    mHingeJointComponents.mInverseMassMatrixTranslation[jointComponentIndex].setToZero();
+    matrixDeterminant = massMatrix.getDeterminant();
+    if (std::abs(matrixDeterminant) > MACHINE_EPSILON) {
+
+        if (mSolverBodies.bodyTypes[solverIndexBody1] == BodyType::DYNAMIC ||
+            mSolverBodies.bodyTypes[solverIndexBody2] == BodyType::DYNAMIC) {
+            mHingeJointComponents.mInverseMassMatrixTranslation[jointComponentIndex] = massMatrix.getInverse(matrixDeterminant);
+        }
 
-            // Update the body position/orientation of body 1
-            x1 += v1;
-            q1 += Quaternion(0, w1) * q1 * decimal(0.5);
-            q1.normalize();
 
-            // Compute the impulse of body 2
-            Vector3 angularImpulseBody2 = -lambdaTranslation.cross(mHingeJointComponents.mR2World[i]);
+        Vector3& x1 = mSolverBodies.positions[solverIndexBody1];
+        Vector3& x2 = mSolverBodies.positions[solverIndexBody2];
 
-            // Compute the pseudo velocity of body 2
-            const Vector3 v2 = inverseMassBody2 * mRigidBodyComponents.mLinearLockAxisFactors[componentIndexBody2] * lambdaTranslation;
-            Vector3 w2 = mRigidBodyComponents.mAngularLockAxisFactors[componentIndexBody2] * (mHingeJointComponents.mI2[i] * angularImpulseBody2);
+        // Compute position error for the 3 translation constraints
+        const Vector3 errorTranslation = x2 + mHingeJointComponents.mR2World[jointComponentIndex] - x1 - mHingeJointComponents.mR1World[jointComponentIndex];
 
-            // Update the body position/orientation of body 2
-            x2 += v2;
-            q2 += Quaternion(0, w2) * q2 * decimal(0.5);
-            q2.normalize();
-        }
+        // Compute the Lagrange multiplier lambda
+        const Vector3 lambdaTranslation = mHingeJointComponents.mInverseMassMatrixTranslation[jointComponentIndex] * (-errorTranslation);
+
+        // Compute the impulse of body 1
+        Vector3 linearImpulseBody1 = -lambdaTranslation;
+        Vector3 angularImpulseBody1 = lambdaTranslation.cross(mHingeJointComponents.mR1World[jointComponentIndex]);
+
+        // Get the inverse mass and inverse inertia tensors of the bodies
+        decimal inverseMassBody1 = mSolverBodies.inverseMasses[solverIndexBody1];
+        decimal inverseMassBody2 = mSolverBodies.inverseMasses[solverIndexBody2];
+
+        // Compute the pseudo velocity of body 1
+        const Vector3 v1 = inverseMassBody1 * mSolverBodies.linearLockAxisFactors[solverIndexBody1] * linearImpulseBody1;
+        Vector3 w1 = mSolverBodies.angularLockAxisFactors[solverIndexBody1] * (mHingeJointComponents.mI1[jointComponentIndex] * angularImpulseBody1);
+
+        // Update the body position/orientation of body 1
+        x1 += v1;
+        q1 += Quaternion(0, w1) * q1 * decimal(0.5);
+        q1.normalize();
+
+        // Compute the impulse of body 2
+        Vector3 angularImpulseBody2 = -lambdaTranslation.cross(mHingeJointComponents.mR2World[jointComponentIndex]);
+
+        // Compute the pseudo velocity of body 2
+        const Vector3 v2 = inverseMassBody2 * mSolverBodies.linearLockAxisFactors[solverIndexBody2] * lambdaTranslation;
+        Vector3 w2 = mSolverBodies.angularLockAxisFactors[solverIndexBody2] * (mHingeJointComponents.mI2[jointComponentIndex] * angularImpulseBody2);
+
+        // Update the body position/orientation of body 2
+        x2 += v2;
+        q2 += Quaternion(0, w2) * q2 * decimal(0.5);
+        q2.normalize();
     }
 }
 
@@ -757,7 +760,7 @@ decimal SolveHingeJointSystem::computeCorrespondingAngleNearLimits(decimal input
 }
 
 // Compute the current angle around the hinge axis
-decimal SolveHingeJointSystem::computeCurrentHingeAngle(Entity jointEntity, const Quaternion& orientationBody1, const Quaternion& orientationBody2) {
+decimal SolveHingeJointSystem::computeCurrentHingeAngle(uint32 jointComponentIndex, const Quaternion& orientationBody1, const Quaternion& orientationBody2) {
 
     decimal hingeAngle;
 
@@ -766,7 +769,7 @@ decimal SolveHingeJointSystem::computeCurrentHingeAngle(Entity jointEntity, cons
     currentOrientationDiff.normalize();
 
     // Compute the relative rotation considering the initial orientation difference
-    Quaternion relativeRotation = currentOrientationDiff * mHingeJointComponents.getInitOrientationDifferenceInv(jointEntity);
+    Quaternion relativeRotation = currentOrientationDiff * mHingeJointComponents.mInitOrientationDifferenceInv[jointComponentIndex];
     relativeRotation.normalize();
 
     // A quaternion q = [cos(theta/2); sin(theta/2) * rotAxis] where rotAxis is a unit
@@ -780,7 +783,7 @@ decimal SolveHingeJointSystem::computeCurrentHingeAngle(Entity jointEntity, cons
     decimal sinHalfAngleAbs = relativeRotation.getVectorV().length();
 
     // Compute the dot product of the relative rotation axis and the hinge axis
-    decimal dotProduct = relativeRotation.getVectorV().dot(mHingeJointComponents.getA1(jointEntity));
+    decimal dotProduct = relativeRotation.getVectorV().dot(mHingeJointComponents.mA1[jointComponentIndex]);
 
     // If the relative rotation axis and the hinge axis are pointing the same direction
     if (dotProduct >= decimal(0.0)) {
@@ -795,6 +798,6 @@ decimal SolveHingeJointSystem::computeCurrentHingeAngle(Entity jointEntity, cons
 
     // Compute and return the corresponding angle near one the two limits
     return computeCorrespondingAngleNearLimits(hingeAngle,
-                                               mHingeJointComponents.getLowerLimit(jointEntity),
-                                               mHingeJointComponents.getUpperLimit(jointEntity));
+                                               mHingeJointComponents.mLowerLimit[jointComponentIndex],
+                                               mHingeJointComponents.mUpperLimit[jointComponentIndex]);
 }
@@ -0,0 +1,194 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+// Libraries
+#include <reactphysics3d/utils/DefaultTaskScheduler.h>
+#include <reactphysics3d/memory/MemoryAllocator.h>
+#include <algorithm>
+
+using namespace reactphysics3d;
+
+// Static variables definition
+const uint32 DefaultTaskScheduler::NB_MAX_CHUNKS_PER_WORKER = 4;
+
+namespace {
+
+// True if the current thread is executing a task of a DefaultTaskScheduler
+thread_local bool isThreadExecutingTask = false;
+
+// Index of the worker that is executing a task on the current thread (only valid if isThreadExecutingTask is true)
+thread_local uint32 executingWorkerIndex = 0;
+}
+
+// Constructor
+/**
+ * @param allocator Memory allocator
+ * @param nbWorkers Total number of workers (including the thread calling parallelFor()). If
+ *                  zero, the number of hardware threads is used.
+ */
+DefaultTaskScheduler::DefaultTaskScheduler(MemoryAllocator& allocator, uint32 nbWorkers)
+                     : mAllocator(allocator), mNbWorkers(nbWorkers), mThreads(allocator), mTask(nullptr), mNbItems(0),
+                       mNbItemsPerChunk(0), mNbChunks(0), mNextChunk(0), mNbRemainingChunks(0), mNbActiveWorkers(0),
+                       mJobId(0), mIsQuitting(false) {
+
+    if (mNbWorkers == 0) {
+        mNbWorkers = std::max(1u, static_cast<uint32>(std::thread::hardware_concurrency()));
+    }
+
+    // Create the worker threads (the thread calling parallelFor() is the worker with index 0)
+    mThreads.reserve(mNbWorkers - 1);
+    for (uint32 i=1; i < mNbWorkers; i++) {
+        std::thread* thread = new (mAllocator.allocate(sizeof(std::thread))) std::thread(&DefaultTaskScheduler::runWorker, this, i);
+        mThreads.add(thread);
+    }
+}
+
+// Destructor
+DefaultTaskScheduler::~DefaultTaskScheduler() {
+
+    // Stop the worker threads
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mIsQuitting = true;
+    }
+    mWorkCondition.notify_all();
+
+    for (uint32 i=0; i < mThreads.size(); i++) {
+
+        mThreads[i]->join();
+
+        mThreads[i]->~thread();
+        mAllocator.release(mThreads[i], sizeof(std::thread));
+    }
+    mThreads.clear();
+}
+
+// Main function of a worker thread
+void DefaultTaskScheduler::runWorker(uint32 workerIndex) {
+
+    uint64 lastJobId = 0;
+
+    while (true) {
+
+        // Wait for a new job
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkCondition.wait(lock, [&]{ return mIsQuitting || mJobId != lastJobId; });
+
+            if (mIsQuitting) return;
+
+            lastJobId = mJobId;
+            mNbActiveWorkers++;
+        }
+
+        processChunks(workerIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mNbActiveWorkers--;
+        }
+        mDoneCondition.notify_all();
+    }
+}
+
+// Process chunks of the current job until all of them have been grabbed
+void DefaultTaskScheduler::processChunks(uint32 workerIndex) {
+
+    isThreadExecutingTask = true;
+    executingWorkerIndex = workerIndex;
+
+    uint32 chunk = mNextChunk.fetch_add(1);
+    while (chunk < mNbChunks) {
+
+        const uint32 startIndex = chunk * mNbItemsPerChunk;
+        const uint32 endIndex = std::min(startIndex + mNbItemsPerChunk, mNbItems);
+
+        mTask->execute(startIndex, endIndex, workerIndex);
+
+        // If this was the last chunk of the job
+        if (mNbRemainingChunks.fetch_sub(1) == 1) {
+
+            std::lock_guard<std::mutex> lock(mMutex);
+            mDoneCondition.notify_all();
+        }
+
+        chunk = mNextChunk.fetch_add(1);
+    }
+
+    isThreadExecutingTask = false;
+}
+
+// Execute a task on the range [0, nbItems) using the worker threads
+/// This method only returns when all the items have been processed. If this
+/// method is called from inside a task, the items are processed on the calling thread
+/// with the index of the worker that is executing the outer task. If there are not
+/// enough items to split them, they are also processed on the calling thread.
+/**
+ * @param nbItems Number of items to process
+ * @param minNbItemsPerTask Minimum number of items that a single call to Task::execute() should process
+ * @param task Task to execute
+ */
+void DefaultTaskScheduler::parallelFor(uint32 nbItems, uint32 minNbItemsPerTask, Task& task) {
+
+    if (nbItems == 0) return;
+
+    // If there are no worker threads, if we are already inside a task or if there are not enough items
+    if (mNbWorkers <= 1 || isThreadExecutingTask || nbItems <= minNbItemsPerTask) {
+        task.execute(0, nbItems, isThreadExecutingTask ? executingWorkerIndex : 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> parallelForLock(mParallelForMutex);
+
+    minNbItemsPerTask = std::max(minNbItemsPerTask, 1u);
+    const uint32 nbMaxChunks = mNbWorkers * NB_MAX_CHUNKS_PER_WORKER;
+    const uint32 nbChunks = std::max(1u, std::min(nbMaxChunks, nbItems / minNbItemsPerTask));
+
+    // Publish the new job
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        // Make sure no worker is still looking at the previous job
+        mDoneCondition.wait(lock, [&]{ return mNbActiveWorkers == 0; });
+
+        mTask = &task;
+        mNbItems = nbItems;
+        mNbItemsPerChunk = (nbItems + nbChunks - 1) / nbChunks;
+        mNbChunks = (nbItems + mNbItemsPerChunk - 1) / mNbItemsPerChunk;
+        mNbRemainingChunks = mNbChunks;
+        mNextChunk = 0;
+        mJobId++;
+    }
+    mWorkCondition.notify_all();
+
+    // The calling thread is also working on the job
+    processChunks(0);
+
+    // Wait until all the chunks have been processed and all the workers are done
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDoneCondition.wait(lock, [&]{ return mNbRemainingChunks == 0 && mNbActiveWorkers == 0; });
+
+    mTask = nullptr;
+}
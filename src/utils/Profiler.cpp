@@ -30,14 +30,52 @@
 // Libraries
 #include <reactphysics3d/utils/Profiler.h>
 #include <string>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
 #include <reactphysics3d/memory/MemoryManager.h>
 
 using namespace reactphysics3d;
 
+// Static variables definition
+const uint32 Profiler::NB_MAX_EVENTS_PER_THREAD = 65536;
+const uint32 Profiler::MAX_TREE_DEPTH = 64;
+std::atomic<uint64> Profiler::mNbCreatedProfilers(0);
+
+namespace {
+
+// Event buffer of the calling thread for the last profiler used by this thread
+struct ThreadEventBufferCache {
+
+    /// Identifier of the profiler (zero if no profiler has been used by the thread)
+    uint64 profilerId = 0;
+
+    /// Event buffer of the thread in this profiler
+    ProfileEventBuffer* eventBuffer = nullptr;
+};
+
+thread_local ThreadEventBufferCache threadEventBufferCache;
+}
+
+// Constructor
+ProfileEventBuffer::ProfileEventBuffer(uint32 capacity, uint32 threadIndex, std::thread::id threadId)
+                   :mCapacity(capacity), mNbRecordedEvents(0), mDepth(0), mThreadIndex(threadIndex),
+                    mThreadId(threadId), mFirstEventIndex(0), mNbEventsInTree(0) {
+
+    assert((capacity & (capacity - 1)) == 0);
+
+    mEvents = static_cast<ProfileEvent*>(std::malloc(capacity * sizeof(ProfileEvent)));
+}
+
+// Destructor
+ProfileEventBuffer::~ProfileEventBuffer() {
+    std::free(mEvents);
+}
+
 // Constructor
 ProfileNode::ProfileNode(const char* name, ProfileNode* parentNode)
-    :mName(name), mNbTotalCalls(0), mStartingTime(), mTotalTime(0),
-     mRecursionCounter(0), mParentNode(parentNode), mChildNode(nullptr),
+    :mName(name), mNbTotalCalls(0), mTotalTime(0),
+     mParentNode(parentNode), mChildNode(nullptr),
      mSiblingNode(nullptr) {
     reset();
 }
@@ -70,36 +108,10 @@ ProfileNode* ProfileNode::findSubNode(const char* name) {
     return newNode;
 }
 
-// Called when we enter the block of code corresponding to this profile node
-void ProfileNode::enterBlockOfCode() {
+// Add a call of the block of code to the node
+void ProfileNode::addCall(std::chrono::duration<double, std::milli> duration) {
     mNbTotalCalls++;
-
-    // If the current code is not called recursively
-    if (mRecursionCounter == 0) {
-
-        // Get the current system time to initialize the starting time of
-        // the profiling of the current block of code
-        mStartingTime = clock::now();
-    }
-
-    mRecursionCounter++;
-}
-
-// Called when we exit the block of code corresponding to this profile node
-bool ProfileNode::exitBlockOfCode() {
-    mRecursionCounter--;
-
-    if (mRecursionCounter == 0 && mNbTotalCalls != 0) {
-
-        // Get the current system time
-        std::chrono::time_point<std::chrono::high_resolution_clock> currentTime = std::chrono::high_resolution_clock::now();
-
-        // Increase the total elasped time in the current block of code
-        mTotalTime += currentTime - mStartingTime;
-    }
-
-    // Return true if the current code is not recursing
-    return (mRecursionCounter == 0);
+    mTotalTime += duration;
 }
 
 // Reset the profiling of the node
@@ -156,13 +168,25 @@ void ProfileNodeIterator::enterParent() {
 }
 
 // Constructor
-Profiler::Profiler() :mRootNode("Root", nullptr) {
+Profiler::Profiler() :mId(++mNbCreatedProfilers), mIsEnabled(true), mRootNode("Root", nullptr) {
 
-	mCurrentNode = &mRootNode;
     mNbDestinations = 0;
     mNbAllocatedDestinations = 0;
     mProfilingStartTime = clock::now();
+    mProfilingStartTimestamp = getTimestamp();
+    mCalibrationTime = std::chrono::steady_clock::now();
+    mCalibrationTimestamp = mProfilingStartTimestamp;
 	mFrameCounter = 0;
+    mProfilingThreadId = std::this_thread::get_id();
+    mNbEventBuffers = 0;
+    mNbAllocatedEventBuffers = 0;
+    mEventBuffers = nullptr;
+
+#ifdef RP3D_PROFILER_USE_TSC
+    mNbTicksPerMillisecond = 0.0;
+#else
+    mNbTicksPerMillisecond = 1000000.0;
+#endif
 
     allocatedDestinations(1);
 }
@@ -173,6 +197,11 @@ Profiler::~Profiler() {
     removeAllDestinations();
 
 	destroy();
+
+    for (uint32 i=0; i < mNbEventBuffers; i++) {
+        delete mEventBuffers[i];
+    }
+    std::free(mEventBuffers);
 }
 
 // Remove all logs destination previously set
@@ -186,41 +215,241 @@ void Profiler::removeAllDestinations() {
     mNbDestinations = 0;
 }
 
-// Method called when we want to start profiling a block of code.
-void Profiler::startProfilingBlock(const char* name) {
+// Return the event buffer of the calling thread
+/// The buffer is created the first time a thread profiles a block of code with this profiler.
+ProfileEventBuffer* Profiler::getThreadEventBuffer() {
+
+    if (threadEventBufferCache.profilerId == mId) {
+        return threadEventBufferCache.eventBuffer;
+    }
+
+    ProfileEventBuffer* eventBuffer = createThreadEventBuffer();
+
+    threadEventBufferCache.profilerId = mId;
+    threadEventBufferCache.eventBuffer = eventBuffer;
+
+    return eventBuffer;
+}
+
+// Create the event buffer of the calling thread
+/// If the thread already has an event buffer in this profiler, this buffer is returned.
+ProfileEventBuffer* Profiler::createThreadEventBuffer() {
+
+    const std::thread::id threadId = std::this_thread::get_id();
+
+    std::lock_guard<std::mutex> lock(mEventBuffersMutex);
+
+    for (uint32 i=0; i < mNbEventBuffers; i++) {
+        if (mEventBuffers[i]->mThreadId == threadId) {
+            return mEventBuffers[i];
+        }
+    }
+
+    if (mNbEventBuffers == mNbAllocatedEventBuffers) {
+
+        const uint32 nbAllocatedEventBuffers = std::max(4u, 2 * mNbAllocatedEventBuffers);
+        ProfileEventBuffer** newArray = static_cast<ProfileEventBuffer**>(std::malloc(nbAllocatedEventBuffers * sizeof(ProfileEventBuffer*)));
+        if (mEventBuffers != nullptr) {
+            std::memcpy(newArray, mEventBuffers, mNbEventBuffers * sizeof(ProfileEventBuffer*));
+            std::free(mEventBuffers);
+        }
+
+        mEventBuffers = newArray;
+        mNbAllocatedEventBuffers = nbAllocatedEventBuffers;
+    }
+
+    ProfileEventBuffer* eventBuffer = new ProfileEventBuffer(NB_MAX_EVENTS_PER_THREAD, mNbEventBuffers, threadId);
+
+    // The new events are only exported after the last reset of the profiler
+    mEventBuffers[mNbEventBuffers] = eventBuffer;
+    mNbEventBuffers++;
+
+    return eventBuffer;
+}
+
+// Increment the frame counter
+/// This method must be called by the thread that updates the world at the beginning of
+/// a frame. The events of the previous frame of this thread are added to the profiler tree.
+void Profiler::incrementFrameCounter() {
 
-    // Look for the node in the tree that corresponds to the block of
-    // code to profile
-    if (name != mCurrentNode->getName()) {
-        mCurrentNode = mCurrentNode->findSubNode(name);
+    mProfilingThreadId = std::this_thread::get_id();
+
+    updateProfilerTree();
+
+    mFrameCounter++;
+}
+
+// Update the number of timestamp ticks per millisecond
+void Profiler::updateTimestampFrequency() {
+
+#ifdef RP3D_PROFILER_USE_TSC
+
+    // The time-stamp counter frequency is computed using the elapsed time since the creation of the profiler
+    const uint64 timestamp = getTimestamp();
+    const double elapsedTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mCalibrationTime).count();
+    if (elapsedTime > 0.0 && timestamp > mCalibrationTimestamp) {
+        mNbTicksPerMillisecond = static_cast<double>(timestamp - mCalibrationTimestamp) / elapsedTime;
     }
 
-    // Start profile the node
-    mCurrentNode->enterBlockOfCode();
+#endif
 }
 
-// Method called at the end of the scope where the
-// startProfilingBlock() method has been called.
-void Profiler::stopProfilingBlock() {
+// Add the new events of the profiling thread to the profiler tree
+/// The events are recorded when the blocks of code end which means that a block is recorded after
+/// all its nested blocks. Therefore, going through the events backward, a block is always found before
+/// its nested blocks and the depth of an event is enough to find its parent node in the tree.
+void Profiler::updateProfilerTree() {
+
+    ProfileEventBuffer* eventBuffer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mEventBuffersMutex);
+        for (uint32 i=0; i < mNbEventBuffers; i++) {
+            if (mEventBuffers[i]->mThreadId == mProfilingThreadId) {
+                eventBuffer = mEventBuffers[i];
+                break;
+            }
+        }
+    }
+
+    if (eventBuffer == nullptr) return;
+
+    const uint64 nbRecordedEvents = eventBuffer->mNbRecordedEvents.load(std::memory_order_acquire);
+
+    // The oldest events might have been overwritten if there were too many events since the last update
+    const uint64 firstEventIndex = std::max(eventBuffer->mNbEventsInTree, eventBuffer->getOldestEventIndex(nbRecordedEvents));
+    eventBuffer->mNbEventsInTree = nbRecordedEvents;
+
+    if (firstEventIndex == nbRecordedEvents) return;
 
-    // Go to the parent node unless if the current block
-    // of code is recursing
-    if (mCurrentNode->exitBlockOfCode()) {
-        mCurrentNode = mCurrentNode->getParentNode();
+    updateTimestampFrequency();
+    const double nbMillisecondsPerTick = mNbTicksPerMillisecond > 0.0 ? 1.0 / mNbTicksPerMillisecond : 0.0;
+
+    // Stack with the node of the last event at each depth
+    ProfileNode* nodes[MAX_TREE_DEPTH];
+    uint32 nbNodes = 0;
+
+    for (uint64 i = nbRecordedEvents; i > firstEventIndex; i--) {
+
+        const ProfileEvent& event = eventBuffer->getEvent(i - 1);
+
+        // Find the parent node (the enclosing block might be missing if its event has been overwritten)
+        nbNodes = std::min(nbNodes, std::min(event.depth, MAX_TREE_DEPTH - 1));
+        ProfileNode* parentNode = nbNodes > 0 ? nodes[nbNodes - 1] : &mRootNode;
+
+        // If the block of code is called recursively, its time is already counted by the parent
+        if (parentNode != &mRootNode && parentNode->getName() == event.name) {
+            parentNode->addCall(std::chrono::duration<double, std::milli>::zero());
+            nodes[nbNodes++] = parentNode;
+            continue;
+        }
+
+        ProfileNode* node = parentNode->findSubNode(event.name);
+        node->addCall(std::chrono::duration<double, std::milli>(static_cast<double>(event.endTime - event.startTime) * nbMillisecondsPerTick));
+        nodes[nbNodes++] = node;
     }
 }
 
 // Reset the timing data of the profiler (but not the profiler tree structure)
+/// The events recorded before the reset are not exported anymore. This method must not be
+/// called while the world is being updated.
 void Profiler::reset() {
+
+    {
+        std::lock_guard<std::mutex> lock(mEventBuffersMutex);
+        for (uint32 i=0; i < mNbEventBuffers; i++) {
+            const uint64 nbRecordedEvents = mEventBuffers[i]->mNbRecordedEvents.load(std::memory_order_acquire);
+            mEventBuffers[i]->mFirstEventIndex = nbRecordedEvents;
+            mEventBuffers[i]->mNbEventsInTree = nbRecordedEvents;
+        }
+    }
+
     mRootNode.reset();
-    mRootNode.enterBlockOfCode();
     mFrameCounter = 0;
     mProfilingStartTime = clock::now();
+    mProfilingStartTimestamp = getTimestamp();
+}
+
+// Return an iterator over the profiler tree starting at the root
+ProfileNodeIterator* Profiler::getIterator() {
+
+    updateProfilerTree();
+
+    return new ProfileNodeIterator(&mRootNode);
+}
+
+// Export the recent events of all the threads as a Chrome trace (JSON)
+/// The file can be opened with chrome://tracing or https://ui.perfetto.dev. Only the
+/// events recorded since the last reset that are still in the ring buffers of the threads
+/// are exported. This method must not be called while the world is being updated.
+/**
+ * @param outputStream Stream where the trace is written
+ */
+void Profiler::exportChromeTrace(std::ostream& outputStream) {
+
+    std::lock_guard<std::mutex> lock(mEventBuffersMutex);
+
+    updateTimestampFrequency();
+    const double nbMicrosecondsPerTick = mNbTicksPerMillisecond > 0.0 ? 1000.0 / mNbTicksPerMillisecond : 0.0;
+
+    const std::ios::fmtflags flags = outputStream.flags();
+    const std::streamsize precision = outputStream.precision();
+    outputStream.setf(std::ios::fixed, std::ios::floatfield);
+    outputStream.precision(3);
+
+    outputStream << "{\"traceEvents\":[";
+
+    bool isFirstEvent = true;
+    for (uint32 i=0; i < mNbEventBuffers; i++) {
+
+        const ProfileEventBuffer* eventBuffer = mEventBuffers[i];
+
+        // Name of the thread
+        outputStream << (isFirstEvent ? "\n" : ",\n");
+        outputStream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << eventBuffer->mThreadIndex <<
+                        ",\"args\":{\"name\":\"" << (eventBuffer->mThreadId == mProfilingThreadId ? "Physics thread " : "Thread ") <<
+                        eventBuffer->mThreadIndex << "\"}}";
+        isFirstEvent = false;
+
+        const uint64 nbRecordedEvents = eventBuffer->mNbRecordedEvents.load(std::memory_order_acquire);
+        const uint64 firstEventIndex = std::max(eventBuffer->mFirstEventIndex, eventBuffer->getOldestEventIndex(nbRecordedEvents));
+
+        for (uint64 e = firstEventIndex; e < nbRecordedEvents; e++) {
+
+            const ProfileEvent& event = eventBuffer->getEvent(e);
+            if (event.startTime < mProfilingStartTimestamp) continue;
+
+            outputStream << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"rp3d\",\"ph\":\"X\",\"pid\":0,\"tid\":" <<
+                            eventBuffer->mThreadIndex << ",\"ts\":" <<
+                            static_cast<double>(event.startTime - mProfilingStartTimestamp) * nbMicrosecondsPerTick <<
+                            ",\"dur\":" << static_cast<double>(event.endTime - event.startTime) * nbMicrosecondsPerTick << "}";
+        }
+    }
+
+    outputStream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    outputStream.flags(flags);
+    outputStream.precision(precision);
+}
+
+// Export the recent events of all the threads as a Chrome trace (JSON) into a file
+/**
+ * @param filePath Path of the file where the trace is written
+ */
+void Profiler::exportChromeTrace(const std::string& filePath) {
+
+    std::ofstream fileStream(filePath, std::ios::binary);
+    if (!fileStream.is_open()) {
+        throw(std::runtime_error("ReactPhysics3D Profiler: Unable to open an output stream to file " + filePath));
+    }
+
+    exportChromeTrace(fileStream);
 }
 
 // Print the report of the profiler in a given output stream
 void Profiler::printReport() {
 
+    updateProfilerTree();
+
     // For each destination
     for (uint i=0; i < mNbDestinations; i++) {
 
@@ -39,12 +39,21 @@
 #include "tests/collision/TestDynamicAABBTree.h"
 #include "tests/collision/TestHalfEdgeStructure.h"
 #include "tests/collision/TestTriangleVertexArray.h"
+#include "tests/collision/TestNarrowPhaseInfoBatch.h"
 #include "tests/containers/TestArray.h"
 #include "tests/containers/TestMap.h"
 #include "tests/containers/TestSet.h"
 #include "tests/containers/TestDeque.h"
 #include "tests/containers/TestStack.h"
+#include "tests/containers/TestEntitySparseSet.h"
+#include "tests/memory/TestMemoryAllocators.h"
 #include "tests/engine/TestRigidBody.h"
+#include "tests/engine/TestTaskScheduler.h"
+#include "tests/engine/TestContactSolver.h"
+#include "tests/engine/TestWorldSnapshot.h"
+#include "tests/engine/TestOverlappingPairs.h"
+#include "tests/engine/TestSolverBodies.h"
+#include "tests/utils/TestProfiler.h"
 
 using namespace reactphysics3d;
 
@@ -59,6 +68,11 @@ int main() {
     testSuite.addTest(new TestMap("Map"));
     testSuite.addTest(new TestDeque("Deque"));
     testSuite.addTest(new TestStack("Stack"));
+    testSuite.addTest(new TestEntitySparseSet("EntitySparseSet"));
+
+    // ---------- Memory tests ---------- //
+
+    testSuite.addTest(new TestMemoryAllocators("MemoryAllocators"));
 
     // ---------- Mathematics tests ---------- //
 
@@ -79,11 +93,23 @@ int main() {
     testSuite.addTest(new TestCollisionWorld("CollisionWorld"));
     testSuite.addTest(new TestDynamicAABBTree("DynamicAABBTree"));
     testSuite.addTest(new TestHalfEdgeStructure("HalfEdgeStructure"));
+    testSuite.addTest(new TestNarrowPhaseInfoBatch("NarrowPhaseInfoBatch"));
 
 
     // ---------- Engine tests ---------- //
 
     testSuite.addTest(new TestRigidBody("RigidBody"));
+    testSuite.addTest(new TestTaskScheduler("TaskScheduler"));
+    testSuite.addTest(new TestContactSolver("ContactSolver"));
+    testSuite.addTest(new TestWorldSnapshot("WorldSnapshot"));
+    testSuite.addTest(new TestOverlappingPairs("OverlappingPairs"));
+    testSuite.addTest(new TestSolverBodies("SolverBodies"));
+
+    // ---------- Utils tests ---------- //
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+    testSuite.addTest(new TestProfiler("Profiler"));
+#endif
 
     // Run the tests
     testSuite.run();
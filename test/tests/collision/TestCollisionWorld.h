@@ -185,11 +185,10 @@ class WorldCollisionCallback : public CollisionCallback
         // This method is called when some contacts occur
         virtual void onContact(const CallbackData& callbackData) override {
 
-            CollisionData collisionData;
-
             // For each contact pair
             for (uint32 p=0; p < callbackData.getNbContactPairs(); p++) {
 
+                CollisionData collisionData;
                 ContactPairData contactPairData;
                 ContactPair contactPair = callbackData.getContactPair(p);
 
@@ -206,9 +205,9 @@ class WorldCollisionCallback : public CollisionCallback
                 }
 
                 collisionData.contactPairs.push_back(contactPairData);
-            }
 
-            mCollisionDatas.insert(std::make_pair(getCollisionKeyPair(collisionData.colliders), collisionData));
+                mCollisionDatas.insert(std::make_pair(getCollisionKeyPair(collisionData.colliders), collisionData));
+            }
         }
 };
 
@@ -514,6 +513,8 @@ class TestCollisionWorld : public Test {
             testConvexMeshVsConvexMeshCollision();
             testConvexMeshVsCapsuleCollision();
             testConvexMeshVsConcaveMeshCollision();
+
+            testSphereAndCapsuleBatches();
         }
 
 		void testNoCollisions() {
@@ -2954,6 +2955,73 @@ class TestCollisionWorld : public Test {
             mCapsuleBody1->setTransform(initTransform1);
             mConcaveMeshBody->setTransform(initTransform2);
         }
+
+        /// Test many sphere vs sphere and sphere vs capsule pairs at the same time so that the
+        /// narrow-phase batches are large enough to be tested several items at a time
+        void testSphereAndCapsuleBatches() {
+
+            const uint32 nbPairs = 11;
+            const Quaternion capsuleOrientation = Quaternion::fromEulerAngles(0, 0, rp3d::PI_RP3D / 4.0f);
+
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(1);
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(0.5, 2);
+
+            std::vector<CollisionBody*> bodies;
+            std::vector<Collider*> colliders;
+
+            for (uint32 i=0; i < nbPairs; i++) {
+
+                // The shapes of the odd pairs are colliding. The shapes of the even pairs are not colliding
+                // but their AABBs are overlapping.
+                const bool isColliding = i % 2 == 1;
+
+                // Sphere vs sphere pair
+                const Vector3 spherePosition(300, 10 * i, 0);
+                const Vector3 offset = isColliding ? Vector3(1.2, 1.2, 0) : Vector3(1.6, 1.6, 0);
+                bodies.push_back(mWorld->createCollisionBody(Transform(spherePosition, Quaternion::identity())));
+                colliders.push_back(bodies.back()->addCollider(sphereShape, Transform::identity()));
+                bodies.push_back(mWorld->createCollisionBody(Transform(spherePosition + offset, Quaternion::identity())));
+                colliders.push_back(bodies.back()->addCollider(sphereShape, Transform::identity()));
+
+                // Sphere vs capsule pair
+                const Vector3 capsulePosition(400, 10 * i, 0);
+                const Vector3 sphereLocalPosition = isColliding ? Vector3(1.2, 0.3, 0) : Vector3(1.7, 0.3, 0);
+                bodies.push_back(mWorld->createCollisionBody(Transform(capsulePosition, capsuleOrientation)));
+                colliders.push_back(bodies.back()->addCollider(capsuleShape, Transform::identity()));
+                bodies.push_back(mWorld->createCollisionBody(Transform(capsulePosition + capsuleOrientation * sphereLocalPosition, Quaternion::identity())));
+                colliders.push_back(bodies.back()->addCollider(sphereShape, Transform::identity()));
+            }
+
+            mCollisionCallback.reset();
+            mWorld->testCollision(mCollisionCallback);
+
+            for (uint32 i=0; i < nbPairs; i++) {
+
+                const bool isColliding = i % 2 == 1;
+
+                // Sphere vs sphere pair
+                const CollisionData* collisionData = mCollisionCallback.getCollisionData(colliders[4 * i], colliders[4 * i + 1]);
+                rp3d_test((collisionData != nullptr) == isColliding);
+                if (collisionData != nullptr) {
+                    rp3d_test(collisionData->getTotalNbContactPoints() == 1);
+                    rp3d_test(approxEqual(collisionData->contactPairs[0].contactPoints[0].penetrationDepth, decimal(2.0) - Vector3(1.2, 1.2, 0).length(), decimal(0.001)));
+                }
+
+                // Sphere vs capsule pair
+                collisionData = mCollisionCallback.getCollisionData(colliders[4 * i + 2], colliders[4 * i + 3]);
+                rp3d_test((collisionData != nullptr) == isColliding);
+                if (collisionData != nullptr) {
+                    rp3d_test(collisionData->getTotalNbContactPoints() == 1);
+                    rp3d_test(approxEqual(collisionData->contactPairs[0].contactPoints[0].penetrationDepth, decimal(0.3), decimal(0.001)));
+                }
+            }
+
+            for (uint32 i=0; i < bodies.size(); i++) {
+                mWorld->destroyCollisionBody(bodies[i]);
+            }
+            mPhysicsCommon.destroySphereShape(sphereShape);
+            mPhysicsCommon.destroyCapsuleShape(capsuleShape);
+        }
  };
 
 }
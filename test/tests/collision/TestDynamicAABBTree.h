@@ -29,10 +29,14 @@
 // Libraries
 #include "Test.h"
 #include <reactphysics3d/collision/broadphase/DynamicAABBTree.h>
+#include <reactphysics3d/collision/broadphase/QuantizedAABBTree.h>
+#include <reactphysics3d/collision/broadphase/WideAABBTree.h>
 #include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/engine/WorldSnapshot.h>
 #include <reactphysics3d/engine/PhysicsCommon.h>
 #include <reactphysics3d/utils/Profiler.h>
 #include <vector>
+#include <cstring>
 
 /// Reactphysics3D namespace
 namespace reactphysics3d {
@@ -136,6 +140,13 @@ class TestDynamicAABBTree : public Test {
             testBasicsMethods();
             testOverlapping();
             testRaycast();
+            testBulkInsertion();
+            testRebuild();
+            testQuantizedTree();
+            testWideTree();
+            testQuantizedTreesFarFromOrigin();
+            testFatAABBMargins();
+            testRestoreCorruptedSnapshot();
 
         }
 
@@ -560,7 +571,537 @@ class TestDynamicAABBTree : public Test {
             rp3d_test(mRaycastCallback.isHit(object4Id));
 
         }
- };
+
+        /// Return true if the tree reports exactly the objects overlapping with an AABB
+        bool isSameOverlapping(const DynamicAABBTree& tree, const std::vector<int>& objectIds,
+                               const std::vector<AABB>& objectAABBs, const AABB& aabb) {
+
+            Array<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+
+            uint32 nbOverlappingObjects = 0;
+            for (size_t i=0; i < objectIds.size(); i++) {
+                if (objectAABBs[i].testCollision(aabb)) {
+                    nbOverlappingObjects++;
+                    if (!isOverlapping(objectIds[i], overlappingNodes)) return false;
+                }
+            }
+
+            return overlappingNodes.size() == nbOverlappingObjects;
+        }
+
+        void testBulkInsertion() {
+
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            std::vector<int> objectIds;
+            std::vector<AABB> objectAABBs;
+            std::vector<int> objectsData(300);
+
+            // Objects inserted one by one
+            for (int i=0; i < 3; i++) {
+                const AABB aabb(Vector3(decimal(i * 5), 20, 0), Vector3(decimal(i * 5 + 2), 22, 2));
+                objectIds.push_back(tree.addObject(aabb, &(objectsData[i])));
+                objectAABBs.push_back(aabb);
+            }
+
+            // Many objects inserted at once (the tree is built again)
+            std::vector<AABB> newAABBs;
+            for (int x=0; x < 10; x++) {
+                for (int z=0; z < 20; z++) {
+                    const Vector3 min(decimal(x * 1.5), decimal((x + z) % 3), decimal(z * 1.5));
+                    newAABBs.push_back(AABB(min, min + Vector3(1, 1, 1)));
+                }
+            }
+            std::vector<int32> newIds(newAABBs.size());
+            tree.addObjects(newAABBs.data(), static_cast<uint32>(newAABBs.size()), newIds.data());
+            for (size_t i=0; i < newIds.size(); i++) {
+                tree.setNodeDataPointer(newIds[i], &(objectsData[objectIds.size()]));
+                objectIds.push_back(newIds[i]);
+                objectAABBs.push_back(newAABBs[i]);
+            }
+
+            // The objects inserted before keep their ids and data
+            rp3d_test(tree.getNodeDataPointer(objectIds[0]) == &(objectsData[0]));
+            rp3d_test(tree.getNodeDataPointer(objectIds[2]) == &(objectsData[2]));
+            rp3d_test(tree.getNodeDataPointer(objectIds[150]) == &(objectsData[150]));
+
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(2, 0, 2), Vector3(6, 1, 9))));
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(-1, 19, -1), Vector3(6, 21, 1))));
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50))));
+
+            // A few objects inserted at once (they are inserted one by one)
+            newAABBs.clear();
+            for (int i=0; i < 5; i++) {
+                newAABBs.push_back(AABB(Vector3(decimal(i * 3), 2, 4), Vector3(decimal(i * 3 + 2), 3, 8)));
+            }
+            tree.addObjects(newAABBs.data(), static_cast<uint32>(newAABBs.size()), newIds.data());
+            for (size_t i=0; i < newAABBs.size(); i++) {
+                tree.setNodeDataPointer(newIds[i], &(objectsData[objectIds.size()]));
+                objectIds.push_back(newIds[i]);
+                objectAABBs.push_back(newAABBs[i]);
+            }
+
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(2, 0, 2), Vector3(6, 1, 9))));
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(0, 2, 0), Vector3(20, 4, 5))));
+
+            // Remove objects from the tree built in bulk
+            for (int i=0; i < 50; i++) {
+                tree.removeObject(objectIds.back());
+                objectIds.pop_back();
+                objectAABBs.pop_back();
+            }
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50))));
+        }
+
+        void testRebuild() {
+
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+#endif
+
+            // The cost of an empty tree or a tree with a single object is zero
+            rp3d_test(approxEqual(tree.computeSAHCost(), decimal(0.0)));
+            tree.rebuild();
+            rp3d_test(approxEqual(tree.computeSAHCost(), decimal(0.0)));
+
+            std::vector<int> objectIds;
+            std::vector<AABB> objectAABBs;
+
+            // Objects inserted one by one in a scrambled order
+            for (int i=0; i < 256; i++) {
+                const int x = (i * 37) % 16;
+                const int z = (i * 101) % 256 / 16;
+                const Vector3 min(decimal(x * 2), decimal(i % 3), decimal(z * 2));
+                const AABB aabb(min, min + Vector3(1, 1, 1));
+                objectIds.push_back(tree.addObject(aabb, i, 2 * i));
+                objectAABBs.push_back(aabb);
+            }
+
+            // The cost of a tree with two objects only depends on the root
+            DynamicAABBTree smallTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            smallTree.setProfiler(mProfiler);
+#endif
+            smallTree.addObject(objectAABBs[0], 0, 0);
+            smallTree.addObject(objectAABBs[1], 1, 1);
+            rp3d_test(approxEqual(smallTree.computeSAHCost(), decimal(1.0)));
+
+            // Rebuilding the tree makes it cheaper without changing the objects
+            const decimal costBeforeRebuild = tree.computeSAHCost();
+            tree.rebuild();
+            const decimal costAfterRebuild = tree.computeSAHCost();
+            rp3d_test(costAfterRebuild > decimal(1.0));
+            rp3d_test(costAfterRebuild < costBeforeRebuild);
+
+            for (int i=0; i < 256; i++) {
+                rp3d_test(tree.getNodeDataInt(objectIds[i])[0] == i);
+                rp3d_test(tree.getNodeDataInt(objectIds[i])[1] == 2 * i);
+            }
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(2, 0, 2), Vector3(6, 1, 9))));
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50))));
+
+            // A rebuilt tree can be updated again
+            const AABB movedAABB(Vector3(100, 0, 100), Vector3(101, 1, 101));
+            tree.updateObject(objectIds[10], movedAABB);
+            objectAABBs[10] = movedAABB;
+            tree.removeObject(objectIds.back());
+            objectIds.pop_back();
+            objectAABBs.pop_back();
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(99, -1, 99), Vector3(102, 2, 102))));
+            rp3d_test(isSameOverlapping(tree, objectIds, objectAABBs, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50))));
+        }
+        /// Return the IDs in the source tree of the leaf nodes of a quantized or wide tree overlapping with an AABB
+        template<typename CompactTree>
+        std::vector<int> getQuantizedOverlapping(const CompactTree& tree, const AABB& aabb) {
+
+            Array<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+
+            std::vector<int> sourceNodeIds;
+            for (uint32 i=0; i < overlappingNodes.size(); i++) {
+                sourceNodeIds.push_back(tree.getSourceNodeID(overlappingNodes[i]));
+            }
+
+            return sourceNodeIds;
+        }
+
+        /// Return true if a quantized or wide tree reports all the objects overlapping with an AABB and
+        /// only objects that are overlapping with the AABB enlarged by a given margin
+        template<typename CompactTree>
+        bool isQuantizedOverlappingValid(const CompactTree& tree, const std::vector<int>& objectIds,
+                                         const std::vector<AABB>& objectAABBs, const AABB& aabb, decimal margin) {
+
+            const std::vector<int> sourceNodeIds = getQuantizedOverlapping(tree, aabb);
+            const AABB enlargedAABB(aabb.getMin() - Vector3(margin, margin, margin), aabb.getMax() + Vector3(margin, margin, margin));
+
+            for (size_t i=0; i < objectIds.size(); i++) {
+
+                const bool isReported = std::find(sourceNodeIds.begin(), sourceNodeIds.end(), objectIds[i]) != sourceNodeIds.end();
+                if (objectAABBs[i].testCollision(aabb) && !isReported) return false;
+                if (isReported && !objectAABBs[i].testCollision(enlargedAABB)) return false;
+            }
+
+            return true;
+        }
+
+        void testQuantizedTree() {
+
+            rp3d_test(sizeof(QuantizedTreeNode) == 32);
+
+            DynamicAABBTree tree(mAllocator);
+            QuantizedAABBTree quantizedTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+            quantizedTree.setProfiler(mProfiler);
+#endif
+
+            // The quantized copy of an empty tree is empty
+            quantizedTree.build(tree);
+            rp3d_test(quantizedTree.getNbNodes() == 0);
+            rp3d_test(getQuantizedOverlapping(quantizedTree, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50))).empty());
+
+            std::vector<int> objectIds;
+            std::vector<AABB> objectAABBs;
+            for (int i=0; i < 256; i++) {
+                const int x = (i * 37) % 16;
+                const int z = (i * 101) % 256 / 16;
+                const Vector3 min(decimal(x * 2), decimal(i % 3) * decimal(0.7), decimal(z * 2.1));
+                const AABB aabb(min, min + Vector3(decimal(1.3), 1, decimal(0.9)));
+                objectIds.push_back(tree.addObject(aabb, i, 2 * i));
+                objectAABBs.push_back(aabb);
+            }
+
+            quantizedTree.build(tree);
+
+            rp3d_test(quantizedTree.getNbNodes() == 2 * 256 - 1);
+            rp3d_test(quantizedTree.getNodesSizeInBytes() == static_cast<size_t>(2 * 256 - 1) * 32);
+            rp3d_test(approxEqual(quantizedTree.getRootAABB().getMin(), tree.getRootAABB().getMin()));
+            rp3d_test(approxEqual(quantizedTree.getRootAABB().getMax(), tree.getRootAABB().getMax()));
+
+            // Each leaf node keeps the data of its node in the source tree
+            Array<int> allNodes(mAllocator);
+            quantizedTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50)), allNodes);
+            rp3d_test(allNodes.size() == 256);
+            for (uint32 i=0; i < allNodes.size(); i++) {
+                const int32 sourceNodeId = quantizedTree.getSourceNodeID(allNodes[i]);
+                const int objectIndex = static_cast<int>(std::find(objectIds.begin(), objectIds.end(), sourceNodeId) - objectIds.begin());
+                rp3d_test(objectIndex < 256);
+                rp3d_test(quantizedTree.getNodeDataInt(allNodes[i])[0] == objectIndex);
+                rp3d_test(quantizedTree.getNodeDataInt(allNodes[i])[1] == 2 * objectIndex);
+            }
+
+            // The quantization error is at most two units of 1/65535 of the size of the root AABB
+            const decimal margin = decimal(0.01);
+            rp3d_test(isQuantizedOverlappingValid(quantizedTree, objectIds, objectAABBs, AABB(Vector3(2, 0, 2), Vector3(6, 1, 9)), margin));
+            rp3d_test(isQuantizedOverlappingValid(quantizedTree, objectIds, objectAABBs, AABB(Vector3(3.3, 0.5, 0.9), Vector3(3.31, 0.6, 0.95)), margin));
+            rp3d_test(isQuantizedOverlappingValid(quantizedTree, objectIds, objectAABBs, AABB(Vector3(-10, -10, -10), Vector3(1, 1, 1)), margin));
+            rp3d_test(getQuantizedOverlapping(quantizedTree, AABB(Vector3(100, 0, 0), Vector3(101, 1, 1))).empty());
+
+            // Raycast
+            DynamicTreeRaycastCallback dynamicCallback;
+            DynamicTreeRaycastCallback quantizedCallback;
+            const Ray ray(Vector3(-5, decimal(0.5), decimal(0.5)), Vector3(40, decimal(0.5), decimal(0.5)));
+            tree.raycast(ray, dynamicCallback);
+            quantizedTree.raycast(ray, quantizedCallback);
+            rp3d_test(dynamicCallback.mHitNodes.size() > 0);
+            rp3d_test(dynamicCallback.mHitNodes.size() == quantizedCallback.mHitNodes.size());
+            for (size_t i=0; i < quantizedCallback.mHitNodes.size(); i++) {
+                rp3d_test(dynamicCallback.isHit(quantizedTree.getSourceNodeID(quantizedCallback.mHitNodes[i])));
+            }
+
+            // The tree can be built again after the source tree has been modified
+            tree.removeObject(objectIds[0]);
+            quantizedTree.build(tree);
+            rp3d_test(quantizedTree.getNbNodes() == 2 * 255 - 1);
+            const std::vector<int> sourceNodeIds = getQuantizedOverlapping(quantizedTree, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50)));
+            rp3d_test(sourceNodeIds.size() == 255);
+            rp3d_test(std::find(sourceNodeIds.begin(), sourceNodeIds.end(), objectIds[0]) == sourceNodeIds.end());
+        }
+        void testWideTree() {
+
+            rp3d_test(sizeof(WideTreeNode) == 64);
+
+            DynamicAABBTree tree(mAllocator);
+            QuantizedAABBTree quantizedTree(mAllocator);
+            WideAABBTree wideTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+            quantizedTree.setProfiler(mProfiler);
+            wideTree.setProfiler(mProfiler);
+#endif
+
+            // The wide copy of an empty tree is empty
+            wideTree.build(tree);
+            rp3d_test(wideTree.getNbNodes() == 0);
+            rp3d_test(wideTree.getNbLeaves() == 0);
+            rp3d_test(getQuantizedOverlapping(wideTree, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50))).empty());
+
+            // A tree with a single object has a single node with one child
+            const int32 singleObjectId = tree.addObject(AABB(Vector3(1, 1, 1), Vector3(2, 2, 2)), 7, 8);
+            wideTree.build(tree);
+            rp3d_test(wideTree.getNbNodes() == 1);
+            rp3d_test(wideTree.getNbLeaves() == 1);
+            rp3d_test(getQuantizedOverlapping(wideTree, AABB(Vector3(0, 0, 0), Vector3(decimal(1.5), decimal(1.5), decimal(1.5)))).size() == 1);
+            rp3d_test(getQuantizedOverlapping(wideTree, AABB(Vector3(3, 3, 3), Vector3(4, 4, 4))).empty());
+            DynamicTreeRaycastCallback singleCallback;
+            wideTree.raycast(Ray(Vector3(-5, decimal(1.5), decimal(1.5)), Vector3(5, decimal(1.5), decimal(1.5))), singleCallback);
+            rp3d_test(singleCallback.mHitNodes.size() == 1);
+            rp3d_test(wideTree.getNodeDataInt(0)[0] == 7 && wideTree.getNodeDataInt(0)[1] == 8);
+            tree.removeObject(singleObjectId);
+
+            std::vector<int> objectIds;
+            std::vector<AABB> objectAABBs;
+            for (int i=0; i < 256; i++) {
+                const int x = (i * 37) % 16;
+                const int z = (i * 101) % 256 / 16;
+                const Vector3 min(decimal(x * 2), decimal(i % 3) * decimal(0.7), decimal(z * 2.1));
+                const AABB aabb(min, min + Vector3(decimal(1.3), 1, decimal(0.9)));
+                objectIds.push_back(tree.addObject(aabb, i, 2 * i));
+                objectAABBs.push_back(aabb);
+            }
+
+            quantizedTree.build(tree);
+            wideTree.build(tree);
+
+            // A node has at most four children so the wide tree has at least 255 / 3 internal nodes
+            rp3d_test(wideTree.getNbLeaves() == 256);
+            rp3d_test(wideTree.getNbNodes() >= 85 && wideTree.getNbNodes() < 255);
+            rp3d_test(wideTree.getNodesSizeInBytes() < quantizedTree.getNodesSizeInBytes());
+            rp3d_test(approxEqual(wideTree.getRootAABB().getMin(), tree.getRootAABB().getMin()));
+            rp3d_test(approxEqual(wideTree.getRootAABB().getMax(), tree.getRootAABB().getMax()));
+
+            // Each leaf keeps the data of its node in the source tree
+            Array<int> allNodes(mAllocator);
+            wideTree.reportAllShapesOverlappingWithAABB(AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50)), allNodes);
+            rp3d_test(allNodes.size() == 256);
+            for (uint32 i=0; i < allNodes.size(); i++) {
+                const int32 sourceNodeId = wideTree.getSourceNodeID(allNodes[i]);
+                const int objectIndex = static_cast<int>(std::find(objectIds.begin(), objectIds.end(), sourceNodeId) - objectIds.begin());
+                rp3d_test(objectIndex < 256);
+                rp3d_test(wideTree.getNodeDataInt(allNodes[i])[0] == objectIndex);
+                rp3d_test(wideTree.getNodeDataInt(allNodes[i])[1] == 2 * objectIndex);
+            }
+
+            const decimal margin = decimal(0.01);
+            rp3d_test(isQuantizedOverlappingValid(wideTree, objectIds, objectAABBs, AABB(Vector3(2, 0, 2), Vector3(6, 1, 9)), margin));
+            rp3d_test(isQuantizedOverlappingValid(wideTree, objectIds, objectAABBs, AABB(Vector3(3.3, 0.5, 0.9), Vector3(3.31, 0.6, 0.95)), margin));
+            rp3d_test(isQuantizedOverlappingValid(wideTree, objectIds, objectAABBs, AABB(Vector3(-10, -10, -10), Vector3(1, 1, 1)), margin));
+            rp3d_test(getQuantizedOverlapping(wideTree, AABB(Vector3(100, 0, 0), Vector3(101, 1, 1))).empty());
+
+            // The leaves are quantized as in the quantized tree so the same leaves are hit by a ray
+            const Ray rays[] = {Ray(Vector3(-5, decimal(0.5), decimal(0.5)), Vector3(40, decimal(0.5), decimal(0.5))),
+                                Ray(Vector3(-5, -5, -5), Vector3(40, 10, 40)),
+                                Ray(Vector3(10, 20, 10), Vector3(10, -20, 10)),
+                                Ray(Vector3(40, 1, 3), Vector3(-3, 1, 3), decimal(0.5))};
+            for (const Ray& ray : rays) {
+
+                DynamicTreeRaycastCallback quantizedCallback;
+                DynamicTreeRaycastCallback wideCallback;
+                quantizedTree.raycast(ray, quantizedCallback);
+                wideTree.raycast(ray, wideCallback);
+                rp3d_test(quantizedCallback.mHitNodes.size() == wideCallback.mHitNodes.size());
+                for (size_t i=0; i < wideCallback.mHitNodes.size(); i++) {
+
+                    const int32 sourceNodeId = wideTree.getSourceNodeID(wideCallback.mHitNodes[i]);
+                    bool isHit = false;
+                    for (size_t j=0; j < quantizedCallback.mHitNodes.size(); j++) {
+                        isHit |= quantizedTree.getSourceNodeID(quantizedCallback.mHitNodes[j]) == sourceNodeId;
+                    }
+                    rp3d_test(isHit);
+                }
+            }
+
+            // The tree can be built again after the source tree has been modified
+            tree.removeObject(objectIds[0]);
+            wideTree.build(tree);
+            rp3d_test(wideTree.getNbLeaves() == 255);
+            const std::vector<int> sourceNodeIds = getQuantizedOverlapping(wideTree, AABB(Vector3(-50, -50, -50), Vector3(50, 50, 50)));
+            rp3d_test(sourceNodeIds.size() == 255);
+            rp3d_test(std::find(sourceNodeIds.begin(), sourceNodeIds.end(), objectIds[0]) == sourceNodeIds.end());
+        }
+ 
+        /// Return true if all the source nodes hit by a ray in the dynamic tree are also hit in a quantized tree
+        template<typename QuantizedTree>
+        bool isQuantizedRaycastConservative(const DynamicAABBTree& tree, const QuantizedTree& quantizedTree, const Ray& ray) {
+
+            DynamicTreeRaycastCallback dynamicCallback;
+            DynamicTreeRaycastCallback quantizedCallback;
+            tree.raycast(ray, dynamicCallback);
+            quantizedTree.raycast(ray, quantizedCallback);
+
+            for (size_t i=0; i < dynamicCallback.mHitNodes.size(); i++) {
+
+                bool isHit = false;
+                for (size_t j=0; j < quantizedCallback.mHitNodes.size(); j++) {
+                    isHit |= quantizedTree.getSourceNodeID(quantizedCallback.mHitNodes[j]) == dynamicCallback.mHitNodes[i];
+                }
+                if (!isHit) return false;
+            }
+
+            return true;
+        }
+
+        void testQuantizedTreesFarFromOrigin() {
+
+            DynamicAABBTree tree(mAllocator);
+            QuantizedAABBTree quantizedTree(mAllocator);
+            WideAABBTree wideTree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            tree.setProfiler(mProfiler);
+            quantizedTree.setProfiler(mProfiler);
+            wideTree.setProfiler(mProfiler);
+#endif
+
+            // AABBs of the triangles of a small mesh that is far from the origin. The coordinates
+            // of the mesh are much larger than its extent so the dequantized coordinates of the
+            // nodes are rounded with a precision that is much coarser than the quantization step.
+            const Vector3 meshOrigin(decimal(100000.3), decimal(5000.7), decimal(-100000.1));
+            std::vector<AABB> triangleAABBs;
+            for (int i=0; i < 20; i++) {
+                for (int j=0; j < 20; j++) {
+
+                    const Vector3 min = meshOrigin + Vector3(decimal(i * 1.03), decimal((i + j) % 3) * decimal(0.01), decimal(j * 0.97));
+                    const AABB aabb(min, min + Vector3(decimal(1.03), decimal(0.02), decimal(0.97)));
+                    tree.addObject(aabb, i, j);
+                    triangleAABBs.push_back(aabb);
+                }
+            }
+
+            quantizedTree.build(tree);
+            wideTree.build(tree);
+
+            // Vertical rays through the exact corners of the AABBs must hit at least the same
+            // AABBs in the quantized trees as in the dynamic tree
+            bool isQuantizedTreeConservative = true;
+            bool isWideTreeConservative = true;
+            for (size_t i=0; i < triangleAABBs.size(); i += 3) {
+
+                const Vector3 corners[] = {triangleAABBs[i].getMin(), triangleAABBs[i].getMax()};
+                for (const Vector3& corner : corners) {
+
+                    const Ray ray(Vector3(corner.x, meshOrigin.y + 10, corner.z), Vector3(corner.x, meshOrigin.y - 10, corner.z));
+                    isQuantizedTreeConservative &= isQuantizedRaycastConservative(tree, quantizedTree, ray);
+                    isWideTreeConservative &= isQuantizedRaycastConservative(tree, wideTree, ray);
+                }
+            }
+            rp3d_test(isQuantizedTreeConservative);
+            rp3d_test(isWideTreeConservative);
+
+            // The same for horizontal rays along the top faces of the AABBs
+            for (size_t i=0; i < triangleAABBs.size(); i += 7) {
+
+                const Vector3& max = triangleAABBs[i].getMax();
+                const Ray ray(Vector3(meshOrigin.x - 5, max.y, max.z), Vector3(meshOrigin.x + 30, max.y, max.z));
+                rp3d_test(isQuantizedRaycastConservative(tree, quantizedTree, ray));
+                rp3d_test(isQuantizedRaycastConservative(tree, wideTree, ray));
+            }
+        }
+ 
+        void testFatAABBMargins() {
+
+            DynamicAABBTree tree(mAllocator, decimal(0.08));
+#ifdef IS_RP3D_PROFILING_ENABLED
+            tree.setProfiler(mProfiler);
+#endif
+
+            const decimal epsilon = decimal(0.0001);
+            int objectData = 3;
+
+            // Without margins, the fat AABB is inflated by a percentage of its size
+            int smallObjectId = tree.addObject(AABB(Vector3(0, 0, 0), Vector3(1, 1, 1)), &objectData);
+            rp3d_test(approxEqual(tree.getFatAABB(smallObjectId).getMin(), Vector3(decimal(-0.04), decimal(-0.04), decimal(-0.04)), epsilon));
+            rp3d_test(approxEqual(tree.getFatAABB(smallObjectId).getMax(), Vector3(decimal(1.04), decimal(1.04), decimal(1.04)), epsilon));
+
+            // The displacement is ignored without displacement factor
+            rp3d_test(tree.updateObject(smallObjectId, AABB(Vector3(2, 0, 0), Vector3(3, 1, 1)), false, Vector3(1, 0, 0)));
+            rp3d_test(approxEqual(tree.getFatAABB(smallObjectId).getMax(), Vector3(decimal(3.04), decimal(1.04), decimal(1.04)), epsilon));
+
+            tree.setFatAABBMargins(decimal(0.1), decimal(1.0), decimal(4.0));
+
+            // The inflation is clamped between the minimum and maximum margins
+            int largeObjectId = tree.addObject(AABB(Vector3(0, 0, 0), Vector3(50, 10, 1)), &objectData);
+            rp3d_test(approxEqual(tree.getFatAABB(largeObjectId).getMin(), Vector3(decimal(-1.0), decimal(-0.4), decimal(-0.1)), epsilon));
+            rp3d_test(approxEqual(tree.getFatAABB(largeObjectId).getMax(), Vector3(decimal(51.0), decimal(10.4), decimal(1.1)), epsilon));
+
+            // The fat AABB is extruded along the displacement (clamped to the maximum margin)
+            rp3d_test(tree.updateObject(smallObjectId, AABB(Vector3(4, 0, 0), Vector3(5, 1, 1)), false, Vector3(decimal(0.2), 0, -5)));
+            rp3d_test(approxEqual(tree.getFatAABB(smallObjectId).getMin(), Vector3(decimal(3.9), decimal(-0.1), decimal(-1.1)), epsilon));
+            rp3d_test(approxEqual(tree.getFatAABB(smallObjectId).getMax(), Vector3(decimal(5.9), decimal(1.1), decimal(1.1)), epsilon));
+
+            // The object stays in its fat AABB while it moves along its displacement
+            rp3d_test(!tree.updateObject(smallObjectId, AABB(Vector3(decimal(4.2), 0, -1), Vector3(decimal(5.2), 1, 0)), false, Vector3(decimal(0.2), 0, -5)));
+            rp3d_test(!tree.updateObject(smallObjectId, AABB(Vector3(decimal(4.8), 0, decimal(-1.05)), Vector3(decimal(5.8), 1, decimal(-0.05))), false, Vector3(decimal(0.2), 0, -5)));
+            rp3d_test(tree.updateObject(smallObjectId, AABB(Vector3(decimal(5.0), 0, -2), Vector3(decimal(6.0), 1, -1)), false, Vector3(decimal(0.2), 0, -5)));
+        }
+
+        /// Return the number of objects of a tree overlapping with a given AABB
+        uint32 getNbOverlappingObjects(const DynamicAABBTree& tree, const AABB& aabb) {
+
+            Array<int> overlappingNodes(mAllocator);
+            tree.reportAllShapesOverlappingWithAABB(aabb, overlappingNodes);
+            return static_cast<uint32>(overlappingNodes.size());
+        }
+
+        void testRestoreCorruptedSnapshot() {
+
+            DynamicAABBTree savedTree(mAllocator);
+            DynamicAABBTree tree(mAllocator);
+#ifdef IS_RP3D_PROFILING_ENABLED
+            savedTree.setProfiler(mProfiler);
+            tree.setProfiler(mProfiler);
+#endif
+
+            for (int i=0; i < 40; i++) {
+                savedTree.addObject(AABB(Vector3(decimal(i), 0, 0), Vector3(decimal(i + 0.5), 1, 1)), i, 0);
+            }
+            for (int i=0; i < 3; i++) {
+                tree.addObject(AABB(Vector3(0, decimal(i), 0), Vector3(1, decimal(i + 0.5), 1)), i, 0);
+            }
+            const AABB largeAABB(Vector3(-100, -100, -100), Vector3(100, 100, 100));
+
+            Array<uint8> data(mAllocator);
+            SnapshotWriter writer(data);
+            savedTree.saveSnapshot(writer);
+
+            // The number of allocated nodes (after the root and free node ids) is too large for the data
+            Array<uint8> corruptedData(data);
+            const int32 nbAllocatedNodes = 0x7FFFFFFF;
+            std::memcpy(&(corruptedData[2 * sizeof(int32)]), &nbAllocatedNodes, sizeof(int32));
+            SnapshotReader corruptedSkipReader(&(corruptedData[0]), static_cast<uint32>(corruptedData.size()));
+            rp3d_test(!tree.skipSnapshot(corruptedSkipReader));
+            SnapshotReader corruptedReader(&(corruptedData[0]), static_cast<uint32>(corruptedData.size()));
+            tree.restoreSnapshot(corruptedReader);
+            rp3d_test(getNbOverlappingObjects(tree, largeAABB) == 3);
+
+            // The last node is missing
+            const uint32 truncatedSize = static_cast<uint32>(data.size() - sizeof(TreeNode));
+            SnapshotReader truncatedSkipReader(&(data[0]), truncatedSize);
+            rp3d_test(!tree.skipSnapshot(truncatedSkipReader));
+            SnapshotReader truncatedReader(&(data[0]), truncatedSize);
+            tree.restoreSnapshot(truncatedReader);
+            rp3d_test(getNbOverlappingObjects(tree, largeAABB) == 3);
+
+            // The valid data is restored
+            SnapshotReader skipReader(&(data[0]), static_cast<uint32>(data.size()));
+            rp3d_test(tree.skipSnapshot(skipReader));
+            rp3d_test(skipReader.isAtEnd());
+            SnapshotReader reader(&(data[0]), static_cast<uint32>(data.size()));
+            tree.restoreSnapshot(reader);
+            rp3d_test(reader.isValid() && reader.isAtEnd());
+            rp3d_test(getNbOverlappingObjects(tree, largeAABB) == 40);
+        }
+};
 
 }
 
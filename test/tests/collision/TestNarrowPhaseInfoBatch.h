@@ -0,0 +1,272 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_NARROW_PHASE_INFO_BATCH_H
+#define TEST_NARROW_PHASE_INFO_BATCH_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/reactphysics3d.h>
+#include <reactphysics3d/collision/narrowphase/NarrowPhaseInfoBatch.h>
+#include <reactphysics3d/collision/narrowphase/CollisionDispatch.h>
+#include <reactphysics3d/components/ColliderComponents.h>
+#include <reactphysics3d/components/CollisionBodyComponents.h>
+#include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/engine/OverlappingPairs.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestNarrowPhaseInfoBatch
+/**
+ * Unit test for the NarrowPhaseInfoBatch class (items stored as a structure
+ * of arrays with their contact points in pools)
+ */
+class TestNarrowPhaseInfoBatch : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        DefaultAllocator mBaseAllocator;
+
+        MemoryManager mMemoryManager;
+
+        ColliderComponents mColliderComponents;
+
+        CollisionBodyComponents mCollisionBodyComponents;
+
+        RigidBodyComponents mRigidBodyComponents;
+
+        Set<bodypair> mNoCollisionPairs;
+
+        CollisionDispatch mCollisionDispatch;
+
+        OverlappingPairs mOverlappingPairs;
+
+        SphereShape* mSphereShape;
+
+        // ---------- Methods ---------- //
+
+        /// Add a given number of items into a batch
+        void addItems(NarrowPhaseInfoBatch& batch, uint32 nbItems) {
+
+            const uint32 firstItem = batch.getNbObjects();
+            for (uint32 i=firstItem; i < firstItem + nbItems; i++) {
+                batch.addNarrowPhaseInfo(i, Entity(2 * i, 0), Entity(2 * i + 1, 0), mSphereShape, mSphereShape,
+                                         Transform(Vector3(decimal(i), 0, 0), Quaternion::identity()), Transform::identity(),
+                                         i % 2 == 0, nullptr, mMemoryManager.getPoolAllocator());
+            }
+        }
+
+        /// Add a contact point into an item of a batch with a penetration depth that identifies it
+        static void addContactPoint(NarrowPhaseInfoBatch& batch, uint32 index, decimal penetrationDepth) {
+            batch.addContactPoint(index, Vector3(0, 1, 0), penetrationDepth, Vector3(penetrationDepth, 0, 0), Vector3(0, 0, penetrationDepth));
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestNarrowPhaseInfoBatch(const std::string& name)
+            : Test(name), mMemoryManager(&mBaseAllocator), mColliderComponents(mMemoryManager.getHeapAllocator()),
+              mCollisionBodyComponents(mMemoryManager.getHeapAllocator()), mRigidBodyComponents(mMemoryManager.getHeapAllocator()),
+              mNoCollisionPairs(mMemoryManager.getHeapAllocator()), mCollisionDispatch(mMemoryManager.getPoolAllocator()),
+              mOverlappingPairs(mMemoryManager, mColliderComponents, mCollisionBodyComponents, mRigidBodyComponents,
+                                mNoCollisionPairs, mCollisionDispatch) {
+
+            mSphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+        }
+
+        /// Run the tests
+        void run() {
+            testItems();
+            testSingleContactPointPool();
+            testContactPointPoolsPerRange();
+            testResetContactPoints();
+        }
+
+        void testItems() {
+
+            NarrowPhaseInfoBatch batch(mOverlappingPairs, mMemoryManager.getHeapAllocator());
+            rp3d_test(batch.getNbObjects() == 0);
+
+            // Add more items than the initial capacity of the batch
+            addItems(batch, 40);
+            rp3d_test(batch.getNbObjects() == 40);
+
+            // The data of the items is kept when the batch grows
+            bool isDataValid = true;
+            for (uint32 i=0; i < 40; i++) {
+                isDataValid &= batch.overlappingPairIds[i] == i;
+                isDataValid &= batch.colliderEntities1[i] == Entity(2 * i, 0);
+                isDataValid &= batch.colliderEntities2[i] == Entity(2 * i + 1, 0);
+                isDataValid &= batch.collisionShapes1[i] == mSphereShape && batch.collisionShapes2[i] == mSphereShape;
+                isDataValid &= batch.shape1ToWorldTransforms[i].getPosition() == Vector3(decimal(i), 0, 0);
+                isDataValid &= batch.reportContacts[i] == (i % 2 == 0);
+                isDataValid &= !batch.isColliding[i];
+                isDataValid &= batch.nbContactPoints[i] == 0;
+            }
+            rp3d_test(isDataValid);
+
+            batch.clear();
+            rp3d_test(batch.getNbObjects() == 0);
+
+            // The capacity of the previous frame is reserved again
+            batch.reserveMemory();
+            addItems(batch, 3);
+            rp3d_test(batch.getNbObjects() == 3);
+            rp3d_test(batch.overlappingPairIds[2] == 2);
+
+            batch.clear();
+        }
+
+        void testSingleContactPointPool() {
+
+            NarrowPhaseInfoBatch batch(mOverlappingPairs, mMemoryManager.getHeapAllocator());
+            addItems(batch, 4);
+
+            // The items without contact do not use any contact point
+            addContactPoint(batch, 1, decimal(0.1));
+            addContactPoint(batch, 1, decimal(0.2));
+            addContactPoint(batch, 3, decimal(0.3));
+
+            rp3d_test(batch.nbContactPoints[0] == 0);
+            rp3d_test(batch.nbContactPoints[1] == 2);
+            rp3d_test(batch.nbContactPoints[2] == 0);
+            rp3d_test(batch.nbContactPoints[3] == 1);
+
+            // The contact points of an item are contiguous in the pool
+            rp3d_test(batch.contactPointsIndices[1] == 0);
+            rp3d_test(batch.contactPointsIndices[3] == 2);
+
+            rp3d_test(approxEqual(batch.getContactPoint(1, 0).penetrationDepth, decimal(0.1)));
+            rp3d_test(approxEqual(batch.getContactPoint(1, 1).penetrationDepth, decimal(0.2)));
+            rp3d_test(approxEqual(batch.getContactPoint(3, 0).penetrationDepth, decimal(0.3)));
+            rp3d_test(batch.getContactPoint(3, 0).localPoint1 == Vector3(decimal(0.3), 0, 0));
+            rp3d_test(batch.getContactPoint(3, 0).localPoint2 == Vector3(0, 0, decimal(0.3)));
+            rp3d_test(batch.getContactPoint(3, 0).normal == Vector3(0, 1, 0));
+
+            // An item cannot have more than the maximum number of contact points
+            for (uint32 i=0; i < NB_MAX_CONTACT_POINTS_IN_NARROWPHASE_INFO + 4; i++) {
+                addContactPoint(batch, 2, decimal(1.0));
+            }
+            rp3d_test(batch.nbContactPoints[2] == NB_MAX_CONTACT_POINTS_IN_NARROWPHASE_INFO);
+            rp3d_test(batch.contactPointsIndices[2] == 3);
+
+            batch.clear();
+        }
+
+        void testContactPointPoolsPerRange() {
+
+            NarrowPhaseInfoBatch batch(mOverlappingPairs, mMemoryManager.getHeapAllocator());
+            addItems(batch, 7);
+
+            // Items [0, 3) use the pool 0, items [3, 6) the pool 1 and item 6 the pool 2
+            batch.setNbItemsPerContactPointPool(3);
+
+            // The ranges are tested in any order (as they would with several threads)
+            addContactPoint(batch, 6, decimal(0.6));
+            addContactPoint(batch, 4, decimal(0.4));
+            addContactPoint(batch, 4, decimal(0.41));
+            addContactPoint(batch, 1, decimal(0.1));
+            addContactPoint(batch, 5, decimal(0.5));
+            addContactPoint(batch, 2, decimal(0.2));
+            addContactPoint(batch, 2, decimal(0.21));
+
+            // The indices of the contact points are local to the pool of their range
+            rp3d_test(batch.contactPointsIndices[1] == 0);
+            rp3d_test(batch.contactPointsIndices[2] == 1);
+            rp3d_test(batch.contactPointsIndices[4] == 0);
+            rp3d_test(batch.contactPointsIndices[5] == 2);
+            rp3d_test(batch.contactPointsIndices[6] == 0);
+
+            rp3d_test(approxEqual(batch.getContactPoint(1, 0).penetrationDepth, decimal(0.1)));
+            rp3d_test(approxEqual(batch.getContactPoint(2, 0).penetrationDepth, decimal(0.2)));
+            rp3d_test(approxEqual(batch.getContactPoint(2, 1).penetrationDepth, decimal(0.21)));
+            rp3d_test(approxEqual(batch.getContactPoint(4, 0).penetrationDepth, decimal(0.4)));
+            rp3d_test(approxEqual(batch.getContactPoint(4, 1).penetrationDepth, decimal(0.41)));
+            rp3d_test(approxEqual(batch.getContactPoint(5, 0).penetrationDepth, decimal(0.5)));
+            rp3d_test(approxEqual(batch.getContactPoint(6, 0).penetrationDepth, decimal(0.6)));
+
+            // After a clear, the next frame can use a single pool again
+            batch.clear();
+            addItems(batch, 2);
+            addContactPoint(batch, 1, decimal(0.7));
+            addContactPoint(batch, 0, decimal(0.8));
+            rp3d_test(batch.contactPointsIndices[1] == 0);
+            rp3d_test(batch.contactPointsIndices[0] == 1);
+            rp3d_test(approxEqual(batch.getContactPoint(0, 0).penetrationDepth, decimal(0.8)));
+
+            batch.clear();
+        }
+
+        void testResetContactPoints() {
+
+            NarrowPhaseInfoBatch batch(mOverlappingPairs, mMemoryManager.getHeapAllocator());
+            addItems(batch, 3);
+
+            addContactPoint(batch, 0, decimal(0.1));
+            addContactPoint(batch, 0, decimal(0.11));
+            addContactPoint(batch, 1, decimal(0.2));
+            addContactPoint(batch, 1, decimal(0.21));
+
+            // The points of the last item of the pool are removed from the pool
+            batch.resetContactPoints(1);
+            rp3d_test(batch.nbContactPoints[1] == 0);
+            addContactPoint(batch, 1, decimal(0.22));
+            rp3d_test(batch.contactPointsIndices[1] == 2);
+            rp3d_test(approxEqual(batch.getContactPoint(1, 0).penetrationDepth, decimal(0.22)));
+
+            // The points of an item that are not at the end of the pool are forgotten and
+            // its new points are added at the end of the pool
+            batch.resetContactPoints(0);
+            rp3d_test(batch.nbContactPoints[0] == 0);
+            addContactPoint(batch, 0, decimal(0.12));
+            rp3d_test(batch.nbContactPoints[0] == 1);
+            rp3d_test(batch.contactPointsIndices[0] == 3);
+            rp3d_test(approxEqual(batch.getContactPoint(0, 0).penetrationDepth, decimal(0.12)));
+
+            // The points of the other items are not modified
+            rp3d_test(batch.nbContactPoints[1] == 1);
+            rp3d_test(approxEqual(batch.getContactPoint(1, 0).penetrationDepth, decimal(0.22)));
+
+            // Resetting an item without contact points does nothing
+            batch.resetContactPoints(2);
+            rp3d_test(batch.nbContactPoints[2] == 0);
+            addContactPoint(batch, 2, decimal(0.3));
+            rp3d_test(batch.contactPointsIndices[2] == 4);
+
+            batch.clear();
+        }
+ };
+
+}
+
+#endif
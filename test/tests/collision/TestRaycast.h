@@ -92,6 +92,35 @@ class WorldRaycastCallback : public RaycastCallback {
         }
 };
 
+/// Class ClosestRaycastCallback
+class ClosestRaycastCallback : public RaycastCallback {
+
+    public:
+
+        decimal hitFraction;
+        Collider* collider;
+
+        ClosestRaycastCallback() {
+            reset();
+        }
+
+        virtual decimal notifyRaycastHit(const RaycastInfo& info) override {
+
+            if (collider == nullptr || info.hitFraction < hitFraction) {
+                hitFraction = info.hitFraction;
+                collider = info.collider;
+            }
+
+            // Clip the ray at the hit to only get the closer hits afterwards
+            return info.hitFraction;
+        }
+
+        void reset() {
+            hitFraction = decimal(0.0);
+            collider = nullptr;
+        }
+};
+
 // Class TestPointInside
 /**
  * Unit test for the CollisionBody::testPointInside() method.
@@ -327,6 +356,7 @@ class TestRaycast : public Test {
             testCompound();
             testConcaveMesh();
             testHeightField();
+            testRaycastBatch();
         }
 
         /// Test the Collider::raycast(), CollisionBody::raycast() and
@@ -1742,6 +1772,131 @@ class TestRaycast : public Test {
             mWorld->raycast(Ray(ray14.point1, ray14.point2, decimal(0.8)), &mCallback);
             rp3d_test(mCallback.isHit);
         }
+
+        /// Cast the rays of a batch one by one and compare their closest hit with the results of the batch
+        bool isBatchSameAsSingleRaycasts(PhysicsWorld* world, const std::vector<Ray>& rays, const std::vector<RaycastHit>& hits,
+                                         unsigned short raycastWithCategoryMaskBits) {
+
+            ClosestRaycastCallback callback;
+            for (size_t i=0; i < rays.size(); i++) {
+
+                callback.reset();
+                world->raycast(rays[i], &callback, raycastWithCategoryMaskBits);
+
+                if (callback.collider != hits[i].collider) return false;
+                if (hits[i].isHit() && !approxEqual(callback.hitFraction, hits[i].hitFraction, decimal(0.0001))) return false;
+            }
+
+            return true;
+        }
+
+        /// Test the PhysicsWorld::raycastBatch() method
+        void testRaycastBatch() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* pillarShape = mPhysicsCommon.createBoxShape(Vector3(1, 2, 1));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(1);
+
+            // Static colliders (static broad-phase tree)
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+            for (int i=0; i < 5; i++) {
+                for (int j=0; j < 5; j++) {
+                    RigidBody* pillar = world->createRigidBody(Transform(Vector3(decimal(i * 6 - 12), 2, decimal(j * 6 - 12)), Quaternion::identity()));
+                    pillar->setType(BodyType::STATIC);
+                    pillar->addCollider(pillarShape, Transform::identity());
+                }
+            }
+
+            // Colliders of collision bodies (dynamic broad-phase tree)
+            for (int i=0; i < 4; i++) {
+                for (int j=0; j < 4; j++) {
+                    CollisionBody* body = world->createCollisionBody(Transform(Vector3(decimal(i * 6 - 9), 6, decimal(j * 6 - 9)), Quaternion::identity()));
+                    Collider* collider = body->addCollider(sphereShape, Transform::identity());
+                    collider->setCollisionCategoryBits((i + j) % 2 == 0 ? CATEGORY1 : CATEGORY2);
+                }
+            }
+
+            // Coherent rays going down from a grid and rays going sideways (the number
+            // of rays is not a multiple of the size of a packet)
+            std::vector<Ray> rays;
+            for (int i=0; i < 1999; i++) {
+                const decimal x = decimal((i % 40) * 0.7 - 14);
+                const decimal z = decimal((i / 40) * 0.6 - 15);
+                const Vector3 origin(x, decimal(10 + (i % 3)), z);
+                if (i % 5 == 4) {
+                    rays.push_back(Ray(origin - Vector3(0, 7, 0), origin + Vector3(30, -7, decimal(std::sin(i * 0.1) * 10))));
+                }
+                else {
+                    rays.push_back(Ray(origin, origin + Vector3(decimal(std::cos(i * 0.3)), -15, decimal(std::sin(i * 0.3))), decimal(0.9)));
+                }
+            }
+            const uint32 nbRays = static_cast<uint32>(rays.size());
+            std::vector<RaycastHit> hits(nbRays);
+            std::vector<RaycastHit> anyHits(nbRays);
+
+            // The copies of the static tree are only built at the next update so the static
+            // tree is traversed before the update and its wide copy after the update
+            for (int k=0; k < 2; k++) {
+
+                // The closest hit of each ray must be the same as with a single raycast
+                world->raycastBatch(rays.data(), nbRays, hits.data());
+                rp3d_test(isBatchSameAsSingleRaycasts(world, rays, hits, 0xFFFF));
+
+                uint32 nbHits = 0;
+                uint32 nbSphereHits = 0;
+                for (uint32 i=0; i < nbRays; i++) {
+                    if (hits[i].isHit()) nbHits++;
+                    if (hits[i].collider != nullptr && hits[i].collider->getCollisionShape() == sphereShape) nbSphereHits++;
+                }
+                rp3d_test(nbHits > nbRays / 2);
+                rp3d_test(nbSphereHits > 0);
+
+                // A ray has any hit if and only if it has a closest hit
+                world->raycastBatch(rays.data(), nbRays, anyHits.data(), RaycastBatchMode::ANY_HIT);
+                bool isAnyHitValid = true;
+                for (uint32 i=0; i < nbRays; i++) {
+                    isAnyHitValid &= anyHits[i].isHit() == hits[i].isHit();
+                    isAnyHitValid &= !anyHits[i].isHit() || anyHits[i].hitFraction >= hits[i].hitFraction;
+                }
+                rp3d_test(isAnyHitValid);
+
+                // Filter the colliders with their category
+                world->raycastBatch(rays.data(), nbRays, hits.data(), RaycastBatchMode::CLOSEST_HIT, CATEGORY2);
+                rp3d_test(isBatchSameAsSingleRaycasts(world, rays, hits, CATEGORY2));
+                bool isCategoryValid = true;
+                for (uint32 i=0; i < nbRays; i++) {
+                    isCategoryValid &= !hits[i].isHit() || hits[i].collider->getCollisionCategoryBits() == CATEGORY2;
+                }
+                rp3d_test(isCategoryValid);
+
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The packets of rays give the same results on several threads
+            std::vector<RaycastHit> parallelHits(nbRays);
+            DefaultTaskScheduler* taskScheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+            world->raycastBatch(rays.data(), nbRays, hits.data());
+            world->setTaskScheduler(taskScheduler);
+            world->raycastBatch(rays.data(), nbRays, parallelHits.data());
+            bool isParallelSame = true;
+            for (uint32 i=0; i < nbRays; i++) {
+                isParallelSame &= parallelHits[i].collider == hits[i].collider && parallelHits[i].hitFraction == hits[i].hitFraction;
+            }
+            rp3d_test(isParallelSame);
+            world->setTaskScheduler(nullptr);
+            mPhysicsCommon.destroyDefaultTaskScheduler(taskScheduler);
+
+            // An empty batch does nothing
+            world->raycastBatch(rays.data(), 0, hits.data());
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+            mPhysicsCommon.destroyBoxShape(groundShape);
+            mPhysicsCommon.destroyBoxShape(pillarShape);
+            mPhysicsCommon.destroySphereShape(sphereShape);
+        }
 };
 
 }
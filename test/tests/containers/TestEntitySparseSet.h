@@ -0,0 +1,132 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_ENTITY_SPARSE_SET_H
+#define TEST_ENTITY_SPARSE_SET_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/containers/EntitySparseSet.h>
+#include <reactphysics3d/memory/DefaultAllocator.h>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestEntitySparseSet
+/**
+ * Unit test for the EntitySparseSet class
+ */
+class TestEntitySparseSet : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mAllocator;
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestEntitySparseSet(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+
+            testAddRemove();
+            testGenerations();
+        }
+
+        void testAddRemove() {
+
+            EntitySparseSet set(mAllocator);
+            rp3d_test(set.size() == 0);
+
+            const Entity entity1(0, 0);
+            const Entity entity2(5, 0);
+            const Entity entity3(1000, 0);
+
+            rp3d_test(!set.containsKey(entity1));
+            rp3d_test(!set.containsKey(entity3));
+
+            set.add(entity1, 3);
+            set.add(entity2, 0);
+            set.add(entity3, 7);
+            rp3d_test(set.size() == 3);
+            rp3d_test(set.containsKey(entity1));
+            rp3d_test(set.containsKey(entity2));
+            rp3d_test(set.containsKey(entity3));
+            rp3d_test(!set.containsKey(Entity(4, 0)));
+            rp3d_test(set[entity1] == 3);
+            rp3d_test(set[entity2] == 0);
+            rp3d_test(set[entity3] == 7);
+
+            uint32 componentIndex = 0;
+            rp3d_test(set.tryGetComponentIndex(entity3, componentIndex));
+            rp3d_test(componentIndex == 7);
+            rp3d_test(!set.tryGetComponentIndex(Entity(6, 0), componentIndex));
+
+            // Move an entity to another component index
+            set.remove(entity1);
+            rp3d_test(!set.containsKey(entity1));
+            rp3d_test(set.size() == 2);
+            set.add(entity1, 2);
+            rp3d_test(set[entity1] == 2);
+
+            set.remove(entity1);
+            set.remove(entity2);
+            set.remove(entity3);
+            rp3d_test(set.size() == 0);
+            rp3d_test(!set.containsKey(entity1));
+            rp3d_test(!set.containsKey(entity2));
+            rp3d_test(!set.containsKey(entity3));
+        }
+
+        void testGenerations() {
+
+            EntitySparseSet set(mAllocator);
+
+            const Entity oldEntity(12, 0);
+            const Entity newEntity(12, 1);
+
+            set.add(oldEntity, 4);
+            rp3d_test(set.containsKey(oldEntity));
+            rp3d_test(!set.containsKey(newEntity));
+
+            set.remove(oldEntity);
+            set.add(newEntity, 9);
+            rp3d_test(!set.containsKey(oldEntity));
+            rp3d_test(set.containsKey(newEntity));
+            rp3d_test(set[newEntity] == 9);
+            rp3d_test(set.size() == 1);
+        }
+ };
+
+}
+
+#endif
@@ -0,0 +1,227 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_CONTACT_SOLVER_H
+#define TEST_CONTACT_SOLVER_H
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestContactSolver
+/**
+ * Unit test for the wide (SIMD) contact solver
+ */
+class TestContactSolver : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        DefaultTaskScheduler* mTaskScheduler;
+
+        // ---------- Methods ---------- //
+
+        /// Create a world with boxes that are resting on the ground far from each other
+        PhysicsWorld* createBoxesWorld(std::vector<RigidBody*>& dynamicBodies, bool isWideContactSolverEnabled) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isWideContactSolverEnabled = isWideContactSolverEnabled;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            for (int i=0; i < 10; i++) {
+
+                const Vector3 position(decimal(i * 3), decimal(0.6), decimal(i % 2));
+                RigidBody* box = world->createRigidBody(Transform(position, Quaternion::fromEulerAngles(decimal(0.05 * i), decimal(0.2 * i), 0)));
+                box->addCollider(boxShape, Transform::identity());
+                box->setLinearVelocity(Vector3(decimal(0.3 * i), 0, decimal(-0.2)));
+                dynamicBodies.push_back(box);
+            }
+
+            return world;
+        }
+
+        /// Create a world with several stacks of boxes
+        PhysicsWorld* createStacksWorld(std::vector<RigidBody*>& dynamicBodies, bool isWideContactSolverEnabled) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isWideContactSolverEnabled = isWideContactSolverEnabled;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            for (int s=0; s < 5; s++) {
+                for (int b=0; b < 8; b++) {
+                    const Vector3 position(decimal(s * 3), decimal(0.5 + b * 1.01), decimal(0));
+                    RigidBody* box = world->createRigidBody(Transform(position, Quaternion::identity()));
+                    box->addCollider(boxShape, Transform::identity());
+                    dynamicBodies.push_back(box);
+                }
+            }
+
+            return world;
+        }
+
+        /// Return true if the transforms of the bodies of two worlds are exactly the same
+        static bool areTransformsSame(const std::vector<RigidBody*>& bodies1, const std::vector<RigidBody*>& bodies2) {
+
+            for (size_t i=0; i < bodies1.size(); i++) {
+                const Transform& t1 = bodies1[i]->getTransform();
+                const Transform& t2 = bodies2[i]->getTransform();
+                if (t1.getPosition() != t2.getPosition() || !(t1.getOrientation() == t2.getOrientation())) return false;
+            }
+
+            return true;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestContactSolver(const std::string& name) : Test(name) {
+
+            mTaskScheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+        }
+
+        /// Destructor
+        virtual ~TestContactSolver() {
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(mTaskScheduler);
+        }
+
+        /// Run the tests
+        void run() {
+            testWideSolverSettings();
+            testWideSolverSingleManifolds();
+            testWideSolverStacks();
+        }
+
+        void testWideSolverSettings() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+            rp3d_test(!world->isWideContactSolverEnabled());
+
+            world->enableWideContactSolver(true);
+            rp3d_test(world->isWideContactSolverEnabled());
+
+            world->enableWideContactSolver(false);
+            rp3d_test(!world->isWideContactSolverEnabled());
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isWideContactSolverEnabled = true;
+            world = mPhysicsCommon.createPhysicsWorld(settings);
+            rp3d_test(world->isWideContactSolverEnabled());
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testWideSolverSingleManifolds() {
+
+            std::vector<RigidBody*> bodiesScalar;
+            std::vector<RigidBody*> bodiesWide;
+            PhysicsWorld* worldScalar = createBoxesWorld(bodiesScalar, false);
+            PhysicsWorld* worldWide = createBoxesWorld(bodiesWide, true);
+
+            for (int i=0; i < 90; i++) {
+                worldScalar->update(decimal(1.0) / decimal(60.0));
+                worldWide->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // Each island contains a single contact manifold that is solved alone in its lane
+            // group so the wide solver must give exactly the same result as the scalar one
+            rp3d_test(areTransformsSame(bodiesScalar, bodiesWide));
+
+            // The boxes must rest on the ground
+            for (size_t i=0; i < bodiesWide.size(); i++) {
+                rp3d_test(approxEqual(bodiesWide[i]->getTransform().getPosition().y, decimal(0.5), decimal(0.05)));
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(worldScalar);
+            mPhysicsCommon.destroyPhysicsWorld(worldWide);
+        }
+
+        void testWideSolverStacks() {
+
+            std::vector<RigidBody*> bodiesScalar;
+            std::vector<RigidBody*> bodiesWide;
+            std::vector<RigidBody*> bodiesWideParallel;
+            PhysicsWorld* worldScalar = createStacksWorld(bodiesScalar, false);
+            PhysicsWorld* worldWide = createStacksWorld(bodiesWide, true);
+            PhysicsWorld* worldWideParallel = createStacksWorld(bodiesWideParallel, true);
+            worldWideParallel->setTaskScheduler(mTaskScheduler);
+
+            for (int i=0; i < 180; i++) {
+                worldScalar->update(decimal(1.0) / decimal(60.0));
+                worldWide->update(decimal(1.0) / decimal(60.0));
+                worldWideParallel->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The islands are solved independently so the parallel simulation must give
+            // exactly the same result as the serial one
+            rp3d_test(areTransformsSame(bodiesWide, bodiesWideParallel));
+
+            // The stacks must still be standing with both solvers. The contact manifolds are not
+            // solved in the same order so the results of the two solvers are slightly different.
+            for (size_t i=0; i < bodiesWide.size(); i++) {
+
+                const Vector3 expectedPosition(decimal((i / 8) * 3), decimal(0.5 + (i % 8)), decimal(0));
+                const Vector3& positionScalar = bodiesScalar[i]->getTransform().getPosition();
+                const Vector3& positionWide = bodiesWide[i]->getTransform().getPosition();
+                rp3d_test(approxEqual(positionScalar, expectedPosition, decimal(0.3)));
+                rp3d_test(approxEqual(positionWide, expectedPosition, decimal(0.3)));
+                rp3d_test(approxEqual(positionWide.y, positionScalar.y, decimal(0.2)));
+            }
+
+            worldWideParallel->setTaskScheduler(nullptr);
+
+            mPhysicsCommon.destroyPhysicsWorld(worldScalar);
+            mPhysicsCommon.destroyPhysicsWorld(worldWide);
+            mPhysicsCommon.destroyPhysicsWorld(worldWideParallel);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,263 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_OVERLAPPING_PAIRS_H
+#define TEST_OVERLAPPING_PAIRS_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/reactphysics3d.h>
+#include <reactphysics3d/collision/narrowphase/CollisionDispatch.h>
+#include <reactphysics3d/components/ColliderComponents.h>
+#include <reactphysics3d/components/CollisionBodyComponents.h>
+#include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/engine/OverlappingPairs.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <reactphysics3d/utils/Profiler.h>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestOverlappingPairs
+/**
+ * Unit test for the OverlappingPairs class (lookup of the pairs through slots with a generation)
+ */
+class TestOverlappingPairs : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        PhysicsWorld* mWorld;
+
+        SphereShape* mSphereShape;
+
+        /// Collider of the world used for its material
+        Collider* mCollider;
+
+        DefaultAllocator mBaseAllocator;
+
+        MemoryManager mMemoryManager;
+
+        ColliderComponents mColliderComponents;
+
+        CollisionBodyComponents mCollisionBodyComponents;
+
+        RigidBodyComponents mRigidBodyComponents;
+
+        Set<bodypair> mNoCollisionPairs;
+
+        CollisionDispatch mCollisionDispatch;
+
+        /// Indices of the colliders in the colliders components
+        uint32 mColliderIndices[4];
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+        Profiler* mProfiler;
+#endif
+
+        // ---------- Methods ---------- //
+
+        /// Return the index of the slot of a pair
+        static uint32 getSlotIndex(uint64 pairId) {
+            return static_cast<uint32>(pairId & 0xFFFFFFFF);
+        }
+
+        /// Return the generation of the slot of a pair
+        static uint32 getGeneration(uint64 pairId) {
+            return static_cast<uint32>(pairId >> 32);
+        }
+
+        /// Return true if an id refers to the pair between two given colliders
+        bool isPair(OverlappingPairs& pairs, uint64 pairId, uint32 collider1, uint32 collider2) {
+
+            const OverlappingPairs::OverlappingPair* pair = pairs.getOverlappingPair(pairId);
+            return pair != nullptr && pair->pairID == pairId &&
+                   pair->broadPhaseId1 == static_cast<int32>(collider1) && pair->broadPhaseId2 == static_cast<int32>(collider2);
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestOverlappingPairs(const std::string& name)
+            : Test(name), mMemoryManager(&mBaseAllocator), mColliderComponents(mMemoryManager.getHeapAllocator()),
+              mCollisionBodyComponents(mMemoryManager.getHeapAllocator()), mRigidBodyComponents(mMemoryManager.getHeapAllocator()),
+              mNoCollisionPairs(mMemoryManager.getHeapAllocator()), mCollisionDispatch(mMemoryManager.getPoolAllocator()) {
+
+            mWorld = mPhysicsCommon.createPhysicsWorld();
+            mSphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            CollisionBody* body = mWorld->createCollisionBody(Transform::identity());
+            mCollider = body->addCollider(mSphereShape, Transform::identity());
+
+            // Create four colliders with the broad-phase ids 0, 1, 2 and 3
+            const Transform transform = Transform::identity();
+            for (uint32 i=0; i < 4; i++) {
+
+                const Entity colliderEntity(i, 0);
+                ColliderComponents::ColliderComponent colliderComponent(Entity(10 + i, 0), nullptr, AABB(), transform,
+                                                                        mSphereShape, 0x0001, 0xFFFF, transform,
+                                                                        mCollider->getMaterial());
+                mColliderComponents.addComponent(colliderEntity, false, colliderComponent);
+                mColliderComponents.setBroadPhaseId(colliderEntity, static_cast<int32>(i));
+                mColliderIndices[i] = mColliderComponents.getEntityIndex(colliderEntity);
+            }
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            mProfiler = new Profiler();
+            mCollisionDispatch.setProfiler(mProfiler);
+#endif
+
+        }
+
+        /// Destructor
+        virtual ~TestOverlappingPairs() {
+
+            for (uint32 i=0; i < 4; i++) {
+                mColliderComponents.removeComponent(Entity(i, 0));
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(mWorld);
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+            delete mProfiler;
+#endif
+
+        }
+
+        /// Run the tests
+        void run() {
+            testAddAndRemovePairs();
+            testReuseOfFreeSlots();
+        }
+
+        void testAddAndRemovePairs() {
+
+            OverlappingPairs pairs(mMemoryManager, mColliderComponents, mCollisionBodyComponents, mRigidBodyComponents,
+                                   mNoCollisionPairs, mCollisionDispatch);
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+            pairs.setProfiler(mProfiler);
+#endif
+
+            const uint64 pair01 = pairs.addPair(mColliderIndices[0], mColliderIndices[1], true);
+            const uint64 pair02 = pairs.addPair(mColliderIndices[0], mColliderIndices[2], true);
+            const uint64 pair13 = pairs.addPair(mColliderIndices[1], mColliderIndices[3], true);
+
+            // A new slot is created for each pair
+            rp3d_test(getSlotIndex(pair01) == 0 && getSlotIndex(pair02) == 1 && getSlotIndex(pair13) == 2);
+            rp3d_test(getGeneration(pair01) == 0 && getGeneration(pair02) == 0 && getGeneration(pair13) == 0);
+
+            rp3d_test(isPair(pairs, pair01, 0, 1));
+            rp3d_test(isPair(pairs, pair02, 0, 2));
+            rp3d_test(isPair(pairs, pair13, 1, 3));
+
+            rp3d_test(pairs.findOverlappingPair(mColliderIndices[1], mColliderIndices[0])->pairID == pair01);
+            rp3d_test(pairs.findOverlappingPair(mColliderIndices[3], mColliderIndices[1])->pairID == pair13);
+            rp3d_test(pairs.findOverlappingPair(mColliderIndices[2], mColliderIndices[3]) == nullptr);
+
+            // The last pair is moved into the place of the removed one and can still be found with its id
+            pairs.removePair(pair02);
+            rp3d_test(pairs.getOverlappingPair(pair02) == nullptr);
+            rp3d_test(pairs.findOverlappingPair(mColliderIndices[0], mColliderIndices[2]) == nullptr);
+            rp3d_test(isPair(pairs, pair01, 0, 1));
+            rp3d_test(isPair(pairs, pair13, 1, 3));
+            rp3d_test(mColliderComponents.getOverlappingPairs(Entity(2, 0)).size() == 0);
+
+            pairs.removePair(pair01);
+            pairs.removePair(pair13);
+            rp3d_test(pairs.getOverlappingPair(pair01) == nullptr);
+            rp3d_test(pairs.getOverlappingPair(pair13) == nullptr);
+            rp3d_test(mColliderComponents.getOverlappingPairs(Entity(1, 0)).size() == 0);
+        }
+
+        void testReuseOfFreeSlots() {
+
+            OverlappingPairs pairs(mMemoryManager, mColliderComponents, mCollisionBodyComponents, mRigidBodyComponents,
+                                   mNoCollisionPairs, mCollisionDispatch);
+
+#ifdef IS_RP3D_PROFILING_ENABLED
+            pairs.setProfiler(mProfiler);
+#endif
+
+            const uint64 pair01 = pairs.addPair(mColliderIndices[0], mColliderIndices[1], true);
+            const uint64 pair02 = pairs.addPair(mColliderIndices[0], mColliderIndices[2], true);
+            const uint64 pair03 = pairs.addPair(mColliderIndices[0], mColliderIndices[3], true);
+
+            // The slot of a removed pair is reused by the next pair with a new generation
+            pairs.removePair(pair02);
+            const uint64 pair23 = pairs.addPair(mColliderIndices[2], mColliderIndices[3], true);
+            rp3d_test(getSlotIndex(pair23) == getSlotIndex(pair02));
+            rp3d_test(getGeneration(pair23) == getGeneration(pair02) + 1);
+            rp3d_test(pair23 != pair02);
+
+            // The id of the removed pair does not refer to the new pair of its slot
+            rp3d_test(pairs.getOverlappingPair(pair02) == nullptr);
+            rp3d_test(isPair(pairs, pair23, 2, 3));
+
+            // The last released slot is reused first and no new slot is created while there are free slots
+            pairs.removePair(pair01);
+            pairs.removePair(pair03);
+            const uint64 pair12 = pairs.addPair(mColliderIndices[1], mColliderIndices[2], true);
+            const uint64 pair13 = pairs.addPair(mColliderIndices[1], mColliderIndices[3], true);
+            const uint64 pair01Again = pairs.addPair(mColliderIndices[0], mColliderIndices[1], true);
+            rp3d_test(getSlotIndex(pair12) == getSlotIndex(pair03));
+            rp3d_test(getSlotIndex(pair13) == getSlotIndex(pair01));
+            rp3d_test(getSlotIndex(pair01Again) == 3);
+            rp3d_test(getGeneration(pair12) == 1 && getGeneration(pair13) == 1 && getGeneration(pair01Again) == 0);
+
+            // A pair between the same colliders as a removed pair gets a new id
+            rp3d_test(pair01Again != pair01);
+            rp3d_test(pairs.getOverlappingPair(pair01) == nullptr);
+            rp3d_test(pairs.getOverlappingPair(pair03) == nullptr);
+            rp3d_test(isPair(pairs, pair12, 1, 2));
+            rp3d_test(isPair(pairs, pair13, 1, 3));
+            rp3d_test(isPair(pairs, pair01Again, 0, 1));
+            rp3d_test(isPair(pairs, pair23, 2, 3));
+
+            // A slot released several times keeps increasing its generation
+            pairs.removePair(pair23);
+            const uint64 pair02Again = pairs.addPair(mColliderIndices[0], mColliderIndices[2], true);
+            rp3d_test(getSlotIndex(pair02Again) == getSlotIndex(pair02));
+            rp3d_test(getGeneration(pair02Again) == 2);
+            rp3d_test(pairs.getOverlappingPair(pair23) == nullptr);
+            rp3d_test(isPair(pairs, pair02Again, 0, 2));
+
+            pairs.removePair(pair12);
+            pairs.removePair(pair13);
+            pairs.removePair(pair01Again);
+            pairs.removePair(pair02Again);
+        }
+ };
+
+}
+
+#endif
@@ -146,6 +146,12 @@ class TestRigidBody : public Test {
             testGettersSetters();
             testMassPropertiesMethods();
             testApplyForcesAndTorques();
+            testBulkCreationAndDestruction();
+            testStaticBodiesBroadPhase();
+            testCollidersOfMovedBodies();
+            testPredictiveFatAABBs();
+            testIslands();
+            testIslandsUpdatedWithoutLostContacts();
         }
 
         void testGettersSetters() {
@@ -311,6 +317,408 @@ class TestRigidBody : public Test {
             mRigidBody3->resetForce();
             mRigidBody3->resetTorque();
         }
+
+        void testBulkCreationAndDestruction() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            RigidBody* ground = world->createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(mPhysicsCommon.createBoxShape(Vector3(20, 1, 20)), Transform::identity());
+
+            // Create the bodies of a grid of boxes at once
+            const uint32 nbBodies = 100;
+            Transform transforms[nbBodies];
+            for (uint32 i=0; i < nbBodies; i++) {
+                transforms[i].setPosition(Vector3(decimal(i % 10) * 2 - 10, decimal(2), decimal(i / 10) * 2 - 10));
+            }
+            RigidBody* bodies[nbBodies];
+            world->createRigidBodies(transforms, nbBodies, bodies);
+            rp3d_test(world->getNbRigidBodies() == nbBodies + 1);
+            rp3d_test(world->getRigidBody(1) == bodies[0]);
+            rp3d_test(bodies[55]->getTransform().getPosition() == transforms[55].getPosition());
+
+            // Add two colliders to each body at once
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            RigidBody* colliderBodies[2 * nbBodies];
+            CollisionShape* colliderShapes[2 * nbBodies];
+            Transform colliderTransforms[2 * nbBodies];
+            for (uint32 i=0; i < 2 * nbBodies; i++) {
+                colliderBodies[i] = bodies[i / 2];
+                colliderShapes[i] = boxShape;
+                colliderTransforms[i].setPosition(Vector3(0, decimal(i % 2), 0));
+            }
+            Collider* colliders[2 * nbBodies];
+            world->addColliders(colliderBodies, colliderShapes, colliderTransforms, 2 * nbBodies, colliders);
+            rp3d_test(bodies[10]->getNbColliders() == 2);
+            rp3d_test(bodies[10]->getCollider(1) == colliders[21]);
+            rp3d_test(colliders[21]->getBody() == bodies[10]);
+            rp3d_test(colliders[21]->getBroadPhaseId() != -1);
+            for (uint32 i=0; i < nbBodies; i++) {
+                bodies[i]->updateMassPropertiesFromColliders();
+            }
+
+            // The bodies must fall on the ground
+            for (int i=0; i < 120; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(bodies[0]->getTransform().getPosition().y > decimal(1.2));
+            rp3d_test(bodies[99]->getTransform().getPosition().y > decimal(1.2));
+            rp3d_test(bodies[99]->getTransform().getPosition().y < decimal(1.8));
+
+            // Destroy every other body at once
+            RigidBody* bodiesToDestroy[nbBodies / 2];
+            for (uint32 i=0; i < nbBodies / 2; i++) {
+                bodiesToDestroy[i] = bodies[2 * i];
+            }
+            world->destroyRigidBodies(bodiesToDestroy, nbBodies / 2);
+            rp3d_test(world->getNbRigidBodies() == nbBodies / 2 + 1);
+            rp3d_test(world->getRigidBody(0) == ground);
+            rp3d_test(world->getRigidBody(1) == bodies[1]);
+            rp3d_test(world->getRigidBody(50) == bodies[99]);
+
+            // Rebuild the broad-phase trees after the destruction of many bodies
+            world->rebuildBroadPhaseTrees();
+            rp3d_test(world->getBroadPhaseDynamicTreeCost() > decimal(1.0));
+            rp3d_test(world->getBroadPhaseStaticTreeCost() == decimal(0.0));
+
+            for (int i=0; i < 10; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(bodies[99]->getTransform().getPosition().y > decimal(1.2));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testStaticBodiesBroadPhase() {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            // Static ground
+            RigidBody* ground = world->createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(mPhysicsCommon.createBoxShape(Vector3(10, 1, 10)), Transform::identity());
+
+            // Static box overlapping with the ground
+            RigidBody* staticBox = world->createRigidBody(Transform(Vector3(4, 1, 0), Quaternion::identity()));
+            staticBox->setType(BodyType::STATIC);
+            staticBox->addCollider(boxShape, Transform::identity());
+
+            // Dynamic box falling on the ground
+            RigidBody* box1 = world->createRigidBody(Transform(Vector3(0, 3, 0), Quaternion::identity()));
+            box1->addCollider(boxShape, Transform::identity());
+
+            for (int i=0; i < 120; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(box1->getTransform().getPosition().y > decimal(1.3));
+            rp3d_test(box1->getTransform().getPosition().y < decimal(1.7));
+            rp3d_test(world->testOverlap(box1, ground));
+
+            // The first box becomes static and a second box falls on it
+            box1->setType(BodyType::STATIC);
+            box1->setTransform(Transform(Vector3(0, decimal(1.5), 0), Quaternion::identity()));
+            RigidBody* box2 = world->createRigidBody(Transform(Vector3(0, 4, 0), Quaternion::identity()));
+            box2->addCollider(boxShape, Transform::identity());
+
+            for (int i=0; i < 120; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(box2->getTransform().getPosition().y > decimal(2.3));
+            rp3d_test(box2->getTransform().getPosition().y < decimal(2.7));
+
+            // A static body moved by the user is updated in the broad-phase
+            staticBox->setTransform(Transform(Vector3(-4, 5, 0), Quaternion::identity()));
+            RigidBody* box3 = world->createRigidBody(Transform(Vector3(-4, 7, 0), Quaternion::identity()));
+            box3->addCollider(boxShape, Transform::identity());
+
+            // The first box becomes dynamic again
+            box1->setType(BodyType::DYNAMIC);
+
+            for (int i=0; i < 120; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(box1->getTransform().getPosition().y > decimal(1.3));
+            rp3d_test(box1->getTransform().getPosition().y < decimal(1.7));
+            rp3d_test(box2->getTransform().getPosition().y > decimal(2.3));
+            rp3d_test(box3->getTransform().getPosition().y > decimal(5.8));
+            rp3d_test(box3->getTransform().getPosition().y < decimal(6.2));
+
+            // A ray hits the colliders of both broad-phase trees
+            struct CountRaycastCallback : public RaycastCallback {
+                int nbHits = 0;
+                decimal notifyRaycastHit(const RaycastInfo& /*info*/) override {
+                    nbHits++;
+                    return decimal(1.0);
+                }
+            } raycastCallback;
+            world->raycast(Ray(Vector3(-4, 20, 0), Vector3(-4, -20, 0)), &raycastCallback);
+            rp3d_test(raycastCallback.nbHits == 3);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testCollidersOfMovedBodies() {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.isSleepingEnabled = false;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            const Transform colliderTransform(Vector3(0, 1, 0), Quaternion::identity());
+
+            // Kinematic body at rest
+            RigidBody* restingBody = world->createRigidBody(Transform(Vector3(10, 0, 0), Quaternion::identity()));
+            restingBody->setType(BodyType::KINEMATIC);
+            Collider* restingCollider = restingBody->addCollider(boxShape, colliderTransform);
+
+            // Kinematic body moving along the x axis
+            RigidBody* movingBody = world->createRigidBody(Transform(Vector3(0, 0, 0), Quaternion::identity()));
+            movingBody->setType(BodyType::KINEMATIC);
+            movingBody->setLinearVelocity(Vector3(6, 0, 0));
+            movingBody->setAngularVelocity(Vector3(0, 1, 0));
+            Collider* movingCollider = movingBody->addCollider(boxShape, colliderTransform);
+
+            // Dynamic body falling
+            RigidBody* fallingBody = world->createRigidBody(Transform(Vector3(-10, 0, 0), Quaternion::identity()));
+            Collider* fallingCollider = fallingBody->addCollider(boxShape, colliderTransform);
+
+            const Transform restingTransform = restingBody->getTransform();
+
+            for (int i=0; i < 60; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The transform of the body at rest has not changed
+            rp3d_test(restingBody->getTransform() == restingTransform);
+            rp3d_test(approxEqual(restingCollider->getWorldAABB().getMin(), Vector3(decimal(9.5), decimal(0.5), decimal(-0.5)), decimal(0.0001)));
+
+            // The colliders of the moving bodies follow their body
+            rp3d_test(approxEqual(movingBody->getTransform().getPosition().x, decimal(6.0), decimal(0.01)));
+            rp3d_test(fallingBody->getTransform().getPosition().y < decimal(-3.0));
+            RigidBody* bodies[] = {movingBody, fallingBody};
+            Collider* colliders[] = {movingCollider, fallingCollider};
+            for (int b=0; b < 2; b++) {
+
+                const Transform expectedTransform = bodies[b]->getTransform() * colliderTransform;
+                const Transform colliderLocalToWorld = colliders[b]->getLocalToWorldTransform();
+                rp3d_test(approxEqual(colliderLocalToWorld.getPosition(), expectedTransform.getPosition(), decimal(0.0001)));
+
+                AABB expectedAABB;
+                boxShape->computeAABB(expectedAABB, expectedTransform);
+                rp3d_test(approxEqual(colliders[b]->getWorldAABB().getMin(), expectedAABB.getMin(), decimal(0.0001)));
+                rp3d_test(approxEqual(colliders[b]->getWorldAABB().getMax(), expectedAABB.getMax(), decimal(0.0001)));
+            }
+
+            // The moving body hits the body at rest and then leaves it
+            rp3d_test(!world->testOverlap(movingBody, restingBody));
+            movingBody->setAngularVelocity(Vector3(0, 0, 0));
+            for (int i=0; i < 40; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(world->testOverlap(movingBody, restingBody));
+            for (int i=0; i < 40; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+            rp3d_test(!world->testOverlap(movingBody, restingBody));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        /// Simulate small fast bodies and return the total number of broad-phase reinsertions
+        uint32 simulateFastBodies(bool isFatAABBPredictive, uint32& outNbUpdatedColliders) {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.gravity = Vector3(0, 0, 0);
+            settings.isBroadPhaseFatAABBPredictive = isFatAABBPredictive;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+            rp3d_test(world->isBroadPhaseFatAABBPredictive() == isFatAABBPredictive);
+
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.05));
+
+            // Static ground that is never updated
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -5, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(mPhysicsCommon.createBoxShape(Vector3(50, 1, 50)), Transform::identity());
+
+            for (int i=0; i < 10; i++) {
+                RigidBody* body = world->createRigidBody(Transform(Vector3(0, decimal(i), 0), Quaternion::identity()));
+                body->addCollider(sphereShape, Transform::identity());
+                body->setLinearVelocity(Vector3(20, 0, decimal(i)));
+            }
+
+            uint32 nbReinsertedColliders = 0;
+            outNbUpdatedColliders = 0;
+            for (int i=0; i < 60; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+                nbReinsertedColliders += world->getNbBroadPhaseReinsertedColliders();
+                outNbUpdatedColliders += world->getNbBroadPhaseUpdatedColliders();
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+
+            return nbReinsertedColliders;
+        }
+
+        void testPredictiveFatAABBs() {
+
+            uint32 nbUpdatedColliders;
+            uint32 nbUpdatedCollidersPredictive;
+            const uint32 nbReinsertedColliders = simulateFastBodies(false, nbUpdatedColliders);
+            const uint32 nbReinsertedCollidersPredictive = simulateFastBodies(true, nbUpdatedCollidersPredictive);
+
+            // Only the colliders of the moving bodies are updated
+            rp3d_test(nbUpdatedColliders == 600);
+            rp3d_test(nbUpdatedCollidersPredictive == 600);
+
+            // Without prediction, the small fast bodies leave their fat AABB at every frame
+            rp3d_test(nbReinsertedColliders == 600);
+            rp3d_test(nbReinsertedCollidersPredictive < 200);
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+            rp3d_test(!world->isBroadPhaseFatAABBPredictive());
+            world->setIsBroadPhaseFatAABBPredictive(true);
+            world->setBroadPhaseFatAABBMargins(decimal(0.1), decimal(1.0));
+            rp3d_test(world->isBroadPhaseFatAABBPredictive());
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+        void testIslands() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            // Two boxes in contact with each other and two boxes linked by a joint
+            RigidBody* boxA = world->createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            boxA->addCollider(boxShape, Transform::identity());
+            RigidBody* boxB = world->createRigidBody(Transform(Vector3(decimal(1.0), decimal(0.5), 0), Quaternion::identity()));
+            boxB->addCollider(boxShape, Transform::identity());
+            RigidBody* boxC = world->createRigidBody(Transform(Vector3(0, decimal(0.5), 10), Quaternion::identity()));
+            boxC->addCollider(boxShape, Transform::identity());
+            RigidBody* boxD = world->createRigidBody(Transform(Vector3(3, decimal(0.5), 10), Quaternion::identity()));
+            boxD->addCollider(boxShape, Transform::identity());
+            Joint* joint = world->createJoint(BallAndSocketJointInfo(boxC, boxD, Vector3(decimal(1.5), decimal(0.5), 10)));
+
+            for (int i=0; i < 30; i++) {
+                world->update(timeStep);
+            }
+
+            // The box moved by the user drags the box linked to it by the joint
+            const decimal initialPositionC = boxC->getTransform().getPosition().x;
+            for (int i=0; i < 30; i++) {
+                boxD->setLinearVelocity(Vector3(2, 0, 0));
+                world->update(timeStep);
+            }
+            rp3d_test(boxC->getTransform().getPosition().x > initialPositionC + decimal(0.5));
+
+            // The boxes are separated while one of them keeps moving. The islands of
+            // the separated boxes must be split such that the other box can fall asleep.
+            world->destroyJoint(joint);
+            for (int i=0; i < 150; i++) {
+                boxB->setLinearVelocity(Vector3(2, 0, 0));
+                boxD->setLinearVelocity(Vector3(2, 0, 0));
+                world->update(timeStep);
+            }
+            rp3d_test(boxA->isSleeping());
+            rp3d_test(!boxB->isSleeping());
+            rp3d_test(boxC->isSleeping());
+            rp3d_test(!boxD->isSleeping());
+
+            // A box falling on a sleeping box wakes it up
+            RigidBody* boxE = world->createRigidBody(Transform(Vector3(0, 3, 0), Quaternion::identity()));
+            boxE->addCollider(boxShape, Transform::identity());
+            bool isBoxAWokenUp = false;
+            for (int i=0; i < 60; i++) {
+                world->update(timeStep);
+                isBoxAWokenUp |= !boxA->isSleeping();
+            }
+            rp3d_test(isBoxAWokenUp);
+            rp3d_test(approxEqual(boxE->getTransform().getPosition().y, decimal(1.5), decimal(0.05)));
+
+            // All the boxes fall asleep once they are at rest
+            for (int i=0; i < 300; i++) {
+                world->update(timeStep);
+            }
+            RigidBody* boxes[] = {boxA, boxB, boxC, boxD, boxE};
+            for (int b=0; b < 5; b++) {
+                rp3d_test(boxes[b]->isSleeping());
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testIslandsUpdatedWithoutLostContacts() {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            // Two boxes resting on kinematic platforms that never fall asleep
+            RigidBody* platformA = world->createRigidBody(Transform(Vector3(0, decimal(0.5), 0), Quaternion::identity()));
+            platformA->setType(BodyType::KINEMATIC);
+            platformA->setIsAllowedToSleep(false);
+            Collider* platformACollider = platformA->addCollider(boxShape, Transform::identity());
+            RigidBody* boxA = world->createRigidBody(Transform(Vector3(0, decimal(1.49), 0), Quaternion::identity()));
+            boxA->addCollider(boxShape, Transform::identity());
+
+            RigidBody* platformB = world->createRigidBody(Transform(Vector3(10, decimal(0.5), 0), Quaternion::identity()));
+            platformB->setType(BodyType::KINEMATIC);
+            platformB->setIsAllowedToSleep(false);
+            Collider* platformBCollider = platformB->addCollider(boxShape, Transform::identity());
+            RigidBody* boxB = world->createRigidBody(Transform(Vector3(10, decimal(1.49), 0), Quaternion::identity()));
+            boxB->addCollider(boxShape, Transform::identity());
+
+            for (int i=0; i < 120; i++) {
+                world->update(timeStep);
+            }
+            rp3d_test(!boxA->isSleeping());
+            rp3d_test(!boxB->isSleeping());
+
+            // The contact with a platform that becomes a trigger is not reported as a lost contact. The
+            // island of the box must be split anyway such that the box falls onto the ground and falls asleep.
+            platformACollider->setIsTrigger(true);
+
+            // The contacts of a removed collider are not reported as lost contacts either
+            platformB->removeCollider(platformBCollider);
+
+            for (int i=0; i < 360; i++) {
+                world->update(timeStep);
+            }
+            rp3d_test(boxA->isSleeping());
+            rp3d_test(boxB->isSleeping());
+            rp3d_test(approxEqual(boxA->getTransform().getPosition().y, decimal(0.5), decimal(0.05)));
+
+            // The sleeping box is inside the trigger. When the platform stops being a trigger, the box is
+            // already touching it (this is not a new contact) and must be woken up.
+            platformACollider->setIsTrigger(false);
+            world->update(timeStep);
+            world->update(timeStep);
+            rp3d_test(!boxA->isSleeping());
+
+            // A new joint between an awake body and a sleeping body wakes up the sleeping body
+            rp3d_test(boxB->isSleeping());
+            world->createJoint(BallAndSocketJointInfo(platformB, boxB, Vector3(10, 1, 0)));
+            world->update(timeStep);
+            rp3d_test(!boxB->isSleeping());
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
  };
 
 }
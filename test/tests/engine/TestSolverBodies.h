@@ -0,0 +1,357 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef TEST_SOLVER_BODIES_H
+#define TEST_SOLVER_BODIES_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/reactphysics3d.h>
+#include <reactphysics3d/collision/ContactManifold.h>
+#include <reactphysics3d/components/JointComponents.h>
+#include <reactphysics3d/components/RigidBodyComponents.h>
+#include <reactphysics3d/engine/Islands.h>
+#include <reactphysics3d/engine/SolverBodies.h>
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <vector>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestSolverBodies
+/**
+ * Unit test for the SolverBodies structure (packed state of the bodies used by the solvers)
+ */
+class TestSolverBodies : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        DefaultAllocator mBaseAllocator;
+
+        MemoryManager mMemoryManager;
+
+        RigidBodyComponents mRigidBodyComponents;
+
+        JointComponents mJointComponents;
+
+        Islands mIslands;
+
+        /// Contact manifolds of the islands
+        Array<ContactManifold> mContactManifolds;
+
+        /// Entities of the static ground and of the three dynamic bodies
+        Entity mGround, mBody1, mBody2, mBody3;
+
+        // ---------- Methods ---------- //
+
+        /// Return a vector that is different for each body entity and each kind of value
+        static Vector3 getValue(Entity entity, decimal kind) {
+            return Vector3(decimal(entity.getIndex()), kind, decimal(entity.getIndex()) * kind + decimal(0.5));
+        }
+
+        /// Return an orientation that is different for each body entity
+        static Quaternion getOrientation(Entity entity, decimal kind) {
+            return Quaternion::fromEulerAngles(decimal(0.1) * kind, decimal(0.2) * decimal(entity.getIndex()), 0);
+        }
+
+        /// Add a rigid body component with a different state for each body
+        void addBody(Entity entity, BodyType bodyType) {
+
+            const Vector3 worldPosition = getValue(entity, 5);
+            mRigidBodyComponents.addComponent(entity, false, RigidBodyComponents::RigidBodyComponent(nullptr, bodyType, worldPosition));
+
+            mRigidBodyComponents.setConstrainedLinearVelocity(entity, getValue(entity, 1));
+            mRigidBodyComponents.setConstrainedAngularVelocity(entity, getValue(entity, 2));
+            mRigidBodyComponents.setSplitLinearVelocity(entity, getValue(entity, 3));
+            mRigidBodyComponents.setSplitAngularVelocity(entity, getValue(entity, 4));
+            mRigidBodyComponents.setConstrainedPosition(entity, getValue(entity, 5));
+            mRigidBodyComponents.setConstrainedOrientation(entity, getOrientation(entity, 1));
+            mRigidBodyComponents.setMassInverse(entity, bodyType == BodyType::DYNAMIC ? decimal(1.0) / decimal(entity.getIndex()) : decimal(0.0));
+        }
+
+        /// Return true if the state of a solver body is the state of its rigid body component
+        bool isSolverBodyLoaded(const SolverBodies& solverBodies, uint32 solverIndex) {
+
+            const Entity entity = getSolverBodyEntity(solverBodies, solverIndex);
+
+            return solverBodies.bodyTypes[solverIndex] == mRigidBodyComponents.getBodyType(entity) &&
+                   solverBodies.linearVelocities[solverIndex] == mRigidBodyComponents.getConstrainedLinearVelocity(entity) &&
+                   solverBodies.angularVelocities[solverIndex] == mRigidBodyComponents.getConstrainedAngularVelocity(entity) &&
+                   solverBodies.splitLinearVelocities[solverIndex] == mRigidBodyComponents.getSplitLinearVelocity(entity) &&
+                   solverBodies.splitAngularVelocities[solverIndex] == mRigidBodyComponents.getSplitAngularVelocity(entity) &&
+                   solverBodies.positions[solverIndex] == mRigidBodyComponents.getConstrainedPosition(entity) &&
+                   solverBodies.orientations[solverIndex] == mRigidBodyComponents.getConstrainedOrientation(entity) &&
+                   solverBodies.inverseMasses[solverIndex] == mRigidBodyComponents.getMassInverse(entity);
+        }
+
+        /// Return the entity of the body of a solver body
+        Entity getSolverBodyEntity(const SolverBodies& solverBodies, uint32 solverIndex) {
+
+            for (const Entity entity : {mGround, mBody1, mBody2, mBody3}) {
+                if (mRigidBodyComponents.getEntityIndex(entity) == solverBodies.rigidBodyComponentIndices[solverIndex]) {
+                    return entity;
+                }
+            }
+
+            return Entity(0, 1);
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestSolverBodies(const std::string& name)
+            : Test(name), mMemoryManager(&mBaseAllocator), mRigidBodyComponents(mMemoryManager.getHeapAllocator()),
+              mJointComponents(mMemoryManager.getHeapAllocator()), mIslands(mMemoryManager.getHeapAllocator()),
+              mContactManifolds(mMemoryManager.getHeapAllocator()),
+              mGround(0, 0), mBody1(1, 0), mBody2(2, 0), mBody3(3, 0) {
+
+            // Add the components in an order that is different from the order of the bodies in the islands
+            addBody(mBody3, BodyType::DYNAMIC);
+            addBody(mGround, BodyType::STATIC);
+            addBody(mBody2, BodyType::DYNAMIC);
+            addBody(mBody1, BodyType::DYNAMIC);
+
+            // The first island contains the first body on the ground
+            mIslands.addIsland(0);
+            mIslands.addBodyToIsland(mBody1);
+            mIslands.addBodyToIsland(mGround);
+            mContactManifolds.add(ContactManifold(mBody1, mGround, Entity(10, 0), Entity(11, 0), 0, 1));
+            mIslands.nbContactManifolds[0]++;
+
+            // The second island contains the second body on the ground and the third body on the second one
+            mIslands.addIsland(1);
+            mIslands.addBodyToIsland(mBody2);
+            mIslands.addBodyToIsland(mGround);
+            mIslands.addBodyToIsland(mBody3);
+            mContactManifolds.add(ContactManifold(mBody2, mGround, Entity(12, 0), Entity(11, 0), 1, 1));
+            mContactManifolds.add(ContactManifold(mBody3, mBody2, Entity(13, 0), Entity(12, 0), 2, 1));
+            mIslands.nbContactManifolds[1] += 2;
+        }
+
+        /// Destructor
+        virtual ~TestSolverBodies() {
+
+            for (const Entity entity : {mGround, mBody1, mBody2, mBody3}) {
+                mRigidBodyComponents.removeComponent(entity);
+            }
+        }
+
+        /// Run the tests
+        void run() {
+            testInitialize();
+            testStoreVelocitiesAndPositions();
+            testIslandsSolvedByColors();
+            testWriteBackMatchesIntegration();
+        }
+
+        void testInitialize() {
+
+            SolverBodies solverBodies(mMemoryManager.getHeapAllocator(), mIslands, mRigidBodyComponents, mJointComponents);
+            solverBodies.initialize(mContactManifolds, 0);
+
+            // The static ground has one solver body in each island
+            rp3d_test(solverBodies.getNbBodies() == 5);
+            rp3d_test(solverBodies.nbIslandsSolvedByColors == 0);
+
+            // The solver bodies are in island order and contain the state of their rigid body component
+            rp3d_test(getSolverBodyEntity(solverBodies, 0) == mBody1);
+            rp3d_test(getSolverBodyEntity(solverBodies, 1) == mGround);
+            rp3d_test(getSolverBodyEntity(solverBodies, 2) == mBody2);
+            rp3d_test(getSolverBodyEntity(solverBodies, 3) == mGround);
+            rp3d_test(getSolverBodyEntity(solverBodies, 4) == mBody3);
+            for (uint32 i=0; i < solverBodies.getNbBodies(); i++) {
+                rp3d_test(isSolverBodyLoaded(solverBodies, i));
+            }
+
+            // The contact manifolds use the solver bodies of their own island
+            rp3d_test(solverBodies.contactManifoldsBody1Indices[0] == 0 && solverBodies.contactManifoldsBody2Indices[0] == 1);
+            rp3d_test(solverBodies.contactManifoldsBody1Indices[1] == 2 && solverBodies.contactManifoldsBody2Indices[1] == 3);
+            rp3d_test(solverBodies.contactManifoldsBody1Indices[2] == 4 && solverBodies.contactManifoldsBody2Indices[2] == 2);
+        }
+
+        void testStoreVelocitiesAndPositions() {
+
+            SolverBodies solverBodies(mMemoryManager.getHeapAllocator(), mIslands, mRigidBodyComponents, mJointComponents);
+            solverBodies.initialize(mContactManifolds, 0);
+
+            const Vector3 groundLinearVelocity = mRigidBodyComponents.getConstrainedLinearVelocity(mGround);
+            const Vector3 groundSplitLinearVelocity = mRigidBodyComponents.getSplitLinearVelocity(mGround);
+            const Vector3 groundPosition = mRigidBodyComponents.getConstrainedPosition(mGround);
+            const Quaternion groundOrientation = mRigidBodyComponents.getConstrainedOrientation(mGround);
+
+            // Solve the velocities the way the solver would do it on the components
+            for (uint32 i=0; i < solverBodies.getNbBodies(); i++) {
+
+                const Entity entity = getSolverBodyEntity(solverBodies, i);
+                solverBodies.linearVelocities[i] = getValue(entity, 11);
+                solverBodies.angularVelocities[i] = getValue(entity, 12);
+                solverBodies.splitLinearVelocities[i] = getValue(entity, 13);
+                solverBodies.splitAngularVelocities[i] = getValue(entity, 14);
+            }
+            solverBodies.storeVelocities();
+
+            // Each dynamic body gets the velocities of its solver body and the static ground is not modified
+            for (const Entity entity : {mBody1, mBody2, mBody3}) {
+                rp3d_test(mRigidBodyComponents.getConstrainedLinearVelocity(entity) == getValue(entity, 11));
+                rp3d_test(mRigidBodyComponents.getConstrainedAngularVelocity(entity) == getValue(entity, 12));
+                rp3d_test(mRigidBodyComponents.getSplitLinearVelocity(entity) == getValue(entity, 13));
+                rp3d_test(mRigidBodyComponents.getSplitAngularVelocity(entity) == getValue(entity, 14));
+            }
+            rp3d_test(mRigidBodyComponents.getConstrainedLinearVelocity(mGround) == groundLinearVelocity);
+            rp3d_test(mRigidBodyComponents.getSplitLinearVelocity(mGround) == groundSplitLinearVelocity);
+
+            // Integrate the positions on the components and load them into the solver bodies
+            for (const Entity entity : {mBody1, mBody2, mBody3}) {
+                mRigidBodyComponents.setConstrainedPosition(entity, getValue(entity, 15));
+                mRigidBodyComponents.setConstrainedOrientation(entity, getOrientation(entity, 2));
+            }
+            solverBodies.loadPositions();
+            for (uint32 i=0; i < solverBodies.getNbBodies(); i++) {
+                const Entity entity = getSolverBodyEntity(solverBodies, i);
+                rp3d_test(solverBodies.positions[i] == mRigidBodyComponents.getConstrainedPosition(entity));
+                rp3d_test(solverBodies.orientations[i] == mRigidBodyComponents.getConstrainedOrientation(entity));
+            }
+
+            // Solve the positions and write them back
+            for (uint32 i=0; i < solverBodies.getNbBodies(); i++) {
+
+                const Entity entity = getSolverBodyEntity(solverBodies, i);
+                solverBodies.positions[i] = getValue(entity, 16);
+                solverBodies.orientations[i] = getOrientation(entity, 3);
+            }
+            solverBodies.storePositions();
+
+            for (const Entity entity : {mBody1, mBody2, mBody3}) {
+                rp3d_test(mRigidBodyComponents.getConstrainedPosition(entity) == getValue(entity, 16));
+                rp3d_test(mRigidBodyComponents.getConstrainedOrientation(entity) == getOrientation(entity, 3));
+            }
+            rp3d_test(mRigidBodyComponents.getConstrainedPosition(mGround) == groundPosition);
+            rp3d_test(mRigidBodyComponents.getConstrainedOrientation(mGround) == groundOrientation);
+
+            // Restore the state of the bodies for the next tests
+            for (const Entity entity : {mBody1, mBody2, mBody3}) {
+                mRigidBodyComponents.setConstrainedLinearVelocity(entity, getValue(entity, 1));
+                mRigidBodyComponents.setConstrainedAngularVelocity(entity, getValue(entity, 2));
+                mRigidBodyComponents.setSplitLinearVelocity(entity, getValue(entity, 3));
+                mRigidBodyComponents.setSplitAngularVelocity(entity, getValue(entity, 4));
+                mRigidBodyComponents.setConstrainedPosition(entity, getValue(entity, 5));
+                mRigidBodyComponents.setConstrainedOrientation(entity, getOrientation(entity, 1));
+            }
+        }
+
+        void testIslandsSolvedByColors() {
+
+            SolverBodies solverBodies(mMemoryManager.getHeapAllocator(), mIslands, mRigidBodyComponents, mJointComponents);
+
+            // Only the second island has at least two constraints
+            solverBodies.initialize(mContactManifolds, 2);
+            rp3d_test(solverBodies.nbIslandsSolvedByColors == 1);
+            rp3d_test(!solverBodies.islandsSolvedByColors[0]);
+            rp3d_test(solverBodies.islandsSolvedByColors[1]);
+
+            // In the island solved by colors, the static ground gets its own solver body for its
+            // contact manifold while the dynamic bodies keep the solver bodies of the island
+            rp3d_test(solverBodies.getNbBodies() == 6);
+            rp3d_test(solverBodies.contactManifoldsBody1Indices[0] == 0 && solverBodies.contactManifoldsBody2Indices[0] == 1);
+            rp3d_test(solverBodies.contactManifoldsBody1Indices[1] == 2 && solverBodies.contactManifoldsBody2Indices[1] == 5);
+            rp3d_test(solverBodies.contactManifoldsBody1Indices[2] == 4 && solverBodies.contactManifoldsBody2Indices[2] == 2);
+            rp3d_test(getSolverBodyEntity(solverBodies, 5) == mGround);
+            rp3d_test(isSolverBodyLoaded(solverBodies, 5));
+
+            // The velocities written into the solver bodies of the ground are ignored
+            const Vector3 groundLinearVelocity = mRigidBodyComponents.getConstrainedLinearVelocity(mGround);
+            solverBodies.linearVelocities[5] = Vector3(7, 7, 7);
+            solverBodies.linearVelocities[2] = Vector3(8, 8, 8);
+            solverBodies.storeVelocities();
+            rp3d_test(mRigidBodyComponents.getConstrainedLinearVelocity(mGround) == groundLinearVelocity);
+            rp3d_test(mRigidBodyComponents.getConstrainedLinearVelocity(mBody2) == Vector3(8, 8, 8));
+
+            mRigidBodyComponents.setConstrainedLinearVelocity(mBody2, getValue(mBody2, 1));
+        }
+
+        void testWriteBackMatchesIntegration() {
+
+            PhysicsWorld::WorldSettings settings;
+            settings.gravity = Vector3(0, decimal(-9.81), 0);
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(settings);
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+
+            // Two bodies connected by a joint are created first so that the solver bodies
+            // of the free bodies are not at the index of their rigid body component
+            RigidBody* jointBody1 = world->createRigidBody(Transform(Vector3(-10, 0, 0), Quaternion::identity()));
+            RigidBody* jointBody2 = world->createRigidBody(Transform(Vector3(-10, -2, 0), Quaternion::identity()));
+            jointBody1->addCollider(sphereShape, Transform::identity());
+            jointBody2->addCollider(sphereShape, Transform::identity());
+            BallAndSocketJointInfo jointInfo(jointBody1, jointBody2, Vector3(-10, -1, 0));
+            world->createJoint(jointInfo);
+
+            // Free bodies that do not touch each other with different velocities
+            std::vector<RigidBody*> bodies;
+            for (int i=0; i < 6; i++) {
+
+                RigidBody* body = world->createRigidBody(Transform(Vector3(decimal(i * 3), decimal(i), 0), Quaternion::identity()));
+                body->addCollider(sphereShape, Transform::identity());
+                body->setLinearDamping(0);
+                body->setAngularDamping(0);
+                body->setLinearVelocity(Vector3(decimal(i), decimal(1 - i), decimal(0.5 * i)));
+                body->setAngularVelocity(Vector3(0, decimal(0.1 * i), 0));
+                bodies.push_back(body);
+            }
+
+            // The free bodies are integrated with the semi-implicit Euler scheme
+            const decimal timeStep = decimal(1.0) / decimal(60.0);
+            for (int step=0; step < 10; step++) {
+
+                std::vector<Vector3> expectedVelocities;
+                std::vector<Vector3> expectedPositions;
+                for (RigidBody* body : bodies) {
+                    const Vector3 velocity = body->getLinearVelocity() + timeStep * settings.gravity;
+                    expectedVelocities.push_back(velocity);
+                    expectedPositions.push_back(body->getTransform().getPosition() + timeStep * velocity);
+                }
+
+                world->update(timeStep);
+
+                for (size_t i=0; i < bodies.size(); i++) {
+                    rp3d_test(approxEqual(bodies[i]->getLinearVelocity(), expectedVelocities[i], decimal(0.0001)));
+                    rp3d_test(approxEqual(bodies[i]->getTransform().getPosition(), expectedPositions[i], decimal(0.0001)));
+                    rp3d_test(approxEqual(bodies[i]->getAngularVelocity(), Vector3(0, decimal(0.1 * i), 0), decimal(0.0001)));
+                }
+            }
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+ };
+
+}
+
+#endif
@@ -0,0 +1,557 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_TASK_SCHEDULER_H
+#define TEST_TASK_SCHEDULER_H
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include <atomic>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TriggerPairsEventListener
+/**
+ * Event listener that records the pairs of bodies (by entity id) that start overlapping
+ */
+class TriggerPairsEventListener : public EventListener {
+
+    public:
+
+        std::vector<std::pair<uint32, uint32>> mStartedPairs;
+
+        /// Called when some trigger events occur
+        virtual void onTrigger(const OverlapCallback::CallbackData& callbackData) override {
+
+            for (uint32 i=0; i < callbackData.getNbOverlappingPairs(); i++) {
+
+                OverlapCallback::OverlapPair pair = callbackData.getOverlappingPair(i);
+                if (pair.getEventType() == OverlapCallback::OverlapPair::EventType::OverlapStart) {
+
+                    const uint32 id1 = pair.getBody1()->getEntity().id;
+                    const uint32 id2 = pair.getBody2()->getEntity().id;
+                    mStartedPairs.push_back(std::make_pair(std::min(id1, id2), std::max(id1, id2)));
+                }
+            }
+        }
+};
+
+// Class TestTaskScheduler
+/**
+ * Unit test for the DefaultTaskScheduler class and for the parallel simulation of a world.
+ */
+class TestTaskScheduler : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        DefaultTaskScheduler* mTaskScheduler;
+
+        // ---------- Methods ---------- //
+
+        /// Create a world with several independent stacks of boxes and pendulums
+        PhysicsWorld* createWorld(std::vector<RigidBody*>& dynamicBodies) {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            for (int s=0; s < 6; s++) {
+
+                // Stack of boxes
+                for (int b=0; b < 4; b++) {
+                    const Vector3 position(decimal(s * 4), decimal(0.5 + b * 1.05), decimal(0));
+                    const Quaternion orientation = Quaternion::fromEulerAngles(0, decimal(0.1 * b), 0);
+                    RigidBody* box = world->createRigidBody(Transform(position, orientation));
+                    box->addCollider(boxShape, Transform::identity());
+                    dynamicBodies.push_back(box);
+                }
+
+                // Pendulum attached to a static anchor
+                RigidBody* anchor = world->createRigidBody(Transform(Vector3(decimal(s * 4), 10, 10), Quaternion::identity()));
+                anchor->setType(BodyType::STATIC);
+                RigidBody* bob = world->createRigidBody(Transform(Vector3(decimal(s * 4 + 2), 10, 10), Quaternion::identity()));
+                bob->addCollider(boxShape, Transform::identity());
+                dynamicBodies.push_back(bob);
+
+                BallAndSocketJointInfo jointInfo(anchor, bob, Vector3(decimal(s * 4), 10, 10));
+                world->createJoint(jointInfo);
+            }
+
+            return world;
+        }
+
+        /// Create a world with a pile of spheres, capsules and boxes
+        PhysicsWorld* createPileWorld(std::vector<RigidBody*>& dynamicBodies,
+                                      const PhysicsWorld::WorldSettings& worldSettings = PhysicsWorld::WorldSettings()) {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(worldSettings);
+
+            BoxShape* groundShape = mPhysicsCommon.createBoxShape(Vector3(50, 1, 50));
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.5), decimal(0.5), decimal(0.5)));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+            CapsuleShape* capsuleShape = mPhysicsCommon.createCapsuleShape(decimal(0.4), decimal(1.0));
+
+            RigidBody* ground = world->createRigidBody(Transform(Vector3(0, -1, 0), Quaternion::identity()));
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(groundShape, Transform::identity());
+
+            for (int y=0; y < 5; y++) {
+                for (int x=0; x < 6; x++) {
+                    for (int z=0; z < 6; z++) {
+
+                        const Vector3 position(decimal(x * 1.1 + 0.05 * y), decimal(0.5 + y * 1.6), decimal(z * 1.1 - 0.05 * y));
+                        RigidBody* body = world->createRigidBody(Transform(position, Quaternion::fromEulerAngles(decimal(0.3 * y), 0, decimal(0.1 * x))));
+
+                        switch ((x + y + z) % 3) {
+                            case 0: body->addCollider(sphereShape, Transform::identity()); break;
+                            case 1: body->addCollider(capsuleShape, Transform::identity()); break;
+                            default: body->addCollider(boxShape, Transform::identity()); break;
+                        }
+
+                        dynamicBodies.push_back(body);
+                    }
+                }
+            }
+
+            return world;
+        }
+
+        /// Create a world with a grid of sphere triggers that do not move and return the positions of the spheres
+        PhysicsWorld* createTriggersWorld(std::vector<Vector3>& positions) {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld();
+
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.5));
+
+            uint32 random = 17;
+            for (int x=0; x < 8; x++) {
+                for (int y=0; y < 5; y++) {
+                    for (int z=0; z < 8; z++) {
+
+                        // Move the spheres a bit around the grid such that some neighbors overlap and others not
+                        Vector3 position(decimal(x * 0.95), decimal(y * 0.95), decimal(z * 0.95));
+                        for (int i=0; i < 3; i++) {
+                            random = random * 1664525u + 1013904223u;
+                            position[i] += decimal(((random >> 16) % 21) * 0.01 - 0.1);
+                        }
+                        positions.push_back(position);
+
+                        RigidBody* body = world->createRigidBody(Transform(position, Quaternion::identity()));
+                        body->enableGravity(false);
+                        Collider* collider = body->addCollider(sphereShape, Transform::identity());
+                        collider->setIsTrigger(true);
+                    }
+                }
+            }
+
+            return world;
+        }
+
+        /// Create a world with a chain of boxes connected by ball-and-socket joints
+        PhysicsWorld* createChainWorld(std::vector<RigidBody*>& dynamicBodies, const PhysicsWorld::WorldSettings& worldSettings) {
+
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(worldSettings);
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.4), decimal(0.4), decimal(0.4)));
+
+            RigidBody* anchor = world->createRigidBody(Transform(Vector3(0, 20, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+
+            RigidBody* previousBody = anchor;
+            for (int i=0; i < 40; i++) {
+
+                RigidBody* body = world->createRigidBody(Transform(Vector3(decimal(i + 1), 20, 0), Quaternion::identity()));
+                body->addCollider(boxShape, Transform::identity());
+                dynamicBodies.push_back(body);
+
+                BallAndSocketJointInfo jointInfo(previousBody, body, Vector3(decimal(i + 0.5), 20, 0));
+                world->createJoint(jointInfo);
+
+                previousBody = body;
+            }
+
+            return world;
+        }
+
+        /// Return true if the bodies of two worlds have exactly the same transforms
+        bool isSameSimulation(const std::vector<RigidBody*>& bodies1, const std::vector<RigidBody*>& bodies2) {
+
+            for (size_t i=0; i < bodies1.size(); i++) {
+                const Transform& t1 = bodies1[i]->getTransform();
+                const Transform& t2 = bodies2[i]->getTransform();
+                if (t1.getPosition() != t2.getPosition() || !(t1.getOrientation() == t2.getOrientation())) return false;
+            }
+
+            return true;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestTaskScheduler(const std::string& name) : Test(name) {
+
+            mTaskScheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+        }
+
+        /// Destructor
+        virtual ~TestTaskScheduler() {
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(mTaskScheduler);
+        }
+
+        /// Run the tests
+        void run() {
+            testParallelFor();
+            testParallelSimulation();
+            testParallelNarrowPhase();
+            testParallelBroadPhase();
+            testIslandsSolvedByColors();
+            testDeterministicSimulation();
+        }
+
+        void testParallelFor() {
+
+            rp3d_test(mTaskScheduler->getNbWorkers() == 4);
+
+            // Each item must be processed exactly once
+            const uint32 nbItems = 10007;
+            std::vector<std::atomic<uint32>> counters(nbItems);
+            for (uint32 i=0; i < nbItems; i++) counters[i] = 0;
+            std::atomic<bool> isWorkerIndexValid(true);
+
+            for (uint32 k=0; k < 20; k++) {
+
+                parallelFor(mTaskScheduler, nbItems, 16, [&](uint32 startIndex, uint32 endIndex, uint32 workerIndex) {
+
+                    if (workerIndex >= 4 || startIndex >= endIndex || endIndex > nbItems) isWorkerIndexValid = false;
+
+                    for (uint32 i=startIndex; i < endIndex; i++) {
+                        counters[i]++;
+                    }
+                });
+            }
+
+            bool isValid = true;
+            for (uint32 i=0; i < nbItems; i++) {
+                if (counters[i] != 20) isValid = false;
+            }
+            rp3d_test(isValid);
+            rp3d_test(isWorkerIndexValid);
+
+            // A parallelFor() called from inside a task must run on the calling thread
+            // with the worker index of the outer task
+            std::atomic<uint32> nbNestedItems(0);
+            std::atomic<bool> isNestedWorkerIndexValid(true);
+            parallelFor(mTaskScheduler, 64, 1, [&](uint32 startIndex, uint32 endIndex, uint32 workerIndex) {
+                for (uint32 i=startIndex; i < endIndex; i++) {
+                    parallelFor(mTaskScheduler, 32, 1, [&](uint32 start, uint32 end, uint32 nestedWorkerIndex) {
+                        nbNestedItems += end - start;
+                        if (nestedWorkerIndex != workerIndex) isNestedWorkerIndexValid = false;
+                    });
+                }
+            });
+            rp3d_test(nbNestedItems == 64 * 32);
+            rp3d_test(isNestedWorkerIndexValid);
+
+            // Same thing with a nested call that has too few items to be split (the outer items
+            // take some time so that they are also processed by the worker threads)
+            nbNestedItems = 0;
+            parallelFor(mTaskScheduler, 64, 1, [&](uint32 startIndex, uint32 endIndex, uint32 workerIndex) {
+                for (uint32 i=startIndex; i < endIndex; i++) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    parallelFor(mTaskScheduler, 4, 8, [&](uint32 start, uint32 end, uint32 nestedWorkerIndex) {
+                        nbNestedItems += end - start;
+                        if (nestedWorkerIndex != workerIndex) isNestedWorkerIndexValid = false;
+                    });
+                }
+            });
+            rp3d_test(nbNestedItems == 64 * 4);
+            rp3d_test(isNestedWorkerIndexValid);
+
+            // No item
+            bool isCalled = false;
+            parallelFor(mTaskScheduler, 0, 1, [&](uint32 /*startIndex*/, uint32 /*endIndex*/, uint32 /*workerIndex*/) {
+                isCalled = true;
+            });
+            rp3d_test(!isCalled);
+        }
+
+        void testParallelSimulation() {
+
+            std::vector<RigidBody*> bodiesSerial;
+            std::vector<RigidBody*> bodiesParallel;
+            PhysicsWorld* worldSerial = createWorld(bodiesSerial);
+            PhysicsWorld* worldParallel = createWorld(bodiesParallel);
+
+            worldParallel->setTaskScheduler(mTaskScheduler);
+            rp3d_test(worldParallel->getTaskScheduler() == mTaskScheduler);
+            rp3d_test(worldSerial->getTaskScheduler() == nullptr);
+
+            for (int i=0; i < 120; i++) {
+                worldSerial->update(decimal(1.0) / decimal(60.0));
+                worldParallel->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // Each island only contains a single joint so the parallel simulation must give exactly
+            // the same result as the serial one
+            bool isSame = true;
+            for (size_t i=0; i < bodiesSerial.size(); i++) {
+                const Transform& t1 = bodiesSerial[i]->getTransform();
+                const Transform& t2 = bodiesParallel[i]->getTransform();
+                if (t1.getPosition() != t2.getPosition() || !(t1.getOrientation() == t2.getOrientation())) isSame = false;
+            }
+            rp3d_test(isSame);
+
+            // The pendulums must have moved
+            rp3d_test(bodiesParallel[4]->getTransform().getPosition().y < decimal(10.0));
+
+            worldParallel->setTaskScheduler(nullptr);
+
+            mPhysicsCommon.destroyPhysicsWorld(worldSerial);
+            mPhysicsCommon.destroyPhysicsWorld(worldParallel);
+        }
+
+        void testParallelNarrowPhase() {
+
+            std::vector<RigidBody*> bodiesSerial;
+            std::vector<RigidBody*> bodiesParallel;
+            PhysicsWorld* worldSerial = createPileWorld(bodiesSerial);
+            PhysicsWorld* worldParallel = createPileWorld(bodiesParallel);
+
+            worldParallel->setTaskScheduler(mTaskScheduler);
+
+            for (int i=0; i < 90; i++) {
+                worldSerial->update(decimal(1.0) / decimal(60.0));
+                worldParallel->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The narrow-phase results are merged in a deterministic order and the pile does not
+            // contain any joint so the parallel simulation must give the same result as the serial one
+            bool isSame = true;
+            for (size_t i=0; i < bodiesSerial.size(); i++) {
+                const Transform& t1 = bodiesSerial[i]->getTransform();
+                const Transform& t2 = bodiesParallel[i]->getTransform();
+                if (t1.getPosition() != t2.getPosition() || !(t1.getOrientation() == t2.getOrientation())) isSame = false;
+            }
+            rp3d_test(isSame);
+
+            // The bodies must have fallen onto the ground
+            rp3d_test(bodiesParallel[bodiesParallel.size() - 1]->getTransform().getPosition().y < decimal(6.9));
+
+            mPhysicsCommon.destroyPhysicsWorld(worldSerial);
+            mPhysicsCommon.destroyPhysicsWorld(worldParallel);
+        }
+
+        void testParallelBroadPhase() {
+
+            DefaultTaskScheduler* singleWorkerTaskScheduler = mPhysicsCommon.createDefaultTaskScheduler(1);
+            DefaultTaskScheduler* taskSchedulers[] = {nullptr, singleWorkerTaskScheduler, mTaskScheduler};
+
+            // All the shapes of the world are tested in the first frame. There are enough of them to be split into
+            // several ranges with four workers. Two overlapping shapes have both moved and are reported twice.
+            std::vector<std::pair<uint32, uint32>> startedPairs[3];
+            std::vector<Vector3> positions;
+            for (int w=0; w < 3; w++) {
+
+                positions.clear();
+                PhysicsWorld* world = createTriggersWorld(positions);
+                world->setTaskScheduler(taskSchedulers[w]);
+
+                TriggerPairsEventListener listener;
+                world->setEventListener(&listener);
+
+                world->update(decimal(1.0) / decimal(60.0));
+                startedPairs[w] = listener.mStartedPairs;
+
+                world->setTaskScheduler(nullptr);
+                mPhysicsCommon.destroyPhysicsWorld(world);
+            }
+
+            // The same pairs are found in the same order whatever the number of workers
+            rp3d_test(startedPairs[0] == startedPairs[1]);
+            rp3d_test(startedPairs[0] == startedPairs[2]);
+
+            // Each pair of overlapping spheres is found exactly once
+            uint32 nbOverlappingSpheres = 0;
+            for (size_t i=0; i < positions.size(); i++) {
+                for (size_t j=i+1; j < positions.size(); j++) {
+                    if ((positions[i] - positions[j]).lengthSquare() < decimal(1.0)) nbOverlappingSpheres++;
+                }
+            }
+            std::vector<std::pair<uint32, uint32>> sortedPairs = startedPairs[2];
+            std::sort(sortedPairs.begin(), sortedPairs.end());
+            rp3d_test(nbOverlappingSpheres > 0);
+            rp3d_test(sortedPairs.size() == nbOverlappingSpheres);
+            rp3d_test(std::adjacent_find(sortedPairs.begin(), sortedPairs.end()) == sortedPairs.end());
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(singleWorkerTaskScheduler);
+        }
+
+        void testIslandsSolvedByColors() {
+
+            DefaultTaskScheduler* singleWorkerTaskScheduler = mPhysicsCommon.createDefaultTaskScheduler(1);
+
+            // Solve the constraints of small islands by colors
+            PhysicsWorld::WorldSettings worldSettings;
+            worldSettings.minNbConstraintsIslandSolvedByColors = 16;
+
+            // ---------- Contacts ---------- //
+
+            std::vector<RigidBody*> pileBodies1;
+            std::vector<RigidBody*> pileBodies4;
+            PhysicsWorld* pileWorld1 = createPileWorld(pileBodies1, worldSettings);
+            PhysicsWorld* pileWorld4 = createPileWorld(pileBodies4, worldSettings);
+
+            pileWorld1->setTaskScheduler(singleWorkerTaskScheduler);
+            pileWorld4->setTaskScheduler(mTaskScheduler);
+
+            for (int i=0; i < 90; i++) {
+                pileWorld1->update(decimal(1.0) / decimal(60.0));
+                pileWorld4->update(decimal(1.0) / decimal(60.0));
+            }
+
+            // The colors are solved in the same order whatever the number of threads
+            rp3d_test(isSameSimulation(pileBodies1, pileBodies4));
+
+            // The bodies must have fallen onto the ground and must not go through it
+            bool isAboveGround = true;
+            for (size_t i=0; i < pileBodies4.size(); i++) {
+                if (pileBodies4[i]->getTransform().getPosition().y < decimal(0.2)) isAboveGround = false;
+            }
+            rp3d_test(isAboveGround);
+            rp3d_test(pileBodies4[pileBodies4.size() - 1]->getTransform().getPosition().y < decimal(6.9));
+
+            mPhysicsCommon.destroyPhysicsWorld(pileWorld1);
+            mPhysicsCommon.destroyPhysicsWorld(pileWorld4);
+
+            // ---------- Joints ---------- //
+
+            std::vector<RigidBody*> chainBodies1;
+            std::vector<RigidBody*> chainBodies4;
+            PhysicsWorld* chainWorld1 = createChainWorld(chainBodies1, worldSettings);
+            PhysicsWorld* chainWorld4 = createChainWorld(chainBodies4, worldSettings);
+
+            chainWorld1->setTaskScheduler(singleWorkerTaskScheduler);
+            chainWorld4->setTaskScheduler(mTaskScheduler);
+
+            for (int i=0; i < 60; i++) {
+                chainWorld1->update(decimal(1.0) / decimal(60.0));
+                chainWorld4->update(decimal(1.0) / decimal(60.0));
+            }
+
+            rp3d_test(isSameSimulation(chainBodies1, chainBodies4));
+
+            // The chain must have swung down without breaking apart
+            rp3d_test(chainBodies4[chainBodies4.size() - 1]->getTransform().getPosition().y < decimal(17.0));
+            bool isChainConnected = true;
+            for (size_t i=1; i < chainBodies4.size(); i++) {
+                const decimal distance = (chainBodies4[i]->getTransform().getPosition() -
+                                          chainBodies4[i - 1]->getTransform().getPosition()).length();
+                if (distance > decimal(1.1)) isChainConnected = false;
+            }
+            rp3d_test(isChainConnected);
+
+            mPhysicsCommon.destroyPhysicsWorld(chainWorld1);
+            mPhysicsCommon.destroyPhysicsWorld(chainWorld4);
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(singleWorkerTaskScheduler);
+        }
+
+        void testDeterministicSimulation() {
+
+            PhysicsWorld::WorldSettings worldSettings;
+            worldSettings.isDeterministic = true;
+            worldSettings.minNbConstraintsIslandSolvedByColors = 16;
+
+            DefaultTaskScheduler* twoWorkersTaskScheduler = mPhysicsCommon.createDefaultTaskScheduler(2);
+            DefaultTaskScheduler* threeWorkersTaskScheduler = mPhysicsCommon.createDefaultTaskScheduler(3);
+            DefaultTaskScheduler* taskSchedulers[] = {twoWorkersTaskScheduler, threeWorkersTaskScheduler, mTaskScheduler};
+
+            std::vector<RigidBody*> bodiesSerial;
+            PhysicsWorld* worldSerial = createPileWorld(bodiesSerial, worldSettings);
+            rp3d_test(worldSerial->isDeterministic());
+
+            // The world without task scheduler must give the same result as the worlds with two, three and four workers
+            std::vector<RigidBody*> bodiesParallel[3];
+            PhysicsWorld* worldsParallel[3];
+            for (int w=0; w < 3; w++) {
+                worldsParallel[w] = createPileWorld(bodiesParallel[w], worldSettings);
+                worldsParallel[w]->setTaskScheduler(taskSchedulers[w]);
+            }
+
+            for (int i=0; i < 90; i++) {
+
+                // Throw a few bodies up to remove and create overlapping pairs
+                if (i == 45) {
+                    for (size_t b=0; b < bodiesSerial.size(); b += 7) {
+                        bodiesSerial[b]->setLinearVelocity(Vector3(0, 2, 0));
+                        for (int w=0; w < 3; w++) {
+                            bodiesParallel[w][b]->setLinearVelocity(Vector3(0, 2, 0));
+                        }
+                    }
+                }
+
+                worldSerial->update(decimal(1.0) / decimal(60.0));
+                for (int w=0; w < 3; w++) {
+                    worldsParallel[w]->update(decimal(1.0) / decimal(60.0));
+                }
+            }
+
+            for (int w=0; w < 3; w++) {
+                rp3d_test(isSameSimulation(bodiesSerial, bodiesParallel[w]));
+            }
+
+            worldSerial->setIsDeterministic(false);
+            rp3d_test(!worldSerial->isDeterministic());
+
+            mPhysicsCommon.destroyPhysicsWorld(worldSerial);
+            for (int w=0; w < 3; w++) {
+                mPhysicsCommon.destroyPhysicsWorld(worldsParallel[w]);
+            }
+            mPhysicsCommon.destroyDefaultTaskScheduler(twoWorkersTaskScheduler);
+            mPhysicsCommon.destroyDefaultTaskScheduler(threeWorkersTaskScheduler);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,488 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_WORLD_SNAPSHOT_H
+#define TEST_WORLD_SNAPSHOT_H
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include <vector>
+#include <cstring>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class CountingAllocator
+/**
+ * Base memory allocator that counts the number of allocations
+ */
+class CountingAllocator : public MemoryAllocator {
+
+    private:
+
+        /// Number of calls to the allocate() method
+        uint64 mNbAllocations = 0;
+
+    public:
+
+        /// Allocate memory of a given size (in bytes) and return a pointer to the
+        /// allocated memory.
+        virtual void* allocate(size_t size) override {
+
+            mNbAllocations++;
+            return malloc(size);
+        }
+
+        /// Release previously allocated memory.
+        virtual void release(void* pointer, size_t /*size*/) override {
+            free(pointer);
+        }
+
+        /// Return the number of calls to the allocate() method
+        uint64 getNbAllocations() const {
+            return mNbAllocations;
+        }
+};
+
+// Class TestWorldSnapshot
+/**
+ * Unit test for the save and restore of the state of a world with snapshots.
+ */
+class TestWorldSnapshot : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        /// Base allocator of the worlds
+        CountingAllocator mAllocator;
+
+        PhysicsCommon mPhysicsCommon;
+
+        /// Heights of the height field of the ground
+        float mHeights[10 * 10];
+
+        // ---------- Methods ---------- //
+
+        /// Create a world with bodies falling on a height field and a chain of joints
+        PhysicsWorld* createWorld(std::vector<RigidBody*>& dynamicBodies, int nbPileLayers = 3) {
+
+            PhysicsWorld::WorldSettings worldSettings;
+            worldSettings.isDeterministic = true;
+            PhysicsWorld* world = mPhysicsCommon.createPhysicsWorld(worldSettings);
+
+            // Ground with a height field (convex vs concave pairs)
+            HeightFieldShape* heightFieldShape = mPhysicsCommon.createHeightFieldShape(10, 10, 0, 1, mHeights,
+                                                        HeightFieldShape::HeightDataType::HEIGHT_FLOAT_TYPE, 1, 1, Vector3(2, 1, 2));
+            RigidBody* ground = world->createRigidBody(Transform::identity());
+            ground->setType(BodyType::STATIC);
+            ground->addCollider(heightFieldShape, Transform::identity());
+
+            BoxShape* boxShape = mPhysicsCommon.createBoxShape(Vector3(decimal(0.4), decimal(0.4), decimal(0.4)));
+            SphereShape* sphereShape = mPhysicsCommon.createSphereShape(decimal(0.4));
+
+            // Pile of boxes and spheres
+            for (int y=0; y < nbPileLayers; y++) {
+                for (int x=0; x < 4; x++) {
+                    for (int z=0; z < 4; z++) {
+
+                        const Vector3 position(decimal(x * 1.1 - 2 + 0.05 * y), decimal(2 + y * 1.2), decimal(z * 1.1 - 2));
+                        RigidBody* body = world->createRigidBody(Transform(position, Quaternion::fromEulerAngles(decimal(0.2 * y), 0, decimal(0.1 * x))));
+                        if ((x + y + z) % 2 == 0) {
+                            body->addCollider(boxShape, Transform::identity());
+                        }
+                        else {
+                            body->addCollider(sphereShape, Transform::identity());
+                        }
+                        dynamicBodies.push_back(body);
+                    }
+                }
+            }
+
+            // Chain of bodies attached to a static anchor with a ball-and-socket joint and hinge joints
+            RigidBody* anchor = world->createRigidBody(Transform(Vector3(6, 8, 0), Quaternion::identity()));
+            anchor->setType(BodyType::STATIC);
+            RigidBody* previousBody = anchor;
+            for (int i=0; i < 4; i++) {
+
+                RigidBody* link = world->createRigidBody(Transform(Vector3(decimal(7 + i), 8, 0), Quaternion::identity()));
+                link->addCollider(boxShape, Transform::identity());
+                dynamicBodies.push_back(link);
+
+                const Vector3 anchorPoint(decimal(6.5 + i), 8, 0);
+                if (i == 0) {
+                    world->createJoint(BallAndSocketJointInfo(previousBody, link, anchorPoint));
+                }
+                else {
+                    world->createJoint(HingeJointInfo(previousBody, link, anchorPoint, Vector3(0, 0, 1)));
+                }
+                previousBody = link;
+            }
+
+            return world;
+        }
+
+        /// Return true if the bodies of two worlds have exactly the same state
+        bool isSameState(const std::vector<RigidBody*>& bodies1, const std::vector<RigidBody*>& bodies2) {
+
+            if (bodies1.size() != bodies2.size()) return false;
+
+            for (size_t i=0; i < bodies1.size(); i++) {
+
+                const Transform& t1 = bodies1[i]->getTransform();
+                const Transform& t2 = bodies2[i]->getTransform();
+                if (t1.getPosition() != t2.getPosition() || !(t1.getOrientation() == t2.getOrientation()) ||
+                    bodies1[i]->getLinearVelocity() != bodies2[i]->getLinearVelocity() ||
+                    bodies1[i]->getAngularVelocity() != bodies2[i]->getAngularVelocity() ||
+                    bodies1[i]->isSleeping() != bodies2[i]->isSleeping()) {
+
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// Store the transforms of bodies
+        std::vector<Transform> getTransforms(const std::vector<RigidBody*>& bodies) {
+
+            std::vector<Transform> transforms;
+            for (size_t i=0; i < bodies.size(); i++) {
+                transforms.push_back(bodies[i]->getTransform());
+            }
+            return transforms;
+        }
+
+        /// Return true if the bodies have the given transforms
+        bool hasTransforms(const std::vector<RigidBody*>& bodies, const std::vector<Transform>& transforms) {
+
+            for (size_t i=0; i < bodies.size(); i++) {
+                const Transform& transform = bodies[i]->getTransform();
+                if (transform.getPosition() != transforms[i].getPosition() ||
+                    !(transform.getOrientation() == transforms[i].getOrientation())) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /// Return a copy of the data of a snapshot
+        std::vector<uint8> getData(const WorldSnapshot* snapshot) {
+            return std::vector<uint8>(snapshot->getData(), snapshot->getData() + snapshot->getSize());
+        }
+
+        /// Remove the last bytes of a section of the data of a snapshot and update the size of the section
+        /// The sections start after the header and each section starts with its size
+        std::vector<uint8> truncateSection(const std::vector<uint8>& data, int sectionIndex, uint32 nbBytes) {
+
+            const size_t headerSize = 8 * sizeof(uint32);
+            size_t sectionStart = headerSize;
+            uint32 sectionSize = 0;
+            for (int i=0; i <= sectionIndex; i++) {
+                sectionStart += i > 0 ? sizeof(uint32) + sectionSize : 0;
+                std::memcpy(&sectionSize, &(data[sectionStart]), sizeof(uint32));
+            }
+
+            std::vector<uint8> truncatedData(data);
+            const size_t sectionEnd = sectionStart + sizeof(uint32) + sectionSize;
+            truncatedData.erase(truncatedData.begin() + static_cast<long>(sectionEnd - nbBytes), truncatedData.begin() + static_cast<long>(sectionEnd));
+            sectionSize -= nbBytes;
+            std::memcpy(&(truncatedData[sectionStart]), &sectionSize, sizeof(uint32));
+
+            return truncatedData;
+        }
+
+        /// Take a few steps of simulation
+        void simulate(PhysicsWorld* world, int nbSteps) {
+
+            for (int i=0; i < nbSteps; i++) {
+                world->update(decimal(1.0) / decimal(60.0));
+            }
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestWorldSnapshot(const std::string& name) : Test(name), mPhysicsCommon(&mAllocator) {
+
+            for (int i=0; i < 10 * 10; i++) {
+                mHeights[i] = float((i * 7) % 5) * 0.2f;
+            }
+        }
+
+        /// Run the tests
+        void run() {
+
+            testRestoreSameWorld();
+            testRestoreOtherWorld();
+            testInvalidSnapshot();
+            testCorruptedSnapshot();
+            testSaveRestoreState();
+            testRestoreStateWithoutAllocation();
+        }
+
+        void testRestoreSameWorld() {
+
+            std::vector<RigidBody*> bodies;
+            PhysicsWorld* world = createWorld(bodies);
+
+            simulate(world, 40);
+
+            WorldSnapshot* snapshot = world->createSnapshot();
+            world->saveSnapshot(snapshot);
+            rp3d_test(snapshot->getSize() > 0);
+            const std::vector<Transform> savedTransforms = getTransforms(bodies);
+
+            // Simulate and throw a body in order to change the overlapping pairs
+            bodies[0]->setLinearVelocity(Vector3(0, 5, 0));
+            simulate(world, 60);
+            const std::vector<Transform> finalTransforms = getTransforms(bodies);
+            rp3d_test(!hasTransforms(bodies, savedTransforms));
+
+            // Go back in time and simulate the same steps again
+            rp3d_test(world->restoreSnapshot(snapshot));
+            rp3d_test(hasTransforms(bodies, savedTransforms));
+
+            bodies[0]->setLinearVelocity(Vector3(0, 5, 0));
+            simulate(world, 60);
+            rp3d_test(hasTransforms(bodies, finalTransforms));
+
+            world->destroySnapshot(snapshot);
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testRestoreOtherWorld() {
+
+            std::vector<RigidBody*> bodies1;
+            std::vector<RigidBody*> bodies2;
+            PhysicsWorld* world1 = createWorld(bodies1);
+            PhysicsWorld* world2 = createWorld(bodies2);
+
+            simulate(world1, 50);
+
+            // Copy the data of a snapshot of the first world into a snapshot of the second world
+            WorldSnapshot* snapshot1 = world1->createSnapshot();
+            world1->saveSnapshot(snapshot1);
+            std::vector<uint8> data(snapshot1->getData(), snapshot1->getData() + snapshot1->getSize());
+            WorldSnapshot* snapshot2 = world2->createSnapshot();
+            snapshot2->setData(data.data(), static_cast<uint32>(data.size()));
+
+            // The second world must continue the simulation of the first one
+            rp3d_test(world2->restoreSnapshot(snapshot2));
+            rp3d_test(isSameState(bodies1, bodies2));
+
+            simulate(world1, 60);
+            simulate(world2, 60);
+            rp3d_test(isSameState(bodies1, bodies2));
+
+            // The snapshot of the second world must be the same as the one of the first world
+            world1->saveSnapshot(snapshot1);
+            world2->saveSnapshot(snapshot2);
+            rp3d_test(snapshot1->getSize() == snapshot2->getSize());
+
+            // The snapshots are destroyed with the worlds
+            mPhysicsCommon.destroyPhysicsWorld(world1);
+            mPhysicsCommon.destroyPhysicsWorld(world2);
+        }
+
+        void testInvalidSnapshot() {
+
+            std::vector<RigidBody*> bodies1;
+            std::vector<RigidBody*> bodies2;
+            PhysicsWorld* world1 = createWorld(bodies1, 3);
+            PhysicsWorld* world2 = createWorld(bodies2, 2);
+
+            simulate(world1, 20);
+            simulate(world2, 20);
+
+            WorldSnapshot* snapshot = world1->createSnapshot();
+
+            // Empty snapshot
+            rp3d_test(!world1->restoreSnapshot(snapshot));
+
+            world1->saveSnapshot(snapshot);
+
+            // The bodies of the second world are not the same
+            const std::vector<Transform> transforms2 = getTransforms(bodies2);
+            rp3d_test(!world2->restoreSnapshot(snapshot));
+            rp3d_test(hasTransforms(bodies2, transforms2));
+
+            // Truncated snapshot
+            const std::vector<Transform> transforms1 = getTransforms(bodies1);
+            std::vector<uint8> data(snapshot->getData(), snapshot->getData() + snapshot->getSize());
+            snapshot->setData(data.data(), static_cast<uint32>(data.size() - 10));
+            rp3d_test(!world1->restoreSnapshot(snapshot));
+
+            // Invalid version
+            data[4] = 0xFF;
+            snapshot->setData(data.data(), static_cast<uint32>(data.size()));
+            rp3d_test(!world1->restoreSnapshot(snapshot));
+            rp3d_test(hasTransforms(bodies1, transforms1));
+
+            world1->destroySnapshot(snapshot);
+            mPhysicsCommon.destroyPhysicsWorld(world1);
+            mPhysicsCommon.destroyPhysicsWorld(world2);
+        }
+
+        void testCorruptedSnapshot() {
+
+            std::vector<RigidBody*> bodies1;
+            std::vector<RigidBody*> bodies2;
+            PhysicsWorld* world1 = createWorld(bodies1);
+            PhysicsWorld* world2 = createWorld(bodies2);
+
+            simulate(world1, 40);
+            simulate(world2, 60);
+
+            WorldSnapshot* snapshot = world1->createSnapshot();
+            world1->saveSnapshot(snapshot);
+            const std::vector<uint8> data = getData(snapshot);
+            world2->saveSnapshot(snapshot);
+            const std::vector<uint8> data2 = getData(snapshot);
+
+            // A snapshot whose sizes of the sections are consistent but where the end of the data of
+            // a section is missing must not be restored, even partially. There are nine sections for the
+            // components and a last section for the overlapping pairs, the broad-phase and the contacts.
+            bool isRestoreRefused = true;
+            bool isWorldUnchanged = true;
+            for (int sectionIndex = 0; sectionIndex < 10; sectionIndex++) {
+
+                const std::vector<uint8> truncatedData = truncateSection(data, sectionIndex, 4);
+                snapshot->setData(truncatedData.data(), static_cast<uint32>(truncatedData.size()));
+                isRestoreRefused &= !world2->restoreSnapshot(snapshot);
+
+                world2->saveSnapshot(snapshot);
+                isWorldUnchanged &= getData(snapshot) == data2;
+            }
+            rp3d_test(isRestoreRefused);
+            rp3d_test(isWorldUnchanged);
+
+            // A snapshot with some additional data at the end is not valid either
+            std::vector<uint8> extendedData(data);
+            extendedData.push_back(0);
+            snapshot->setData(extendedData.data(), static_cast<uint32>(extendedData.size()));
+            rp3d_test(!world2->restoreSnapshot(snapshot));
+            world2->saveSnapshot(snapshot);
+            rp3d_test(getData(snapshot) == data2);
+
+            // The original data can still be restored
+            snapshot->setData(data.data(), static_cast<uint32>(data.size()));
+            rp3d_test(world2->restoreSnapshot(snapshot));
+            rp3d_test(isSameState(bodies1, bodies2));
+
+            mPhysicsCommon.destroyPhysicsWorld(world1);
+            mPhysicsCommon.destroyPhysicsWorld(world2);
+        }
+
+        void testSaveRestoreState() {
+
+            std::vector<RigidBody*> bodies;
+            PhysicsWorld* world = createWorld(bodies);
+
+            world->setNbStateCheckpoints(8);
+            rp3d_test(world->getNbStateCheckpoints() == 8);
+
+            simulate(world, 30);
+
+            // Save a state at each frame
+            std::vector<uint32> checkpoints;
+            std::vector<std::vector<Transform>> transforms;
+            for (int i=0; i < 12; i++) {
+                checkpoints.push_back(world->saveState());
+                transforms.push_back(getTransforms(bodies));
+                simulate(world, 1);
+            }
+            const std::vector<Transform> finalTransforms = getTransforms(bodies);
+
+            // The oldest checkpoints have been overwritten
+            rp3d_test(!world->restoreState(checkpoints[0]));
+            rp3d_test(!world->restoreState(checkpoints[3]));
+            rp3d_test(!world->restoreState(checkpoints[11] + 1));
+            rp3d_test(hasTransforms(bodies, finalTransforms));
+
+            // Rewind and simulate the same frames again (several times)
+            for (int r=0; r < 2; r++) {
+
+                rp3d_test(world->restoreState(checkpoints[5]));
+                rp3d_test(hasTransforms(bodies, transforms[5]));
+
+                simulate(world, 4);
+                rp3d_test(hasTransforms(bodies, transforms[9]));
+                simulate(world, 3);
+                rp3d_test(hasTransforms(bodies, finalTransforms));
+            }
+
+            // Rewind to the most recent checkpoint
+            rp3d_test(world->restoreState(checkpoints[11]));
+            rp3d_test(hasTransforms(bodies, transforms[11]));
+
+            // Changing the number of checkpoints removes the saved states
+            world->setNbStateCheckpoints(2);
+            rp3d_test(!world->restoreState(checkpoints[11]));
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+
+        void testRestoreStateWithoutAllocation() {
+
+            std::vector<RigidBody*> bodies;
+            PhysicsWorld* world = createWorld(bodies);
+            MemoryManager& memoryManager = world->getMemoryManager();
+
+            world->setNbStateCheckpoints(4);
+            simulate(world, 30);
+            const uint32 checkpoint = world->saveState();
+
+            // Warm up: the first rollbacks grow the arrays of the world and the single frame
+            // allocator halves its memory after 120 frames that use less than half of it
+            bool isRestored = true;
+            for (int r=0; r < 100; r++) {
+                isRestored &= world->restoreState(checkpoint);
+                simulate(world, 10);
+            }
+            rp3d_test(isRestored);
+
+            // Restoring the state and simulating the same frames again (for more than 120 frames) does
+            // not take memory from the base allocator or from the heap allocator (the heap allocator is
+            // locked at each allocation and each release)
+            const uint64 nbBaseAllocations = mAllocator.getNbAllocations();
+            const uint64 nbHeapLocks = memoryManager.getNbLocks(MemoryManager::AllocationType::Heap);
+            for (int r=0; r < 13; r++) {
+                isRestored &= world->restoreState(checkpoint);
+                simulate(world, 10);
+            }
+            rp3d_test(isRestored);
+            rp3d_test(mAllocator.getNbAllocations() == nbBaseAllocations);
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Heap) == nbHeapLocks);
+
+            mPhysicsCommon.destroyPhysicsWorld(world);
+        }
+};
+
+}
+
+#endif
@@ -0,0 +1,264 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2016 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+
+#ifndef TEST_MEMORY_ALLOCATORS_H
+#define TEST_MEMORY_ALLOCATORS_H
+
+// Libraries
+#include "Test.h"
+#include <reactphysics3d/memory/MemoryManager.h>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Class TestMemoryAllocators
+/**
+ * Unit test for the pool and heap memory allocators
+ */
+class TestMemoryAllocators : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        DefaultAllocator mBaseAllocator;
+
+        // ---------- Methods ---------- //
+
+        /// Fill a piece of memory with a pattern
+        static void fillMemory(void* pointer, size_t size, unsigned char value) {
+            memset(pointer, value, size);
+        }
+
+        /// Return true if a piece of memory is filled with a pattern
+        static bool isMemoryFilled(const void* pointer, size_t size, unsigned char value) {
+
+            const unsigned char* bytes = static_cast<const unsigned char*>(pointer);
+            for (size_t i=0; i < size; i++) {
+                if (bytes[i] != value) return false;
+            }
+            return true;
+        }
+
+        /// Allocate and release memory with an allocator and return true if the memory is never shared
+        static bool allocateAndRelease(MemoryAllocator& allocator, uint32 seed, int nbIterations) {
+
+            std::vector<void*> pointers;
+            std::vector<size_t> sizes;
+            bool isValid = true;
+
+            uint32 random = seed;
+            for (int i=0; i < nbIterations; i++) {
+
+                random = random * 1664525u + 1013904223u;
+
+                // Allocate a new piece of memory or release one
+                if (pointers.empty() || (random >> 16) % 3 != 0) {
+
+                    const size_t size = 1 + (random >> 8) % 1100;
+                    void* pointer = allocator.allocate(size);
+                    fillMemory(pointer, size, static_cast<unsigned char>(pointers.size()));
+                    pointers.push_back(pointer);
+                    sizes.push_back(size);
+                }
+                else {
+
+                    const size_t index = (random >> 4) % pointers.size();
+                    isValid &= isMemoryFilled(pointers[index], sizes[index], static_cast<unsigned char>(index));
+                    allocator.release(pointers[index], sizes[index]);
+
+                    // Move the last piece of memory at the released index and update its pattern
+                    pointers[index] = pointers.back();
+                    sizes[index] = sizes.back();
+                    pointers.pop_back();
+                    sizes.pop_back();
+                    if (index < pointers.size()) {
+                        isValid &= isMemoryFilled(pointers[index], sizes[index], static_cast<unsigned char>(pointers.size()));
+                        fillMemory(pointers[index], sizes[index], static_cast<unsigned char>(index));
+                    }
+                }
+            }
+
+            for (size_t i=0; i < pointers.size(); i++) {
+                isValid &= isMemoryFilled(pointers[i], sizes[i], static_cast<unsigned char>(i));
+                allocator.release(pointers[i], sizes[i]);
+            }
+
+            return isValid;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestMemoryAllocators(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+            testHeapAllocator();
+            testPoolAllocator();
+            testPoolAllocatorThreads();
+            testLockStatistics();
+        }
+
+        void testHeapAllocator() {
+
+            HeapAllocator heapAllocator(mBaseAllocator, 4096);
+
+            rp3d_test(allocateAndRelease(heapAllocator, 1, 5000));
+
+            // The allocator reserves more memory when it is full
+            void* largePointer = heapAllocator.allocate(100000);
+            fillMemory(largePointer, 100000, 7);
+            void* smallPointer = heapAllocator.allocate(16);
+            fillMemory(smallPointer, 16, 8);
+            rp3d_test(isMemoryFilled(largePointer, 100000, 7));
+            rp3d_test(isMemoryFilled(smallPointer, 16, 8));
+
+            // The released memory units are merged and can be used for a larger request
+            heapAllocator.release(largePointer, 100000);
+            void* largerPointer = heapAllocator.allocate(100008);
+            rp3d_test(largerPointer == largePointer);
+            heapAllocator.release(largerPointer, 100008);
+            heapAllocator.release(smallPointer, 16);
+
+            rp3d_test(heapAllocator.getMutex().getNbLocks() > 0);
+        }
+
+        void testPoolAllocator() {
+
+            HeapAllocator heapAllocator(mBaseAllocator);
+
+            {
+                PoolAllocator poolAllocator(heapAllocator);
+
+                rp3d_test(allocateAndRelease(poolAllocator, 2, 5000));
+
+                // A released memory unit is reused by the next request of the same size
+                void* pointer = poolAllocator.allocate(40);
+                poolAllocator.release(pointer, 40);
+                rp3d_test(poolAllocator.allocate(40) == pointer);
+                poolAllocator.release(pointer, 40);
+
+                // The memory units are taken from the allocator by batches
+                heapAllocator.getMutex().resetStatistics();
+                poolAllocator.getMutex().resetStatistics();
+                std::vector<void*> pointers;
+                for (int i=0; i < 1000; i++) {
+                    pointers.push_back(poolAllocator.allocate(24));
+                }
+                for (int i=0; i < 1000; i++) {
+                    poolAllocator.release(pointers[i], 24);
+                }
+                rp3d_test(poolAllocator.getMutex().getNbLocks() < 200);
+
+                poolAllocator.releaseThreadCache();
+            }
+
+            // A new allocator does not use the cache of the destroyed one
+            PoolAllocator poolAllocator(heapAllocator);
+            rp3d_test(allocateAndRelease(poolAllocator, 3, 2000));
+        }
+
+        void testPoolAllocatorThreads() {
+
+            HeapAllocator heapAllocator(mBaseAllocator);
+            PoolAllocator poolAllocator(heapAllocator);
+
+            const int nbThreads = 4;
+            std::vector<std::thread> threads;
+            std::vector<int> results(nbThreads, 0);
+            for (int t=0; t < nbThreads; t++) {
+                threads.emplace_back([&poolAllocator, &results, t]() {
+                    results[t] = allocateAndRelease(poolAllocator, uint32(10 + t), 20000) ? 1 : 0;
+                });
+            }
+            for (int t=0; t < nbThreads; t++) {
+                threads[t].join();
+            }
+
+            for (int t=0; t < nbThreads; t++) {
+                rp3d_test(results[t] == 1);
+            }
+
+            // The memory allocated by a thread can be released by another thread
+            std::vector<void*> pointers;
+            std::thread allocatingThread([&poolAllocator, &pointers]() {
+                for (int i=0; i < 500; i++) {
+                    void* pointer = poolAllocator.allocate(64);
+                    fillMemory(pointer, 64, 3);
+                    pointers.push_back(pointer);
+                }
+            });
+            allocatingThread.join();
+
+            bool isValid = true;
+            for (size_t i=0; i < pointers.size(); i++) {
+                isValid &= isMemoryFilled(pointers[i], 64, 3);
+                poolAllocator.release(pointers[i], 64);
+            }
+            rp3d_test(isValid);
+
+            // The memory units cached by the threads that have exited have been given back to the allocator
+            rp3d_test(allocateAndRelease(poolAllocator, 20, 5000));
+        }
+
+        void testLockStatistics() {
+
+            MemoryManager memoryManager(nullptr, 4096);
+
+            memoryManager.resetLockStatistics();
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Heap) == 0);
+            rp3d_test(memoryManager.getNbContendedLocks(MemoryManager::AllocationType::Heap) == 0);
+
+            void* pointer = memoryManager.allocate(MemoryManager::AllocationType::Heap, 100);
+            memoryManager.release(MemoryManager::AllocationType::Heap, pointer, 100);
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Heap) == 2);
+
+            pointer = memoryManager.allocate(MemoryManager::AllocationType::Frame, 100);
+            memoryManager.release(MemoryManager::AllocationType::Frame, pointer, 100);
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Frame) == 2);
+
+            // A single thread never waits for a lock
+            rp3d_test(allocateAndRelease(memoryManager.getPoolAllocator(), 4, 2000));
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Pool) > 0);
+            rp3d_test(memoryManager.getNbContendedLocks(MemoryManager::AllocationType::Pool) == 0);
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Base) == 0);
+
+            memoryManager.resetLockStatistics();
+            rp3d_test(memoryManager.getNbLocks(MemoryManager::AllocationType::Pool) == 0);
+        }
+};
+
+}
+
+#endif
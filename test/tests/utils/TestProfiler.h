@@ -0,0 +1,215 @@
+/********************************************************************************
+* ReactPhysics3D physics library, http://www.reactphysics3d.com                 *
+* Copyright (c) 2010-2022 Daniel Chappuis                                       *
+*********************************************************************************
+*                                                                               *
+* This software is provided 'as-is', without any express or implied warranty.   *
+* In no event will the authors be held liable for any damages arising from the  *
+* use of this software.                                                         *
+*                                                                               *
+* Permission is granted to anyone to use this software for any purpose,         *
+* including commercial applications, and to alter it and redistribute it        *
+* freely, subject to the following restrictions:                                *
+*                                                                               *
+* 1. The origin of this software must not be misrepresented; you must not claim *
+*    that you wrote the original software. If you use this software in a        *
+*    product, an acknowledgment in the product documentation would be           *
+*    appreciated but is not required.                                           *
+*                                                                               *
+* 2. Altered source versions must be plainly marked as such, and must not be    *
+*    misrepresented as being the original software.                             *
+*                                                                               *
+* 3. This notice may not be removed or altered from any source distribution.    *
+*                                                                               *
+********************************************************************************/
+
+#ifndef TEST_PROFILER_H
+#define TEST_PROFILER_H
+
+// Libraries
+#include <reactphysics3d/reactphysics3d.h>
+#include <atomic>
+#include <sstream>
+#include <string>
+
+// The profiler is only available when profiling is enabled
+#ifdef IS_RP3D_PROFILING_ENABLED
+
+/// Reactphysics3D namespace
+namespace reactphysics3d {
+
+// Names of the profiled blocks of code
+static const char* const PROFILE_OUTER_BLOCK = "Outer";
+static const char* const PROFILE_INNER_BLOCK = "Inner";
+static const char* const PROFILE_TASK_BLOCK = "Task";
+static const char* const PROFILE_DISABLED_BLOCK = "Disabled";
+
+// Class TestProfiler
+/**
+ * Unit test for the Profiler class
+ */
+class TestProfiler : public Test {
+
+    private :
+
+        // ---------- Atributes ---------- //
+
+        PhysicsCommon mPhysicsCommon;
+
+        // ---------- Methods ---------- //
+
+        /// Return the number of events with a given name in a Chrome trace
+        static uint32 countTraceEvents(const std::string& trace, const char* name) {
+
+            const std::string pattern = std::string("{\"name\":\"") + name + "\",\"cat\"";
+            uint32 nbEvents = 0;
+            for (size_t i = trace.find(pattern); i != std::string::npos; i = trace.find(pattern, i + 1)) {
+                nbEvents++;
+            }
+            return nbEvents;
+        }
+
+    public :
+
+        // ---------- Methods ---------- //
+
+        /// Constructor
+        TestProfiler(const std::string& name) : Test(name) {
+
+        }
+
+        /// Run the tests
+        void run() {
+            testProfilerTree();
+            testDisabledProfiling();
+            testThreads();
+            testRingBuffer();
+        }
+
+        void testProfilerTree() {
+
+            Profiler profiler;
+            profiler.incrementFrameCounter();
+
+            {
+                RP3D_PROFILE(PROFILE_OUTER_BLOCK, &profiler);
+                for (int i=0; i < 3; i++) {
+                    RP3D_PROFILE(PROFILE_INNER_BLOCK, &profiler);
+                }
+            }
+
+            ProfileNodeIterator* iterator = profiler.getIterator();
+
+            rp3d_test(!iterator->isEnd());
+            rp3d_test(iterator->getCurrentName() == PROFILE_OUTER_BLOCK);
+            rp3d_test(iterator->getCurrentNbTotalCalls() == 1);
+            const double outerTime = iterator->getCurrentTotalTime().count();
+
+            iterator->next();
+            rp3d_test(iterator->isEnd());
+
+            iterator->enterChild(0);
+            rp3d_test(!iterator->isEnd());
+            rp3d_test(iterator->getCurrentName() == PROFILE_INNER_BLOCK);
+            rp3d_test(iterator->getCurrentNbTotalCalls() == 3);
+            rp3d_test(iterator->getCurrentTotalTime().count() >= 0.0);
+            rp3d_test(iterator->getCurrentTotalTime().count() <= outerTime);
+
+            delete iterator;
+
+            // After a reset, the tree keeps its structure but the calls are not counted anymore
+            profiler.reset();
+            iterator = profiler.getIterator();
+            rp3d_test(iterator->getCurrentNbTotalCalls() == 0);
+            delete iterator;
+
+            // The events before the reset are not exported
+            std::stringstream trace;
+            profiler.exportChromeTrace(trace);
+            rp3d_test(trace.str().find("{\"traceEvents\":[") == 0);
+            rp3d_test(countTraceEvents(trace.str(), PROFILE_OUTER_BLOCK) == 0);
+        }
+
+        void testDisabledProfiling() {
+
+            Profiler profiler;
+            rp3d_test(profiler.isEnabled());
+
+            profiler.setIsEnabled(false);
+            rp3d_test(!profiler.isEnabled());
+            {
+                RP3D_PROFILE(PROFILE_DISABLED_BLOCK, &profiler);
+            }
+
+            profiler.setIsEnabled(true);
+            {
+                RP3D_PROFILE(PROFILE_OUTER_BLOCK, &profiler);
+            }
+
+            std::stringstream trace;
+            profiler.exportChromeTrace(trace);
+            rp3d_test(countTraceEvents(trace.str(), PROFILE_DISABLED_BLOCK) == 0);
+            rp3d_test(countTraceEvents(trace.str(), PROFILE_OUTER_BLOCK) == 1);
+        }
+
+        void testThreads() {
+
+            Profiler profiler;
+            DefaultTaskScheduler* taskScheduler = mPhysicsCommon.createDefaultTaskScheduler(4);
+
+            // Each execution of the task is recorded by the thread that executes it
+            std::atomic<uint32> nbExecutions(0);
+            for (int k=0; k < 10; k++) {
+                parallelFor(taskScheduler, 1000, 10, [&](uint32 /*startIndex*/, uint32 /*endIndex*/, uint32 /*workerIndex*/) {
+                    RP3D_PROFILE(PROFILE_TASK_BLOCK, &profiler);
+                    nbExecutions++;
+                });
+            }
+
+            std::stringstream trace;
+            profiler.exportChromeTrace(trace);
+            rp3d_test(countTraceEvents(trace.str(), PROFILE_TASK_BLOCK) == nbExecutions);
+            rp3d_test(trace.str().find("\"ph\":\"M\"") != std::string::npos);
+
+            mPhysicsCommon.destroyDefaultTaskScheduler(taskScheduler);
+        }
+
+        void testRingBuffer() {
+
+            Profiler profiler;
+            profiler.incrementFrameCounter();
+
+            // Record more events than the ring buffer of a thread can contain
+            const uint32 nbEvents = 100000;
+            for (uint32 i=0; i < nbEvents; i++) {
+                RP3D_PROFILE(PROFILE_INNER_BLOCK, &profiler);
+            }
+            {
+                RP3D_PROFILE(PROFILE_OUTER_BLOCK, &profiler);
+            }
+
+            // Only the most recent events are kept
+            std::stringstream trace;
+            profiler.exportChromeTrace(trace);
+            const uint32 nbExportedEvents = countTraceEvents(trace.str(), PROFILE_INNER_BLOCK);
+            rp3d_test(nbExportedEvents > 0);
+            rp3d_test(nbExportedEvents < nbEvents);
+            rp3d_test(countTraceEvents(trace.str(), PROFILE_OUTER_BLOCK) == 1);
+
+            ProfileNodeIterator* iterator = profiler.getIterator();
+            uint32 nbCallsInTree = 0;
+            for (; !iterator->isEnd(); iterator->next()) {
+                if (iterator->getCurrentName() == PROFILE_INNER_BLOCK) {
+                    nbCallsInTree = iterator->getCurrentNbTotalCalls();
+                }
+            }
+            rp3d_test(nbCallsInTree == nbExportedEvents);
+            delete iterator;
+        }
+};
+
+}
+
+#endif
+
+#endif